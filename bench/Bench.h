@@ -0,0 +1,110 @@
+#pragma once
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Benchmark Utilities
+// Shared by the portable benchmarks: a deterministic RNG for scene generation, best-of-N
+// timing and one report line format, so results from different benchmarks read the same.
+// Every benchmark accepts --quick, which shrinks the problem sizes for the CTest smoke run.
+namespace Bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double Seconds(Clock::duration duration) {
+    return std::chrono::duration<double>(duration).count();
+}
+
+// xorshift32: fast, and the same sequence on every platform for a given seed
+class Rng {
+  public:
+    explicit Rng(uint32_t seed = 0x9E3779B9u) : state(seed ? seed : 1u) {}
+
+    uint32_t Next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    // Uniform in [0, 1)
+    float Unit() {
+        return static_cast<float>(Next() >> 8) * (1.0f / 16777216.0f);
+    }
+    float Range(float low, float high) {
+        return low + (high - low) * Unit();
+    }
+    // Uniform in [0, count)
+    uint32_t Below(uint32_t count) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(Next()) * count) >> 32);
+    }
+
+  private:
+    uint32_t state;
+};
+
+// Command line shared by every benchmark
+struct Options {
+    bool quick = false; // --quick: smallest sizes only, for smoke runs under CTest
+
+    static Options Parse(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--quick") == 0) {
+                options.quick = true;
+            }
+        }
+        return options;
+    }
+
+    // Problem size: full for real runs, small for smoke runs
+    uint32_t Size(uint32_t full, uint32_t small) const {
+        return quick ? small : full;
+    }
+};
+
+// Fastest of repetitions runs of function, in seconds; the minimum is the least noisy estimate
+template <typename Function>
+double Best(int repetitions, Function&& function) {
+    double best = 1e30;
+    for (int i = 0; i < repetitions; ++i) {
+        Clock::time_point start = Clock::now();
+        function();
+        double seconds = Seconds(Clock::now() - start);
+        best           = seconds < best ? seconds : best;
+    }
+    return best;
+}
+
+// "  name ............ value" with the name padded to one column, printf-style value
+inline void Report(const char* name, const char* format, ...) {
+    std::printf("  %-40s ", name);
+    va_list args;
+    va_start(args, format);
+    std::vprintf(format, args);
+    va_end(args);
+    std::printf("\n");
+}
+
+// Section title for a group of Report lines
+inline void Section(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    std::vprintf(format, args);
+    va_end(args);
+    std::printf("\n");
+}
+
+// Keeps the optimizer from deleting work whose result is otherwise unused
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast<const volatile char*>(&value);
+#endif
+}
+
+} // namespace Bench
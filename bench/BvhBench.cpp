@@ -0,0 +1,158 @@
+// BVH Benchmark
+// Frustum culling cost per frame for 100k and 1M objects: the scalar linear scan (one
+// Frustum::TestBox per object), the SSE2 linear scan (CullBoxes), the four-wide BVH on one
+// thread and spread over the job system. A camera turns through 20 views per run. Also
+// reports build time and the refit after a tenth of the objects moved.
+//
+//   BvhBench [--quick]
+#include "Bench.h"
+#include "scene/Bvh.h"
+#include "threading/JobSystem.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const int ViewCount = 20;
+
+/*
+Row-vector view-projection (clip = p * M, depth in [0, w]) of a camera at position turned
+yaw radians about +y from looking down +z, 60 degree vertical field of view, 16:9
+*/
+Frustum MakeFrustum(const float position[3], float yaw) {
+    const float nearZ      = 0.5f;
+    const float farZ       = 300.0f;
+    const float right[3]   = {std::cos(yaw), 0.0f, -std::sin(yaw)};
+    const float up[3]      = {0.0f, 1.0f, 0.0f};
+    const float forward[3] = {std::sin(yaw), 0.0f, std::cos(yaw)};
+    const float yScale     = 1.0f / std::tan(0.5236f);
+    const float xScale     = yScale * 9.0f / 16.0f;
+    const float depth      = farZ / (farZ - nearZ);
+
+    auto dot = [&](const float axis[3]) {
+        return axis[0] * position[0] + axis[1] * position[1] + axis[2] * position[2];
+    };
+    float m[16];
+    for (int i = 0; i < 3; ++i) {
+        m[i * 4 + 0] = xScale * right[i];
+        m[i * 4 + 1] = yScale * up[i];
+        m[i * 4 + 2] = depth * forward[i];
+        m[i * 4 + 3] = forward[i];
+    }
+    m[12] = -xScale * dot(right);
+    m[13] = -yScale * dot(up);
+    m[14] = -depth * dot(forward) - depth * nearZ;
+    m[15] = -dot(forward);
+    return Frustum::FromViewProjection(m);
+}
+
+// Boxes [first, first + count) become boxes of 0.5 to 5 units anywhere in the cube of
+// half-size half around the origin
+void Scatter(Bench::Rng& rng, float half, BoundsArray& bounds, uint32_t first, uint32_t count) {
+    for (uint32_t i = first; i < first + count; ++i) {
+        float min[3], max[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            const float center = rng.Range(-half, half);
+            const float extent = rng.Range(0.25f, 2.5f);
+            min[axis]          = center - extent;
+            max[axis]          = center + extent;
+        }
+        bounds.Set(i, min, max);
+    }
+}
+
+// Best total over the views of cull(frustum), in milliseconds per view
+template <typename Cull>
+double PerView(int repetitions, const std::vector<Frustum>& views, Cull&& cull) {
+    double seconds = Bench::Best(repetitions, [&] {
+        for (const Frustum& frustum : views) {
+            Bench::DoNotOptimize(cull(frustum));
+        }
+    });
+    return seconds * 1e3 / views.size();
+}
+
+void Run(uint32_t count, JobSystem& jobSystem, int repetitions) {
+    // The density stays that of 100k objects in a 400-unit cube, so larger scenes reach
+    // further past the far plane, as a larger world would
+    Bench::Rng rng;
+    const float half = 200.0f * std::cbrt(count / 100000.0f);
+    BoundsArray bounds;
+    bounds.Resize(count);
+    Scatter(rng, half, bounds, 0, count);
+
+    std::vector<Frustum> views;
+    const float position[3] = {0.0f, 0.0f, 0.0f};
+    for (int view = 0; view < ViewCount; ++view) {
+        views.push_back(MakeFrustum(position, view * (6.2831853f / ViewCount)));
+    }
+    Bench::Section("%u objects", count);
+
+    Bvh bvh;
+    bvh.SetParallelFor(jobSystem.GetTaskExecutor());
+    const double build = Bench::Best(repetitions, [&] { bvh.Build(bounds); });
+    Bench::Report("build",
+                  "%8.3f ms  %u nodes, cost %.3f",
+                  build * 1e3,
+                  bvh.GetNodeCount(),
+                  bvh.GetCost());
+
+    std::vector<uint32_t> visible(count);
+    const double scalar = PerView(repetitions, views, [&](const Frustum& frustum) {
+        return CullBoxesScalar(frustum, bounds, visible.data());
+    });
+    const double linear = PerView(repetitions, views, [&](const Frustum& frustum) {
+        return CullBoxes(frustum, bounds, visible.data());
+    });
+    const double tree = PerView(repetitions, views, [&](const Frustum& frustum) {
+        return bvh.Cull(frustum, visible);
+    });
+    const double parallel = PerView(repetitions, views, [&](const Frustum& frustum) {
+        return bvh.CullParallel(frustum, visible);
+    });
+
+    uint64_t total = 0;
+    for (const Frustum& frustum : views) {
+        total += bvh.Cull(frustum, visible);
+    }
+    Bench::Report("visible per view",
+                  "%.1f%%",
+                  100.0 * total / (static_cast<double>(count) * ViewCount));
+    Bench::Report("scalar linear", "%8.3f ms/view", scalar);
+    Bench::Report("SSE2 linear", "%8.3f ms/view", linear);
+    Bench::Report("BVH", "%8.3f ms/view", tree);
+    char label[64];
+    const uint32_t threads = jobSystem.GetThreadCount();
+    std::snprintf(label, sizeof(label), "BVH, %u thread%s", threads, threads == 1 ? "" : "s");
+    Bench::Report(label, "%8.3f ms/view", parallel);
+
+    // Moved objects keep their place in the tree; the cost shows how much that hurts
+    Scatter(rng, half, bounds, 0, count / 10);
+    const double refit = Bench::Best(repetitions, [&] { bvh.Refit(bounds); });
+    Bench::Report("refit, 10% moved", "%8.3f ms  cost %.3f", refit * 1e3, bvh.GetCost());
+    const double refitted = PerView(repetitions, views, [&](const Frustum& frustum) {
+        return bvh.Cull(frustum, visible);
+    });
+    Bench::Report("BVH after refit", "%8.3f ms/view", refitted);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 5;
+
+    JobSystem jobSystem;
+    jobSystem.Initialize();
+
+    std::vector<uint32_t> counts = {100000, 1000000};
+    if (options.quick) {
+        counts = {20000};
+    }
+    for (uint32_t count : counts) {
+        Run(count, jobSystem, repetitions);
+    }
+    jobSystem.Shutdown();
+    return 0;
+}
@@ -0,0 +1,95 @@
+// File Watcher Benchmark
+// The watcher's share of the hot-reload "edit to pixels" latency: time from a file write
+// until the OS notification reaches the watcher thread, and until the debounced callback
+// runs (which starts the recompile). The remainder, compile plus the swap at the next
+// frame boundary, is logged by ShaderHotReload at run time.
+//
+//   FileWatcherBench [--quick]
+#include "Bench.h"
+#include "utils/FileWatcher.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+double Milliseconds(FileWatcher::Clock::duration duration) {
+    return Bench::Seconds(duration) * 1e3;
+}
+
+void ReportPercentiles(const char* name, std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    const size_t count = samples.size();
+    Bench::Report(name,
+                  "p50 %7.3f ms  p99 %7.3f ms  max %7.3f ms",
+                  samples[count / 2],
+                  samples[std::min(count - 1, count * 99 / 100)],
+                  samples.back());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const uint32_t edits   = options.Size(100, 5);
+
+    const fs::path directory = fs::temp_directory_path() / "FileWatcherBench";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    const std::string file = (directory / "BasicPS.hlsl").string();
+
+    std::mutex mutex;
+    std::condition_variable arrived;
+    uint32_t callbacks = 0;
+    FileWatcher::Clock::time_point firstChange;
+    FileWatcher::Clock::time_point delivered;
+
+    auto onChange = [&](const std::vector<std::string>&, FileWatcher::Clock::time_point first) {
+        std::lock_guard<std::mutex> lock(mutex);
+        firstChange = first;
+        delivered   = FileWatcher::Clock::now();
+        ++callbacks;
+        arrived.notify_all();
+    };
+    FileWatcher watcher;
+    if (!watcher.Start(directory.string(), onChange)) {
+        std::fprintf(stderr, "cannot watch %s\n", directory.string().c_str());
+        return 1;
+    }
+
+    std::vector<double> notification;
+    std::vector<double> callback;
+    for (uint32_t edit = 0; edit < edits; ++edit) {
+        FileWatcher::Clock::time_point written;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            const uint32_t expected = callbacks + 1;
+            written                 = FileWatcher::Clock::now();
+            FILE* handle            = std::fopen(file.c_str(), "wb");
+            if (handle) {
+                std::fprintf(handle, "// edit %u\n", edit);
+                std::fclose(handle);
+            }
+            if (!arrived.wait_for(lock, std::chrono::seconds(5), [&] {
+                    return callbacks >= expected;
+                })) {
+                std::fprintf(stderr, "edit %u was never reported\n", edit);
+                return 1;
+            }
+            notification.push_back(Milliseconds(firstChange - written));
+            callback.push_back(Milliseconds(delivered - written));
+        }
+    }
+    watcher.Stop();
+    fs::remove_all(directory);
+
+    Bench::Section("FileWatcher: %u edits, %u ms debounce", edits, FileWatcher::DebounceMs);
+    ReportPercentiles("write to notification", notification);
+    ReportPercentiles("write to callback (debounced)", callback);
+    return 0;
+}
@@ -0,0 +1,219 @@
+// Frame Arena Benchmark
+// Per-frame transient allocation through FrameArena against the default allocator, for the
+// pattern a frame's build has: a few hundred scratch arrays of mixed size (culling lists,
+// instance data), vectors grown one element at a time (render queue packets), and
+// short-lived objects (ObjectPool against new/delete). Also runs the scratch pattern spread
+// over the job system, where malloc's shared state is contended and each worker's arena is
+// not. Reports nanoseconds per allocation.
+//
+//   FrameArenaBench [--quick]
+#include "Bench.h"
+#include "memory/FrameArena.h"
+#include "memory/ObjectPool.h"
+#include "threading/JobSystem.h"
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <vector>
+
+namespace {
+
+const uint32_t FrameCount = 200;
+
+// Requested scratch sizes: mostly small, some a few kilobytes, a few large
+std::vector<uint32_t> MakeSizes(uint32_t count) {
+    Bench::Rng rng(7);
+    std::vector<uint32_t> sizes(count);
+    for (uint32_t& size : sizes) {
+        const uint32_t kind = rng.Below(20);
+        if (kind < 14) {
+            size = 16 + rng.Below(240);
+        } else if (kind < 19) {
+            size = 1024 + rng.Below(7 * 1024);
+        } else {
+            size = 64 * 1024 + rng.Below(192 * 1024);
+        }
+    }
+    return sizes;
+}
+
+// Touch the first and last byte, as a real user of the memory would
+void Touch(void* memory, uint32_t size) {
+    static_cast<uint8_t*>(memory)[0]        = 1;
+    static_cast<uint8_t*>(memory)[size - 1] = 1;
+}
+
+// Scratch arrays [begin, end) of one frame from the heap, freed once all are made
+void ScratchHeap(const std::vector<uint32_t>& sizes,
+                 std::vector<void*>& blocks,
+                 uint32_t begin,
+                 uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) {
+        blocks[i] = std::malloc(sizes[i]);
+        Touch(blocks[i], sizes[i]);
+    }
+    for (uint32_t i = begin; i < end; ++i) {
+        std::free(blocks[i]);
+    }
+}
+
+// The same from the arena; BeginFrame releases them all
+void ScratchArena(const std::vector<uint32_t>& sizes,
+                  FrameArena& arena,
+                  uint32_t begin,
+                  uint32_t end) {
+    for (uint32_t i = begin; i < end; ++i) {
+        void* memory = arena.Allocate(sizes[i], 16, MemoryTag::Culling);
+        Touch(memory, sizes[i]);
+    }
+}
+
+struct Packet {
+    uint64_t sortKey;
+    uint32_t indexCount;
+    uint32_t state;
+    const void* constants;
+};
+
+// A render queue's worth of packets pushed one by one
+template <typename Vector>
+void FillPackets(Vector& packets, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        packets.push_back(Packet{i * 2654435761ull, 36, i % 7, nullptr});
+    }
+    Bench::DoNotOptimize(packets.back());
+}
+
+struct Transient {
+    float transform[16];
+    uint32_t id;
+};
+
+void Print(const char* label, double seconds, uint64_t allocations) {
+    Bench::Report(label, "%8.1f ns/allocation", seconds * 1e9 / allocations);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 5;
+    const uint32_t frames  = options.Size(FrameCount, 10);
+
+    // Scratch arrays
+    const std::vector<uint32_t> sizes = MakeSizes(options.Size(500, 100));
+    const uint32_t sizeCount          = static_cast<uint32_t>(sizes.size());
+    const uint64_t scratchCount       = static_cast<uint64_t>(sizeCount) * frames;
+    Bench::Section("Scratch arrays: %u per frame, %u frames", sizeCount, frames);
+    std::vector<void*> blocks(sizeCount);
+    const double heap = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            ScratchHeap(sizes, blocks, 0, sizeCount);
+        }
+    });
+    Print("malloc/free", heap, scratchCount);
+    FrameArena arena;
+    const double scratch = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            arena.BeginFrame();
+            ScratchArena(sizes, arena, 0, sizeCount);
+        }
+    });
+    Print("FrameArena", scratch, scratchCount);
+
+    // Growing vectors: both reallocate as often, so this is the whole frame's pushes; the
+    // arena never frees the outgrown buffers until the frame comes round again
+    const uint32_t packetCount = options.Size(10000, 1000);
+    Bench::Section("Render packets: %u pushed per frame, %u frames", packetCount, frames);
+    const double vector = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            std::vector<Packet> packets;
+            FillPackets(packets, packetCount);
+        }
+    });
+    Bench::Report("std::vector", "%8.3f ms/frame", vector * 1e3 / frames);
+    const double pmr = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            arena.BeginFrame();
+            std::pmr::vector<Packet> packets(arena.GetResource(MemoryTag::RenderQueue));
+            FillPackets(packets, packetCount);
+        }
+    });
+    Bench::Report("std::pmr::vector on FrameArena", "%8.3f ms/frame", pmr * 1e3 / frames);
+
+    // Short-lived objects: half created and destroyed within the frame
+    const uint32_t objectCount = options.Size(5000, 500);
+    const uint64_t objects     = static_cast<uint64_t>(objectCount) * frames;
+    Bench::Section("Objects: %u of %zu bytes per frame", objectCount, sizeof(Transient));
+    std::vector<Transient*> live(objectCount);
+    const double heapObjects = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            for (uint32_t i = 0; i < objectCount; ++i) {
+                live[i]     = new Transient();
+                live[i]->id = i;
+            }
+            for (uint32_t i = 0; i < objectCount; i += 2) {
+                delete live[i];
+            }
+            for (uint32_t i = 1; i < objectCount; i += 2) {
+                delete live[i];
+            }
+        }
+    });
+    Print("new/delete", heapObjects, objects);
+    ObjectPool<Transient> pool;
+    const double pooled = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            for (uint32_t i = 0; i < objectCount; ++i) {
+                live[i]     = pool.Create();
+                live[i]->id = i;
+            }
+            for (uint32_t i = 0; i < objectCount; i += 2) {
+                pool.Destroy(live[i]);
+            }
+            for (uint32_t i = 1; i < objectCount; i += 2) {
+                pool.Destroy(live[i]);
+            }
+        }
+    });
+    Print("ObjectPool", pooled, objects);
+
+    // The same scratch pattern split over every thread, a range of 16 arrays per job
+    JobSystem jobSystem;
+    jobSystem.Initialize();
+    const uint32_t threads                    = jobSystem.GetThreadCount();
+    const uint32_t parallelCount              = sizeCount * threads;
+    const uint64_t parallelTotal              = static_cast<uint64_t>(parallelCount) * frames;
+    const std::vector<uint32_t> parallelSizes = MakeSizes(parallelCount);
+    Bench::Section("Scratch arrays on %u thread%s: %u per frame",
+                   threads,
+                   threads == 1 ? "" : "s",
+                   parallelCount);
+    std::vector<void*> parallelBlocks(parallelCount);
+    const double parallelHeap = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            jobSystem.ParallelFor(parallelCount, 16, [&](uint32_t begin, uint32_t end) {
+                ScratchHeap(parallelSizes, parallelBlocks, begin, end);
+            });
+        }
+    });
+    Print("malloc/free", parallelHeap, parallelTotal);
+    const double parallelArena = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            arena.BeginFrame();
+            jobSystem.ParallelFor(parallelCount, 16, [&](uint32_t begin, uint32_t end) {
+                ScratchArena(parallelSizes, arena, begin, end);
+            });
+        }
+    });
+    Print("FrameArena", parallelArena, parallelTotal);
+    jobSystem.Shutdown();
+
+    arena.BeginFrame();
+    FrameArena::Stats stats = arena.GetStats();
+    Bench::Report("arena high-water",
+                  "%.1f KB, %.1f KB reserved",
+                  stats.highWater / 1024.0,
+                  stats.bytesReserved / 1024.0);
+    return 0;
+}
@@ -0,0 +1,164 @@
+// Frame Capture Benchmark
+// Cost of FrameCapture on a synthetic frame of draws as StateCache forwards them: per draw a
+// vertex buffer, constants window, texture and indexed draw, with a material change every 8
+// draws and the constant contents recorded per object. Reports the forwarding cost outside
+// a capture against calling the sink directly, the cost per command while capturing, the
+// file size, and how long CaptureFile takes to validate the frame and replay it.
+//
+//   FrameCaptureBench [--quick]
+#include "Bench.h"
+#include "render/FrameCapture.h"
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// Stands in for the driver: counts calls and nothing else
+class CountingSink : public ContextSink {
+  public:
+    uint64_t calls = 0;
+
+    void SetInputLayout(void*) override {
+        ++calls;
+    }
+    void SetPrimitiveTopology(uint32_t) override {
+        ++calls;
+    }
+    void SetIndexBuffer(void*, uint32_t, uint32_t) override {
+        ++calls;
+    }
+    void SetVertexBuffer(uint32_t, void*, uint32_t, uint32_t) override {
+        ++calls;
+    }
+    void SetVertexShader(void*) override {
+        ++calls;
+    }
+    void SetPixelShader(void*) override {
+        ++calls;
+    }
+    void SetPixelShaderResource(uint32_t, void*) override {
+        ++calls;
+    }
+    void SetPixelSampler(uint32_t, void*) override {
+        ++calls;
+    }
+    void SetVertexConstantBuffer(uint32_t, void*, uint32_t, uint32_t) override {
+        ++calls;
+    }
+    void SetRasterizerState(void*) override {
+        ++calls;
+    }
+    void SetViewport(float, float, float, float) override {
+        ++calls;
+    }
+    void SetDepthStencilState(void*, uint32_t) override {
+        ++calls;
+    }
+    void SetBlendState(void*, const float*, uint32_t) override {
+        ++calls;
+    }
+    void SetRenderTarget(void*, void*) override {
+        ++calls;
+    }
+    void Draw(uint32_t, uint32_t) override {
+        ++calls;
+    }
+    void DrawIndexed(uint32_t, uint32_t, int32_t) override {
+        ++calls;
+    }
+    void DrawInstanced(uint32_t, uint32_t, uint32_t, uint32_t) override {
+        ++calls;
+    }
+    void DrawIndexedInstanced(uint32_t, uint32_t, uint32_t, int32_t, uint32_t) override {
+        ++calls;
+    }
+};
+
+// Fake object pointers; only their identity matters
+void* Object(uintptr_t id) {
+    return reinterpret_cast<void*>((id + 1) * 16);
+}
+
+/*
+Issue one frame of draws to sink; capture, when given, also receives the per-object
+constants (64 bytes each, so identical matrices dedupe)
+*/
+void IssueFrame(ContextSink& sink, FrameCapture* capture, uint32_t draws) {
+    float constants[16] = {};
+    sink.SetRenderTarget(Object(0), Object(1));
+    sink.SetViewport(0.0f, 0.0f, 1920.0f, 1080.0f);
+    sink.SetInputLayout(Object(2));
+    sink.SetPrimitiveTopology(4);
+    for (uint32_t draw = 0; draw < draws; ++draw) {
+        if (draw % 8 == 0) {
+            const uintptr_t material = 10 + (draw / 8) % 16 * 4;
+            sink.SetVertexShader(Object(material));
+            sink.SetPixelShader(Object(material + 1));
+            sink.SetPixelSampler(0, Object(material + 2));
+            sink.SetBlendState(Object(material + 3), nullptr, 0xFFFFFFFFu);
+        }
+        constants[12] = static_cast<float>(draw % 500);
+        if (capture) {
+            capture->RecordBufferData(Object(3), draw * 256, constants, sizeof(constants));
+        }
+        sink.SetVertexBuffer(0, Object(100 + draw % 64), 28, 0);
+        sink.SetIndexBuffer(Object(200 + draw % 64), 42, 0);
+        sink.SetVertexConstantBuffer(0, Object(3), draw * 16, 16);
+        sink.SetPixelShaderResource(0, Object(300 + draw % 128));
+        sink.DrawIndexed(36 + draw % 7 * 3, 0, 0);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const uint32_t draws   = options.Size(2000, 200);
+    const int repetitions  = options.Size(200, 5);
+
+    CountingSink sink;
+    FrameCapture capture(sink);
+    const uint64_t before = sink.calls;
+    IssueFrame(sink, nullptr, draws);
+    const uint64_t calls = sink.calls - before;
+
+    Bench::Section("%u draws, %llu calls per frame",
+                   draws,
+                   static_cast<unsigned long long>(calls));
+    const double direct = Bench::Best(repetitions, [&] { IssueFrame(sink, nullptr, draws); });
+    const double idle   = Bench::Best(repetitions, [&] { IssueFrame(capture, nullptr, draws); });
+    Bench::Report("sink called directly",
+                  "%8.1f us  %5.2f ns per call",
+                  direct * 1e6,
+                  direct * 1e9 / calls);
+    Bench::Report("through FrameCapture, idle",
+                  "%8.1f us  %5.2f ns per call",
+                  idle * 1e6,
+                  idle * 1e9 / calls);
+
+    std::vector<uint8_t> file;
+    const double capturing = Bench::Best(repetitions, [&] {
+        capture.Begin(1);
+        IssueFrame(capture, &capture, draws);
+        file = capture.End();
+    });
+    const FrameCapture::Stats stats = capture.GetStats();
+    Bench::Report("capturing",
+                  "%8.1f us  %5.2f ns per command  %u commands  %u blobs (%u reused)  %.1f KB",
+                  capturing * 1e6,
+                  capturing * 1e9 / stats.commands,
+                  stats.commands,
+                  stats.blobs,
+                  stats.blobsReused,
+                  static_cast<double>(file.size()) / 1024.0);
+
+    CaptureFile replay;
+    const double load = Bench::Best(repetitions, [&] { replay.Load(file.data(), file.size()); });
+    const double play = Bench::Best(repetitions, [&] { replay.Replay(sink); });
+    Bench::Report("load and validate", "%8.1f us", load * 1e6);
+    Bench::Report("replay into the sink",
+                  "%8.1f us  %5.2f ns per command",
+                  play * 1e6,
+                  play * 1e9 / replay.GetHeader().commandCount);
+    return 0;
+}
@@ -0,0 +1,176 @@
+// Frame Pacer Benchmark
+// Frame-time variance, input-to-display latency and CPU cost of FramePacer's modes on a
+// simulated 60 Hz vsynced flip-model swap chain (frame latency one: Present queues for the
+// next vertical blank, and the next frame waits until it is on screen), with work times that
+// vary from frame to frame and three kinds of OS sleep: exact, a 1 ms timer, and the 15.6 ms
+// default Windows tick. Then paces real frames with the system clock at 240 Hz.
+//
+//   FramePacerBench [--quick]
+#include "Bench.h"
+#include "render/FramePacer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+const int64_t Ms = 1000000;
+
+const int64_t Refresh = 16666667; // 60 Hz
+
+// Simulated time; sleeps wake on the next timer tick plus up to jitter late, spins cost 100 ns
+class SimulatedClock : public PacingClock {
+  public:
+    int64_t time = 0;
+
+    SimulatedClock(int64_t tick, int64_t jitter) : tick(tick), jitter(jitter) {}
+
+    int64_t Now() override {
+        return time;
+    }
+    void Sleep(int64_t ns) override {
+        int64_t wake = time + ns;
+        if (tick > 0) {
+            wake = (wake + tick - 1) / tick * tick;
+        }
+        if (jitter > 0) {
+            wake += rng.Below(static_cast<uint32_t>(jitter));
+        }
+        time = wake;
+    }
+    void Spin() override {
+        time += 100;
+    }
+
+  private:
+    int64_t tick;
+    int64_t jitter;
+    Bench::Rng rng{11};
+};
+
+struct Mode {
+    const char* label;
+    double targetFps;
+    bool lowLatency;
+};
+
+const Mode Modes[] = {
+    {"vsync only", 0.0, false},
+    {"60 fps cap", 60.0, false},
+    {"60 fps low-latency", 60.0, true},
+};
+
+struct Timer {
+    const char* label;
+    int64_t tick;
+    int64_t jitter;
+};
+
+const Timer Timers[] = {
+    {"exact sleep", 0, 0},
+    {"1 ms timer", 1 * Ms, 200000},
+    {"15.6 ms tick", 15625000, 0},
+};
+
+void Simulate(const Mode& mode, const Timer& timer, int frames) {
+    SimulatedClock clock(timer.tick, timer.jitter);
+    FramePacer pacer(&clock);
+    FramePacer::Settings settings;
+    settings.targetFps  = mode.targetFps;
+    settings.lowLatency = mode.lowLatency;
+    pacer.SetSettings(settings);
+
+    // Work of 3 to 7 ms, with a 12 ms spike one frame in fifty
+    Bench::Rng rng(5);
+    const int warmup   = 30;
+    int64_t onScreen   = 0;
+    double displaySum  = 0.0;
+    int64_t lastScreen = 0;
+    double screenSum   = 0.0;
+    double screenSumSq = 0.0;
+    int screenFrames   = 0;
+    for (int frame = 0; frame < warmup + frames; ++frame) {
+        if (frame == warmup) {
+            pacer.ResetStats();
+        }
+        if (onScreen > clock.time) {
+            clock.time = onScreen;
+            pacer.SyncToDisplay(onScreen);
+        }
+        pacer.WaitForFrameStart();
+        const int64_t start = clock.Now();
+        clock.time += rng.Below(50) == 0 ? 12 * Ms : 3 * Ms + rng.Below(4 * Ms);
+        pacer.OnPresent();
+        onScreen = (clock.time / Refresh + 1) * Refresh;
+        if (frame >= warmup) {
+            const double shown = static_cast<double>(onScreen - lastScreen) / Ms;
+            displaySum += static_cast<double>(onScreen - start) / Ms;
+            screenSum += shown;
+            screenSumSq += shown * shown;
+            ++screenFrames;
+        }
+        lastScreen = onScreen;
+    }
+
+    const FramePacer::Stats stats = pacer.GetStats();
+    const double screenMean       = screenSum / screenFrames;
+    const double screenDev =
+        std::sqrt(std::max(screenSumSq / screenFrames - screenMean * screenMean, 0.0));
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s, %s", mode.label, timer.label);
+    Bench::Report(label,
+                  "shown %5.2f +- %5.2f ms  to display %5.2f ms  spin %4.2f ms  missed %u",
+                  screenMean,
+                  screenDev,
+                  displaySum / screenFrames,
+                  stats.spinMs,
+                  stats.missed);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int frames       = static_cast<int>(options.Size(6000, 300));
+
+    Bench::Section("Simulated 60 Hz display, %d frames of 3-7 ms work", frames);
+    for (const Mode& mode : Modes) {
+        for (const Timer& timer : Timers) {
+            if (mode.targetFps == 0.0 && timer.tick != 0) {
+                continue; // Nothing sleeps without a target rate
+            }
+            Simulate(mode, timer, frames);
+        }
+    }
+
+    // The system clock: how close real sleeps plus the adaptive spin come to the schedule
+    const int realFrames = static_cast<int>(options.Size(960, 48));
+    Bench::Section("System clock, 240 fps target, %d frames of 1 ms work", realFrames);
+    FramePacer pacer;
+    std::unique_ptr<PacingClock> workClock = PacingClock::CreateSystemClock();
+    FramePacer::Settings settings;
+    settings.targetFps = 240.0;
+    pacer.SetSettings(settings);
+    for (int frame = 0; frame < realFrames; ++frame) {
+        pacer.WaitForFrameStart();
+        const int64_t end = workClock->Now() + 1 * Ms;
+        while (workClock->Now() < end) {
+            workClock->Spin();
+        }
+        pacer.OnPresent();
+    }
+    const FramePacer::Stats stats = pacer.GetStats();
+    Bench::Report("frame time",
+                  "%6.3f +- %6.3f ms, worst %6.3f ms",
+                  stats.frameMs,
+                  stats.frameDevMs,
+                  stats.maxFrameMs);
+    Bench::Report("per frame",
+                  "%6.3f ms asleep, %6.3f ms spinning, margin %6.3f ms",
+                  stats.sleepMs,
+                  stats.spinMs,
+                  stats.spinMarginMs);
+    Bench::Report("missed", "%u", stats.missed);
+    return 0;
+}
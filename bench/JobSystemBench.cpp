@@ -0,0 +1,101 @@
+// Job System Benchmark
+// Scheduler throughput versus thread count: jobs/s for empty jobs (pure scheduling cost) and
+// for jobs carrying a few microseconds of work (scaling), submitted from worker 0, plus the
+// speedup of a ParallelFor over an arithmetic loop. Steal counts show how much work moved.
+//
+//   JobSystemBench [--quick]
+#include "Bench.h"
+#include "threading/JobSystem.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Work {
+    uint32_t iterations = 0;
+};
+
+// Serial dependency chain so the compiler cannot fold the loop
+uint32_t Spin(uint32_t iterations, uint32_t seed) {
+    uint32_t x = seed | 1u;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+    return x;
+}
+
+void WorkJob(const Job& job) {
+    const Work& work = *static_cast<const Work*>(job.data);
+    Bench::DoNotOptimize(Spin(work.iterations, job.begin));
+}
+
+// Jobs/s for jobCount jobs of the given size, submitted in batches of QueueCapacity
+double JobsPerSecond(JobSystem& jobSystem, uint32_t jobCount, uint32_t iterations, int reps) {
+    Work work;
+    work.iterations = iterations;
+    double seconds  = Bench::Best(reps, [&] {
+        for (uint32_t first = 0; first < jobCount; first += JobSystem::QueueCapacity) {
+            const uint32_t last = std::min(jobCount, first + JobSystem::QueueCapacity);
+            JobCounter counter;
+            for (uint32_t i = first; i < last; ++i) {
+                jobSystem.Run(WorkJob, &work, i, i + 1, &counter);
+            }
+            jobSystem.Wait(counter);
+        }
+    });
+    return jobCount / seconds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 5;
+    const uint32_t jobs    = options.Size(1000000, 20000);
+    const uint32_t loop    = options.Size(1 << 26, 1 << 18);
+
+    const uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<uint32_t> threadCounts = {1, 2, 4, 8};
+    if (std::find(threadCounts.begin(), threadCounts.end(), hardware) == threadCounts.end()) {
+        threadCounts.push_back(hardware);
+    }
+
+    // Single-threaded baseline for the ParallelFor speedup
+    const uint32_t chunk = 4096;
+    double serial        = Bench::Best(repetitions, [&] {
+        for (uint32_t begin = 0; begin < loop; begin += chunk) {
+            Bench::DoNotOptimize(Spin(chunk, begin));
+        }
+    });
+
+    Bench::Section("JobSystem: %u jobs, %u hardware threads", jobs, hardware);
+    for (uint32_t threads : threadCounts) {
+        JobSystem jobSystem;
+        jobSystem.Initialize(threads);
+        jobSystem.ResetStats();
+
+        double empty    = JobsPerSecond(jobSystem, jobs, 0, repetitions);
+        double small    = JobsPerSecond(jobSystem, jobs / 10, 2000, repetitions);
+        double parallel = Bench::Best(repetitions, [&] {
+            jobSystem.ParallelFor(loop / chunk, 0, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i) {
+                    Bench::DoNotOptimize(Spin(chunk, i * chunk));
+                }
+            });
+        });
+        JobSystem::Stats stats = jobSystem.GetStats();
+        jobSystem.Shutdown();
+
+        Bench::Section("%u thread%s", threads, threads == 1 ? "" : "s");
+        Bench::Report("empty jobs/s", "%.2f M", empty / 1e6);
+        Bench::Report("~2k-iteration jobs/s", "%.2f M", small / 1e6);
+        Bench::Report("ParallelFor speedup vs serial loop", "%.2fx", serial / parallel);
+        Bench::Report("jobs stolen",
+                      "%.1f %%",
+                      100.0 * stats.jobsStolen / std::max<uint64_t>(1, stats.jobsExecuted));
+    }
+    return 0;
+}
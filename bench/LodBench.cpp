@@ -0,0 +1,241 @@
+// LOD Benchmark
+// Offline LOD chain generation with MeshSimplifier and runtime selection with LodSelector.
+// First, chains for 16 tori whose wrap-around rows and columns are UV-style seams (same
+// position, separate vertices), built serially and with one task per mesh on the job system.
+// Then a dense scene of tori on a grid using the first chain, seen by a camera flying low
+// across it at 60 Hz, 1080p, 60 degrees: triangles drawn at LOD 0 against the levels chosen
+// within 1 pixel, the cost of Select, and how often an object switches level and back again
+// within half a second, with and without hysteresis.
+//
+//   LodBench [--quick]
+#include "Bench.h"
+#include "render/MeshSimplifier.h"
+#include "scene/LodSelector.h"
+#include "threading/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const float FovY           = 1.04719755f; // 60 degrees
+const float ViewportHeight = 1080.0f;
+const uint32_t FrameRate   = 60;
+
+struct Mesh {
+    std::vector<float> positions;
+    std::vector<uint32_t> indices;
+
+    MeshSimplifier::Input Input() const {
+        return {indices.data(),
+                static_cast<uint32_t>(indices.size()),
+                positions.data(),
+                static_cast<uint32_t>(positions.size() / 3),
+                3 * sizeof(float)};
+    }
+};
+
+// A (rings + 1) x (sides + 1) lattice: the last row and column repeat the first positions
+Mesh Torus(uint32_t rings, uint32_t sides, float minor, Bench::Rng& rng) {
+    const float major = 1.0f;
+    Mesh mesh;
+    for (uint32_t ring = 0; ring <= rings; ++ring) {
+        const float u = 6.28318531f * static_cast<float>(ring % rings) / static_cast<float>(rings);
+        for (uint32_t side = 0; side <= sides; ++side) {
+            const float v =
+                6.28318531f * static_cast<float>(side % sides) / static_cast<float>(sides);
+            // Small bumps, so the surface is not perfectly regular
+            const float r      = minor * (1.0f + 0.02f * rng.Range(-1.0f, 1.0f));
+            const float radius = major + r * std::cos(v);
+            const float p[3]   = {radius * std::cos(u), r * std::sin(v), radius * std::sin(u)};
+            mesh.positions.insert(mesh.positions.end(), p, p + 3);
+        }
+    }
+    for (uint32_t ring = 0; ring < rings; ++ring) {
+        for (uint32_t side = 0; side < sides; ++side) {
+            const uint32_t a       = ring * (sides + 1) + side;
+            const uint32_t b       = a + sides + 1;
+            const uint32_t quad[6] = {a, a + 1, b, a + 1, b + 1, b};
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    }
+    return mesh;
+}
+
+void BuildChains(const char* label,
+                 const MeshSimplifier& simplifier,
+                 const std::vector<MeshSimplifier::Input>& inputs,
+                 std::vector<MeshSimplifier::Chain>& chains,
+                 int repetitions) {
+    uint64_t triangles = 0;
+    for (const MeshSimplifier::Input& input : inputs) {
+        triangles += input.indexCount / 3;
+    }
+    chains.assign(inputs.size(), MeshSimplifier::Chain());
+    const double seconds = Bench::Best(repetitions, [&] {
+        simplifier.BuildChains(chains.data(),
+                               inputs.data(),
+                               static_cast<uint32_t>(inputs.size()),
+                               MeshSimplifier::DefaultChainSettings());
+    });
+    Bench::Report(label,
+                  "%8.1f ms  %5.2f Mtri/s",
+                  seconds * 1e3,
+                  static_cast<double>(triangles) / seconds * 1e-6);
+}
+
+struct Flight {
+    uint64_t fullTriangles     = 0;
+    uint64_t selectedTriangles = 0;
+    uint64_t changes           = 0;
+    uint64_t reversals         = 0; // Changes undoing the object's previous one within 0.5 s
+    double selectSeconds       = 0.0;
+};
+
+/*
+Fly the camera along the grid's diagonal at a height of 2 units for frames frames
+levelTriangles: Triangle count of each level of the chain every object uses
+*/
+Flight Fly(LodSelector& selector,
+           std::vector<LodSelector::Object> objects,
+           const std::vector<uint32_t>& levelTriangles,
+           float extent,
+           uint32_t frames) {
+    Flight flight;
+    const uint32_t count = static_cast<uint32_t>(objects.size());
+    std::vector<uint32_t> previousLod(count, 0);
+    std::vector<int32_t> lastDirection(count, 0);
+    std::vector<uint32_t> lastChange(count, 0);
+    for (uint32_t frame = 0; frame <= frames; ++frame) {
+        const float t         = static_cast<float>(frame) / static_cast<float>(frames);
+        const float camera[3] = {-0.1f * extent + 1.2f * extent * t,
+                                 2.0f,
+                                 -0.1f * extent + 1.2f * extent * t};
+        selector.SetCamera(camera);
+        if (frame == 0) {
+            // Settle at the start of the path; only the flight itself is counted
+            selector.Select(objects.data(), count);
+            for (uint32_t i = 0; i < count; ++i) {
+                previousLod[i] = objects[i].lod;
+            }
+            continue;
+        }
+
+        const Bench::Clock::time_point start = Bench::Clock::now();
+        flight.changes += selector.Select(objects.data(), count);
+        flight.selectSeconds += Bench::Seconds(Bench::Clock::now() - start);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t lod = objects[i].lod;
+            flight.fullTriangles += levelTriangles[0];
+            flight.selectedTriangles += levelTriangles[lod];
+            if (lod == previousLod[i]) {
+                continue;
+            }
+            const int32_t direction = lod > previousLod[i] ? 1 : -1;
+            if (direction == -lastDirection[i] &&
+                frame - lastChange[i] < FrameRate / 2) {
+                ++flight.reversals;
+            }
+            lastDirection[i] = direction;
+            lastChange[i]    = frame;
+            previousLod[i]   = lod;
+        }
+    }
+    return flight;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 3;
+    const uint32_t rings   = options.Size(176, 48);
+    const uint32_t sides   = options.Size(88, 24);
+    const uint32_t side    = options.Size(100, 20);
+    const uint32_t frames  = options.Size(600, 60);
+
+    // ========================================
+    // 1. CHAIN GENERATION
+    // ========================================
+    Bench::Rng rng(22);
+    std::vector<Mesh> meshes;
+    std::vector<MeshSimplifier::Input> inputs;
+    for (uint32_t i = 0; i < 16; ++i) {
+        meshes.push_back(Torus(rings, sides, rng.Range(0.2f, 0.45f), rng));
+    }
+    for (const Mesh& mesh : meshes) {
+        inputs.push_back(mesh.Input());
+    }
+    Bench::Section("16 seamed tori of %u triangles, default chain settings", rings * sides * 2);
+    MeshSimplifier simplifier;
+    std::vector<MeshSimplifier::Chain> chains;
+    BuildChains("serial", simplifier, inputs, chains, repetitions);
+
+    JobSystem jobSystem;
+    jobSystem.Initialize();
+    simplifier.SetParallelFor(jobSystem.GetTaskExecutor());
+    char label[64];
+    const uint32_t threads = jobSystem.GetThreadCount();
+    std::snprintf(label,
+                  sizeof(label),
+                  "one task per mesh, %u thread%s",
+                  threads,
+                  threads == 1 ? "" : "s");
+    BuildChains(label, simplifier, inputs, chains, repetitions);
+    jobSystem.Shutdown();
+
+    const MeshSimplifier::Chain& chain = chains[0];
+    std::vector<float> errors;
+    std::vector<uint32_t> levelTriangles;
+    for (const MeshSimplifier::Lod& lod : chain.lods) {
+        errors.push_back(lod.error);
+        levelTriangles.push_back(lod.indexCount / 3);
+        std::snprintf(label, sizeof(label), "torus 0, LOD %zu", levelTriangles.size() - 1);
+        Bench::Report(label, "%8u triangles  error %.5f", levelTriangles.back(), lod.error);
+    }
+
+    // ========================================
+    // 2. SELECTION IN A DENSE SCENE
+    // ========================================
+    const float spacing = 4.0f;
+    std::vector<LodSelector::Object> objects;
+    LodSelector selector;
+    const uint32_t chainId = selector.AddChain(errors.data(), static_cast<uint32_t>(errors.size()));
+    for (uint32_t y = 0; y < side; ++y) {
+        for (uint32_t x = 0; x < side; ++x) {
+            const float scale = rng.Range(0.5f, 2.0f);
+            LodSelector::Object object;
+            object.center[0] = (static_cast<float>(x) + 0.5f) * spacing;
+            object.center[1] = 0.0f;
+            object.center[2] = (static_cast<float>(y) + 0.5f) * spacing;
+            object.radius    = 1.45f * scale;
+            object.scale     = scale;
+            object.chain     = chainId;
+            object.lod       = 0;
+            objects.push_back(object);
+        }
+    }
+    selector.SetProjection(FovY, ViewportHeight, 0.1f);
+    selector.SetThreshold(1.0f);
+
+    Bench::Section("%u tori, 1080p, 1 pixel, %u frames at %u Hz", side * side, frames, FrameRate);
+    const float hystereses[] = {0.0f, 0.25f, 0.5f};
+    for (float hysteresis : hystereses) {
+        selector.SetHysteresis(hysteresis);
+        const Flight flight = Fly(selector, objects, levelTriangles, side * spacing, frames);
+        std::snprintf(label, sizeof(label), "hysteresis %.2f", hysteresis);
+        Bench::Report(label,
+                      "%6.2f M of %7.2f M tris/frame (%4.1f%% saved)  select %.3f ms  "
+                      "%6llu changes  %5llu reversals",
+                      static_cast<double>(flight.selectedTriangles) / frames * 1e-6,
+                      static_cast<double>(flight.fullTriangles) / frames * 1e-6,
+                      100.0 - 100.0 * static_cast<double>(flight.selectedTriangles) /
+                                  static_cast<double>(flight.fullTriangles),
+                      flight.selectSeconds * 1e3 / frames,
+                      static_cast<unsigned long long>(flight.changes),
+                      static_cast<unsigned long long>(flight.reversals));
+    }
+    return 0;
+}
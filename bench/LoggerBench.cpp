@@ -0,0 +1,184 @@
+// Logger Benchmark
+// Throughput and caller-side latency of the asynchronous Logger against the pattern it
+// replaced, std::cout << ... << std::endl (a synchronous flush per line), with several
+// producer threads. Both write to a file, so the comparison is not skewed by a terminal.
+// Also times the common failure case: one call site firing every iteration, which the
+// per-site rate limit turns into a handful of lines. Last, the caller's cost alone, in batches
+// the queue always has room for: packing the arguments for the background thread against
+// formatting them on the spot with vsnprintf, as producers used to.
+//
+//   LoggerBench [--quick]
+#include "Bench.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* const BaselinePath = "LoggerBench.cout.log";
+const char* const LoggerPath   = "LoggerBench.log";
+
+struct Result {
+    double seconds = 0.0;        // First call until everything is written and flushed
+    std::vector<double> latency; // Caller-side nanoseconds per message, all threads
+};
+
+// Run produce(thread, index) for perThread messages on threadCount threads
+template <typename Produce>
+Result Run(uint32_t threadCount, uint32_t perThread, Produce&& produce) {
+    Result result;
+    std::vector<std::vector<double>> latencies(threadCount);
+    Bench::Clock::time_point start = Bench::Clock::now();
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<double>& latency = latencies[t];
+            latency.reserve(perThread);
+            for (uint32_t i = 0; i < perThread; ++i) {
+                Bench::Clock::time_point before = Bench::Clock::now();
+                produce(t, i);
+                latency.push_back(Bench::Seconds(Bench::Clock::now() - before) * 1e9);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    Logger::Get().Flush();
+    result.seconds = Bench::Seconds(Bench::Clock::now() - start);
+
+    for (const std::vector<double>& latency : latencies) {
+        result.latency.insert(result.latency.end(), latency.begin(), latency.end());
+    }
+    return result;
+}
+
+// messages: what the rate counts (lines written, or calls made)
+void Print(const char* label, uint64_t messages, Result& result) {
+    std::sort(result.latency.begin(), result.latency.end());
+    double sum = 0.0;
+    for (double latency : result.latency) {
+        sum += latency;
+    }
+    const size_t count = std::max<size_t>(1, result.latency.size());
+    Bench::Report(label,
+                  "%8.2f M msg/s  caller avg %8.1f ns  p99 %9.1f ns",
+                  messages / result.seconds / 1e6,
+                  sum / count,
+                  result.latency[std::min(count - 1, count * 99 / 100)]);
+}
+
+// What a producer paid before formatting moved to the background thread
+void FormatLikeTheCaller(char* out, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(out, Logger::MessageSize, format, args);
+    va_end(args);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options  = Bench::Options::Parse(argc, argv);
+    const uint32_t messages = options.Size(400000, 20000); // Per run, split across threads
+
+    Logger::Get().SetConsole(false);
+    Logger::Get().SetFile(LoggerPath);
+
+    // The old pattern, with cout pointed at a file
+    std::filebuf coutFile;
+    coutFile.open(BaselinePath, std::ios::out | std::ios::trunc);
+    std::streambuf* consoleBuffer = std::cout.rdbuf(&coutFile);
+
+    Bench::Section("Logger: %u messages per run", messages);
+    for (uint32_t threads : {1u, 2u, 4u}) {
+        const uint32_t perThread = messages / threads;
+        Bench::Section("%u producer%s", threads, threads == 1 ? "" : "s");
+
+        Result baseline = Run(threads, perThread, [](uint32_t t, uint32_t i) {
+            std::cout << "Frame " << i << ": device is null (thread " << t << ")" << std::endl;
+        });
+        Print("std::cout << std::endl", uint64_t(threads) * perThread, baseline);
+
+        // One site per message index, so the rate limit never applies
+        std::vector<std::unique_ptr<LogSite[]>> sites;
+        for (uint32_t t = 0; t < threads; ++t) {
+            sites.emplace_back(new LogSite[perThread]);
+            for (uint32_t i = 0; i < perThread; ++i) {
+                sites[t][i].file  = __FILE__;
+                sites[t][i].line  = static_cast<int>(i);
+                sites[t][i].level = LogLevel::Error;
+            }
+        }
+        const Logger::Stats before = Logger::Get().GetStats();
+
+        Result logger = Run(threads, perThread, [&sites](uint32_t t, uint32_t i) {
+            Logger::Get().Write(sites[t][i], "Frame %u: device is null (thread %u)", i, t);
+        });
+
+        // A producer never waits for the writer: what the queue cannot take is dropped, so
+        // the rate counts written messages only
+        const Logger::Stats after = Logger::Get().GetStats();
+        Print("Logger, distinct sites", after.written - before.written, logger);
+        Bench::Report("  dropped (queue full)",
+                      "%llu",
+                      static_cast<unsigned long long>(after.dropped - before.dropped));
+
+        // Every thread hammering one LOG_ERROR site, as a per-frame error would
+        Result hot = Run(threads, perThread, [](uint32_t t, uint32_t i) {
+            LOG_ERROR("Frame %u: device is null (thread %u)", i, t);
+        });
+        Print("Logger, one rate-limited site (calls)", uint64_t(threads) * perThread, hot);
+    }
+
+    // Single producer, batches of half the queue with a Flush between them (not timed)
+    Bench::Section("Caller cost, queue never full");
+    const uint32_t batch = Logger::QueueCapacity / 2;
+    const uint32_t runs  = std::max(1u, messages / batch);
+    std::unique_ptr<LogSite[]> sites(new LogSite[batch]);
+    for (uint32_t i = 0; i < batch; ++i) {
+        sites[i].file  = __FILE__;
+        sites[i].line  = static_cast<int>(i);
+        sites[i].level = LogLevel::Error;
+    }
+    const char* const format = "Frame %u: %s failed (hr 0x%08X, %.2f ms, thread %u)";
+    double packed            = 0.0;
+    for (uint32_t run = 0; run < runs; ++run) {
+        Bench::Clock::time_point start = Bench::Clock::now();
+        for (uint32_t i = 0; i < batch; ++i) {
+            Logger::Get().Write(sites[i], format, i, "CreateBuffer", 0x887A0005u, 1.25, 0u);
+        }
+        packed += Bench::Seconds(Bench::Clock::now() - start);
+        Logger::Get().Flush();
+        for (uint32_t i = 0; i < batch; ++i) {
+            sites[i].windowStart.store(0, std::memory_order_relaxed); // Reopen every window
+            sites[i].windowCount.store(0, std::memory_order_relaxed);
+        }
+    }
+    char text[Logger::MessageSize];
+    Bench::Clock::time_point start = Bench::Clock::now();
+    for (uint32_t run = 0; run < runs; ++run) {
+        for (uint32_t i = 0; i < batch; ++i) {
+            FormatLikeTheCaller(text, format, i, "CreateBuffer", 0x887A0005u, 1.25, 0u);
+            Bench::DoNotOptimize(text[0]);
+        }
+    }
+    const double formatted = Bench::Seconds(Bench::Clock::now() - start);
+    const double calls     = static_cast<double>(runs) * batch;
+    Bench::Report("Logger::Write (arguments packed)", "%8.1f ns/call", packed * 1e9 / calls);
+    Bench::Report("vsnprintf alone (old caller work)", "%8.1f ns/call", formatted * 1e9 / calls);
+
+    std::cout.rdbuf(consoleBuffer);
+    coutFile.close();
+    Logger::Get().SetFile("");
+    std::remove(BaselinePath);
+    std::remove(LoggerPath);
+    return 0;
+}
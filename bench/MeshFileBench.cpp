@@ -0,0 +1,271 @@
+// Mesh File Benchmark
+// Load time and peak memory of one model as text OBJ (parsed with MeshImport, the converter's
+// reader) against the MeshFile containers MeshConverter writes from it: packed vertices,
+// float vertices, and packed with LZ4. Every load ends with each vertex and index byte read
+// once, as CreateBuffer would. Times are warm (files in the page cache). On Linux each load
+// also runs alone in a fresh process (the benchmark re-executed with --peak), and its peak
+// resident memory (file pages it maps included) above that of a process that loads nothing
+// is reported.
+//
+//   MeshFileBench [--quick]
+#include "Bench.h"
+#include "MeshImport.h"
+#include "render/MeshFile.h"
+#include "render/VertexEncoder.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <stdio.h> // popen
+#endif
+
+namespace {
+
+const char* const ObjPath = "MeshFileBench.obj";
+
+const int PartCount = 4;
+
+/*
+A colored height field of about triangleCount triangles over [-1, 1], in PartCount groups
+with their own vertices, the shape a converted scan or terrain tile has
+*/
+bool WriteObj(uint32_t triangleCount) {
+    FILE* file = std::fopen(ObjPath, "w");
+    if (!file) {
+        return false;
+    }
+    Bench::Rng rng;
+    const double perPart = triangleCount / (2.0 * PartCount);
+    const uint32_t cells = std::max(1u, static_cast<uint32_t>(std::sqrt(perPart)));
+    uint32_t first       = 1; // OBJ indices are 1-based and global
+    for (int part = 0; part < PartCount; ++part) {
+        std::fprintf(file, "g Part%d\n", part);
+        for (uint32_t y = 0; y <= cells; ++y) {
+            for (uint32_t x = 0; x <= cells; ++x) {
+                std::fprintf(file,
+                             "v %.6f %.6f %.6f %.4f %.4f %.4f\n",
+                             -1.0f + 2.0f * x / cells,
+                             rng.Range(-0.1f, 0.1f) + 0.2f * part - 0.3f,
+                             -1.0f + 2.0f * y / cells,
+                             rng.Unit(),
+                             rng.Unit(),
+                             rng.Unit());
+            }
+        }
+        for (uint32_t y = 0; y < cells; ++y) {
+            for (uint32_t x = 0; x < cells; ++x) {
+                const uint32_t a = first + y * (cells + 1) + x;
+                const uint32_t b = a + cells + 1;
+                std::fprintf(file, "f %u %u %u\nf %u %u %u\n", a, b, a + 1, a + 1, b, b + 1);
+            }
+        }
+        first += (cells + 1) * (cells + 1);
+    }
+    return std::fclose(file) == 0;
+}
+
+struct MeshVariant {
+    const char* label;
+    const char* path;
+    bool packed;
+    bool compress;
+};
+
+const MeshVariant Variants[] = {
+    {"mesh, packed", "MeshFileBench.packed.mesh", true, false},
+    {"mesh, float", "MeshFileBench.float.mesh", false, false},
+    {"mesh, packed + LZ4", "MeshFileBench.lz4.mesh", true, true},
+};
+
+// The containers MeshConverter would write for mesh with --no-optimize (and --float)
+bool WriteMeshes(const ImportedMesh& mesh) {
+    float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (const Vertex& vertex : mesh.vertices) {
+        for (int axis = 0; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], vertex.position[axis]);
+            max[axis] = std::max(max[axis], vertex.position[axis]);
+        }
+    }
+    const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    std::vector<PackedVertex> packed(vertexCount);
+    VertexEncoder::EncodeVertices(mesh.vertices.data(), vertexCount, packed.data());
+
+    for (const MeshVariant& variant : Variants) {
+        MeshFileWriter writer;
+        if (variant.packed) {
+            writer.SetVertices(packed.data(), vertexCount);
+        } else {
+            writer.SetVertices(mesh.vertices.data(), vertexCount);
+        }
+        writer.SetIndices(mesh.indices.data(), static_cast<uint32_t>(mesh.indices.size()));
+        writer.SetBounds(min, max);
+        for (const ImportedMesh::Part& part : mesh.parts) {
+            writer.AddSubmesh(part.name,
+                              part.indexStart,
+                              part.indexCount,
+                              part.baseVertex,
+                              part.vertexCount,
+                              min,
+                              max);
+        }
+        if (!writer.Write(variant.path, variant.compress)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sum of the 64-bit words of size bytes, so every byte is read
+uint64_t SumWords(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t sum         = 0;
+    for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + i, std::min(sizeof(word), size - i));
+        sum += word;
+    }
+    return sum;
+}
+
+// Parse the OBJ, then read back every vertex and index
+uint64_t LoadObj() {
+    ImportedMesh mesh;
+    std::string error;
+    if (!MeshImport::ImportObj(ObjPath, mesh, error)) {
+        return 0;
+    }
+    return SumWords(mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex)) +
+           SumWords(mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+}
+
+// Map (and for LZ4, decode) the file, then read back every vertex and index
+uint64_t LoadMesh(const char* path) {
+    MeshFile mesh;
+    if (!mesh.Open(path)) {
+        return 0;
+    }
+    return SumWords(mesh.GetVertexData(), mesh.GetVertexDataSize()) +
+           SumWords(mesh.GetIndexData(), mesh.GetIndexDataSize());
+}
+
+double FileMegabytes(const char* path) {
+    FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        return 0.0;
+    }
+    std::fseek(file, 0, SEEK_END);
+    const long size = std::ftell(file);
+    std::fclose(file);
+    return size / 1048576.0;
+}
+
+#ifdef __linux__
+// Peak resident set of this process so far (VmHWM), in bytes
+double PeakBytes() {
+    FILE* status = std::fopen("/proc/self/status", "r");
+    if (!status) {
+        return 0.0;
+    }
+    char line[256];
+    double kilobytes = 0.0;
+    while (std::fgets(line, sizeof(line), status)) {
+        if (std::sscanf(line, "VmHWM: %lf kB", &kilobytes) == 1) {
+            break;
+        }
+    }
+    std::fclose(status);
+    return kilobytes * 1024.0;
+}
+
+/*
+Peak resident set of a new copy of this program that loads path ("" loads nothing)
+A forked child would start with this process's heap, freed blocks included, and allocate
+into it without its peak growing; getrusage's ru_maxrss even survives exec
+*/
+double ChildPeakBytes(const char* program, const char* path) {
+    const std::string command = std::string("\"") + program + "\" --peak \"" + path + "\"";
+    FILE* child               = popen(command.c_str(), "r");
+    if (!child) {
+        return 0.0;
+    }
+    double bytes = 0.0;
+    if (std::fscanf(child, "%lf", &bytes) != 1) {
+        bytes = 0.0;
+    }
+    pclose(child);
+    return bytes;
+}
+#endif
+
+} // namespace
+
+int main(int argc, char** argv) {
+#ifdef __linux__
+    if (argc == 3 && std::strcmp(argv[1], "--peak") == 0) {
+        const std::string path = argv[2];
+        if (path == ObjPath) {
+            Bench::DoNotOptimize(LoadObj());
+        } else if (!path.empty()) {
+            Bench::DoNotOptimize(LoadMesh(path.c_str()));
+        }
+        std::printf("%.0f\n", PeakBytes());
+        return 0;
+    }
+#endif
+
+    Bench::Options options       = Bench::Options::Parse(argc, argv);
+    const int repetitions        = options.quick ? 1 : 5;
+    const uint32_t triangleCount = options.Size(1000000, 20000);
+
+    uint32_t vertexCount = 0;
+    uint32_t triangles   = 0;
+    {
+        ImportedMesh mesh;
+        std::string error;
+        if (!WriteObj(triangleCount) || !MeshImport::ImportObj(ObjPath, mesh, error) ||
+            !WriteMeshes(mesh)) {
+            std::fprintf(stderr,
+                         "MeshFileBench: could not write the test model %s\n",
+                         error.c_str());
+            return 1;
+        }
+        vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+        triangles   = static_cast<uint32_t>(mesh.indices.size() / 3);
+    }
+    Bench::Section("%u triangles, %u vertices in %d parts", triangles, vertexCount, PartCount);
+
+    const double obj = Bench::Best(repetitions, [&] { Bench::DoNotOptimize(LoadObj()); });
+    Bench::Report("OBJ text", "%8.2f ms  %7.1f MB file", obj * 1e3, FileMegabytes(ObjPath));
+    for (const MeshVariant& variant : Variants) {
+        const double seconds = Bench::Best(repetitions, [&] {
+            Bench::DoNotOptimize(LoadMesh(variant.path));
+        });
+        Bench::Report(variant.label,
+                      "%8.2f ms  %7.1f MB file",
+                      seconds * 1e3,
+                      FileMegabytes(variant.path));
+    }
+
+#ifdef __linux__
+    Bench::Section("Peak memory above an empty process");
+    const double baseline = ChildPeakBytes(argv[0], "");
+    Bench::Report("OBJ text",
+                  "%8.1f MB",
+                  (ChildPeakBytes(argv[0], ObjPath) - baseline) / 1048576.0);
+    for (const MeshVariant& variant : Variants) {
+        const double peak = ChildPeakBytes(argv[0], variant.path);
+        Bench::Report(variant.label, "%8.1f MB", (peak - baseline) / 1048576.0);
+    }
+#endif
+
+    std::remove(ObjPath);
+    for (const MeshVariant& variant : Variants) {
+        std::remove(variant.path);
+    }
+    return 0;
+}
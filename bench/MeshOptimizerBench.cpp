@@ -0,0 +1,299 @@
+// Mesh Optimizer Benchmark
+// MeshConverter's optimization pipeline over a synthetic corpus: weld, vertex cache order,
+// overdraw order, fetch order and meshlets, as Optimize runs them on every part. Regular
+// grids and spheres come as generated (already fairly cache friendly), a sphere as an
+// unwelded triangle soup, and a torus and nested spheres with their triangles shuffled, as
+// exporters that lose the mesh order produce them. Reports for every model the vertices
+// before and after welding, ACMR and ATVR (FIFO of 16) and overdraw from the six axis views
+// before and after, and the pipeline's throughput.
+//
+//   MeshOptimizerBench [--quick]
+#include "Bench.h"
+#include "render/MeshOptimizer.h"
+#include "render/RenderBackend.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Model {
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+
+    uint32_t VertexCount() const {
+        return static_cast<uint32_t>(vertices.size());
+    }
+    uint32_t IndexCount() const {
+        return static_cast<uint32_t>(indices.size());
+    }
+};
+
+Vertex MakeVertex(float x, float y, float z) {
+    Vertex vertex;
+    vertex.position[0] = x;
+    vertex.position[1] = y;
+    vertex.position[2] = z;
+    vertex.color[0]    = 0.5f + 0.5f * x;
+    vertex.color[1]    = 0.5f + 0.5f * y;
+    vertex.color[2]    = 0.5f + 0.5f * z;
+    vertex.color[3]    = 1.0f;
+    return vertex;
+}
+
+// Two triangles per cell of a (columns + 1) x (rows + 1) vertex lattice starting at first
+void AddQuads(Model& model, uint32_t first, uint32_t columns, uint32_t rows) {
+    for (uint32_t y = 0; y < rows; ++y) {
+        for (uint32_t x = 0; x < columns; ++x) {
+            const uint32_t a       = first + y * (columns + 1) + x;
+            const uint32_t b       = a + columns + 1;
+            const uint32_t quad[6] = {a, b, a + 1, a + 1, b, b + 1};
+            model.indices.insert(model.indices.end(), quad, quad + 6);
+        }
+    }
+}
+
+/*
+Wind every triangle of [firstIndex, end) so its front face (the optimizer's convention)
+points away from inside(centroid), the nearest interior point
+*/
+template <typename Inside>
+void FaceOutward(Model& model, size_t firstIndex, Inside inside) {
+    for (size_t i = firstIndex; i + 2 < model.indices.size(); i += 3) {
+        const float* a        = model.vertices[model.indices[i]].position;
+        const float* b        = model.vertices[model.indices[i + 1]].position;
+        const float* c        = model.vertices[model.indices[i + 2]].position;
+        const float e1[3]     = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        const float e2[3]     = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        const float normal[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                                 e1[2] * e2[0] - e1[0] * e2[2],
+                                 e1[0] * e2[1] - e1[1] * e2[0]};
+        const float middle[3] = {(a[0] + b[0] + c[0]) / 3.0f,
+                                 (a[1] + b[1] + c[1]) / 3.0f,
+                                 (a[2] + b[2] + c[2]) / 3.0f};
+        float center[3];
+        inside(middle, center);
+        float outward = 0.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            outward += normal[axis] * (middle[axis] - center[axis]);
+        }
+        if (outward < 0.0f) {
+            std::swap(model.indices[i + 1], model.indices[i + 2]);
+        }
+    }
+}
+
+Model Grid(uint32_t cells) {
+    Model model;
+    model.name = "grid " + std::to_string(cells) + "x" + std::to_string(cells);
+    for (uint32_t y = 0; y <= cells; ++y) {
+        for (uint32_t x = 0; x <= cells; ++x) {
+            const float u = -1.0f + 2.0f * static_cast<float>(x) / static_cast<float>(cells);
+            const float v = -1.0f + 2.0f * static_cast<float>(y) / static_cast<float>(cells);
+            model.vertices.push_back(MakeVertex(u, 0.0f, v));
+        }
+    }
+    AddQuads(model, 0, cells, cells);
+    FaceOutward(model, 0, [](const float p[3], float center[3]) {
+        center[0] = p[0];
+        center[1] = -1.0f;
+        center[2] = p[2];
+    });
+    return model;
+}
+
+void AddSphere(Model& model, uint32_t slices, uint32_t stacks, float radius, float offset) {
+    const uint32_t first    = model.VertexCount();
+    const size_t firstIndex = model.indices.size();
+    for (uint32_t stack = 0; stack <= stacks; ++stack) {
+        const float theta = 3.14159265f * static_cast<float>(stack) / static_cast<float>(stacks);
+        for (uint32_t slice = 0; slice <= slices; ++slice) {
+            const float phi = 6.28318531f * static_cast<float>(slice) / static_cast<float>(slices);
+            model.vertices.push_back(MakeVertex(offset + radius * std::sin(theta) * std::cos(phi),
+                                                radius * std::cos(theta),
+                                                radius * std::sin(theta) * std::sin(phi)));
+        }
+    }
+    AddQuads(model, first, slices, stacks);
+    FaceOutward(model, firstIndex, [offset](const float*, float center[3]) {
+        center[0] = offset;
+        center[1] = 0.0f;
+        center[2] = 0.0f;
+    });
+}
+
+Model Sphere(uint32_t slices, uint32_t stacks) {
+    Model model;
+    model.name = "sphere " + std::to_string(slices) + "x" + std::to_string(stacks);
+    AddSphere(model, slices, stacks, 1.0f, 0.0f);
+    return model;
+}
+
+Model Torus(uint32_t rings, uint32_t sides) {
+    const float major = 1.0f;
+    const float minor = 0.35f;
+    Model model;
+    model.name = "torus " + std::to_string(rings * sides * 2) + " tris";
+    for (uint32_t ring = 0; ring <= rings; ++ring) {
+        const float u = 6.28318531f * static_cast<float>(ring) / static_cast<float>(rings);
+        for (uint32_t side = 0; side <= sides; ++side) {
+            const float v      = 6.28318531f * static_cast<float>(side) / static_cast<float>(sides);
+            const float radius = major + minor * std::cos(v);
+            model.vertices.push_back(
+                MakeVertex(radius * std::cos(u), minor * std::sin(v), radius * std::sin(u)));
+        }
+    }
+    AddQuads(model, 0, sides, rings);
+    FaceOutward(model, 0, [major](const float p[3], float center[3]) {
+        const float length = std::sqrt(p[0] * p[0] + p[2] * p[2]);
+        center[0]          = p[0] * major / length;
+        center[1]          = 0.0f;
+        center[2]          = p[2] * major / length;
+    });
+    return model;
+}
+
+// One vertex per corner, as a loader that does not share vertices produces
+Model Soup(Model model) {
+    std::vector<Vertex> vertices;
+    for (uint32_t& index : model.indices) {
+        vertices.push_back(model.vertices[index]);
+        index = static_cast<uint32_t>(vertices.size()) - 1;
+    }
+    model.vertices.swap(vertices);
+    model.name += " soup";
+    return model;
+}
+
+Model Shuffle(Model model, uint32_t seed) {
+    Bench::Rng rng(seed);
+    for (uint32_t i = model.IndexCount() / 3; i > 1; --i) {
+        const uint32_t j = rng.Below(i);
+        for (int k = 0; k < 3; ++k) {
+            std::swap(model.indices[(i - 1) * 3 + k], model.indices[j * 3 + k]);
+        }
+    }
+    model.name += ", shuffled";
+    return model;
+}
+
+struct Stats {
+    uint32_t vertexCount = 0;
+    MeshOptimizer::CacheStats cache;
+    MeshOptimizer::OverdrawStats overdraw;
+};
+
+Stats Analyze(const Model& model) {
+    Stats stats;
+    stats.vertexCount = model.VertexCount();
+    stats.cache       = MeshOptimizer::AnalyzeVertexCache(model.indices.data(),
+                                                          model.IndexCount(),
+                                                          stats.vertexCount);
+    stats.overdraw    = MeshOptimizer::AnalyzeOverdraw(model.indices.data(),
+                                                       model.IndexCount(),
+                                                       model.vertices.front().position,
+                                                       stats.vertexCount,
+                                                       sizeof(Vertex));
+    return stats;
+}
+
+// MeshConverter's Optimize for one part, leaving the fetched vertices and final indices
+void Optimize(Model& model, std::vector<MeshFile::Meshlet>& meshlets) {
+    const uint32_t indexCount = model.IndexCount();
+    std::vector<uint32_t> remap(model.VertexCount());
+    const uint32_t unique = MeshOptimizer::GenerateRemap(remap.data(),
+                                                         model.vertices.data(),
+                                                         model.VertexCount(),
+                                                         sizeof(Vertex));
+    std::vector<Vertex> welded(unique);
+    MeshOptimizer::RemapIndices(model.indices.data(), indexCount, remap.data());
+    MeshOptimizer::RemapVertices(welded.data(),
+                                 model.vertices.data(),
+                                 model.VertexCount(),
+                                 sizeof(Vertex),
+                                 remap.data());
+
+    std::vector<uint32_t> cached(indexCount);
+    MeshOptimizer::OptimizeVertexCache(cached.data(), model.indices.data(), indexCount, unique);
+    MeshOptimizer::OptimizeOverdraw(model.indices.data(),
+                                    cached.data(),
+                                    indexCount,
+                                    welded.front().position,
+                                    unique,
+                                    sizeof(Vertex));
+
+    model.vertices.resize(unique);
+    const uint32_t used = MeshOptimizer::OptimizeVertexFetch(model.vertices.data(),
+                                                             model.indices.data(),
+                                                             indexCount,
+                                                             welded.data(),
+                                                             unique,
+                                                             sizeof(Vertex));
+    model.vertices.resize(used);
+    MeshOptimizer::BuildMeshlets(meshlets,
+                                 model.indices.data(),
+                                 indexCount,
+                                 model.vertices.front().position,
+                                 used,
+                                 sizeof(Vertex));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 3;
+
+    std::vector<Model> corpus;
+    corpus.push_back(Grid(options.Size(200, 40)));
+    corpus.push_back(Sphere(options.Size(256, 64), options.Size(128, 32)));
+    corpus.push_back(Soup(Sphere(options.Size(96, 32), options.Size(48, 16))));
+    corpus.push_back(Shuffle(Torus(options.Size(256, 64), options.Size(128, 32)), 1));
+    Model nested;
+    nested.name = "4 nested spheres";
+    for (uint32_t i = 0; i < 4; ++i) {
+        const uint32_t slices = options.Size(96, 32) >> i;
+        AddSphere(nested, slices, slices / 2, 1.0f - 0.2f * static_cast<float>(i), 0.0f);
+    }
+    corpus.push_back(Shuffle(nested, 2));
+    corpus.push_back(Torus(options.Size(1024, 128), options.Size(512, 64)));
+
+    Bench::Section("%zu models, weld + cache + overdraw + fetch + meshlets", corpus.size());
+    double totalSeconds = 0.0;
+    uint64_t totalTris  = 0;
+    for (const Model& model : corpus) {
+        const Stats before = Analyze(model);
+        Model optimized;
+        std::vector<MeshFile::Meshlet> meshlets;
+        // The copy is timed too; it is small next to the passes
+        const double seconds = Bench::Best(repetitions, [&] {
+            optimized = model;
+            Optimize(optimized, meshlets);
+        });
+        const Stats after        = Analyze(optimized);
+        const uint32_t triangles = model.IndexCount() / 3;
+        Bench::Report(model.name.c_str(),
+                      "%7u -> %7u verts  ACMR %.3f -> %.3f  ATVR %.3f -> %.3f  "
+                      "overdraw %.3f -> %.3f  %5.2f Mtri/s",
+                      before.vertexCount,
+                      after.vertexCount,
+                      before.cache.acmr,
+                      after.cache.acmr,
+                      before.cache.atvr,
+                      after.cache.atvr,
+                      before.overdraw.overdraw,
+                      after.overdraw.overdraw,
+                      triangles / seconds * 1e-6);
+        totalSeconds += seconds;
+        totalTris += triangles;
+    }
+    Bench::Report("whole corpus",
+                  "%llu triangles in %.1f ms, %.2f Mtri/s",
+                  static_cast<unsigned long long>(totalTris),
+                  totalSeconds * 1e3,
+                  static_cast<double>(totalTris) / totalSeconds * 1e-6);
+    return 0;
+}
@@ -0,0 +1,274 @@
+// Object Benchmark
+// CPU cost of per-object constants, as Graphics does for the objects queued on it every frame:
+// a grid of rotated copies, each with its own world matrix, multiplied by the view-projection
+// into its own 256-byte constant buffer slot. Compares the scalar multiply, the SSE one with
+// streaming stores into the cache-line aligned slots, the same with the slots 16 bytes off
+// (ordinary stores), and the SSE one on the job system. Then the whole path through
+// ConstantAllocator over 4 MB pages in ordinary memory: a batched multiply run by run, and
+// one allocation and multiply per object. Last, the full per-object draw path: ObjectSubmitter
+// writing the constants and queuing one packet per object, then the RenderQueue sort and
+// replay binding every object's slot window through StateCache into a counting sink.
+//
+//   ObjectBench [--quick]
+#include "Bench.h"
+#include "render/ConstantAllocator.h"
+#include "render/MatrixBatch.h"
+#include "render/ObjectSubmitter.h"
+#include "render/RenderQueue.h"
+#include "render/StateCache.h"
+#include "threading/JobSystem.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct alignas(64) Line {
+    uint8_t bytes[64];
+};
+
+// Reuses one page of memory per page index, standing in for the mapped constant buffers
+class MemoryTarget : public ConstantAllocator::Target {
+  public:
+    explicit MemoryTarget(uint32_t slotsPerPage) : lineCount(slotsPerPage * 4) {}
+
+    uint8_t* MapPage(uint32_t page) override {
+        while (pages.size() <= page) {
+            pages.emplace_back(lineCount);
+        }
+        return pages[page].front().bytes;
+    }
+
+  private:
+    size_t lineCount;
+    std::vector<std::vector<Line>> pages;
+};
+
+// Counts the constant buffer binds and draws that reach it, standing in for the context
+class CountingSink : public ContextSink {
+  public:
+    uint64_t binds = 0;
+    uint64_t draws = 0;
+
+    void SetInputLayout(void*) override {}
+    void SetPrimitiveTopology(uint32_t) override {}
+    void SetIndexBuffer(void*, uint32_t, uint32_t) override {}
+    void SetVertexBuffer(uint32_t, void*, uint32_t, uint32_t) override {}
+    void SetVertexShader(void*) override {}
+    void SetPixelShader(void*) override {}
+    void SetPixelShaderResource(uint32_t, void*) override {}
+    void SetPixelSampler(uint32_t, void*) override {}
+    void SetVertexConstantBuffer(uint32_t, void*, uint32_t, uint32_t) override {
+        ++binds;
+    }
+    void SetRasterizerState(void*) override {}
+    void SetViewport(float, float, float, float) override {}
+    void SetDepthStencilState(void*, uint32_t) override {}
+    void SetBlendState(void*, const float*, uint32_t) override {}
+    void SetRenderTarget(void*, void*) override {}
+    void Draw(uint32_t, uint32_t) override {
+        ++draws;
+    }
+    void DrawIndexed(uint32_t, uint32_t, int32_t) override {}
+    void DrawInstanced(uint32_t, uint32_t, uint32_t, uint32_t) override {}
+    void DrawIndexedInstanced(uint32_t, uint32_t, uint32_t, int32_t, uint32_t) override {}
+};
+
+// Binds each packet's slot window of its page, as the Direct3D dispatcher does
+class ObjectDispatcher : public RenderQueue::Dispatcher {
+  public:
+    ObjectDispatcher(const ConstantAllocator& allocator, StateCache& state)
+        : allocator(allocator), state(state) {}
+
+    void BindShader(uint32_t) override {}
+    void BindMaterial(uint32_t) override {}
+    void BindGeometry(uint32_t, uint32_t) override {}
+    void Draw(const DrawPacket& packet) override {
+        const uintptr_t page = allocator.GetPage(packet.constants);
+        state.SetVertexConstantBuffer(0,
+                                      reinterpret_cast<void*>(page + 1),
+                                      allocator.GetFirstConstant(packet.constants),
+                                      ConstantAllocator::ConstantsPerSlot);
+        state.Draw(packet.vertexCount, packet.startVertex);
+    }
+
+  private:
+    const ConstantAllocator& allocator;
+    StateCache& state;
+};
+
+// Copies on a grid over clip space, each scaled to its cell and turned by a random angle
+std::vector<Float4x4> BuildScene(uint32_t count) {
+    Bench::Rng rng(19);
+    const uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    const float cell    = 2.0f / static_cast<float>(side);
+    const float scale   = cell * 0.5f;
+    std::vector<Float4x4> world(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        const float angle = rng.Range(0.0f, 6.28318531f);
+        const float c     = std::cos(angle) * scale;
+        const float s     = std::sin(angle) * scale;
+        const float x     = -1.0f + (static_cast<float>(i % side) + 0.5f) * cell;
+        const float y     = -1.0f + (static_cast<float>(i / side) + 0.5f) * cell;
+        world[i]          = {{{c, s, 0.0f, 0.0f},
+                              {-s, c, 0.0f, 0.0f},
+                              {0.0f, 0.0f, 1.0f, 0.0f},
+                              {x, y, 0.0f, 1.0f}}};
+    }
+    return world;
+}
+
+Float4x4 ViewProjection() {
+    Float4x4 viewProjection = Float4x4::Identity();
+    viewProjection.m[0][0]  = 0.5625f; // 16:9
+    viewProjection.m[2][2]  = 0.5f;
+    viewProjection.m[3][2]  = 0.5f;
+    return viewProjection;
+}
+
+void Report(const char* label, double seconds, uint32_t count, uint32_t frames) {
+    const double objects = static_cast<double>(count) * frames;
+    Bench::Report(label,
+                  "%6.2f ns/object  %7.3f ms/frame",
+                  seconds * 1e9 / objects,
+                  seconds * 1e3 / frames);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 5;
+    const uint32_t count   = options.Size(100000, 10000);
+    const uint32_t frames  = options.Size(60, 3);
+    const size_t stride    = ConstantAllocator::SlotSize;
+
+    const std::vector<Float4x4> world = BuildScene(count);
+    const Float4x4 viewProjection     = ViewProjection();
+    std::vector<Line> slots((count * stride + 64) / 64);
+    uint8_t* aligned   = slots.front().bytes;
+    uint8_t* unaligned = aligned + 16;
+
+    Bench::Section("%u objects into 256-byte slots, %u frames", count, frames);
+    double seconds = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            MatrixBatch::MultiplyRangeScalar(world.data(),
+                                             viewProjection,
+                                             0,
+                                             count,
+                                             aligned,
+                                             stride);
+        }
+    });
+    Report("scalar", seconds, count, frames);
+    seconds = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            MatrixBatch::MultiplyRange(world.data(), viewProjection, 0, count, aligned, stride);
+        }
+    });
+    Report("SSE, streaming stores", seconds, count, frames);
+    seconds = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            MatrixBatch::MultiplyRange(world.data(), viewProjection, 0, count, unaligned, stride);
+        }
+    });
+    Report("SSE, slots 16 bytes off", seconds, count, frames);
+
+    JobSystem jobSystem;
+    jobSystem.Initialize();
+    MatrixBatch parallel;
+    parallel.SetParallelFor(jobSystem.GetTaskExecutor());
+    seconds = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            parallel.Multiply(world.data(), viewProjection, count, aligned, stride);
+        }
+    });
+    char label[64];
+    const uint32_t threads = jobSystem.GetThreadCount();
+    std::snprintf(label, sizeof(label), "SSE, %u thread%s", threads, threads == 1 ? "" : "s");
+    Report(label, seconds, count, frames);
+    jobSystem.Shutdown();
+    Bench::DoNotOptimize(slots[count / 2]);
+
+    Bench::Section("Through ConstantAllocator, 4 MB pages");
+    ConstantAllocator allocator;
+    MemoryTarget target(allocator.GetSlotsPerPage());
+    MatrixBatch batch;
+    seconds = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            allocator.BeginFrame();
+            uint32_t placed = 0;
+            while (placed < count) {
+                const ConstantAllocator::Run run = allocator.Allocate(target, count - placed);
+                batch.Multiply(world.data() + placed,
+                               viewProjection,
+                               run.objectCount,
+                               run.cpuPtr,
+                               stride);
+                placed += run.objectCount;
+            }
+        }
+    });
+    Report("run by run, batched multiply", seconds, count, frames);
+    seconds = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            allocator.BeginFrame();
+            for (uint32_t i = 0; i < count; ++i) {
+                uint8_t* cpuPtr          = nullptr;
+                const Float4x4 constants = Float4x4::Multiply(world[i], viewProjection);
+                const uint32_t slot      = allocator.AllocateOne(target, 1, &cpuPtr);
+                std::memcpy(cpuPtr, &constants, sizeof(constants));
+                Bench::DoNotOptimize(slot);
+            }
+        }
+    });
+    Report("one object at a time", seconds, count, frames);
+
+    Bench::Section("Full submission, one draw per object");
+    DrawPacket packet    = {};
+    packet.sortKey       = SortKey::Make(0, 1, 0, 0);
+    packet.geometry      = 1;
+    packet.vertexCount   = 3;
+    packet.instanceCount = 1;
+    ObjectSubmitter submitter;
+    RenderQueue queue;
+    queue.Reserve(count);
+    CountingSink sink;
+    StateCache state(sink);
+    ObjectDispatcher dispatcher(allocator, state);
+    uint32_t submitted = 0;
+    seconds            = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            allocator.BeginFrame();
+            queue.Reset();
+            submitter.Add(world.data(), count);
+            submitted =
+                submitter.Submit(allocator, target, batch, viewProjection, packet, queue);
+        }
+    });
+    Report("constants and packets", seconds, count, frames);
+    seconds = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            allocator.BeginFrame();
+            queue.Reset();
+            state.BeginFrame();
+            submitter.Add(world.data(), count);
+            submitted =
+                submitter.Submit(allocator, target, batch, viewProjection, packet, queue);
+            queue.Sort();
+            queue.Execute(dispatcher);
+        }
+    });
+    Report("through sort and replay", seconds, count, frames);
+    if (submitted != count || sink.draws == 0 || sink.binds != sink.draws) {
+        std::fprintf(stderr,
+                     "submitted %u of %u objects, %llu binds for %llu draws\n",
+                     submitted,
+                     count,
+                     static_cast<unsigned long long>(sink.binds),
+                     static_cast<unsigned long long>(sink.draws));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Profiler Benchmark
+// CPU-side cost of the profiler: one timestamp, one ProfileScope (two timestamps plus the
+// ring write), and the PROFILE_SCOPE macro as configured for this build, single-threaded and
+// with several threads recording at once (the rings are per thread, so it should not grow).
+//
+//   ProfilerBench [--quick]
+#include "Bench.h"
+#include "utils/Profiler.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Nanoseconds per call of function, best of repetitions runs of count calls
+template <typename Function>
+double NanosecondsPerCall(uint32_t count, int repetitions, Function&& function) {
+    double seconds = Bench::Best(repetitions, [&] {
+        for (uint32_t i = 0; i < count; ++i) {
+            function();
+        }
+    });
+    return seconds * 1e9 / count;
+}
+
+void EmptyScope() {
+    ProfileScope scope("Bench");
+}
+
+void EmptyMacroScope() {
+    PROFILE_SCOPE("Bench");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 10;
+    const uint32_t count   = options.Size(10000000, 100000);
+
+    // Construct the singleton and register this thread's ring outside the timed loops
+    EmptyScope();
+
+    Bench::Section("Profiler: %u markers, PROFILING_ENABLED=%d, %s timestamps",
+                   count,
+                   PROFILING_ENABLED,
+                   PROFILER_USE_TSC ? "TSC" : "steady_clock");
+    Bench::Report("steady_clock::now()",
+                  "%6.2f ns",
+                  NanosecondsPerCall(count, repetitions, [] {
+                      Bench::DoNotOptimize(Bench::Clock::now());
+                  }));
+    Bench::Report("Profiler::Now()",
+                  "%6.2f ns",
+                  NanosecondsPerCall(count, repetitions, [] {
+                      Bench::DoNotOptimize(Profiler::Now());
+                  }));
+    Bench::Report("ProfileScope", "%6.2f ns", NanosecondsPerCall(count, repetitions, EmptyScope));
+    Bench::Report("PROFILE_SCOPE (this build)",
+                  "%6.2f ns",
+                  NanosecondsPerCall(count, repetitions, EmptyMacroScope));
+
+    const uint32_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (uint32_t threadCount : {2u, 4u}) {
+        std::vector<double> perThread(threadCount);
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t] {
+                EmptyScope();
+                perThread[t] = NanosecondsPerCall(count, repetitions, EmptyScope);
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        char label[64];
+        std::snprintf(label,
+                      sizeof(label),
+                      "ProfileScope, %u threads (%u cores)",
+                      threadCount,
+                      hardware);
+        double worst = *std::max_element(perThread.begin(), perThread.end());
+        Bench::Report(label, "%6.2f ns worst thread", worst);
+    }
+    return 0;
+}
@@ -0,0 +1,239 @@
+// Render Graph Benchmark
+// A deferred frame declared and compiled from scratch every frame, as the renderer would:
+// four shadow cascades, depth prepass, G-buffer, half resolution AO with a two-pass blur,
+// lighting, a chain of full resolution post effects (its length sets the pass count), TAA
+// against an imported history, a six-level bloom, tonemapping, UI and present, plus eight
+// debug views nothing reads, which culling removes. Reports the transient memory every
+// texture would take on its own against the pool blocks the aliased frame uses, the most
+// bytes alive at once, and the cost of declaring and compiling the graph per frame. Then
+// the resolution changes, and the pool must trim the blocks the old size left behind.
+//
+//   RenderGraphBench [--quick]
+#include "Bench.h"
+#include "render/RenderGraph.h"
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// Passes outside the post chain
+const uint32_t FixedPasses = 35;
+
+RenderTargetDesc Target(uint32_t width, uint32_t height, RenderTargetFormat format) {
+    RenderTargetDesc desc;
+    desc.width  = width;
+    desc.height = height;
+    desc.format = format;
+    return desc;
+}
+
+// Declare one frame of passCount passes (at least FixedPasses) at width x height
+void DeclareFrame(RenderGraph& graph,
+                  uint32_t passCount,
+                  uint32_t width,
+                  uint32_t height,
+                  uint32_t& executed) {
+    const RenderGraph::ExecuteFunction execute = [&executed](const RenderGraph&) { ++executed; };
+
+    const RenderTargetDesc color  = Target(width, height, RenderTargetFormat::RGBA8);
+    const RenderTargetDesc hdr    = Target(width, height, RenderTargetFormat::RGBA16F);
+    const RenderTargetDesc half   = Target(width / 2, height / 2, RenderTargetFormat::R32F);
+    const RenderTargetDesc shadow = Target(2048, 2048, RenderTargetFormat::D32F);
+
+    graph.Reset();
+    const uint32_t backBuffer = graph.ImportTexture("back buffer", color);
+    const uint32_t history    = graph.ImportTexture("TAA history", hdr);
+
+    uint32_t cascades[4];
+    for (uint32_t& cascade : cascades) {
+        cascade = graph.CreateTexture("cascade", shadow);
+        graph.Write(graph.AddPass("shadow cascade", execute), cascade);
+    }
+
+    const uint32_t depth =
+        graph.CreateTexture("depth", Target(width, height, RenderTargetFormat::D24S8));
+    uint32_t pass = graph.AddPass("depth prepass", execute);
+    graph.Write(pass, depth);
+
+    const uint32_t albedo = graph.CreateTexture("albedo", color);
+    const uint32_t normals =
+        graph.CreateTexture("normals", Target(width, height, RenderTargetFormat::RGB10A2));
+    const uint32_t material = graph.CreateTexture("material", color);
+    const uint32_t motion =
+        graph.CreateTexture("motion", Target(width, height, RenderTargetFormat::RG16F));
+    pass = graph.AddPass("G-buffer", execute);
+    graph.Read(pass, depth);
+    graph.Write(pass, depth);
+    graph.Write(pass, albedo);
+    graph.Write(pass, normals);
+    graph.Write(pass, material);
+    graph.Write(pass, motion);
+
+    uint32_t ao = graph.CreateTexture("AO", half);
+    pass        = graph.AddPass("AO", execute);
+    graph.Read(pass, depth);
+    graph.Read(pass, normals);
+    graph.Write(pass, ao);
+    for (int axis = 0; axis < 2; ++axis) {
+        const uint32_t blurred = graph.CreateTexture("AO blur", half);
+        pass                   = graph.AddPass("AO blur", execute);
+        graph.Read(pass, ao);
+        graph.Read(pass, depth);
+        graph.Write(pass, blurred);
+        ao = blurred;
+    }
+
+    uint32_t lit = graph.CreateTexture("lighting", hdr);
+    pass         = graph.AddPass("lighting", execute);
+    for (uint32_t cascade : cascades) {
+        graph.Read(pass, cascade);
+    }
+    graph.Read(pass, depth);
+    graph.Read(pass, albedo);
+    graph.Read(pass, normals);
+    graph.Read(pass, material);
+    graph.Read(pass, ao);
+    graph.Write(pass, lit);
+
+    for (uint32_t effect = FixedPasses; effect < passCount; ++effect) {
+        const uint32_t next = graph.CreateTexture("post", hdr);
+        pass                = graph.AddPass("post effect", execute);
+        graph.Read(pass, lit);
+        graph.Read(pass, depth);
+        graph.Write(pass, next);
+        lit = next;
+    }
+
+    const uint32_t resolved = graph.CreateTexture("TAA", hdr);
+    pass                    = graph.AddPass("TAA", execute);
+    graph.Read(pass, lit);
+    graph.Read(pass, motion);
+    graph.Read(pass, history);
+    graph.Write(pass, resolved);
+    pass = graph.AddPass("history copy", execute);
+    graph.Read(pass, resolved);
+    graph.Write(pass, history);
+
+    // Down to 1/64 and back up, each level adding the matching downsampled one
+    uint32_t bloom[7];
+    bloom[0] = resolved;
+    for (uint32_t level = 1; level < 7; ++level) {
+        const RenderTargetDesc desc =
+            Target(width >> level, height >> level, RenderTargetFormat::R11G11B10F);
+        bloom[level] = graph.CreateTexture("bloom down", desc);
+        pass         = graph.AddPass("bloom downsample", execute);
+        graph.Read(pass, bloom[level - 1]);
+        graph.Write(pass, bloom[level]);
+    }
+    uint32_t up = bloom[6];
+    for (uint32_t level = 6; level-- > 0;) {
+        const RenderTargetDesc desc =
+            Target(width >> level, height >> level, RenderTargetFormat::R11G11B10F);
+        const uint32_t next = graph.CreateTexture("bloom up", desc);
+        pass                = graph.AddPass("bloom upsample", execute);
+        graph.Read(pass, up);
+        graph.Read(pass, bloom[level]);
+        graph.Write(pass, next);
+        up = next;
+    }
+
+    const uint32_t ldr = graph.CreateTexture("tonemapped", color);
+    pass               = graph.AddPass("tonemap", execute);
+    graph.Read(pass, up);
+    graph.Write(pass, ldr);
+    pass = graph.AddPass("UI", execute);
+    graph.Read(pass, ldr);
+    graph.Write(pass, ldr);
+
+    for (int view = 0; view < 8; ++view) {
+        const uint32_t debug = graph.CreateTexture("debug view", color);
+        pass                 = graph.AddPass("debug view", execute);
+        graph.Read(pass, view % 2 == 0 ? normals : depth);
+        graph.Write(pass, debug);
+    }
+
+    pass = graph.AddPass("present", execute);
+    graph.Read(pass, ldr);
+    graph.Write(pass, backBuffer);
+}
+
+double Megabytes(uint64_t bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const uint32_t frames  = options.Size(2000, 100);
+    uint32_t executed      = 0;
+
+    Bench::Section("deferred frame at 1920x1080, %u frames, per-frame times", frames);
+    const uint32_t passCounts[] = {101, 141, 261};
+    for (uint32_t passCount : passCounts) {
+        RenderGraph graph;
+        double declareSeconds      = 0.0;
+        double compileSeconds      = 0.0;
+        bool compiled              = true;
+        uint64_t createdAfterFirst = 0;
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            const Bench::Clock::time_point start = Bench::Clock::now();
+            DeclareFrame(graph, passCount, 1920, 1080, executed);
+            const Bench::Clock::time_point declared = Bench::Clock::now();
+            compiled &= graph.Compile();
+            const Bench::Clock::time_point end = Bench::Clock::now();
+            declareSeconds += Bench::Seconds(declared - start);
+            compileSeconds += Bench::Seconds(end - declared);
+            graph.Execute();
+            if (frame == 0) {
+                createdAfterFirst = graph.GetPool().GetStats().blocksCreated;
+            }
+        }
+        if (!compiled) {
+            std::printf("compile failed\n");
+            return 1;
+        }
+
+        const RenderGraph::Stats stats = graph.GetStats();
+        char label[64];
+        std::snprintf(label,
+                      sizeof(label),
+                      "%u passes, %u culled",
+                      stats.passes,
+                      stats.culledPasses);
+        Bench::Report(label,
+                      "%3u transients  %7.1f MB unaliased  %5.1f MB aliased (%u blocks)  "
+                      "%5.1f MB peak live  declare %5.1f us  compile %5.1f us  %llu new blocks",
+                      stats.transients,
+                      Megabytes(stats.unaliasedBytes),
+                      Megabytes(stats.aliasedBytes),
+                      stats.blocks,
+                      Megabytes(stats.peakLiveBytes),
+                      declareSeconds * 1e6 / frames,
+                      compileSeconds * 1e6 / frames,
+                      static_cast<unsigned long long>(graph.GetPool().GetStats().blocksCreated -
+                                                      createdAfterFirst));
+    }
+
+    Bench::Section("101 passes, 1920x1080 then 2560x1440 for %u frames each", frames);
+    RenderGraph graph;
+    const uint32_t sizes[2][2] = {{1920, 1080}, {2560, 1440}};
+    for (const uint32_t* size : sizes) {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            DeclareFrame(graph, 101, size[0], size[1], executed);
+            graph.Compile();
+            graph.Execute();
+        }
+        const TransientPool::Stats pool = graph.GetPool().GetStats();
+        char label[64];
+        std::snprintf(label, sizeof(label), "%ux%u", size[0], size[1]);
+        Bench::Report(label,
+                      "%5.1f MB in %u blocks  %llu created  %llu trimmed",
+                      Megabytes(pool.bytes),
+                      pool.blocks,
+                      static_cast<unsigned long long>(pool.blocksCreated),
+                      static_cast<unsigned long long>(pool.blocksTrimmed));
+    }
+    Bench::DoNotOptimize(executed);
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Render Queue Benchmark
+// Sort and dispatch cost of RenderQueue for frame-sized packet counts: the radix sort alone,
+// serially and on a JobSystem executor, against std::sort of the same keys, and the replay
+// through a null Dispatcher with redundant binds removed.
+//
+//   RenderQueueBench [--quick]
+#include "Bench.h"
+#include "render/RenderQueue.h"
+#include "threading/JobSystem.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Counts calls so the replay cannot be optimized away
+class NullDispatcher : public RenderQueue::Dispatcher {
+  public:
+    uint64_t calls = 0;
+
+    void BindShader(uint32_t) override {
+        ++calls;
+    }
+    void BindMaterial(uint32_t) override {
+        ++calls;
+    }
+    void BindGeometry(uint32_t, uint32_t) override {
+        ++calls;
+    }
+    void Draw(const DrawPacket& packet) override {
+        calls += packet.vertexCount;
+    }
+};
+
+// A scene's worth of draws: few shaders, more materials, many meshes, random depths
+std::vector<DrawPacket> MakePackets(uint32_t count) {
+    Bench::Rng rng(42);
+    std::vector<DrawPacket> packets(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        DrawPacket& packet   = packets[i];
+        packet               = {};
+        uint32_t shader      = rng.Below(16);
+        uint32_t material    = shader * 64 + rng.Below(64);
+        packet.sortKey       = SortKey::Make(rng.Below(2), shader, material, rng.Next(), i);
+        packet.geometry      = rng.Below(1024);
+        packet.vertexCount   = 36;
+        packet.instanceCount = 1;
+    }
+    return packets;
+}
+
+void Fill(RenderQueue& queue, const std::vector<DrawPacket>& packets) {
+    queue.Reset();
+    for (const DrawPacket& packet : packets) {
+        queue.Submit(packet);
+    }
+}
+
+void Run(uint32_t count, JobSystem& jobSystem, int repetitions) {
+    std::vector<DrawPacket> packets = MakePackets(count);
+    Bench::Section("%u packets", count);
+
+    std::vector<uint64_t> keys(count);
+    double stdSort = Bench::Best(repetitions, [&] {
+        for (uint32_t i = 0; i < count; ++i) {
+            keys[i] = packets[i].sortKey;
+        }
+        std::sort(keys.begin(), keys.end());
+        Bench::DoNotOptimize(keys.front());
+    });
+    Bench::Report("std::sort (keys only)", "%8.3f ms", stdSort * 1e3);
+
+    RenderQueue queue;
+    queue.Reserve(count);
+    double serial = Bench::Best(repetitions, [&] {
+        Fill(queue, packets);
+        queue.Sort();
+    });
+    Bench::Report("submit + radix sort, serial", "%8.3f ms", serial * 1e3);
+
+    queue.SetParallelFor(jobSystem.GetTaskExecutor());
+    double parallel = Bench::Best(repetitions, [&] {
+        Fill(queue, packets);
+        queue.Sort();
+    });
+    char label[64];
+    const uint32_t threads = jobSystem.GetThreadCount();
+    std::snprintf(label,
+                  sizeof(label),
+                  "submit + radix sort, %u thread%s",
+                  threads,
+                  threads == 1 ? "" : "s");
+    Bench::Report(label, "%8.3f ms", parallel * 1e3);
+
+    NullDispatcher dispatcher;
+    double dispatch = Bench::Best(repetitions, [&] { queue.Execute(dispatcher); });
+    Bench::DoNotOptimize(dispatcher.calls);
+
+    const RenderQueue::Stats& stats = queue.GetStats();
+    Bench::Report("dispatch", "%8.3f ms", dispatch * 1e3);
+    Bench::Report("radix passes", "%u", stats.radixPasses);
+    Bench::Report("shader / material / geometry binds",
+                  "%u / %u / %u",
+                  stats.shaderChanges,
+                  stats.materialChanges,
+                  stats.geometryChanges);
+    Bench::Report("packets/s (sort + dispatch)", "%.1f M", count / (parallel + dispatch) / 1e6);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 10;
+
+    JobSystem jobSystem;
+    jobSystem.Initialize();
+
+    std::vector<uint32_t> counts = {10000, 100000, 1000000};
+    if (options.quick) {
+        counts = {10000, 40000};
+    }
+    for (uint32_t count : counts) {
+        Run(count, jobSystem, repetitions);
+    }
+    jobSystem.Shutdown();
+    return 0;
+}
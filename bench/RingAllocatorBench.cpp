@@ -0,0 +1,146 @@
+// Ring Allocator Benchmark
+// Allocation rate and fragmentation of RingAllocator under a simulated frames-in-flight
+// pattern: every frame makes a burst of mixed-size, mixed-alignment allocations (vertex,
+// index and constant data), closes with a fence, and the fence of the frame FramesInFlight
+// back completes. Runs single-threaded and with producer threads allocating concurrently.
+//
+//   RingAllocatorBench [--quick]
+#include "Bench.h"
+#include "memory/RingAllocator.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t FramesInFlight = 3;
+constexpr uint64_t Capacity       = 32ull << 20;
+
+struct Request {
+    uint32_t size;
+    uint32_t alignment;
+};
+
+// Sizes as a typical frame sees them: many small constant blocks, some vertex streams
+std::vector<Request> MakeFrame(Bench::Rng& rng, uint32_t count) {
+    std::vector<Request> requests(count);
+    for (Request& request : requests) {
+        uint32_t kind = rng.Below(10);
+        if (kind < 6) {
+            request = {64 + rng.Below(192), 256}; // Constant buffer slot
+        } else if (kind < 9) {
+            request = {256 + rng.Below(16 * 1024), 16}; // Vertex data
+        } else {
+            request = {64 + rng.Below(4096), 4}; // Index data
+        }
+    }
+    return requests;
+}
+
+struct Result {
+    double seconds       = 0.0;
+    uint64_t allocations = 0;
+    uint64_t failed      = 0;
+    uint64_t bytes       = 0;
+    uint64_t padding     = 0;
+    uint64_t peakInUse   = 0;
+};
+
+Result Run(uint32_t frames, uint32_t perFrame, uint32_t threadCount) {
+    std::vector<uint8_t> memory(Capacity);
+    RingAllocator ring;
+    ring.Initialize(Capacity, memory.data());
+
+    Bench::Rng rng(1234);
+    std::vector<std::vector<Request>> frameRequests;
+    for (uint32_t i = 0; i < 16; ++i) {
+        frameRequests.push_back(MakeFrame(rng, perFrame));
+    }
+
+    Result result;
+    Bench::Clock::time_point start = Bench::Clock::now();
+    for (uint64_t frame = 1; frame <= frames; ++frame) {
+        if (frame > FramesInFlight) {
+            ring.Retire(frame - FramesInFlight);
+        }
+        ring.BeginFrame();
+
+        const std::vector<Request>& requests = frameRequests[frame % frameRequests.size()];
+        auto produce                         = [&](uint32_t first, uint32_t step) {
+            for (uint32_t i = first; i < requests.size(); i += step) {
+                RingAllocator::Allocation allocation =
+                    ring.Allocate(requests[i].size, requests[i].alignment);
+                Bench::DoNotOptimize(allocation);
+            }
+        };
+        if (threadCount == 1) {
+            produce(0, 1);
+        } else {
+            std::vector<std::thread> threads;
+            for (uint32_t t = 1; t < threadCount; ++t) {
+                threads.emplace_back(produce, t, threadCount);
+            }
+            produce(0, threadCount);
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        }
+
+        RingAllocator::Stats stats = ring.GetStats();
+        result.allocations += stats.allocations;
+        result.failed      += stats.failedAllocations;
+        result.bytes       += stats.bytesAllocated;
+        result.padding     += stats.bytesPadding;
+        result.peakInUse    = std::max(result.peakInUse, ring.GetBytesInUse());
+        ring.EndFrame(frame);
+    }
+    result.seconds = Bench::Seconds(Bench::Clock::now() - start);
+    return result;
+}
+
+void Print(const char* label, const Result& result, double threadOverheadSeconds) {
+    double allocationSeconds = std::max(1e-9, result.seconds - threadOverheadSeconds);
+    Bench::Section("%s", label);
+    Bench::Report("allocations/s", "%.1f M", result.allocations / allocationSeconds / 1e6);
+    Bench::Report("failed allocations", "%llu", static_cast<unsigned long long>(result.failed));
+    Bench::Report("fragmentation (padding / allocated)",
+                  "%.2f %%",
+                  100.0 * result.padding / std::max<uint64_t>(1, result.bytes));
+    Bench::Report("peak bytes in use",
+                  "%.2f MB of %.0f MB",
+                  result.peakInUse / 1048576.0,
+                  Capacity / 1048576.0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const uint32_t frames  = options.Size(2000, 50);
+    const uint32_t perFrame = options.Size(2000, 200);
+
+    Bench::Section("RingAllocator: %u frames x %u allocations, %u frames in flight",
+                   frames,
+                   perFrame,
+                   FramesInFlight);
+    Print("1 thread", Run(frames, perFrame, 1), 0.0);
+
+    // Spawning the producers every frame is part of the measured time; subtract it
+    for (uint32_t threads : {2u, 4u}) {
+        double spawn = Bench::Best(3, [&] {
+            for (uint32_t frame = 0; frame < frames; ++frame) {
+                std::vector<std::thread> idle;
+                for (uint32_t t = 1; t < threads; ++t) {
+                    idle.emplace_back([] {});
+                }
+                for (std::thread& thread : idle) {
+                    thread.join();
+                }
+            }
+        });
+        char label[32];
+        std::snprintf(label, sizeof(label), "%u threads", threads);
+        Print(label, Run(frames, perFrame, threads), spawn);
+    }
+    return 0;
+}
@@ -0,0 +1,178 @@
+// Shader Archive Benchmark
+// Startup cost of getting the bytecode of a few hundred shaders into memory: one loose .cso
+// file per shader read with fopen/fseek/ftell/fread (the loader ShaderLibrary replaced)
+// against one memory-mapped ShaderArchive, cold and warm. Both paths touch every byte, as
+// shader creation would. On Linux "cold" evicts the files from the page cache first
+// (posix_fadvise); elsewhere it is simply the first load after writing.
+//
+//   ShaderArchiveBench [--quick]
+#include "Bench.h"
+#include "render/ShaderArchive.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char* const ArchivePath = "ShaderArchiveBench.pak";
+
+struct Shader {
+    std::string name;
+    std::string path; // Loose file
+    std::vector<uint8_t> bytecode;
+};
+
+// Sizes of typical DXBC blobs; every fifth shader repeats an earlier one (permutations that
+// compile to the same code), which the archive stores once
+std::vector<Shader> MakeShaders(uint32_t count) {
+    Bench::Rng rng(99);
+    std::vector<Shader> shaders(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        Shader& shader = shaders[i];
+        shader.name    = "Shader" + std::to_string(i) + (i % 2 ? "PS" : "VS");
+        shader.path    = "ShaderArchiveBench." + shader.name + ".cso";
+        if (i >= 10 && i % 5 == 0) {
+            shader.bytecode = shaders[rng.Below(i)].bytecode;
+        } else {
+            shader.bytecode.resize(1024 + rng.Below(15 * 1024));
+            for (uint8_t& byte : shader.bytecode) {
+                byte = static_cast<uint8_t>(rng.Next());
+            }
+        }
+    }
+    return shaders;
+}
+
+bool WriteFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+// Push path out of the page cache so the next read goes to the device
+void Evict(const std::string& path) {
+#ifdef __linux__
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor >= 0) {
+        fdatasync(descriptor);
+        posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED);
+        close(descriptor);
+    }
+#else
+    (void)path;
+#endif
+}
+
+// The loose-file loader: one open, size query and read per shader into a fresh vector
+uint64_t LoadLoose(const std::vector<Shader>& shaders) {
+    uint64_t checksum = 0;
+    for (const Shader& shader : shaders) {
+        FILE* file = std::fopen(shader.path.c_str(), "rb");
+        if (!file) {
+            continue;
+        }
+        std::fseek(file, 0, SEEK_END);
+        long size = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        std::vector<char> bytes(static_cast<size_t>(size));
+        if (std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size()) {
+            checksum += ShaderArchive::Hash(bytes.data(), bytes.size());
+        }
+        std::fclose(file);
+    }
+    return checksum;
+}
+
+// The archive loader: map, validate the index, then read each entry's bytecode in place
+uint64_t LoadArchive(const std::vector<Shader>& shaders) {
+    ShaderArchive archive;
+    if (!archive.Open(ArchivePath)) {
+        return 0;
+    }
+    uint64_t checksum = 0;
+    for (const Shader& shader : shaders) {
+        const ShaderArchive::Entry* entry = archive.Find(shader.name.c_str());
+        if (entry) {
+            checksum += ShaderArchive::Hash(archive.GetBytecode(*entry), entry->size);
+        }
+    }
+    return checksum;
+}
+
+// Best time of load over repetitions runs, each preceded by an untimed evict
+template <typename EvictFunction, typename LoadFunction>
+double ColdBest(int repetitions, EvictFunction&& evict, LoadFunction&& load) {
+    double best = 1e30;
+    for (int i = 0; i < repetitions; ++i) {
+        evict();
+        Bench::Clock::time_point start = Bench::Clock::now();
+        Bench::DoNotOptimize(load());
+        best = std::min(best, Bench::Seconds(Bench::Clock::now() - start));
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 10;
+    const uint32_t count   = options.Size(500, 50);
+
+    std::vector<Shader> shaders = MakeShaders(count);
+    ShaderArchiveWriter writer;
+    uint64_t looseBytes = 0;
+    for (const Shader& shader : shaders) {
+        ShaderStage stage = ShaderStage::Vertex;
+        ShaderStageFromName(shader.name, stage);
+        writer.Add(shader.name, stage, shader.bytecode.data(), shader.bytecode.size());
+        WriteFile(shader.path, shader.bytecode);
+        looseBytes += shader.bytecode.size();
+    }
+    writer.Write(ArchivePath);
+
+    MappedFile archiveFile;
+    ShaderArchive archive;
+    archiveFile.Open(ArchivePath);
+    archive.Open(ArchivePath);
+    Bench::Section("ShaderArchive: %u shaders, %u distinct blobs", count, archive.GetBlobCount());
+    Bench::Report("loose files", "%.2f MB in %u files", looseBytes / 1048576.0, count);
+    Bench::Report("archive", "%.2f MB in 1 file", archiveFile.GetSize() / 1048576.0);
+    archive.Close();
+    archiveFile.Close();
+
+    // Cold runs evict the files before every repetition, outside the timed region
+    auto evictLoose = [&] {
+        for (const Shader& shader : shaders) {
+            Evict(shader.path);
+        }
+    };
+    double looseCold   = ColdBest(repetitions, evictLoose, [&] { return LoadLoose(shaders); });
+    double archiveCold = ColdBest(
+        repetitions, [] { Evict(ArchivePath); }, [&] { return LoadArchive(shaders); });
+    double looseWarm = Bench::Best(repetitions, [&] {
+        Bench::DoNotOptimize(LoadLoose(shaders));
+    });
+    double archiveWarm = Bench::Best(repetitions, [&] {
+        Bench::DoNotOptimize(LoadArchive(shaders));
+    });
+
+    Bench::Report("loose files, cold", "%8.3f ms", looseCold * 1e3);
+    Bench::Report("archive, cold", "%8.3f ms", archiveCold * 1e3);
+    Bench::Report("loose files, warm", "%8.3f ms", looseWarm * 1e3);
+    Bench::Report("archive, warm", "%8.3f ms", archiveWarm * 1e3);
+
+    for (const Shader& shader : shaders) {
+        std::remove(shader.path.c_str());
+    }
+    std::remove(ArchivePath);
+    return 0;
+}
@@ -0,0 +1,189 @@
+// Sprite Benchmark
+// CPU cost of drawing many screen-space sprites through SpriteBatch, as Graphics does for the
+// sprites queued on it every frame: a generated atlas of 64 soft discs, and spinning sprites
+// from it interleaved with untextured and additive ones, so only sorting keeps the draw
+// count down. Compares a flush per sprite (one draw each, the naive renderer), batching in
+// submission order, batching sorted by texture and blend, and one texture only, then the
+// sorted batch with vertex writing on the job system. Vertices go into a buffer reused every
+// frame, standing in for the mapped upload ring.
+//
+//   SpriteBench [--quick]
+#include "Bench.h"
+#include "render/SpriteBatch.h"
+#include "render/TextureAtlas.h"
+#include "threading/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+const float ViewportWidth  = 1280.0f;
+const float ViewportHeight = 720.0f;
+
+const uint32_t AtlasTexture = 1;
+const uint32_t WhiteTexture = 0;
+
+// Hands out one reused vertex buffer and only counts the draws
+class CountingTarget : public SpriteBatch::Target {
+  public:
+    uint64_t draws = 0;
+
+    CountingTarget() : vertices(SpriteBatch::MaxQuadsPerDraw * 4) {}
+
+    SpriteVertex* BeginChunk(uint32_t) override {
+        return vertices.data();
+    }
+    void DrawQuads(uint32_t, SpriteBlend, uint32_t, uint32_t) override {
+        ++draws;
+    }
+
+  private:
+    std::vector<SpriteVertex> vertices;
+};
+
+// 64 soft-edged discs of 8 to 40 pixels, white so the sprite color tints them
+bool BuildAtlas(TextureAtlas& atlas, Bench::Rng& rng) {
+    std::vector<uint32_t> image;
+    for (uint32_t i = 0; i < 64; ++i) {
+        const uint32_t size = 8 + rng.Below(33);
+        const float radius  = static_cast<float>(size) * 0.5f;
+        image.assign(static_cast<size_t>(size) * size, 0u);
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                const float dx       = static_cast<float>(x) + 0.5f - radius;
+                const float dy       = static_cast<float>(y) + 0.5f - radius;
+                const float distance = std::sqrt(dx * dx + dy * dy);
+                const float coverage = std::clamp(radius - distance, 0.0f, 1.0f);
+                const uint32_t alpha = static_cast<uint32_t>(coverage * 255.0f);
+                image[y * size + x]  = (alpha << 24) | 0xFFFFFFu;
+            }
+        }
+        atlas.Add(image.data(), size, size);
+    }
+    return atlas.Build(1024, 1);
+}
+
+// Sprites scattered over the viewport; spin is radians per frame
+struct Scene {
+    std::vector<Sprite> sprites;
+    std::vector<float> spin;
+
+    /*
+    One in eight is an untextured square and one in eight is additive, interleaved with the
+    rest; mixed false makes every sprite an alpha-blended atlas one
+    */
+    Scene(const TextureAtlas& atlas, uint32_t count, bool mixed) : sprites(count), spin(count) {
+        Bench::Rng rng(17);
+        for (uint32_t i = 0; i < count; ++i) {
+            const TextureAtlas::Region& region = atlas.GetRegion(rng.Below(atlas.GetImageCount()));
+
+            Sprite& sprite  = sprites[i];
+            sprite.x        = rng.Range(0.0f, ViewportWidth);
+            sprite.y        = rng.Range(0.0f, ViewportHeight);
+            sprite.width    = static_cast<float>(region.width);
+            sprite.height   = static_cast<float>(region.height);
+            sprite.rotation = rng.Range(0.0f, 6.28318531f);
+            sprite.region   = {region.u0, region.v0, region.u1, region.v1};
+            sprite.color    = (rng.Next() & 0x00FFFFFFu) | 0xC0000000u;
+            sprite.texture  = AtlasTexture;
+
+            const uint32_t kind = rng.Below(8);
+            if (mixed && kind == 0) {
+                sprite.texture = WhiteTexture;
+                sprite.region  = SpriteRegion();
+                sprite.width *= 0.5f;
+                sprite.height *= 0.5f;
+            } else if (mixed && kind == 1) {
+                sprite.blend = SpriteBlend::Additive;
+            }
+            spin[i] = rng.Range(-0.05f, 0.05f);
+        }
+    }
+
+    void Animate() {
+        for (size_t i = 0; i < sprites.size(); ++i) {
+            sprites[i].rotation += spin[i];
+        }
+    }
+};
+
+/*
+Time frames frames of animating the scene, queuing it and ending the batch; perSprite ends
+the batch after every sprite
+*/
+void Run(const char* label,
+         Scene& scene,
+         SpriteBatch& batch,
+         uint32_t frames,
+         int repetitions,
+         bool perSprite = false) {
+    const uint32_t count = static_cast<uint32_t>(scene.sprites.size());
+    CountingTarget target;
+    const double seconds = Bench::Best(repetitions, [&] {
+        target.draws = 0;
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            scene.Animate();
+            if (perSprite) {
+                for (const Sprite& sprite : scene.sprites) {
+                    batch.Draw(sprite);
+                    batch.End(target);
+                }
+            } else {
+                batch.Draw(scene.sprites.data(), count);
+                batch.End(target);
+            }
+        }
+    });
+    Bench::Report(label,
+                  "%7.3f ms/frame  %6.1f M quads/s  %8.0f draws/frame",
+                  seconds * 1e3 / frames,
+                  static_cast<double>(count) * frames / seconds * 1e-6,
+                  static_cast<double>(target.draws) / frames);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 5;
+    const uint32_t count   = options.Size(100000, 10000);
+    const uint32_t frames  = options.Size(60, 3);
+
+    Bench::Rng rng(3);
+    TextureAtlas atlas;
+    if (!BuildAtlas(atlas, rng)) {
+        std::fprintf(stderr, "Sprite atlas does not fit in 1024x1024\n");
+        return 1;
+    }
+    Bench::Section("Atlas: %u images in %ux%u, %.0f%% occupied",
+                   atlas.GetImageCount(),
+                   atlas.GetWidth(),
+                   atlas.GetHeight(),
+                   atlas.GetOccupancy() * 100.0f);
+
+    Scene mixed(atlas, count, true);
+    Scene single(atlas, count, false);
+    SpriteBatch batch;
+    batch.SetViewport(ViewportWidth, ViewportHeight);
+    batch.Reserve(count);
+
+    Bench::Section("%u sprites, 1/8 untextured, 1/8 additive, %u frames", count, frames);
+    batch.SetSortMode(SpriteBatch::SortMode::Submission);
+    Run("flush per sprite", mixed, batch, frames, repetitions, true);
+    Run("batched, submission order", mixed, batch, frames, repetitions);
+    batch.SetSortMode(SpriteBatch::SortMode::Texture);
+    Run("batched, sorted", mixed, batch, frames, repetitions);
+    Run("sorted, one texture", single, batch, frames, repetitions);
+
+    JobSystem jobSystem;
+    jobSystem.Initialize();
+    batch.SetParallelFor(jobSystem.GetTaskExecutor());
+    char label[64];
+    const uint32_t threads = jobSystem.GetThreadCount();
+    std::snprintf(label, sizeof(label), "sorted, %u thread%s", threads, threads == 1 ? "" : "s");
+    Run(label, mixed, batch, frames, repetitions);
+    jobSystem.Shutdown();
+    return 0;
+}
@@ -0,0 +1,159 @@
+// State Cache Benchmark
+// State calls saved by StateCache on a synthetic multi-object scene. Every object binds its
+// full pipeline state the way naive per-object code does (layout, topology, shaders, vertex
+// buffer, constants, texture, sampler, rasterizer, depth-stencil, blend); objects share a few
+// shaders and materials, drawn in submission order or sorted by state.
+//
+//   StateCacheBench [--quick]
+#include "Bench.h"
+#include "render/StateCache.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Stands in for the driver: counts calls and nothing else
+class CountingSink : public ContextSink {
+  public:
+    uint64_t calls = 0;
+
+    void SetInputLayout(void*) override {
+        ++calls;
+    }
+    void SetPrimitiveTopology(uint32_t) override {
+        ++calls;
+    }
+    void SetIndexBuffer(void*, uint32_t, uint32_t) override {
+        ++calls;
+    }
+    void SetVertexBuffer(uint32_t, void*, uint32_t, uint32_t) override {
+        ++calls;
+    }
+    void SetVertexShader(void*) override {
+        ++calls;
+    }
+    void SetPixelShader(void*) override {
+        ++calls;
+    }
+    void SetPixelShaderResource(uint32_t, void*) override {
+        ++calls;
+    }
+    void SetPixelSampler(uint32_t, void*) override {
+        ++calls;
+    }
+    void SetVertexConstantBuffer(uint32_t, void*, uint32_t, uint32_t) override {
+        ++calls;
+    }
+    void SetRasterizerState(void*) override {
+        ++calls;
+    }
+    void SetViewport(float, float, float, float) override {
+        ++calls;
+    }
+    void SetDepthStencilState(void*, uint32_t) override {
+        ++calls;
+    }
+    void SetBlendState(void*, const float*, uint32_t) override {
+        ++calls;
+    }
+    void SetRenderTarget(void*, void*) override {
+        ++calls;
+    }
+    void Draw(uint32_t, uint32_t) override {
+        ++calls;
+    }
+    void DrawIndexed(uint32_t, uint32_t, int32_t) override {
+        ++calls;
+    }
+    void DrawInstanced(uint32_t, uint32_t, uint32_t, uint32_t) override {
+        ++calls;
+    }
+    void DrawIndexedInstanced(uint32_t, uint32_t, uint32_t, int32_t, uint32_t) override {
+        ++calls;
+    }
+};
+
+struct Object {
+    uint32_t shader;   // Also picks the input layout
+    uint32_t material; // Texture, sampler and blend state
+    uint32_t mesh;     // Vertex buffer
+    uint32_t constants;
+};
+
+void* Handle(uint32_t kind, uint32_t id) {
+    return reinterpret_cast<void*>((static_cast<uintptr_t>(kind) << 20 | id) * 16 + 16);
+}
+
+std::vector<Object> MakeScene(uint32_t count) {
+    Bench::Rng rng(7);
+    std::vector<Object> objects(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        objects[i].shader    = rng.Below(4);
+        objects[i].material  = objects[i].shader * 8 + rng.Below(8);
+        objects[i].mesh      = rng.Below(32);
+        objects[i].constants = i;
+    }
+    return objects;
+}
+
+// One frame of naive per-object binding through cache
+void DrawFrame(StateCache& cache, const std::vector<Object>& objects) {
+    cache.BeginFrame();
+    cache.SetRenderTarget(Handle(1, 0), Handle(2, 0));
+    cache.SetViewport(0.0f, 0.0f, 1280.0f, 720.0f);
+    for (const Object& object : objects) {
+        cache.SetInputLayout(Handle(3, object.shader));
+        cache.SetPrimitiveTopology(4);
+        cache.SetVertexShader(Handle(4, object.shader));
+        cache.SetPixelShader(Handle(5, object.shader));
+        cache.SetVertexBuffer(0, Handle(6, object.mesh), 28, 0);
+        // 256-byte constant slots in 64 KB pages, 16 constants each
+        cache.SetVertexConstantBuffer(0,
+                                      Handle(7, object.constants / 256),
+                                      object.constants % 256 * 16,
+                                      16);
+        cache.SetPixelShaderResource(0, Handle(8, object.material));
+        cache.SetPixelSampler(0, Handle(9, object.material % 2));
+        cache.SetRasterizerState(Handle(10, 0));
+        cache.SetDepthStencilState(nullptr, 0);
+        cache.SetBlendState(Handle(11, object.material % 3), nullptr, 0xFFFFFFFF);
+        cache.Draw(36, 0);
+    }
+}
+
+void Run(const char* label, const std::vector<Object>& objects, int repetitions) {
+    CountingSink sink;
+    StateCache cache(sink);
+    DrawFrame(cache, objects); // Warm frame: the shadow starts out unknown
+    double seconds = Bench::Best(repetitions, [&] { DrawFrame(cache, objects); });
+    Bench::DoNotOptimize(sink.calls);
+
+    const StateCache::Stats& stats = cache.GetStats();
+    const uint32_t requested       = stats.issued + stats.elided;
+    Bench::Section("%s: %zu objects", label, objects.size());
+    Bench::Report("state calls requested", "%u", requested);
+    Bench::Report("state calls issued", "%u", stats.issued);
+    Bench::Report("state calls elided",
+                  "%u (%.1f %%)",
+                  stats.elided,
+                  100.0 * stats.elided / std::max(1u, requested));
+    Bench::Report("draws", "%u", stats.draws);
+    Bench::Report("cache time per frame", "%.3f ms", seconds * 1e3);
+    Bench::Report("cache time per state call", "%.2f ns", seconds * 1e9 / std::max(1u, requested));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 20;
+
+    std::vector<Object> objects = MakeScene(options.Size(10000, 1000));
+    Run("Submission order", objects, repetitions);
+
+    std::sort(objects.begin(), objects.end(), [](const Object& a, const Object& b) {
+        return a.material != b.material ? a.material < b.material : a.mesh < b.mesh;
+    });
+    Run("Sorted by material, mesh", objects, repetitions);
+    return 0;
+}
@@ -0,0 +1,176 @@
+// State Object Benchmark
+// Lookup latency of StateObjectCache, the hashing and dedup core of PipelineCache, when
+// threads recording draws all ask for the states their materials use. Every lookup hits:
+// 256 unique descriptors the size of a D3D11_RASTERIZER_DESC (40 bytes) and of a
+// D3D11_BLEND_DESC (264 bytes), from 1 to 8 threads, against a mutex-guarded
+// std::unordered_map using the same hash. Then the cost of inserting 4096 unique blend
+// descriptors, Direct3D 11's limit per kind.
+//
+//   StateObjectBench [--quick]
+#include "Bench.h"
+#include "render/StateObjectCache.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// The obvious alternative: one lock around a hash map keyed by the descriptor bytes
+class LockedMap {
+  public:
+    explicit LockedMap(size_t descSize)
+        : descSize(descSize), map(64, Hasher{descSize}, Equal{descSize}) {}
+
+    uint16_t Acquire(const uint8_t* desc) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = map.find(desc);
+        if (found != map.end()) {
+            return found->second;
+        }
+        stored.emplace_back(desc, desc + descSize);
+        const uint16_t handle = static_cast<uint16_t>(map.size());
+        map.emplace(stored.back().data(), handle);
+        return handle;
+    }
+
+  private:
+    struct Hasher {
+        size_t size;
+        size_t operator()(const uint8_t* desc) const {
+            return static_cast<size_t>(StateObjectCache::Hash(desc, size));
+        }
+    };
+    struct Equal {
+        size_t size;
+        bool operator()(const uint8_t* a, const uint8_t* b) const {
+            return std::memcmp(a, b, size) == 0;
+        }
+    };
+
+    size_t descSize;
+    std::mutex mutex;
+    std::vector<std::vector<uint8_t>> stored; // Keys point into these
+    std::unordered_map<const uint8_t*, uint16_t, Hasher, Equal> map;
+};
+
+// count descriptors of size bytes, zero but for a few fields, as a cleared D3D11 desc
+std::vector<uint8_t> MakeDescs(size_t size, uint32_t count, uint32_t seed) {
+    Bench::Rng rng(seed);
+    std::vector<uint8_t> descs(size * count, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t* desc = descs.data() + size * i;
+        std::memcpy(desc, &i, sizeof(i));
+        for (int field = 0; field < 4; ++field) {
+            const uint32_t offset = 4 + rng.Below(static_cast<uint32_t>(size) - 4);
+            desc[offset]          = static_cast<uint8_t>(rng.Next());
+        }
+    }
+    return descs;
+}
+
+/*
+Nanoseconds per lookup seen by each of threadCount threads, averaged over the threads
+acquire: Called with a descriptor, returns its handle
+*/
+template <typename Acquire>
+double LookupLatency(uint32_t threadCount,
+                     const std::vector<uint8_t>& descs,
+                     size_t descSize,
+                     uint32_t lookups,
+                     Acquire acquire) {
+    const uint32_t descCount = static_cast<uint32_t>(descs.size() / descSize);
+    std::atomic<uint32_t> ready{0};
+    std::vector<double> seconds(threadCount, 0.0);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            Bench::Rng rng(t + 1);
+            std::vector<uint32_t> sequence(lookups);
+            for (uint32_t& index : sequence) {
+                index = rng.Below(descCount);
+            }
+            ready.fetch_add(1);
+            while (ready.load() < threadCount) {
+                std::this_thread::yield();
+            }
+            uint32_t sum                         = 0;
+            const Bench::Clock::time_point start = Bench::Clock::now();
+            for (uint32_t index : sequence) {
+                sum += acquire(descs.data() + size_t(index) * descSize);
+            }
+            seconds[t] = Bench::Seconds(Bench::Clock::now() - start);
+            Bench::DoNotOptimize(sum);
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double total = 0.0;
+    for (double s : seconds) {
+        total += s;
+    }
+    return total / threadCount / lookups * 1e9;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const uint32_t lookups = options.Size(2000000, 20000);
+    const int repetitions  = options.quick ? 1 : 3;
+
+    const size_t descSizes[] = {40, 264};
+    for (size_t descSize : descSizes) {
+        const std::vector<uint8_t> descs = MakeDescs(descSize, 256, 24);
+        StateObjectCache cache(descSize);
+        LockedMap locked(descSize);
+        for (uint32_t i = 0; i < 256; ++i) {
+            cache.Acquire(descs.data() + descSize * i, nullptr);
+            locked.Acquire(descs.data() + descSize * i);
+        }
+
+        Bench::Section("%zu-byte descriptors, 256 unique, %u hits per thread", descSize, lookups);
+        auto lockFree = [&cache](const uint8_t* desc) { return cache.Acquire(desc, nullptr); };
+        auto mutex    = [&locked](const uint8_t* desc) { return locked.Acquire(desc); };
+        for (uint32_t threadCount = 1; threadCount <= 8; threadCount *= 2) {
+            double lockFreeNs = 1e30;
+            double mutexNs    = 1e30;
+            for (int r = 0; r < repetitions; ++r) {
+                lockFreeNs = std::min(
+                    lockFreeNs, LookupLatency(threadCount, descs, descSize, lookups, lockFree));
+                mutexNs =
+                    std::min(mutexNs, LookupLatency(threadCount, descs, descSize, lookups, mutex));
+            }
+            char label[64];
+            std::snprintf(label,
+                          sizeof(label),
+                          "%u thread%s",
+                          threadCount,
+                          threadCount == 1 ? "" : "s");
+            Bench::Report(label,
+                          "StateObjectCache %6.1f ns  mutex + unordered_map %6.1f ns",
+                          lockFreeNs,
+                          mutexNs);
+        }
+    }
+
+    Bench::Section("inserting %u unique 264-byte descriptors", StateObjectCache::MaxCapacity);
+    const std::vector<uint8_t> many = MakeDescs(264, StateObjectCache::MaxCapacity, 25);
+    const double seconds            = Bench::Best(repetitions, [&many] {
+        StateObjectCache cache(264);
+        for (uint32_t i = 0; i < StateObjectCache::MaxCapacity; ++i) {
+            cache.Acquire(many.data() + size_t(264) * i, nullptr);
+        }
+        Bench::DoNotOptimize(cache.GetCount());
+    });
+    Bench::Report("empty cache to full",
+                  "%7.1f us  %5.1f ns per insert",
+                  seconds * 1e6,
+                  seconds * 1e9 / StateObjectCache::MaxCapacity);
+    return 0;
+}
@@ -0,0 +1,197 @@
+// Texture Streamer Benchmark
+// Texture streaming under a memory budget, with a camera moving along a ring of BC7
+// textures. Each texture is sampled at a mip that gets coarser with its distance from the
+// camera, and textures out of view are not sampled. Frames run at a fixed 1 ms, with two
+// loader threads reading DDS files and a null uploader. For budgets well above and just
+// around what the view needs, and a fast camera, the benchmark reports:
+// - the share of requests whose mip was resident
+// - MB/s streamed and evicted
+// - the render thread's Update cost per frame
+//
+//   TextureStreamerBench [--quick]
+#include "Bench.h"
+#include "render/TextureStreamer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+const double FrameSeconds = 0.001;
+const uint32_t ViewRange  = 16; // Textures on either side of the camera that are sampled
+
+// Keeps nothing: measures the streamer and the residency policy, not D3D11
+class NullUploader : public TextureStreamer::Uploader {
+  public:
+    bool UploadMips(uint32_t, const TextureDesc&, uint32_t, uint32_t, const uint8_t*) override {
+        return true;
+    }
+    void Evict(uint32_t, const TextureDesc&, uint32_t) override {}
+};
+
+void PutU32(std::vector<uint8_t>& bytes, size_t offset, uint32_t value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+}
+
+// A BC7 DDS (DX10 header) of size x size with a full mip chain of noise
+bool WriteDds(const std::string& path, uint32_t size, Bench::Rng& rng) {
+    TextureDesc desc;
+    desc.format   = TextureFormat::BC7;
+    desc.width    = size;
+    desc.height   = size;
+    desc.mipCount = 1;
+    while ((size >> desc.mipCount) > 0) {
+        ++desc.mipCount;
+    }
+    std::vector<uint8_t> bytes(4 + 124 + 20, 0);
+    PutU32(bytes, 0, 0x20534444);
+    PutU32(bytes, 4, 124);
+    PutU32(bytes, 8, 0x1007 | 0x20000);
+    PutU32(bytes, 12, size);
+    PutU32(bytes, 16, size);
+    PutU32(bytes, 28, desc.mipCount);
+    PutU32(bytes, 76, 32);
+    PutU32(bytes, 80, 0x4);
+    PutU32(bytes, 84, 0x30315844); // "DX10"
+    PutU32(bytes, 128, 98);        // DXGI_FORMAT_BC7_UNORM
+    PutU32(bytes, 132, 3);         // Texture2D
+    PutU32(bytes, 140, 1);
+    for (uint32_t mip = 0; mip < desc.mipCount; ++mip) {
+        const size_t start = bytes.size();
+        bytes.resize(start + desc.MipBytes(mip));
+        for (size_t i = start; i + 4 <= bytes.size(); i += 4) {
+            const uint32_t word = rng.Next();
+            std::memcpy(bytes.data() + i, &word, sizeof(word));
+        }
+    }
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && written;
+}
+
+struct Scenario {
+    const char* label;
+    double budgetShare; // Of all the textures at full detail
+    double speed;       // Textures the camera passes per second
+};
+
+void Run(const Scenario& scenario,
+         const std::vector<std::string>& paths,
+         uint64_t totalBytes,
+         uint32_t frames) {
+    TextureStreamer streamer;
+    const uint32_t count = static_cast<uint32_t>(paths.size());
+    for (const std::string& path : paths) {
+        streamer.Add(path);
+    }
+    TextureStreamer::Settings settings;
+    settings.budgetBytes = static_cast<uint64_t>(static_cast<double>(totalBytes) *
+                                                 scenario.budgetShare);
+    settings.threadCount = 2;
+    streamer.Start(settings);
+
+    NullUploader uploader;
+    std::vector<double> updateMicroseconds;
+    updateMicroseconds.reserve(frames);
+    const Bench::Clock::time_point start = Bench::Clock::now();
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        // Mip 0 up to 4 textures away, then one level coarser every doubling of distance
+        const double camera = std::fmod(frame * FrameSeconds * scenario.speed, count);
+        const int32_t near  = static_cast<int32_t>(camera);
+        for (int32_t offset = -static_cast<int32_t>(ViewRange);
+             offset <= static_cast<int32_t>(ViewRange);
+             ++offset) {
+            const uint32_t texture = static_cast<uint32_t>((near + offset + count) % count);
+            const double distance  = std::fabs(near + offset - camera);
+            streamer.Request(texture, static_cast<uint32_t>(std::log2(1.0 + distance / 4.0)));
+        }
+
+        const Bench::Clock::time_point updateStart = Bench::Clock::now();
+        streamer.Update(uploader);
+        updateMicroseconds.push_back(Bench::Seconds(Bench::Clock::now() - updateStart) * 1e6);
+        std::this_thread::sleep_until(start + std::chrono::milliseconds(frame + 1));
+    }
+    const double seconds = Bench::Seconds(Bench::Clock::now() - start);
+    streamer.Stop();
+
+    const TextureResidency::Stats stats = streamer.GetStats();
+    std::sort(updateMicroseconds.begin(), updateMicroseconds.end());
+    const size_t samples = updateMicroseconds.size();
+    Bench::Report(scenario.label,
+                  "%5.1f%% hits  in %6.1f MB/s  out %6.1f MB/s  update p50 %4.1f us p99 %5.1f us",
+                  100.0 * static_cast<double>(stats.hits) / static_cast<double>(stats.requests),
+                  static_cast<double>(stats.bytesLoaded) / seconds / (1024.0 * 1024.0),
+                  static_cast<double>(stats.bytesEvicted) / seconds / (1024.0 * 1024.0),
+                  updateMicroseconds[samples / 2],
+                  updateMicroseconds[std::min(samples - 1, samples * 99 / 100)]);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const uint32_t count   = options.Size(128, 48);
+    const uint32_t size    = options.Size(1024, 256);
+    const uint32_t frames  = options.Size(3000, 300);
+
+    const fs::path directory = fs::temp_directory_path() / "TextureStreamerBench";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    Bench::Rng rng(21);
+    std::vector<std::string> paths;
+    for (uint32_t i = 0; i < count; ++i) {
+        paths.push_back((directory / ("texture" + std::to_string(i) + ".dds")).string());
+        if (!WriteDds(paths.back(), size, rng)) {
+            std::fprintf(stderr, "Could not write %s\n", paths.back().c_str());
+            return 1;
+        }
+    }
+
+    // What the view needs at once: the textures in range at the mip their distance asks for
+    uint64_t levelBytes[TextureFile::MaxMips + 1] = {};
+    TextureFile probe;
+    if (!probe.Open(paths[0])) {
+        return 1;
+    }
+    const TextureDesc& desc = probe.GetDesc();
+    for (uint32_t mip = desc.mipCount; mip-- > 0;) {
+        levelBytes[mip] = levelBytes[mip + 1] + desc.MipBytes(mip);
+    }
+    uint64_t workingSet = 0;
+    for (uint32_t distance = 0; distance <= ViewRange; ++distance) {
+        const uint32_t mip = static_cast<uint32_t>(std::log2(1.0 + distance / 4.0));
+        workingSet += levelBytes[std::min(mip, desc.mipCount - 1)] * (distance == 0 ? 1 : 2);
+    }
+    probe.Close();
+
+    const uint64_t totalBytes = levelBytes[0] * count;
+    Bench::Section("%u textures of %ux%u BC7 (%.1f MB), view needs %.1f MB, %u frames",
+                   count,
+                   size,
+                   size,
+                   static_cast<double>(totalBytes) / (1024.0 * 1024.0),
+                   static_cast<double>(workingSet) / (1024.0 * 1024.0),
+                   frames);
+    const Scenario scenarios[] = {
+        {"budget 3/8 of all", 0.375, 20.0},
+        {"budget 3/32 of all", 0.09375, 20.0},
+        {"budget 3/16, camera 5x faster", 0.1875, 100.0},
+    };
+    for (const Scenario& scenario : scenarios) {
+        Run(scenario, paths, totalBytes, frames);
+    }
+
+    fs::remove_all(directory);
+    return 0;
+}
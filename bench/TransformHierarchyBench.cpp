@@ -0,0 +1,154 @@
+// Transform Hierarchy Benchmark
+// World matrix updates of a large scene graph through TransformHierarchy: a forest of random
+// recursive trees (every node hangs below a random earlier node of its tree). Times the
+// first Update, which lays the forest out, then frames that move 1% and 100% of the nodes
+// (SetLocal on each, then Update), serially and on the job system. The baseline is the usual
+// tree of heap-allocated nodes with child pointers, updated by recursion from every root.
+//
+//   TransformHierarchyBench [--quick]
+#include "Bench.h"
+#include "scene/TransformHierarchy.h"
+#include "threading/JobSystem.h"
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+
+const uint32_t TreeCount = 1000;
+
+// The pointer-chasing scene graph the hierarchy replaces
+struct TreeNode {
+    Float4x4 local;
+    Float4x4 world;
+    std::vector<TreeNode*> children;
+};
+
+void UpdateRecursive(TreeNode& node, const Float4x4& parentWorld) {
+    node.world = Float4x4::Multiply(node.local, parentWorld);
+    for (TreeNode* child : node.children) {
+        UpdateRecursive(*child, node.world);
+    }
+}
+
+// A turn about z and a small offset, so deep chains stay finite
+Float4x4 RandomLocal(Bench::Rng& rng) {
+    const float angle = rng.Range(-3.14159265f, 3.14159265f);
+    const float c     = std::cos(angle);
+    const float s     = std::sin(angle);
+    return {{{c, s, 0.0f, 0.0f},
+             {-s, c, 0.0f, 0.0f},
+             {0.0f, 0.0f, 1.0f, 0.0f},
+             {rng.Range(-1.0f, 1.0f), rng.Range(-1.0f, 1.0f), 0.0f, 1.0f}}};
+}
+
+// Parent of every node: the first TreeCount are roots, node i belongs to tree i % TreeCount
+std::vector<uint32_t> BuildForest(uint32_t count, Bench::Rng& rng) {
+    std::vector<uint32_t> parents(count, TransformHierarchy::InvalidNode);
+    for (uint32_t node = TreeCount; node < count; ++node) {
+        parents[node] = node % TreeCount + TreeCount * rng.Below(node / TreeCount);
+    }
+    return parents;
+}
+
+/*
+Time frames frames that each give moved random nodes a new local and update; reports the
+cost per frame, per recomputed node and the size of the change list
+*/
+void RunFrames(const char* label,
+               TransformHierarchy& hierarchy,
+               const std::vector<Float4x4>& pool,
+               uint32_t moved,
+               uint32_t frames,
+               int repetitions) {
+    const uint32_t count = hierarchy.GetNodeCount();
+    Bench::Rng rng(7);
+    uint64_t recomputed  = 0;
+    uint64_t ranges      = 0;
+    const double seconds = Bench::Best(repetitions, [&] {
+        recomputed = 0;
+        ranges     = 0;
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            for (uint32_t i = 0; i < moved; ++i) {
+                const uint32_t node = moved == count ? i : rng.Below(count);
+                hierarchy.SetLocal(node, pool[(frame + i) % pool.size()]);
+            }
+            recomputed += hierarchy.Update();
+            ranges += hierarchy.GetChangedRanges().size();
+        }
+    });
+    Bench::Report(label,
+                  "%7.3f ms/frame  %5.1f ns/node  %8.0f nodes in %6.0f ranges",
+                  seconds * 1e3 / frames,
+                  seconds * 1e9 / static_cast<double>(recomputed),
+                  static_cast<double>(recomputed) / frames,
+                  static_cast<double>(ranges) / frames);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 5;
+    const uint32_t count   = options.Size(1000000, 50000);
+    const uint32_t frames  = options.Size(20, 2);
+
+    Bench::Rng rng(20);
+    const std::vector<uint32_t> parents = BuildForest(count, rng);
+    std::vector<Float4x4> pool(4096);
+    for (Float4x4& local : pool) {
+        local = RandomLocal(rng);
+    }
+
+    Bench::Section("%u nodes in %u random trees, %u frames", count, TreeCount, frames);
+
+    // Baseline: every world matrix recomputed by recursion over heap nodes, every frame
+    std::vector<std::unique_ptr<TreeNode>> tree(count);
+    for (uint32_t node = 0; node < count; ++node) {
+        tree[node]        = std::make_unique<TreeNode>();
+        tree[node]->local = pool[node % pool.size()];
+        if (parents[node] != TransformHierarchy::InvalidNode) {
+            tree[parents[node]]->children.push_back(tree[node].get());
+        }
+    }
+    double seconds = Bench::Best(repetitions, [&] {
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            for (uint32_t root = 0; root < TreeCount; ++root) {
+                UpdateRecursive(*tree[root], Float4x4::Identity());
+            }
+        }
+    });
+    Bench::Report("recursive node tree, all nodes",
+                  "%7.3f ms/frame  %5.1f ns/node",
+                  seconds * 1e3 / frames,
+                  seconds * 1e9 / (static_cast<double>(count) * frames));
+    tree.clear();
+
+    TransformHierarchy hierarchy;
+    seconds = Bench::Best(repetitions, [&] {
+        hierarchy.Clear();
+        hierarchy.Reserve(count);
+        for (uint32_t node = 0; node < count; ++node) {
+            hierarchy.AddNode(parents[node], pool[node % pool.size()]);
+        }
+        hierarchy.Update();
+    });
+    Bench::Report("build and first Update (layout)", "%7.3f ms", seconds * 1e3);
+
+    RunFrames("1% moved", hierarchy, pool, count / 100, frames, repetitions);
+    RunFrames("100% moved", hierarchy, pool, count, frames, repetitions);
+
+    JobSystem jobSystem;
+    jobSystem.Initialize();
+    hierarchy.SetParallelFor(jobSystem.GetTaskExecutor());
+    char label[64];
+    const uint32_t threads = jobSystem.GetThreadCount();
+    const char* plural     = threads == 1 ? "" : "s";
+    std::snprintf(label, sizeof(label), "1%% moved, %u thread%s", threads, plural);
+    RunFrames(label, hierarchy, pool, count / 100, frames, repetitions);
+    std::snprintf(label, sizeof(label), "100%% moved, %u thread%s", threads, plural);
+    RunFrames(label, hierarchy, pool, count, frames, repetitions);
+    jobSystem.Shutdown();
+    return 0;
+}
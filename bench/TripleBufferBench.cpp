@@ -0,0 +1,247 @@
+// Triple Buffer Benchmark
+// Cost and latency of the simulation thread's handoff primitives: TripleBuffer (snapshots to
+// the render thread) and SpscQueue (input events from the window thread), against the
+// obvious alternative of a mutex around a shared copy. Reports the single-thread cost of a
+// publish plus pick-up, the cross-thread delay from publish to the reader seeing it, and how
+// long a reader's pick-up takes while a writer publishes 4 KB snapshots nonstop.
+//
+//   TripleBufferBench [--quick]
+#include "Bench.h"
+#include "threading/SpscQueue.h"
+#include "threading/TripleBuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Snapshot {
+    int64_t published   = 0; // Clock time in nanoseconds
+    uint8_t state[4088] = {};
+};
+
+struct Event {
+    int64_t published = 0;
+    uint32_t key      = 0;
+};
+
+int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               Bench::Clock::now().time_since_epoch())
+        .count();
+}
+
+// The mutex alternative: the writer copies in under the lock, the reader copies out
+template <typename T>
+class LockedValue {
+  public:
+    void Publish(const T& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        shared = value;
+        fresh  = true;
+    }
+    bool Update(T& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!fresh) {
+            return false;
+        }
+        value = shared;
+        fresh = false;
+        return true;
+    }
+
+  private:
+    std::mutex mutex;
+    T shared{};
+    bool fresh = false;
+};
+
+void ReportPercentiles(const char* name, std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    const size_t count = samples.size();
+    Bench::Report(name,
+                  "p50 %7.2f us  p99 %7.2f us  p99.9 %7.2f us  max %8.2f us",
+                  samples[count / 2],
+                  samples[std::min(count - 1, count * 99 / 100)],
+                  samples[std::min(count - 1, count * 999 / 1000)],
+                  samples.back());
+}
+
+/*
+Publish-to-observe delay in microseconds: the writer publishes a timestamp, waits until
+the reader has seen it, pauses, and repeats
+*/
+template <typename Publish, typename Observe>
+std::vector<double> HandoffLatency(uint32_t samples, Publish&& publish, Observe&& observe) {
+    std::atomic<uint32_t> seen{0};
+    std::vector<double> latency;
+    latency.reserve(samples);
+    std::thread reader([&] {
+        while (seen.load(std::memory_order_relaxed) < samples) {
+            int64_t published = 0;
+            if (observe(published)) {
+                latency.push_back((Now() - published) * 1e-3);
+                seen.fetch_add(1, std::memory_order_release);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (uint32_t i = 0; i < samples; ++i) {
+        publish(Now());
+        while (seen.load(std::memory_order_acquire) <= i) {
+            std::this_thread::yield();
+        }
+    }
+    reader.join();
+    return latency;
+}
+
+/*
+Duration in microseconds of each of the reader's pick-ups (including the copy the mutex
+version makes) while a writer publishes 4 KB snapshots as fast as it can
+*/
+template <typename Publish, typename Read>
+std::vector<double> ReaderUnderLoad(uint32_t reads, Publish&& publish, Read&& read) {
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        int64_t sequence = 0;
+        while (!done.load(std::memory_order_relaxed)) {
+            publish(++sequence);
+        }
+    });
+    std::vector<double> durations;
+    durations.reserve(reads);
+    for (uint32_t i = 0; i < reads; ++i) {
+        const Bench::Clock::time_point start = Bench::Clock::now();
+        Bench::DoNotOptimize(read());
+        durations.push_back(Bench::Seconds(Bench::Clock::now() - start) * 1e6);
+        if (i % 64 == 0) {
+            std::this_thread::yield(); // Let the writer run even on one core
+        }
+    }
+    done.store(true);
+    writer.join();
+    return durations;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 5;
+    const uint32_t ops     = options.Size(1000000, 20000);
+
+    // One thread alternating both sides: the uncontended cost of the operations themselves
+    Bench::Section("One thread, %u operations", ops);
+    struct Small {
+        int64_t published;
+        float state[14];
+    };
+    TripleBuffer<Small> triple;
+    const double tripleCost = Bench::Best(repetitions, [&] {
+        for (uint32_t i = 0; i < ops; ++i) {
+            triple.GetWriteBuffer().published = i;
+            triple.Publish();
+            triple.Update();
+            Bench::DoNotOptimize(triple.GetReadBuffer().published);
+        }
+    });
+    Bench::Report("TripleBuffer publish + update", "%6.1f ns", tripleCost * 1e9 / ops);
+    LockedValue<Small> locked;
+    const double lockedCost = Bench::Best(repetitions, [&] {
+        Small value = {};
+        for (uint32_t i = 0; i < ops; ++i) {
+            value.published = i;
+            locked.Publish(value);
+            locked.Update(value);
+            Bench::DoNotOptimize(value.published);
+        }
+    });
+    Bench::Report("mutex + copy, 64 bytes", "%6.1f ns", lockedCost * 1e9 / ops);
+    SpscQueue<Event, 256> queue;
+    const double queueCost = Bench::Best(repetitions, [&] {
+        Event event;
+        for (uint32_t i = 0; i < ops; ++i) {
+            event.key = i;
+            queue.Push(event);
+            queue.Pop(event);
+            Bench::DoNotOptimize(event.key);
+        }
+    });
+    Bench::Report("SpscQueue push + pop", "%6.1f ns", queueCost * 1e9 / ops);
+
+    // Writer and reader on different threads; the reader polls and yields between polls
+    const uint32_t samples = options.Size(20000, 500);
+    Bench::Section("Publish to observe, %u handoffs", samples);
+    TripleBuffer<Event> latest;
+    ReportPercentiles("TripleBuffer",
+                      HandoffLatency(
+                          samples,
+                          [&](int64_t time) {
+                              latest.GetWriteBuffer().published = time;
+                              latest.Publish();
+                          },
+                          [&](int64_t& published) {
+                              if (!latest.Update()) {
+                                  return false;
+                              }
+                              published = latest.GetReadBuffer().published;
+                              return true;
+                          }));
+    SpscQueue<Event, 256> events;
+    ReportPercentiles("SpscQueue",
+                      HandoffLatency(
+                          samples,
+                          [&](int64_t time) {
+                              Event event;
+                              event.published = time;
+                              events.Push(event);
+                          },
+                          [&](int64_t& published) {
+                              Event event;
+                              if (!events.Pop(event)) {
+                                  return false;
+                              }
+                              published = event.published;
+                              return true;
+                          }));
+
+    // Reader cost while the writer never stops: the mutex makes the reader wait for, and
+    // then copy, a 4 KB snapshot; the triple buffer is one exchange
+    const uint32_t reads = options.Size(200000, 5000);
+    Bench::Section("Reader pick-up against a nonstop 4 KB writer, %u reads", reads);
+    TripleBuffer<Snapshot> snapshots;
+    ReportPercentiles("TripleBuffer",
+                      ReaderUnderLoad(
+                          reads,
+                          [&](int64_t sequence) {
+                              Snapshot& snapshot = snapshots.GetWriteBuffer();
+                              std::memset(snapshot.state, static_cast<int>(sequence), 64);
+                              snapshot.published = sequence;
+                              snapshots.Publish();
+                          },
+                          [&] {
+                              snapshots.Update();
+                              return snapshots.GetReadBuffer().published;
+                          }));
+    LockedValue<Snapshot> lockedSnapshots;
+    Snapshot writerCopy;
+    Snapshot readerCopy;
+    ReportPercentiles("mutex + copy",
+                      ReaderUnderLoad(
+                          reads,
+                          [&](int64_t sequence) {
+                              std::memset(writerCopy.state, static_cast<int>(sequence), 64);
+                              writerCopy.published = sequence;
+                              lockedSnapshots.Publish(writerCopy);
+                          },
+                          [&] {
+                              lockedSnapshots.Update(readerCopy);
+                              return readerCopy.published;
+                          }));
+    return 0;
+}
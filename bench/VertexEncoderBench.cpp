@@ -0,0 +1,105 @@
+// Vertex Encoder Benchmark
+// Cost of packing vertices before upload, as Graphics does for every SetVertexBuffer: float
+// Vertex (28 bytes) to PackedVertex (12 bytes) with the scalar reference encoders and the
+// SSE2 ones, against a plain copy of the float vertices; and float3 normals to octahedral
+// SNORM16x2 (12 bytes to 4). Reports million attributes per second and bytes written.
+//
+//   VertexEncoderBench [--quick]
+#include "Bench.h"
+#include "render/VertexEncoder.h"
+#include <cstring>
+#include <vector>
+
+namespace {
+
+void Print(const char* label, double seconds, uint32_t count, size_t bytesPerItem) {
+    Bench::Report(label,
+                  "%8.1f M/s  %8.3f ms  %6.1f MB written",
+                  count / seconds / 1e6,
+                  seconds * 1e3,
+                  static_cast<double>(count) * bytesPerItem / 1048576.0);
+}
+
+void EncodeVerticesScalar(const Vertex* vertices, uint32_t count, PackedVertex* destination) {
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(destination);
+    VertexEncoder::EncodeSNorm16x4Scalar(vertices[0].position,
+                                         sizeof(Vertex),
+                                         count,
+                                         bytes + offsetof(PackedVertex, position),
+                                         sizeof(PackedVertex));
+    VertexEncoder::EncodeUNorm8x4Scalar(vertices[0].color,
+                                        sizeof(Vertex),
+                                        count,
+                                        bytes + offsetof(PackedVertex, color),
+                                        sizeof(PackedVertex));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Bench::Options options = Bench::Options::Parse(argc, argv);
+    const int repetitions  = options.quick ? 1 : 20;
+    const uint32_t count   = options.Size(1000000, 20000);
+
+    Bench::Rng rng;
+    std::vector<Vertex> vertices(count);
+    std::vector<float> normals(count * 3);
+    for (uint32_t i = 0; i < count; ++i) {
+        for (float& value : vertices[i].position) {
+            value = rng.Range(-1.0f, 1.0f);
+        }
+        for (float& value : vertices[i].color) {
+            value = rng.Unit();
+        }
+        for (uint32_t c = 0; c < 3; ++c) {
+            normals[i * 3 + c] = rng.Range(-1.0f, 1.0f);
+        }
+    }
+
+    Bench::Section("Vertices: %u, %zu bytes float, %zu bytes packed",
+                   count,
+                   sizeof(Vertex),
+                   sizeof(PackedVertex));
+    std::vector<Vertex> copy(count);
+    double copied = Bench::Best(repetitions, [&] {
+        std::memcpy(copy.data(), vertices.data(), count * sizeof(Vertex));
+        Bench::DoNotOptimize(copy.back());
+    });
+    Print("float copy (memcpy)", copied, count, sizeof(Vertex));
+
+    std::vector<PackedVertex> packed(count);
+    double scalar = Bench::Best(repetitions, [&] {
+        EncodeVerticesScalar(vertices.data(), count, packed.data());
+        Bench::DoNotOptimize(packed.back());
+    });
+    Print("packed, scalar", scalar, count, sizeof(PackedVertex));
+
+    double simd = Bench::Best(repetitions, [&] {
+        VertexEncoder::EncodeVertices(vertices.data(), count, packed.data());
+        Bench::DoNotOptimize(packed.back());
+    });
+    Print("packed, SSE2", simd, count, sizeof(PackedVertex));
+
+    Bench::Section("Normals: %u, 12 bytes float3, %zu bytes octahedral", count, sizeof(SNorm16x2));
+    std::vector<SNorm16x2> encoded(count);
+    double normalScalar = Bench::Best(repetitions, [&] {
+        VertexEncoder::EncodeOctahedralScalar(normals.data(),
+                                              3 * sizeof(float),
+                                              count,
+                                              encoded.data(),
+                                              sizeof(SNorm16x2));
+        Bench::DoNotOptimize(encoded.back());
+    });
+    Print("octahedral, scalar", normalScalar, count, sizeof(SNorm16x2));
+
+    double normalSimd = Bench::Best(repetitions, [&] {
+        VertexEncoder::EncodeOctahedral(normals.data(),
+                                        3 * sizeof(float),
+                                        count,
+                                        encoded.data(),
+                                        sizeof(SNorm16x2));
+        Bench::DoNotOptimize(encoded.back());
+    });
+    Print("octahedral, SSE2", normalSimd, count, sizeof(SNorm16x2));
+    return 0;
+}
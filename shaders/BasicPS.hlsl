@@ -1,11 +1,17 @@
+// Streamed material texture: only its resident mips are in the view, so sampling a finer
+// level than has arrived reads the finest one that has (white until the first lands)
+Texture2D materialTexture : register(t0);
+SamplerState materialSampler : register(s0);
+
 struct PixelInput
 {
     float4 position : SV_POSITION;
     float4 color : COLOR;
+    float2 uv : TEXCOORD0;
 };
 
 float4 main(PixelInput input) : SV_TARGET
 {
-    return input.color;
+    return materialTexture.Sample(materialSampler, input.uv) * input.color;
 } 
 
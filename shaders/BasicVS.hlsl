@@ -1,19 +1,42 @@
 struct VertexInput
 {
+    // Stored as SNORM16 and RGBA8 (PackedVertex); the input assembler expands them to floats
     float3 position : POSITION;
     float4 color : COLOR;
+
+    // Per-instance stream (slot 1): rows of a 3x4 transform and a color multiplier
+    // Non-instanced draws read instance 0, which is the identity
+    float4 row0 : INSTANCE_TRANSFORM0;
+    float4 row1 : INSTANCE_TRANSFORM1;
+    float4 row2 : INSTANCE_TRANSFORM2;
+    float4 instanceColor : INSTANCE_COLOR;
+};
+
+// Per-object constants: a 256-byte window of a shared buffer, bound per draw (b0)
+cbuffer ObjectConstants : register(b0)
+{
+    row_major float4x4 worldViewProjection; // World * view-projection, row-vector convention
 };
 
 struct VertexOutput
 {
     float4 position : SV_POSITION;
     float4 color : COLOR;
+    float2 uv : TEXCOORD0;
 };
 
 VertexOutput main(VertexInput input)
 {
     VertexOutput output;
-    output.position = float4(input.position, 1.0f);
-    output.color = input.color;
+    float4 position = float4(input.position, 1.0f);
+    float4 placed   = float4(dot(input.row0, position),
+                             dot(input.row1, position),
+                             dot(input.row2, position),
+                             1.0f);
+    output.position = mul(placed, worldViewProjection);
+    output.color = input.color * input.instanceColor;
+
+    // Planar mapping of the model's xy plane: [-1, 1] covers the texture once, v downwards
+    output.uv = input.position.xy * float2(0.5f, -0.5f) + 0.5f;
     return output;
 } 
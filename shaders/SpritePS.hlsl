@@ -0,0 +1,14 @@
+Texture2D spriteTexture : register(t0);
+SamplerState spriteSampler : register(s0);
+
+struct PixelInput
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD0;
+    float4 color : COLOR;
+};
+
+float4 main(PixelInput input) : SV_TARGET
+{
+    return spriteTexture.Sample(spriteSampler, input.uv) * input.color;
+}
@@ -0,0 +1,23 @@
+struct VertexInput
+{
+    // SpriteVertex: the batch has already transformed the corners to clip space
+    float2 position : POSITION;
+    float2 uv : TEXCOORD0;
+    float4 color : COLOR;
+};
+
+struct VertexOutput
+{
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD0;
+    float4 color : COLOR;
+};
+
+VertexOutput main(VertexInput input)
+{
+    VertexOutput output;
+    output.position = float4(input.position, 0.0f, 1.0f);
+    output.uv = input.uv;
+    output.color = input.color;
+    return output;
+}
@@ -0,0 +1,111 @@
+#include "ConstantBufferPool.h"
+#include "utils/Logger.h"
+
+bool ConstantBufferPool::Initialize(ID3D11Device* device, uint32_t slotsPerPage) {
+    this->device = device;
+    allocator    = ConstantAllocator(slotsPerPage);
+    pages.clear();
+
+    // Binding a window of a constant buffer is a Direct3D 11.1 runtime feature; without it
+    // every object would need a buffer of its own
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+    HRESULT hr = device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS,
+                                             &options,
+                                             sizeof(options));
+    if (FAILED(hr) || !options.ConstantBufferOffsetting) {
+        LOG_ERROR("Constant buffer offsetting is not supported (needs the D3D11.1 runtime)");
+        return false;
+    }
+    return true;
+}
+
+void ConstantBufferPool::BeginFrame(ID3D11DeviceContext* context) {
+    Unmap();
+    this->context = context;
+    allocator.BeginFrame();
+}
+
+void ConstantBufferPool::Unmap() {
+    allocator.ClosePage();
+    for (Page& page : pages) {
+        if (page.mapped) {
+            if (capture && capture->IsCapturing()) {
+                capture->RecordBufferData(page.buffer.Get(),
+                                          0,
+                                          page.data,
+                                          uint64_t(page.usedSlots) * ConstantAllocator::SlotSize);
+            }
+            context->Unmap(page.buffer.Get(), 0);
+            page.data      = nullptr;
+            page.usedSlots = 0;
+            page.mapped    = false;
+        }
+    }
+}
+
+void ConstantBufferPool::OnAllocated(uint32_t firstSlot, uint32_t slotCount) {
+    if (!capture) {
+        return;
+    }
+    // Pages fill from slot 0 in order, so the extent is the end of the latest run
+    Page& page     = pages[allocator.GetPage(firstSlot)];
+    page.usedSlots = firstSlot % allocator.GetSlotsPerPage() + slotCount;
+}
+
+uint8_t* ConstantBufferPool::MapPage(uint32_t page) {
+    if (!context) {
+        return nullptr;
+    }
+
+    // ========================================
+    // 1. CREATE THE PAGE ON FIRST USE
+    // ========================================
+    // Constant buffers larger than 64 KB are fine on 11.1; a draw only sees its window
+    while (pages.size() <= page) {
+        D3D11_BUFFER_DESC desc = {};
+        desc.Usage             = D3D11_USAGE_DYNAMIC;
+        desc.ByteWidth         = allocator.GetSlotsPerPage() * ConstantAllocator::SlotSize;
+        desc.BindFlags         = D3D11_BIND_CONSTANT_BUFFER;
+        desc.CPUAccessFlags    = D3D11_CPU_ACCESS_WRITE;
+
+        Page newPage;
+        HRESULT hr = device->CreateBuffer(&desc, nullptr, newPage.buffer.GetAddressOf());
+        if (FAILED(hr)) {
+            LOG_ERROR("Failed to create constant buffer page! HRESULT: 0x%08X",
+                      static_cast<unsigned>(hr));
+            return nullptr;
+        }
+        pages.push_back(newPage);
+        LOG_INFO("Constant buffer page %u created (%u bytes)",
+                 static_cast<unsigned>(pages.size() - 1),
+                 desc.ByteWidth);
+    }
+
+    // ========================================
+    // 2. MAP ONCE PER FRAME
+    // ========================================
+    // DISCARD hands back fresh memory, so last frame's constants stay intact for the GPU
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    HRESULT hr = context->Map(pages[page].buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to map constant buffer page! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+        return nullptr;
+    }
+    pages[page].data   = static_cast<uint8_t*>(mapped.pData);
+    pages[page].mapped = true;
+    return pages[page].data;
+}
+
+void ConstantBufferPool::BindVertex(StateCache& state,
+                                    uint32_t reg,
+                                    uint32_t slot,
+                                    uint32_t slotCount) const {
+    const uint32_t page = allocator.GetPage(slot);
+    if (page >= pages.size()) {
+        return;
+    }
+    state.SetVertexConstantBuffer(reg,
+                                  pages[page].buffer.Get(),
+                                  allocator.GetFirstConstant(slot),
+                                  slotCount * ConstantAllocator::ConstantsPerSlot);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "render/ConstantAllocator.h"
+#include "render/FrameCapture.h"
+#include "render/StateCache.h"
+#include "utils/stdafx.h"
+#include <d3d11_1.h>
+#include <vector>
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+// Constant Buffer Pool Class
+// Per-object shader constants without a buffer or a Map per object: a ConstantAllocator
+// packs them into 256-byte slots of a few large DYNAMIC constant buffers (pages), each page
+// is mapped once per frame with WRITE_DISCARD when its first slot is handed out, and draws
+// bind their slot's window with VSSetConstantBuffers1. Pages are created on demand and kept.
+// Needs the Direct3D 11.1 runtime with constant buffer offsetting (Windows 8 and later).
+class ConstantBufferPool : public ConstantAllocator::Target {
+  public:
+    ConstantBufferPool()           = default;
+    ~ConstantBufferPool() override = default;
+
+    ConstantBufferPool(const ConstantBufferPool&)            = delete;
+    ConstantBufferPool& operator=(const ConstantBufferPool&) = delete;
+
+    /*
+    Check for constant buffer offsetting and remember the device
+    slotsPerPage: 256-byte slots per buffer (16384 = 4 MB)
+    */
+    bool Initialize(ID3D11Device* device, uint32_t slotsPerPage = 16384);
+
+    // Start a frame: later allocations map their pages on context with WRITE_DISCARD
+    void BeginFrame(ID3D11DeviceContext* context);
+
+    // Unmap every page; must be called before any draw that reads them. Later allocations
+    // in the same frame go to a new page
+    void Unmap();
+
+    // Slots for the frame's objects (see ConstantAllocator)
+    ConstantAllocator::Run Allocate(uint32_t objectCount, uint32_t slotsPerObject = 1) {
+        return allocator.Allocate(*this, objectCount, slotsPerObject);
+    }
+    uint32_t AllocateOne(uint32_t slotsPerObject, uint8_t** cpuPtr) {
+        return allocator.AllocateOne(*this, slotsPerObject, cpuPtr);
+    }
+
+    // Bind slotCount slots from slot to vertex shader register b<reg> through the cache
+    void BindVertex(StateCache& state, uint32_t reg, uint32_t slot, uint32_t slotCount) const;
+
+    // For code that allocates through the portable interface (ObjectSubmitter)
+    ConstantAllocator& GetAllocator() {
+        return allocator;
+    }
+    const ConstantAllocator& GetAllocator() const {
+        return allocator;
+    }
+
+    // While capture is capturing, Unmap records the slots handed out in each page
+    void SetCapture(FrameCapture* capture) {
+        this->capture = capture;
+    }
+
+    // ConstantAllocator::Target interface
+    uint8_t* MapPage(uint32_t page) override;
+    void OnAllocated(uint32_t firstSlot, uint32_t slotCount) override;
+
+  private:
+    struct Page {
+        ComPtr<ID3D11Buffer> buffer;
+        uint8_t* data      = nullptr; // While mapped
+        uint32_t usedSlots = 0;       // Extent handed out since the Map (tracked for capture)
+        bool mapped        = false;
+    };
+
+    ID3D11Device* device         = nullptr;
+    ID3D11DeviceContext* context = nullptr; // Set by BeginFrame
+    ConstantAllocator allocator;
+    std::vector<Page> pages;
+    FrameCapture* capture = nullptr;
+};
@@ -0,0 +1,119 @@
+#include "D3D11ContextSink.h"
+
+void D3D11ContextSink::SetContext(ID3D11DeviceContext* deviceContext) {
+    context = deviceContext;
+    context1.Reset();
+    if (context) {
+        context->QueryInterface(__uuidof(ID3D11DeviceContext1),
+                                reinterpret_cast<void**>(context1.GetAddressOf()));
+    }
+}
+
+void D3D11ContextSink::SetInputLayout(void* layout) {
+    context->IASetInputLayout(static_cast<ID3D11InputLayout*>(layout));
+}
+
+void D3D11ContextSink::SetPrimitiveTopology(uint32_t topology) {
+    context->IASetPrimitiveTopology(static_cast<D3D11_PRIMITIVE_TOPOLOGY>(topology));
+}
+
+void D3D11ContextSink::SetVertexBuffer(uint32_t slot,
+                                       void* buffer,
+                                       uint32_t stride,
+                                       uint32_t offset) {
+    ID3D11Buffer* vertexBuffer = static_cast<ID3D11Buffer*>(buffer);
+    UINT strides[1]            = {stride};
+    UINT offsets[1]            = {offset};
+    context->IASetVertexBuffers(slot, 1, &vertexBuffer, strides, offsets);
+}
+
+void D3D11ContextSink::SetIndexBuffer(void* buffer, uint32_t format, uint32_t offset) {
+    context->IASetIndexBuffer(static_cast<ID3D11Buffer*>(buffer),
+                              static_cast<DXGI_FORMAT>(format),
+                              offset);
+}
+
+void D3D11ContextSink::SetVertexShader(void* shader) {
+    context->VSSetShader(static_cast<ID3D11VertexShader*>(shader), nullptr, 0);
+}
+
+void D3D11ContextSink::SetPixelShader(void* shader) {
+    context->PSSetShader(static_cast<ID3D11PixelShader*>(shader), nullptr, 0);
+}
+
+void D3D11ContextSink::SetPixelShaderResource(uint32_t slot, void* resource) {
+    ID3D11ShaderResourceView* view = static_cast<ID3D11ShaderResourceView*>(resource);
+    context->PSSetShaderResources(slot, 1, &view);
+}
+
+void D3D11ContextSink::SetPixelSampler(uint32_t slot, void* sampler) {
+    ID3D11SamplerState* state = static_cast<ID3D11SamplerState*>(sampler);
+    context->PSSetSamplers(slot, 1, &state);
+}
+
+void D3D11ContextSink::SetVertexConstantBuffer(uint32_t slot,
+                                               void* buffer,
+                                               uint32_t firstConstant,
+                                               uint32_t constantCount) {
+    // ConstantBufferPool refuses to start without the 11.1 interface, so this never has to
+    // fall back to binding whole buffers
+    ID3D11Buffer* constantBuffer = static_cast<ID3D11Buffer*>(buffer);
+    UINT firstConstants[1]       = {firstConstant};
+    UINT constantCounts[1]       = {constantCount};
+    if (context1) {
+        context1->VSSetConstantBuffers1(slot, 1, &constantBuffer, firstConstants, constantCounts);
+    }
+}
+
+void D3D11ContextSink::SetRasterizerState(void* state) {
+    context->RSSetState(static_cast<ID3D11RasterizerState*>(state));
+}
+
+void D3D11ContextSink::SetViewport(float x, float y, float width, float height) {
+    D3D11_VIEWPORT viewport = {};
+    viewport.TopLeftX       = x;
+    viewport.TopLeftY       = y;
+    viewport.Width          = width;
+    viewport.Height         = height;
+    viewport.MinDepth       = 0.0f;
+    viewport.MaxDepth       = 1.0f;
+    context->RSSetViewports(1, &viewport);
+}
+
+void D3D11ContextSink::SetDepthStencilState(void* state, uint32_t stencilRef) {
+    context->OMSetDepthStencilState(static_cast<ID3D11DepthStencilState*>(state), stencilRef);
+}
+
+void D3D11ContextSink::SetBlendState(void* state, const float blendFactor[4], uint32_t mask) {
+    context->OMSetBlendState(static_cast<ID3D11BlendState*>(state), blendFactor, mask);
+}
+
+void D3D11ContextSink::SetRenderTarget(void* renderTarget, void* depthStencil) {
+    ID3D11RenderTargetView* view = static_cast<ID3D11RenderTargetView*>(renderTarget);
+    context->OMSetRenderTargets(view ? 1 : 0,
+                                view ? &view : nullptr,
+                                static_cast<ID3D11DepthStencilView*>(depthStencil));
+}
+
+void D3D11ContextSink::Draw(uint32_t vertexCount, uint32_t startVertex) {
+    context->Draw(vertexCount, startVertex);
+}
+
+void D3D11ContextSink::DrawInstanced(uint32_t vertexCount,
+                                     uint32_t instanceCount,
+                                     uint32_t startVertex,
+                                     uint32_t startInstance) {
+    context->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+}
+
+void D3D11ContextSink::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) {
+    context->DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+void D3D11ContextSink::DrawIndexedInstanced(uint32_t indexCount,
+                                            uint32_t instanceCount,
+                                            uint32_t startIndex,
+                                            int32_t baseVertex,
+                                            uint32_t startInstance) {
+    context->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "render/StateCache.h"
+#include "utils/stdafx.h"
+#include <d3d11_1.h>
+#include <wrl/client.h>
+
+// D3D11 Context Sink Class
+// Forwards StateCache calls to an ID3D11DeviceContext (immediate or deferred)
+// Constant buffer windows need the Direct3D 11.1 interface of the same context
+class D3D11ContextSink : public ContextSink {
+  public:
+    explicit D3D11ContextSink(ID3D11DeviceContext* deviceContext = nullptr) {
+        SetContext(deviceContext);
+    }
+
+    void SetContext(ID3D11DeviceContext* deviceContext);
+    ID3D11DeviceContext* GetContext() const {
+        return context;
+    }
+
+    void SetInputLayout(void* layout) override;
+    void SetPrimitiveTopology(uint32_t topology) override;
+    void SetVertexBuffer(uint32_t slot, void* buffer, uint32_t stride, uint32_t offset) override;
+    void SetIndexBuffer(void* buffer, uint32_t format, uint32_t offset) override;
+    void SetVertexShader(void* shader) override;
+    void SetPixelShader(void* shader) override;
+    void SetPixelShaderResource(uint32_t slot, void* resource) override;
+    void SetPixelSampler(uint32_t slot, void* sampler) override;
+    void SetVertexConstantBuffer(uint32_t slot,
+                                 void* buffer,
+                                 uint32_t firstConstant,
+                                 uint32_t constantCount) override;
+    void SetRasterizerState(void* state) override;
+    void SetViewport(float x, float y, float width, float height) override;
+    void SetDepthStencilState(void* state, uint32_t stencilRef) override;
+    void SetBlendState(void* state, const float blendFactor[4], uint32_t mask) override;
+    void SetRenderTarget(void* renderTarget, void* depthStencil) override;
+
+    void Draw(uint32_t vertexCount, uint32_t startVertex) override;
+    void DrawInstanced(uint32_t vertexCount,
+                       uint32_t instanceCount,
+                       uint32_t startVertex,
+                       uint32_t startInstance) override;
+    void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+    void DrawIndexedInstanced(uint32_t indexCount,
+                              uint32_t instanceCount,
+                              uint32_t startIndex,
+                              int32_t baseVertex,
+                              uint32_t startInstance) override;
+
+  private:
+    ID3D11DeviceContext* context = nullptr;
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext1> context1; // nullptr before Windows 8
+};
@@ -0,0 +1,221 @@
+#include "D3D11StateFactory.h"
+#include "utils/Logger.h"
+#include <cstring>
+
+// ========================================
+// 1. OBJECT CREATION
+// ========================================
+
+size_t D3D11StateFactory::GetDescSize(PipelineCache::StateKind kind) const {
+    switch (kind) {
+    case PipelineCache::Blend:
+        return sizeof(D3D11_BLEND_DESC);
+    case PipelineCache::Rasterizer:
+        return sizeof(D3D11_RASTERIZER_DESC);
+    case PipelineCache::DepthStencil:
+        return sizeof(D3D11_DEPTH_STENCIL_DESC);
+    case PipelineCache::Sampler:
+        return sizeof(D3D11_SAMPLER_DESC);
+    default:
+        return 0;
+    }
+}
+
+void* D3D11StateFactory::Create(PipelineCache::StateKind kind, const void* desc) {
+    // Creation is thread-safe on the device; the returned reference is the cache's to release
+    HRESULT hr = E_INVALIDARG;
+    switch (kind) {
+    case PipelineCache::Blend: {
+        ID3D11BlendState* state = nullptr;
+        hr = device->CreateBlendState(static_cast<const D3D11_BLEND_DESC*>(desc), &state);
+        if (SUCCEEDED(hr)) {
+            return state;
+        }
+        break;
+    }
+    case PipelineCache::Rasterizer: {
+        ID3D11RasterizerState* state = nullptr;
+        hr = device->CreateRasterizerState(static_cast<const D3D11_RASTERIZER_DESC*>(desc),
+                                           &state);
+        if (SUCCEEDED(hr)) {
+            return state;
+        }
+        break;
+    }
+    case PipelineCache::DepthStencil: {
+        ID3D11DepthStencilState* state = nullptr;
+        hr = device->CreateDepthStencilState(static_cast<const D3D11_DEPTH_STENCIL_DESC*>(desc),
+                                             &state);
+        if (SUCCEEDED(hr)) {
+            return state;
+        }
+        break;
+    }
+    case PipelineCache::Sampler: {
+        ID3D11SamplerState* state = nullptr;
+        hr = device->CreateSamplerState(static_cast<const D3D11_SAMPLER_DESC*>(desc), &state);
+        if (SUCCEEDED(hr)) {
+            return state;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    LOG_ERROR("Failed to create pipeline state (kind %u)! HRESULT: 0x%08X",
+              static_cast<unsigned>(kind),
+              static_cast<unsigned>(hr));
+    return nullptr;
+}
+
+void D3D11StateFactory::Release(PipelineCache::StateKind kind, void* object) {
+    (void)kind;
+    if (object) {
+        static_cast<IUnknown*>(static_cast<ID3D11DeviceChild*>(object))->Release();
+    }
+}
+
+// ========================================
+// 2. NORMALIZED LOOKUPS
+// ========================================
+
+uint16_t D3D11StateFactory::AcquireBlend(PipelineCache& cache, const D3D11_BLEND_DESC& desc) {
+    D3D11_BLEND_DESC normalized;
+    std::memset(&normalized, 0, sizeof(normalized));
+    normalized.AlphaToCoverageEnable  = desc.AlphaToCoverageEnable;
+    normalized.IndependentBlendEnable = desc.IndependentBlendEnable;
+
+    const UINT targetCount = desc.IndependentBlendEnable ? 8 : 1;
+    for (UINT i = 0; i < targetCount; ++i) {
+        const D3D11_RENDER_TARGET_BLEND_DESC& source = desc.RenderTarget[i];
+        D3D11_RENDER_TARGET_BLEND_DESC& target       = normalized.RenderTarget[i];
+        target.BlendEnable                           = source.BlendEnable;
+        target.SrcBlend                              = source.SrcBlend;
+        target.DestBlend                             = source.DestBlend;
+        target.BlendOp                               = source.BlendOp;
+        target.SrcBlendAlpha                         = source.SrcBlendAlpha;
+        target.DestBlendAlpha                        = source.DestBlendAlpha;
+        target.BlendOpAlpha                          = source.BlendOpAlpha;
+        target.RenderTargetWriteMask                 = source.RenderTargetWriteMask;
+    }
+    return cache.AcquireState(PipelineCache::Blend, &normalized);
+}
+
+uint16_t D3D11StateFactory::AcquireRasterizer(PipelineCache& cache,
+                                              const D3D11_RASTERIZER_DESC& desc) {
+    // Ten 4-byte fields: no padding to clear
+    return cache.AcquireState(PipelineCache::Rasterizer, &desc);
+}
+
+uint16_t D3D11StateFactory::AcquireDepthStencil(PipelineCache& cache,
+                                                const D3D11_DEPTH_STENCIL_DESC& desc) {
+    D3D11_DEPTH_STENCIL_DESC normalized;
+    std::memset(&normalized, 0, sizeof(normalized));
+    normalized.DepthEnable      = desc.DepthEnable;
+    normalized.DepthWriteMask   = desc.DepthWriteMask;
+    normalized.DepthFunc        = desc.DepthFunc;
+    normalized.StencilEnable    = desc.StencilEnable;
+    normalized.StencilReadMask  = desc.StencilReadMask;
+    normalized.StencilWriteMask = desc.StencilWriteMask;
+    normalized.FrontFace        = desc.FrontFace;
+    normalized.BackFace         = desc.BackFace;
+    return cache.AcquireState(PipelineCache::DepthStencil, &normalized);
+}
+
+uint16_t D3D11StateFactory::AcquireSampler(PipelineCache& cache, const D3D11_SAMPLER_DESC& desc) {
+    // All 4-byte fields: no padding to clear
+    return cache.AcquireState(PipelineCache::Sampler, &desc);
+}
+
+// ========================================
+// 3. PREWARMING
+// ========================================
+
+void D3D11StateFactory::Prewarm(PipelineCache& cache) {
+    // Blend: SpriteRenderer's conventions (alpha always composites source-over); opaque is
+    // the alpha state with blending disabled
+    struct BlendMode {
+        BOOL enable;
+        D3D11_BLEND source;
+        D3D11_BLEND destination;
+    };
+    const BlendMode blendModes[] = {
+        {FALSE, D3D11_BLEND_SRC_ALPHA, D3D11_BLEND_INV_SRC_ALPHA}, // Opaque
+        {TRUE, D3D11_BLEND_SRC_ALPHA, D3D11_BLEND_INV_SRC_ALPHA},  // Alpha
+        {TRUE, D3D11_BLEND_SRC_ALPHA, D3D11_BLEND_ONE},            // Additive
+        {TRUE, D3D11_BLEND_ONE, D3D11_BLEND_INV_SRC_ALPHA},        // Premultiplied alpha
+    };
+    for (const BlendMode& mode : blendModes) {
+        D3D11_BLEND_DESC blendDesc             = {};
+        D3D11_RENDER_TARGET_BLEND_DESC& target = blendDesc.RenderTarget[0];
+        target.BlendEnable                     = mode.enable;
+        target.SrcBlend                        = mode.source;
+        target.DestBlend                       = mode.destination;
+        target.BlendOp                         = D3D11_BLEND_OP_ADD;
+        target.SrcBlendAlpha                   = D3D11_BLEND_ONE;
+        target.DestBlendAlpha                  = D3D11_BLEND_INV_SRC_ALPHA;
+        target.BlendOpAlpha                    = D3D11_BLEND_OP_ADD;
+        target.RenderTargetWriteMask           = D3D11_COLOR_WRITE_ENABLE_ALL;
+        AcquireBlend(cache, blendDesc);
+    }
+
+    // Rasterizer: solid with back, front or no culling, and wireframe without culling
+    const D3D11_FILL_MODE fills[] = {
+        D3D11_FILL_SOLID, D3D11_FILL_SOLID, D3D11_FILL_SOLID, D3D11_FILL_WIREFRAME};
+    const D3D11_CULL_MODE culls[] = {
+        D3D11_CULL_BACK, D3D11_CULL_FRONT, D3D11_CULL_NONE, D3D11_CULL_NONE};
+    for (uint32_t i = 0; i < 4; ++i) {
+        D3D11_RASTERIZER_DESC rasterizerDesc = {};
+        rasterizerDesc.FillMode              = fills[i];
+        rasterizerDesc.CullMode              = culls[i];
+        rasterizerDesc.DepthClipEnable       = TRUE;
+        AcquireRasterizer(cache, rasterizerDesc);
+    }
+
+    // Depth: off, test and write, test only (transparent geometry), and equal (after a
+    // depth prepass); stencil stays at the API defaults
+    struct DepthMode {
+        BOOL enable;
+        D3D11_DEPTH_WRITE_MASK write;
+        D3D11_COMPARISON_FUNC func;
+    };
+    const DepthMode depthModes[] = {
+        {FALSE, D3D11_DEPTH_WRITE_MASK_ZERO, D3D11_COMPARISON_ALWAYS},
+        {TRUE, D3D11_DEPTH_WRITE_MASK_ALL, D3D11_COMPARISON_LESS_EQUAL},
+        {TRUE, D3D11_DEPTH_WRITE_MASK_ZERO, D3D11_COMPARISON_LESS_EQUAL},
+        {TRUE, D3D11_DEPTH_WRITE_MASK_ZERO, D3D11_COMPARISON_EQUAL},
+    };
+    const D3D11_DEPTH_STENCILOP_DESC keep = {D3D11_STENCIL_OP_KEEP,
+                                             D3D11_STENCIL_OP_KEEP,
+                                             D3D11_STENCIL_OP_KEEP,
+                                             D3D11_COMPARISON_ALWAYS};
+    for (const DepthMode& mode : depthModes) {
+        D3D11_DEPTH_STENCIL_DESC depthDesc = {};
+        depthDesc.DepthEnable              = mode.enable;
+        depthDesc.DepthWriteMask           = mode.write;
+        depthDesc.DepthFunc                = mode.func;
+        depthDesc.StencilReadMask          = D3D11_DEFAULT_STENCIL_READ_MASK;
+        depthDesc.StencilWriteMask         = D3D11_DEFAULT_STENCIL_WRITE_MASK;
+        depthDesc.FrontFace                = keep;
+        depthDesc.BackFace                 = keep;
+        AcquireDepthStencil(cache, depthDesc);
+    }
+
+    // Samplers: linear and point clamp (sprites, post-processing), and TextureCache's
+    // trilinear anisotropic wrap
+    const D3D11_FILTER filters[] = {
+        D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_FILTER_ANISOTROPIC};
+    const D3D11_TEXTURE_ADDRESS_MODE addresses[] = {
+        D3D11_TEXTURE_ADDRESS_CLAMP, D3D11_TEXTURE_ADDRESS_CLAMP, D3D11_TEXTURE_ADDRESS_WRAP};
+    for (uint32_t i = 0; i < 3; ++i) {
+        D3D11_SAMPLER_DESC samplerDesc = {};
+        samplerDesc.Filter             = filters[i];
+        samplerDesc.AddressU           = addresses[i];
+        samplerDesc.AddressV           = addresses[i];
+        samplerDesc.AddressW           = addresses[i];
+        samplerDesc.MaxAnisotropy      = filters[i] == D3D11_FILTER_ANISOTROPIC ? 8 : 0;
+        samplerDesc.ComparisonFunc     = D3D11_COMPARISON_NEVER;
+        samplerDesc.MaxLOD             = D3D11_FLOAT32_MAX;
+        AcquireSampler(cache, samplerDesc);
+    }
+}
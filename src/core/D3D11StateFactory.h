@@ -0,0 +1,39 @@
+#pragma once
+#include "render/PipelineCache.h"
+#include "utils/stdafx.h"
+
+// D3D11 State Factory Class
+// Creates the Direct3D 11 blend, rasterizer, depth-stencil and sampler states behind
+// PipelineCache handles. The Acquire helpers copy a descriptor field by field into a zeroed
+// one before looking it up: D3D11_BLEND_DESC and D3D11_DEPTH_STENCIL_DESC have padding, and
+// render targets 1-7 of a blend desc are ignored unless IndependentBlendEnable is set, so
+// descriptors of the same state always hash the same.
+class D3D11StateFactory : public PipelineCache::StateFactory {
+  public:
+    explicit D3D11StateFactory(ID3D11Device* device = nullptr) : device(device) {}
+
+    // Must be set before the first state is created
+    void SetDevice(ID3D11Device* newDevice) {
+        device = newDevice;
+    }
+
+    // PipelineCache::StateFactory interface
+    size_t GetDescSize(PipelineCache::StateKind kind) const override;
+    void* Create(PipelineCache::StateKind kind, const void* desc) override;
+    void Release(PipelineCache::StateKind kind, void* object) override;
+
+    // Handles of normalized descriptors (PipelineCache::DefaultState on failure)
+    static uint16_t AcquireBlend(PipelineCache& cache, const D3D11_BLEND_DESC& desc);
+    static uint16_t AcquireRasterizer(PipelineCache& cache, const D3D11_RASTERIZER_DESC& desc);
+    static uint16_t AcquireDepthStencil(PipelineCache& cache,
+                                        const D3D11_DEPTH_STENCIL_DESC& desc);
+    static uint16_t AcquireSampler(PipelineCache& cache, const D3D11_SAMPLER_DESC& desc);
+
+    // Create the states the renderers commonly use: opaque, alpha, additive and
+    // premultiplied blending; back, front and no culling, and wireframe; depth off, test
+    // and write, test only, and equal; linear and point clamp, and anisotropic wrap sampling
+    static void Prewarm(PipelineCache& cache);
+
+  private:
+    ID3D11Device* device = nullptr;
+};
@@ -0,0 +1,137 @@
+#include "GpuProfiler.h"
+#include "utils/Logger.h"
+
+bool GpuProfiler::Initialize(ID3D11Device* device) {
+    D3D11_QUERY_DESC disjointDesc = {};
+    disjointDesc.Query            = D3D11_QUERY_TIMESTAMP_DISJOINT;
+
+    D3D11_QUERY_DESC timestampDesc = {};
+    timestampDesc.Query            = D3D11_QUERY_TIMESTAMP;
+
+    for (Frame& frame : frames) {
+        HRESULT hr = device->CreateQuery(&disjointDesc, frame.disjoint.GetAddressOf());
+        if (SUCCEEDED(hr)) {
+            hr = device->CreateQuery(&timestampDesc, frame.begin.GetAddressOf());
+        }
+        if (SUCCEEDED(hr)) {
+            hr = device->CreateQuery(&timestampDesc, frame.end.GetAddressOf());
+        }
+        for (Scope& scope : frame.scopes) {
+            if (SUCCEEDED(hr)) {
+                hr = device->CreateQuery(&timestampDesc, scope.begin.GetAddressOf());
+            }
+            if (SUCCEEDED(hr)) {
+                hr = device->CreateQuery(&timestampDesc, scope.end.GetAddressOf());
+            }
+        }
+        if (FAILED(hr)) {
+            LOG_ERROR("Failed to create GPU timer queries! HRESULT: 0x%08X",
+                      static_cast<unsigned>(hr));
+            return false;
+        }
+    }
+    initialized = true;
+    return true;
+}
+
+void GpuProfiler::BeginFrame(ID3D11DeviceContext* context) {
+    if (!initialized) {
+        return;
+    }
+
+    // The slot was last used FrameLatency frames ago; its results should be ready by now
+    Frame& frame = frames[frameIndex % FrameLatency];
+    if (frame.pending) {
+        Collect(context, frame);
+    }
+
+    frame.scopeCount = 0;
+    frame.cpuBegin   = Profiler::Now();
+    frame.pending    = false;
+    depth            = 0;
+    inFrame          = true;
+
+    context->Begin(frame.disjoint.Get());
+    context->End(frame.begin.Get());
+}
+
+void GpuProfiler::EndFrame(ID3D11DeviceContext* context) {
+    if (!inFrame) {
+        return;
+    }
+
+    Frame& frame = frames[frameIndex % FrameLatency];
+    context->End(frame.end.Get());
+    context->End(frame.disjoint.Get());
+    frame.pending = true;
+    inFrame       = false;
+    ++frameIndex;
+}
+
+uint32_t GpuProfiler::BeginScope(ID3D11DeviceContext* context, const char* name) {
+    Frame& frame = frames[frameIndex % FrameLatency];
+    if (!inFrame || frame.scopeCount >= MaxScopes) {
+        return ~0u;
+    }
+
+    uint32_t index = frame.scopeCount++;
+    Scope& scope   = frame.scopes[index];
+    scope.name     = name;
+    scope.depth    = depth++;
+    context->End(scope.begin.Get());
+    return index;
+}
+
+void GpuProfiler::EndScope(ID3D11DeviceContext* context, uint32_t scope) {
+    if (!inFrame || scope == ~0u) {
+        return;
+    }
+    context->End(frames[frameIndex % FrameLatency].scopes[scope].end.Get());
+    --depth;
+}
+
+void GpuProfiler::Collect(ID3D11DeviceContext* context, Frame& frame) {
+    // DONOTFLUSH: never force a flush from the readback path; late results are dropped
+    const UINT flags = D3D11_ASYNC_GETDATA_DONOTFLUSH;
+
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint = {};
+    if (context->GetData(frame.disjoint.Get(), &disjoint, sizeof(disjoint), flags) != S_OK) {
+        ++droppedFrames;
+        return;
+    }
+    // Disjoint: the clock changed frequency mid-frame (power state change), values are garbage
+    if (disjoint.Disjoint || disjoint.Frequency == 0) {
+        return;
+    }
+
+    UINT64 frameBegin = 0;
+    UINT64 frameEnd   = 0;
+    if (context->GetData(frame.begin.Get(), &frameBegin, sizeof(UINT64), flags) != S_OK ||
+        context->GetData(frame.end.Get(), &frameEnd, sizeof(UINT64), flags) != S_OK) {
+        ++droppedFrames;
+        return;
+    }
+
+    // Ticks relative to the frame's first timestamp, placed at the CPU time of BeginFrame
+    const double toNanoseconds = 1.0e9 / static_cast<double>(disjoint.Frequency);
+
+    Profiler& profiler = Profiler::Get();
+
+    auto toCpuTime = [&](UINT64 ticks) {
+        return frame.cpuBegin + profiler.FromNanoseconds((ticks - frameBegin) * toNanoseconds);
+    };
+
+    profiler.AddGpuFrame(static_cast<float>((frameEnd - frameBegin) * toNanoseconds / 1.0e6));
+    profiler.RecordGpu("GPU Frame", frame.cpuBegin, toCpuTime(frameEnd), 0);
+
+    for (uint32_t i = 0; i < frame.scopeCount; ++i) {
+        const Scope& scope = frame.scopes[i];
+        UINT64 begin       = 0;
+        UINT64 end         = 0;
+        if (context->GetData(scope.begin.Get(), &begin, sizeof(UINT64), flags) != S_OK ||
+            context->GetData(scope.end.Get(), &end, sizeof(UINT64), flags) != S_OK) {
+            continue;
+        }
+        profiler.RecordGpu(scope.name, toCpuTime(begin), toCpuTime(end), scope.depth + 1);
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "utils/Profiler.h"
+#include "utils/stdafx.h"
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+// GPU Profiler Class
+// Brackets each frame with a TIMESTAMP_DISJOINT query and each scope with a pair of
+// TIMESTAMP queries. Results are read back FrameLatency frames later without flushing, so
+// timing never stalls the pipeline; resolved scopes are handed to Profiler as GPU events
+// aligned to the CPU time at which their frame began.
+class GpuProfiler {
+  public:
+    static constexpr uint32_t FrameLatency = 4;  // Frames between issue and readback
+    static constexpr uint32_t MaxScopes    = 32; // Timed scopes per frame
+
+    GpuProfiler() = default;
+
+    // Create the query objects for every frame slot
+    bool Initialize(ID3D11Device* device);
+
+    // Open the frame; reads back the slot's previous contents first
+    void BeginFrame(ID3D11DeviceContext* context);
+
+    // Close the frame (call after the last draw, before Present)
+    void EndFrame(ID3D11DeviceContext* context);
+
+    /*
+    Start a timed scope; returns its index for EndScope
+    name: String literal; returns ~0u when the frame has no free scope
+    */
+    uint32_t BeginScope(ID3D11DeviceContext* context, const char* name);
+    void EndScope(ID3D11DeviceContext* context, uint32_t scope);
+
+    // Frames whose queries were still not ready at readback time
+    uint64_t GetDroppedFrames() const {
+        return droppedFrames;
+    }
+
+  private:
+    struct Scope {
+        const char* name = nullptr;
+        ComPtr<ID3D11Query> begin;
+        ComPtr<ID3D11Query> end;
+        uint32_t depth = 0;
+    };
+
+    struct Frame {
+        ComPtr<ID3D11Query> disjoint;
+        ComPtr<ID3D11Query> begin;
+        ComPtr<ID3D11Query> end;
+        Scope scopes[MaxScopes];
+        uint32_t scopeCount = 0;
+        uint64_t cpuBegin   = 0; // Profiler::Now() at BeginFrame
+        bool pending        = false;
+    };
+
+    Frame frames[FrameLatency];
+    uint64_t frameIndex    = 0;
+    uint32_t depth         = 0;
+    uint64_t droppedFrames = 0;
+    bool initialized       = false;
+    bool inFrame           = false;
+
+    void Collect(ID3D11DeviceContext* context, Frame& frame);
+};
+
+// GPU Scope Class
+// RAII wrapper around BeginScope/EndScope
+class GpuScope {
+  public:
+    GpuScope(GpuProfiler& gpuProfiler, ID3D11DeviceContext* deviceContext, const char* name)
+        : profiler(gpuProfiler), context(deviceContext) {
+        scope = profiler.BeginScope(context, name);
+    }
+    ~GpuScope() {
+        profiler.EndScope(context, scope);
+    }
+
+    GpuScope(const GpuScope&)            = delete;
+    GpuScope& operator=(const GpuScope&) = delete;
+
+  private:
+    GpuProfiler& profiler;
+    ID3D11DeviceContext* context;
+    uint32_t scope;
+};
+
+#if PROFILING_ENABLED
+#define GPU_PROFILE_SCOPE(profiler, context, name) \
+    GpuScope PROFILE_CONCAT(gpuScope, __LINE__)(profiler, context, name)
+#else
+#define GPU_PROFILE_SCOPE(profiler, context, name) ((void)0)
+#endif
@@ -1,69 +1,138 @@
 #include "Graphics.h"
+#include "utils/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
-Graphics::Graphics() {
+Graphics::Graphics()
+    : frameCapture(contextSink), stateCache(frameCapture), pipelineCache(stateFactory) {
     // ComPtr automatically initializes to nullptr, but explicit initialization for clarity
     device           = nullptr;
     deviceContext    = nullptr;
-    swapChain        = nullptr;
     renderTargetView = nullptr;
     vertexShader     = nullptr;
     pixelShader      = nullptr;
     inputLayout      = nullptr;
+    triangleBuffer   = nullptr;
+
+    // Draw packets are sorted and replayed through the dispatcher every frame
+    queueDispatcher.graphics = this;
+    queueDispatcher.state    = &stateCache;
+    renderQueue.Reserve(4096);
+    renderQueue.SetMemoryResource(frameArena.GetResource(MemoryTag::RenderQueue));
+
+    // Sort passes, instance packing for large batches, sprite vertex writing and batches of
+    // per-object constants are split into tasks on the job system
+    // (runs serially until Initialize starts the workers)
+    const ParallelFor executor = jobSystem.GetTaskExecutor();
+    renderQueue.SetParallelFor(executor);
+    instanceWriter.SetParallelFor(executor);
+    spriteBatch.SetParallelFor(executor);
+    matrixBatch.SetParallelFor(executor);
+
+    // Captured frames also record what is written into the dynamic buffers
+    uploadBuffer.SetCapture(&frameCapture);
+    instanceBuffer.SetCapture(&frameCapture);
+    constantPool.SetCapture(&frameCapture);
 }
 
-Graphics::~Graphics() {}
+Graphics::~Graphics() {
+    // Peak per-frame scratch, for sizing the arena chunks up front
+    FrameArena::Stats stats = frameArena.GetStats();
+    LOG_INFO("Frame arena high-water: %llu bytes (%llu reserved)",
+             static_cast<unsigned long long>(stats.highWater),
+             static_cast<unsigned long long>(stats.bytesReserved));
+    for (uint32_t tag = 0; tag < MemoryTagCount; ++tag) {
+        if (stats.tagHighWater[tag] > 0) {
+            LOG_INFO("  %-12s %llu bytes",
+                     MemoryTagName(static_cast<MemoryTag>(tag)),
+                     static_cast<unsigned long long>(stats.tagHighWater[tag]));
+        }
+    }
+
+    // Frame pacing over the whole run
+    FramePacer::Stats pacing = framePacer.GetStats();
+    if (pacing.frames > 0) {
+        LOG_INFO("Frame pacing: %u frames, %.2f ms (dev %.2f, max %.2f), input to present "
+                 "%.2f ms (max %.2f), sleep %.2f ms, spin %.2f ms per frame, %u missed",
+                 pacing.frames,
+                 pacing.frameMs,
+                 pacing.frameDevMs,
+                 pacing.maxFrameMs,
+                 pacing.latencyMs,
+                 pacing.maxLatencyMs,
+                 pacing.sleepMs,
+                 pacing.spinMs,
+                 pacing.missed);
+    }
+
+    // Texture streaming over the whole run
+    TextureResidency::Stats streaming = textureStreamer.GetStats();
+    if (streaming.requests > 0) {
+        LOG_INFO("Texture streaming: %.1f%% hits, %llu loads (%.1f MB), %llu levels evicted, "
+                 "%.1f MB resident",
+                 100.0 * static_cast<double>(streaming.hits) /
+                     static_cast<double>(streaming.requests),
+                 static_cast<unsigned long long>(streaming.loads),
+                 static_cast<double>(streaming.bytesLoaded) / (1024.0 * 1024.0),
+                 static_cast<unsigned long long>(streaming.evictions),
+                 static_cast<double>(streaming.residentBytes) / (1024.0 * 1024.0));
+    }
+}
+
+bool Graphics::Initialize(const BackendDesc& desc) {
+    return Initialize(static_cast<HWND>(desc.windowHandle), desc.width, desc.height);
+}
 
 bool Graphics::Initialize(HWND hwnd, int width, int height) {
-    std::cout << "Starting Graphics::Initialize..." << std::endl;
-    // ========================================
-    // 1. SWAP CHAIN CONFIGURATION
-    // ========================================
-    // Configure swap chain settings - this controls how frames are presented to screen
-    DXGI_SWAP_CHAIN_DESC swapChainDesc = {};
-    swapChainDesc.BufferCount          = 1;      // Single back buffer (double buffering)
-    swapChainDesc.BufferDesc.Width     = width;  // Render target width
-    swapChainDesc.BufferDesc.Height    = height; // Render target height
-    swapChainDesc.BufferDesc.Format =
-        DXGI_FORMAT_R8G8B8A8_UNORM; // 32-bit RGBA format (8 bits per channel)
-    swapChainDesc.BufferUsage =
-        DXGI_USAGE_RENDER_TARGET_OUTPUT;   // Buffer will be used as render target
-    swapChainDesc.OutputWindow     = hwnd; // Target window handle
-    swapChainDesc.SampleDesc.Count = 1;    // No multisampling (anti-aliasing)
-    swapChainDesc.Windowed         = TRUE; // Windowed mode (not fullscreen)
+    LOG_INFO("Starting Graphics::Initialize...");
+    this->width  = width;
+    this->height = height;
 
     // ========================================
-    // 2. CREATE DIRECTX DEVICE AND SWAP CHAIN
+    // 1. CREATE DIRECTX DEVICE
     // ========================================
-    // This is the core DirectX initialization - creates the main rendering device and swap chain
+    // This is the core DirectX initialization - creates the main rendering device
+    // The swap chain is created separately (step 2) so it can use the flip model
     D3D_FEATURE_LEVEL featureLevel;
-    HRESULT hr = D3D11CreateDeviceAndSwapChain(
-        nullptr,                     // Default adapter (GPU)
-        D3D_DRIVER_TYPE_HARDWARE,    // Hardware acceleration
-        nullptr,                     // No software rasterizer
-        0,                           // Flags (debug etc.)
-        nullptr,                     // Feature level array
-        0,                           // Array size
-        D3D11_SDK_VERSION,           // SDK version
-        &swapChainDesc,              // Swap chain settings
-        swapChain.GetAddressOf(),    // [Output] Swap chain - ComPtr output
-        device.GetAddressOf(),       // [Output] Device - ComPtr output
-        &featureLevel,               // [Output] Feature level
-        deviceContext.GetAddressOf() // [Output] Context - ComPtr output
+    HRESULT hr = D3D11CreateDevice(nullptr,                     // Default adapter (GPU)
+                                   D3D_DRIVER_TYPE_HARDWARE,    // Hardware acceleration
+                                   nullptr,                     // No software rasterizer
+                                   0,                           // Flags (debug etc.)
+                                   nullptr,                     // Feature level array
+                                   0,                           // Array size
+                                   D3D11_SDK_VERSION,           // SDK version
+                                   device.GetAddressOf(),       // [Output] Device
+                                   &featureLevel,               // [Output] Feature level
+                                   deviceContext.GetAddressOf() // [Output] Context
     );
 
     // Check if DirectX initialization succeeded
     if (FAILED(hr)) {
-        std::cout << "ERROR: D3D11CreateDeviceAndSwapChain failed! HRESULT: 0x" << std::hex << hr
-                  << std::endl;
-        MessageBox(hwnd, L"Failed to create Device/SwapChain", L"Error", MB_OK);
+        LOG_ERROR("D3D11CreateDevice failed! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+        MessageBox(hwnd, L"Failed to create Device", L"Error", MB_OK);
+        return false;
+    }
+    LOG_INFO("DirectX device created");
+
+    // ========================================
+    // 2. CREATE FLIP-MODEL SWAP CHAIN
+    // ========================================
+    // Flip model (FLIP_DISCARD) with presentDesc.bufferCount back buffers: the compositor
+    // reads our buffers directly instead of copying them, and a frame-latency waitable
+    // object lets WaitForNextFrame block before the frame starts rather than in Present
+    if (!swapChain.Initialize(device.Get(), hwnd, width, height, presentDesc)) {
+        MessageBox(hwnd, L"Failed to create SwapChain", L"Error", MB_OK);
         return false;
     }
-    std::cout << "SUCCESS: DirectX device and swap chain created!\n";
+
+    // Pipeline binds are filtered by the state cache before reaching the context
+    contextSink.SetContext(deviceContext.Get());
+    stateCache.Invalidate();
 
     // Debug: Check if device is really created properly
-    std::cout << "Device pointer: " << device.Get() << std::endl;
-    std::cout << "DeviceContext pointer: " << deviceContext.Get() << std::endl;
-    std::cout << "SwapChain pointer: " << swapChain.Get() << std::endl;
+    LOG_DEBUG("Device pointer: %p", static_cast<void*>(device.Get()));
+    LOG_DEBUG("DeviceContext pointer: %p", static_cast<void*>(deviceContext.Get()));
 
     // ========================================
     // 3. CREATE RENDER TARGET VIEW
@@ -72,16 +141,13 @@ bool Graphics::Initialize(HWND hwnd, int width, int height) {
     // This is where all rendering operations will draw to
     ComPtr<ID3D11Texture2D> backBuffer;
 
-    // GetBuffer() extracts the actual texture from swap chain for rendering
-    // Parameters breakdown:
-    // - 0: Buffer index (0 = primary back buffer, 1 = secondary for triple buffering)
-    // - __uuidof(ID3D11Texture2D): COM interface UUID to specify return type
-    //   This tells DirectX "I want this buffer as a 2D texture interface"
-    // - backBuffer.GetAddressOf(): ComPtr output parameter
-    //   ComPtr handles COM interface returns automatically
-    swapChain->GetBuffer(0,
-                         __uuidof(ID3D11Texture2D),
-                         reinterpret_cast<void**>(backBuffer.GetAddressOf()));
+    // Buffer 0 extracts the actual texture from swap chain for rendering
+    // With flip model the buffers rotate on every Present, but Direct3D 11 keeps buffer 0
+    // (and views of it) pointing at whichever buffer is currently being drawn, so one
+    // render target view serves every frame
+    if (!swapChain.GetBackBuffer(backBuffer.GetAddressOf())) {
+        return false;
+    }
 
     // Create a render target view from the back buffer texture
     // This "view" allows the graphics pipeline to render into the texture
@@ -99,7 +165,7 @@ bool Graphics::Initialize(HWND hwnd, int width, int height) {
     // OM = Output Merger stage (final stage of graphics pipeline)
     // renderTargetView.GetAddressOf() gets pointer to the ComPtr for array input
     deviceContext->OMSetRenderTargets(1, renderTargetView.GetAddressOf(), nullptr);
-    std::cout << "SUCCESS: Render target bound!\n";
+    LOG_INFO("Render target bound");
 
     // ========================================
     // 5. SETUP VIEWPORT
@@ -113,215 +179,295 @@ bool Graphics::Initialize(HWND hwnd, int width, int height) {
     deviceContext->RSSetViewports(1, &viewport); // RS = Rasterizer Stage
 
     // ========================================
-    // 6. LOAD AND COMPILE SHADERS
+    // 6. START JOB SYSTEM AND LOAD SHADERS
     // ========================================
-    // Load vertex and pixel shaders from compiled .cso files
-    std::cout << "Starting shader loading...\n";
+    // This thread becomes worker 0 of the job system; shader objects are created on its
+    // workers, so it has to run before LoadShaders
+    jobSystem.Initialize();
+    LOG_INFO("Job system started with %u threads", jobSystem.GetThreadCount());
+
+    LOG_INFO("Starting shader loading...");
     if (!LoadShaders()) {
-        std::cout << "ERROR: Shader loading failed!\n";
+        LOG_ERROR("Shader loading failed!");
+        return false;
+    }
+    LOG_INFO("Shaders loaded successfully");
+
+    // ========================================
+    // 7. CREATE GEOMETRY AND UPLOAD STORAGE
+    // ========================================
+    // Static geometry goes into IMMUTABLE buffers once; anything that changes per frame is
+    // written into the long-lived upload ring instead of a freshly created buffer
+    // Per-instance data has its own dynamic buffer, which grows when a frame overflows it
+    // Per-object constants share a few large constant buffers, bound a 256-byte window each
+    // Sprite vertices share the ring (80 bytes per sprite), hence its size
+    if (!CreateGeometry()) {
+        LOG_ERROR("Geometry creation failed!");
+        return false;
+    }
+    if (!uploadBuffer.Initialize(device.Get(), 16 * 1024 * 1024)) {
+        LOG_ERROR("Upload buffer creation failed!");
+        return false;
+    }
+    if (!instanceBuffer.Initialize(device.Get(), 65536)) {
+        LOG_ERROR("Instance buffer creation failed!");
+        return false;
+    }
+    if (!constantPool.Initialize(device.Get())) {
+        LOG_ERROR("Constant buffer pool initialization failed!");
+        return false;
+    }
+    if (!spriteRenderer.Initialize(device.Get())) {
+        LOG_ERROR("Sprite renderer creation failed!");
+        return false;
+    }
+    spriteBatch.SetViewport(static_cast<float>(width), static_cast<float>(height));
+    LOG_INFO("Geometry buffers created");
+
+    // Streamed textures start with nothing resident; loader threads fill them in
+    if (!textureCache.Initialize(device.Get(), deviceContext.Get()) ||
+        !textureStreamer.Start(textureSettings)) {
+        LOG_ERROR("Texture streaming initialization failed!");
+        return false;
+    }
+    LOG_INFO("Texture streaming started: %llu MB budget, %u loader threads",
+             static_cast<unsigned long long>(textureSettings.budgetBytes / (1024 * 1024)),
+             textureSettings.threadCount);
+
+    // Common fixed-function states are created now rather than on first use mid-frame;
+    // the basic pipeline then bundles the shaders with theirs
+    stateFactory.SetDevice(device.Get());
+    D3D11StateFactory::Prewarm(pipelineCache);
+    if (!CreatePipelines()) {
         return false;
     }
-    std::cout << "SUCCESS: Shaders loaded successfully!\n";
+    LOG_INFO("Pipeline states: %u blend, %u rasterizer, %u depth-stencil, %u sampler",
+             pipelineCache.GetStateCount(PipelineCache::Blend),
+             pipelineCache.GetStateCount(PipelineCache::Rasterizer),
+             pipelineCache.GetStateCount(PipelineCache::DepthStencil),
+             pipelineCache.GetStateCount(PipelineCache::Sampler));
+
+    // ========================================
+    // 8. DEFERRED CONTEXTS
+    // ========================================
+    // One deferred context per recorder lets large frames record their draw calls in parallel
+    if (!CreateRecorders()) {
+        LOG_WARNING("Deferred contexts unavailable, recording on one thread");
+    }
+
+    // ========================================
+    // 9. PROFILING
+    // ========================================
+    // GPU timestamps are read back a few frames late; press F12 to write a Chrome trace
+#if PROFILING_ENABLED
+    PROFILE_THREAD_NAME("Render");
+    if (!gpuProfiler.Initialize(device.Get())) {
+        LOG_WARNING("GPU profiling unavailable");
+    }
+#endif
 
     return true;
 }
 
+bool Graphics::CreateRecorders() {
+    // Drivers without native command lists still work: the runtime emulates them
+    D3D11_FEATURE_DATA_THREADING threading = {};
+    device->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading));
+    LOG_INFO("Driver command lists: %s", threading.DriverCommandLists ? "native" : "emulated");
+
+    uint32_t count = std::min(MaxRecorders, jobSystem.GetThreadCount());
+    recorders.clear();
+    for (uint32_t i = 0; i < count && count > 1; ++i) {
+        auto recorder = std::make_unique<CommandRecorder>();
+
+        HRESULT hr = device->CreateDeferredContext(0, recorder->context.GetAddressOf());
+        if (FAILED(hr)) {
+            LOG_ERROR("Failed to create deferred context! HRESULT: 0x%08X",
+                      static_cast<unsigned>(hr));
+            recorders.clear();
+            return false;
+        }
+        recorder->contextSink.SetContext(recorder->context.Get());
+        recorder->dispatcher.graphics = this;
+        recorder->dispatcher.state    = &recorder->stateCache;
+        recorders.push_back(std::move(recorder));
+    }
+    return true;
+}
+
+bool Graphics::CreateGeometry() {
+    // ========================================
+    // 1. VERTEX DATA DEFINITION AND LAYOUT
+    // ========================================
+    // Define the geometry we want to render - in this case, a colored triangle
+    // Each vertex contains both position (3D coordinates) and color (RGBA values)
+    // The vertex winding order is CLOCKWISE - this affects face culling and normals
+
+    // Source data uses the float Vertex struct shared with SoftwareRasterizer
+    // Coordinate system: DirectX uses left-handed coordinates
+    // X-axis: right (+) / left (-), Y-axis: up (+) / down (-), Z-axis: into screen (+) / out of
+    // screen (-)
+    const Vertex triangle[] = {
+        {{0.0f, 0.8f, 0.0f}, {1.0f, 0.0f, 0.0f, 1.0f}},   // Top vertex - RED color
+        {{0.8f, -0.8f, 0.0f}, {0.0f, 1.0f, 0.0f, 1.0f}},  // Bottom right vertex - GREEN color
+        {{-0.8f, -0.8f, 0.0f}, {0.0f, 0.0f, 1.0f, 1.0f}}, // Bottom left vertex - BLUE color
+    };
+
+    // The GPU copy is packed: SNORM16 position and RGBA8 color, 12 bytes instead of 28
+    // The input layout (generated from PackedVertex) expands them back to floats
+    PackedVertex packed[3];
+    VertexEncoder::EncodeVertices(triangle, 3, packed);
+
+    // ========================================
+    // 2. IMMUTABLE VERTEX BUFFER CREATION
+    // ========================================
+    // The triangle never changes, so it is uploaded exactly once at startup
+    // IMMUTABLE: GPU read-only, contents must be supplied at creation time
+    // This lets the driver place it in the fastest memory and skip all synchronization
+    D3D11_BUFFER_DESC bufferDesc = {};
+    // Total size: 3 vertices × 12 bytes = 36 bytes, used as vertex data
+    bufferDesc.Usage             = D3D11_USAGE_IMMUTABLE;
+    bufferDesc.ByteWidth         = sizeof(packed);
+    bufferDesc.BindFlags         = D3D11_BIND_VERTEX_BUFFER;
+
+    // Initialization data: Specify the initial content of the buffer
+    D3D11_SUBRESOURCE_DATA initData = {};
+    initData.pSysMem                = packed; // Pointer to our vertex data array
+
+    HRESULT hr = device->CreateBuffer(&bufferDesc, &initData, triangleBuffer.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create vertex buffer! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+        return false;
+    }
+    return true;
+}
+
 bool Graphics::LoadShaders() {
     // ========================================================================
-    // DIRECTX 11 SHADER LOADING AND COMPILATION PIPELINE
+    // DIRECTX 11 SHADER LOADING
     // ========================================================================
-    // This function demonstrates the complete process of loading compiled shaders
-    // and setting up the graphics pipeline for rendering operations.
+    // Compiled shader objects (.cso = pre-compiled HLSL bytecode) are packed at build time
+    // into one archive by tools/ShaderPacker. ShaderLibrary memory-maps it and creates every
+    // shader object in parallel; this function only looks up the ones it needs by name.
     //
     // KEY CONCEPTS COVERED:
-    // 1. Compiled Shader Objects (.cso files) - Pre-compiled HLSL bytecode
+    // 1. Shader Archive - One mapped file instead of one open/read per shader
     // 2. Vertex Shaders - Transform vertices from model to screen space
     // 3. Pixel Shaders - Calculate final pixel colors for rendering
     // 4. Input Layouts - Define vertex data structure and attributes
-    // 5. DirectX Resource Management - Creating and binding GPU resources
     // ========================================================================
 
     // ========================================
-    // 1. SHADER FILE DISCOVERY AND VALIDATION
+    // 1. SHADER ARCHIVE LOADING
     // ========================================
-    // Define the directory path where compiled shader files (.cso) are located
-    // .cso = Compiled Shader Object - these are HLSL shaders pre-compiled to bytecode
-    std::wstring shaderPath = L"shaders/";
-
-    std::wcout << L"Looking for shaders in: " << shaderPath << std::endl;
+    // The archive sits next to the loose .cso files; without it (e.g. shaders compiled by
+    // hand) the loose files are packed in memory instead, which is slower but equivalent
+    const std::string shaderPath = "shaders/";
+    LOG_INFO("Looking for shaders in: %s", shaderPath.c_str());
 
     // Debug output: Show current working directory for troubleshooting
     // This helps verify we're looking in the right location for shader files
     wchar_t currentDir[MAX_PATH];
     GetCurrentDirectoryW(MAX_PATH, currentDir);
-    std::wcout << L"Current directory: " << currentDir << std::endl;
-
-    // File system enumeration: Search for all .cso files in the shader directory
-    // This is primarily for debugging - helps verify shader files exist before loading
-    WIN32_FIND_DATAW findData;
-    HANDLE hFind = FindFirstFileW((shaderPath + L"*.cso").c_str(), &findData);
-    if (hFind != INVALID_HANDLE_VALUE) {
-        do {
-            std::wcout << L"Found shader file: " << findData.cFileName << std::endl;
-        } while (FindNextFileW(hFind, &findData));
-        FindClose(hFind);
-    } else {
-        std::wcout << L"No shader files found in directory!" << std::endl;
+    LOG_DEBUG("Current directory: %ls", currentDir);
+
+    if (!shaderLibrary.LoadArchive(device.Get(), jobSystem, shaderPath + "Shaders.pak") &&
+        !shaderLibrary.LoadDirectory(device.Get(), jobSystem, shaderPath)) {
+        return false;
     }
 
     // ========================================
-    // 2. VERTEX SHADER LOADING AND CREATION
+    // 2. SHADER LOOKUP AND INPUT LAYOUT
     // ========================================
-    // Vertex shaders are the first programmable stage in the graphics pipeline
-    // They transform vertex positions, apply transformations, and prepare data for rasterization
-
-    // Binary file loading: Read the compiled vertex shader bytecode from disk
-    // Use binary mode ("rb") because .cso files contain compiled bytecode, not text
-    std::vector<char> vsData; // Vector to hold vertex shader bytecode
-    FILE* vsFile = nullptr;
-    _wfopen_s(&vsFile, (shaderPath + L"BasicVS.cso").c_str(), L"rb");
-
-    if (vsFile) {
-        std::cout << "Found vertex shader file\n";
-
-        // File size calculation: Determine the size of the shader bytecode
-        // This is necessary for memory allocation and DirectX buffer creation
-        fseek(vsFile, 0, SEEK_END);   // Move to end of file
-        vsData.resize(ftell(vsFile)); // Resize vector to file size
-        fseek(vsFile, 0, SEEK_SET);   // Return to beginning of file
-
-        // Binary data loading: Read the entire shader bytecode into memory
-        // fread() loads the raw bytecode that DirectX will use to create the shader
-        fread(vsData.data(), 1, vsData.size(), vsFile);
-        fclose(vsFile);
-    } else {
-        std::cout << "Failed to load vertex shader!\n";
-        return false; // Early return if vertex shader loading fails
+    // Split out so a hot reload can repeat it when the library swaps a shader
+    if (!AcquireShaders()) {
+        return false;
     }
 
+#if SHADER_HOT_RELOAD
     // ========================================
-    // 3. PIXEL SHADER LOADING AND CREATION
+    // 3. HOT RELOAD
     // ========================================
-    // Pixel shaders (also called fragment shaders) run for each pixel/fragment
-    // They calculate the final color that appears on screen for each pixel
-    // Binary file loading: Read the compiled pixel shader bytecode from disk
-    // Similar process to vertex shader loading - binary mode for bytecode
-    std::vector<char> psData; // Vector to hold pixel shader bytecode
-    FILE* psFile = nullptr;
-    _wfopen_s(&psFile, (shaderPath + L"BasicPS.cso").c_str(), L"rb");
+    // Edits to the HLSL sources are recompiled in the background and applied by Render
+    shaderHotReload.Start(device.Get(), SHADER_SOURCE_DIR);
+#endif
 
-    if (psFile) {
-        // File size calculation and binary data loading (same pattern as vertex shader)
-        fseek(psFile, 0, SEEK_END);
-        psData.resize(ftell(psFile));
-        fseek(psFile, 0, SEEK_SET);
-        fread(psData.data(), 1, psData.size(), psFile);
-        fclose(psFile);
-    } else {
-        std::cout << "Failed to load pixel shader!\n";
-        return false; // Early return if pixel shader loading fails
-    }
+    return true; // Success - all shaders and layouts created successfully
+}
 
+bool Graphics::AcquireShaders() {
     // ========================================
-    // 4. DIRECTX VERTEX SHADER OBJECT CREATION
+    // 1. SHADER LOOKUP
     // ========================================
-    // Convert the loaded bytecode into a DirectX vertex shader object
-    // This creates a GPU resource that can be bound to the graphics pipeline
-
-    // CreateVertexShader() parameters breakdown:
-    // - vsData.data(): Pointer to the vertex shader bytecode
-    // - vsData.size(): Size of the bytecode in bytes
-    // - nullptr: No class linkage interface (advanced feature, not needed here)
-    // - vertexShader.GetAddressOf(): Output parameter - receives the created shader
-    HRESULT hr = device->CreateVertexShader(vsData.data(),
-                                            vsData.size(),
-                                            nullptr,
-                                            vertexShader.GetAddressOf());
-
-    // Error handling: Check if vertex shader creation succeeded
-    // FAILED() macro checks if HRESULT indicates an error condition
-    if (FAILED(hr)) {
-        char errorMsg[256];
-        sprintf_s(errorMsg, "Failed to create vertex shader! Error: 0x%08X\n", hr);
-        std::cout << errorMsg;
-        std::cout << "Shader size: " << vsData.size() << " bytes\n";
+    // Names are the .cso file names without extension; the library keeps the objects alive
+    // Nothing is assigned until every lookup succeeded, so a bad reload keeps the old set
+    ID3D11VertexShader* newVertexShader = shaderLibrary.GetVertexShader("BasicVS");
+    ID3D11PixelShader* newPixelShader   = shaderLibrary.GetPixelShader("BasicPS");
+    if (!newVertexShader) {
+        LOG_ERROR("Failed to load vertex shader!");
+        return false;
+    }
+    if (!newPixelShader) {
+        LOG_ERROR("Failed to load pixel shader!");
         return false;
     }
 
     // ========================================
-    // 5. INPUT LAYOUT DEFINITION AND CREATION
+    // 2. INPUT LAYOUT DEFINITION AND CREATION
     // ========================================
     // Input layouts define how vertex data is structured and interpreted by shaders
     // They create a contract between your vertex buffer format and shader expectations
     // This is critical for the Input Assembler stage of the graphics pipeline
 
-    // Vertex attribute description: Define the structure of vertex data
-    // Each D3D11_INPUT_ELEMENT_DESC describes one attribute (position, color, etc.)
-    D3D11_INPUT_ELEMENT_DESC layout[] = {
-        // POSITION attribute (first 3 floats of each vertex)
-        // - "POSITION": Semantic name that matches the shader input
-        // - 0: Semantic index (for multiple attributes of same type)
-        // - DXGI_FORMAT_R32G32B32_FLOAT: 3 32-bit floats (x, y, z coordinates)
-        // - 0: Input slot (which vertex buffer stream)
-        // - 0: Byte offset from start of vertex (position comes first)
-        // - D3D11_INPUT_PER_VERTEX_DATA: Data changes per vertex (not per instance)
-        // - 0: Instance data step rate (not used for per-vertex data)
-        {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
-
-        // COLOR attribute (next 4 floats of each vertex)
-        // - "COLOR": Semantic name that matches the shader input
-        // - DXGI_FORMAT_R32G32B32A32_FLOAT: 4 32-bit floats (r, g, b, a values)
-        // - 12: Byte offset (3 position floats × 4 bytes = 12 bytes offset)
-        {"COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0}};
-
-    // Create the input layout object using the vertex shader bytecode
-    // The input layout must be created using the same shader bytecode that will use it
-    // This ensures compatibility between vertex data format and shader expectations
-    hr = device->CreateInputLayout(layout,        // Array of input element descriptions
-                                   2,             // Number of elements in the array
-                                   vsData.data(), // Vertex shader bytecode for validation
-                                   vsData.size(), // Size of vertex shader bytecode
-                                   inputLayout.GetAddressOf()); // Output parameter
-
-    // Error handling: Verify input layout creation succeeded
-    if (FAILED(hr)) {
-        std::cout << "Failed to create input layout! Error: 0x" << std::hex << hr << std::endl;
+    // The element descs are generated at compile time from the vertex structs themselves
+    // (VertexLayout<PackedVertex>, VertexLayout<InstanceData>), so semantics, formats and
+    // byte offsets cannot drift from the data that is actually uploaded:
+    // - Slot 0, per vertex: POSITION (R16G16B16A16_SNORM), COLOR (R8G8B8A8_UNORM)
+    // - Slot 1, per instance, step rate 1: INSTANCE_TRANSFORM0-2 and INSTANCE_COLOR (float4)
+    static constexpr auto layout = MakeInputLayout(InputLayoutStream<PackedVertex>{0},
+                                                   InputLayoutStream<InstanceData>{1, true});
+    const UINT layoutCount       = static_cast<UINT>(layout.size());
+
+    // The layout is validated against the vertex shader's input signature, so the library
+    // memoizes it per (element descs, vertex shader bytecode): asking again is a lookup
+    ID3D11InputLayout* newInputLayout =
+        shaderLibrary.GetInputLayout(layout.data(), layoutCount, "BasicVS");
+    if (!newInputLayout) {
         return false;
     }
 
-    // ========================================
-    // 6. DIRECTX PIXEL SHADER OBJECT CREATION
-    // ========================================
-    // Convert the loaded pixel shader bytecode into a DirectX pixel shader object
-    // This creates the final GPU resource needed for pixel/fragment processing
-
-    // CreatePixelShader() parameters (similar to vertex shader):
-    // - psData.data(): Pointer to the pixel shader bytecode
-    // - psData.size(): Size of the bytecode in bytes
-    // - nullptr: No class linkage interface needed
-    // - pixelShader.GetAddressOf(): Output parameter for the created shader
-    hr = device->CreatePixelShader(psData.data(),
-                                   psData.size(),
-                                   nullptr,
-                                   pixelShader.GetAddressOf());
-
-    // Error handling: Check if pixel shader creation succeeded
-    if (FAILED(hr)) {
-        std::cout << "Failed to create pixel shader!\n";
+    // The sprite renderer looks up its own pair the same way
+    if (!spriteRenderer.AcquireShaders(shaderLibrary)) {
         return false;
     }
 
-    // ========================================
-    // 7. SHADER LOADING SUCCESS
-    // ========================================
-    // If we reach this point, all shader resources have been successfully created:
-    // - Vertex shader object (transforms vertex positions)
-    // - Pixel shader object (calculates pixel colors)
-    // - Input layout (defines vertex data structure)
-    //
-    // These resources are now ready to be bound to the graphics pipeline during rendering
+    vertexShader = newVertexShader;
+    pixelShader  = newPixelShader;
+    inputLayout  = newInputLayout;
+    return true;
+}
 
-    return true; // Success - all shaders and layouts created successfully
+bool Graphics::CreatePipelines() {
+    // The basic program draws triangle lists with the default blend, rasterizer and
+    // depth-stencil states (there is no depth buffer) and samples every material through
+    // TextureCache's sampler; Direct3D hands back the same object for the same desc
+    D3D11_SAMPLER_DESC samplerDesc;
+    textureCache.GetSampler()->GetDesc(&samplerDesc);
+
+    PipelineCache::PipelineDesc desc;
+    desc.inputLayout  = inputLayout.Get();
+    desc.vertexShader = vertexShader.Get();
+    desc.pixelShader  = pixelShader.Get();
+    desc.topology     = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+    desc.samplers[0]  = D3D11StateFactory::AcquireSampler(pipelineCache, samplerDesc);
+
+    const uint16_t pipeline = pipelineCache.AcquirePipeline(desc);
+    if (pipeline == PipelineCache::InvalidPipeline) {
+        LOG_ERROR("Failed to create the basic pipeline: pipeline cache is full");
+        return false;
+    }
+    basicPipeline = pipeline;
+    return true;
 }
 
 void Graphics::Render() {
@@ -329,17 +475,20 @@ void Graphics::Render() {
     // DIRECTX 11 RENDERING PIPELINE EXECUTION
     // ========================================================================
     // This function demonstrates the complete DirectX 11 rendering process from
-    // frame initialization to final presentation. It covers all major stages
-    // of the graphics pipeline in a real-world rendering scenario.
+    // frame initialization to final presentation. The individual stages live in the
+    // RenderBackend methods below (Clear, SetVertexBuffer, Draw, Present) so a headless
+    // backend can replay exactly the same frame.
     //
     // KEY CONCEPTS COVERED:
     // 1. Render Target Management - Frame buffer clearing and preparation
-    // 2. Vertex Buffer Creation - GPU memory management for geometry data
-    // 3. Input Assembly Configuration - Setting up the vertex input stage
+    // 2. Upload Ring Management - Per-frame GPU memory without CreateBuffer
+    // 3. Draw Packet Sorting - Ordering draws to minimize pipeline state changes
     // 4. Shader Pipeline Binding - Connecting programmable shader stages
     // 5. Draw Call Execution - Triggering GPU rendering commands
-    // 6. Frame Presentation - Double buffering and screen update
-    // 7. Resource Management - Proper cleanup and memory management
+    // 6. Sprite Batching - Thousands of quads in a handful of indexed draws
+    // 7. Texture Streaming - Mips loaded in the background under a memory budget
+    // 8. Frame Presentation - Double buffering and screen update
+    // 9. Resource Management - Long-lived buffers instead of per-frame allocation
     // ========================================================================
 
     // ========================================
@@ -348,204 +497,594 @@ void Graphics::Render() {
     // Safety check: Verify that all essential DirectX objects are properly initialized
     // This prevents crashes and provides clear error messaging for debugging
     // These objects are created during Graphics::Initialize() and are required for rendering
-    if (!device.Get() || !deviceContext.Get() || !swapChain.Get()) {
-        std::cout << "ERROR: DirectX objects are NULL" << std::endl;
+    if (!device.Get() || !deviceContext.Get() || !swapChain.IsValid()) {
+        LOG_ERROR("DirectX objects are NULL"); // Rate limited: this runs every frame
         return; // Early exit if core DirectX objects are not available
     }
 
+    PROFILE_SCOPE("Graphics::Render");
+#if PROFILING_ENABLED
+    gpuProfiler.BeginFrame(deviceContext.Get());
+#endif
+
+#if SHADER_HOT_RELOAD
+    // Shaders recompiled in the background are swapped in here, between frames, as a new
+    // pipeline; the state cache forgets the old objects so the next bind reaches the context
+    if (shaderHotReload.Apply(shaderLibrary) > 0 && AcquireShaders() && CreatePipelines()) {
+        stateCache.Invalidate();
+    }
+#endif
+
+    // Sampled frames are captured from before Clear, so the upload ring and constant pages
+    // are recorded from their first write; forgetting the cached state makes the capture
+    // bind everything it draws with instead of relying on earlier frames
+    if (captureInterval > 0 && frameCount % captureInterval == 0) {
+        frameCapture.Begin(frameCount);
+        stateCache.Invalidate();
+    }
+
     // ========================================
     // 2. FRAME BUFFER CLEARING (RENDER TARGET PREPARATION)
     // ========================================
-    // Frame clearing is essential for proper rendering - without this, you get
-    // accumulation of previous frames (ghosting effect). This prepares a clean
-    // canvas for the current frame's rendering operations.
-
     // Clear color definition: RGBA values (Red, Green, Blue, Alpha)
-    // Values range from 0.0f (minimum) to 1.0f (maximum intensity)
     // {0.0f, 0.0f, 0.0f, 1.0f} = solid black background with full opacity
     float clearColor[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    {
+        GPU_PROFILE_SCOPE(gpuProfiler, deviceContext.Get(), "Clear");
+        Clear(clearColor);
+    }
+    stateCache.BeginFrame(); // Reset issued/elided counters for this frame
 
-    // Clear the render target view (back buffer) with the specified color
-    // This operation runs on the GPU and clears every pixel in the frame buffer
-    // clearColor array provides the RGBA values for the background
-    deviceContext->ClearRenderTargetView(renderTargetView.Get(), clearColor);
+    // Output targets go through the cache too: replaying command lists resets the
+    // immediate context, so they are re-asserted every frame (free when unchanged)
+    stateCache.SetRenderTarget(renderTargetView.Get(), nullptr);
+    stateCache.SetViewport(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
 
     // ========================================
-    // 3. VERTEX DATA DEFINITION AND LAYOUT
+    // 3. TEXTURE STREAMING
     // ========================================
-    // Define the geometry we want to render - in this case, a colored triangle
-    // Each vertex contains both position (3D coordinates) and color (RGBA values)
-    // The vertex winding order is CLOCKWISE - this affects face culling and normals
+    // Finished loads are uploaded and evictions applied before anything samples them
+    StreamTextures();
 
-    // Vertex data structure: 7 floats per vertex (position: 3, color: 4)
-    // Coordinate system: DirectX uses left-handed coordinates
-    // X-axis: right (+) / left (-), Y-axis: up (+) / down (-), Z-axis: into screen (+) / out of
-    // screen (-)
-    float triangle[] = {
-        // Top vertex - RED color
-        // Position (x, y, z): Center-top of screen at (0, 0.8, 0)
-        // Color (r, g, b, a): Full red with full opacity (1, 0, 0, 1)
-        0.0f,
-        0.8f,
-        0.0f, // Position coordinates
-        1.0f,
-        0.0f,
-        0.0f,
-        1.0f, // Color values (red)
-
-        // Bottom right vertex - GREEN color
-        // Position: Bottom-right at (0.8, -0.8, 0)
-        // Color: Full green with full opacity (0, 1, 0, 1)
-        0.8f,
-        -0.8f,
-        0.0f,
-        0.0f,
-        1.0f,
-        0.0f,
-        1.0f, // Color values (green)
-
-        // Bottom left vertex - BLUE color
-        // Position: Bottom-left at (-0.8, -0.8, 0)
-        // Color: Full blue with full opacity (0, 0, 1, 1)
-        -0.8f,
-        -0.8f,
-        0.0f,
-        0.0f,
-        0.0f,
-        1.0f,
-        1.0f // Color values (blue)
-    };
+    // ========================================
+    // 4. DRAW PACKET SUBMISSION
+    // ========================================
+    // Every object becomes a small POD packet tagged with a 64-bit sort key
+    // (layer | shader | material | depth). Nothing touches the device context yet.
+    renderQueue.Reset();
+
+    DrawPacket packet    = {};
+    packet.sortKey       = SortKey::Make(0, ShaderBasic, sceneMaterial, 0);
+    packet.geometry      = GeometryTriangle; // Immutable buffer from CreateGeometry()
+    packet.vertexOffset  = 0;
+    packet.vertexCount   = 3;
+    packet.startVertex   = 0;
+    packet.instanceCount = 1;
+    packet.startInstance = 0; // Identity instance unless the scene state has a slot
+    packet.constants     = sceneConstants; // World is identity: just the view-projection
+    WriteSceneInstance(packet.startInstance);
+    renderQueue.Submit(packet);
+
+    if (!instanceBatches.empty()) {
+        SubmitInstances();
+    }
+    if (objectSubmitter.GetCount() > 0) {
+        SubmitObjects();
+    }
 
     // ========================================
-    // 4. VERTEX BUFFER CREATION AND GPU UPLOAD
+    // 5. SORT AND DISPATCH
     // ========================================
-    // Vertex buffers store geometry data in GPU memory for efficient rendering
-    // Creating buffers every frame is inefficient - typically done during initialization
-    // This example shows the process for educational purposes
+    // Radix-sorting by key groups packets that share shader/material/geometry, and the
+    // dispatcher only issues IASet*/VSSetShader/PSSetShader calls when the value changes
+    // Both the sort and (for large queues) the recording run on the job system
+    {
+        PROFILE_SCOPE("RenderQueue::Sort");
+        renderQueue.Sort();
+    }
+    if (ValidateShaders()) {
+        PROFILE_SCOPE("Graphics::ExecuteQueue");
+        GPU_PROFILE_SCOPE(gpuProfiler, deviceContext.Get(), "Draw Queue");
+
+        // The upload ring, instance buffer and constant pages must be unmapped before any
+        // draw that could read from them
+        uploadBuffer.Unmap(deviceContext.Get());
+        instanceBuffer.Unmap(deviceContext.Get());
+        constantPool.Unmap();
+        ExecuteQueue();
+    }
 
-    // Buffer description: Define properties of the vertex buffer
-    D3D11_BUFFER_DESC bufferDesc = {};
-    bufferDesc.Usage             = D3D11_USAGE_DEFAULT; // GPU read/write access (most common)
-    bufferDesc.ByteWidth =
-        sizeof(triangle); // Total size: 3 vertices × 7 floats × 4 bytes = 84 bytes
-    bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER; // This buffer will be used as vertex data
+    // ========================================
+    // 6. SPRITES
+    // ========================================
+    // Overlay quads are drawn last, over the scene, in as few draws as the batch allows
+    DrawSprites();
 
-    // Initialization data: Specify the initial content of the buffer
-    D3D11_SUBRESOURCE_DATA initData = {};
-    initData.pSysMem                = triangle; // Pointer to our vertex data array
+    // ========================================
+    // 7. PRESENT
+    // ========================================
+    // GPU timing closes before Present so the swap itself is not attributed to the frame
+#if PROFILING_ENABLED
+    gpuProfiler.EndFrame(deviceContext.Get());
+#endif
+    Present();
+#if SHADER_HOT_RELOAD
+    shaderHotReload.OnPresented();
+#endif
+    shaderLibrary.EndFrame(); // Objects superseded by hot reload are released a few frames on
+
+    if (frameCapture.IsCapturing()) {
+        const std::string path =
+            captureDirectory + "/frame_" + std::to_string(frameCount) + ".fcap";
+        if (frameCapture.End(path)) {
+            const FrameCapture::Stats stats = frameCapture.GetStats();
+            LOG_INFO("Captured frame %llu: %u commands, %u draws, %llu bytes to %s",
+                     static_cast<unsigned long long>(frameCount),
+                     stats.commands,
+                     stats.draws,
+                     static_cast<unsigned long long>(stats.fileBytes),
+                     path.c_str());
+        } else {
+            LOG_ERROR("Failed to write frame capture %s", path.c_str());
+        }
+    }
+    ++frameCount;
+}
+
+bool Graphics::ValidateShaders() {
+    // Verify that all required shader resources are loaded and ready
+    // Without shaders, the graphics pipeline cannot process vertices or pixels
+    if (vertexShader.Get() && pixelShader.Get() && inputLayout.Get()) {
+        return true;
+    }
+    // Called every frame: the per-site rate limit keeps a broken state from flooding the log
+    LOG_ERROR("Shaders are null! vertexShader: %s, pixelShader: %s, inputLayout: %s",
+              vertexShader.Get() ? "OK" : "NULL",
+              pixelShader.Get() ? "OK" : "NULL",
+              inputLayout.Get() ? "OK" : "NULL");
+    return false;
+}
 
-    // Create the vertex buffer on the GPU using the device interface
-    // This allocates GPU memory and uploads our vertex data to it
-    ID3D11Buffer* vertexBuffer; // Raw pointer for the created buffer
-    HRESULT hr = device->CreateBuffer(&bufferDesc, &initData, &vertexBuffer);
+void Graphics::QueueDispatcher::BindShader(uint32_t shader) {
+    // Only one shader program exists so far; the handle selects its pipeline, which bundles
+    // the shaders, input layout, triangle list topology, material sampler and fixed-function
+    // states. Re-binding the same pipeline is one handle compare; a different one goes
+    // through the state cache, which drops the parts the two pipelines share
+    (void)shader;
+    const uint16_t pipeline = graphics->basicPipeline;
+    if (pipeline == boundPipeline) {
+        return;
+    }
+    boundPipeline = pipeline;
+    graphics->pipelineCache.Bind(*state, pipeline);
+}
 
-    // Error handling: Check if buffer creation succeeded
-    if (FAILED(hr)) {
-        std::cout << "Failed to create vertex buffer! HRESULT: 0x" << std::hex << hr << std::endl;
-        return; // Exit if vertex buffer creation fails
+void Graphics::QueueDispatcher::BindMaterial(uint32_t material) {
+    // Material 0 is untextured; the cache also falls back to white while nothing of a
+    // streamed texture is resident
+    const uint32_t texture = material > 0 ? material - 1 : TextureStreamer::InvalidTexture;
+    state->SetPixelShaderResource(0, graphics->textureCache.GetView(texture));
+}
+
+void Graphics::QueueDispatcher::BindGeometry(uint32_t geometry, uint32_t vertexOffset) {
+    ID3D11Buffer* buffer = geometry == GeometryTriangle ? graphics->triangleBuffer.Get()
+                                                        : graphics->uploadBuffer.GetBuffer();
+    state->SetVertexBuffer(0, buffer, VertexFormat<PackedVertex>::Stride, vertexOffset);
+
+    // Every draw reads the instance stream; non-instanced packets use its identity element
+    state->SetVertexBuffer(1,
+                           graphics->instanceBuffer.GetBuffer(),
+                           VertexFormat<InstanceData>::Stride,
+                           0);
+}
+
+void Graphics::QueueDispatcher::Draw(const DrawPacket& packet) {
+    // Each packet's constants are a 256-byte window of a shared page (register b0); the
+    // state cache drops the bind when consecutive packets share the slot
+    if (packet.constants != ConstantAllocator::InvalidSlot) {
+        graphics->constantPool.BindVertex(*state, 0, packet.constants, 1);
     }
 
+    // This triggers the complete pipeline: Input Assembly → Vertex Shader →
+    // Rasterization → Pixel Shader → Output Merger
+    if (packet.instanceCount > 1 || packet.startInstance > 0) {
+        state->DrawInstanced(packet.vertexCount,
+                             packet.instanceCount,
+                             packet.startVertex,
+                             packet.startInstance);
+    } else {
+        state->Draw(packet.vertexCount, packet.startVertex);
+    }
+}
+
+void Graphics::ExecuteQueue() {
     // ========================================
-    // 5. INPUT ASSEMBLER STAGE CONFIGURATION
+    // 1. SMALL QUEUES: RECORD DIRECTLY
     // ========================================
-    // The Input Assembler (IA) is the first stage of the DirectX graphics pipeline
-    // It reads vertex data from buffers and assembles it into geometric primitives
-    // This stage prepares data for the vertex shader processing
+    // Deferred contexts have a fixed cost per command list; below a few hundred packets
+    // per recorder the immediate context is faster. Captured frames are recorded here too,
+    // since the recorders' sinks bypass frameCapture
+    const uint32_t count = renderQueue.GetPacketCount();
+    uint32_t rangeCount  = std::min(static_cast<uint32_t>(recorders.size()),
+                                   count / MinPacketsPerRecorder);
+    if (rangeCount < 2 || frameCapture.IsCapturing()) {
+        queueDispatcher.boundPipeline = PipelineCache::InvalidPipeline;
+        renderQueue.Execute(queueDispatcher);
+        return;
+    }
 
-    // Configure vertex buffer binding parameters
-    UINT stride = sizeof(float) * 7; // Size of one vertex (7 floats: 3 position + 4 color)
-    UINT offset = 0;                 // Start reading from the beginning of the buffer
+    // ========================================
+    // 2. PARALLEL RECORDING ON DEFERRED CONTEXTS
+    // ========================================
+    // Each job records one contiguous slice of the sorted queue; deferred contexts start
+    // with default state, so every recorder binds its own targets and a fresh state cache
+    const uint32_t rangeSize = (count + rangeCount - 1) / rangeCount;
+    jobSystem.ParallelFor(rangeCount, 1, [&](uint32_t first, uint32_t last) {
+        for (uint32_t range = first; range < last; ++range) {
+            PROFILE_SCOPE("Record Command List");
+            CommandRecorder& recorder = *recorders[range];
+            recorder.stateCache.Invalidate();
+            recorder.stateCache.BeginFrame();
+            recorder.stateCache.SetRenderTarget(renderTargetView.Get(), nullptr);
+            recorder.stateCache.SetViewport(0.0f,
+                                            0.0f,
+                                            static_cast<float>(width),
+                                            static_cast<float>(height));
+
+            recorder.dispatcher.boundPipeline = PipelineCache::InvalidPipeline;
+
+            uint32_t begin = range * rangeSize;
+            uint32_t end   = std::min(count, begin + rangeSize);
+            recorder.stats = renderQueue.ExecuteRange(recorder.dispatcher, begin, end);
+            recorder.context->FinishCommandList(FALSE,
+                                                recorder.commandList.ReleaseAndGetAddressOf());
+        }
+    });
 
-    // Bind our vertex buffer to the Input Assembler stage
-    // Parameters: slot index, buffer count, buffer pointer, stride, offset
-    // Slot 0 is the primary vertex stream (can have multiple streams for complex geometry)
-    deviceContext->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+    // ========================================
+    // 3. SUBMIT IN QUEUE ORDER
+    // ========================================
+    // Command lists replay in range order, so the sorted draw order is preserved
+    // RestoreContextState = FALSE leaves the immediate context in default state afterwards
+    for (uint32_t range = 0; range < rangeCount; ++range) {
+        CommandRecorder& recorder = *recorders[range];
+        if (recorder.commandList) {
+            deviceContext->ExecuteCommandList(recorder.commandList.Get(), FALSE);
+            recorder.commandList.Reset();
+        }
+    }
+    stateCache.Invalidate();
+}
 
-    // Set primitive topology: Define how vertices form geometric primitives
-    // D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST: Every 3 vertices form one triangle
-    // Other options: TRIANGLESTRIP, LINELIST, POINTLIST, etc.
-    deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+void Graphics::DrawInstances(const InstanceSource& source, uint32_t count) {
+    if (count > 0) {
+        instanceBatches.push_back({source, count});
+    }
+}
 
+void Graphics::SubmitInstances() {
     // ========================================
-    // 6. SHADER PIPELINE VALIDATION AND BINDING
+    // 1. PACK AND QUEUE EVERY BATCH
     // ========================================
-    // Verify that all required shader resources are loaded and ready
-    // Without shaders, the graphics pipeline cannot process vertices or pixels
+    // Each batch is written straight into the mapped instance buffer, then drawn with a
+    // single instanced packet; the whole submission is timed on the CPU
+    PROFILE_SCOPE("Graphics::SubmitInstances");
+    const uint64_t start = Profiler::Now();
+    uint64_t submitted   = 0;
+    for (const InstanceBatch& batch : instanceBatches) {
+        uint32_t firstInstance    = 0;
+        InstanceData* destination =
+            instanceBuffer.Allocate(deviceContext.Get(), batch.count, &firstInstance);
+        if (!destination) {
+            // The buffer grows at the start of the next frame
+            LOG_WARNING("Instance buffer is full, skipping %u instances this frame", batch.count);
+            continue;
+        }
+        instanceWriter.Write(batch.source, batch.count, destination);
+
+        DrawPacket packet    = {};
+        packet.sortKey       = SortKey::Make(0, ShaderBasic, 0, 0);
+        packet.geometry      = GeometryTriangle;
+        packet.vertexCount   = 3;
+        packet.instanceCount = batch.count;
+        packet.startInstance = firstInstance;
+        packet.constants     = sceneConstants;
+        renderQueue.Submit(packet);
+        submitted += batch.count;
+    }
+    instanceBatches.clear();
 
-    // Safety check: Ensure all shader objects are properly created
-    if (!vertexShader.Get() || !pixelShader.Get() || !inputLayout.Get()) {
-        std::cout << "ERROR: Shaders are null!" << std::endl;
+    // ========================================
+    // 2. REPORT
+    // ========================================
+    // Averaged over a few seconds of frames so one slow frame does not dominate
+    if (instanceTiming.Add(Profiler::Now() - start, submitted)) {
+        const double nanoseconds = Profiler::Get().ToNanoseconds(instanceTiming.ticks);
+        LOG_INFO("Instance submit: %.0f instances/frame, %.2f ns/instance, %.3f ms/frame",
+                 static_cast<double>(instanceTiming.items) / instanceTiming.frames,
+                 nanoseconds / static_cast<double>(instanceTiming.items),
+                 nanoseconds / instanceTiming.frames / 1.0e6);
+        instanceTiming.Reset();
+    }
+}
 
-        // Debug output: Show the state of each shader component
-        std::cout << "vertexShader: " << (vertexShader.Get() ? "OK" : "NULL") << std::endl;
-        std::cout << "pixelShader: " << (pixelShader.Get() ? "OK" : "NULL") << std::endl;
-        std::cout << "inputLayout: " << (inputLayout.Get() ? "OK" : "NULL") << std::endl;
+void Graphics::DrawObjects(const Float4x4* world, uint32_t count) {
+    if (count > 0) {
+        objectSubmitter.Add(world, count);
 
-        vertexBuffer->Release(); // Clean up vertex buffer before exiting
-        return;                  // Cannot render without shaders
+        // One packet per object on top of the usual few thousand
+        renderQueue.Reserve(objectSubmitter.GetCount() + 4096);
     }
+}
 
-    // Bind input layout to the Input Assembler stage
-    // This MUST be set BEFORE binding shaders - defines how vertex data is interpreted
-    // The input layout was created using the vertex shader bytecode for compatibility
-    deviceContext->IASetInputLayout(inputLayout.Get());
+void Graphics::SubmitObjects() {
+    // Constants go into runs of consecutive 256-byte slots, one batched multiply per run,
+    // then one packet per object names its slot (see ObjectSubmitter)
+    PROFILE_SCOPE("Graphics::SubmitObjects");
+    const uint64_t start = Profiler::Now();
+    DrawPacket packet    = {};
+    packet.sortKey       = SortKey::Make(0, ShaderBasic, 0, 0);
+    packet.geometry      = GeometryTriangle;
+    packet.vertexCount   = 3;
+    packet.instanceCount = 1;
+
+    const uint32_t queued    = objectSubmitter.GetCount();
+    const uint32_t submitted = objectSubmitter.Submit(constantPool.GetAllocator(),
+                                                      constantPool,
+                                                      matrixBatch,
+                                                      viewProjection,
+                                                      packet,
+                                                      renderQueue);
+    if (submitted < queued) {
+        LOG_WARNING("Object submit dropped %u of %u objects", queued - submitted, queued);
+    }
 
-    // Bind shaders to their respective pipeline stages
-    // Vertex Shader: Transforms vertex positions and attributes
-    // Parameters: shader object, class instances (advanced), instance count
-    deviceContext->VSSetShader(vertexShader.Get(), nullptr, 0);
+    // Averaged over a few seconds of frames so one slow frame does not dominate
+    if (objectTiming.Add(Profiler::Now() - start, submitted)) {
+        const double nanoseconds = Profiler::Get().ToNanoseconds(objectTiming.ticks);
+        LOG_INFO("Object submit: %.0f objects/frame, %.2f ns/object, %.3f ms/frame, %u pages",
+                 static_cast<double>(objectTiming.items) / objectTiming.frames,
+                 nanoseconds / static_cast<double>(objectTiming.items),
+                 nanoseconds / objectTiming.frames / 1.0e6,
+                 constantPool.GetAllocator().GetStats().pages);
+        objectTiming.Reset();
+    }
+}
 
-    // Pixel Shader: Calculates final pixel colors for rasterized fragments
-    // Parameters: shader object, class instances (advanced), instance count
-    deviceContext->PSSetShader(pixelShader.Get(), nullptr, 0);
+void Graphics::DrawSprites() {
+    PROFILE_SCOPE("Graphics::DrawSprites");
+    GPU_PROFILE_SCOPE(gpuProfiler, deviceContext.Get(), "Sprites");
+    const uint32_t count = spriteBatch.GetSpriteCount();
+    if (count == 0) {
+        spriteRenderer.Flush(spriteBatch, stateCache, uploadBuffer, deviceContext.Get());
+        return;
+    }
 
+    // Averaged over a few seconds of frames so one slow frame does not dominate
+    const uint64_t start = Profiler::Now();
+    SpriteBatch::Stats stats =
+        spriteRenderer.Flush(spriteBatch, stateCache, uploadBuffer, deviceContext.Get());
+    if (spriteTiming.Add(Profiler::Now() - start, count, stats.draws)) {
+        const double seconds = Profiler::Get().ToNanoseconds(spriteTiming.ticks) * 1.0e-9;
+        LOG_INFO("Sprite batch: %.0f sprites/frame, %.1f M quads/s, %.3f ms/frame, "
+                 "%.1f draws/frame",
+                 static_cast<double>(spriteTiming.items) / spriteTiming.frames,
+                 static_cast<double>(spriteTiming.items) / seconds * 1.0e-6,
+                 seconds * 1.0e3 / spriteTiming.frames,
+                 static_cast<double>(spriteTiming.draws) / spriteTiming.frames);
+        spriteTiming.Reset();
+    }
+}
+
+uint32_t Graphics::LoadTexture(const std::string& path) {
+    const uint32_t texture = textureStreamer.Add(path);
+    if (texture == TextureStreamer::InvalidTexture || texture + 1 > 0xFFFFu) {
+        LOG_ERROR("Failed to open streamed texture: %s", path.c_str());
+        return 0;
+    }
+    const TextureDesc& desc = textureStreamer.GetDesc(texture);
+    LOG_INFO("Streaming %s: %ux%u, %u mips", path.c_str(), desc.width, desc.height, desc.mipCount);
+    return texture + 1; // Material handles fit the 16-bit material field of SortKey
+}
+
+void Graphics::StreamTextures() {
+    PROFILE_SCOPE("Graphics::StreamTextures");
+
+    // The triangle's planar mapping spans the viewport width once (clip space [-1, 1]), so
+    // the mip it needs is the first one no wider than the viewport
+    if (sceneMaterial > 0) {
+        const uint32_t texture  = sceneMaterial - 1;
+        const TextureDesc& desc = textureStreamer.GetDesc(texture);
+        uint32_t mip            = 0;
+        while (mip + 1 < desc.mipCount && desc.MipWidth(mip) > static_cast<uint32_t>(width)) {
+            ++mip;
+        }
+        textureStreamer.Request(texture, mip);
+    }
+    textureStreamer.Update(textureCache);
+}
+
+void Graphics::WriteSceneInstance(uint32_t& startInstance) {
+    // The simulated placement of the triangle becomes one instance: a rotation about the
+    // view axis followed by the clip-space offset (rows of the 3x4 transform)
+    uint32_t first         = 0;
+    InstanceData* instance = instanceBuffer.Allocate(deviceContext.Get(), 1, &first);
+    if (!instance) {
+        return; // Full this frame: the identity instance is drawn instead
+    }
+    const float c           = std::cos(sceneState.angle);
+    const float s           = std::sin(sceneState.angle);
+    const InstanceData data = {{{c, -s, 0.0f, sceneState.position[0]},
+                                {s, c, 0.0f, sceneState.position[1]},
+                                {0.0f, 0.0f, 1.0f, 0.0f}},
+                               {1.0f, 1.0f, 1.0f, 1.0f}};
+    *instance     = data;
+    startInstance = first;
+}
+
+void Graphics::Clear(const float color[4]) {
     // ========================================
-    // 7. OUTPUT MERGER STAGE CONFIGURATION
+    // 1. UPLOAD RING FRAME START
     // ========================================
-    // The Output Merger (OM) stage handles the final pixel output operations
-    // Including depth testing, stencil testing, and blending
-
-    // Disable depth testing by setting depth stencil state to nullptr
-    // We don't have a depth buffer in this simple example, so depth testing is not needed
-    // In 3D applications, depth testing prevents far objects from drawing over near objects
-    deviceContext->OMSetDepthStencilState(nullptr, 0);
+    // The first Clear of a frame retires ring space the GPU has finished with and maps the
+    // upload buffer; per-frame geometry is then written there instead of into new buffers
+    // The instance buffer is re-mapped with DISCARD, leaving only the identity instance
+    // The frame arena rewinds the CPU scratch used FrameArena::FrameCount frames ago
+    if (!frameActive) {
+        uploadBuffer.BeginFrame(deviceContext.Get());
+        instanceBuffer.BeginFrame(deviceContext.Get());
+        frameArena.BeginFrame();
+        instanceBase = 0;
+        frameActive  = true;
+
+        // Constant pages are re-mapped with DISCARD as they fill; slot 0 of the frame holds
+        // the view-projection alone, for draws whose world transform is the identity
+        constantPool.BeginFrame(deviceContext.Get());
+        uint8_t* constants = nullptr;
+        sceneConstants     = constantPool.AllocateOne(1, &constants);
+        if (constants) {
+            memcpy(constants, &viewProjection, sizeof(viewProjection));
+        }
+    }
 
     // ========================================
-    // 8. DRAW CALL EXECUTION (GPU COMMAND SUBMISSION)
+    // 2. FRAME BUFFER CLEARING
     // ========================================
-    // The Draw call is where actual rendering happens - this sends a command to the GPU
-    // to process our vertices through the entire graphics pipeline
+    // Frame clearing is essential for proper rendering - without this, you get
+    // accumulation of previous frames (ghosting effect). This prepares a clean
+    // canvas for the current frame's rendering operations.
+    // This operation runs on the GPU and clears every pixel in the frame buffer
+    deviceContext->ClearRenderTargetView(renderTargetView.Get(), color);
+}
 
-    // Draw() parameters breakdown:
-    // - 3: Number of vertices to draw (our triangle has 3 vertices)
-    // - 0: Starting vertex index (begin from the first vertex in the buffer)
-    // This triggers the complete pipeline: Input Assembly → Vertex Shader →
-    // Rasterization → Pixel Shader → Output Merger
-    deviceContext->Draw(3, 0);
+void Graphics::SetVertexBuffer(const Vertex* vertices, uint32_t vertexCount) {
+    // Transient geometry is packed straight into the upload ring and bound at its ring offset
+    // The ring is re-mapped with NO_OVERWRITE if a previous Draw unmapped it
+    const UINT stride = VertexFormat<PackedVertex>::Stride;
+    RingAllocator::Allocation allocation;
+    if (uploadBuffer.Map(deviceContext.Get())) {
+        allocation = uploadBuffer.Allocate(stride * vertexCount, 16);
+    }
+    if (!allocation.IsValid()) {
+        LOG_ERROR("Upload ring is full, dropping %u vertices", vertexCount);
+        return;
+    }
+    VertexEncoder::EncodeVertices(vertices,
+                                  vertexCount,
+                                  static_cast<PackedVertex*>(allocation.cpuPtr));
+
+    stateCache.SetVertexBuffer(0,
+                               uploadBuffer.GetBuffer(),
+                               stride,
+                               static_cast<UINT>(allocation.offset));
+}
+
+void Graphics::Draw(uint32_t vertexCount, uint32_t startVertex) {
+    // Immediate path used through the RenderBackend interface; Render() goes through the
+    // sorted RenderQueue instead
+    if (!ValidateShaders()) {
+        return; // Cannot render without shaders
+    }
+
+    // Other renderers may change state between immediate draws, so the pipeline goes
+    // through the state cache every time rather than the dispatcher's handle compare
+    pipelineCache.Bind(stateCache, basicPipeline);
+
+    // Without a SetInstanceBuffer() this draws the identity instance
+    stateCache.SetVertexBuffer(1,
+                               instanceBuffer.GetBuffer(),
+                               VertexFormat<InstanceData>::Stride,
+                               0);
+
+    if (sceneConstants != ConstantAllocator::InvalidSlot) {
+        constantPool.BindVertex(stateCache, 0, sceneConstants, 1);
+    }
+
+    // The upload ring, instance buffer and constant pages must be unmapped before any draw
+    // that could read from them
+    uploadBuffer.Unmap(deviceContext.Get());
+    instanceBuffer.Unmap(deviceContext.Get());
+    constantPool.Unmap();
+    stateCache.Draw(vertexCount, startVertex);
+}
+
+void Graphics::SetInstanceBuffer(const InstanceData* instances, uint32_t instanceCount) {
+    // Instances are appended to this frame's instance buffer; DrawInstanced offsets its
+    // startInstance by where they landed
+    InstanceData* destination =
+        instanceBuffer.Allocate(deviceContext.Get(), instanceCount, &instanceBase);
+    if (!destination) {
+        LOG_ERROR("Instance buffer is full, dropping %u instances", instanceCount);
+        instanceBase = 0;
+        return;
+    }
+    memcpy(destination, instances, sizeof(InstanceData) * instanceCount);
+}
+
+void Graphics::DrawInstanced(uint32_t vertexCount,
+                             uint32_t instanceCount,
+                             uint32_t startVertex,
+                             uint32_t startInstance) {
+    // Immediate path, like Draw(); one call draws every copy
+    if (!ValidateShaders()) {
+        return;
+    }
+    pipelineCache.Bind(stateCache, basicPipeline);
+    stateCache.SetVertexBuffer(1,
+                               instanceBuffer.GetBuffer(),
+                               VertexFormat<InstanceData>::Stride,
+                               0);
+    if (sceneConstants != ConstantAllocator::InvalidSlot) {
+        constantPool.BindVertex(stateCache, 0, sceneConstants, 1);
+    }
+
+    uploadBuffer.Unmap(deviceContext.Get());
+    instanceBuffer.Unmap(deviceContext.Get());
+    constantPool.Unmap();
+    stateCache.DrawInstanced(vertexCount, instanceCount, startVertex, instanceBase + startInstance);
+}
 
+void Graphics::Present() {
     // ========================================
-    // 9. FRAME PRESENTATION (DOUBLE BUFFERING)
+    // 1. CLOSE THE UPLOAD RING FRAME
     // ========================================
-    // Present the completed frame to the screen using the swap chain
-    // This implements double buffering - rendering to back buffer, then swapping to front
-
-    // Present() parameters:
-    // - 1: Sync interval (1 = wait for vertical sync, 0 = present immediately)
-    // - 0: Presentation flags (none in this case)
-    // VSync synchronization prevents screen tearing but limits frame rate to monitor refresh
-    swapChain->Present(0, 0);
+    // Issue the ring fence after the last draw that may read this frame's allocations
+    if (frameActive) {
+        uploadBuffer.EndFrame(deviceContext.Get());
+        frameActive = false;
+    }
 
     // ========================================
-    // 10. RESOURCE CLEANUP AND MEMORY MANAGEMENT
+    // 2. FRAME PRESENTATION (FLIP MODEL)
     // ========================================
-    // Proper resource management is crucial in DirectX applications
-    // Every Created buffer must be Released to prevent memory leaks
+    // Sync interval 1 with vsync; without it 0 plus ALLOW_TEARING where supported
+    // The waitable object already kept the queue short, so this does not block
+    HRESULT hr = swapChain.Present();
+    if (FAILED(hr)) {
+        LOG_ERROR("Present failed! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+    }
+    framePacer.OnPresent();
 
-    // Release the vertex buffer - decrements reference count
-    // When reference count reaches 0, DirectX automatically frees the GPU memory
-    // In production code, consider using ComPtr for automatic resource management
-    vertexBuffer->Release();
+    // Flip model unbinds the back buffer from the output merger on Present; recording
+    // that in the state cache makes the next frame's SetRenderTarget rebind it
+    stateCache.SetRenderTarget(nullptr, nullptr);
+}
 
-    // NOTE: Other resources (shaders, input layout) are managed by ComPtr in class members
-    // and will be automatically released when the Graphics object is destroyed
+void Graphics::SetFrameCapture(uint32_t interval, const std::string& directory) {
+    captureInterval  = interval;
+    captureDirectory = directory.empty() ? std::string(".") : directory;
+    if (interval > 0) {
+        LOG_INFO("Capturing every %u frames to %s", interval, captureDirectory.c_str());
+    }
+}
+
+void Graphics::WaitForNextFrame() {
+    PROFILE_SCOPE("Graphics::WaitForNextFrame");
+
+    // With vsync a blocking wait ends at a vertical blank: low-latency pacing counts the
+    // next present deadline from there
+    if (swapChain.WaitForFrame() && swapChain.GetDesc().vsync) {
+        framePacer.SyncToDisplay(framePacer.GetClock().Now());
+    }
+    framePacer.WaitForFrameStart();
 }
@@ -1,15 +1,44 @@
 #pragma once
+#include "ConstantBufferPool.h"
+#include "D3D11ContextSink.h"
+#include "D3D11StateFactory.h"
+#include "GpuProfiler.h"
+#include "InputLayout.h"
+#include "InstanceBuffer.h"
+#include "ShaderHotReload.h"
+#include "ShaderLibrary.h"
+#include "SpriteRenderer.h"
+#include "SwapChain.h"
+#include "TextureCache.h"
+#include "UploadBuffer.h"
+#include "memory/FrameArena.h"
+#include "render/FrameCapture.h"
+#include "render/FramePacer.h"
+#include "render/InstanceWriter.h"
+#include "render/MatrixBatch.h"
+#include "render/ObjectSubmitter.h"
+#include "render/RenderBackend.h"
+#include "render/RenderQueue.h"
+#include "render/SpriteBatch.h"
+#include "render/StateCache.h"
+#include "render/TextureStreamer.h"
+#include "render/VertexEncoder.h"
+#include "scene/Simulation.h"
+#include "threading/JobSystem.h"
+#include "utils/Profiler.h"
 #include "utils/stdafx.h"
+#include <string>
 #include <wrl/client.h>
 
 using Microsoft::WRL::ComPtr;
 
 // DirectX Graphics Management Class
 // Initializes and manages the rendering pipeline and graphics resources
-class Graphics {
+// Implements RenderBackend so the same frame can also be produced by SoftwareRasterizer
+class Graphics : public RenderBackend {
   public:
     Graphics();
-    ~Graphics();
+    ~Graphics() override;
 
     /*
     DirectX Initialize Function
@@ -18,20 +47,267 @@ class Graphics {
     */
     bool Initialize(HWND hwnd, int width, int height);
 
+    // Swap chain buffering, frame latency and vsync; only read by Initialize
+    void SetPresentDesc(const PresentDesc& desc) {
+        presentDesc = desc;
+    }
+
+    // Frame rate cap and low-latency mode, applied from the next frame
+    void SetFramePacing(const FramePacer::Settings& settings) {
+        framePacer.SetSettings(settings);
+    }
+
+    /*
+    Block until the next frame should start: first until the swap chain can take another
+    frame, then for the frame pacer. Call before reading input, so input is as fresh as
+    possible when the frame is built
+    */
+    void WaitForNextFrame();
+
     // Frame Rendering Function
     void Render();
 
+    // Place the triangle drawn by the next Render (e.g. Simulation::Sample())
+    void SetSceneState(const SceneState& state) {
+        sceneState = state;
+    }
+
+    // RenderBackend interface
+    bool Initialize(const BackendDesc& desc) override;
+    void Clear(const float color[4]) override;
+    void SetVertexBuffer(const Vertex* vertices, uint32_t vertexCount) override;
+    // Camera for everything the basic shader draws, applied after each object's transform
+    void SetViewProjection(const Float4x4& matrix) override {
+        viewProjection = matrix;
+    }
+    void Draw(uint32_t vertexCount, uint32_t startVertex) override;
+    void SetInstanceBuffer(const InstanceData* instances, uint32_t instanceCount) override;
+    void DrawInstanced(uint32_t vertexCount,
+                       uint32_t instanceCount,
+                       uint32_t startVertex,
+                       uint32_t startInstance) override;
+    void Present() override;
+
+    /*
+    Draw count copies of the triangle in one instanced draw with the next Render, packed
+    from a structure-of-arrays source; its arrays must stay valid until that Render returns
+    The CPU cost of packing and queuing them is logged per instance every few seconds
+    */
+    void DrawInstances(const InstanceSource& source, uint32_t count);
+
+    /*
+    Draw count copies of the triangle with the next Render, each as its own draw with
+    world[i] * viewProjection in its own constant buffer slot; world must stay valid until
+    that Render returns
+    */
+    void DrawObjects(const Float4x4* world, uint32_t count);
+
+    /*
+    Sprites queued here are drawn over the scene by the next Render, in pixel coordinates
+    The CPU cost of flushing them (sort, vertex writes and draws) is logged every few seconds
+    */
+    SpriteBatch& GetSpriteBatch() {
+        return spriteBatch;
+    }
+
+    // Texture for Sprite::texture from RGBA8 pixels (e.g. a built TextureAtlas)
+    uint32_t CreateSpriteTexture(const uint32_t* pixels, uint32_t width, uint32_t height) {
+        return spriteRenderer.CreateTexture(pixels, width, height);
+    }
+
+    // Memory budget and loader threads for streamed textures; only read by Initialize
+    void SetTextureStreaming(const TextureStreamer::Settings& settings) {
+        textureSettings = settings;
+    }
+
+    /*
+    Stream a DDS or KTX2 texture; returns its material handle, 0 (untextured) on failure
+    Its mips arrive in the background, coarsest first, while it is drawn
+    */
+    uint32_t LoadTexture(const std::string& path);
+
+    // Material the triangle is drawn with (LoadTexture result, 0 = untextured)
+    void SetSceneMaterial(uint32_t material) {
+        sceneMaterial = material;
+    }
+
+    // Texture streaming hit rate, bytes streamed and residency since startup
+    TextureResidency::Stats GetTextureStats() const {
+        return textureStreamer.GetStats();
+    }
+
+    // Transient CPU memory of the last finished frame, with high-water marks
+    FrameArena::Stats GetMemoryStats() const {
+        return frameArena.GetStats();
+    }
+
+    // Frame intervals, input-to-present latency and wait times since startup
+    FramePacer::Stats GetPacingStats() const {
+        return framePacer.GetStats();
+    }
+
+    /*
+    Capture every interval-th frame to directory/frame_<n>.fcap for tools/FrameReplay
+    Frames in between pay one branch per context call; 0 turns capturing off
+    */
+    void SetFrameCapture(uint32_t interval, const std::string& directory);
+
   private:
     // DirectX 11 core components
     ComPtr<ID3D11Device> device;
     ComPtr<ID3D11DeviceContext> deviceContext;
-    ComPtr<IDXGISwapChain> swapChain;
     ComPtr<ID3D11RenderTargetView> renderTargetView;
+    int width  = 0; // Render target size, rebound every frame
+    int height = 0;
+
+    // Presentation
+    PresentDesc presentDesc; // Settings for the swap chain Initialize creates
+    SwapChain swapChain;     // Flip model with a frame-latency waitable object
+    FramePacer framePacer;   // Frame rate cap and just-in-time frame starts
+
+    // Redundant state filtering: all pipeline binds go through stateCache
+    D3D11ContextSink contextSink; // Forwards to deviceContext
+    FrameCapture frameCapture;    // Forwards to contextSink, recording sampled frames
+    StateCache stateCache;        // Shadows IA/VS/PS/RS/OM state, drops no-op binds
+
+    // Frame capture settings; frameCount numbers the frames Render has started
+    uint32_t captureInterval = 0;
+    std::string captureDirectory;
+    uint64_t frameCount = 0;
+
+    // Pipeline state objects, one per unique descriptor, and the pipelines bundling them
+    D3D11StateFactory stateFactory; // Creates the D3D11 objects behind pipelineCache handles
+    PipelineCache pipelineCache;    // Prewarmed at load; lookups never block
+
+    // BasicVS/BasicPS with their input layout and states, rebuilt on shader hot reload
+    uint16_t basicPipeline = PipelineCache::InvalidPipeline;
 
     // Shader related
+    ShaderLibrary shaderLibrary;     // Owns every shader object, loaded from the packed archive
+    ShaderHotReload shaderHotReload; // Recompiles edited HLSL, only started if SHADER_HOT_RELOAD
     ComPtr<ID3D11VertexShader> vertexShader;
     ComPtr<ID3D11PixelShader> pixelShader;
     ComPtr<ID3D11InputLayout> inputLayout;
 
-    bool LoadShaders(); // Load Shaders Function
+    // Geometry related
+    ComPtr<ID3D11Buffer> triangleBuffer; // IMMUTABLE: created once, never rewritten
+    UploadBuffer uploadBuffer;           // Ring-allocated storage for per-frame geometry
+    bool frameActive = false;            // Set by Clear(), cleared by Present()
+    SceneState sceneState;               // Triangle placement, drawn as one instance
+
+    // Per-frame CPU scratch (sort buffers, culling lists), rewound by the first Clear()
+    FrameArena frameArena;
+
+    // Instancing
+    InstanceBuffer instanceBuffer; // Per-frame instance stream bound to input slot 1
+    InstanceWriter instanceWriter; // SoA to InstanceData packing, split across the job system
+    uint32_t instanceBase = 0;     // First instance of the last SetInstanceBuffer() upload
+
+    // Batches queued by DrawInstances for the next Render
+    struct InstanceBatch {
+        InstanceSource source;
+        uint32_t count = 0;
+    };
+    std::vector<InstanceBatch> instanceBatches;
+
+    // CPU cost of one submission path, averaged over Profiler::FrameHistory frames
+    struct SubmitTiming {
+        uint64_t ticks  = 0; // Profiler::Now() ticks spent submitting, since last report
+        uint64_t items  = 0; // Instances, objects or sprites submitted in those frames
+        uint64_t draws  = 0; // Draw calls they took, where the path counts them
+        uint32_t frames = 0;
+
+        // Count one frame; true when a report is due (read the totals, then Reset)
+        bool Add(uint64_t frameTicks, uint64_t frameItems, uint64_t frameDraws = 0) {
+            ticks += frameTicks;
+            items += frameItems;
+            draws += frameDraws;
+            return ++frames == Profiler::FrameHistory;
+        }
+        void Reset() {
+            *this = SubmitTiming();
+        }
+    };
+    SubmitTiming instanceTiming;
+
+    // Per-object constants: world * viewProjection in 256-byte slots of shared buffers
+    ConstantBufferPool constantPool; // Pages mapped once per frame, bound by window
+    MatrixBatch matrixBatch;         // SIMD world * viewProjection, split across the job system
+    Float4x4 viewProjection = Float4x4::Identity();
+    uint32_t sceneConstants = ConstantAllocator::InvalidSlot; // viewProjection, this frame
+
+    // Objects queued by DrawObjects for the next Render, drawn one object per draw call
+    ObjectSubmitter objectSubmitter;
+    SubmitTiming objectTiming;
+
+    // Sprites
+    SpriteBatch spriteBatch;       // Overlay quads queued for the current frame
+    SpriteRenderer spriteRenderer; // Writes them into the upload ring, one draw per batch
+    SubmitTiming spriteTiming;     // Sorting, writing and drawing the queued sprites
+
+    // Streamed textures; material handle m > 0 samples streamer texture m - 1
+    TextureStreamer::Settings textureSettings; // Settings Initialize starts the streamer with
+    TextureStreamer textureStreamer;           // Loader threads and residency policy
+    TextureCache textureCache;                 // GPU textures of the resident mips
+    uint32_t sceneMaterial = 0;
+
+    // Draw submission
+    // Handles referenced by SortKey (shader) and DrawPacket::geometry
+    enum ShaderHandle : uint32_t { ShaderBasic = 0 };
+    enum GeometryHandle : uint32_t { GeometryTriangle = 0, GeometryUpload = 1 };
+
+    // Translates sorted RenderQueue packets into device context calls
+    struct QueueDispatcher : public RenderQueue::Dispatcher {
+        Graphics* graphics = nullptr;
+        StateCache* state  = nullptr; // Immediate or deferred context cache to record into
+
+        // Last pipeline sent to state; reset before every replay, as the cache may have
+        // been invalidated since
+        uint16_t boundPipeline = PipelineCache::InvalidPipeline;
+
+        void BindShader(uint32_t shader) override;
+        void BindMaterial(uint32_t material) override;
+        void BindGeometry(uint32_t geometry, uint32_t vertexOffset) override;
+        void Draw(const DrawPacket& packet) override;
+    };
+
+    RenderQueue renderQueue;         // Per-frame draw packets, sorted before submission
+    QueueDispatcher queueDispatcher; // Bound to this Graphics in the constructor
+
+    // Parallel command recording
+    // Large queues are split into contiguous ranges, each recorded on its own deferred
+    // context by a job, then replayed in order on the immediate context
+    static constexpr uint32_t MaxRecorders          = 4;
+    static constexpr uint32_t MinPacketsPerRecorder = 256;
+
+    struct CommandRecorder {
+        CommandRecorder() : stateCache(contextSink) {}
+
+        ComPtr<ID3D11DeviceContext> context; // D3D11_DEVICE_CONTEXT_DEFERRED
+        D3D11ContextSink contextSink;
+        StateCache stateCache;
+        QueueDispatcher dispatcher;
+        ComPtr<ID3D11CommandList> commandList;
+        RenderQueue::Stats stats;
+    };
+
+    JobSystem jobSystem; // Sort passes and command recording fan out across cores
+    std::vector<std::unique_ptr<CommandRecorder>> recorders;
+
+    GpuProfiler gpuProfiler; // Timestamp queries, only driven when PROFILING_ENABLED
+
+    bool LoadShaders();     // Load Shaders Function
+    bool AcquireShaders();  // Fetch shaders and input layout from shaderLibrary
+    bool CreatePipelines(); // Bundle the shaders with their states into basicPipeline
+    bool CreateGeometry();  // Create static geometry buffers
+    bool ValidateShaders(); // Report and return false if any shader object is missing
+    void SubmitInstances(); // Pack the queued instance batches and queue their draws
+    void SubmitObjects();   // Write the queued objects' constants and queue their draws
+    void DrawSprites();     // Flush the sprite batch on top of the scene
+    void StreamTextures();  // Request the mips this frame samples and apply finished loads
+    bool CreateRecorders(); // Create one deferred context per recorder
+    void ExecuteQueue();    // Replay the sorted queue, in parallel when it is large enough
+
+    // Upload sceneState as one instance and point startInstance at it
+    void WriteSceneInstance(uint32_t& startInstance);
 };
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+#include "render/VertexFormat.h"
+#include "utils/stdafx.h"
+#include <array>
+
+// DXGI format the input assembler reads a vertex element as
+constexpr DXGI_FORMAT ToDxgiFormat(VertexElementFormat format) {
+    switch (format) {
+    case VertexElementFormat::Float2:
+        return DXGI_FORMAT_R32G32_FLOAT;
+    case VertexElementFormat::Float3:
+        return DXGI_FORMAT_R32G32B32_FLOAT;
+    case VertexElementFormat::Float4:
+        return DXGI_FORMAT_R32G32B32A32_FLOAT;
+    case VertexElementFormat::SNorm16x2:
+        return DXGI_FORMAT_R16G16_SNORM;
+    case VertexElementFormat::SNorm16x4:
+        return DXGI_FORMAT_R16G16B16A16_SNORM;
+    case VertexElementFormat::UNorm8x4:
+        return DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+    return DXGI_FORMAT_UNKNOWN;
+}
+
+/*
+Input Layout Stream
+One vertex buffer slot of an input layout: the vertex struct read from it, and whether it
+advances per vertex or per instance. Streams are combined with MakeInputLayout:
+
+    constexpr auto layout = MakeInputLayout(InputLayoutStream<PackedVertex>{0},
+                                            InputLayoutStream<InstanceData>{1, true});
+*/
+template <typename V>
+struct InputLayoutStream {
+    UINT slot        = 0;
+    bool perInstance = false;
+    UINT stepRate    = 1; // Instances per element when perInstance
+};
+
+namespace InputLayoutDetail {
+
+template <typename V>
+constexpr void Append(D3D11_INPUT_ELEMENT_DESC* out, size_t& next, InputLayoutStream<V> stream) {
+    const D3D11_INPUT_CLASSIFICATION classification =
+        stream.perInstance ? D3D11_INPUT_PER_INSTANCE_DATA : D3D11_INPUT_PER_VERTEX_DATA;
+    const UINT stepRate = stream.perInstance ? stream.stepRate : 0;
+
+    for (uint32_t i = 0; i < VertexFormat<V>::Count; ++i) {
+        const VertexElement& element = VertexFormat<V>::Elements[i];
+        out[next++]                  = {element.semantic,
+                                        element.semanticIndex,
+                                        ToDxgiFormat(element.format),
+                                        stream.slot,
+                                        element.offset,
+                                        classification,
+                                        stepRate};
+    }
+}
+
+} // namespace InputLayoutDetail
+
+// Element descs for every stream, in order; built at compile time when used as constexpr
+template <typename... V>
+constexpr std::array<D3D11_INPUT_ELEMENT_DESC, (VertexFormat<V>::Count + ...)>
+MakeInputLayout(InputLayoutStream<V>... streams) {
+    std::array<D3D11_INPUT_ELEMENT_DESC, (VertexFormat<V>::Count + ...)> descs = {};
+
+    size_t next = 0;
+    (InputLayoutDetail::Append(descs.data(), next, streams), ...);
+    return descs;
+}
@@ -0,0 +1,112 @@
+#include "InstanceBuffer.h"
+#include "utils/Logger.h"
+
+bool InstanceBuffer::Initialize(ID3D11Device* device, uint32_t capacity) {
+    this->device = device;
+    return Create(capacity);
+}
+
+bool InstanceBuffer::Create(uint32_t instanceCount) {
+    D3D11_BUFFER_DESC desc = {};
+    desc.Usage             = D3D11_USAGE_DYNAMIC;
+    desc.ByteWidth         = static_cast<UINT>(sizeof(InstanceData) * instanceCount);
+    desc.BindFlags         = D3D11_BIND_VERTEX_BUFFER;
+    desc.CPUAccessFlags    = D3D11_CPU_ACCESS_WRITE;
+
+    ComPtr<ID3D11Buffer> created;
+    HRESULT hr = device->CreateBuffer(&desc, nullptr, created.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create instance buffer (%u instances)! HRESULT: 0x%08X",
+                  instanceCount,
+                  static_cast<unsigned>(hr));
+        return false;
+    }
+    buffer   = created;
+    capacity = instanceCount;
+    return true;
+}
+
+bool InstanceBuffer::BeginFrame(ID3D11DeviceContext* context) {
+    if (!buffer) {
+        return false;
+    }
+    Unmap(context);
+
+    // ========================================
+    // 1. GROW AFTER AN OVERFLOWING FRAME
+    // ========================================
+    // Growing mid-frame would invalidate draws already recorded against the old buffer, so
+    // the frame that overflowed drops instances and the next one gets the larger buffer
+    if (requested > capacity && capacity < MaxCapacity) {
+        uint32_t grown = capacity;
+        while (grown < requested && grown < MaxCapacity) {
+            grown *= 2;
+        }
+        if (Create(grown)) {
+            LOG_INFO("Instance buffer grown to %u instances", grown);
+        }
+    }
+
+    // ========================================
+    // 2. DISCARD AND WRITE THE IDENTITY INSTANCE
+    // ========================================
+    used        = 0;
+    requested   = 0;
+    frameMapped = false;
+    if (!Map(context, D3D11_MAP_WRITE_DISCARD)) {
+        return false;
+    }
+    frameMapped = true;
+
+    InstanceData identity = {};
+    for (int row = 0; row < 3; ++row) {
+        identity.transform[row][row] = 1.0f;
+    }
+    for (float& channel : identity.color) {
+        channel = 1.0f;
+    }
+    mappedData[0] = identity;
+    used          = 1;
+    requested     = 1;
+    return true;
+}
+
+InstanceData* InstanceBuffer::Allocate(ID3D11DeviceContext* context,
+                                       uint32_t count,
+                                       uint32_t* firstInstance) {
+    requested += count;
+    if (!frameMapped || count > capacity - used) {
+        return nullptr;
+    }
+    // Re-map after an Unmap earlier in the frame; NO_OVERWRITE keeps the earlier instances
+    if (!mappedData && !Map(context, D3D11_MAP_WRITE_NO_OVERWRITE)) {
+        return nullptr;
+    }
+
+    *firstInstance = used;
+    used += count;
+    return mappedData + *firstInstance;
+}
+
+bool InstanceBuffer::Map(ID3D11DeviceContext* context, D3D11_MAP mapType) {
+    D3D11_MAPPED_SUBRESOURCE mapped = {};
+    if (FAILED(context->Map(buffer.Get(), 0, mapType, 0, &mapped))) {
+        return false;
+    }
+    mappedData  = static_cast<InstanceData*>(mapped.pData);
+    mappedFirst = used;
+    return true;
+}
+
+void InstanceBuffer::Unmap(ID3D11DeviceContext* context) {
+    if (mappedData) {
+        if (capture && capture->IsCapturing()) {
+            capture->RecordBufferData(buffer.Get(),
+                                      static_cast<uint32_t>(mappedFirst * sizeof(InstanceData)),
+                                      mappedData + mappedFirst,
+                                      uint64_t(used - mappedFirst) * sizeof(InstanceData));
+        }
+        context->Unmap(buffer.Get(), 0);
+        mappedData = nullptr;
+    }
+}
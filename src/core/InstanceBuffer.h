@@ -0,0 +1,66 @@
+#pragma once
+#include "render/FrameCapture.h"
+#include "render/RenderBackend.h"
+#include "utils/stdafx.h"
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+// Instance Buffer Class
+// Per-frame D3D11_USAGE_DYNAMIC vertex buffer holding the InstanceData stream (input slot 1).
+// The first Map of a frame is WRITE_DISCARD, so the driver renames the storage instead of
+// waiting for the GPU; later Maps in the same frame use NO_OVERWRITE and keep earlier
+// allocations. Element 0 is always an identity instance, which non-instanced draws use.
+// A frame that runs out of space drops the overflowing allocations and the buffer grows
+// (to the next power of two) at the start of the following frame.
+class InstanceBuffer {
+  public:
+    // Largest instance count the buffer will grow to (256 MB)
+    static constexpr uint32_t MaxCapacity = 1u << 22;
+
+    /*
+    Create the buffer
+    device: Kept for growing the buffer later
+    capacity: Initial size in instances
+    */
+    bool Initialize(ID3D11Device* device, uint32_t capacity);
+
+    // Start a frame: grow if the last frame overflowed, map with DISCARD, write the identity
+    bool BeginFrame(ID3D11DeviceContext* context);
+
+    /*
+    Reserve count instances; write them through the returned pointer before Unmap
+    firstInstance receives the index to pass as StartInstanceLocation
+    Returns nullptr when the frame's space is exhausted
+    */
+    InstanceData* Allocate(ID3D11DeviceContext* context, uint32_t count, uint32_t* firstInstance);
+
+    // Unmap the buffer; must be called before any draw that reads from it
+    void Unmap(ID3D11DeviceContext* context);
+
+    ID3D11Buffer* GetBuffer() const {
+        return buffer.Get();
+    }
+    uint32_t GetCapacity() const {
+        return capacity;
+    }
+
+    // While capture is capturing, each Unmap records the instances written since the Map
+    void SetCapture(FrameCapture* capture) {
+        this->capture = capture;
+    }
+
+  private:
+    ComPtr<ID3D11Device> device;
+    ComPtr<ID3D11Buffer> buffer;
+    InstanceData* mappedData = nullptr;
+    uint32_t capacity        = 0;
+    uint32_t used            = 0;     // Instances allocated this frame, including the identity
+    uint32_t requested       = 0;     // Instances asked for this frame, including dropped ones
+    bool frameMapped         = false; // DISCARD already done this frame
+    uint32_t mappedFirst     = 0;     // used at Map
+    FrameCapture* capture    = nullptr;
+
+    bool Create(uint32_t instanceCount);
+    bool Map(ID3D11DeviceContext* context, D3D11_MAP mapType);
+};
@@ -0,0 +1,71 @@
+#include "MeshBuffer.h"
+#include "utils/Logger.h"
+
+bool MeshBuffer::Create(ID3D11Device* device, const MeshFile& mesh) {
+    Release();
+    const MeshFile::Header& header = mesh.GetHeader();
+    if (mesh.GetVertexDataSize() == 0 || mesh.GetIndexDataSize() == 0 ||
+        mesh.GetVertexDataSize() > UINT32_MAX || mesh.GetIndexDataSize() > UINT32_MAX) {
+        LOG_ERROR("Mesh has no geometry or exceeds the 4 GB buffer limit");
+        return false;
+    }
+
+    // ========================================
+    // 1. VERTEX BUFFER
+    // ========================================
+    // pSysMem points into the mapped file; the runtime copies it into the buffer once
+    D3D11_BUFFER_DESC desc = {};
+    desc.Usage             = D3D11_USAGE_IMMUTABLE;
+    desc.ByteWidth         = static_cast<UINT>(mesh.GetVertexDataSize());
+    desc.BindFlags         = D3D11_BIND_VERTEX_BUFFER;
+
+    D3D11_SUBRESOURCE_DATA initData = {};
+    initData.pSysMem                = mesh.GetVertexData();
+
+    HRESULT hr = device->CreateBuffer(&desc, &initData, vertexBuffer.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create mesh vertex buffer! HRESULT: 0x%08X",
+                  static_cast<unsigned>(hr));
+        return false;
+    }
+
+    // ========================================
+    // 2. INDEX BUFFER
+    // ========================================
+    desc.ByteWidth   = static_cast<UINT>(mesh.GetIndexDataSize());
+    desc.BindFlags   = D3D11_BIND_INDEX_BUFFER;
+    initData.pSysMem = mesh.GetIndexData();
+
+    hr = device->CreateBuffer(&desc, &initData, indexBuffer.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create mesh index buffer! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+        Release();
+        return false;
+    }
+
+    vertexStride = header.vertexStride;
+    indexFormat  = header.indexSize == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+    submeshes.resize(mesh.GetSubmeshCount());
+    for (uint32_t i = 0; i < mesh.GetSubmeshCount(); ++i) {
+        submeshes[i] = mesh.GetSubmesh(i);
+    }
+    meshlets.resize(mesh.GetMeshletCount());
+    for (uint32_t i = 0; i < mesh.GetMeshletCount(); ++i) {
+        meshlets[i] = mesh.GetMeshlet(i);
+    }
+    lods.resize(mesh.GetLodCount());
+    for (uint32_t i = 0; i < mesh.GetLodCount(); ++i) {
+        lods[i] = mesh.GetLod(i);
+    }
+    return true;
+}
+
+void MeshBuffer::Release() {
+    vertexBuffer.Reset();
+    indexBuffer.Reset();
+    vertexStride = 0;
+    indexFormat  = DXGI_FORMAT_UNKNOWN;
+    submeshes.clear();
+    meshlets.clear();
+    lods.clear();
+}
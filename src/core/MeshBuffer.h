@@ -0,0 +1,64 @@
+#pragma once
+#include "render/MeshFile.h"
+#include "utils/stdafx.h"
+#include <vector>
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+// Mesh Buffer Class
+// IMMUTABLE vertex and index buffers created straight from a MeshFile: the mapped sections
+// are the D3D11_SUBRESOURCE_DATA, so nothing is parsed or copied on the CPU. The submesh,
+// meshlet and LOD tables are kept for DrawIndexed arguments, culling and LOD selection; the
+// MeshFile can be closed once this is created.
+class MeshBuffer {
+  public:
+    /*
+    Create the buffers
+    mesh: An open MeshFile; its vertex stride is expected to match the bound input layout
+    (check with MeshFile::HasVertexFormat<V>() before calling)
+    */
+    bool Create(ID3D11Device* device, const MeshFile& mesh);
+
+    void Release();
+
+    ID3D11Buffer* GetVertexBuffer() const {
+        return vertexBuffer.Get();
+    }
+    ID3D11Buffer* GetIndexBuffer() const {
+        return indexBuffer.Get();
+    }
+    UINT GetVertexStride() const {
+        return vertexStride;
+    }
+    DXGI_FORMAT GetIndexFormat() const {
+        return indexFormat;
+    }
+    uint32_t GetSubmeshCount() const {
+        return static_cast<uint32_t>(submeshes.size());
+    }
+    const MeshFile::Submesh& GetSubmesh(uint32_t index) const {
+        return submeshes[index];
+    }
+    uint32_t GetMeshletCount() const {
+        return static_cast<uint32_t>(meshlets.size());
+    }
+    const MeshFile::Meshlet& GetMeshlet(uint32_t index) const {
+        return meshlets[index];
+    }
+    uint32_t GetLodCount() const {
+        return static_cast<uint32_t>(lods.size());
+    }
+    const MeshFile::Lod& GetLod(uint32_t index) const {
+        return lods[index];
+    }
+
+  private:
+    ComPtr<ID3D11Buffer> vertexBuffer;
+    ComPtr<ID3D11Buffer> indexBuffer;
+    UINT vertexStride       = 0;
+    DXGI_FORMAT indexFormat = DXGI_FORMAT_UNKNOWN;
+    std::vector<MeshFile::Submesh> submeshes;
+    std::vector<MeshFile::Meshlet> meshlets;
+    std::vector<MeshFile::Lod> lods;
+};
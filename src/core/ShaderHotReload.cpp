@@ -0,0 +1,219 @@
+#include "ShaderHotReload.h"
+#include "utils/Logger.h"
+#include <cstring>
+#include <d3dcompiler.h>
+
+namespace {
+
+double Milliseconds(FileWatcher::Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// Target profiles by ShaderStage, matching the build's fxc step (/T xx_5_0)
+const char* const Profiles[] = {"vs_5_0", "ps_5_0", "gs_5_0", "hs_5_0", "ds_5_0", "cs_5_0"};
+
+std::wstring Widen(const std::string& text) {
+    int length = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, nullptr, 0);
+    std::wstring wide(length > 0 ? length - 1 : 0, L'\0');
+    if (length > 1) {
+        MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, &wide[0], length);
+    }
+    return wide;
+}
+
+} // namespace
+
+ShaderHotReload::~ShaderHotReload() {
+    Stop();
+}
+
+bool ShaderHotReload::Start(ID3D11Device* device, const std::string& sourceDirectory) {
+    this->device = device;
+    directory    = sourceDirectory;
+    bool started = watcher.Start(directory,
+                                 [this](const std::vector<std::string>& files,
+                                        Clock::time_point firstChange) {
+                                     OnFilesChanged(files, firstChange);
+                                 });
+    if (started) {
+        LOG_INFO("Shader hot reload watching %s", directory.c_str());
+    } else {
+        LOG_WARNING("Shader hot reload unavailable: cannot watch %s", directory.c_str());
+    }
+    return started;
+}
+
+void ShaderHotReload::Stop() {
+    watcher.Stop();
+    std::lock_guard<std::mutex> lock(mutex);
+    ready.clear();
+    hasReady.store(false, std::memory_order_relaxed);
+}
+
+// ========================================
+// 1. WATCHER THREAD: RECOMPILE
+// ========================================
+
+void ShaderHotReload::OnFilesChanged(const std::vector<std::string>& files,
+                                     Clock::time_point firstChange) {
+    for (const std::string& file : files) {
+        // Only top-level stage sources map to archive entries ("BasicPS.hlsl" -> "BasicPS")
+        const std::string extension = ".hlsl";
+        if (file.size() <= extension.size() ||
+            file.compare(file.size() - extension.size(), extension.size(), extension) != 0) {
+            continue;
+        }
+        std::string name = file.substr(0, file.size() - extension.size());
+        ShaderStage stage;
+        if (!ShaderStageFromName(name, stage)) {
+            continue;
+        }
+
+        Result result;
+        result.name    = name;
+        result.changed = firstChange;
+        if (!Compile(file, stage, result)) {
+            continue;
+        }
+        result.compiled = Clock::now();
+        LOG_INFO("Recompiled %s (%.1f ms after the edit)",
+                 file.c_str(),
+                 Milliseconds(result.compiled - firstChange));
+
+        std::lock_guard<std::mutex> lock(mutex);
+        // A newer compile of the same shader supersedes one that was never applied
+        for (auto it = ready.begin(); it != ready.end(); ++it) {
+            if (it->name == result.name) {
+                ready.erase(it);
+                break;
+            }
+        }
+        ready.push_back(std::move(result));
+        hasReady.store(true, std::memory_order_release);
+    }
+}
+
+bool ShaderHotReload::Compile(const std::string& file, ShaderStage stage, Result& result) {
+    std::wstring path = Widen(directory + file);
+
+    UINT flags = D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_WARNINGS_ARE_ERRORS;
+#ifdef NDEBUG
+    flags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;
+#else
+    flags |= D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#endif
+
+    // Editors may still hold the file for a moment after the notification; retry briefly
+    ComPtr<ID3DBlob> code;
+    ComPtr<ID3DBlob> errors;
+    HRESULT hr = E_FAIL;
+    for (int attempt = 0; attempt < 3; ++attempt) {
+        hr = D3DCompileFromFile(path.c_str(),
+                                nullptr,
+                                D3D_COMPILE_STANDARD_FILE_INCLUDE,
+                                "main",
+                                Profiles[static_cast<uint32_t>(stage)],
+                                flags,
+                                0,
+                                code.ReleaseAndGetAddressOf(),
+                                errors.ReleaseAndGetAddressOf());
+        if (hr != HRESULT_FROM_WIN32(ERROR_SHARING_VIOLATION)) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    if (FAILED(hr)) {
+        if (errors) {
+            // One diagnostic per line; logged as a single block so the site's rate limit
+            // cannot cut a long error list short (the blob is NUL-terminated)
+            const char* output = static_cast<const char*>(errors->GetBufferPointer());
+            LOG_ERROR_BLOCK(output, strnlen(output, errors->GetBufferSize()));
+        }
+        LOG_ERROR("Failed to recompile %s! Error: 0x%08X (keeping the previous shader)",
+                  file.c_str(),
+                  static_cast<unsigned>(hr));
+        return false;
+    }
+
+    const uint8_t* bytecode = static_cast<const uint8_t*>(code->GetBufferPointer());
+    const SIZE_T size       = code->GetBufferSize();
+    switch (stage) {
+    case ShaderStage::Vertex: {
+        ComPtr<ID3D11VertexShader> shader;
+        hr            = device->CreateVertexShader(bytecode, size, nullptr, shader.GetAddressOf());
+        result.object = shader;
+        break;
+    }
+    case ShaderStage::Pixel: {
+        ComPtr<ID3D11PixelShader> shader;
+        hr            = device->CreatePixelShader(bytecode, size, nullptr, shader.GetAddressOf());
+        result.object = shader;
+        break;
+    }
+    default:
+        // Only the stages Graphics binds are reloaded so far
+        LOG_WARNING("Hot reload of %s skipped: stage not supported", file.c_str());
+        return false;
+    }
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create reloaded shader %s! Error: 0x%08X",
+                  file.c_str(),
+                  static_cast<unsigned>(hr));
+        return false;
+    }
+
+    result.bytecode.assign(bytecode, bytecode + size);
+    return true;
+}
+
+// ========================================
+// 2. RENDER THREAD: SWAP AT FRAME BOUNDARY
+// ========================================
+
+uint32_t ShaderHotReload::Apply(ShaderLibrary& library) {
+    // A single atomic load on frames without a pending reload
+    if (!hasReady.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    std::vector<Result> results;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        results.swap(ready);
+        hasReady.store(false, std::memory_order_relaxed);
+    }
+
+    uint32_t count        = 0;
+    Clock::time_point now = Clock::now();
+    for (Result& result : results) {
+        if (!library.Replace(result.name.c_str(),
+                             std::move(result.object),
+                             std::move(result.bytecode))) {
+            LOG_WARNING("Hot reload of %s skipped: not in the shader library",
+                        result.name.c_str());
+            continue;
+        }
+        applied.push_back({result.name, result.changed, result.compiled, now});
+        ++count;
+    }
+    return count;
+}
+
+void ShaderHotReload::OnPresented() {
+    if (applied.empty()) {
+        return;
+    }
+
+    Clock::time_point presented = Clock::now();
+    for (const Applied& shader : applied) {
+        LOG_INFO("Reloaded %s: edit to pixels %.1f ms (compile %.1f, wait for frame %.1f, "
+                 "frame %.1f)",
+                 shader.name.c_str(),
+                 Milliseconds(presented - shader.changed),
+                 Milliseconds(shader.compiled - shader.changed),
+                 Milliseconds(shader.applied - shader.compiled),
+                 Milliseconds(presented - shader.applied));
+    }
+    applied.clear();
+}
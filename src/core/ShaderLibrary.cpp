@@ -0,0 +1,373 @@
+#include "ShaderLibrary.h"
+#include "utils/Logger.h"
+#include "utils/MappedFile.h"
+#include "utils/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+uint64_t HashCombine(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+HRESULT CreateShader(ID3D11Device* device,
+                     ShaderStage stage,
+                     const uint8_t* bytecode,
+                     SIZE_T size,
+                     ComPtr<ID3D11DeviceChild>& object) {
+    HRESULT hr = E_INVALIDARG;
+    switch (stage) {
+    case ShaderStage::Vertex: {
+        ComPtr<ID3D11VertexShader> shader;
+        hr     = device->CreateVertexShader(bytecode, size, nullptr, shader.GetAddressOf());
+        object = shader;
+        break;
+    }
+    case ShaderStage::Pixel: {
+        ComPtr<ID3D11PixelShader> shader;
+        hr     = device->CreatePixelShader(bytecode, size, nullptr, shader.GetAddressOf());
+        object = shader;
+        break;
+    }
+    case ShaderStage::Geometry: {
+        ComPtr<ID3D11GeometryShader> shader;
+        hr     = device->CreateGeometryShader(bytecode, size, nullptr, shader.GetAddressOf());
+        object = shader;
+        break;
+    }
+    case ShaderStage::Hull: {
+        ComPtr<ID3D11HullShader> shader;
+        hr     = device->CreateHullShader(bytecode, size, nullptr, shader.GetAddressOf());
+        object = shader;
+        break;
+    }
+    case ShaderStage::Domain: {
+        ComPtr<ID3D11DomainShader> shader;
+        hr     = device->CreateDomainShader(bytecode, size, nullptr, shader.GetAddressOf());
+        object = shader;
+        break;
+    }
+    case ShaderStage::Compute: {
+        ComPtr<ID3D11ComputeShader> shader;
+        hr     = device->CreateComputeShader(bytecode, size, nullptr, shader.GetAddressOf());
+        object = shader;
+        break;
+    }
+    default:
+        break;
+    }
+    return hr;
+}
+
+} // namespace
+
+// ========================================
+// 1. LOADING
+// ========================================
+
+bool ShaderLibrary::LoadArchive(ID3D11Device* device,
+                                JobSystem& jobSystem,
+                                const std::string& path) {
+    PROFILE_FUNCTION();
+    Clear();
+    auto start = std::chrono::steady_clock::now();
+
+    if (!archive.Open(path)) {
+        LOG_WARNING("Shader archive %s is missing or invalid", path.c_str());
+        return false;
+    }
+    if (!CreateObjects(device, jobSystem)) {
+        Clear();
+        return false;
+    }
+
+    stats.loadMilliseconds = std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+    LOG_INFO("Loaded %u shaders (%u objects) from %s in %.2f ms",
+             stats.shaders,
+             stats.objects,
+             path.c_str(),
+             stats.loadMilliseconds);
+    return true;
+}
+
+bool ShaderLibrary::LoadDirectory(ID3D11Device* device,
+                                  JobSystem& jobSystem,
+                                  const std::string& directory) {
+    PROFILE_FUNCTION();
+    Clear();
+    auto start = std::chrono::steady_clock::now();
+
+    ShaderArchiveWriter writer;
+    WIN32_FIND_DATAA findData;
+    HANDLE find = FindFirstFileA((directory + "*.cso").c_str(), &findData);
+    if (find == INVALID_HANDLE_VALUE) {
+        LOG_ERROR("No shader files found in %s", directory.c_str());
+        return false;
+    }
+    do {
+        std::string name = findData.cFileName;
+        name.resize(name.size() - 4); // ".cso"
+        ShaderStage stage;
+        MappedFile file;
+        if (ShaderStageFromName(name, stage) && file.Open(directory + findData.cFileName)) {
+            writer.Add(name, stage, file.GetData(), file.GetSize());
+        }
+    } while (FindNextFileA(find, &findData));
+    FindClose(find);
+
+    looseArchive = writer.Build();
+    if (!archive.Load(looseArchive.data(), looseArchive.size()) ||
+        !CreateObjects(device, jobSystem)) {
+        Clear();
+        return false;
+    }
+
+    stats.loadMilliseconds = std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+    LOG_INFO("Loaded %u loose shaders from %s in %.2f ms (no archive)",
+             stats.shaders,
+             directory.c_str(),
+             stats.loadMilliseconds);
+    return true;
+}
+
+void ShaderLibrary::Clear() {
+    layouts.clear();
+    replaced.clear();
+    retired.clear();
+    objects.clear();
+    entryObjects.clear();
+    archive.Close();
+    looseArchive.clear();
+    device = nullptr;
+    stats  = Stats();
+}
+
+bool ShaderLibrary::CreateObjects(ID3D11Device* device, JobSystem& jobSystem) {
+    this->device = device;
+
+    // One object per distinct (stage, blob): the archive stores identical bytecode once, so
+    // entries with the same offset and stage can share the same shader object
+    struct Work {
+        uint32_t entry; // First entry using this object
+        HRESULT result;
+    };
+    std::vector<Work> work;
+    std::unordered_map<uint64_t, uint32_t> unique;
+
+    const uint32_t entryCount = archive.GetEntryCount();
+    entryObjects.resize(entryCount);
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        const ShaderArchive::Entry& entry = archive.GetEntry(i);
+        uint64_t key = entry.offset * static_cast<uint32_t>(ShaderStage::Count) +
+                       static_cast<uint32_t>(entry.stage);
+        auto inserted = unique.emplace(key, static_cast<uint32_t>(work.size()));
+        if (inserted.second) {
+            work.push_back({i, S_OK});
+        }
+        entryObjects[i] = inserted.first->second;
+    }
+    objects.resize(work.size());
+
+    // Driver compilation of the bytecode dominates; it runs on every core
+    auto createRange = [&](uint32_t begin, uint32_t end) {
+        PROFILE_SCOPE("Create Shaders");
+        for (uint32_t i = begin; i < end; ++i) {
+            const ShaderArchive::Entry& entry = archive.GetEntry(work[i].entry);
+            const uint8_t* bytecode           = archive.GetBytecode(entry);
+
+            work[i].result = CreateShader(device, entry.stage, bytecode, entry.size, objects[i]);
+        }
+    };
+    jobSystem.ParallelFor(static_cast<uint32_t>(work.size()), 0, createRange);
+
+    for (const Work& item : work) {
+        if (FAILED(item.result)) {
+            LOG_ERROR("Failed to create shader %s! Error: 0x%08X",
+                      archive.GetEntry(item.entry).name,
+                      static_cast<unsigned>(item.result));
+            return false;
+        }
+    }
+
+    stats.shaders = entryCount;
+    stats.objects = static_cast<uint32_t>(objects.size());
+    return true;
+}
+
+// ========================================
+// 2. LOOKUP
+// ========================================
+
+ID3D11DeviceChild* ShaderLibrary::Find(const char* name, ShaderStage stage) const {
+    const ShaderArchive::Entry* entry = archive.Find(name);
+    if (!entry || entry->stage != stage) {
+        return nullptr;
+    }
+    return objects[entryObjects[entry - &archive.GetEntry(0)]].Get();
+}
+
+ID3D11VertexShader* ShaderLibrary::GetVertexShader(const char* name) const {
+    return static_cast<ID3D11VertexShader*>(Find(name, ShaderStage::Vertex));
+}
+
+ID3D11PixelShader* ShaderLibrary::GetPixelShader(const char* name) const {
+    return static_cast<ID3D11PixelShader*>(Find(name, ShaderStage::Pixel));
+}
+
+ShaderLibrary::Bytecode ShaderLibrary::GetBytecode(const char* name) const {
+    Bytecode bytecode;
+    const ShaderArchive::Entry* entry = archive.Find(name);
+    if (!entry) {
+        return bytecode;
+    }
+
+    auto reloaded = replaced.find(static_cast<uint32_t>(entry - &archive.GetEntry(0)));
+    if (reloaded != replaced.end()) {
+        bytecode.data = reloaded->second.bytecode.data();
+        bytecode.size = reloaded->second.bytecode.size();
+        bytecode.hash = reloaded->second.hash;
+    } else {
+        bytecode.data = archive.GetBytecode(*entry);
+        bytecode.size = entry->size;
+        bytecode.hash = entry->hash;
+    }
+    return bytecode;
+}
+
+uint64_t ShaderLibrary::GetBytecodeHash(uint32_t entry) const {
+    auto reloaded = replaced.find(entry);
+    return reloaded != replaced.end() ? reloaded->second.hash : archive.GetEntry(entry).hash;
+}
+
+bool ShaderLibrary::Replace(const char* name,
+                            ComPtr<ID3D11DeviceChild> object,
+                            std::vector<uint8_t> bytecode) {
+    const ShaderArchive::Entry* entry = archive.Find(name);
+    if (!entry || !object || bytecode.empty()) {
+        return false;
+    }
+    uint32_t index        = static_cast<uint32_t>(entry - &archive.GetEntry(0));
+    uint64_t previousHash = GetBytecodeHash(index);
+
+    // An object shared with entries of identical bytecode stays theirs and the entry moves to
+    // a new slot; otherwise the slot is reused, so reloads never grow the object list
+    uint32_t slot = entryObjects[index];
+    if (std::count(entryObjects.begin(), entryObjects.end(), slot) > 1) {
+        entryObjects[index] = static_cast<uint32_t>(objects.size());
+        objects.push_back(std::move(object));
+    } else {
+        Retire(std::move(objects[slot]));
+        objects[slot] = std::move(object);
+    }
+
+    Reloaded& reloaded = replaced[index];
+    reloaded.hash      = ShaderArchive::Hash(bytecode.data(), bytecode.size());
+    reloaded.bytecode  = std::move(bytecode);
+
+    // Layouts validated against the previous bytecode go too, unless another entry still has it
+    for (uint32_t i = 0; i < archive.GetEntryCount(); ++i) {
+        if (GetBytecodeHash(i) == previousHash) {
+            return true;
+        }
+    }
+    for (auto layout = layouts.begin(); layout != layouts.end();) {
+        if (layout->second.bytecodeHash == previousHash) {
+            Retire(std::move(layout->second.layout));
+            layout = layouts.erase(layout);
+        } else {
+            ++layout;
+        }
+    }
+    return true;
+}
+
+void ShaderLibrary::Retire(ComPtr<ID3D11DeviceChild> object) {
+    // Callers hold raw pointers until they re-acquire, and the state cache compares them, so
+    // the object must outlive every frame that may still be recorded with it
+    retired.push_back({std::move(object), frameIndex + RetireFrames});
+}
+
+void ShaderLibrary::EndFrame() {
+    ++frameIndex;
+    if (retired.empty()) {
+        return;
+    }
+    retired.erase(std::remove_if(retired.begin(),
+                                 retired.end(),
+                                 [this](const Retired& item) {
+                                     return item.releaseFrame <= frameIndex;
+                                 }),
+                  retired.end());
+}
+
+// ========================================
+// 3. INPUT LAYOUTS
+// ========================================
+
+ID3D11InputLayout* ShaderLibrary::GetInputLayout(const D3D11_INPUT_ELEMENT_DESC* elements,
+                                                 uint32_t elementCount,
+                                                 const char* vertexShader) {
+    Bytecode bytecode = GetBytecode(vertexShader);
+    if (!bytecode.data) {
+        LOG_ERROR("Input layout requested for unknown vertex shader %s", vertexShader);
+        return nullptr;
+    }
+
+    // Key: every element field (semantic names by content) plus the signature's bytecode
+    layoutKey.clear();
+    auto append = [this](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        layoutKey.insert(layoutKey.end(), bytes, bytes + size);
+    };
+    for (uint32_t i = 0; i < elementCount; ++i) {
+        const D3D11_INPUT_ELEMENT_DESC& element = elements[i];
+
+        append(element.SemanticName, strlen(element.SemanticName) + 1);
+        append(&element.SemanticIndex, sizeof(element.SemanticIndex));
+        append(&element.Format, sizeof(element.Format));
+        append(&element.InputSlot, sizeof(element.InputSlot));
+        append(&element.AlignedByteOffset, sizeof(element.AlignedByteOffset));
+        append(&element.InputSlotClass, sizeof(element.InputSlotClass));
+        append(&element.InstanceDataStepRate, sizeof(element.InstanceDataStepRate));
+    }
+
+    // The descs are hashed with the bytecode's precomputed hash; the bytecode itself only
+    // takes part in the comparison
+    uint64_t hash = HashCombine(0xCBF29CE484222325ull, &bytecode.hash, sizeof(bytecode.hash));
+    hash          = HashCombine(hash, layoutKey.data(), layoutKey.size());
+    append(bytecode.data, bytecode.size);
+
+    auto range = layouts.equal_range(hash);
+    for (auto found = range.first; found != range.second; ++found) {
+        if (found->second.key == layoutKey) {
+            ++stats.layoutHits;
+            return found->second.layout.Get();
+        }
+    }
+
+    ComPtr<ID3D11InputLayout> layout;
+    HRESULT hr = device->CreateInputLayout(elements,
+                                           elementCount,
+                                           bytecode.data,
+                                           bytecode.size,
+                                           layout.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create input layout for %s! Error: 0x%08X",
+                  vertexShader,
+                  static_cast<unsigned>(hr));
+        return nullptr;
+    }
+    ++stats.layouts;
+    layouts.emplace(hash, Layout{layoutKey, bytecode.hash, layout});
+    return layout.Get();
+}
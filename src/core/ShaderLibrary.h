@@ -0,0 +1,118 @@
+#pragma once
+#include "UploadBuffer.h"
+#include "render/ShaderArchive.h"
+#include "threading/JobSystem.h"
+#include "utils/stdafx.h"
+#include <unordered_map>
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+// Shader Library Class
+// Owns every shader object of the application, created from one memory-mapped ShaderArchive.
+// Objects are created in parallel on the job system at load time (device creation methods are
+// free-threaded), once per distinct bytecode blob; entries whose bytecode is identical share
+// one object. Input layouts are created on first request and memoized by the pair
+// (element descs, vertex shader bytecode): the hash picks the bucket and the full key is
+// compared, so a hash collision never returns another layout.
+// Lookups and GetInputLayout are meant for the render thread.
+class ShaderLibrary {
+  public:
+    // Frames a replaced object stays alive: the CPU never runs further ahead of the GPU
+    static constexpr uint32_t RetireFrames = UploadBuffer::FramesInFlight;
+
+    struct Stats {
+        uint32_t shaders        = 0; // Archive entries
+        uint32_t objects        = 0; // Shader objects created (after deduplication)
+        uint32_t layouts        = 0; // Input layouts created
+        uint32_t layoutHits     = 0; // GetInputLayout calls served from the memo
+        double loadMilliseconds = 0.0;
+    };
+
+    // Bytecode of one entry; points into the mapped archive
+    struct Bytecode {
+        const uint8_t* data = nullptr;
+        size_t size         = 0;
+        uint64_t hash       = 0;
+    };
+
+    /*
+    Map a packed archive and create every shader in it
+    device: Device used to create the shader objects
+    jobSystem: Creation fans out across its workers
+    */
+    bool LoadArchive(ID3D11Device* device, JobSystem& jobSystem, const std::string& path);
+
+    // Development fallback: pack every *.cso in directory in memory, then load that
+    bool LoadDirectory(ID3D11Device* device, JobSystem& jobSystem, const std::string& directory);
+
+    // Release all objects and unmap the archive
+    void Clear();
+
+    // Shaders by archive name (file name without extension); nullptr if missing or wrong stage
+    ID3D11VertexShader* GetVertexShader(const char* name) const;
+    ID3D11PixelShader* GetPixelShader(const char* name) const;
+    Bytecode GetBytecode(const char* name) const;
+
+    /*
+    Input layout for elements validated against vertexShader's signature
+    Created on first use, then returned from the memo for every equal request
+    */
+    ID3D11InputLayout* GetInputLayout(const D3D11_INPUT_ELEMENT_DESC* elements,
+                                      uint32_t elementCount,
+                                      const char* vertexShader);
+
+    /*
+    Swap in a recompiled shader for an existing entry (hot reload; render thread, between
+    frames). The entry gets its own object and bytecode, so shaders that shared its blob keep
+    theirs; input layouts for the new signature are created on the next GetInputLayout.
+    The superseded object, and layouts no entry's bytecode matches anymore, are released by
+    EndFrame once RetireFrames frames have ended.
+    */
+    bool Replace(const char* name, ComPtr<ID3D11DeviceChild> object, std::vector<uint8_t> bytecode);
+
+    // Render thread, once per frame: release objects retired RetireFrames frames ago
+    void EndFrame();
+
+    const Stats& GetStats() const {
+        return stats;
+    }
+
+  private:
+    ShaderArchive archive;
+    std::vector<uint8_t> looseArchive; // Backing memory for LoadDirectory
+
+    ID3D11Device* device = nullptr;
+    std::vector<ComPtr<ID3D11DeviceChild>> objects; // One per distinct (stage, blob)
+    std::vector<uint32_t> entryObjects;             // Archive entry index -> objects index
+
+    // Memoized input layouts by key hash; key holds the serialized descs and bytecode
+    struct Layout {
+        std::vector<uint8_t> key;
+        uint64_t bytecodeHash = 0; // Signature the layout was validated against
+        ComPtr<ID3D11InputLayout> layout;
+    };
+    std::unordered_multimap<uint64_t, Layout> layouts;
+    std::vector<uint8_t> layoutKey; // Scratch key reused by every GetInputLayout
+
+    // Hot-reloaded bytecode by archive entry index
+    struct Reloaded {
+        std::vector<uint8_t> bytecode;
+        uint64_t hash = 0;
+    };
+    std::unordered_map<uint32_t, Reloaded> replaced;
+
+    // Objects superseded by Replace, released by EndFrame once frameIndex reaches releaseFrame
+    struct Retired {
+        ComPtr<ID3D11DeviceChild> object;
+        uint64_t releaseFrame = 0;
+    };
+    std::vector<Retired> retired;
+    uint64_t frameIndex = 0;
+    Stats stats;
+
+    bool CreateObjects(ID3D11Device* device, JobSystem& jobSystem);
+    ID3D11DeviceChild* Find(const char* name, ShaderStage stage) const;
+    uint64_t GetBytecodeHash(uint32_t entry) const;
+    void Retire(ComPtr<ID3D11DeviceChild> object);
+};
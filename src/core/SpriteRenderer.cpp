@@ -0,0 +1,236 @@
+#include "SpriteRenderer.h"
+#include "InputLayout.h"
+#include "utils/Logger.h"
+
+bool SpriteRenderer::Initialize(ID3D11Device* device) {
+    this->device = device;
+
+    // ========================================
+    // 1. SHARED INDEX BUFFER
+    // ========================================
+    // Every batch draws quads starting at index 0 with a base vertex, so one buffer of the
+    // largest batch serves them all (16384 quads, 192 KB)
+    std::vector<uint16_t> indices(SpriteBatch::MaxQuadsPerDraw * SpriteBatch::IndicesPerQuad);
+    SpriteBatch::WriteIndices(indices.data(), SpriteBatch::MaxQuadsPerDraw);
+
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.Usage             = D3D11_USAGE_IMMUTABLE;
+    bufferDesc.ByteWidth         = static_cast<UINT>(indices.size() * sizeof(uint16_t));
+    bufferDesc.BindFlags         = D3D11_BIND_INDEX_BUFFER;
+
+    D3D11_SUBRESOURCE_DATA initData = {};
+    initData.pSysMem                = indices.data();
+
+    HRESULT hr = device->CreateBuffer(&bufferDesc, &initData, indexBuffer.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create sprite index buffer! HRESULT: 0x%08X",
+                  static_cast<unsigned>(hr));
+        return false;
+    }
+
+    // ========================================
+    // 2. BLEND, RASTERIZER AND SAMPLER STATES
+    // ========================================
+    // One blend state per SpriteBlend, indexed by its value
+    for (uint32_t mode = 0; mode < SpriteBlendCount; ++mode) {
+        const bool opaque             = mode == static_cast<uint32_t>(SpriteBlend::Opaque);
+        const bool additive           = mode == static_cast<uint32_t>(SpriteBlend::Additive);
+        const D3D11_BLEND destination = additive ? D3D11_BLEND_ONE : D3D11_BLEND_INV_SRC_ALPHA;
+
+        D3D11_BLEND_DESC blendDesc                      = {};
+        blendDesc.RenderTarget[0].BlendEnable           = opaque ? FALSE : TRUE;
+        blendDesc.RenderTarget[0].SrcBlend              = D3D11_BLEND_SRC_ALPHA;
+        blendDesc.RenderTarget[0].DestBlend             = destination;
+        blendDesc.RenderTarget[0].BlendOp               = D3D11_BLEND_OP_ADD;
+        blendDesc.RenderTarget[0].SrcBlendAlpha         = D3D11_BLEND_ONE;
+        blendDesc.RenderTarget[0].DestBlendAlpha        = D3D11_BLEND_INV_SRC_ALPHA;
+        blendDesc.RenderTarget[0].BlendOpAlpha          = D3D11_BLEND_OP_ADD;
+        blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+        hr = device->CreateBlendState(&blendDesc, blendStates[mode].GetAddressOf());
+        if (FAILED(hr)) {
+            LOG_ERROR("Failed to create sprite blend state! HRESULT: 0x%08X",
+                      static_cast<unsigned>(hr));
+            return false;
+        }
+    }
+
+    D3D11_RASTERIZER_DESC rasterizerDesc = {};
+    rasterizerDesc.FillMode              = D3D11_FILL_SOLID;
+    rasterizerDesc.CullMode              = D3D11_CULL_NONE;
+    rasterizerDesc.DepthClipEnable       = TRUE;
+    hr = device->CreateRasterizerState(&rasterizerDesc, rasterizerState.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create sprite rasterizer state! HRESULT: 0x%08X",
+                  static_cast<unsigned>(hr));
+        return false;
+    }
+
+    D3D11_SAMPLER_DESC samplerDesc = {};
+    samplerDesc.Filter             = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+    samplerDesc.AddressU           = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.AddressV           = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.AddressW           = D3D11_TEXTURE_ADDRESS_CLAMP;
+    samplerDesc.ComparisonFunc     = D3D11_COMPARISON_NEVER;
+    samplerDesc.MaxLOD             = D3D11_FLOAT32_MAX;
+    hr = device->CreateSamplerState(&samplerDesc, samplerState.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create sprite sampler! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+        return false;
+    }
+
+    // ========================================
+    // 3. WHITE TEXTURE
+    // ========================================
+    // Handle 0: colored quads sample white and show their vertex color unchanged
+    textures.clear();
+    const uint32_t white = 0xFFFFFFFFu;
+    if (CreateTexture(&white, 1, 1) != WhiteTexture || textures.empty()) {
+        return false;
+    }
+    return true;
+}
+
+bool SpriteRenderer::AcquireShaders(ShaderLibrary& library) {
+    ID3D11VertexShader* newVertexShader = library.GetVertexShader("SpriteVS");
+    ID3D11PixelShader* newPixelShader   = library.GetPixelShader("SpritePS");
+    if (!newVertexShader || !newPixelShader) {
+        LOG_ERROR("Sprite shaders missing! SpriteVS: %s, SpritePS: %s",
+                  newVertexShader ? "OK" : "NULL",
+                  newPixelShader ? "OK" : "NULL");
+        return false;
+    }
+
+    // Slot 0, per vertex: POSITION (float2), TEXCOORD (float2), COLOR (R8G8B8A8_UNORM)
+    static constexpr auto layout = MakeInputLayout(InputLayoutStream<SpriteVertex>{0});
+    ID3D11InputLayout* newInputLayout =
+        library.GetInputLayout(layout.data(), static_cast<uint32_t>(layout.size()), "SpriteVS");
+    if (!newInputLayout) {
+        return false;
+    }
+
+    vertexShader = newVertexShader;
+    pixelShader  = newPixelShader;
+    inputLayout  = newInputLayout;
+    return true;
+}
+
+uint32_t SpriteRenderer::CreateTexture(const uint32_t* pixels, uint32_t width, uint32_t height) {
+    if (textures.size() >= SpriteBatch::MaxTextures) {
+        LOG_ERROR("Sprite texture limit reached (%u)", SpriteBatch::MaxTextures);
+        return WhiteTexture;
+    }
+
+    // IMMUTABLE with a single mip: atlases are drawn near 1:1, and the padding around each
+    // region only protects bilinear filtering at the top level
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width                = width;
+    textureDesc.Height               = height;
+    textureDesc.MipLevels            = 1;
+    textureDesc.ArraySize            = 1;
+    textureDesc.Format               = DXGI_FORMAT_R8G8B8A8_UNORM;
+    textureDesc.SampleDesc.Count     = 1;
+    textureDesc.Usage                = D3D11_USAGE_IMMUTABLE;
+    textureDesc.BindFlags            = D3D11_BIND_SHADER_RESOURCE;
+
+    D3D11_SUBRESOURCE_DATA initData = {};
+    initData.pSysMem                = pixels;
+    initData.SysMemPitch            = width * sizeof(uint32_t);
+
+    ComPtr<ID3D11Texture2D> texture;
+    ComPtr<ID3D11ShaderResourceView> view;
+    HRESULT hr = device->CreateTexture2D(&textureDesc, &initData, texture.GetAddressOf());
+    if (SUCCEEDED(hr)) {
+        hr = device->CreateShaderResourceView(texture.Get(), nullptr, view.GetAddressOf());
+    }
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create %ux%u sprite texture! HRESULT: 0x%08X",
+                  width,
+                  height,
+                  static_cast<unsigned>(hr));
+        return WhiteTexture;
+    }
+    textures.push_back(view);
+    return static_cast<uint32_t>(textures.size() - 1);
+}
+
+SpriteBatch::Stats SpriteRenderer::Flush(SpriteBatch& batch,
+                                         StateCache& state,
+                                         UploadBuffer& upload,
+                                         ID3D11DeviceContext* context) {
+    if (batch.GetSpriteCount() == 0 || !vertexShader || !pixelShader || !inputLayout) {
+        return batch.End(*this); // Empties the batch; every chunk is dropped by BeginChunk
+    }
+    this->state   = &state;
+    this->upload  = &upload;
+    this->context = context;
+
+    // ========================================
+    // 1. PIPELINE FOR EVERY BATCH
+    // ========================================
+    state.SetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    state.SetInputLayout(inputLayout.Get());
+    state.SetIndexBuffer(indexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0);
+    state.SetVertexShader(vertexShader.Get());
+    state.SetPixelShader(pixelShader.Get());
+    state.SetPixelSampler(0, samplerState.Get());
+    state.SetRasterizerState(rasterizerState.Get());
+    state.SetDepthStencilState(nullptr, 0);
+
+    // ========================================
+    // 2. WRITE CHUNKS AND DRAW BATCHES
+    // ========================================
+    SpriteBatch::Stats stats = batch.End(*this);
+    if (stats.dropped > 0) {
+        LOG_WARNING("Upload ring is full, dropped %u sprites", stats.dropped);
+    }
+
+    // The rest of the frame expects default blending and culling
+    upload.Unmap(context);
+    state.SetBlendState(nullptr, nullptr, 0xFFFFFFFFu);
+    state.SetRasterizerState(nullptr);
+
+    this->state   = nullptr;
+    this->upload  = nullptr;
+    this->context = nullptr;
+    return stats;
+}
+
+SpriteVertex* SpriteRenderer::BeginChunk(uint32_t quadCount) {
+    if (!state) {
+        return nullptr; // Not inside Flush (no shaders): drop
+    }
+
+    // Re-mapping with NO_OVERWRITE is cheap; the ring's fences keep the GPU's regions safe
+    const UINT bytes = quadCount * 4 * VertexFormat<SpriteVertex>::Stride;
+    RingAllocator::Allocation allocation;
+    if (upload->Map(context)) {
+        allocation = upload->Allocate(bytes, 16);
+    }
+    if (!allocation.IsValid()) {
+        return nullptr;
+    }
+
+    // The chunk's draws address its vertices from 0 through the base vertex
+    state->SetVertexBuffer(0,
+                           upload->GetBuffer(),
+                           VertexFormat<SpriteVertex>::Stride,
+                           static_cast<UINT>(allocation.offset));
+    return static_cast<SpriteVertex*>(allocation.cpuPtr);
+}
+
+void SpriteRenderer::DrawQuads(uint32_t texture,
+                               SpriteBlend blend,
+                               uint32_t firstQuad,
+                               uint32_t quadCount) {
+    // Drawing reads the ring, so it has to be unmapped; the next chunk maps it again
+    upload->Unmap(context);
+
+    ID3D11ShaderResourceView* view =
+        texture < textures.size() ? textures[texture].Get() : textures[WhiteTexture].Get();
+    state->SetPixelShaderResource(0, view);
+    state->SetBlendState(blendStates[static_cast<uint32_t>(blend)].Get(), nullptr, 0xFFFFFFFFu);
+    state->DrawIndexed(quadCount * SpriteBatch::IndicesPerQuad,
+                       0,
+                       static_cast<int32_t>(firstQuad * 4));
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include "ShaderLibrary.h"
+#include "UploadBuffer.h"
+#include "render/SpriteBatch.h"
+#include "render/StateCache.h"
+#include "utils/stdafx.h"
+#include <vector>
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+// Sprite Renderer Class
+// Direct3D 11 target for SpriteBatch. Vertices go into the shared upload ring (one dynamic
+// buffer mapped with NO_OVERWRITE, so nothing is created per frame), every draw reads the
+// same IMMUTABLE 16-bit index buffer, and texture, blend and pipeline binds go through the
+// state cache, so consecutive batches only pay for what actually changes.
+class SpriteRenderer : public SpriteBatch::Target {
+  public:
+    // Handle of the 1x1 white texture every renderer starts with (untextured quads)
+    static constexpr uint32_t WhiteTexture = 0;
+
+    SpriteRenderer()           = default;
+    ~SpriteRenderer() override = default;
+
+    SpriteRenderer(const SpriteRenderer&)            = delete;
+    SpriteRenderer& operator=(const SpriteRenderer&) = delete;
+
+    // Create the index buffer, blend/rasterizer/sampler states and the white texture
+    bool Initialize(ID3D11Device* device);
+
+    // Fetch SpriteVS/SpritePS and their input layout; repeat after a hot reload
+    bool AcquireShaders(ShaderLibrary& library);
+
+    /*
+    Create a texture sprites can reference
+    pixels: width * height RGBA8 values, rows top to bottom
+    Returns its handle, or WhiteTexture if creation failed
+    */
+    uint32_t CreateTexture(const uint32_t* pixels, uint32_t width, uint32_t height);
+
+    /*
+    Draw and empty batch with the render target and viewport already bound
+    Leaves blend and rasterizer state at their defaults for the draws that follow
+    */
+    SpriteBatch::Stats Flush(SpriteBatch& batch,
+                             StateCache& state,
+                             UploadBuffer& upload,
+                             ID3D11DeviceContext* context);
+
+    // SpriteBatch::Target interface
+    SpriteVertex* BeginChunk(uint32_t quadCount) override;
+    void DrawQuads(uint32_t texture,
+                   SpriteBlend blend,
+                   uint32_t firstQuad,
+                   uint32_t quadCount) override;
+
+  private:
+    ID3D11Device* device = nullptr;
+
+    // Shader objects from the library, referenced so a failed hot reload keeps them alive
+    ComPtr<ID3D11VertexShader> vertexShader;
+    ComPtr<ID3D11PixelShader> pixelShader;
+    ComPtr<ID3D11InputLayout> inputLayout;
+
+    ComPtr<ID3D11Buffer> indexBuffer; // SpriteBatch::WriteIndices for MaxQuadsPerDraw quads
+    ComPtr<ID3D11BlendState> blendStates[SpriteBlendCount];
+    ComPtr<ID3D11RasterizerState> rasterizerState; // No culling: mirrored sprites stay visible
+    ComPtr<ID3D11SamplerState> samplerState;       // Bilinear, clamped
+    std::vector<ComPtr<ID3D11ShaderResourceView>> textures; // Indexed by handle
+
+    // Bound for the duration of one Flush
+    StateCache* state            = nullptr;
+    UploadBuffer* upload         = nullptr;
+    ID3D11DeviceContext* context = nullptr;
+};
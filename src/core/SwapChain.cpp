@@ -0,0 +1,158 @@
+#include "SwapChain.h"
+#include "utils/Logger.h"
+#include <algorithm>
+
+SwapChain::~SwapChain() {
+    if (frameLatencyWaitable) {
+        CloseHandle(frameLatencyWaitable);
+    }
+}
+
+bool SwapChain::Initialize(ID3D11Device* device,
+                           HWND hwnd,
+                           int width,
+                           int height,
+                           const PresentDesc& presentDesc) {
+    desc                 = presentDesc;
+    desc.bufferCount     = std::clamp(desc.bufferCount, 2u, 16u);
+    desc.maxFrameLatency = std::clamp(desc.maxFrameLatency, 1u, 16u);
+
+    // ========================================
+    // 1. FIND THE DXGI FACTORY
+    // ========================================
+    // The swap chain has to come from the factory that owns the device's adapter
+    ComPtr<IDXGIDevice1> dxgiDevice;
+    ComPtr<IDXGIAdapter> adapter;
+    ComPtr<IDXGIFactory2> factory;
+    HRESULT hr = device->QueryInterface(__uuidof(IDXGIDevice1),
+                                        reinterpret_cast<void**>(dxgiDevice.GetAddressOf()));
+    if (SUCCEEDED(hr)) {
+        hr = dxgiDevice->GetAdapter(adapter.GetAddressOf());
+    }
+    if (SUCCEEDED(hr)) {
+        hr = adapter->GetParent(__uuidof(IDXGIFactory2),
+                                reinterpret_cast<void**>(factory.GetAddressOf()));
+    }
+    if (FAILED(hr)) {
+        LOG_ERROR("DXGI 1.2 factory unavailable! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+        return false;
+    }
+
+    // Without a waitable object this is what bounds the queue; with one, the swap chain's
+    // own limit (set below) applies instead
+    dxgiDevice->SetMaximumFrameLatency(desc.maxFrameLatency);
+
+    // ========================================
+    // 2. TEARING SUPPORT
+    // ========================================
+    // Presenting without vsync in a flip-model window only tears (instead of waiting for
+    // the compositor) when the factory reports support and the chain is created for it
+    ComPtr<IDXGIFactory5> factory5;
+    if (SUCCEEDED(factory.As(&factory5))) {
+        BOOL allowTearing = FALSE;
+        if (SUCCEEDED(factory5->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING,
+                                                    &allowTearing,
+                                                    sizeof(allowTearing)))) {
+            tearingSupported = allowTearing == TRUE;
+        }
+    }
+
+    // ========================================
+    // 3. CREATE THE FLIP-MODEL SWAP CHAIN
+    // ========================================
+    DXGI_SWAP_CHAIN_DESC1 chainDesc = {};
+    chainDesc.Width                 = static_cast<UINT>(width);
+    chainDesc.Height                = static_cast<UINT>(height);
+    chainDesc.Format                = DXGI_FORMAT_R8G8B8A8_UNORM;
+    chainDesc.SampleDesc.Count      = 1; // Flip model cannot be multisampled
+    chainDesc.BufferUsage           = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    chainDesc.BufferCount           = desc.bufferCount;
+    chainDesc.Scaling               = DXGI_SCALING_STRETCH;
+    chainDesc.SwapEffect            = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+    chainDesc.AlphaMode             = DXGI_ALPHA_MODE_UNSPECIFIED;
+    chainDesc.Flags                 = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+    if (tearingSupported) {
+        chainDesc.Flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+    }
+
+    hr = factory->CreateSwapChainForHwnd(device,
+                                         hwnd,
+                                         &chainDesc,
+                                         nullptr,
+                                         nullptr,
+                                         swapChain.GetAddressOf());
+    if (FAILED(hr)) {
+        // FLIP_DISCARD and tearing need Windows 10; FLIP_SEQUENTIAL works from 8.1
+        LOG_WARNING("FLIP_DISCARD unavailable (0x%08X), trying FLIP_SEQUENTIAL",
+                    static_cast<unsigned>(hr));
+        chainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
+        chainDesc.Flags &= ~static_cast<UINT>(DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING);
+        tearingSupported = false;
+
+        hr = factory->CreateSwapChainForHwnd(device,
+                                             hwnd,
+                                             &chainDesc,
+                                             nullptr,
+                                             nullptr,
+                                             swapChain.GetAddressOf());
+    }
+    if (FAILED(hr)) {
+        LOG_ERROR("CreateSwapChainForHwnd failed! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+        return false;
+    }
+
+    // Exclusive fullscreen would defeat both the flip presentation and tearing
+    factory->MakeWindowAssociation(hwnd, DXGI_MWA_NO_ALT_ENTER);
+
+    // ========================================
+    // 4. FRAME LATENCY WAITABLE OBJECT
+    // ========================================
+    // The object is signaled whenever fewer than maxFrameLatency presents are queued
+    ComPtr<IDXGISwapChain2> swapChain2;
+    if (SUCCEEDED(swapChain.As(&swapChain2))) {
+        swapChain2->SetMaximumFrameLatency(desc.maxFrameLatency);
+        frameLatencyWaitable = swapChain2->GetFrameLatencyWaitableObject();
+    }
+    if (!frameLatencyWaitable) {
+        LOG_WARNING("Frame latency waitable object unavailable, Present will block instead");
+    }
+
+    LOG_INFO("Swap chain: %s, %u buffers, frame latency %u, vsync %s, tearing %s",
+             chainDesc.SwapEffect == DXGI_SWAP_EFFECT_FLIP_DISCARD ? "FLIP_DISCARD"
+                                                                   : "FLIP_SEQUENTIAL",
+             desc.bufferCount,
+             desc.maxFrameLatency,
+             desc.vsync ? "on" : "off",
+             tearingSupported ? "supported" : "unsupported");
+    return true;
+}
+
+bool SwapChain::WaitForFrame() {
+    if (!frameLatencyWaitable) {
+        return false;
+    }
+    // Polling first tells a real wait (woken at a vertical blank) from a free pass
+    if (WaitForSingleObjectEx(frameLatencyWaitable, 0, TRUE) == WAIT_OBJECT_0) {
+        return false;
+    }
+    WaitForSingleObjectEx(frameLatencyWaitable, 1000, TRUE);
+    return true;
+}
+
+HRESULT SwapChain::Present() {
+    // Sync interval 1 waits for the vertical blank; 0 with ALLOW_TEARING flips at once
+    // ALLOW_TEARING is only legal with sync interval 0 on a chain created with the flag
+    const UINT syncInterval = desc.vsync ? 1 : 0;
+    const UINT flags        = !desc.vsync && tearingSupported ? DXGI_PRESENT_ALLOW_TEARING : 0;
+    return swapChain->Present(syncInterval, flags);
+}
+
+bool SwapChain::GetBackBuffer(ID3D11Texture2D** texture) {
+    HRESULT hr =
+        swapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<void**>(texture));
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to get the back buffer! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "utils/stdafx.h"
+#include <dxgi1_5.h>
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+// Presentation settings, fixed when the swap chain is created
+struct PresentDesc {
+    uint32_t bufferCount     = 3;    // Back buffers in the flip chain (2-16)
+    uint32_t maxFrameLatency = 2;    // Presented frames allowed to wait for the display
+    bool vsync               = true; // false presents at once, tearing where supported
+};
+
+// Swap Chain Class
+// Flip-model swap chain (FLIP_DISCARD, FLIP_SEQUENTIAL where that is unavailable) created
+// with a frame-latency waitable object. Flip model hands the back buffer to the compositor
+// instead of copying it, and the waitable object lets the render loop block *before* it
+// samples input, until fewer than maxFrameLatency frames are queued, rather than inside
+// Present after the frame is already stale.
+class SwapChain {
+  public:
+    SwapChain() = default;
+    ~SwapChain();
+
+    SwapChain(const SwapChain&)            = delete;
+    SwapChain& operator=(const SwapChain&) = delete;
+
+    /*
+    Create the swap chain for hwnd on the factory that created device
+    The back buffers are R8G8B8A8_UNORM, width x height
+    */
+    bool Initialize(ID3D11Device* device,
+                    HWND hwnd,
+                    int width,
+                    int height,
+                    const PresentDesc& desc);
+
+    /*
+    Block until another frame may be queued (at most one second)
+    Returns true if it had to wait, i.e. it woke at a vertical blank
+    */
+    bool WaitForFrame();
+
+    // Present with the sync interval and flags chosen by PresentDesc::vsync
+    HRESULT Present();
+
+    // Back buffer 0; with flip model it always refers to the buffer being drawn
+    bool GetBackBuffer(ID3D11Texture2D** texture);
+
+    const PresentDesc& GetDesc() const {
+        return desc;
+    }
+    bool IsTearingSupported() const {
+        return tearingSupported;
+    }
+    bool IsValid() const {
+        return swapChain.Get() != nullptr;
+    }
+
+  private:
+    ComPtr<IDXGISwapChain1> swapChain;
+    HANDLE frameLatencyWaitable = nullptr; // Owned; closed by the destructor
+    PresentDesc desc;
+    bool tearingSupported = false;
+};
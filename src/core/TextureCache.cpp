@@ -0,0 +1,169 @@
+#include "TextureCache.h"
+#include "utils/Logger.h"
+
+namespace {
+
+DXGI_FORMAT ToDxgiFormat(TextureFormat format) {
+    switch (format) {
+    case TextureFormat::RGBA8:
+        return DXGI_FORMAT_R8G8B8A8_UNORM;
+    case TextureFormat::BC1:
+        return DXGI_FORMAT_BC1_UNORM;
+    case TextureFormat::BC3:
+        return DXGI_FORMAT_BC3_UNORM;
+    case TextureFormat::BC7:
+        return DXGI_FORMAT_BC7_UNORM;
+    default:
+        return DXGI_FORMAT_UNKNOWN;
+    }
+}
+
+} // namespace
+
+bool TextureCache::Initialize(ID3D11Device* device, ID3D11DeviceContext* context) {
+    this->device  = device;
+    this->context = context;
+
+    // ========================================
+    // 1. WHITE FALLBACK
+    // ========================================
+    // Sampled until a texture's tail has landed, so untextured draws look unchanged
+    const uint32_t white = 0xFFFFFFFFu;
+
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width                = 1;
+    textureDesc.Height               = 1;
+    textureDesc.MipLevels            = 1;
+    textureDesc.ArraySize            = 1;
+    textureDesc.Format               = DXGI_FORMAT_R8G8B8A8_UNORM;
+    textureDesc.SampleDesc.Count     = 1;
+    textureDesc.Usage                = D3D11_USAGE_IMMUTABLE;
+    textureDesc.BindFlags            = D3D11_BIND_SHADER_RESOURCE;
+
+    D3D11_SUBRESOURCE_DATA initData = {};
+    initData.pSysMem                = &white;
+    initData.SysMemPitch            = sizeof(white);
+
+    ComPtr<ID3D11Texture2D> whiteTexture;
+    HRESULT hr = device->CreateTexture2D(&textureDesc, &initData, whiteTexture.GetAddressOf());
+    if (SUCCEEDED(hr)) {
+        hr = device->CreateShaderResourceView(whiteTexture.Get(),
+                                              nullptr,
+                                              whiteView.GetAddressOf());
+    }
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create white texture! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+        return false;
+    }
+
+    // ========================================
+    // 2. SAMPLER
+    // ========================================
+    // The view only covers resident mips, so no LOD clamp is needed: sampling finer than
+    // the first resident level just reads that level
+    D3D11_SAMPLER_DESC samplerDesc = {};
+    samplerDesc.Filter             = D3D11_FILTER_ANISOTROPIC;
+    samplerDesc.AddressU           = D3D11_TEXTURE_ADDRESS_WRAP;
+    samplerDesc.AddressV           = D3D11_TEXTURE_ADDRESS_WRAP;
+    samplerDesc.AddressW           = D3D11_TEXTURE_ADDRESS_WRAP;
+    samplerDesc.MaxAnisotropy      = 8;
+    samplerDesc.ComparisonFunc     = D3D11_COMPARISON_NEVER;
+    samplerDesc.MaxLOD             = D3D11_FLOAT32_MAX;
+    hr = device->CreateSamplerState(&samplerDesc, samplerState.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create texture sampler! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+        return false;
+    }
+    return true;
+}
+
+bool TextureCache::UploadMips(uint32_t texture,
+                              const TextureDesc& desc,
+                              uint32_t firstMip,
+                              uint32_t endMip,
+                              const uint8_t* data) {
+    if (texture >= entries.size()) {
+        entries.resize(texture + 1);
+    }
+    return Rebuild(texture, desc, firstMip, endMip, data);
+}
+
+void TextureCache::Evict(uint32_t texture, const TextureDesc& desc, uint32_t firstMip) {
+    if (texture >= entries.size() || !entries[texture].texture) {
+        return;
+    }
+    if (!Rebuild(texture, desc, firstMip, firstMip, nullptr)) {
+        // Keep the larger texture: only the memory is not given back
+        LOG_WARNING("Failed to shrink streamed texture %u to mip %u", texture, firstMip);
+    }
+}
+
+bool TextureCache::Rebuild(uint32_t texture,
+                           const TextureDesc& desc,
+                           uint32_t firstMip,
+                           uint32_t endMip,
+                           const uint8_t* data) {
+    Entry& entry = entries[texture];
+
+    // ========================================
+    // 1. TEXTURE OF THE NEW SIZE
+    // ========================================
+    // Block-compressed textures need a top level that is a multiple of 4; power-of-two
+    // textures always have one, since the residency never drops below the 64x64 tail
+    D3D11_TEXTURE2D_DESC textureDesc = {};
+    textureDesc.Width                = desc.MipWidth(firstMip);
+    textureDesc.Height               = desc.MipHeight(firstMip);
+    textureDesc.MipLevels            = desc.mipCount - firstMip;
+    textureDesc.ArraySize            = 1;
+    textureDesc.Format               = ToDxgiFormat(desc.format);
+    textureDesc.SampleDesc.Count     = 1;
+    textureDesc.Usage                = D3D11_USAGE_DEFAULT;
+    textureDesc.BindFlags            = D3D11_BIND_SHADER_RESOURCE;
+
+    ComPtr<ID3D11Texture2D> newTexture;
+    ComPtr<ID3D11ShaderResourceView> newView;
+    HRESULT hr = device->CreateTexture2D(&textureDesc, nullptr, newTexture.GetAddressOf());
+    if (SUCCEEDED(hr)) {
+        hr = device->CreateShaderResourceView(newTexture.Get(), nullptr, newView.GetAddressOf());
+    }
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create %ux%u streamed texture (%u mips)! HRESULT: 0x%08X",
+                  textureDesc.Width,
+                  textureDesc.Height,
+                  textureDesc.MipLevels,
+                  static_cast<unsigned>(hr));
+        return false;
+    }
+
+    // ========================================
+    // 2. NEW LEVELS FROM THE LOADER
+    // ========================================
+    for (uint32_t mip = firstMip; mip < endMip; ++mip) {
+        context->UpdateSubresource(newTexture.Get(),
+                                   mip - firstMip,
+                                   nullptr,
+                                   data,
+                                   desc.RowPitch(mip),
+                                   0);
+        data += desc.MipBytes(mip);
+    }
+
+    // ========================================
+    // 3. KEPT LEVELS, GPU TO GPU
+    // ========================================
+    for (uint32_t mip = endMip; entry.texture && mip < desc.mipCount; ++mip) {
+        context->CopySubresourceRegion(newTexture.Get(),
+                                       mip - firstMip,
+                                       0,
+                                       0,
+                                       0,
+                                       entry.texture.Get(),
+                                       mip - entry.firstMip,
+                                       nullptr);
+    }
+
+    entry.texture  = newTexture;
+    entry.view     = newView;
+    entry.firstMip = firstMip;
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "render/TextureStreamer.h"
+#include "utils/stdafx.h"
+#include <vector>
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+// Texture Cache Class
+// Direct3D 11 side of texture streaming: one DEFAULT texture per streamed texture holding
+// exactly its resident mips [firstMip, mipCount), so evicted levels give their memory back.
+// Direct3D 11 has no partially resident (tiled) textures at feature level 11_0, so changing
+// the resident range creates a texture of the new size, uploads the new levels, copies the
+// levels it keeps on the GPU and swaps the view. Textures with nothing resident yet sample
+// a 1x1 white texture.
+class TextureCache : public TextureStreamer::Uploader {
+  public:
+    TextureCache()           = default;
+    ~TextureCache() override = default;
+
+    TextureCache(const TextureCache&)            = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // Create the white fallback texture and the shared sampler
+    bool Initialize(ID3D11Device* device, ID3D11DeviceContext* context);
+
+    // View of a streamed texture's resident mips, or the white texture
+    ID3D11ShaderResourceView* GetView(uint32_t texture) const {
+        return texture < entries.size() && entries[texture].view ? entries[texture].view.Get()
+                                                                 : whiteView.Get();
+    }
+
+    // Trilinear anisotropic, wrapping
+    ID3D11SamplerState* GetSampler() const {
+        return samplerState.Get();
+    }
+
+    // TextureStreamer::Uploader interface
+    bool UploadMips(uint32_t texture,
+                    const TextureDesc& desc,
+                    uint32_t firstMip,
+                    uint32_t endMip,
+                    const uint8_t* data) override;
+    void Evict(uint32_t texture, const TextureDesc& desc, uint32_t firstMip) override;
+
+  private:
+    struct Entry {
+        ComPtr<ID3D11Texture2D> texture; // Mip 0 is the streamed texture's firstMip
+        ComPtr<ID3D11ShaderResourceView> view;
+        uint32_t firstMip = 0;
+    };
+
+    ID3D11Device* device         = nullptr;
+    ID3D11DeviceContext* context = nullptr;
+    std::vector<Entry> entries; // Indexed by streamer handle
+    ComPtr<ID3D11ShaderResourceView> whiteView;
+    ComPtr<ID3D11SamplerState> samplerState;
+
+    /*
+    Replace an entry's texture with one holding mips [firstMip, desc.mipCount): levels
+    [firstMip, endMip) from data, the rest copied from the current texture
+    */
+    bool Rebuild(uint32_t texture,
+                 const TextureDesc& desc,
+                 uint32_t firstMip,
+                 uint32_t endMip,
+                 const uint8_t* data);
+};
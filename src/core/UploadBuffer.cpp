@@ -0,0 +1,184 @@
+#include "UploadBuffer.h"
+#include "utils/Logger.h"
+#include <cstring>
+#include <emmintrin.h>
+
+UploadBuffer::UploadBuffer() {}
+
+UploadBuffer::~UploadBuffer() {}
+
+bool UploadBuffer::Initialize(ID3D11Device* device, UINT capacity) {
+    // ========================================
+    // 1. CREATE THE PERSISTENT DYNAMIC BUFFER
+    // ========================================
+    // DYNAMIC + CPU_ACCESS_WRITE lets us Map it every frame instead of calling CreateBuffer
+    // Vertex and index bind flags may be combined, so one ring serves both streams
+    D3D11_BUFFER_DESC desc = {};
+    desc.Usage             = D3D11_USAGE_DYNAMIC;
+    desc.ByteWidth         = capacity;
+    desc.BindFlags         = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_INDEX_BUFFER;
+    desc.CPUAccessFlags    = D3D11_CPU_ACCESS_WRITE;
+
+    HRESULT hr = device->CreateBuffer(&desc, nullptr, buffer.GetAddressOf());
+    if (FAILED(hr)) {
+        LOG_ERROR("Failed to create upload buffer! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+        return false;
+    }
+
+    // ========================================
+    // 2. CREATE FENCE QUERIES
+    // ========================================
+    // D3D11 has no fences; an EVENT query signals once the GPU has consumed all prior commands
+    D3D11_QUERY_DESC queryDesc = {};
+    queryDesc.Query            = D3D11_QUERY_EVENT;
+    for (UINT i = 0; i < FramesInFlight; ++i) {
+        hr = device->CreateQuery(&queryDesc, fences[i].GetAddressOf());
+        if (FAILED(hr)) {
+            LOG_ERROR("Failed to create upload fence query!");
+            return false;
+        }
+        fenceValues[i] = 0;
+    }
+
+    ring.Initialize(capacity, nullptr);
+    frameIndex     = 1;
+    completedFence = 0;
+    firstMap       = true;
+    return true;
+}
+
+void UploadBuffer::PollFences(ID3D11DeviceContext* context) {
+    for (UINT i = 0; i < FramesInFlight; ++i) {
+        if (fenceValues[i] == 0 || fenceValues[i] <= completedFence) {
+            continue;
+        }
+        BOOL done = FALSE;
+        if (context->GetData(fences[i].Get(),
+                             &done,
+                             sizeof(done),
+                             D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK &&
+            done) {
+            completedFence = fenceValues[i] > completedFence ? fenceValues[i] : completedFence;
+        }
+    }
+}
+
+bool UploadBuffer::WaitForFence(ID3D11DeviceContext* context, UINT slot) {
+    // The first poll flushes so the query is guaranteed to reach the GPU; later polls only
+    // check it, backing off from a pause to yielding the core while the GPU catches up
+    UINT flags = 0;
+    for (uint32_t spins = 0;; ++spins) {
+        BOOL done  = FALSE;
+        HRESULT hr = context->GetData(fences[slot].Get(), &done, sizeof(done), flags);
+        if (FAILED(hr)) {
+            // Device removed or reset: the query will never signal
+            LOG_ERROR("Upload fence wait failed! HRESULT: 0x%08X", static_cast<unsigned>(hr));
+            return false;
+        }
+        if (hr == S_OK && done) {
+            return true;
+        }
+        flags = D3D11_ASYNC_GETDATA_DONOTFLUSH;
+        if (spins < 64) {
+            _mm_pause();
+        } else {
+            SwitchToThread();
+        }
+    }
+}
+
+bool UploadBuffer::BeginFrame(ID3D11DeviceContext* context) {
+    if (!buffer) {
+        return false;
+    }
+
+    // Release ring space owned by frames the GPU has finished with
+    PollFences(context);
+    ring.Retire(completedFence);
+
+    // If the slot we are about to reuse is still busy, wait for it: this is the
+    // frames-in-flight throttle and only triggers when the GPU is far behind
+    UINT slot = static_cast<UINT>(frameIndex % FramesInFlight);
+    if (fenceValues[slot] > completedFence) {
+        if (!WaitForFence(context, slot)) {
+            return false;
+        }
+        completedFence = fenceValues[slot];
+        ring.Retire(completedFence);
+    }
+    ring.BeginFrame();
+    return Map(context);
+}
+
+bool UploadBuffer::Map(ID3D11DeviceContext* context) {
+    if (mapped) {
+        return true;
+    }
+
+    // The very first Map of a dynamic buffer must be DISCARD; afterwards the fences
+    // guarantee we only write unused regions, so NO_OVERWRITE avoids any driver rename
+    D3D11_MAP mapType = firstMap ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+
+    D3D11_MAPPED_SUBRESOURCE mappedData = {};
+    HRESULT hr                          = context->Map(buffer.Get(), 0, mapType, 0, &mappedData);
+    if (FAILED(hr)) {
+        ring.SetCpuBase(nullptr);
+        return false;
+    }
+    firstMap   = false;
+    mapped     = true;
+    mappedBase = static_cast<uint8_t*>(mappedData.pData);
+    mappedHead = ring.GetHead();
+    ring.SetCpuBase(mappedData.pData);
+    return true;
+}
+
+void UploadBuffer::RecordWrites() {
+    // Everything allocated since the Map, wrap-around padding included; split in two where
+    // it crosses the end of the ring
+    const uint64_t capacity = ring.GetCapacity();
+    const uint64_t written  = ring.GetHead() - mappedHead;
+    if (written >= capacity) {
+        capture->RecordBufferData(buffer.Get(), 0, mappedBase, capacity);
+        return;
+    }
+    const uint64_t start = mappedHead % capacity;
+    const uint64_t first = written < capacity - start ? written : capacity - start;
+    capture->RecordBufferData(
+        buffer.Get(), static_cast<uint32_t>(start), mappedBase + start, first);
+    capture->RecordBufferData(buffer.Get(), 0, mappedBase, written - first);
+}
+
+void UploadBuffer::Unmap(ID3D11DeviceContext* context) {
+    if (mapped) {
+        if (capture && capture->IsCapturing()) {
+            RecordWrites();
+        }
+        context->Unmap(buffer.Get(), 0);
+        ring.SetCpuBase(nullptr);
+        mapped = false;
+    }
+}
+
+void UploadBuffer::EndFrame(ID3D11DeviceContext* context) {
+    if (!buffer) {
+        return;
+    }
+    Unmap(context);
+
+    UINT slot = static_cast<UINT>(frameIndex % FramesInFlight);
+    context->End(fences[slot].Get());
+    fenceValues[slot] = frameIndex;
+    ring.EndFrame(frameIndex);
+    ++frameIndex;
+}
+
+bool UploadBuffer::Upload(const void* data, UINT bytes, UINT alignment, UINT* outOffset) {
+    RingAllocator::Allocation allocation = ring.Allocate(bytes, alignment);
+    if (!allocation.IsValid()) {
+        return false;
+    }
+    std::memcpy(allocation.cpuPtr, data, bytes);
+    *outOffset = static_cast<UINT>(allocation.offset);
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "memory/RingAllocator.h"
+#include "render/FrameCapture.h"
+#include "utils/stdafx.h"
+#include <wrl/client.h>
+
+using Microsoft::WRL::ComPtr;
+
+// Dynamic Upload Buffer Class
+// One long-lived D3D11_USAGE_DYNAMIC buffer, bindable as vertex and index data, sub-allocated
+// every frame through a RingAllocator. Event queries act as fences so the CPU never overwrites
+// a region the GPU may still be reading, which lets every Map use WRITE_NO_OVERWRITE.
+class UploadBuffer {
+  public:
+    // Frames the CPU may run ahead of the GPU before allocations start failing
+    static constexpr uint32_t FramesInFlight = 3;
+    // BeginFrame's throttle keeps the ring's pending-frame list from ever filling up
+    static_assert(FramesInFlight < RingAllocator::MaxFramesInFlight,
+                  "Upload frames in flight exceed the ring's pending-frame bookkeeping");
+
+    UploadBuffer();
+    ~UploadBuffer();
+
+    /*
+    Create the backing buffer and fence queries
+    device: Device used to create resources
+    capacity: Size of the ring in bytes
+    */
+    bool Initialize(ID3D11Device* device, UINT capacity);
+
+    // Retire finished frames and map the buffer for writing; false if the device was lost
+    bool BeginFrame(ID3D11DeviceContext* context);
+
+    // Re-map after an Unmap within the same frame (no-op when already mapped)
+    bool Map(ID3D11DeviceContext* context);
+
+    // Unmap the buffer; must be called before any draw that reads from it
+    void Unmap(ID3D11DeviceContext* context);
+
+    // Unmap (if needed) and issue this frame's fence
+    void EndFrame(ID3D11DeviceContext* context);
+
+    /*
+    Copy data into the ring
+    Returns false when the ring is full; outOffset receives the byte offset to bind with
+    */
+    bool Upload(const void* data, UINT bytes, UINT alignment, UINT* outOffset);
+
+    // Reserve space without copying; write through the returned cpuPtr before Unmap
+    RingAllocator::Allocation Allocate(UINT bytes, UINT alignment) {
+        return ring.Allocate(bytes, alignment);
+    }
+
+    ID3D11Buffer* GetBuffer() const {
+        return buffer.Get();
+    }
+    const RingAllocator& GetAllocator() const {
+        return ring;
+    }
+
+    // While capture is capturing, each Unmap records the bytes written since the Map
+    void SetCapture(FrameCapture* capture) {
+        this->capture = capture;
+    }
+
+  private:
+    ComPtr<ID3D11Buffer> buffer;
+    ComPtr<ID3D11Query> fences[FramesInFlight]; // D3D11_QUERY_EVENT per frame slot
+    uint64_t fenceValues[FramesInFlight] = {};
+
+    RingAllocator ring;
+    uint64_t frameIndex     = 0; // Fence value of the frame being recorded
+    uint64_t completedFence = 0; // Highest fence known to be finished on the GPU
+    bool mapped             = false;
+    bool firstMap           = true;
+
+    FrameCapture* capture = nullptr;
+    uint8_t* mappedBase   = nullptr;
+    uint64_t mappedHead   = 0; // Ring head at Map
+
+    void RecordWrites();
+
+    void PollFences(ID3D11DeviceContext* context);
+
+    // Block until the fence in slot has signalled; false if the device was lost
+    bool WaitForFence(ID3D11DeviceContext* context, UINT slot);
+};
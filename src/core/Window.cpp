@@ -1,4 +1,6 @@
 #include "Window.h"
+#include "utils/Profiler.h"
+#include <chrono>
 
 Window::Window() : hwnd(nullptr) {}
 
@@ -13,11 +15,32 @@ Window::~Window() {
 // msg: Message type (WM_CREATE, WM_DESTROY, etc.)
 // wParam, lParam: Additional data passed with the message
 LRESULT CALLBACK Window::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    // The Window object arrives with WM_NCCREATE and is kept in the window's user data
+    if (msg == WM_NCCREATE) {
+        auto create = reinterpret_cast<CREATESTRUCTW*>(lParam);
+        SetWindowLongPtrW(hwnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(create->lpCreateParams));
+    }
+    Window* window = reinterpret_cast<Window*>(GetWindowLongPtrW(hwnd, GWLP_USERDATA));
+
     switch (msg) {
     case WM_KEYDOWN: // When a key is pressed
+        // Bit 30 of lParam is set for auto-repeat; only the first press is a transition
+        if (window && (lParam & (1 << 30)) == 0) {
+            window->ForwardKey(InputEvent::KeyDown, wParam);
+        }
         if (wParam == VK_ESCAPE) { // If ESC key is pressed
             DestroyWindow(hwnd);
         }
+#if PROFILING_ENABLED
+        if (wParam == VK_F12) { // Write a Chrome trace of the buffered frames
+            Profiler::Get().RequestExport("profile_trace.json");
+        }
+#endif
+        return 0;
+    case WM_KEYUP: // When a key is released
+        if (window) {
+            window->ForwardKey(InputEvent::KeyUp, wParam);
+        }
         return 0;
     case WM_CLOSE: // When the close button is clicked
         DestroyWindow(hwnd);
@@ -56,7 +79,7 @@ bool Window::Initialize(const wchar_t* title, int width, int height) {
                         nullptr,             // No parent window
                         nullptr,             // No menu
                         GetModuleHandle(nullptr), // Handle to the current program instance
-                        nullptr);                 // No additional data
+                        this);                    // Passed to WM_NCCREATE for WindowProc
 
     // Check if window creation failed
     if (!hwnd) {
@@ -82,4 +105,16 @@ bool Window::ProcessMessages() {
         DispatchMessage(&msg);  // Send messages to the window procedure
     }
     return true; // Continue execution
-}
\ No newline at end of file
+}
+
+void Window::ForwardKey(InputEvent::Type type, WPARAM key) {
+    if (!inputQueue) {
+        return;
+    }
+    using namespace std::chrono;
+    InputEvent event;
+    event.type = type;
+    event.key  = static_cast<uint32_t>(key);
+    event.time = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    inputQueue->Push(event);
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "scene/Simulation.h"
 #include "utils/stdafx.h"
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -24,8 +25,18 @@ class Window {
     // Returns false to terminate program
     bool ProcessMessages();
 
+    // Forward key presses and releases into queue (nullptr stops forwarding)
+    // ProcessMessages is then the queue's only producer
+    void SetInputQueue(InputQueue* queue) {
+        inputQueue = queue;
+    }
+
    private:
-    HWND hwnd; // Window Handle
+    HWND hwnd;                        // Window Handle
+    InputQueue* inputQueue = nullptr; // Receives key events, see SetInputQueue
+
+    // Time-stamp a key transition and queue it; dropped if the queue is full
+    void ForwardKey(InputEvent::Type type, WPARAM key);
 
     // Window Procedure: Process Window Messages Function
     static LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
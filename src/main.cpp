@@ -1,32 +1,164 @@
 #include "core/Graphics.h"
 #include "core/Window.h"
+#include "scene/BenchmarkScene.h"
+#include "utils/Logger.h"
+#include "utils/Profiler.h"
+#include <cstdlib>
+#include <cstring>
 
-int main() {
-    std::cout << "Application starting...\n";
+// Write out queued log lines before blocking on the console
+static int ExitWithPrompt() {
+    Logger::Get().Flush();
+    std::cout << "Press Enter to exit...\n";
+    std::cin.get();
+    return -1;
+}
+
+int main(int argc, char** argv) {
+    LOG_INFO("Application starting...");
+
+    // --instances N: draw N instanced copies of the triangle and log the submission cost
+    // --objects N: draw N copies of the triangle, one draw and constants slot each
+    // --sprites N: draw N batched sprites from a generated atlas and log quads/s and draws
+    // --fps N: cap the frame rate (use the refresh rate with vsync)
+    // --low-latency: start frames just in time for the --fps deadline, frame latency 1
+    // --no-vsync: present at once, tearing where supported
+    // --buffers N, --latency N: swap chain back buffers and queued frames
+    // --tick-rate N: simulation ticks per second (default 60)
+    // --texture PATH: draw the triangle with a streamed DDS/KTX2 texture
+    // --texture-budget MB: video memory the streamed mips may use (default 256)
+    // --capture-every N: write every Nth frame to a capture file (see tools/FrameReplay)
+    // --capture-dir PATH: directory for the capture files (default: working directory)
+    uint32_t instanceCount  = 0;
+    uint32_t objectCount    = 0;
+    uint32_t spriteCount    = 0;
+    uint32_t captureEvery   = 0;
+    double tickRate         = 60.0;
+    const char* texturePath = nullptr;
+    const char* captureDir  = ".";
+    PresentDesc presentDesc;
+    FramePacer::Settings pacing;
+    TextureStreamer::Settings streaming;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--instances") == 0 && hasValue) {
+            instanceCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--objects") == 0 && hasValue) {
+            objectCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--sprites") == 0 && hasValue) {
+            spriteCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--fps") == 0 && hasValue) {
+            pacing.targetFps = strtod(argv[++i], nullptr);
+        } else if (strcmp(argv[i], "--low-latency") == 0) {
+            pacing.lowLatency           = true;
+            presentDesc.maxFrameLatency = 1;
+        } else if (strcmp(argv[i], "--no-vsync") == 0) {
+            presentDesc.vsync = false;
+        } else if (strcmp(argv[i], "--buffers") == 0 && hasValue) {
+            presentDesc.bufferCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--latency") == 0 && hasValue) {
+            presentDesc.maxFrameLatency = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--tick-rate") == 0 && hasValue) {
+            tickRate = strtod(argv[++i], nullptr);
+        } else if (strcmp(argv[i], "--texture") == 0 && hasValue) {
+            texturePath = argv[++i];
+        } else if (strcmp(argv[i], "--texture-budget") == 0 && hasValue) {
+            streaming.budgetBytes = strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+        } else if (strcmp(argv[i], "--capture-every") == 0 && hasValue) {
+            captureEvery = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--capture-dir") == 0 && hasValue) {
+            captureDir = argv[++i];
+        }
+    }
 
     Window window;
     if (!window.Initialize(L"Graphics", 800, 600)) {
-        std::cout << "ERROR: Window initialization failed\n";
-        std::cout << "Press Enter to exit...\n";
-        std::cin.get();
-        return -1;
+        LOG_ERROR("Window initialization failed");
+        return ExitWithPrompt();
     }
-    std::cout << "SUCCESS: Window created!\n";
+    LOG_INFO("Window created");
 
     Graphics graphics;
+    graphics.SetPresentDesc(presentDesc);
+    graphics.SetFramePacing(pacing);
+    graphics.SetTextureStreaming(streaming);
     if (!graphics.Initialize(window.GetHandle(), 800, 600)) {
-        std::cout << "ERROR: Graphics initialization failed\n";
-        std::cout << "Press Enter to exit...\n";
-        std::cin.get();
-        return -1;
+        LOG_ERROR("Graphics initialization failed");
+        return ExitWithPrompt();
+    }
+    LOG_INFO("Graphics initialized");
+    graphics.SetFrameCapture(captureEvery, captureDir);
+    if (texturePath) {
+        graphics.SetSceneMaterial(graphics.LoadTexture(texturePath));
     }
-    std::cout << "SUCCESS: Graphics initialized!\n";
 
-    std::cout << "Starting render loop...\n";
-    while (window.ProcessMessages()) {
+    // Benchmark content, re-submitted unchanged every frame
+    InstanceScene instanceScene;
+    instanceScene.Build(instanceCount);
+    if (instanceCount > 0) {
+        LOG_INFO("Instance benchmark: %u instances", instanceCount);
+    }
+    ObjectScene objectScene;
+    objectScene.Build(objectCount);
+    if (objectCount > 0) {
+        LOG_INFO("Object benchmark: %u draws with per-object constants", objectCount);
+    }
+    SpriteScene spriteScene;
+    if (spriteCount > 0 && !spriteScene.BuildAtlas()) {
+        LOG_ERROR("Sprite benchmark atlas does not fit in 1024x1024");
+    } else if (spriteCount > 0) {
+        const TextureAtlas& atlas = spriteScene.atlas;
+        const uint32_t texture    = graphics.CreateSpriteTexture(atlas.GetPixels().data(),
+                                                              atlas.GetWidth(),
+                                                              atlas.GetHeight());
+        spriteScene.Build(spriteCount, 800, 600, texture);
+        graphics.GetSpriteBatch().Reserve(spriteCount);
+        LOG_INFO("Sprite benchmark: %u sprites, atlas %ux%u, %.0f%% occupied",
+                 spriteCount,
+                 atlas.GetWidth(),
+                 atlas.GetHeight(),
+                 atlas.GetOccupancy() * 100.0f);
+    }
+
+    // The scene is simulated at a fixed rate on its own thread; the window forwards key
+    // events to it and every frame draws its latest ticks, interpolated
+    Simulation simulation;
+    window.SetInputQueue(&simulation.GetInputQueue());
+    if (!simulation.Start(tickRate)) {
+        LOG_ERROR("Simulation failed to start (tick rate %.1f)", tickRate);
+        return ExitWithPrompt();
+    }
+    LOG_INFO("Simulation running at %.1f ticks per second", tickRate);
+
+    LOG_INFO("Starting render loop...");
+    for (;;) {
+        // Wait for the swap chain and the pacer first, so the input read by
+        // ProcessMessages is as recent as possible when the frame is built
+        graphics.WaitForNextFrame();
+        if (!window.ProcessMessages()) {
+            break;
+        }
+        graphics.SetSceneState(simulation.Sample());
+        graphics.DrawInstances(instanceScene.GetSource(), instanceScene.count);
+        graphics.DrawObjects(objectScene.world.data(), objectCount);
+        if (!spriteScene.sprites.empty()) {
+            spriteScene.Animate();
+            graphics.GetSpriteBatch().Draw(spriteScene.sprites.data(),
+                                           static_cast<uint32_t>(spriteScene.sprites.size()));
+        }
         graphics.Render();
+        PROFILE_END_FRAME(); // Roll frame statistics, write a trace if F12 was pressed
     }
 
-    std::cout << "Application ending normally.\n";
+    simulation.Stop();
+    window.SetInputQueue(nullptr);
+    Simulation::Stats simulationStats = simulation.GetStats();
+    LOG_INFO("Simulation: %llu ticks (%llu skipped), %llu inputs, longest input wait %.2f ms",
+             static_cast<unsigned long long>(simulationStats.ticks),
+             static_cast<unsigned long long>(simulationStats.skipped),
+             static_cast<unsigned long long>(simulationStats.inputs),
+             static_cast<double>(simulationStats.maxInputWait) * 1e-6);
+
+    LOG_INFO("Application ending normally.");
     return 0;
 }
\ No newline at end of file
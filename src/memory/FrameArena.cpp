@@ -0,0 +1,158 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Indexed by MemoryTag
+const char* const TagNames[] = {"General", "RenderQueue", "Instances", "Culling"};
+static_assert(sizeof(TagNames) / sizeof(TagNames[0]) == MemoryTagCount, "one name per tag");
+
+// Thread slots of every FrameArena: the lowest never handed out, plus those freed by exited
+// threads. Only a thread's first allocation and its exit touch it
+struct SlotRegistry {
+    std::mutex mutex;
+    std::vector<uint32_t> released;
+    uint32_t next = 0;
+
+    static SlotRegistry& Get() {
+        static SlotRegistry registry;
+        return registry;
+    }
+};
+
+// Holds the calling thread's slot; thread_local, so it is given back when the thread exits.
+// The registry is constructed before the first holder, so it outlives them all
+struct SlotHolder {
+    uint32_t slot;
+
+    SlotHolder() {
+        SlotRegistry& registry = SlotRegistry::Get();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (registry.released.empty()) {
+            slot = registry.next++;
+        } else {
+            // Lowest first, so a slot below MaxThreads is never passed over for one above it
+            auto lowest = std::min_element(registry.released.begin(), registry.released.end());
+            slot        = *lowest;
+            *lowest     = registry.released.back();
+            registry.released.pop_back();
+        }
+    }
+    ~SlotHolder() {
+        SlotRegistry& registry = SlotRegistry::Get();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.released.push_back(slot);
+    }
+};
+
+} // namespace
+
+const char* MemoryTagName(MemoryTag tag) {
+    return tag < MemoryTag::Count ? TagNames[static_cast<uint32_t>(tag)] : "?";
+}
+
+FrameArena::FrameArena() {
+    for (uint32_t i = 0; i < MemoryTagCount; ++i) {
+        resources[i].arena = this;
+        resources[i].tag   = static_cast<MemoryTag>(i);
+    }
+}
+
+FrameArena::~FrameArena() {}
+
+uint32_t FrameArena::ThreadSlot() {
+    // A slot freed mid-frame keeps its arena's contents: the next owner allocates after them
+    thread_local SlotHolder holder;
+    return holder.slot;
+}
+
+void FrameArena::ThreadArena::Reset() {
+    arena.Reset();
+    allocations = 0;
+    std::fill(std::begin(tagBytes), std::end(tagBytes), 0);
+}
+
+// ========================================
+// 1. FRAMES
+// ========================================
+
+void FrameArena::BeginFrame() {
+    // Close the frame that just ended: its totals become the reported stats
+    Stats finished;
+    Sum(frames[frameIndex], finished);
+    finished.highWater = std::max(stats.highWater, finished.bytesUsed);
+    for (uint32_t tag = 0; tag < MemoryTagCount; ++tag) {
+        finished.tagHighWater[tag] = std::max(stats.tagHighWater[tag], finished.tagBytes[tag]);
+    }
+
+    // The next frame's arenas were last used FrameCount - 1 frames ago
+    frameIndex  = (frameIndex + 1) % FrameCount;
+    Frame& next = frames[frameIndex];
+    for (ThreadArena& thread : next.threads) {
+        thread.Reset();
+    }
+    next.shared.Reset();
+
+    finished.bytesReserved = 0;
+    for (const Frame& frame : frames) {
+        for (const ThreadArena& thread : frame.threads) {
+            finished.bytesReserved += thread.arena.GetBytesReserved();
+        }
+        finished.bytesReserved += frame.shared.arena.GetBytesReserved();
+    }
+    stats = finished;
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment, MemoryTag tag) {
+    const uint32_t slot = ThreadSlot();
+    const uint32_t t    = static_cast<uint32_t>(tag);
+    Frame& frame        = frames[frameIndex];
+    if (slot < MaxThreads) {
+        ThreadArena& thread = frame.threads[slot];
+        ++thread.allocations;
+        thread.tagBytes[t] += size;
+        return thread.arena.Allocate(size, alignment);
+    }
+
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    ++frame.shared.allocations;
+    frame.shared.tagBytes[t] += size;
+    return frame.shared.arena.Allocate(size, alignment);
+}
+
+// ========================================
+// 2. STATISTICS
+// ========================================
+
+FrameArena::Stats FrameArena::GetStats() const {
+    return stats;
+}
+
+void FrameArena::Sum(const Frame& frame, Stats& totals) {
+    auto add = [&totals](const ThreadArena& thread) {
+        totals.bytesUsed += thread.arena.GetBytesUsed();
+        totals.allocations += thread.allocations;
+        for (uint32_t tag = 0; tag < MemoryTagCount; ++tag) {
+            totals.tagBytes[tag] += thread.tagBytes[tag];
+        }
+    };
+
+    for (const ThreadArena& thread : frame.threads) {
+        add(thread);
+    }
+    add(frame.shared);
+    totals.sharedAllocations += frame.shared.allocations;
+}
+
+void FrameArena::Release() {
+    for (Frame& frame : frames) {
+        for (ThreadArena& thread : frame.threads) {
+            thread.Reset();
+            thread.arena.Release();
+        }
+        frame.shared.Reset();
+        frame.shared.arena.Release();
+    }
+    stats.bytesReserved = 0;
+}
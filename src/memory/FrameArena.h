@@ -0,0 +1,117 @@
+#pragma once
+#include "LinearArena.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+
+// What transient memory is used for; FrameArena keeps byte counts per tag
+enum class MemoryTag : uint32_t { General = 0, RenderQueue, Instances, Culling, Count };
+
+constexpr uint32_t MemoryTagCount = static_cast<uint32_t>(MemoryTag::Count);
+
+// Display name of tag ("General", "RenderQueue", ...)
+const char* MemoryTagName(MemoryTag tag);
+
+// Frame Arena Class
+// Transient memory that lives for exactly one frame and is released all at once. There is one
+// set of arenas per frame in flight: BeginFrame() rewinds the set used FrameCount frames ago,
+// so data written in a frame stays valid while later frames are being built (e.g. by a
+// pipelined render thread). Within a frame every thread allocates from its own LinearArena,
+// so job workers never contend or share cache lines. A thread takes a slot on its first
+// allocation and hands it back when it exits, for the next new thread to reuse; threads
+// beyond MaxThreads alive at once share one locked arena.
+//
+// GetResource(tag) adapts the arena to std::pmr::memory_resource, so standard containers can
+// use it: std::pmr::vector<T> v(arena.GetResource(MemoryTag::Culling)). Deallocation is a
+// no-op; such containers must not outlive the frame.
+class FrameArena {
+  public:
+    static constexpr uint32_t FrameCount = 3; // Matches UploadBuffer::FramesInFlight
+    static constexpr uint32_t MaxThreads = 32;
+
+    // Totals of the last finished frame, plus high-water marks over every frame so far
+    struct Stats {
+        uint64_t bytesUsed                    = 0; // All threads, including padding
+        uint64_t allocations                  = 0;
+        uint64_t sharedAllocations            = 0; // Of those, made in the locked arena
+        uint64_t highWater                    = 0; // Largest bytesUsed of any frame
+        uint64_t bytesReserved                = 0; // Chunk memory held by all frames
+        uint64_t tagBytes[MemoryTagCount]     = {};
+        uint64_t tagHighWater[MemoryTagCount] = {};
+    };
+
+    FrameArena();
+    ~FrameArena();
+
+    FrameArena(const FrameArena&)            = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /*
+    Finish the current frame's statistics and move to the next frame's arenas, rewinding them
+    Memory from FrameCount frames ago is reused. Call with no other thread allocating.
+    */
+    void BeginFrame();
+
+    // Allocate from the calling thread's arena of the current frame
+    void* Allocate(size_t size, size_t alignment, MemoryTag tag = MemoryTag::General);
+
+    template <typename T>
+    T* AllocateArray(size_t count, MemoryTag tag = MemoryTag::General) {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T), tag));
+    }
+
+    // pmr adapter allocating with tag from the current frame; valid for this arena's lifetime
+    std::pmr::memory_resource* GetResource(MemoryTag tag) {
+        return &resources[static_cast<uint32_t>(tag)];
+    }
+
+    // Read with no other thread allocating (e.g. right after BeginFrame)
+    Stats GetStats() const;
+
+    // Return all chunk memory to the heap (between frames, e.g. after a level unload)
+    void Release();
+
+  private:
+    // One thread's arena for one frame, on its own cache lines
+    struct alignas(64) ThreadArena {
+        LinearArena arena;
+        uint64_t allocations              = 0;
+        uint64_t tagBytes[MemoryTagCount] = {};
+
+        void Reset();
+    };
+
+    struct Frame {
+        ThreadArena threads[MaxThreads];
+        ThreadArena shared; // For threads past MaxThreads, guarded by sharedMutex
+    };
+
+    class Resource : public std::pmr::memory_resource {
+      public:
+        FrameArena* arena = nullptr;
+        MemoryTag tag     = MemoryTag::General;
+
+      private:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            return arena->Allocate(bytes, alignment, tag);
+        }
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    Frame frames[FrameCount];
+    uint32_t frameIndex = 0;
+    std::mutex sharedMutex;
+    Resource resources[MemoryTagCount];
+    Stats stats;
+
+    // Process-wide index of the calling thread, assigned on first use and returned to a free
+    // list when the thread exits
+    static uint32_t ThreadSlot();
+
+    static void Sum(const Frame& frame, Stats& totals);
+};
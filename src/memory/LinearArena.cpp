@@ -0,0 +1,53 @@
+#include "LinearArena.h"
+#include <algorithm>
+
+void* LinearArena::AllocateSlow(size_t size, size_t alignment) {
+    // Move on to the next chunk that can hold the request (chunks kept by Reset are reused
+    // in order), or add one big enough for it
+    const size_t needed = size + alignment - 1;
+    size_t next         = cursor == 0 ? 0 : chunkIndex + 1;
+    while (next < chunks.size() && chunks[next].size < needed) {
+        ++next;
+    }
+    if (next >= chunks.size()) {
+        Chunk chunk;
+        chunk.size   = std::max(chunkSize, needed);
+        chunk.memory = std::make_unique<uint8_t[]>(chunk.size);
+        reserved += chunk.size;
+        chunks.push_back(std::move(chunk));
+        next = chunks.size() - 1;
+    }
+
+    // Whatever was left in the chunk being abandoned counts as used: it is lost until Reset
+    if (cursor != 0) {
+        used += limit - cursor;
+    }
+    chunkIndex = next;
+    cursor     = reinterpret_cast<uintptr_t>(chunks[next].memory.get());
+    limit      = cursor + chunks[next].size;
+    return Allocate(size, alignment);
+}
+
+void LinearArena::Reset() {
+    // A frame that needed several chunks gets them replaced by one of the combined size
+    if (chunks.size() > 1) {
+        Chunk merged;
+        merged.size   = reserved;
+        merged.memory = std::make_unique<uint8_t[]>(merged.size);
+        chunks.clear();
+        chunks.push_back(std::move(merged));
+    }
+    chunkIndex = 0;
+    cursor     = 0;
+    limit      = 0;
+    used       = 0;
+}
+
+void LinearArena::Release() {
+    chunks.clear();
+    chunkIndex = 0;
+    cursor     = 0;
+    limit      = 0;
+    used       = 0;
+    reserved   = 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Linear Arena Class
+// Single-threaded bump allocator over heap chunks. Allocation is a pointer bump; nothing is
+// freed individually, Reset() rewinds everything at once. When the current chunk runs out
+// a new one is added, and Reset() folds a multi-chunk arena into one chunk of the combined
+// size, so a steady workload settles on one chunk and never allocates from the heap again.
+class LinearArena {
+  public:
+    static constexpr size_t DefaultChunkSize = 64 * 1024;
+
+    explicit LinearArena(size_t chunkSize = DefaultChunkSize) : chunkSize(chunkSize) {}
+
+    LinearArena(const LinearArena&)            = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    /*
+    Reserve size bytes aligned to alignment (a power of two)
+    Never fails short of the heap itself
+    */
+    void* Allocate(size_t size, size_t alignment) {
+        uintptr_t aligned = (cursor + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        if (aligned + size > limit || cursor == 0) {
+            return AllocateSlow(size, alignment);
+        }
+        used += aligned + size - cursor;
+        cursor = aligned + size;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Rewind to empty; every pointer handed out becomes invalid
+    void Reset();
+
+    // Return every chunk to the heap
+    void Release();
+
+    // Bytes handed out since the last Reset, including alignment padding
+    size_t GetBytesUsed() const {
+        return used;
+    }
+    // Bytes held in chunks
+    size_t GetBytesReserved() const {
+        return reserved;
+    }
+
+  private:
+    struct Chunk {
+        std::unique_ptr<uint8_t[]> memory;
+        size_t size;
+    };
+
+    size_t chunkSize;
+    std::vector<Chunk> chunks;
+    size_t chunkIndex = 0; // Chunk that cursor points into
+    uintptr_t cursor  = 0; // Next free byte; 0 before the first allocation
+    uintptr_t limit   = 0; // End of the current chunk
+    size_t used       = 0;
+    size_t reserved   = 0;
+
+    void* AllocateSlow(size_t size, size_t alignment);
+};
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Object Pool Class
+// Fixed-size slots for objects of one type, carved from blocks of BlockSize slots. Free slots
+// form an intrusive LIFO list, so Create and Destroy are a few instructions each, a
+// recently freed (cache-warm) slot is reused first, and objects never move. Blocks are only
+// returned to the heap by the destructor. Not thread-safe: give each thread its own pool.
+template <typename T, uint32_t BlockSize = 256>
+class ObjectPool {
+  public:
+    struct Stats {
+        uint32_t live      = 0; // Objects currently constructed
+        uint32_t highWater = 0; // Largest live count so far
+        uint32_t capacity  = 0; // Slots in all blocks
+    };
+
+    ObjectPool()  = default;
+    ~ObjectPool() = default; // Objects still alive are not destroyed, only their storage freed
+
+    ObjectPool(const ObjectPool&)            = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template <typename... Args>
+    T* Create(Args&&... args) {
+        if (!freeList) {
+            AddBlock();
+        }
+        Slot* slot = freeList;
+        freeList   = slot->next;
+        T* object  = new (slot->storage) T(std::forward<Args>(args)...);
+        if (++stats.live > stats.highWater) {
+            stats.highWater = stats.live;
+        }
+        return object;
+    }
+
+    // Destroy an object created by this pool (nullptr is ignored)
+    void Destroy(T* object) {
+        if (!object) {
+            return;
+        }
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = freeList;
+        freeList   = slot;
+        --stats.live;
+    }
+
+    // Make room for count objects in total without growing later
+    void Reserve(uint32_t count) {
+        while (stats.capacity < count) {
+            AddBlock();
+        }
+    }
+
+    Stats GetStats() const {
+        return stats;
+    }
+
+  private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    Slot* freeList = nullptr;
+    Stats stats;
+
+    void AddBlock() {
+        blocks.push_back(std::make_unique<Slot[]>(BlockSize));
+        Slot* block = blocks.back().get();
+
+        // Thread the new slots so the lowest address is handed out first
+        for (uint32_t i = 0; i + 1 < BlockSize; ++i) {
+            block[i].next = &block[i + 1];
+        }
+        block[BlockSize - 1].next = freeList;
+        freeList                  = block;
+        stats.capacity += BlockSize;
+    }
+};
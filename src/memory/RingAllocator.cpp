@@ -0,0 +1,123 @@
+#include "RingAllocator.h"
+#include <cassert>
+
+RingAllocator::RingAllocator()
+    : head(0),
+      tail(0),
+      statAllocations(0),
+      statFailed(0),
+      statBytes(0),
+      statPadding(0) {}
+
+void RingAllocator::Initialize(uint64_t capacityBytes, void* cpuBase) {
+    base         = static_cast<uint8_t*>(cpuBase);
+    capacity     = capacityBytes;
+    pendingFirst = 0;
+    pendingCount = 0;
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    BeginFrame();
+}
+
+RingAllocator::Allocation RingAllocator::Allocate(uint64_t bytes, uint64_t alignment) {
+    Allocation result;
+    if (bytes == 0 || bytes > capacity || base == nullptr) {
+        statFailed.fetch_add(1, std::memory_order_relaxed);
+        return result;
+    }
+    if (alignment == 0) {
+        alignment = 1;
+    }
+
+    // ========================================
+    // 1. RESERVE A RANGE WITH A CAS LOOP
+    // ========================================
+    // Work in virtual offsets so "full" is simply (newHead - tail) > capacity
+    uint64_t current = head.load(std::memory_order_relaxed);
+    uint64_t start   = 0;
+    uint64_t newHead = 0;
+    for (;;) {
+        uint64_t physical = current % capacity;
+        uint64_t aligned  = (physical + alignment - 1) & ~(alignment - 1);
+
+        // Not enough room before the end of the buffer: skip to the start (wrap-around)
+        if (aligned + bytes > capacity) {
+            aligned = 0;
+            start   = current + (capacity - physical);
+        } else {
+            start = current + (aligned - physical);
+        }
+        newHead = start + bytes;
+
+        // Would overwrite memory still owned by a frame in flight
+        if (newHead - tail.load(std::memory_order_acquire) > capacity) {
+            statFailed.fetch_add(1, std::memory_order_relaxed);
+            return result;
+        }
+
+        if (head.compare_exchange_weak(current,
+                                       newHead,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    // ========================================
+    // 2. FILL RESULT AND STATISTICS
+    // ========================================
+    result.offset = start % capacity;
+    result.cpuPtr = base + result.offset;
+
+    statAllocations.fetch_add(1, std::memory_order_relaxed);
+    statBytes.fetch_add(bytes, std::memory_order_relaxed);
+    statPadding.fetch_add(start - current, std::memory_order_relaxed);
+    return result;
+}
+
+void RingAllocator::BeginFrame() {
+    statAllocations.store(0, std::memory_order_relaxed);
+    statFailed.store(0, std::memory_order_relaxed);
+    statBytes.store(0, std::memory_order_relaxed);
+    statPadding.store(0, std::memory_order_relaxed);
+}
+
+bool RingAllocator::EndFrame(uint64_t fenceValue) {
+    // Too many frames in flight. The oldest frame must not be released here: the GPU may still
+    // be reading it. Fold this frame into the newest pending one instead, so its memory is
+    // held until the later fence completes and nothing is ever freed early.
+    assert(pendingCount < MaxFramesInFlight && "Retire() before closing more frames");
+    if (pendingCount == MaxFramesInFlight) {
+        uint32_t newest           = (pendingFirst + pendingCount - 1) % MaxFramesInFlight;
+        pending[newest].fence     = fenceValue;
+        pending[newest].headAtEnd = head.load(std::memory_order_acquire);
+        return false;
+    }
+
+    uint32_t slot           = (pendingFirst + pendingCount) % MaxFramesInFlight;
+    pending[slot].fence     = fenceValue;
+    pending[slot].headAtEnd = head.load(std::memory_order_acquire);
+    ++pendingCount;
+    return true;
+}
+
+void RingAllocator::Retire(uint64_t completedFence) {
+    while (pendingCount > 0 && pending[pendingFirst].fence <= completedFence) {
+        tail.store(pending[pendingFirst].headAtEnd, std::memory_order_release);
+        pendingFirst = (pendingFirst + 1) % MaxFramesInFlight;
+        --pendingCount;
+    }
+}
+
+uint64_t RingAllocator::GetBytesInUse() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+}
+
+RingAllocator::Stats RingAllocator::GetStats() const {
+    Stats stats;
+    stats.allocations       = statAllocations.load(std::memory_order_relaxed);
+    stats.failedAllocations = statFailed.load(std::memory_order_relaxed);
+    stats.bytesAllocated    = statBytes.load(std::memory_order_relaxed);
+    stats.bytesPadding      = statPadding.load(std::memory_order_relaxed);
+    return stats;
+}
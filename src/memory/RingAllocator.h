@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Ring Allocator Class
+// Lock-free bump allocator over one large upload region with wrap-around and
+// fence-based retirement. API-neutral: the owner supplies the CPU pointer of the
+// backing memory (a mapped GPU buffer, or plain system memory) and the fence values.
+class RingAllocator {
+  public:
+    // Maximum number of frames that may be recorded but not yet retired
+    static constexpr uint32_t MaxFramesInFlight = 8;
+
+    // Result of Allocate(); cpuPtr is nullptr when the ring is full
+    struct Allocation {
+        uint64_t offset = 0;       // Byte offset from the start of the backing buffer
+        void* cpuPtr    = nullptr; // Write pointer for the caller (base + offset)
+
+        bool IsValid() const {
+            return cpuPtr != nullptr;
+        }
+    };
+
+    // Counters for the current frame (reset in BeginFrame)
+    struct Stats {
+        uint64_t allocations       = 0; // Successful allocations
+        uint64_t failedAllocations = 0; // Allocations rejected because the ring was full
+        uint64_t bytesAllocated    = 0; // Payload bytes handed out
+        uint64_t bytesPadding      = 0; // Bytes lost to alignment and wrap-around (fragmentation)
+    };
+
+    RingAllocator();
+    ~RingAllocator() = default;
+
+    RingAllocator(const RingAllocator&)            = delete;
+    RingAllocator& operator=(const RingAllocator&) = delete;
+
+    /*
+    Attach the allocator to a backing region
+    capacity: Size of the region in bytes
+    cpuBase: CPU-visible base pointer (may be nullptr until SetCpuBase is called)
+    */
+    void Initialize(uint64_t capacity, void* cpuBase);
+
+    // Update the CPU base pointer (e.g. after a D3D11 Map returns a new address)
+    void SetCpuBase(void* cpuBase) {
+        base = static_cast<uint8_t*>(cpuBase);
+    }
+
+    /*
+    Reserve bytes aligned to alignment (must be a power of two)
+    Safe to call from multiple threads concurrently
+    */
+    Allocation Allocate(uint64_t bytes, uint64_t alignment);
+
+    // Render thread only: reset per-frame counters
+    void BeginFrame();
+
+    /*
+    Render thread only: close the current frame, tagging its allocations with fenceValue
+    Callers must Retire() so that fewer than MaxFramesInFlight frames are pending. If the
+    list is full anyway this asserts, merges the frame into the newest pending one (freed
+    only when fenceValue completes) and returns false
+    */
+    bool EndFrame(uint64_t fenceValue);
+
+    // Render thread only: release every frame whose fence is <= completedFence
+    void Retire(uint64_t completedFence);
+
+    uint64_t GetCapacity() const {
+        return capacity;
+    }
+    // Virtual offset the next allocation starts from (physical offset = head % capacity)
+    uint64_t GetHead() const {
+        return head.load(std::memory_order_acquire);
+    }
+    // Bytes currently owned by frames that have not been retired yet
+    uint64_t GetBytesInUse() const;
+    // Number of closed frames still waiting for their fence
+    uint32_t GetPendingFrames() const {
+        return pendingCount;
+    }
+    Stats GetStats() const;
+
+  private:
+    // A closed frame: everything below headAtEnd belongs to it until fence completes
+    struct PendingFrame {
+        uint64_t fence     = 0;
+        uint64_t headAtEnd = 0;
+    };
+
+    uint8_t* base     = nullptr;
+    uint64_t capacity = 0;
+
+    // Virtual offsets grow monotonically; physical offset = virtual % capacity
+    std::atomic<uint64_t> head; // Next free virtual offset (shared between producers)
+    std::atomic<uint64_t> tail; // Oldest virtual offset still in use
+
+    PendingFrame pending[MaxFramesInFlight];
+    uint32_t pendingFirst = 0;
+    uint32_t pendingCount = 0;
+
+    std::atomic<uint64_t> statAllocations;
+    std::atomic<uint64_t> statFailed;
+    std::atomic<uint64_t> statBytes;
+    std::atomic<uint64_t> statPadding;
+};
@@ -0,0 +1,58 @@
+#include "ConstantAllocator.h"
+#include <cstddef>
+
+void ConstantAllocator::BeginFrame() {
+    page     = 0;
+    used     = 0;
+    pageBase = nullptr;
+    stats    = Stats();
+}
+
+ConstantAllocator::Run ConstantAllocator::Allocate(Target& target,
+                                                   uint32_t objectCount,
+                                                   uint32_t slotsPerObject) {
+    Run run;
+    if (objectCount == 0 || slotsPerObject == 0 || slotsPerObject > slotsPerPage ||
+        slotsPerObject > MaxSlotsPerObject) {
+        return run;
+    }
+
+    // Move on when not even one object fits; a fresh page is mapped on first use
+    if (pageBase && used + slotsPerObject > slotsPerPage) {
+        ClosePage();
+    }
+    if (!pageBase) {
+        pageBase = target.MapPage(page);
+        if (!pageBase) {
+            return run;
+        }
+        ++stats.pages;
+    }
+
+    const uint32_t fit = (slotsPerPage - used) / slotsPerObject;
+    run.objectCount    = objectCount < fit ? objectCount : fit;
+    run.firstSlot      = page * slotsPerPage + used;
+    run.cpuPtr         = pageBase + static_cast<size_t>(used) * SlotSize;
+
+    used += run.objectCount * slotsPerObject;
+    stats.objects += run.objectCount;
+    stats.slots += run.objectCount * slotsPerObject;
+    target.OnAllocated(run.firstSlot, run.objectCount * slotsPerObject);
+    return run;
+}
+
+uint32_t ConstantAllocator::AllocateOne(Target& target, uint32_t slotsPerObject, uint8_t** cpuPtr) {
+    Run run = Allocate(target, 1, slotsPerObject);
+    *cpuPtr = run.cpuPtr;
+    return run.objectCount > 0 ? run.firstSlot : InvalidSlot;
+}
+
+void ConstantAllocator::ClosePage() {
+    if (!pageBase) {
+        return;
+    }
+    stats.slotsWasted += slotsPerPage - used;
+    ++page;
+    used     = 0;
+    pageBase = nullptr;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+
+// Constant Allocator Class
+// Packs per-object shader constants into a few large pages (constant buffers) at 256-byte
+// slots, the granularity Direct3D 11.1 can bind a window of a buffer at (FirstConstant and
+// NumConstants are multiples of 16 sixteen-byte constants). A slot number names a place in
+// the whole frame: page slot / slotsPerPage, first constant (slot % slotsPerPage) * 16.
+//
+// Pages are handed out in order and each is mapped through the Target the first time it is
+// used in a frame, so every page is written exactly once per frame (D3D11: one
+// MAP_WRITE_DISCARD). Allocation is single threaded; the slots of a run can then be filled
+// from any thread until the target unmaps them.
+class ConstantAllocator {
+  public:
+    static constexpr uint32_t SlotSize          = 256;
+    static constexpr uint32_t ConstantsPerSlot  = SlotSize / 16;
+    static constexpr uint32_t MaxSlotsPerObject = 256; // A bind window is at most 64 KB
+    static constexpr uint32_t InvalidSlot       = 0xFFFFFFFFu;
+
+    // Backend side: the memory of each page for this frame
+    class Target {
+      public:
+        virtual ~Target() = default;
+
+        // CPU address of page for writing, creating it if needed; nullptr if that failed
+        virtual uint8_t* MapPage(uint32_t page) = 0;
+
+        // Slots [firstSlot, firstSlot + slotCount) were just handed out from a mapped page
+        virtual void OnAllocated(uint32_t firstSlot, uint32_t slotCount) {
+            (void)firstSlot;
+            (void)slotCount;
+        }
+    };
+
+    // Consecutive slots in one page for objects [firstObject, firstObject + objectCount)
+    struct Run {
+        uint32_t firstSlot   = InvalidSlot;
+        uint32_t objectCount = 0;
+        uint8_t* cpuPtr      = nullptr; // Slot firstSlot; objects are slotsPerObject apart
+    };
+
+    // Counters for the current frame (reset by BeginFrame)
+    struct Stats {
+        uint32_t objects     = 0;
+        uint32_t slots       = 0;
+        uint32_t pages       = 0; // Pages mapped
+        uint32_t slotsWasted = 0; // Left unused at the end of closed pages
+    };
+
+    // slotsPerPage: 16384 makes 4 MB pages
+    explicit ConstantAllocator(uint32_t slotsPerPage = 16384) : slotsPerPage(slotsPerPage) {}
+
+    // Start a frame: rewind to the first slot of page 0
+    void BeginFrame();
+
+    /*
+    Place up to objectCount objects of slotsPerObject slots each in the current page (or the
+    next one if not even one fits). Returns a run with at least one object, or an empty run
+    if the target failed; callers loop until every object is placed
+    */
+    Run Allocate(Target& target, uint32_t objectCount, uint32_t slotsPerObject = 1);
+
+    // One object; cpuPtr receives its address. Returns InvalidSlot if the target failed
+    uint32_t AllocateOne(Target& target, uint32_t slotsPerObject, uint8_t** cpuPtr);
+
+    // Stop writing to the current page (the target is unmapping it); the next allocation
+    // starts a fresh one, since mapping a page twice in a frame would discard its contents
+    void ClosePage();
+
+    // Where a slot lives, for binding
+    uint32_t GetPage(uint32_t slot) const {
+        return slot / slotsPerPage;
+    }
+    uint32_t GetFirstConstant(uint32_t slot) const {
+        return slot % slotsPerPage * ConstantsPerSlot;
+    }
+
+    uint32_t GetSlotsPerPage() const {
+        return slotsPerPage;
+    }
+    const Stats& GetStats() const {
+        return stats;
+    }
+
+  private:
+    uint32_t slotsPerPage;
+    uint32_t page       = 0;       // Current page
+    uint32_t used       = 0;       // Slots used in it
+    uint8_t* pageBase   = nullptr; // Its mapping; nullptr until the first allocation
+    Stats stats;
+};
@@ -0,0 +1,606 @@
+#include "FrameCapture.h"
+#include "StateObjectCache.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+using Op   = CaptureFile::Op;
+using Kind = CaptureFile::ObjectKind;
+using Args = uint32_t[CaptureFile::MaxArgs]; // Arguments of FrameCapture::Record
+
+const CaptureFile::OpInfo OpInfos[CaptureFile::OpCount] = {
+    {"SetInputLayout", 1, 1, {0, 0}, {}},
+    {"SetPrimitiveTopology", 1, 0, {0, 0}, {}},
+    {"SetIndexBuffer", 3, 1, {0, 0}, {Kind::Buffer, Kind::Buffer}},
+    {"SetVertexBuffer", 4, 1, {1, 0}, {Kind::Buffer, Kind::Buffer}},
+    {"SetVertexShader", 1, 1, {0, 0}, {Kind::VertexShader, Kind::VertexShader}},
+    {"SetPixelShader", 1, 1, {0, 0}, {Kind::PixelShader, Kind::PixelShader}},
+    {"SetPixelShaderResource", 2, 1, {1, 0}, {Kind::ShaderResource, Kind::ShaderResource}},
+    {"SetPixelSampler", 2, 1, {1, 0}, {Kind::Sampler, Kind::Sampler}},
+    {"SetVertexConstantBuffer", 4, 1, {1, 0}, {Kind::Buffer, Kind::Buffer}},
+    {"SetRasterizerState", 1, 1, {0, 0}, {Kind::RasterizerState, Kind::RasterizerState}},
+    {"SetViewport", 4, 0, {0, 0}, {}},
+    {"SetDepthStencilState", 2, 1, {0, 0}, {Kind::DepthStencilState, Kind::DepthStencilState}},
+    {"SetBlendState", 7, 1, {0, 0}, {Kind::BlendState, Kind::BlendState}},
+    {"SetRenderTarget", 2, 2, {0, 1}, {Kind::RenderTarget, Kind::DepthStencil}},
+    {"Draw", 2, 0, {0, 0}, {}},
+    {"DrawIndexed", 3, 0, {0, 0}, {}},
+    {"DrawInstanced", 4, 0, {0, 0}, {}},
+    {"DrawIndexedInstanced", 5, 0, {0, 0}, {}},
+    {"BufferData", 3, 1, {0, 0}, {Kind::Buffer, Kind::Buffer}},
+};
+
+uint64_t AlignUp(uint64_t value) {
+    return (value + CaptureFile::SectionAlign - 1) & ~uint64_t(CaptureFile::SectionAlign - 1);
+}
+
+uint32_t FloatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float BitsFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Argument i of a command whose arguments start at args
+uint32_t ReadArg(const uint8_t* args, uint32_t i) {
+    uint32_t value;
+    std::memcpy(&value, args + i * sizeof(uint32_t), sizeof(value));
+    return value;
+}
+
+bool IsDraw(Op op) {
+    return op >= CaptureFile::Draw && op <= CaptureFile::DrawIndexedInstanced;
+}
+
+} // namespace
+
+const CaptureFile::OpInfo& CaptureFile::GetOpInfo(Op op) {
+    return OpInfos[op];
+}
+
+// ========================================
+// 1. LOADING
+// ========================================
+
+bool CaptureFile::Open(const std::string& path) {
+    Close();
+    if (!file.Open(path)) {
+        return false;
+    }
+    if (!Load(file.GetData(), file.GetSize())) {
+        file.Close();
+        return false;
+    }
+    return true;
+}
+
+bool CaptureFile::Load(const uint8_t* data, size_t size) {
+    header   = {};
+    commands = nullptr;
+    blobData = nullptr;
+    objectKinds.clear();
+    blobs.clear();
+    std::memset(opCounts, 0, sizeof(opCounts));
+
+    Header loaded;
+    if (size < sizeof(Header)) {
+        return false;
+    }
+    std::memcpy(&loaded, data, sizeof(loaded));
+    if (loaded.magic != Magic || loaded.version != Version) {
+        return false;
+    }
+
+    // Table sizes follow from the counts, so a mismatch means a truncated or foreign file
+    const Section* sections = loaded.sections;
+    if (sections[Objects].size != uint64_t(loaded.objectCount) * sizeof(uint32_t) ||
+        sections[Blobs].size != uint64_t(loaded.blobCount) * sizeof(Blob)) {
+        return false;
+    }
+    for (uint32_t s = 0; s < SectionCount; ++s) {
+        if (sections[s].offset > size || sections[s].size > size - sections[s].offset) {
+            return false;
+        }
+    }
+
+    objectKinds.resize(loaded.objectCount);
+    blobs.resize(loaded.blobCount);
+    if (loaded.objectCount > 0) {
+        std::memcpy(objectKinds.data(), data + sections[Objects].offset, sections[Objects].size);
+    }
+    if (loaded.blobCount > 0) {
+        std::memcpy(blobs.data(), data + sections[Blobs].offset, sections[Blobs].size);
+    }
+    for (uint32_t kind : objectKinds) {
+        if (kind >= ObjectKindCount) {
+            return false;
+        }
+    }
+    for (const Blob& blob : blobs) {
+        if (blob.offset > sections[BlobData].size ||
+            blob.size > sections[BlobData].size - blob.offset) {
+            return false;
+        }
+    }
+
+    // Walk the command stream once: opcodes, lengths and references are all checked here,
+    // so Replay can trust it
+    const uint8_t* cursor = data + sections[Commands].offset;
+    const uint8_t* end    = cursor + sections[Commands].size;
+    uint32_t count        = 0;
+    uint32_t draws        = 0;
+    while (cursor < end) {
+        const Op op = static_cast<Op>(*cursor++);
+        if (op >= OpCount) {
+            return false;
+        }
+        const OpInfo& info = OpInfos[op];
+        if (size_t(end - cursor) < info.argCount * sizeof(uint32_t)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < info.objectArgCount; ++i) {
+            if (ReadArg(cursor, info.objectArgs[i]) > loaded.objectCount) {
+                return false;
+            }
+        }
+        if (op == BufferData && ReadArg(cursor, 2) >= loaded.blobCount) {
+            return false;
+        }
+        cursor += info.argCount * sizeof(uint32_t);
+        ++opCounts[op];
+        ++count;
+        draws += IsDraw(op) ? 1 : 0;
+    }
+    if (count != loaded.commandCount || draws != loaded.drawCount) {
+        std::memset(opCounts, 0, sizeof(opCounts));
+        return false;
+    }
+
+    header   = loaded;
+    commands = data + sections[Commands].offset;
+    blobData = data + sections[BlobData].offset;
+    return true;
+}
+
+void CaptureFile::Close() {
+    file.Close();
+    header   = {};
+    commands = nullptr;
+    blobData = nullptr;
+    objectKinds.clear();
+    blobs.clear();
+    std::memset(opCounts, 0, sizeof(opCounts));
+}
+
+// ========================================
+// 2. REPLAY
+// ========================================
+
+void CaptureFile::Replay(ContextSink& sink,
+                         void* const* objects,
+                         const BufferDataFunction& bufferData) const {
+    auto object = [objects](uint32_t id) {
+        return objects ? objects[id] : reinterpret_cast<void*>(static_cast<uintptr_t>(id));
+    };
+
+    const uint8_t* cursor = commands;
+    for (uint32_t c = 0; c < header.commandCount; ++c) {
+        // Arguments are read one at a time, each a fixed-size copy (see FrameCapture::Record)
+        const Op op         = static_cast<Op>(*cursor++);
+        const uint8_t* args = cursor;
+        auto a              = [args](uint32_t i) { return ReadArg(args, i); };
+
+        cursor += OpInfos[op].argCount * sizeof(uint32_t);
+
+        switch (op) {
+        case SetInputLayout:
+            sink.SetInputLayout(object(a(0)));
+            break;
+        case SetPrimitiveTopology:
+            sink.SetPrimitiveTopology(a(0));
+            break;
+        case SetIndexBuffer:
+            sink.SetIndexBuffer(object(a(0)), a(1), a(2));
+            break;
+        case SetVertexBuffer:
+            sink.SetVertexBuffer(a(0), object(a(1)), a(2), a(3));
+            break;
+        case SetVertexShader:
+            sink.SetVertexShader(object(a(0)));
+            break;
+        case SetPixelShader:
+            sink.SetPixelShader(object(a(0)));
+            break;
+        case SetPixelShaderResource:
+            sink.SetPixelShaderResource(a(0), object(a(1)));
+            break;
+        case SetPixelSampler:
+            sink.SetPixelSampler(a(0), object(a(1)));
+            break;
+        case SetVertexConstantBuffer:
+            sink.SetVertexConstantBuffer(a(0), object(a(1)), a(2), a(3));
+            break;
+        case SetRasterizerState:
+            sink.SetRasterizerState(object(a(0)));
+            break;
+        case SetViewport:
+            sink.SetViewport(BitsFloat(a(0)), BitsFloat(a(1)), BitsFloat(a(2)), BitsFloat(a(3)));
+            break;
+        case SetDepthStencilState:
+            sink.SetDepthStencilState(object(a(0)), a(1));
+            break;
+        case SetBlendState: {
+            const float factor[4] = {
+                BitsFloat(a(3)), BitsFloat(a(4)), BitsFloat(a(5)), BitsFloat(a(6))};
+            sink.SetBlendState(object(a(0)), a(2) ? factor : nullptr, a(1));
+            break;
+        }
+        case SetRenderTarget:
+            sink.SetRenderTarget(object(a(0)), object(a(1)));
+            break;
+        case Draw:
+            sink.Draw(a(0), a(1));
+            break;
+        case DrawIndexed:
+            sink.DrawIndexed(a(0), a(1), static_cast<int32_t>(a(2)));
+            break;
+        case DrawInstanced:
+            sink.DrawInstanced(a(0), a(1), a(2), a(3));
+            break;
+        case DrawIndexedInstanced:
+            sink.DrawIndexedInstanced(a(0), a(1), a(2), static_cast<int32_t>(a(3)), a(4));
+            break;
+        case BufferData:
+            if (bufferData) {
+                bufferData(object(a(0)), a(1), GetBlobData(a(2)), blobs[a(2)].size);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// ========================================
+// 3. CAPTURE
+// ========================================
+
+void FrameCapture::Begin(uint64_t frameNumber) {
+    frame = frameNumber;
+    stats = Stats();
+    commandBytes = 0;
+    objectKinds.clear();
+    objectIds.clear();
+    blobs.clear();
+    blobData.clear();
+    blobsByHash.clear();
+    for (RecentObject& recent : recentObjects) {
+        recent = RecentObject();
+    }
+    capturing = true;
+}
+
+std::vector<uint8_t> FrameCapture::End() {
+    std::vector<uint8_t> bytes;
+    if (!capturing) {
+        return bytes;
+    }
+    capturing = false;
+
+    CaptureFile::Header header = {};
+    header.magic               = CaptureFile::Magic;
+    header.version             = CaptureFile::Version;
+    header.commandCount        = stats.commands;
+    header.drawCount           = stats.draws;
+    header.objectCount         = static_cast<uint32_t>(objectKinds.size());
+    header.blobCount           = static_cast<uint32_t>(blobs.size());
+    header.frame               = frame;
+
+    const void* sectionData[CaptureFile::SectionCount] = {
+        objectKinds.data(), blobs.data(), commands.data(), blobData.data()};
+    const uint64_t sectionSizes[CaptureFile::SectionCount] = {
+        objectKinds.size() * sizeof(uint32_t),
+        blobs.size() * sizeof(CaptureFile::Blob),
+        commandBytes,
+        blobData.size()};
+
+    uint64_t offset = AlignUp(sizeof(header));
+    for (uint32_t s = 0; s < CaptureFile::SectionCount; ++s) {
+        header.sections[s].offset = offset;
+        header.sections[s].size   = sectionSizes[s];
+        offset                    = AlignUp(offset + sectionSizes[s]);
+    }
+
+    bytes.resize(static_cast<size_t>(offset), 0);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    for (uint32_t s = 0; s < CaptureFile::SectionCount; ++s) {
+        if (sectionSizes[s] > 0) {
+            std::memcpy(bytes.data() + header.sections[s].offset, sectionData[s], sectionSizes[s]);
+        }
+    }
+    stats.fileBytes = bytes.size();
+    return bytes;
+}
+
+bool FrameCapture::End(const std::string& path) {
+    if (!capturing) {
+        return false;
+    }
+    std::vector<uint8_t> bytes = End();
+    FILE* file                 = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+void FrameCapture::Record(CaptureFile::Op op, const uint32_t* args, const void* const* objects) {
+    const CaptureFile::OpInfo& info = OpInfos[op];
+    // Copies here are all of constant size: variable-length ones become rep movs, which
+    // costs more to start than these few bytes take to move
+    uint8_t command[MaxCommandSize];
+    command[0] = op;
+    std::memcpy(command + 1, args, CaptureFile::MaxArgs * sizeof(uint32_t));
+
+    // Objects are numbered on first use; nullptr is always 0. A frame binds the same few
+    // objects over and over, so most lookups end in the direct-mapped recentObjects
+    for (uint32_t i = 0; i < info.objectArgCount; ++i) {
+        const void* object = objects[i];
+        uint32_t id        = 0;
+        if (object) {
+            const uint64_t bits  = reinterpret_cast<uintptr_t>(object) * 0x9E3779B97F4A7C15ull;
+            RecentObject& recent = recentObjects[bits >> 58];
+            if (recent.object == object) {
+                id = recent.id;
+            } else {
+                auto found = objectIds.find(object);
+                if (found == objectIds.end()) {
+                    objectKinds.push_back(info.objectKinds[i]);
+                    found = objectIds.emplace(object, static_cast<uint32_t>(objectKinds.size()))
+                                .first;
+                    ++stats.objects;
+                }
+                id            = found->second;
+                recent.object = object;
+                recent.id     = id;
+            }
+        }
+        std::memcpy(command + 1 + info.objectArgs[i] * sizeof(uint32_t), &id, sizeof(id));
+    }
+
+    if (commands.size() - commandBytes < MaxCommandSize) {
+        commands.resize(commands.size() < 4096 ? 4096 : commands.size() * 2);
+    }
+    std::memcpy(commands.data() + commandBytes, command, MaxCommandSize);
+    commandBytes += 1 + info.argCount * sizeof(uint32_t);
+    ++stats.commands;
+    stats.draws += IsDraw(op) ? 1 : 0;
+}
+
+void FrameCapture::RecordBufferData(void* buffer,
+                                    uint32_t offset,
+                                    const void* data,
+                                    uint64_t size) {
+    if (!capturing || size == 0) {
+        return;
+    }
+
+    // Identical contents (a static upload repeated, the same constants twice) share a blob
+    const uint64_t hash = StateObjectCache::Hash(data, static_cast<size_t>(size));
+    uint32_t blob       = static_cast<uint32_t>(blobs.size());
+    auto range          = blobsByHash.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const CaptureFile::Blob& candidate = blobs[it->second];
+        if (candidate.size == size &&
+            std::memcmp(blobData.data() + candidate.offset, data, static_cast<size_t>(size)) == 0) {
+            blob = it->second;
+            break;
+        }
+    }
+    if (blob == blobs.size()) {
+        const uint64_t blobOffset = blobData.size();
+        blobData.insert(blobData.end(),
+                        static_cast<const uint8_t*>(data),
+                        static_cast<const uint8_t*>(data) + size);
+        blobs.push_back({hash, blobOffset, size});
+        blobsByHash.emplace(hash, blob);
+        ++stats.blobs;
+        stats.blobBytes += size;
+    } else {
+        ++stats.blobsReused;
+        stats.blobBytesReused += size;
+    }
+
+    const Args args        = {0, offset, blob};
+    const void* objects[1] = {buffer};
+    Record(CaptureFile::BufferData, args, objects);
+}
+
+// ========================================
+// 4. FORWARDING
+// ========================================
+
+void FrameCapture::SetInputLayout(void* layout) {
+    target.SetInputLayout(layout);
+    if (capturing) {
+        const Args args        = {0};
+        const void* objects[1] = {layout};
+        Record(CaptureFile::SetInputLayout, args, objects);
+    }
+}
+
+void FrameCapture::SetPrimitiveTopology(uint32_t topology) {
+    target.SetPrimitiveTopology(topology);
+    if (capturing) {
+        const Args args = {topology};
+        Record(CaptureFile::SetPrimitiveTopology, args, nullptr);
+    }
+}
+
+void FrameCapture::SetIndexBuffer(void* buffer, uint32_t format, uint32_t offset) {
+    target.SetIndexBuffer(buffer, format, offset);
+    if (capturing) {
+        const Args args        = {0, format, offset};
+        const void* objects[1] = {buffer};
+        Record(CaptureFile::SetIndexBuffer, args, objects);
+    }
+}
+
+void FrameCapture::SetVertexBuffer(uint32_t slot, void* buffer, uint32_t stride, uint32_t offset) {
+    target.SetVertexBuffer(slot, buffer, stride, offset);
+    if (capturing) {
+        const Args args        = {slot, 0, stride, offset};
+        const void* objects[1] = {buffer};
+        Record(CaptureFile::SetVertexBuffer, args, objects);
+    }
+}
+
+void FrameCapture::SetVertexShader(void* shader) {
+    target.SetVertexShader(shader);
+    if (capturing) {
+        const Args args        = {0};
+        const void* objects[1] = {shader};
+        Record(CaptureFile::SetVertexShader, args, objects);
+    }
+}
+
+void FrameCapture::SetPixelShader(void* shader) {
+    target.SetPixelShader(shader);
+    if (capturing) {
+        const Args args        = {0};
+        const void* objects[1] = {shader};
+        Record(CaptureFile::SetPixelShader, args, objects);
+    }
+}
+
+void FrameCapture::SetPixelShaderResource(uint32_t slot, void* resource) {
+    target.SetPixelShaderResource(slot, resource);
+    if (capturing) {
+        const Args args        = {slot, 0};
+        const void* objects[1] = {resource};
+        Record(CaptureFile::SetPixelShaderResource, args, objects);
+    }
+}
+
+void FrameCapture::SetPixelSampler(uint32_t slot, void* sampler) {
+    target.SetPixelSampler(slot, sampler);
+    if (capturing) {
+        const Args args        = {slot, 0};
+        const void* objects[1] = {sampler};
+        Record(CaptureFile::SetPixelSampler, args, objects);
+    }
+}
+
+void FrameCapture::SetVertexConstantBuffer(uint32_t slot,
+                                           void* buffer,
+                                           uint32_t firstConstant,
+                                           uint32_t constantCount) {
+    target.SetVertexConstantBuffer(slot, buffer, firstConstant, constantCount);
+    if (capturing) {
+        const Args args        = {slot, 0, firstConstant, constantCount};
+        const void* objects[1] = {buffer};
+        Record(CaptureFile::SetVertexConstantBuffer, args, objects);
+    }
+}
+
+void FrameCapture::SetRasterizerState(void* state) {
+    target.SetRasterizerState(state);
+    if (capturing) {
+        const Args args        = {0};
+        const void* objects[1] = {state};
+        Record(CaptureFile::SetRasterizerState, args, objects);
+    }
+}
+
+void FrameCapture::SetViewport(float x, float y, float width, float height) {
+    target.SetViewport(x, y, width, height);
+    if (capturing) {
+        const Args args = {FloatBits(x), FloatBits(y), FloatBits(width), FloatBits(height)};
+        Record(CaptureFile::SetViewport, args, nullptr);
+    }
+}
+
+void FrameCapture::SetDepthStencilState(void* state, uint32_t stencilRef) {
+    target.SetDepthStencilState(state, stencilRef);
+    if (capturing) {
+        const Args args        = {0, stencilRef};
+        const void* objects[1] = {state};
+        Record(CaptureFile::SetDepthStencilState, args, objects);
+    }
+}
+
+void FrameCapture::SetBlendState(void* state, const float blendFactor[4], uint32_t mask) {
+    target.SetBlendState(state, blendFactor, mask);
+    if (capturing) {
+        // A null factor (Direct3D: all ones) is kept distinct from an explicit one
+        const float* factor    = blendFactor;
+        const Args args        = {0,
+                                  mask,
+                                  factor ? 1u : 0u,
+                                  factor ? FloatBits(factor[0]) : 0,
+                                  factor ? FloatBits(factor[1]) : 0,
+                                  factor ? FloatBits(factor[2]) : 0,
+                                  factor ? FloatBits(factor[3]) : 0};
+        const void* objects[1] = {state};
+        Record(CaptureFile::SetBlendState, args, objects);
+    }
+}
+
+void FrameCapture::SetRenderTarget(void* renderTarget, void* depthStencil) {
+    target.SetRenderTarget(renderTarget, depthStencil);
+    if (capturing) {
+        const Args args        = {0, 0};
+        const void* objects[2] = {renderTarget, depthStencil};
+        Record(CaptureFile::SetRenderTarget, args, objects);
+    }
+}
+
+void FrameCapture::Draw(uint32_t vertexCount, uint32_t startVertex) {
+    target.Draw(vertexCount, startVertex);
+    if (capturing) {
+        const Args args = {vertexCount, startVertex};
+        Record(CaptureFile::Draw, args, nullptr);
+    }
+}
+
+void FrameCapture::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) {
+    target.DrawIndexed(indexCount, startIndex, baseVertex);
+    if (capturing) {
+        const Args args = {indexCount, startIndex, static_cast<uint32_t>(baseVertex)};
+        Record(CaptureFile::DrawIndexed, args, nullptr);
+    }
+}
+
+void FrameCapture::DrawInstanced(uint32_t vertexCount,
+                                 uint32_t instanceCount,
+                                 uint32_t startVertex,
+                                 uint32_t startInstance) {
+    target.DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+    if (capturing) {
+        const Args args = {vertexCount, instanceCount, startVertex, startInstance};
+        Record(CaptureFile::DrawInstanced, args, nullptr);
+    }
+}
+
+void FrameCapture::DrawIndexedInstanced(uint32_t indexCount,
+                                        uint32_t instanceCount,
+                                        uint32_t startIndex,
+                                        int32_t baseVertex,
+                                        uint32_t startInstance) {
+    target.DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+    if (capturing) {
+        const Args args = {indexCount,
+                           instanceCount,
+                           startIndex,
+                           static_cast<uint32_t>(baseVertex),
+                           startInstance};
+        Record(CaptureFile::DrawIndexedInstanced, args, nullptr);
+    }
+}
@@ -0,0 +1,272 @@
+#pragma once
+#include "StateCache.h"
+#include "utils/MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Capture File Class
+// Read side of a frame captured by FrameCapture: every call that reached a ContextSink
+// during one frame, plus the contents written into dynamic buffers, replayable into any
+// other sink (tools/FrameReplay):
+//
+//   Header | ObjectKind[objectCount] | Blob[blobCount] | commands | blob data
+//
+// (sections 16-byte aligned)
+//
+// API objects are numbered in order of first use (0 is nullptr) and tagged with the kind
+// of the call that first used them. A command is one opcode byte followed by its OpInfo
+// argument count of little-endian 32-bit values (floats by bit pattern). Buffer contents
+// are deduplicated blobs: identical uploads, within a buffer or across buffers, are stored
+// once and referenced by index.
+class CaptureFile {
+  public:
+    static constexpr uint32_t Magic        = 0x50414346; // "FCAP"
+    static constexpr uint32_t Version      = 1;
+    static constexpr uint32_t SectionAlign = 16;
+    static constexpr uint32_t MaxArgs      = 7;
+
+    // One per ContextSink method, plus buffer contents
+    enum Op : uint8_t {
+        SetInputLayout = 0,
+        SetPrimitiveTopology,
+        SetIndexBuffer,
+        SetVertexBuffer,
+        SetVertexShader,
+        SetPixelShader,
+        SetPixelShaderResource,
+        SetPixelSampler,
+        SetVertexConstantBuffer,
+        SetRasterizerState,
+        SetViewport,
+        SetDepthStencilState,
+        SetBlendState,
+        SetRenderTarget,
+        Draw,
+        DrawIndexed,
+        DrawInstanced,
+        DrawIndexedInstanced,
+        BufferData, // buffer, byte offset, blob
+        OpCount
+    };
+
+    enum ObjectKind : uint32_t {
+        InputLayout = 0,
+        Buffer,
+        VertexShader,
+        PixelShader,
+        ShaderResource,
+        Sampler,
+        RasterizerState,
+        DepthStencilState,
+        BlendState,
+        RenderTarget,
+        DepthStencil,
+        ObjectKindCount
+    };
+
+    // Argument layout of an opcode; objectArgs lists which arguments are object ids
+    struct OpInfo {
+        const char* name;
+        uint8_t argCount;
+        uint8_t objectArgCount;
+        uint8_t objectArgs[2];
+        ObjectKind objectKinds[2];
+    };
+
+    enum SectionIndex : uint32_t { Objects = 0, Blobs, Commands, BlobData, SectionCount };
+
+    struct Section {
+        uint64_t offset; // From the start of the file
+        uint64_t size;
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t commandCount;
+        uint32_t drawCount;
+        uint32_t objectCount; // Excluding nullptr (id 0)
+        uint32_t blobCount;
+        uint64_t frame; // Frame number the application captured
+        Section sections[SectionCount];
+    };
+
+    struct Blob {
+        uint64_t hash;
+        uint64_t offset; // Into the blob data section
+        uint64_t size;
+    };
+
+    // Receives buffer contents during Replay; the data lives as long as the file
+    using BufferDataFunction =
+        std::function<void(void* buffer, uint32_t offset, const void* data, uint64_t size)>;
+
+    static const OpInfo& GetOpInfo(Op op);
+
+    // Map and validate a capture file
+    bool Open(const std::string& path);
+
+    /*
+    Validate a capture already in memory (not copied; must outlive this)
+    Checks the header, the sections, every command's opcode and length, and every object
+    and blob reference
+    */
+    bool Load(const uint8_t* data, size_t size);
+
+    void Close();
+
+    /*
+    Issue every command to sink in capture order
+    objects: Indexed by object id (objects[0] is passed for nullptr); when null the ids
+             themselves are passed as pointers, enough for sinks that only count or log
+    bufferData: Called for BufferData commands; ignored when empty
+    */
+    void Replay(ContextSink& sink,
+                void* const* objects                 = nullptr,
+                const BufferDataFunction& bufferData = nullptr) const;
+
+    const Header& GetHeader() const {
+        return header;
+    }
+    ObjectKind GetObjectKind(uint32_t id) const {
+        return static_cast<ObjectKind>(objectKinds[id - 1]);
+    }
+    const Blob& GetBlob(uint32_t index) const {
+        return blobs[index];
+    }
+    const uint8_t* GetBlobData(uint32_t index) const {
+        return blobData + blobs[index].offset;
+    }
+
+    // Commands of each opcode in the file
+    const uint32_t* GetOpCounts() const {
+        return opCounts;
+    }
+
+  private:
+    MappedFile file;
+    Header header              = {};
+    const uint8_t* commands    = nullptr;
+    const uint8_t* blobData    = nullptr;
+    uint32_t opCounts[OpCount] = {};
+
+    // Copied at Load, so the file needs no particular alignment
+    std::vector<uint32_t> objectKinds;
+    std::vector<Blob> blobs;
+};
+
+// Frame Capture Class
+// ContextSink decorator: forwards every call to the sink it wraps and, between Begin and
+// End, also appends it to a CaptureFile. Sits under the StateCache, so a capture holds
+// exactly the calls that reached the context; Begin is followed by StateCache::Invalidate
+// so the frame starts from fully specified state.
+//
+// Outside a capture the cost is one extra virtual call and a branch per forwarded call.
+// During one, a command is a few bytes appended to a vector, objects are numbered through
+// a hash map, and buffer contents are hashed once and stored only if new.
+class FrameCapture : public ContextSink {
+  public:
+    struct Stats {
+        uint32_t commands        = 0;
+        uint32_t draws           = 0;
+        uint32_t objects         = 0;
+        uint32_t blobs           = 0; // Unique buffer contents
+        uint32_t blobsReused     = 0; // BufferData commands that matched an earlier blob
+        uint64_t blobBytes       = 0; // Stored
+        uint64_t blobBytesReused = 0; // Not stored again
+        uint64_t fileBytes       = 0; // Size of the last End()ed capture
+    };
+
+    explicit FrameCapture(ContextSink& target) : target(target) {}
+
+    // Start recording (drops an unfinished capture)
+    void Begin(uint64_t frame);
+
+    bool IsCapturing() const {
+        return capturing;
+    }
+
+    // Stop recording and serialize the capture; empty if none was active
+    std::vector<uint8_t> End();
+
+    // Stop recording and write the capture to path; false if none was active or on error
+    bool End(const std::string& path);
+
+    /*
+    Record the bytes written into [offset, offset + size) of a buffer, so a replay can
+    restore them (call before the draws that read them; ignored outside a capture)
+    */
+    void RecordBufferData(void* buffer, uint32_t offset, const void* data, uint64_t size);
+
+    // Counters of the current or last capture
+    Stats GetStats() const {
+        return stats;
+    }
+
+    // ContextSink interface
+    void SetInputLayout(void* layout) override;
+    void SetPrimitiveTopology(uint32_t topology) override;
+    void SetIndexBuffer(void* buffer, uint32_t format, uint32_t offset) override;
+    void SetVertexBuffer(uint32_t slot, void* buffer, uint32_t stride, uint32_t offset) override;
+    void SetVertexShader(void* shader) override;
+    void SetPixelShader(void* shader) override;
+    void SetPixelShaderResource(uint32_t slot, void* resource) override;
+    void SetPixelSampler(uint32_t slot, void* sampler) override;
+    void SetVertexConstantBuffer(uint32_t slot,
+                                 void* buffer,
+                                 uint32_t firstConstant,
+                                 uint32_t constantCount) override;
+    void SetRasterizerState(void* state) override;
+    void SetViewport(float x, float y, float width, float height) override;
+    void SetDepthStencilState(void* state, uint32_t stencilRef) override;
+    void SetBlendState(void* state, const float blendFactor[4], uint32_t mask) override;
+    void SetRenderTarget(void* renderTarget, void* depthStencil) override;
+
+    void Draw(uint32_t vertexCount, uint32_t startVertex) override;
+    void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+    void DrawInstanced(uint32_t vertexCount,
+                       uint32_t instanceCount,
+                       uint32_t startVertex,
+                       uint32_t startInstance) override;
+    void DrawIndexedInstanced(uint32_t indexCount,
+                              uint32_t instanceCount,
+                              uint32_t startIndex,
+                              int32_t baseVertex,
+                              uint32_t startInstance) override;
+
+  private:
+    ContextSink& target;
+    bool capturing = false;
+    uint64_t frame = 0;
+    Stats stats;
+
+    // Written a whole MaxCommandSize at a time, so kept at least that far ahead of the
+    // commandBytes in use
+    static constexpr size_t MaxCommandSize = 1 + CaptureFile::MaxArgs * sizeof(uint32_t);
+    std::vector<uint8_t> commands;
+    size_t commandBytes = 0;
+    std::vector<uint32_t> objectKinds;
+    std::unordered_map<const void*, uint32_t> objectIds;
+    std::vector<CaptureFile::Blob> blobs;
+    std::vector<uint8_t> blobData;
+    std::unordered_multimap<uint64_t, uint32_t> blobsByHash;
+
+    // Last id looked up per pointer hash, in front of objectIds
+    static constexpr uint32_t RecentObjectCount = 64; // Indexed by the top 6 hash bits
+    struct RecentObject {
+        const void* object = nullptr;
+        uint32_t id        = 0;
+    };
+    RecentObject recentObjects[RecentObjectCount];
+
+    /*
+    Append a command
+    args: MaxArgs values, of which the op's argCount are used
+    objects: The op's object arguments, numbered here into their places in args
+    */
+    void Record(CaptureFile::Op op, const uint32_t* args, const void* const* objects);
+};
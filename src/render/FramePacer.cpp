@@ -0,0 +1,229 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRAME_PACER_SSE2 1
+#include <emmintrin.h>
+#else
+#define FRAME_PACER_SSE2 0
+#endif
+
+namespace {
+
+class SystemClock : public PacingClock {
+  public:
+    SystemClock() {
+#ifdef _WIN32
+        // Sleep() and plain timers round up to the 15.6 ms system tick unless the process
+        // raises the timer resolution; high-resolution timers (Windows 10 1803+) do not
+        timer = CreateWaitableTimerExW(nullptr,
+                                       nullptr,
+                                       CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                       TIMER_ALL_ACCESS);
+#endif
+    }
+
+    ~SystemClock() override {
+#ifdef _WIN32
+        if (timer) {
+            CloseHandle(timer);
+        }
+#endif
+    }
+
+    int64_t Now() override {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    void Sleep(int64_t ns) override {
+#ifdef _WIN32
+        if (timer) {
+            LARGE_INTEGER due;
+            due.QuadPart = -(ns / 100); // Relative, in 100 ns units
+            if (SetWaitableTimerEx(timer, &due, 0, nullptr, nullptr, nullptr, 0)) {
+                WaitForSingleObject(timer, INFINITE);
+                return;
+            }
+        }
+#endif
+        std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+    }
+
+    void Spin() override {
+#if FRAME_PACER_SSE2
+        _mm_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+  private:
+#ifdef _WIN32
+    HANDLE timer = nullptr;
+#endif
+};
+
+} // namespace
+
+std::unique_ptr<PacingClock> PacingClock::CreateSystemClock() {
+    return std::make_unique<SystemClock>();
+}
+
+FramePacer::FramePacer(PacingClock* clock) : clock(clock) {
+    if (!this->clock) {
+        ownedClock  = PacingClock::CreateSystemClock();
+        this->clock = ownedClock.get();
+    }
+}
+
+FramePacer::~FramePacer() {}
+
+void FramePacer::SetSettings(const Settings& newSettings) {
+    settings = newSettings;
+    period   = settings.targetFps > 0.0 ? std::llround(1e9 / settings.targetFps) : 0;
+    deadline = 0;
+}
+
+// ========================================
+// 1. FRAME SCHEDULE
+// ========================================
+
+void FramePacer::WaitForFrameStart() {
+    if (period > 0) {
+        const int64_t now = clock->Now();
+        if (!settings.lowLatency) {
+            // Frames start on a fixed grid; a start that is late by a whole period (a hitch,
+            // or the first frame) restarts the grid instead of rushing to catch up
+            if (deadline == 0 || now - deadline > period) {
+                deadline = now;
+            } else if (now - deadline > MinSpinNs) {
+                ++totals.missed;
+            }
+            WaitUntil(deadline);
+            deadline += period;
+        } else {
+            // The frame has to present by deadline: start once the slowest recent frame
+            // plus the slack still fits. A vertical blank, when known, sets the deadline
+            if (displaySync != 0) {
+                deadline = displaySync + period;
+            } else if (deadline == 0 || deadline < now) {
+                deadline = now + period;
+            }
+            WaitUntil(deadline - PredictWork() - settings.presentSlackNs);
+        }
+    }
+    displaySync = 0;
+    frameStart  = clock->Now();
+}
+
+void FramePacer::OnPresent() {
+    const int64_t now = clock->Now();
+    if (frameStart != 0) {
+        const int64_t latency = now - frameStart;
+        work[workIndex]       = latency;
+        workIndex             = (workIndex + 1) % WorkHistory;
+        totals.latencySum += static_cast<double>(latency);
+        totals.maxLatency = std::max(totals.maxLatency, latency);
+    }
+    if (lastPresent != 0) {
+        const int64_t interval = now - lastPresent;
+        totals.intervalSum += static_cast<double>(interval);
+        totals.intervalSumSq += static_cast<double>(interval) * static_cast<double>(interval);
+        totals.maxInterval = std::max(totals.maxInterval, interval);
+        ++totals.intervals;
+    }
+    lastPresent = now;
+    ++totals.frames;
+
+    if (period > 0 && settings.lowLatency) {
+        if (now > deadline) {
+            ++totals.missed;
+        }
+        deadline += period;
+    }
+}
+
+void FramePacer::SyncToDisplay(int64_t time) {
+    displaySync = time;
+}
+
+int64_t FramePacer::PredictWork() const {
+    // The slowest of the recent frames, with an eighth on top: one early start costs a
+    // little latency, one late start costs a whole missed deadline
+    const int64_t slowest = *std::max_element(work, work + WorkHistory);
+    return slowest + slowest / 8;
+}
+
+// ========================================
+// 2. SLEEP AND SPIN
+// ========================================
+
+void FramePacer::WaitUntil(int64_t time) {
+    int64_t now = clock->Now();
+    if (time - now > spinMargin) {
+        const int64_t request = time - now - spinMargin;
+        clock->Sleep(request);
+        const int64_t woke = clock->Now();
+        totals.sleepNs += woke - now;
+
+        // The margin jumps to cover the largest overshoot seen and decays slowly (1/16 per
+        // sleep) while sleeps are accurate, so one late wakeup does not pin it at the maximum
+        const int64_t overshoot = std::max<int64_t>(woke - now - request, 0);
+        const int64_t wanted    = overshoot + overshoot / 4 + MinSpinNs;
+        spinMargin = wanted > spinMargin ? wanted : spinMargin - (spinMargin - wanted) / 16;
+        spinMargin = std::clamp(spinMargin, MinSpinNs, std::max(settings.maxSpinNs, MinSpinNs));
+        now        = woke;
+    }
+
+    const int64_t spinStart = now;
+    while (now < time) {
+        clock->Spin();
+        now = clock->Now();
+    }
+    totals.spinNs += now - spinStart;
+}
+
+// ========================================
+// 3. STATISTICS
+// ========================================
+
+FramePacer::Stats FramePacer::GetStats() const {
+    constexpr double Ms = 1e-6;
+
+    Stats stats;
+    stats.frames       = totals.frames;
+    stats.missed       = totals.missed;
+    stats.spinMarginMs = static_cast<double>(spinMargin) * Ms;
+    if (totals.intervals > 0) {
+        const double count = static_cast<double>(totals.intervals);
+        const double mean  = totals.intervalSum / count;
+        const double var   = std::max(totals.intervalSumSq / count - mean * mean, 0.0);
+        stats.frameMs      = mean * Ms;
+        stats.frameDevMs   = std::sqrt(var) * Ms;
+        stats.maxFrameMs   = static_cast<double>(totals.maxInterval) * Ms;
+    }
+    if (totals.frames > 0) {
+        const double count = static_cast<double>(totals.frames);
+        stats.latencyMs    = totals.latencySum / count * Ms;
+        stats.maxLatencyMs = static_cast<double>(totals.maxLatency) * Ms;
+        stats.sleepMs      = static_cast<double>(totals.sleepNs) / count * Ms;
+        stats.spinMs       = static_cast<double>(totals.spinNs) / count * Ms;
+    }
+    return stats;
+}
+
+void FramePacer::ResetStats() {
+    totals = Totals();
+}
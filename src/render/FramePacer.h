@@ -0,0 +1,126 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+// Pacing Clock
+// Time source for FramePacer. The system clock reads the monotonic clock and sleeps the
+// thread; tests and benchmarks inject a simulated one to replay present timings.
+class PacingClock {
+  public:
+    virtual ~PacingClock() = default;
+
+    // Monotonic time in nanoseconds
+    virtual int64_t Now() = 0;
+
+    // Block for about ns nanoseconds; may oversleep by the OS timer granularity
+    virtual void Sleep(int64_t ns) = 0;
+
+    // One step of a busy wait (a pause instruction)
+    virtual void Spin() = 0;
+
+    // Steady clock; on Windows sleeps on a high-resolution waitable timer where available
+    static std::unique_ptr<PacingClock> CreateSystemClock();
+};
+
+// Frame Pacer Class
+// CPU-side frame rate limiter and latency controller for the render loop:
+//
+//   WaitForFrameStart() -> sample input, simulate, render -> Present() -> OnPresent()
+//
+// With a target rate, frames start on a fixed schedule. Waiting sleeps until shortly before
+// the deadline and spins the rest; the spin margin adapts to how much the clock's sleeps
+// have been overshooting, so coarse OS timers cost a little CPU instead of missed frames.
+//
+// Low-latency mode schedules the end of the frame instead of its start: the frame begins
+// as late as the recent work times allow while still presenting before the deadline, so
+// input is sampled just in time. Passing vertical blank times (SyncToDisplay) anchors
+// that deadline to the display; without them it is the fixed schedule.
+class FramePacer {
+  public:
+    struct Settings {
+        double targetFps       = 0.0;     // 0 = uncapped (the swap chain alone paces)
+        bool lowLatency        = false;   // Start frames just in time for their present
+        int64_t maxSpinNs      = 2000000; // Upper bound of the adaptive spin margin
+        int64_t presentSlackNs = 500000;  // Low-latency: room left before the deadline
+    };
+
+    // Averages over the frames since the last ResetStats, in milliseconds
+    struct Stats {
+        uint32_t frames     = 0;
+        double frameMs      = 0.0; // Present-to-present interval
+        double frameDevMs   = 0.0; // Its standard deviation
+        double maxFrameMs   = 0.0;
+        double latencyMs    = 0.0; // Frame start (input sample) to Present
+        double maxLatencyMs = 0.0;
+        double sleepMs      = 0.0; // Per frame, spent sleeping
+        double spinMs       = 0.0; // Per frame, spent spinning
+        double spinMarginMs = 0.0; // Current adaptive margin
+        uint32_t missed     = 0;   // Frames that missed their deadline
+    };
+
+    // clock: Time source, not owned; nullptr uses the system clock
+    explicit FramePacer(PacingClock* clock = nullptr);
+    ~FramePacer();
+
+    FramePacer(const FramePacer&)            = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // Takes effect at the next frame; the schedule restarts
+    void SetSettings(const Settings& settings);
+    const Settings& GetSettings() const {
+        return settings;
+    }
+
+    // Block until the next frame should begin
+    void WaitForFrameStart();
+
+    // Call right after Present returns
+    void OnPresent();
+
+    // A vertical blank was observed at time (e.g. the frame-latency wait unblocked)
+    void SyncToDisplay(int64_t time);
+
+    Stats GetStats() const;
+    void ResetStats();
+
+    PacingClock& GetClock() {
+        return *clock;
+    }
+
+  private:
+    // Recent frame start to Present durations, for the low-latency start prediction
+    static constexpr uint32_t WorkHistory = 16;
+    static constexpr int64_t MinSpinNs    = 50000;
+
+    std::unique_ptr<PacingClock> ownedClock;
+    PacingClock* clock = nullptr;
+    Settings settings;
+    int64_t period = 0; // Nanoseconds per frame, 0 when uncapped
+
+    int64_t deadline          = 0; // Next frame start, or next present in low-latency mode
+    int64_t frameStart        = 0;
+    int64_t lastPresent       = 0;
+    int64_t spinMargin        = MinSpinNs;
+    int64_t displaySync       = 0; // Vertical blank not yet used as an anchor
+    int64_t work[WorkHistory] = {};
+    uint32_t workIndex        = 0;
+
+    // Accumulated since ResetStats, in nanoseconds
+    struct Totals {
+        uint32_t frames      = 0;
+        uint32_t intervals   = 0;
+        double intervalSum   = 0.0;
+        double intervalSumSq = 0.0;
+        int64_t maxInterval  = 0;
+        double latencySum    = 0.0;
+        int64_t maxLatency   = 0;
+        int64_t sleepNs      = 0;
+        int64_t spinNs       = 0;
+        uint32_t missed      = 0;
+    };
+    Totals totals;
+
+    // Sleep, then spin, until time; adapts the spin margin to the sleep overshoot
+    void WaitUntil(int64_t time);
+    int64_t PredictWork() const;
+};
@@ -0,0 +1,170 @@
+#include "InstanceWriter.h"
+#include <cassert>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INSTANCE_WRITER_SSE2 1
+#include <emmintrin.h>
+#else
+#define INSTANCE_WRITER_SSE2 0
+#endif
+
+namespace {
+
+void WriteOne(const InstanceSource& source, uint32_t i, InstanceData& out) {
+    const float x = source.rotationX[i];
+    const float y = source.rotationY[i];
+    const float z = source.rotationZ[i];
+    const float w = source.rotationW[i];
+    const float s = source.scale[i];
+
+    // Rotation matrix of a unit quaternion, scaled, with the translation in column 3
+    out.transform[0][0] = s * (1.0f - 2.0f * (y * y + z * z));
+    out.transform[0][1] = s * (2.0f * (x * y - w * z));
+    out.transform[0][2] = s * (2.0f * (x * z + w * y));
+    out.transform[0][3] = source.positionX[i];
+    out.transform[1][0] = s * (2.0f * (x * y + w * z));
+    out.transform[1][1] = s * (1.0f - 2.0f * (x * x + z * z));
+    out.transform[1][2] = s * (2.0f * (y * z - w * x));
+    out.transform[1][3] = source.positionY[i];
+    out.transform[2][0] = s * (2.0f * (x * z - w * y));
+    out.transform[2][1] = s * (2.0f * (y * z + w * x));
+    out.transform[2][2] = s * (1.0f - 2.0f * (x * x + y * y));
+    out.transform[2][3] = source.positionZ[i];
+
+    const uint32_t rgba = source.color[i];
+    for (int c = 0; c < 4; ++c) {
+        out.color[c] = static_cast<float>((rgba >> (8 * c)) & 0xFF) * (1.0f / 255.0f);
+    }
+}
+
+} // namespace
+
+void InstanceWriter::Write(const InstanceSource& source,
+                           uint32_t count,
+                           InstanceData* destination) const {
+    const uint32_t chunkCount = (count + ChunkSize - 1) / ChunkSize;
+    if (!parallelFor || chunkCount < 2) {
+        WriteRange(source, 0, count, destination);
+        return;
+    }
+    parallelFor(chunkCount, [&](uint32_t chunk) {
+        uint32_t begin = chunk * ChunkSize;
+        uint32_t end   = begin + ChunkSize < count ? begin + ChunkSize : count;
+        WriteRange(source, begin, end, destination);
+    });
+}
+
+void InstanceWriter::WriteRangeScalar(const InstanceSource& source,
+                                      uint32_t begin,
+                                      uint32_t end,
+                                      InstanceData* destination) {
+    for (uint32_t i = begin; i < end; ++i) {
+        WriteOne(source, i, destination[i]);
+    }
+}
+
+#if INSTANCE_WRITER_SSE2
+
+void InstanceWriter::WriteRange(const InstanceSource& source,
+                                uint32_t begin,
+                                uint32_t end,
+                                InstanceData* destination) {
+    // Streaming stores need 16-byte alignment, which alignas(16) InstanceData guarantees
+    // (mapped D3D buffers are at least 16-byte aligned as well)
+    assert((reinterpret_cast<uintptr_t>(destination) & 15) == 0 && "misaligned InstanceData");
+
+    const __m128 one       = _mm_set1_ps(1.0f);
+    const __m128 two       = _mm_set1_ps(2.0f);
+    const __m128 toUnit    = _mm_set1_ps(1.0f / 255.0f);
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+
+    uint32_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        // ========================================
+        // 1. LOAD FOUR INSTANCES (SOA)
+        // ========================================
+        __m128 x = _mm_loadu_ps(source.rotationX + i);
+        __m128 y = _mm_loadu_ps(source.rotationY + i);
+        __m128 z = _mm_loadu_ps(source.rotationZ + i);
+        __m128 w = _mm_loadu_ps(source.rotationW + i);
+        __m128 s = _mm_loadu_ps(source.scale + i);
+
+        // ========================================
+        // 2. QUATERNION TO SCALED ROTATION ROWS
+        // ========================================
+        __m128 x2 = _mm_mul_ps(two, x);
+        __m128 y2 = _mm_mul_ps(two, y);
+        __m128 z2 = _mm_mul_ps(two, z);
+        __m128 xx = _mm_mul_ps(x, x2);
+        __m128 yy = _mm_mul_ps(y, y2);
+        __m128 zz = _mm_mul_ps(z, z2);
+        __m128 xy = _mm_mul_ps(x, y2);
+        __m128 xz = _mm_mul_ps(x, z2);
+        __m128 yz = _mm_mul_ps(y, z2);
+        __m128 wx = _mm_mul_ps(w, x2);
+        __m128 wy = _mm_mul_ps(w, y2);
+        __m128 wz = _mm_mul_ps(w, z2);
+
+        __m128 m00 = _mm_mul_ps(s, _mm_sub_ps(one, _mm_add_ps(yy, zz)));
+        __m128 m01 = _mm_mul_ps(s, _mm_sub_ps(xy, wz));
+        __m128 m02 = _mm_mul_ps(s, _mm_add_ps(xz, wy));
+        __m128 m10 = _mm_mul_ps(s, _mm_add_ps(xy, wz));
+        __m128 m11 = _mm_mul_ps(s, _mm_sub_ps(one, _mm_add_ps(xx, zz)));
+        __m128 m12 = _mm_mul_ps(s, _mm_sub_ps(yz, wx));
+        __m128 m20 = _mm_mul_ps(s, _mm_sub_ps(xz, wy));
+        __m128 m21 = _mm_mul_ps(s, _mm_add_ps(yz, wx));
+        __m128 m22 = _mm_mul_ps(s, _mm_sub_ps(one, _mm_add_ps(xx, yy)));
+        __m128 tx  = _mm_loadu_ps(source.positionX + i);
+        __m128 ty  = _mm_loadu_ps(source.positionY + i);
+        __m128 tz  = _mm_loadu_ps(source.positionZ + i);
+
+        // ========================================
+        // 3. RGBA8 TO FLOAT COLOR
+        // ========================================
+        __m128i rgba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source.color + i));
+        __m128 r     = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(rgba, byteMask)), toUnit);
+        __m128 g     = _mm_mul_ps(
+            _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(rgba, 8), byteMask)), toUnit);
+        __m128 b = _mm_mul_ps(
+            _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(rgba, 16), byteMask)), toUnit);
+        __m128 a = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(rgba, 24)), toUnit);
+
+        // ========================================
+        // 4. TRANSPOSE TO PER-INSTANCE ROWS AND STORE
+        // ========================================
+        // After each transpose, register k holds one row of instance i + k
+        _MM_TRANSPOSE4_PS(m00, m01, m02, tx);
+        _MM_TRANSPOSE4_PS(m10, m11, m12, ty);
+        _MM_TRANSPOSE4_PS(m20, m21, m22, tz);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+
+        const __m128 rows[4][4] = {{m00, m10, m20, r},
+                                   {m01, m11, m21, g},
+                                   {m02, m12, m22, b},
+                                   {tx, ty, tz, a}};
+        for (int k = 0; k < 4; ++k) {
+            float* out = &destination[i + k].transform[0][0];
+            _mm_stream_ps(out + 0, rows[k][0]);
+            _mm_stream_ps(out + 4, rows[k][1]);
+            _mm_stream_ps(out + 8, rows[k][2]);
+            _mm_stream_ps(out + 12, rows[k][3]);
+        }
+    }
+    _mm_sfence(); // Make the streamed rows visible before the buffer is unmapped
+
+    for (; i < end; ++i) {
+        WriteOne(source, i, destination[i]);
+    }
+}
+
+#else
+
+void InstanceWriter::WriteRange(const InstanceSource& source,
+                                uint32_t begin,
+                                uint32_t end,
+                                InstanceData* destination) {
+    WriteRangeScalar(source, begin, end, destination);
+}
+
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+#include "RenderBackend.h"
+#include "threading/ParallelFor.h"
+#include <cstdint>
+
+// Instance Source
+// Structure-of-arrays view of the objects to draw; every array holds at least count values
+struct InstanceSource {
+    const float* positionX = nullptr;
+    const float* positionY = nullptr;
+    const float* positionZ = nullptr;
+    const float* rotationX = nullptr; // Unit quaternion
+    const float* rotationY = nullptr;
+    const float* rotationZ = nullptr;
+    const float* rotationW = nullptr;
+    const float* scale     = nullptr; // Uniform scale
+    const uint32_t* color  = nullptr; // RGBA8, red in the low byte
+};
+
+// Instance Writer Class
+// Packs an InstanceSource into InstanceData (3x4 transform + float color), four instances
+// per SSE iteration: quaternions become rotation rows, scale and translation are folded
+// in, and the 4x4 blocks are transposed into per-instance rows. The rows are written with
+// streaming stores, which suits write-combined mapped GPU memory (and avoids reading the
+// destination into cache for plain memory); destinations must be 16-byte aligned.
+// Large batches are split into chunks for a ParallelFor.
+class InstanceWriter {
+  public:
+    // Instances per parallel task; smaller batches are written on the calling thread
+    static constexpr uint32_t ChunkSize = 16384;
+
+    // Install a parallel executor (default: serial)
+    void SetParallelFor(ParallelFor executor) {
+        parallelFor = std::move(executor);
+    }
+
+    // Write instances [0, count) of source to destination[0, count)
+    void Write(const InstanceSource& source, uint32_t count, InstanceData* destination) const;
+
+    // Single-threaded range writers; Write uses the SIMD one
+    static void WriteRange(const InstanceSource& source,
+                           uint32_t begin,
+                           uint32_t end,
+                           InstanceData* destination);
+    static void WriteRangeScalar(const InstanceSource& source,
+                                 uint32_t begin,
+                                 uint32_t end,
+                                 InstanceData* destination);
+
+  private:
+    ParallelFor parallelFor;
+};
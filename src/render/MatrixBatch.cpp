@@ -0,0 +1,135 @@
+#include "MatrixBatch.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATRIX_BATCH_SSE2 1
+#include <emmintrin.h>
+#else
+#define MATRIX_BATCH_SSE2 0
+#endif
+
+namespace {
+
+// First float of result index; only 4-byte aligned in general
+float* ResultAt(void* destination, size_t stride, uint32_t index) {
+    return reinterpret_cast<float*>(static_cast<uint8_t*>(destination) + index * stride);
+}
+
+} // namespace
+
+void MatrixBatch::Multiply(const Float4x4* left,
+                           const Float4x4& right,
+                           uint32_t count,
+                           void* destination,
+                           size_t stride) const {
+    const uint32_t chunkCount = (count + ChunkSize - 1) / ChunkSize;
+    if (!parallelFor || chunkCount < 2) {
+        MultiplyRange(left, right, 0, count, destination, stride);
+        return;
+    }
+    parallelFor(chunkCount, [&](uint32_t chunk) {
+        uint32_t begin = chunk * ChunkSize;
+        uint32_t end   = begin + ChunkSize < count ? begin + ChunkSize : count;
+        MultiplyRange(left, right, begin, end, destination, stride);
+    });
+}
+
+void MatrixBatch::MultiplyRangeScalar(const Float4x4* left,
+                                      const Float4x4& right,
+                                      uint32_t begin,
+                                      uint32_t end,
+                                      void* destination,
+                                      size_t stride) {
+    for (uint32_t i = begin; i < end; ++i) {
+        const Float4x4& a = left[i];
+        Float4x4 result;
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                result.m[row][column] = a.m[row][0] * right.m[0][column] +
+                                        a.m[row][1] * right.m[1][column] +
+                                        a.m[row][2] * right.m[2][column] +
+                                        a.m[row][3] * right.m[3][column];
+            }
+        }
+        std::memcpy(ResultAt(destination, stride, i), &result, sizeof(result));
+    }
+}
+
+#if MATRIX_BATCH_SSE2
+
+Float4x4 Float4x4::Multiply(const Float4x4& a, const Float4x4& b) {
+    const __m128 r0 = _mm_load_ps(b.m[0]);
+    const __m128 r1 = _mm_load_ps(b.m[1]);
+    const __m128 r2 = _mm_load_ps(b.m[2]);
+    const __m128 r3 = _mm_load_ps(b.m[3]);
+
+    Float4x4 result;
+    for (int row = 0; row < 4; ++row) {
+        const __m128 v = _mm_load_ps(a.m[row]);
+        __m128 sum     = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r1));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r2));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), r3));
+        _mm_store_ps(result.m[row], sum);
+    }
+    return result;
+}
+
+void MatrixBatch::MultiplyRange(const Float4x4* left,
+                                const Float4x4& right,
+                                uint32_t begin,
+                                uint32_t end,
+                                void* destination,
+                                size_t stride) {
+    // Streaming stores only pay off when every result fills one whole cache line (constant
+    // buffer slots in a mapped page do); a result split across two lines leaves partial
+    // write-combining buffers, which is several times slower than ordinary stores
+    const bool streaming =
+        ((reinterpret_cast<uintptr_t>(destination) | static_cast<uintptr_t>(stride)) & 63) == 0;
+
+    const __m128 r0 = _mm_load_ps(right.m[0]);
+    const __m128 r1 = _mm_load_ps(right.m[1]);
+    const __m128 r2 = _mm_load_ps(right.m[2]);
+    const __m128 r3 = _mm_load_ps(right.m[3]);
+
+    for (uint32_t i = begin; i < end; ++i) {
+        const Float4x4& a = left[i];
+        float* out        = ResultAt(destination, stride, i);
+
+        // Row k of the result is a[k][0] * r0 + a[k][1] * r1 + a[k][2] * r2 + a[k][3] * r3
+        for (int row = 0; row < 4; ++row) {
+            const __m128 v = _mm_load_ps(a.m[row]);
+            __m128 sum     = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r1));
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r2));
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), r3));
+            if (streaming) {
+                _mm_stream_ps(out + row * 4, sum);
+            } else {
+                _mm_storeu_ps(out + row * 4, sum);
+            }
+        }
+    }
+    if (streaming) {
+        _mm_sfence(); // Make the streamed rows visible before the buffer is unmapped
+    }
+}
+
+#else
+
+Float4x4 Float4x4::Multiply(const Float4x4& a, const Float4x4& b) {
+    Float4x4 result;
+    MatrixBatch::MultiplyRangeScalar(&a, b, 0, 1, &result, sizeof(result));
+    return result;
+}
+
+void MatrixBatch::MultiplyRange(const Float4x4* left,
+                                const Float4x4& right,
+                                uint32_t begin,
+                                uint32_t end,
+                                void* destination,
+                                size_t stride) {
+    MultiplyRangeScalar(left, right, begin, end, destination, stride);
+}
+
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+#include "threading/ParallelFor.h"
+#include <cstddef>
+#include <cstdint>
+
+// Float4x4
+// Row-major 4x4 matrix in the row-vector convention (p' = p * M, as DirectXMath), so a
+// transform's translation is row 3. HLSL reads it as declared row_major.
+struct alignas(16) Float4x4 {
+    float m[4][4];
+
+    static Float4x4 Identity() {
+        return {{{1.0f, 0.0f, 0.0f, 0.0f},
+                 {0.0f, 1.0f, 0.0f, 0.0f},
+                 {0.0f, 0.0f, 1.0f, 0.0f},
+                 {0.0f, 0.0f, 0.0f, 1.0f}}};
+    }
+
+    // a * b (apply a, then b) with SSE when available; ordinary stores, so the result
+    // stays in cache for products that chain (parent to child)
+    static Float4x4 Multiply(const Float4x4& a, const Float4x4& b);
+};
+
+// Matrix Batch Class
+// Multiplies many matrices by one shared matrix (world by view-projection), one matrix per
+// iteration with SSE: the shared matrix's rows stay in four registers and every output row
+// is a sum of them weighted by the broadcast elements of an input row. Results go to a
+// strided destination, so they can land straight in 256-byte constant buffer slots, with
+// streaming stores when every result is a whole cache line (write-combined mapped memory).
+// Large batches are split into chunks for a ParallelFor.
+class MatrixBatch {
+  public:
+    // Matrices per parallel task; smaller batches are multiplied on the calling thread
+    static constexpr uint32_t ChunkSize = 8192;
+
+    // Install a parallel executor (default: serial)
+    void SetParallelFor(ParallelFor executor) {
+        parallelFor = std::move(executor);
+    }
+
+    /*
+    destination + i * stride = left[i] * right, for i in [0, count)
+    stride: Bytes between results, at least sizeof(Float4x4)
+    */
+    void Multiply(const Float4x4* left,
+                  const Float4x4& right,
+                  uint32_t count,
+                  void* destination,
+                  size_t stride) const;
+
+    // Single-threaded range multipliers; Multiply uses the SIMD one
+    static void MultiplyRange(const Float4x4* left,
+                              const Float4x4& right,
+                              uint32_t begin,
+                              uint32_t end,
+                              void* destination,
+                              size_t stride);
+    static void MultiplyRangeScalar(const Float4x4* left,
+                                    const Float4x4& right,
+                                    uint32_t begin,
+                                    uint32_t end,
+                                    void* destination,
+                                    size_t stride);
+
+  private:
+    ParallelFor parallelFor;
+};
@@ -0,0 +1,390 @@
+#include "MeshFile.h"
+#include "utils/Lz4.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static_assert(sizeof(MeshFile::Header) == 208, "mesh layout is part of the file format");
+static_assert(sizeof(MeshFile::Submesh) == 88, "mesh layout is part of the file format");
+static_assert(sizeof(MeshFile::Meshlet) == 40, "mesh layout is part of the file format");
+static_assert(sizeof(MeshFile::Lod) == 20, "mesh layout is part of the file format");
+
+namespace {
+
+void AlignSection(std::vector<uint8_t>& out) {
+    const size_t alignMask = MeshFile::SectionAlign - 1;
+    out.resize((out.size() + alignMask) & ~alignMask, 0);
+}
+
+template <typename Index>
+bool IndicesInRange(const void* data,
+                    uint32_t indexStart,
+                    uint32_t indexCount,
+                    uint32_t baseVertex,
+                    uint32_t vertexCount) {
+    const Index* indices = static_cast<const Index*>(data) + indexStart;
+    for (uint32_t i = 0; i < indexCount; ++i) {
+        if (static_cast<uint64_t>(indices[i]) + baseVertex >= vertexCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every meshlet of [meshletStart, meshletStart + meshletCount) within the index range
+bool MeshletsInRange(const MeshFile::Meshlet* meshlets,
+                     uint32_t meshletStart,
+                     uint32_t meshletCount,
+                     uint32_t indexStart,
+                     uint32_t indexCount) {
+    for (uint32_t m = meshletStart; m < meshletStart + meshletCount; ++m) {
+        if (meshlets[m].indexStart < indexStart ||
+            uint64_t(meshlets[m].indexStart) + meshlets[m].indexCount >
+                uint64_t(indexStart) + indexCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// ========================================
+// 1. READER
+// ========================================
+
+bool MeshFile::Open(const std::string& path) {
+    Close();
+    if (!file.Open(path)) {
+        return false;
+    }
+    if (!Load(file.GetData(), file.GetSize())) {
+        file.Close();
+        return false;
+    }
+    return true;
+}
+
+bool MeshFile::Load(const uint8_t* data, size_t size) {
+    header    = {};
+    submeshes = nullptr;
+    meshlets  = nullptr;
+    lods      = nullptr;
+    vertices  = nullptr;
+    indices   = nullptr;
+    decoded.clear();
+
+    Header loaded;
+    if (size < sizeof(Header)) {
+        return false;
+    }
+    std::memcpy(&loaded, data, sizeof(loaded));
+    if (loaded.magic != Magic || loaded.version != Version || (loaded.flags & ~Compressed) != 0 ||
+        (loaded.indexSize != 2 && loaded.indexSize != 4) || loaded.vertexStride == 0) {
+        return false;
+    }
+
+    // Section sizes follow from the counts, so a mismatch means a truncated or foreign file
+    const bool compressed   = (loaded.flags & Compressed) != 0;
+    const Section* sections = loaded.sections;
+    if (sections[Submeshes].size != uint64_t(loaded.submeshCount) * sizeof(Submesh) ||
+        sections[Vertices].size != uint64_t(loaded.vertexCount) * loaded.vertexStride ||
+        sections[Indices].size != uint64_t(loaded.indexCount) * loaded.indexSize ||
+        sections[Meshlets].size != uint64_t(loaded.meshletCount) * sizeof(Meshlet) ||
+        sections[Lods].size != uint64_t(loaded.lodCount) * sizeof(Lod) ||
+        sections[Submeshes].storedSize != sections[Submeshes].size ||
+        sections[Meshlets].storedSize != sections[Meshlets].size ||
+        sections[Lods].storedSize != sections[Lods].size) {
+        return false;
+    }
+    for (uint32_t i = 0; i < SectionCount; ++i) {
+        if (sections[i].offset % SectionAlign != 0 || sections[i].offset > size ||
+            sections[i].storedSize > size - sections[i].offset ||
+            (!compressed && sections[i].storedSize != sections[i].size)) {
+            return false;
+        }
+    }
+
+    // The submesh, meshlet and LOD tables are small; every range is checked here so draws
+    // need not
+    const Submesh* table    = reinterpret_cast<const Submesh*>(data + sections[Submeshes].offset);
+    const Meshlet* clusters = reinterpret_cast<const Meshlet*>(data + sections[Meshlets].offset);
+    const Lod* levels       = reinterpret_cast<const Lod*>(data + sections[Lods].offset);
+    for (uint32_t i = 0; i < loaded.submeshCount; ++i) {
+        const Submesh& submesh = table[i];
+        if (submesh.name[MaxNameLen] != '\0' || submesh.indexStart > loaded.indexCount ||
+            submesh.indexCount > loaded.indexCount - submesh.indexStart ||
+            submesh.baseVertex > loaded.vertexCount ||
+            submesh.vertexCount > loaded.vertexCount - submesh.baseVertex ||
+            submesh.meshletStart > loaded.meshletCount ||
+            submesh.meshletCount > loaded.meshletCount - submesh.meshletStart ||
+            submesh.lodStart > loaded.lodCount ||
+            submesh.lodCount > loaded.lodCount - submesh.lodStart ||
+            !MeshletsInRange(clusters,
+                             submesh.meshletStart,
+                             submesh.meshletCount,
+                             submesh.indexStart,
+                             submesh.indexCount)) {
+            return false;
+        }
+        for (uint32_t l = submesh.lodStart; l < submesh.lodStart + submesh.lodCount; ++l) {
+            const Lod& lod = levels[l];
+            if (lod.indexStart > loaded.indexCount ||
+                lod.indexCount > loaded.indexCount - lod.indexStart ||
+                lod.meshletStart > loaded.meshletCount ||
+                lod.meshletCount > loaded.meshletCount - lod.meshletStart ||
+                !MeshletsInRange(
+                    clusters, lod.meshletStart, lod.meshletCount, lod.indexStart, lod.indexCount)) {
+                return false;
+            }
+        }
+    }
+
+    if (compressed) {
+        const size_t vertexSize = static_cast<size_t>(sections[Vertices].size);
+        const size_t indexSize  = static_cast<size_t>(sections[Indices].size);
+        decoded.resize(vertexSize + indexSize);
+        if (!Lz4::Decompress(data + sections[Vertices].offset,
+                             static_cast<size_t>(sections[Vertices].storedSize),
+                             decoded.data(),
+                             vertexSize) ||
+            !Lz4::Decompress(data + sections[Indices].offset,
+                             static_cast<size_t>(sections[Indices].storedSize),
+                             decoded.data() + vertexSize,
+                             indexSize)) {
+            decoded.clear();
+            return false;
+        }
+        vertices = decoded.data();
+        indices  = decoded.data() + vertexSize;
+    } else {
+        vertices = data + sections[Vertices].offset;
+        indices  = data + sections[Indices].offset;
+    }
+
+    header    = loaded;
+    submeshes = table;
+    meshlets  = clusters;
+    lods      = levels;
+    return true;
+}
+
+void MeshFile::Close() {
+    file.Close();
+    header    = {};
+    submeshes = nullptr;
+    meshlets  = nullptr;
+    lods      = nullptr;
+    vertices  = nullptr;
+    indices   = nullptr;
+    decoded.clear();
+    decoded.shrink_to_fit();
+}
+
+bool MeshFile::Verify() const {
+    auto inRange = [this](uint32_t indexStart, uint32_t indexCount, uint32_t baseVertex) {
+        return header.indexSize == 2
+                   ? IndicesInRange<uint16_t>(
+                         indices, indexStart, indexCount, baseVertex, header.vertexCount)
+                   : IndicesInRange<uint32_t>(
+                         indices, indexStart, indexCount, baseVertex, header.vertexCount);
+    };
+
+    for (uint32_t i = 0; i < header.submeshCount; ++i) {
+        const Submesh& submesh = submeshes[i];
+        if (!inRange(submesh.indexStart, submesh.indexCount, submesh.baseVertex)) {
+            return false;
+        }
+        for (uint32_t l = submesh.lodStart; l < submesh.lodStart + submesh.lodCount; ++l) {
+            if (!inRange(lods[l].indexStart, lods[l].indexCount, submesh.baseVertex)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+uint64_t MeshFile::LayoutHash(const VertexElement* elements, uint32_t count, uint32_t stride) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    auto mix      = [&hash](uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * 0x100000001B3ull;
+        }
+    };
+
+    for (uint32_t i = 0; i < count; ++i) {
+        for (const char* c = elements[i].semantic; *c; ++c) {
+            hash = (hash ^ static_cast<uint8_t>(*c)) * 0x100000001B3ull;
+        }
+        mix(elements[i].semanticIndex);
+        mix(static_cast<uint32_t>(elements[i].format));
+        mix(elements[i].offset);
+    }
+    mix(stride);
+    return hash;
+}
+
+// ========================================
+// 2. WRITER
+// ========================================
+
+void MeshFileWriter::SetVertices(const void* data,
+                                 uint32_t count,
+                                 uint32_t stride,
+                                 uint64_t layoutHash) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    vertices.assign(bytes, bytes + size_t(count) * stride);
+    header.vertexCount  = count;
+    header.vertexStride = stride;
+    header.layoutHash   = layoutHash;
+}
+
+void MeshFileWriter::SetIndices(const uint32_t* data, uint32_t count) {
+    const uint32_t maxIndex = count > 0 ? *std::max_element(data, data + count) : 0;
+    header.indexCount       = count;
+    header.indexSize        = maxIndex <= 0xFFFF ? 2 : 4;
+
+    indices.resize(size_t(count) * header.indexSize);
+    if (header.indexSize == 4) {
+        std::memcpy(indices.data(), data, indices.size());
+        return;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint16_t index = static_cast<uint16_t>(data[i]);
+        std::memcpy(indices.data() + i * sizeof(index), &index, sizeof(index));
+    }
+}
+
+void MeshFileWriter::SetMeshlets(const MeshFile::Meshlet* data, uint32_t count) {
+    meshlets.assign(data, data + count);
+}
+
+void MeshFileWriter::SetLods(const MeshFile::Lod* data, uint32_t count) {
+    lods.assign(data, data + count);
+}
+
+void MeshFileWriter::SetBounds(const float min[3], const float max[3]) {
+    std::memcpy(header.boundsMin, min, sizeof(header.boundsMin));
+    std::memcpy(header.boundsMax, max, sizeof(header.boundsMax));
+}
+
+void MeshFileWriter::SetPositionTransform(float scale, const float offset[3]) {
+    header.positionScale = scale;
+    std::memcpy(header.positionOffset, offset, sizeof(header.positionOffset));
+}
+
+bool MeshFileWriter::AddSubmesh(const std::string& name,
+                                uint32_t indexStart,
+                                uint32_t indexCount,
+                                uint32_t baseVertex,
+                                uint32_t vertexCount,
+                                const float boundsMin[3],
+                                const float boundsMax[3],
+                                uint32_t meshletStart,
+                                uint32_t meshletCount,
+                                uint32_t lodStart,
+                                uint32_t lodCount) {
+    const uint32_t totalMeshlets = static_cast<uint32_t>(meshlets.size());
+    const uint32_t totalLods     = static_cast<uint32_t>(lods.size());
+    if (name.size() > MeshFile::MaxNameLen || indexStart > header.indexCount ||
+        indexCount > header.indexCount - indexStart || baseVertex > header.vertexCount ||
+        vertexCount > header.vertexCount - baseVertex || meshletStart > totalMeshlets ||
+        meshletCount > totalMeshlets - meshletStart || lodStart > totalLods ||
+        lodCount > totalLods - lodStart ||
+        !MeshletsInRange(meshlets.data(), meshletStart, meshletCount, indexStart, indexCount)) {
+        return false;
+    }
+    for (uint32_t l = lodStart; l < lodStart + lodCount; ++l) {
+        const MeshFile::Lod& lod = lods[l];
+        if (lod.indexStart > header.indexCount ||
+            lod.indexCount > header.indexCount - lod.indexStart ||
+            lod.meshletStart > totalMeshlets ||
+            lod.meshletCount > totalMeshlets - lod.meshletStart ||
+            !MeshletsInRange(meshlets.data(),
+                             lod.meshletStart,
+                             lod.meshletCount,
+                             lod.indexStart,
+                             lod.indexCount)) {
+            return false;
+        }
+    }
+
+    MeshFile::Submesh submesh = {};
+    std::memcpy(submesh.name, name.c_str(), name.size());
+    submesh.indexStart   = indexStart;
+    submesh.indexCount   = indexCount;
+    submesh.baseVertex   = baseVertex;
+    submesh.vertexCount  = vertexCount;
+    submesh.meshletStart = meshletStart;
+    submesh.meshletCount = meshletCount;
+    submesh.lodStart     = lodStart;
+    submesh.lodCount     = lodCount;
+    std::memcpy(submesh.boundsMin, boundsMin, sizeof(submesh.boundsMin));
+    std::memcpy(submesh.boundsMax, boundsMax, sizeof(submesh.boundsMax));
+    submeshes.push_back(submesh);
+    return true;
+}
+
+std::vector<uint8_t> MeshFileWriter::Build(bool compress) const {
+    MeshFile::Header out = header;
+    out.magic            = MeshFile::Magic;
+    out.version          = MeshFile::Version;
+    out.flags            = compress ? uint32_t(MeshFile::Compressed) : 0u;
+    out.submeshCount     = static_cast<uint32_t>(submeshes.size());
+    out.meshletCount     = static_cast<uint32_t>(meshlets.size());
+    out.lodCount         = static_cast<uint32_t>(lods.size());
+    if (out.indexSize == 0) {
+        out.indexSize = 2; // No indices set
+    }
+    if (out.positionScale == 0.0f) {
+        out.positionScale = 1.0f;
+    }
+
+    std::vector<uint8_t> bytes(sizeof(MeshFile::Header), 0);
+    auto append = [&](MeshFile::SectionIndex index, const std::vector<uint8_t>& data, bool lz4) {
+        AlignSection(bytes);
+        MeshFile::Section& section = out.sections[index];
+        section.offset             = bytes.size();
+        section.size               = data.size();
+        if (lz4) {
+            bytes.resize(section.offset + Lz4::CompressBound(data.size()));
+            uint8_t* stored    = bytes.data() + section.offset;
+            section.storedSize = Lz4::Compress(
+                data.data(), data.size(), stored, bytes.size() - section.offset);
+            bytes.resize(section.offset + section.storedSize);
+        } else {
+            bytes.insert(bytes.end(), data.begin(), data.end());
+            section.storedSize = data.size();
+        }
+    };
+
+    const uint8_t* table = reinterpret_cast<const uint8_t*>(submeshes.data());
+    append(MeshFile::Submeshes,
+           std::vector<uint8_t>(table, table + submeshes.size() * sizeof(MeshFile::Submesh)),
+           false);
+    append(MeshFile::Vertices, vertices, compress);
+    append(MeshFile::Indices, indices, compress);
+
+    const uint8_t* clusters = reinterpret_cast<const uint8_t*>(meshlets.data());
+    append(MeshFile::Meshlets,
+           std::vector<uint8_t>(clusters, clusters + meshlets.size() * sizeof(MeshFile::Meshlet)),
+           false);
+
+    const uint8_t* levels = reinterpret_cast<const uint8_t*>(lods.data());
+    append(MeshFile::Lods,
+           std::vector<uint8_t>(levels, levels + lods.size() * sizeof(MeshFile::Lod)),
+           false);
+
+    std::memcpy(bytes.data(), &out, sizeof(out));
+    return bytes;
+}
+
+bool MeshFileWriter::Write(const std::string& path, bool compress) const {
+    std::vector<uint8_t> bytes = Build(compress);
+    FILE* file                 = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && ok;
+}
@@ -0,0 +1,235 @@
+#pragma once
+#include "render/VertexFormat.h"
+#include "utils/MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Mesh File Class
+// Read side of the binary mesh container written by MeshFileWriter (tools/MeshConverter):
+//
+//   Header | Submesh[submeshCount] | vertices | indices | Meshlet[meshletCount] | Lod[lodCount]
+//
+// (sections 16-byte aligned)
+//
+// Vertex and index sections are stored exactly as the input assembler reads them, so an
+// uncompressed file is memory-mapped and its sections handed to CreateBuffer as
+// D3D11_SUBRESOURCE_DATA without parsing or copying. Compressed files (LZ4 blocks) are
+// decoded once at load into memory owned by this object; the interface is the same.
+//
+// The vertex section is tagged with the stride and a hash of the VertexFormat it was written
+// with; HasVertexFormat<V>() checks a file against the struct the input layout is built from.
+class MeshFile {
+  public:
+    static constexpr uint32_t Magic        = 0x4853454D; // "MESH"
+    static constexpr uint32_t Version      = 3;          // 2: meshlets, 3: LODs
+    static constexpr uint32_t MaxNameLen   = 31;         // Excluding the terminator
+    static constexpr uint32_t SectionAlign = 16;
+
+    enum Flags : uint32_t { Compressed = 1 }; // Vertex and index sections are LZ4 blocks
+
+    enum SectionIndex : uint32_t {
+        Submeshes = 0,
+        Vertices,
+        Indices,
+        Meshlets,
+        Lods,
+        SectionCount
+    };
+
+    struct Section {
+        uint64_t offset;     // From the start of the file
+        uint64_t size;       // Decoded size in bytes
+        uint64_t storedSize; // Bytes in the file; equals size unless compressed
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t flags;
+        uint32_t vertexStride;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t indexSize; // 2 or 4 bytes (DXGI_FORMAT_R16_UINT / R32_UINT)
+        uint32_t submeshCount;
+        uint32_t meshletCount;
+        uint32_t lodCount;
+        uint64_t layoutHash; // LayoutHash of the vertex struct
+        float boundsMin[3];  // Whole mesh, in source units
+        float boundsMax[3];
+
+        // Stored positions are quantized to the bounds when the vertex format needs it:
+        // source = stored * positionScale + positionOffset (1 and 0 for float positions)
+        float positionScale;
+        float positionOffset[3];
+        Section sections[SectionCount];
+    };
+
+    // One draw call's worth of the index buffer
+    struct Submesh {
+        char name[MaxNameLen + 1];
+        uint32_t indexStart;
+        uint32_t indexCount;
+        uint32_t baseVertex; // Added to every index (DrawIndexed BaseVertexLocation)
+        uint32_t vertexCount;
+        uint32_t meshletStart; // Meshlets covering [indexStart, indexStart + indexCount)
+        uint32_t meshletCount;
+        uint32_t lodStart; // Coarser versions (LOD 1 onwards), finest first
+        uint32_t lodCount;
+        float boundsMin[3];
+        float boundsMax[3];
+    };
+
+    /*
+    A simplified copy of a submesh's triangles, drawn like the submesh itself (same
+    baseVertex and vertex range) with its own index range and meshlets
+    */
+    struct Lod {
+        uint32_t indexStart;
+        uint32_t indexCount;
+        uint32_t meshletStart;
+        uint32_t meshletCount;
+        float error; // Distance from the full-detail surface, in source units
+    };
+
+    /*
+    Consecutive triangles of one submesh, drawn with that submesh's baseVertex
+    Culled as a whole: outside the frustum if the sphere is, and back-facing from camera c
+    if dot(center - c, coneAxis) >= coneCutoff * length(center - c) + radius
+    (coneCutoff is 1 when the triangles face too many ways to ever pass)
+    */
+    struct Meshlet {
+        uint32_t indexStart; // Into the whole index buffer, like Submesh::indexStart
+        uint32_t indexCount;
+        float center[3]; // Bounding sphere, in stored position units
+        float radius;
+        float coneAxis[3]; // Average front-face normal
+        float coneCutoff;  // Sine of the widest angle between a normal and the axis
+    };
+
+    // Map, validate and (for compressed files) decode a mesh file
+    bool Open(const std::string& path);
+
+    /*
+    Validate a mesh file already in memory (not copied if uncompressed; must outlive this)
+    Checks the header, the section ranges and every submesh range; vertex and index pages
+    are not touched
+    */
+    bool Load(const uint8_t* data, size_t size);
+
+    void Close();
+
+    // Check every index against the vertex count; touches all index pages
+    bool Verify() const;
+
+    const Header& GetHeader() const {
+        return header;
+    }
+    uint32_t GetSubmeshCount() const {
+        return header.submeshCount;
+    }
+    const Submesh& GetSubmesh(uint32_t index) const {
+        return submeshes[index];
+    }
+    uint32_t GetMeshletCount() const {
+        return header.meshletCount;
+    }
+    const Meshlet& GetMeshlet(uint32_t index) const {
+        return meshlets[index];
+    }
+    uint32_t GetLodCount() const {
+        return header.lodCount;
+    }
+    const Lod& GetLod(uint32_t index) const {
+        return lods[index];
+    }
+
+    const void* GetVertexData() const {
+        return vertices;
+    }
+    size_t GetVertexDataSize() const {
+        return static_cast<size_t>(header.sections[Vertices].size);
+    }
+    const void* GetIndexData() const {
+        return indices;
+    }
+    size_t GetIndexDataSize() const {
+        return static_cast<size_t>(header.sections[Indices].size);
+    }
+
+    template <typename V>
+    bool HasVertexFormat() const {
+        return header.vertexStride == sizeof(V) && header.layoutHash == LayoutHash<V>();
+    }
+
+    // 64-bit FNV-1a over the semantic, index, format and offset of each element and the stride
+    static uint64_t LayoutHash(const VertexElement* elements, uint32_t count, uint32_t stride);
+
+    template <typename V>
+    static uint64_t LayoutHash() {
+        return LayoutHash(VertexFormat<V>::Elements, VertexFormat<V>::Count, sizeof(V));
+    }
+
+  private:
+    MappedFile file;
+    Header header            = {};
+    const Submesh* submeshes = nullptr;
+    const Meshlet* meshlets  = nullptr;
+    const Lod* lods          = nullptr;
+    const uint8_t* vertices  = nullptr;
+    const uint8_t* indices   = nullptr;
+    std::vector<uint8_t> decoded; // Vertex then index bytes of a compressed file
+};
+
+// Mesh File Writer Class
+// Collects one mesh (vertices, indices, submeshes) and lays it out as a MeshFile
+class MeshFileWriter {
+  public:
+    // Vertices in the exact layout the file should carry; copied
+    template <typename V>
+    void SetVertices(const V* data, uint32_t count) {
+        SetVertices(data, count, sizeof(V), MeshFile::LayoutHash<V>());
+    }
+    void SetVertices(const void* data, uint32_t count, uint32_t stride, uint64_t layoutHash);
+
+    // Stored as 16-bit when every index fits, 32-bit otherwise
+    void SetIndices(const uint32_t* data, uint32_t count);
+
+    void SetBounds(const float min[3], const float max[3]);
+    void SetPositionTransform(float scale, const float offset[3]);
+
+    // Meshlets of every submesh and LOD, in submesh order; copied
+    void SetMeshlets(const MeshFile::Meshlet* data, uint32_t count);
+
+    // LODs of every submesh, in submesh order; copied
+    void SetLods(const MeshFile::Lod* data, uint32_t count);
+
+    /*
+    Fails on a range outside the indices, meshlets or LODs set so far, a meshlet outside the
+    index range it belongs to, or a name longer than MaxNameLen
+    */
+    bool AddSubmesh(const std::string& name,
+                    uint32_t indexStart,
+                    uint32_t indexCount,
+                    uint32_t baseVertex,
+                    uint32_t vertexCount,
+                    const float boundsMin[3],
+                    const float boundsMax[3],
+                    uint32_t meshletStart = 0,
+                    uint32_t meshletCount = 0,
+                    uint32_t lodStart     = 0,
+                    uint32_t lodCount     = 0);
+
+    // Serialize; compress stores the vertex and index sections as LZ4 blocks
+    std::vector<uint8_t> Build(bool compress) const;
+    bool Write(const std::string& path, bool compress) const;
+
+  private:
+    MeshFile::Header header = {};
+    std::vector<MeshFile::Submesh> submeshes;
+    std::vector<MeshFile::Meshlet> meshlets;
+    std::vector<MeshFile::Lod> lods;
+    std::vector<uint8_t> vertices;
+    std::vector<uint8_t> indices;
+};
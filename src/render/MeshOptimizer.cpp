@@ -0,0 +1,679 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t Invalid = ~0u;
+
+const float* PositionAt(const float* positions, size_t stride, uint32_t vertex) {
+    return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) +
+                                          vertex * stride);
+}
+
+// Front-face normal (not normalized) of a clockwise triangle in D3D's left-handed space
+void FaceNormal(const float* a, const float* b, const float* c, float normal[3]) {
+    const float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    const float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    normal[0]         = e1[1] * e2[2] - e1[2] * e2[1];
+    normal[1]         = e1[2] * e2[0] - e1[0] * e2[2];
+    normal[2]         = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+float Length(const float v[3]) {
+    return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+// FIFO post-transform cache: a vertex is resident if it was one of the last size misses
+class FifoCache {
+  public:
+    FifoCache(uint32_t vertexCount, uint32_t size)
+        : stamps(vertexCount, 0), time(size + 1), size(size) {}
+
+    // 1 on a miss
+    uint32_t Touch(uint32_t vertex) {
+        if (time - stamps[vertex] > size) {
+            stamps[vertex] = time++;
+            return 1;
+        }
+        return 0;
+    }
+
+    // Forget everything (no vertex is within size misses of the new time)
+    void Reset() {
+        time += size + 1;
+    }
+
+  private:
+    std::vector<uint32_t> stamps;
+    uint32_t time;
+    uint32_t size;
+};
+
+// ========================================
+// FORSYTH SCORING
+// ========================================
+// Vertices score for being recently used (but the last triangle's three score less, so the
+// strip does not turn back on itself) and for having few triangles left, so isolated
+// triangles are finished instead of being left behind
+constexpr uint32_t LruSize          = 32;
+constexpr float CacheDecayPower     = 1.5f;
+constexpr float LastTriangleScore   = 0.75f;
+constexpr float ValenceBoostScale   = 2.0f;
+constexpr float ValenceBoostPower   = 0.5f;
+constexpr uint32_t ValenceTableSize = 32;
+
+struct ScoreTables {
+    float cache[LruSize];
+    float valence[ValenceTableSize];
+
+    ScoreTables() {
+        for (uint32_t i = 0; i < LruSize; ++i) {
+            const float scale = 1.0f / static_cast<float>(LruSize - 3);
+            cache[i]          = i < 3 ? LastTriangleScore
+                                      : std::pow(1.0f - static_cast<float>(i - 3) * scale,
+                                        CacheDecayPower);
+        }
+        valence[0] = 0.0f;
+        for (uint32_t i = 1; i < ValenceTableSize; ++i) {
+            valence[i] = ValenceBoostScale * std::pow(static_cast<float>(i), -ValenceBoostPower);
+        }
+    }
+
+    float Score(int32_t cachePosition, uint32_t remaining) const {
+        if (remaining == 0) {
+            return -1.0f; // Nothing left to draw with it
+        }
+        const float boost =
+            remaining < ValenceTableSize
+                ? valence[remaining]
+                : ValenceBoostScale * std::pow(static_cast<float>(remaining), -ValenceBoostPower);
+        return (cachePosition >= 0 ? cache[cachePosition] : 0.0f) + boost;
+    }
+};
+
+} // namespace
+
+namespace MeshOptimizer {
+
+// ========================================
+// 1. WELDING
+// ========================================
+
+uint32_t GenerateRemap(uint32_t* remap, const void* vertices, uint32_t vertexCount, size_t stride) {
+    // Open addressing over the vertex bytes (FNV-1a), at most half full
+    const uint8_t* bytes = static_cast<const uint8_t*>(vertices);
+    size_t capacity      = 16;
+    while (capacity < size_t(vertexCount) * 2) {
+        capacity *= 2;
+    }
+    std::vector<uint32_t> table(capacity, Invalid);
+
+    uint32_t unique = 0;
+    for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+        const uint8_t* data = bytes + vertex * stride;
+        uint32_t hash       = 2166136261u;
+        for (size_t i = 0; i < stride; ++i) {
+            hash = (hash ^ data[i]) * 16777619u;
+        }
+
+        size_t slot = hash & (capacity - 1);
+        while (table[slot] != Invalid &&
+               std::memcmp(bytes + table[slot] * stride, data, stride) != 0) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        if (table[slot] == Invalid) {
+            table[slot]  = vertex;
+            remap[vertex] = unique++;
+        } else {
+            remap[vertex] = remap[table[slot]];
+        }
+    }
+    return unique;
+}
+
+void RemapIndices(uint32_t* indices, uint32_t indexCount, const uint32_t* remap) {
+    for (uint32_t i = 0; i < indexCount; ++i) {
+        indices[i] = remap[indices[i]];
+    }
+}
+
+void RemapVertices(void* destination,
+                   const void* vertices,
+                   uint32_t vertexCount,
+                   size_t stride,
+                   const uint32_t* remap) {
+    const uint8_t* source = static_cast<const uint8_t*>(vertices);
+    uint8_t* target       = static_cast<uint8_t*>(destination);
+    for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+        if (remap[vertex] != Invalid) {
+            std::memcpy(target + remap[vertex] * stride, source + vertex * stride, stride);
+        }
+    }
+}
+
+// ========================================
+// 2. VERTEX CACHE ORDER
+// ========================================
+
+void OptimizeVertexCache(uint32_t* destination,
+                         const uint32_t* indices,
+                         uint32_t indexCount,
+                         uint32_t vertexCount) {
+    static const ScoreTables scores;
+    const uint32_t triangleCount = indexCount / 3;
+
+    // Triangles of each vertex (CSR); remaining[v] shrinks as they are emitted, and emitted
+    // triangles are swapped out of the live part of the list
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    std::vector<uint32_t> firstTriangle(vertexCount + 1, 0);
+    for (uint32_t i = 0; i < triangleCount * 3; ++i) {
+        ++remaining[indices[i]];
+    }
+    for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+        firstTriangle[vertex + 1] = firstTriangle[vertex] + remaining[vertex];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    std::vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+    for (uint32_t i = 0; i < triangleCount * 3; ++i) {
+        adjacency[fill[indices[i]]++] = i / 3;
+    }
+
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+        vertexScore[vertex] = scores.Score(-1, remaining[vertex]);
+    }
+    std::vector<uint8_t> emitted(triangleCount, 0);
+
+    auto triangleScore = [&](uint32_t triangle) {
+        const uint32_t* corner = indices + triangle * 3;
+        return vertexScore[corner[0]] + vertexScore[corner[1]] + vertexScore[corner[2]];
+    };
+
+    // Start from the best triangle overall
+    uint32_t best   = Invalid;
+    float bestScore = -FLT_MAX;
+    for (uint32_t triangle = 0; triangle < triangleCount; ++triangle) {
+        const float score = triangleScore(triangle);
+        if (score > bestScore) {
+            bestScore = score;
+            best      = triangle;
+        }
+    }
+
+    uint32_t cache[LruSize + 3];
+    uint32_t cacheCount = 0;
+    uint32_t cursor     = 0; // Fallback when nothing in the cache has triangles left
+    for (uint32_t output = 0; output < triangleCount; ++output) {
+        if (best == Invalid) {
+            while (emitted[cursor]) {
+                ++cursor;
+            }
+            best = cursor;
+        }
+
+        // ========================================
+        // EMIT AND UNLINK
+        // ========================================
+        const uint32_t* corner = indices + best * 3;
+        std::memcpy(destination + output * 3, corner, 3 * sizeof(uint32_t));
+        emitted[best] = 1;
+        for (int k = 0; k < 3; ++k) {
+            const uint32_t vertex = corner[k];
+            uint32_t* list        = adjacency.data() + firstTriangle[vertex];
+            uint32_t* last        = list + remaining[vertex] - 1;
+            std::iter_swap(std::find(list, last + 1, best), last);
+            --remaining[vertex];
+        }
+
+        // ========================================
+        // LRU UPDATE
+        // ========================================
+        // The triangle's vertices move to the front; whatever falls past LruSize is evicted
+        uint32_t next[LruSize + 3];
+        uint32_t nextCount = 0;
+        for (int k = 0; k < 3; ++k) {
+            if (std::find(next, next + nextCount, corner[k]) == next + nextCount) {
+                next[nextCount++] = corner[k];
+            }
+        }
+        for (uint32_t i = 0; i < cacheCount; ++i) {
+            if (std::find(next, next + nextCount, cache[i]) == next + nextCount) {
+                next[nextCount++] = cache[i];
+            }
+        }
+        for (uint32_t i = 0; i < nextCount; ++i) {
+            const uint32_t vertex = next[i];
+            cachePosition[vertex] = i < LruSize ? static_cast<int32_t>(i) : -1;
+            vertexScore[vertex]   = scores.Score(cachePosition[vertex], remaining[vertex]);
+        }
+        cacheCount = std::min(nextCount, LruSize);
+        std::memcpy(cache, next, cacheCount * sizeof(uint32_t));
+
+        // ========================================
+        // NEXT TRIANGLE
+        // ========================================
+        // Only triangles touching the cache changed score, so the best is among them
+        best      = Invalid;
+        bestScore = -FLT_MAX;
+        for (uint32_t i = 0; i < cacheCount; ++i) {
+            const uint32_t vertex = cache[i];
+            const uint32_t* list  = adjacency.data() + firstTriangle[vertex];
+            for (uint32_t t = 0; t < remaining[vertex]; ++t) {
+                const float score = triangleScore(list[t]);
+                if (score > bestScore) {
+                    bestScore = score;
+                    best      = list[t];
+                }
+            }
+        }
+    }
+}
+
+// ========================================
+// 3. OVERDRAW ORDER
+// ========================================
+
+void OptimizeOverdraw(uint32_t* destination,
+                      const uint32_t* indices,
+                      uint32_t indexCount,
+                      const float* positions,
+                      uint32_t vertexCount,
+                      size_t positionStride,
+                      float threshold) {
+    const uint32_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // ========================================
+    // CLUSTERS
+    // ========================================
+    // Hard boundaries: triangles that miss on all three vertices, where the cache is cold
+    // whatever came before. Soft boundaries: inside a hard cluster, close a cluster as soon
+    // as its own ACMR (from a cold cache) is within threshold of the whole hard cluster's
+    const uint32_t cacheSize = 16;
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<uint32_t> hard;
+    for (uint32_t triangle = 0; triangle < triangleCount; ++triangle) {
+        const uint32_t* corner = indices + triangle * 3;
+        const uint32_t misses =
+            cache.Touch(corner[0]) + cache.Touch(corner[1]) + cache.Touch(corner[2]);
+        if (misses == 3) {
+            hard.push_back(triangle);
+        }
+    }
+    hard.push_back(triangleCount);
+
+    std::vector<uint32_t> clusters; // First triangle of each, plus the end
+    for (size_t h = 0; h + 1 < hard.size(); ++h) {
+        const uint32_t begin = hard[h];
+        const uint32_t end   = hard[h + 1];
+
+        cache.Reset();
+        uint32_t clusterMisses = 0;
+        for (uint32_t triangle = begin; triangle < end; ++triangle) {
+            const uint32_t* corner = indices + triangle * 3;
+            clusterMisses +=
+                cache.Touch(corner[0]) + cache.Touch(corner[1]) + cache.Touch(corner[2]);
+        }
+        const float target =
+            threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+        cache.Reset();
+        clusters.push_back(begin);
+        uint32_t misses = 0;
+        uint32_t size   = 0;
+        for (uint32_t triangle = begin; triangle < end; ++triangle) {
+            const uint32_t* corner = indices + triangle * 3;
+            misses += cache.Touch(corner[0]) + cache.Touch(corner[1]) + cache.Touch(corner[2]);
+            ++size;
+            if (triangle + 1 < end &&
+                static_cast<float>(misses) <= target * static_cast<float>(size)) {
+                clusters.push_back(triangle + 1);
+                cache.Reset();
+                misses = 0;
+                size   = 0;
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    // ========================================
+    // SORT OUTSIDE-IN
+    // ========================================
+    // Key: how far the cluster's area-weighted centroid lies along its average normal,
+    // measured from the mesh centroid; outward-facing clusters on the hull come first
+    const uint32_t clusterCount = static_cast<uint32_t>(clusters.size()) - 1;
+    std::vector<float> centroids(clusterCount * 3, 0.0f);
+    std::vector<float> normals(clusterCount * 3, 0.0f);
+    std::vector<float> areas(clusterCount, 0.0f);
+    float meshCentroid[3] = {0.0f, 0.0f, 0.0f};
+    float meshArea        = 0.0f;
+    for (uint32_t c = 0; c < clusterCount; ++c) {
+        for (uint32_t triangle = clusters[c]; triangle < clusters[c + 1]; ++triangle) {
+            const float* a = PositionAt(positions, positionStride, indices[triangle * 3]);
+            const float* b = PositionAt(positions, positionStride, indices[triangle * 3 + 1]);
+            const float* p = PositionAt(positions, positionStride, indices[triangle * 3 + 2]);
+            float normal[3];
+            FaceNormal(a, b, p, normal);
+            const float area = Length(normal);
+            for (int axis = 0; axis < 3; ++axis) {
+                const float center = (a[axis] + b[axis] + p[axis]) / 3.0f;
+                centroids[c * 3 + axis] += center * area;
+                normals[c * 3 + axis] += normal[axis];
+                meshCentroid[axis] += center * area;
+            }
+            areas[c] += area;
+            meshArea += area;
+        }
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        meshCentroid[axis] /= meshArea > 0.0f ? meshArea : 1.0f;
+    }
+
+    std::vector<float> keys(clusterCount, 0.0f);
+    for (uint32_t c = 0; c < clusterCount; ++c) {
+        const float* normal  = &normals[c * 3];
+        const float length   = Length(normal);
+        const float weight   = areas[c] > 0.0f ? 1.0f / areas[c] : 0.0f;
+        const float scale    = length > 0.0f ? 1.0f / length : 0.0f;
+        float key            = 0.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            key += (centroids[c * 3 + axis] * weight - meshCentroid[axis]) * normal[axis] * scale;
+        }
+        keys[c] = key;
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; ++c) {
+        order[c] = c;
+    }
+    std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) {
+        return keys[a] > keys[b];
+    });
+
+    uint32_t output = 0;
+    for (uint32_t c : order) {
+        const uint32_t count = (clusters[c + 1] - clusters[c]) * 3;
+        std::memcpy(destination + output, indices + clusters[c] * 3, count * sizeof(uint32_t));
+        output += count;
+    }
+}
+
+// ========================================
+// 4. VERTEX FETCH ORDER
+// ========================================
+
+uint32_t OptimizeVertexFetch(void* destination,
+                             uint32_t* indices,
+                             uint32_t indexCount,
+                             const void* vertices,
+                             uint32_t vertexCount,
+                             size_t stride) {
+    const uint8_t* source = static_cast<const uint8_t*>(vertices);
+    uint8_t* target       = static_cast<uint8_t*>(destination);
+    std::vector<uint32_t> remap(vertexCount, Invalid);
+    uint32_t next = 0;
+    for (uint32_t i = 0; i < indexCount; ++i) {
+        const uint32_t vertex = indices[i];
+        if (remap[vertex] == Invalid) {
+            remap[vertex] = next;
+            std::memcpy(target + next * stride, source + vertex * stride, stride);
+            ++next;
+        }
+        indices[i] = remap[vertex];
+    }
+    return next;
+}
+
+// ========================================
+// 5. MESHLETS
+// ========================================
+
+void BuildMeshlets(std::vector<MeshFile::Meshlet>& meshlets,
+                   const uint32_t* indices,
+                   uint32_t indexCount,
+                   const float* positions,
+                   uint32_t vertexCount,
+                   size_t positionStride,
+                   uint32_t maxVertices,
+                   uint32_t maxTriangles) {
+    meshlets.clear();
+    const uint32_t triangleCount = indexCount / 3;
+
+    auto finish = [&](uint32_t begin, uint32_t end) {
+        if (end == begin) {
+            return;
+        }
+        MeshFile::Meshlet meshlet = {};
+        meshlet.indexStart        = begin * 3;
+        meshlet.indexCount        = (end - begin) * 3;
+
+        // Sphere: box centre and the farthest vertex from it
+        float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+        float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        for (uint32_t i = begin * 3; i < end * 3; ++i) {
+            const float* p = PositionAt(positions, positionStride, indices[i]);
+            for (int axis = 0; axis < 3; ++axis) {
+                min[axis] = std::min(min[axis], p[axis]);
+                max[axis] = std::max(max[axis], p[axis]);
+            }
+        }
+        float radiusSquared = 0.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            meshlet.center[axis] = 0.5f * (min[axis] + max[axis]);
+        }
+        for (uint32_t i = begin * 3; i < end * 3; ++i) {
+            const float* p  = PositionAt(positions, positionStride, indices[i]);
+            const float d[3] = {p[0] - meshlet.center[0],
+                                p[1] - meshlet.center[1],
+                                p[2] - meshlet.center[2]};
+            radiusSquared    = std::max(radiusSquared, d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        }
+        meshlet.radius = std::sqrt(radiusSquared);
+
+        // Cone: mean unit normal, opened to the widest normal; degenerate triangles skipped
+        float axisSum[3] = {0.0f, 0.0f, 0.0f};
+        for (uint32_t triangle = begin; triangle < end; ++triangle) {
+            float normal[3];
+            FaceNormal(PositionAt(positions, positionStride, indices[triangle * 3]),
+                       PositionAt(positions, positionStride, indices[triangle * 3 + 1]),
+                       PositionAt(positions, positionStride, indices[triangle * 3 + 2]),
+                       normal);
+            const float length = Length(normal);
+            for (int axis = 0; axis < 3 && length > 0.0f; ++axis) {
+                axisSum[axis] += normal[axis] / length;
+            }
+        }
+        const float axisLength = Length(axisSum);
+        meshlet.coneCutoff     = 1.0f;
+        if (axisLength > 0.0f) {
+            float minDot = 1.0f;
+            for (int axis = 0; axis < 3; ++axis) {
+                meshlet.coneAxis[axis] = axisSum[axis] / axisLength;
+            }
+            for (uint32_t triangle = begin; triangle < end; ++triangle) {
+                float normal[3];
+                FaceNormal(PositionAt(positions, positionStride, indices[triangle * 3]),
+                           PositionAt(positions, positionStride, indices[triangle * 3 + 1]),
+                           PositionAt(positions, positionStride, indices[triangle * 3 + 2]),
+                           normal);
+                const float length = Length(normal);
+                if (length > 0.0f) {
+                    const float dot = (normal[0] * meshlet.coneAxis[0] +
+                                       normal[1] * meshlet.coneAxis[1] +
+                                       normal[2] * meshlet.coneAxis[2]) /
+                                      length;
+                    minDot = std::min(minDot, dot);
+                }
+            }
+            // Past about 84 degrees the test would almost never pass; keep it disabled
+            if (minDot > 0.1f) {
+                meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+            }
+        }
+        meshlets.push_back(meshlet);
+    };
+
+    // Greedy: extend the meshlet with the next triangle until either limit would be exceeded
+    std::vector<uint32_t> tags(vertexCount, Invalid);
+    uint32_t meshletId = 0;
+    uint32_t begin     = 0;
+    uint32_t used      = 0;
+    for (uint32_t triangle = 0; triangle < triangleCount; ++triangle) {
+        const uint32_t* corner = indices + triangle * 3;
+        auto added             = [&]() {
+            uint32_t count = 0;
+            for (int k = 0; k < 3; ++k) {
+                const bool repeat = (k > 0 && corner[k] == corner[0]) ||
+                                    (k > 1 && corner[k] == corner[1]);
+                count += tags[corner[k]] != meshletId && !repeat ? 1 : 0;
+            }
+            return count;
+        };
+        uint32_t count = added();
+        if (used + count > maxVertices || triangle - begin + 1 > maxTriangles) {
+            finish(begin, triangle);
+            ++meshletId;
+            begin = triangle;
+            used  = 0;
+            count = added();
+        }
+        for (int k = 0; k < 3; ++k) {
+            tags[corner[k]] = meshletId;
+        }
+        used += count;
+    }
+    finish(begin, triangleCount);
+}
+
+// ========================================
+// 6. ANALYSIS
+// ========================================
+
+CacheStats AnalyzeVertexCache(const uint32_t* indices,
+                              uint32_t indexCount,
+                              uint32_t vertexCount,
+                              uint32_t cacheSize) {
+    CacheStats stats;
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<uint8_t> referenced(vertexCount, 0);
+    uint32_t referencedCount = 0;
+    for (uint32_t i = 0; i < indexCount; ++i) {
+        stats.misses += cache.Touch(indices[i]);
+        if (!referenced[indices[i]]) {
+            referenced[indices[i]] = 1;
+            ++referencedCount;
+        }
+    }
+    if (indexCount >= 3) {
+        stats.acmr = static_cast<float>(stats.misses) / static_cast<float>(indexCount / 3);
+        stats.atvr = static_cast<float>(stats.misses) / static_cast<float>(referencedCount);
+    }
+    return stats;
+}
+
+OverdrawStats AnalyzeOverdraw(const uint32_t* indices,
+                              uint32_t indexCount,
+                              const float* positions,
+                              uint32_t vertexCount,
+                              size_t positionStride,
+                              uint32_t resolution) {
+    (void)vertexCount;
+    OverdrawStats stats;
+
+    float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (uint32_t i = 0; i < indexCount; ++i) {
+        const float* p = PositionAt(positions, positionStride, indices[i]);
+        for (int axis = 0; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], p[axis]);
+            max[axis] = std::max(max[axis], p[axis]);
+        }
+    }
+    float extent = 0.0f;
+    for (int axis = 0; axis < 3; ++axis) {
+        extent = std::max(extent, max[axis] - min[axis]);
+    }
+    if (indexCount < 3 || extent <= 0.0f) {
+        return stats;
+    }
+
+    // Orthographic views looking along +x, -x, +y, -y, +z, -z; back faces are culled
+    // (clockwise front faces), the depth test is LESS and pixel centres are sampled
+    const float scale = static_cast<float>(resolution) / extent;
+    std::vector<float> depth(size_t(resolution) * resolution);
+    for (int view = 0; view < 6; ++view) {
+        const int axis   = view / 2;
+        const float sign = view % 2 == 0 ? 1.0f : -1.0f;
+        const int uAxis  = (axis + 1) % 3;
+        const int vAxis  = (axis + 2) % 3;
+        std::fill(depth.begin(), depth.end(), FLT_MAX);
+
+        for (uint32_t i = 0; i + 2 < indexCount; i += 3) {
+            const float* corner[3] = {PositionAt(positions, positionStride, indices[i]),
+                                      PositionAt(positions, positionStride, indices[i + 1]),
+                                      PositionAt(positions, positionStride, indices[i + 2])};
+            float normal[3];
+            FaceNormal(corner[0], corner[1], corner[2], normal);
+            if (normal[axis] * sign >= 0.0f) {
+                continue; // Facing away from (or edge-on to) the viewer
+            }
+
+            float x[3], y[3], z[3];
+            for (int k = 0; k < 3; ++k) {
+                x[k] = (corner[k][uAxis] - min[uAxis]) * scale;
+                y[k] = (corner[k][vAxis] - min[vAxis]) * scale;
+                z[k] = corner[k][axis] * sign;
+            }
+            const float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+            if (area == 0.0f) {
+                continue;
+            }
+            const float inverseArea = 1.0f / area;
+
+            const int maxPixel = static_cast<int>(resolution) - 1;
+            const int x0 = std::max(0, static_cast<int>(std::floor(std::min({x[0], x[1], x[2]}))));
+            const int x1 =
+                std::min(maxPixel, static_cast<int>(std::floor(std::max({x[0], x[1], x[2]}))));
+            const int y0 = std::max(0, static_cast<int>(std::floor(std::min({y[0], y[1], y[2]}))));
+            const int y1 =
+                std::min(maxPixel, static_cast<int>(std::floor(std::max({y[0], y[1], y[2]}))));
+            for (int py = y0; py <= y1; ++py) {
+                for (int px = x0; px <= x1; ++px) {
+                    const float cx = static_cast<float>(px) + 0.5f;
+                    const float cy = static_cast<float>(py) + 0.5f;
+
+                    // Barycentrics from edge functions, normalized so inside is positive
+                    const float w0 =
+                        ((x[2] - x[1]) * (cy - y[1]) - (y[2] - y[1]) * (cx - x[1])) * inverseArea;
+                    const float w1 =
+                        ((x[0] - x[2]) * (cy - y[2]) - (y[0] - y[2]) * (cx - x[2])) * inverseArea;
+                    const float w2 = 1.0f - w0 - w1;
+                    if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+                        continue;
+                    }
+                    const float fragment = w0 * z[0] + w1 * z[1] + w2 * z[2];
+                    float& stored        = depth[size_t(py) * resolution + px];
+                    if (fragment < stored) {
+                        stored = fragment;
+                        ++stats.shaded;
+                    }
+                }
+            }
+        }
+        for (float value : depth) {
+            stats.covered += value != FLT_MAX ? 1 : 0;
+        }
+    }
+    stats.overdraw = stats.covered > 0 ? static_cast<float>(stats.shaded) /
+                                             static_cast<float>(stats.covered)
+                                       : 0.0f;
+    return stats;
+}
+
+} // namespace MeshOptimizer
@@ -0,0 +1,114 @@
+#pragma once
+#include "render/MeshFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Mesh Optimizer
+// Offline index and vertex reordering for indexed triangle lists, run by MeshConverter on
+// every part before it is written. The usual order is
+//
+//   GenerateRemap + Remap*      weld identical vertices
+//   OptimizeVertexCache         triangles in post-transform cache order (Forsyth)
+//   OptimizeOverdraw            clusters of that order sorted outside-in (Sander et al.)
+//   OptimizeVertexFetch         vertices in first-use order, unused ones dropped
+//   BuildMeshlets               contiguous triangle ranges with culling bounds
+//
+// Positions are read through a byte stride, so every function works on the Vertex array
+// as imported. Indices are 32-bit throughout; MeshFileWriter stores them as 16-bit when
+// they fit, which fetch ordering makes likely for parts under 65536 vertices.
+namespace MeshOptimizer {
+
+// Post-transform cache efficiency of an index order, with a FIFO cache of cacheSize
+struct CacheStats {
+    uint32_t misses = 0;
+    float acmr      = 0.0f; // Misses per triangle: 0.5 is ideal for a regular grid, 3 worst
+    float atvr      = 0.0f; // Misses per referenced vertex: 1 is ideal
+};
+
+// Pixels drawn against pixels covered, averaged over views along the six axes
+struct OverdrawStats {
+    uint64_t covered = 0;
+    uint64_t shaded  = 0; // Fragments that passed the depth test when they were drawn
+    float overdraw   = 0.0f;
+};
+
+/*
+Map every vertex to the first vertex with identical bytes
+remap: Receives vertexCount entries, the new index of each vertex
+Returns the number of unique vertices; they are numbered in order of first appearance
+*/
+uint32_t GenerateRemap(uint32_t* remap, const void* vertices, uint32_t vertexCount, size_t stride);
+
+// Apply a remap: indices in place, vertices into destination (uniqueCount vertices)
+void RemapIndices(uint32_t* indices, uint32_t indexCount, const uint32_t* remap);
+void RemapVertices(void* destination,
+                   const void* vertices,
+                   uint32_t vertexCount,
+                   size_t stride,
+                   const uint32_t* remap);
+
+/*
+Reorder triangles for the post-transform vertex cache (Tom Forsyth's linear-speed
+algorithm, simulated LRU of 32 entries); destination must not alias indices
+*/
+void OptimizeVertexCache(uint32_t* destination,
+                         const uint32_t* indices,
+                         uint32_t indexCount,
+                         uint32_t vertexCount);
+
+/*
+Reduce overdraw without giving up much cache efficiency: the cache-ordered triangles are
+cut into clusters where the cache would be cold anyway or where a cluster alone stays within
+threshold x the ACMR, then clusters facing away from the mesh centre are drawn first
+indices: The output of OptimizeVertexCache; destination must not alias it
+*/
+void OptimizeOverdraw(uint32_t* destination,
+                      const uint32_t* indices,
+                      uint32_t indexCount,
+                      const float* positions,
+                      uint32_t vertexCount,
+                      size_t positionStride,
+                      float threshold = 1.05f);
+
+/*
+Renumber vertices in the order the indices first use them (indices rewritten in place)
+destination: Room for vertexCount vertices; must not alias vertices
+Returns the number of vertices written; unreferenced ones are dropped
+*/
+uint32_t OptimizeVertexFetch(void* destination,
+                             uint32_t* indices,
+                             uint32_t indexCount,
+                             const void* vertices,
+                             uint32_t vertexCount,
+                             size_t stride);
+
+/*
+Cut the triangle list into meshlets of consecutive triangles, each referencing at most
+maxVertices distinct vertices, with a bounding sphere and a normal cone (clockwise front
+faces) so whole meshlets can be frustum and backface culled before DrawIndexed
+Meshlet index ranges are relative to indices
+*/
+void BuildMeshlets(std::vector<MeshFile::Meshlet>& meshlets,
+                   const uint32_t* indices,
+                   uint32_t indexCount,
+                   const float* positions,
+                   uint32_t vertexCount,
+                   size_t positionStride,
+                   uint32_t maxVertices  = 64,
+                   uint32_t maxTriangles = 124);
+
+CacheStats AnalyzeVertexCache(const uint32_t* indices,
+                              uint32_t indexCount,
+                              uint32_t vertexCount,
+                              uint32_t cacheSize = 16);
+
+// Rasterizes the triangles in order at resolution x resolution from each axis direction
+OverdrawStats AnalyzeOverdraw(const uint32_t* indices,
+                              uint32_t indexCount,
+                              const float* positions,
+                              uint32_t vertexCount,
+                              size_t positionStride,
+                              uint32_t resolution = 256);
+
+} // namespace MeshOptimizer
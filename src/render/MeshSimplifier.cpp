@@ -0,0 +1,681 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t Invalid = ~0u;
+
+enum VertexKind : uint8_t { Manifold, Border, Locked };
+
+// Border planes count this much more than face planes, so leaving the outline is expensive
+constexpr float BorderWeight = 10.0f;
+
+// Rings of triangles searched around a collapsed vertex when measuring the error
+constexpr uint32_t MaxRings = 4;
+
+// Symmetric 4x4 quadric: error(p) = p'Ap + 2b'p + c, a weighted sum of squared distances
+struct Quadric {
+    float a00, a11, a22, a10, a20, a21;
+    float b0, b1, b2;
+    float c;
+    float weight;
+};
+
+void AddPlane(Quadric& q, const float normal[3], float distance, float weight) {
+    const float x = normal[0];
+    const float y = normal[1];
+    const float z = normal[2];
+    q.a00 += weight * x * x;
+    q.a11 += weight * y * y;
+    q.a22 += weight * z * z;
+    q.a10 += weight * y * x;
+    q.a20 += weight * z * x;
+    q.a21 += weight * z * y;
+    q.b0 += weight * distance * x;
+    q.b1 += weight * distance * y;
+    q.b2 += weight * distance * z;
+    q.c += weight * distance * distance;
+    q.weight += weight;
+}
+
+void AddQuadric(Quadric& q, const Quadric& other) {
+    q.a00 += other.a00;
+    q.a11 += other.a11;
+    q.a22 += other.a22;
+    q.a10 += other.a10;
+    q.a20 += other.a20;
+    q.a21 += other.a21;
+    q.b0 += other.b0;
+    q.b1 += other.b1;
+    q.b2 += other.b2;
+    q.c += other.c;
+    q.weight += other.weight;
+}
+
+// Root mean squared distance from p to the quadric's planes
+float QuadricDistance(const Quadric& q, const float p[3]) {
+    if (q.weight <= 0.0f) {
+        return 0.0f;
+    }
+    const float x  = p[0];
+    const float y  = p[1];
+    const float z  = p[2];
+    const float rx = q.a00 * x + q.a10 * y + q.a20 * z;
+    const float ry = q.a10 * x + q.a11 * y + q.a21 * z;
+    const float rz = q.a20 * x + q.a21 * y + q.a22 * z;
+    const float e  = rx * x + ry * y + rz * z + 2.0f * (q.b0 * x + q.b1 * y + q.b2 * z) + q.c;
+    return std::sqrt(std::fabs(e) / q.weight);
+}
+
+void Cross(const float a[3], const float b[3], const float c[3], float normal[3]) {
+    const float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    const float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    normal[0]         = e1[1] * e2[2] - e1[2] * e2[1];
+    normal[1]         = e1[2] * e2[0] - e1[0] * e2[2];
+    normal[2]         = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+float Dot(const float a[3], const float b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Closest point on a triangle by Voronoi region (Ericson, Real-Time Collision Detection)
+float PointTriangleDistance(const float p[3],
+                            const float a[3],
+                            const float b[3],
+                            const float c[3]) {
+    auto distance = [p](float x, float y, float z) {
+        const float d[3] = {p[0] - x, p[1] - y, p[2] - z};
+        return std::sqrt(Dot(d, d));
+    };
+    const float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    const float ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    const float ap[3] = {p[0] - a[0], p[1] - a[1], p[2] - a[2]};
+    const float d1    = Dot(ab, ap);
+    const float d2    = Dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        return distance(a[0], a[1], a[2]);
+    }
+    const float bp[3] = {p[0] - b[0], p[1] - b[1], p[2] - b[2]};
+    const float d3    = Dot(ab, bp);
+    const float d4    = Dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) {
+        return distance(b[0], b[1], b[2]);
+    }
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        const float v = d1 / (d1 - d3);
+        return distance(a[0] + v * ab[0], a[1] + v * ab[1], a[2] + v * ab[2]);
+    }
+    const float cp[3] = {p[0] - c[0], p[1] - c[1], p[2] - c[2]};
+    const float d5    = Dot(ab, cp);
+    const float d6    = Dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) {
+        return distance(c[0], c[1], c[2]);
+    }
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        const float w = d2 / (d2 - d6);
+        return distance(a[0] + w * ac[0], a[1] + w * ac[1], a[2] + w * ac[2]);
+    }
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) {
+        const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        return distance(
+            b[0] + w * (c[0] - b[0]), b[1] + w * (c[1] - b[1]), b[2] + w * (c[2] - b[2]));
+    }
+    const float scale = 1.0f / (va + vb + vc);
+    const float v     = vb * scale;
+    const float w     = vc * scale;
+    return distance(a[0] + ab[0] * v + ac[0] * w,
+                    a[1] + ab[1] * v + ac[1] * w,
+                    a[2] + ab[2] * v + ac[2] * w);
+}
+
+uint32_t HashWords(const uint32_t* words, int count) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < count; ++i) {
+        hash = (hash ^ words[i]) * 16777619u;
+        hash ^= hash >> 15;
+    }
+    return hash;
+}
+
+size_t TableSize(size_t count) {
+    size_t capacity = 16;
+    while (capacity < count * 2) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+// Directed edges of the position-welded mesh and how often each occurs
+class EdgeTable {
+  public:
+    explicit EdgeTable(size_t edgeCount) : keys(TableSize(edgeCount), ~0ull), counts(keys.size()) {}
+
+    void Add(uint32_t from, uint32_t to) {
+        ++counts[Find(Key(from, to))];
+    }
+
+    uint32_t Count(uint32_t from, uint32_t to) const {
+        const size_t slot = Probe(Key(from, to));
+        return keys[slot] == Key(from, to) ? counts[slot] : 0;
+    }
+
+  private:
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> counts;
+
+    static uint64_t Key(uint32_t from, uint32_t to) {
+        return (uint64_t(from) << 32) | to;
+    }
+
+    size_t Probe(uint64_t key) const {
+        const uint32_t words[2] = {static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key)};
+        size_t slot             = HashWords(words, 2) & (keys.size() - 1);
+        while (keys[slot] != ~0ull && keys[slot] != key) {
+            slot = (slot + 1) & (keys.size() - 1);
+        }
+        return slot;
+    }
+
+    size_t Find(uint64_t key) {
+        const size_t slot = Probe(key);
+        keys[slot]        = key;
+        return slot;
+    }
+};
+
+struct Candidate {
+    uint32_t vertex; // Collapses onto target
+    uint32_t target;
+    float error;
+};
+
+} // namespace
+
+uint32_t MeshSimplifier::Simplify(uint32_t* destination,
+                                  const uint32_t* indices,
+                                  uint32_t indexCount,
+                                  const float* positions,
+                                  uint32_t vertexCount,
+                                  size_t positionStride,
+                                  uint32_t targetIndexCount,
+                                  float targetError,
+                                  float* resultError) {
+    indexCount -= indexCount % 3;
+    std::memmove(destination, indices, indexCount * sizeof(uint32_t));
+    if (resultError) {
+        *resultError = 0.0f;
+    }
+    if (indexCount <= targetIndexCount || vertexCount == 0) {
+        return indexCount;
+    }
+
+    // ========================================
+    // 1. NORMALIZED POSITIONS
+    // ========================================
+    // Into the unit cube, so quadric sums in float keep their precision far from the origin
+    float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+        const float* p = reinterpret_cast<const float*>(
+            reinterpret_cast<const uint8_t*>(positions) + vertex * positionStride);
+        for (int axis = 0; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], p[axis]);
+            max[axis] = std::max(max[axis], p[axis]);
+        }
+    }
+    const float extent = std::max({max[0] - min[0], max[1] - min[1], max[2] - min[2], FLT_MIN});
+    std::vector<float> points(size_t(vertexCount) * 3);
+    for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+        const float* p = reinterpret_cast<const float*>(
+            reinterpret_cast<const uint8_t*>(positions) + vertex * positionStride);
+        for (int axis = 0; axis < 3; ++axis) {
+            points[vertex * 3 + axis] = (p[axis] - min[axis]) / extent;
+        }
+    }
+    auto point = [&points](uint32_t vertex) { return &points[size_t(vertex) * 3]; };
+
+    // ========================================
+    // 2. VERTEX KINDS
+    // ========================================
+    // Referenced vertices sharing a position form a wedge; a wedge of more than one vertex
+    // is an attribute seam. Open edges and non-manifold edges are found on the welded mesh,
+    // so a seam is not mistaken for a border
+    std::vector<uint8_t> referenced(vertexCount, 0);
+    for (uint32_t i = 0; i < indexCount; ++i) {
+        referenced[destination[i]] = 1;
+    }
+    std::vector<uint32_t> wedge(vertexCount);
+    std::vector<uint32_t> wedgeSize(vertexCount, 0);
+    {
+        std::vector<uint32_t> table(TableSize(vertexCount), Invalid);
+        for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+            if (!referenced[vertex]) {
+                wedge[vertex] = vertex;
+                continue;
+            }
+            uint32_t words[3];
+            std::memcpy(words, point(vertex), sizeof(words));
+            size_t slot = HashWords(words, 3) & (table.size() - 1);
+            while (table[slot] != Invalid &&
+                   std::memcmp(point(table[slot]), point(vertex), 3 * sizeof(float)) != 0) {
+                slot = (slot + 1) & (table.size() - 1);
+            }
+            if (table[slot] == Invalid) {
+                table[slot] = vertex;
+            }
+            wedge[vertex] = table[slot];
+            ++wedgeSize[table[slot]];
+        }
+    }
+
+    EdgeTable edges(indexCount);
+    for (uint32_t i = 0; i < indexCount; i += 3) {
+        for (int k = 0; k < 3; ++k) {
+            const uint32_t from = wedge[destination[i + k]];
+            const uint32_t to   = wedge[destination[i + (k + 1) % 3]];
+            if (from != to) {
+                edges.Add(from, to);
+            }
+        }
+    }
+
+    std::vector<uint32_t> openNext(vertexCount, Invalid);
+    std::vector<uint32_t> openPrev(vertexCount, Invalid);
+    std::vector<uint8_t> openOut(vertexCount, 0);
+    std::vector<uint8_t> openIn(vertexCount, 0);
+    std::vector<uint8_t> nonManifold(vertexCount, 0);
+    std::vector<uint8_t> openEdge(indexCount, 0); // Corner k's edge to corner k + 1 is open
+    for (uint32_t i = 0; i < indexCount; i += 3) {
+        for (int k = 0; k < 3; ++k) {
+            const uint32_t from = wedge[destination[i + k]];
+            const uint32_t to   = wedge[destination[i + (k + 1) % 3]];
+            if (from == to) {
+                continue;
+            }
+            if (edges.Count(from, to) > 1) {
+                nonManifold[from] = nonManifold[to] = 1;
+            } else if (edges.Count(to, from) == 0) {
+                openEdge[i + k] = 1;
+                openNext[from]  = to;
+                openPrev[to]   = from;
+                openOut[from]  = static_cast<uint8_t>(std::min(openOut[from] + 1, 2));
+                openIn[to]     = static_cast<uint8_t>(std::min(openIn[to] + 1, 2));
+            }
+        }
+    }
+
+    std::vector<uint8_t> kind(vertexCount);
+    for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+        const uint32_t w = wedge[vertex];
+        if (wedgeSize[w] > 1 || nonManifold[w]) {
+            kind[vertex] = Locked;
+        } else if (openOut[w] == 0 && openIn[w] == 0) {
+            kind[vertex] = Manifold;
+        } else {
+            kind[vertex] = openOut[w] == 1 && openIn[w] == 1 ? Border : Locked;
+        }
+    }
+    auto allowed = [&](uint32_t vertex, uint32_t target) {
+        switch (kind[vertex]) {
+        case Manifold:
+            return true;
+        case Border:
+            return wedge[target] == openNext[vertex] || wedge[target] == openPrev[vertex];
+        default:
+            return false;
+        }
+    };
+
+    // ========================================
+    // 3. QUADRICS
+    // ========================================
+    // Area-weighted face planes on every corner, plus planes through each open edge
+    // perpendicular to its triangle on the edge's two ends
+    std::vector<Quadric> quadrics(vertexCount, Quadric{});
+    for (uint32_t i = 0; i < indexCount; i += 3) {
+        const uint32_t* corner = destination + i;
+        float normal[3];
+        Cross(point(corner[0]), point(corner[1]), point(corner[2]), normal);
+        const float length = std::sqrt(Dot(normal, normal));
+        if (length == 0.0f) {
+            continue;
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            normal[axis] /= length;
+        }
+        const float distance = -Dot(normal, point(corner[0]));
+        for (int k = 0; k < 3; ++k) {
+            AddPlane(quadrics[corner[k]], normal, distance, 0.5f * length);
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            const uint32_t from = corner[k];
+            const uint32_t to   = corner[(k + 1) % 3];
+            if (!openEdge[i + k]) {
+                continue;
+            }
+            const float* a         = point(from);
+            const float* b         = point(to);
+            const float edge[3]    = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            float side[3]          = {edge[1] * normal[2] - edge[2] * normal[1],
+                                      edge[2] * normal[0] - edge[0] * normal[2],
+                                      edge[0] * normal[1] - edge[1] * normal[0]};
+            const float sideLength = std::sqrt(Dot(side, side));
+            if (sideLength == 0.0f) {
+                continue;
+            }
+            for (int axis = 0; axis < 3; ++axis) {
+                side[axis] /= sideLength;
+            }
+            const float weight = Dot(edge, edge) * BorderWeight;
+            AddPlane(quadrics[from], side, -Dot(side, a), weight);
+            AddPlane(quadrics[to], side, -Dot(side, a), weight);
+        }
+    }
+
+    // ========================================
+    // 4. COLLAPSE PASSES
+    // ========================================
+    const float errorLimit = targetError / extent;
+    std::vector<uint32_t> firstTriangle(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<uint8_t> locked(vertexCount);
+    std::vector<uint32_t> owner(vertexCount); // Surviving vertex each vertex collapsed into
+    std::vector<uint32_t> neighbour(vertexCount, Invalid); // From a triangle that degenerated
+    std::vector<Candidate> candidates;
+    bool relaxed = false; // The last pass stalled below errorLimit; use the full limit
+    for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+        owner[vertex] = vertex;
+    }
+
+    // Triangles of each vertex (CSR)
+    auto linkTriangles = [&]() {
+        std::fill(firstTriangle.begin(), firstTriangle.end(), 0);
+        for (uint32_t i = 0; i < indexCount; ++i) {
+            ++firstTriangle[destination[i] + 1];
+        }
+        for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+            firstTriangle[vertex + 1] += firstTriangle[vertex];
+        }
+        adjacency.resize(indexCount);
+        std::vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+        for (uint32_t i = 0; i < indexCount; ++i) {
+            adjacency[fill[destination[i]]++] = i / 3;
+        }
+    };
+
+    // Would moving vertex onto target turn any of its remaining triangles over?
+    auto flips = [&](uint32_t vertex, uint32_t target) {
+        for (uint32_t a = firstTriangle[vertex]; a < firstTriangle[vertex + 1]; ++a) {
+            const uint32_t* corner = destination + adjacency[a] * 3;
+            uint32_t mapped[3]     = {remap[corner[0]], remap[corner[1]], remap[corner[2]]};
+            if (mapped[0] == target || mapped[1] == target || mapped[2] == target) {
+                continue; // Degenerates instead
+            }
+            float before[3];
+            float after[3];
+            Cross(point(mapped[0]), point(mapped[1]), point(mapped[2]), before);
+            for (int k = 0; k < 3; ++k) {
+                mapped[k] = mapped[k] == vertex ? target : mapped[k];
+            }
+            Cross(point(mapped[0]), point(mapped[1]), point(mapped[2]), after);
+            if (Dot(before, after) <= 0.0f) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    while (indexCount > targetIndexCount) {
+        const uint32_t triangleCount = indexCount / 3;
+        linkTriangles();
+
+        // Cheapest allowed direction of every edge; an interior edge is taken from the
+        // triangle that has it in ascending order, an open edge from its only triangle
+        candidates.clear();
+        for (uint32_t i = 0; i < indexCount; i += 3) {
+            for (int k = 0; k < 3; ++k) {
+                const uint32_t a = destination[i + k];
+                const uint32_t b = destination[i + (k + 1) % 3];
+                if (a > b && openNext[wedge[a]] != wedge[b] && openPrev[wedge[b]] != wedge[a]) {
+                    continue;
+                }
+                Candidate best = {Invalid, Invalid, FLT_MAX};
+                if (allowed(a, b)) {
+                    best = Candidate{a, b, QuadricDistance(quadrics[a], point(b))};
+                }
+                if (allowed(b, a)) {
+                    const float error = QuadricDistance(quadrics[b], point(a));
+                    if (error < best.error) {
+                        best = Candidate{b, a, error};
+                    }
+                }
+                if (best.vertex != Invalid && best.error <= errorLimit) {
+                    candidates.push_back(best);
+                }
+            }
+        }
+        if (candidates.empty()) {
+            break;
+        }
+
+        // A manifold collapse removes two triangles. Collapses well past the cheapest ones
+        // needed are left for the next pass, where their neighbours' costs are up to date,
+        // so only the candidates under this pass's limit are sorted
+        auto cheaper = [](const Candidate& l, const Candidate& r) { return l.error < r.error; };
+        const uint32_t goal = triangleCount - targetIndexCount / 3;
+        const size_t needed = std::min(candidates.size(), size_t(goal / 2 + 1));
+        std::nth_element(
+            candidates.begin(), candidates.begin() + (needed - 1), candidates.end(), cheaper);
+        const float passLimit =
+            relaxed ? errorLimit : std::min(errorLimit, candidates[needed - 1].error * 1.5f);
+        auto end = std::partition(candidates.begin(), candidates.end(), [&](const Candidate& c) {
+            return c.error <= passLimit;
+        });
+        candidates.erase(end, candidates.end());
+        std::sort(candidates.begin(), candidates.end(), cheaper);
+
+        for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+            remap[vertex] = vertex;
+        }
+        std::fill(locked.begin(), locked.end(), uint8_t(0));
+        uint32_t removed   = 0;
+        uint32_t collapses = 0;
+        for (const Candidate& candidate : candidates) {
+            if (removed >= goal) {
+                break;
+            }
+            const uint32_t vertex = candidate.vertex;
+            const uint32_t target = candidate.target;
+            if (locked[vertex] || locked[target] || flips(vertex, target)) {
+                continue;
+            }
+            for (uint32_t a = firstTriangle[vertex]; a < firstTriangle[vertex + 1]; ++a) {
+                const uint32_t* corner = destination + adjacency[a] * 3;
+                removed += remap[corner[0]] == target || remap[corner[1]] == target ||
+                                   remap[corner[2]] == target
+                               ? 1
+                               : 0;
+            }
+            // The border now runs past the removed vertex (border vertices are their own wedge)
+            if (kind[vertex] == Border) {
+                openNext[openPrev[vertex]] = openNext[vertex];
+                openPrev[openNext[vertex]] = openPrev[vertex];
+            }
+            remap[vertex]  = target;
+            locked[vertex] = 1;
+            locked[target] = 1;
+            AddQuadric(quadrics[target], quadrics[vertex]);
+            ++collapses;
+        }
+
+        if (collapses == 0) {
+            if (relaxed || passLimit >= errorLimit) {
+                break;
+            }
+            relaxed = true;
+            continue;
+        }
+        relaxed = false;
+
+        // Apply the pass and drop the triangles that degenerated
+        uint32_t written = 0;
+        for (uint32_t i = 0; i < indexCount; i += 3) {
+            const uint32_t a = remap[destination[i]];
+            const uint32_t b = remap[destination[i + 1]];
+            const uint32_t c = remap[destination[i + 2]];
+            if (a != b && b != c && a != c) {
+                destination[written++] = a;
+                destination[written++] = b;
+                destination[written++] = c;
+            } else {
+                neighbour[a] = a != b ? b : c;
+                neighbour[b] = b != c ? c : a;
+                neighbour[c] = c != a ? a : b;
+            }
+        }
+        indexCount = written;
+        for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+            owner[vertex] = remap[owner[vertex]];
+        }
+    }
+
+    // ========================================
+    // 5. ERROR
+    // ========================================
+    // Quadric costs average over planes and underestimate the worst case, so the reported
+    // error is measured: the largest distance from a removed vertex to the simplified surface.
+    // The search walks rings of triangles out from the vertex it ended up in, which after a
+    // long chain of collapses may no longer touch the nearest triangle, and stops as soon as
+    // the distance cannot raise the maximum
+    if (resultError) {
+        linkTriangles();
+        std::vector<uint32_t> tested(indexCount / 3, Invalid); // Last vertex measured against
+        std::vector<uint32_t> visited(vertexCount, Invalid);
+        std::vector<uint32_t> ring;
+        std::vector<uint32_t> nextRing;
+        float deviation = 0.0f;
+        for (uint32_t vertex = 0; vertex < vertexCount; ++vertex) {
+            const uint32_t kept = owner[vertex];
+            if (!referenced[vertex] || kept == vertex) {
+                continue;
+            }
+            // A vertex can survive every collapse and still lose all its triangles; the
+            // search then starts from a neighbour that kept some
+            uint32_t start = kept;
+            for (int step = 0; step < 8 && firstTriangle[start] == firstTriangle[start + 1] &&
+                               neighbour[start] != Invalid;
+                 ++step) {
+                start = owner[neighbour[start]];
+            }
+
+            float nearest = FLT_MAX;
+            ring.assign(1, start);
+            visited[start] = vertex;
+            for (uint32_t depth = 0; depth < MaxRings && nearest > deviation && !ring.empty();
+                 ++depth) {
+                nextRing.clear();
+                for (uint32_t center : ring) {
+                    for (uint32_t a = firstTriangle[center]; a < firstTriangle[center + 1]; ++a) {
+                        const uint32_t triangle = adjacency[a];
+                        if (tested[triangle] == vertex) {
+                            continue;
+                        }
+                        tested[triangle]       = vertex;
+                        const uint32_t* corner = destination + triangle * 3;
+                        const float distance   = PointTriangleDistance(
+                            point(vertex), point(corner[0]), point(corner[1]), point(corner[2]));
+                        nearest = std::min(nearest, distance);
+                        for (int k = 0; k < 3; ++k) {
+                            if (visited[corner[k]] != vertex) {
+                                visited[corner[k]] = vertex;
+                                nextRing.push_back(corner[k]);
+                            }
+                        }
+                    }
+                }
+                ring.swap(nextRing);
+            }
+            if (nearest == FLT_MAX) {
+                const float* p   = point(vertex);
+                const float* q   = point(start);
+                const float d[3] = {p[0] - q[0], p[1] - q[1], p[2] - q[2]};
+                nearest          = std::sqrt(Dot(d, d)); // Nothing left nearby
+            }
+            deviation = std::max(deviation, nearest);
+        }
+        *resultError = deviation * extent;
+    }
+    return indexCount;
+}
+
+void MeshSimplifier::BuildChains(Chain* chains,
+                                 const Input* inputs,
+                                 uint32_t count,
+                                 const ChainSettings& settings) const {
+    auto build = [&](uint32_t i) {
+        const Input& input = inputs[i];
+        Chain& chain       = chains[i];
+        chain.indices.assign(input.indices, input.indices + input.indexCount);
+        chain.lods.assign(1, Lod{0, input.indexCount, 0.0f});
+
+        float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+        float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        for (uint32_t vertex = 0; vertex < input.vertexCount; ++vertex) {
+            const float* p = reinterpret_cast<const float*>(
+                reinterpret_cast<const uint8_t*>(input.positions) + vertex * input.positionStride);
+            for (int axis = 0; axis < 3; ++axis) {
+                min[axis] = std::min(min[axis], p[axis]);
+                max[axis] = std::max(max[axis], p[axis]);
+            }
+        }
+        const float extent   = std::max({max[0] - min[0], max[1] - min[1], max[2] - min[2], 0.0f});
+        const float maxError = settings.maxError * extent;
+
+        std::vector<uint32_t> level;
+        while (chain.lods.size() < settings.maxLods) {
+            const Lod previous = chain.lods.back();
+            const uint32_t target =
+                static_cast<uint32_t>(previous.indexCount / 3 * settings.reduction) * 3;
+            const float budget = maxError - previous.error;
+            if (target / 3 < settings.minTriangles || budget <= 0.0f) {
+                break;
+            }
+
+            // Each level starts from the last, so the bound is the sum of the steps
+            level.resize(previous.indexCount);
+            float error            = 0.0f;
+            const uint32_t reached = Simplify(level.data(),
+                                              chain.indices.data() + previous.indexStart,
+                                              previous.indexCount,
+                                              input.positions,
+                                              input.vertexCount,
+                                              input.positionStride,
+                                              target,
+                                              budget,
+                                              &error);
+            if (reached > previous.indexCount - previous.indexCount / 10) {
+                break;
+            }
+            const uint32_t start = static_cast<uint32_t>(chain.indices.size());
+            chain.indices.insert(chain.indices.end(), level.begin(), level.begin() + reached);
+            chain.lods.push_back(Lod{start, reached, previous.error + error});
+        }
+    };
+
+    if (!parallelFor || count < 2) {
+        for (uint32_t i = 0; i < count; ++i) {
+            build(i);
+        }
+    } else {
+        parallelFor(count, build);
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "threading/ParallelFor.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Mesh Simplifier Class
+// Offline level-of-detail generation by edge collapse under the quadric error metric
+// (Garland and Heckbert): every vertex carries the sum of the squared-distance quadrics of
+// its triangles' planes, and collapsing v onto a neighbour t costs v's quadric evaluated at
+// t. Collapses are half-edge (t stays where it is), so surviving vertices keep their exact
+// positions and colors and every LOD indexes the original vertex array.
+//
+// Each pass costs every edge, sorts them and collapses greedily in order, each vertex at
+// most once per pass, rejecting collapses that would flip a triangle. Vertex kinds keep
+// the outline of the mesh:
+//
+//   Manifold   interior vertex; may collapse onto any neighbour
+//   Border     on an open edge; only slides along the border
+//   Locked     on an attribute seam (same position as a vertex with different bytes, i.e.
+//              a COLOR discontinuity once welded) or non-manifold; never moves
+//
+// BuildChains simplifies many meshes at once, one task per mesh on the ParallelFor.
+class MeshSimplifier {
+  public:
+    // Indexed triangles over a position array (x, y, z floats every positionStride bytes)
+    struct Input {
+        const uint32_t* indices;
+        uint32_t indexCount;
+        const float* positions;
+        uint32_t vertexCount;
+        size_t positionStride;
+    };
+
+    struct Lod {
+        uint32_t indexStart; // Into Chain::indices
+        uint32_t indexCount;
+        float error; // Distance from LOD 0 (summed over levels), in position units
+    };
+
+    // LOD 0 (the input) followed by coarser levels, all indexing the input's vertices
+    struct Chain {
+        std::vector<uint32_t> indices;
+        std::vector<Lod> lods;
+    };
+
+    struct ChainSettings {
+        uint32_t maxLods;      // Including LOD 0
+        float reduction;       // Target triangle count of each level over the previous one
+        float maxError;        // Largest error of any level, relative to the mesh extent
+        uint32_t minTriangles; // No level is built below this
+    };
+
+    static ChainSettings DefaultChainSettings() {
+        return ChainSettings{6, 0.5f, 0.05f, 32};
+    }
+
+    // Install a parallel executor for BuildChains (default: serial)
+    void SetParallelFor(ParallelFor executor) {
+        parallelFor = std::move(executor);
+    }
+
+    /*
+    Simplify one mesh towards targetIndexCount indices, taking no collapse whose quadric
+    cost (a root mean squared distance, in position units) exceeds targetError
+    destination: Room for indexCount indices; may alias indices
+    resultError: Receives the measured error, in position units: the largest distance from a
+    removed vertex to the simplified triangles near where it went (may be nullptr)
+    Returns the index count reached, which is above the target when the error bound or the
+    locked vertices stop it
+    */
+    static uint32_t Simplify(uint32_t* destination,
+                             const uint32_t* indices,
+                             uint32_t indexCount,
+                             const float* positions,
+                             uint32_t vertexCount,
+                             size_t positionStride,
+                             uint32_t targetIndexCount,
+                             float targetError,
+                             float* resultError = nullptr);
+
+    /*
+    Build a LOD chain for each input: every level simplifies the previous one by the
+    reduction ratio, and the chain ends at maxLods, maxError, minTriangles, or when a level
+    would remove less than a tenth of the triangles. Errors accumulate along the chain
+    */
+    void BuildChains(Chain* chains,
+                     const Input* inputs,
+                     uint32_t count,
+                     const ChainSettings& settings) const;
+
+  private:
+    ParallelFor parallelFor;
+};
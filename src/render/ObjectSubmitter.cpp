@@ -0,0 +1,50 @@
+#include "ObjectSubmitter.h"
+
+void ObjectSubmitter::Add(const Float4x4* world, uint32_t count) {
+    if (count > 0) {
+        batches.push_back({world, count});
+        queued += count;
+    }
+}
+
+uint32_t ObjectSubmitter::Submit(ConstantAllocator& allocator,
+                                 ConstantAllocator::Target& target,
+                                 const MatrixBatch& matrices,
+                                 const Float4x4& viewProjection,
+                                 const DrawPacket& prototype,
+                                 RenderQueue& queue) {
+    DrawPacket packet  = prototype;
+    uint32_t submitted = 0;
+    for (const Batch& batch : batches) {
+        uint32_t placed = 0;
+        while (placed < batch.count) {
+            // ========================================
+            // 1. WRITE A RUN OF CONSTANTS
+            // ========================================
+            // Consecutive 256-byte slots of one page, filled by one batched multiply
+            ConstantAllocator::Run run = allocator.Allocate(target, batch.count - placed);
+            if (run.objectCount == 0) {
+                break; // The target failed; the rest of the batch is dropped
+            }
+            matrices.Multiply(batch.world + placed,
+                              viewProjection,
+                              run.objectCount,
+                              run.cpuPtr,
+                              ConstantAllocator::SlotSize);
+
+            // ========================================
+            // 2. QUEUE ONE DRAW PER OBJECT
+            // ========================================
+            for (uint32_t i = 0; i < run.objectCount; ++i) {
+                packet.constants = run.firstSlot + i;
+                if (queue.Submit(packet)) {
+                    ++submitted;
+                }
+            }
+            placed += run.objectCount;
+        }
+    }
+    batches.clear();
+    queued = 0;
+    return submitted;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "ConstantAllocator.h"
+#include "MatrixBatch.h"
+#include "RenderQueue.h"
+#include <cstdint>
+#include <vector>
+
+// Object Submitter Class
+// Objects drawn one per draw call, each with its own world * viewProjection constants.
+// Submit places the queued objects in ConstantAllocator slots run by run, fills each run
+// with one MatrixBatch multiply straight into the mapped page, and submits one packet per
+// object whose constants field names its slot; the backend's dispatcher binds that slot's
+// window (page GetPage(slot), GetFirstConstant(slot), ConstantsPerSlot) for the draw.
+class ObjectSubmitter {
+  public:
+    // Queue count objects for the next Submit; world must stay valid until then
+    void Add(const Float4x4* world, uint32_t count);
+
+    // Objects queued since the last Submit
+    uint32_t GetCount() const {
+        return queued;
+    }
+
+    /*
+    Write the constants of every queued object and submit a copy of prototype for each,
+    then empty the queue. Returns the objects submitted; the others are dropped when the
+    target fails to map a page
+    */
+    uint32_t Submit(ConstantAllocator& allocator,
+                    ConstantAllocator::Target& target,
+                    const MatrixBatch& matrices,
+                    const Float4x4& viewProjection,
+                    const DrawPacket& prototype,
+                    RenderQueue& queue);
+
+  private:
+    struct Batch {
+        const Float4x4* world = nullptr;
+        uint32_t count        = 0;
+    };
+
+    std::vector<Batch> batches;
+    uint32_t queued = 0;
+};
@@ -0,0 +1,54 @@
+#include "PipelineCache.h"
+
+static_assert(sizeof(PipelineCache::PipelineDesc) == 3 * sizeof(void*) + 24,
+              "PipelineDesc is hashed bytewise and must not contain padding");
+
+PipelineCache::PipelineCache(StateFactory& factory)
+    : factory(factory), pipelines(sizeof(PipelineDesc)) {
+    for (uint32_t kind = 0; kind < StateKindCount; ++kind) {
+        states[kind] = std::make_unique<StateObjectCache>(
+            factory.GetDescSize(static_cast<StateKind>(kind)));
+    }
+}
+
+PipelineCache::~PipelineCache() {
+    for (uint32_t kind = 0; kind < StateKindCount; ++kind) {
+        const StateObjectCache& cache = *states[kind];
+        for (uint32_t handle = 0; handle < cache.GetCount(); ++handle) {
+            factory.Release(static_cast<StateKind>(kind), cache.GetObject(handle));
+        }
+    }
+}
+
+uint16_t PipelineCache::AcquireState(StateKind kind, const void* desc) {
+    // A failed creation falls back to the default state rather than an unusable handle
+    return states[kind]->Acquire(
+        desc, [this, kind](const void* stored) { return factory.Create(kind, stored); });
+}
+
+void PipelineCache::Prewarm(StateKind kind, const void* descs, uint32_t count) {
+    const uint8_t* desc = static_cast<const uint8_t*>(descs);
+    const size_t size   = states[kind]->GetDescSize();
+    for (uint32_t i = 0; i < count; ++i, desc += size) {
+        AcquireState(kind, desc);
+    }
+}
+
+uint16_t PipelineCache::AcquirePipeline(const PipelineDesc& desc) {
+    // Pipelines have no API object of their own; the entry is the bundle
+    return pipelines.Acquire(&desc, nullptr);
+}
+
+void PipelineCache::Bind(StateCache& state, uint16_t pipeline) const {
+    const PipelineDesc& desc = GetPipeline(pipeline);
+    state.SetPrimitiveTopology(desc.topology);
+    state.SetInputLayout(desc.inputLayout);
+    state.SetVertexShader(desc.vertexShader);
+    state.SetPixelShader(desc.pixelShader);
+    for (uint32_t slot = 0; slot < MaxSamplers; ++slot) {
+        state.SetPixelSampler(slot, GetStateObject(Sampler, desc.samplers[slot]));
+    }
+    state.SetRasterizerState(GetStateObject(Rasterizer, desc.rasterizer));
+    state.SetDepthStencilState(GetStateObject(DepthStencil, desc.depthStencil), desc.stencilRef);
+    state.SetBlendState(GetStateObject(Blend, desc.blend), nullptr, 0xFFFFFFFFu);
+}
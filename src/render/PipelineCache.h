@@ -0,0 +1,104 @@
+#pragma once
+#include "StateCache.h"
+#include "StateObjectCache.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Pipeline Cache Class
+// Fixed-function state objects and the pipelines built from them. Blend, rasterizer,
+// depth-stencil and sampler descriptors are each deduplicated by a StateObjectCache into
+// 16-bit handles, creating one API object per unique descriptor through a StateFactory.
+// A pipeline bundles shaders, input layout, topology and state handles into an immutable
+// entry with a handle of its own, so "is this material's pipeline already bound" is one
+// compare of two handles, and Bind sends the rest through a StateCache.
+//
+// Lookups never block and may come from any thread. Entries are never removed while the
+// cache lives; a shader hot reload simply adds pipelines with the new shaders.
+class PipelineCache {
+  public:
+    enum StateKind : uint32_t { Blend = 0, Rasterizer, DepthStencil, Sampler, StateKindCount };
+
+    // State handle binding nullptr: the API's default state (or no sampler)
+    static constexpr uint16_t DefaultState    = StateObjectCache::InvalidHandle;
+    static constexpr uint16_t InvalidPipeline = StateObjectCache::InvalidHandle;
+    static constexpr uint32_t MaxSamplers     = StateCache::MaxPixelSlots;
+
+    // State Factory Interface
+    // Creates and releases the API objects behind state handles. Objects and descriptors
+    // are passed as opaque pointers so the cache compiles without any graphics API headers.
+    class StateFactory {
+      public:
+        virtual ~StateFactory() = default;
+
+        // Bytes of one descriptor of a kind (e.g. sizeof(D3D11_BLEND_DESC))
+        virtual size_t GetDescSize(StateKind kind) const = 0;
+
+        // nullptr on failure
+        virtual void* Create(StateKind kind, const void* desc) = 0;
+        virtual void Release(StateKind kind, void* object)     = 0;
+    };
+
+    // Everything Bind sets; compared bytewise, so it has no padding
+    struct PipelineDesc {
+        void* inputLayout              = nullptr;
+        void* vertexShader             = nullptr;
+        void* pixelShader              = nullptr;
+        uint32_t topology              = 0;
+        uint32_t stencilRef            = 0;
+        uint16_t blend                 = DefaultState;
+        uint16_t rasterizer            = DefaultState;
+        uint16_t depthStencil          = DefaultState;
+        uint16_t samplers[MaxSamplers] = {DefaultState, DefaultState, DefaultState, DefaultState};
+        uint16_t reserved              = 0;
+    };
+
+    // The factory must outlive the cache, which releases its objects on destruction
+    explicit PipelineCache(StateFactory& factory);
+    ~PipelineCache();
+
+    PipelineCache(const PipelineCache&)            = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    /*
+    Handle of a state descriptor, creating its object on first sight
+    desc: GetDescSize(kind) bytes with padding and unused fields zeroed
+    Returns DefaultState if the cache is full or the object could not be created
+    */
+    uint16_t AcquireState(StateKind kind, const void* desc);
+
+    // Create the objects of descriptors known to be used, so the first frames do not
+    // create them mid-draw; descs are count packed descriptors of one kind
+    void Prewarm(StateKind kind, const void* descs, uint32_t count);
+
+    // Object behind a state handle; nullptr for DefaultState
+    void* GetStateObject(StateKind kind, uint16_t handle) const {
+        return handle == DefaultState ? nullptr : states[kind]->GetObject(handle);
+    }
+
+    /*
+    Handle of a pipeline (state handles from this cache)
+    Returns InvalidPipeline when the cache is full
+    */
+    uint16_t AcquirePipeline(const PipelineDesc& desc);
+
+    const PipelineDesc& GetPipeline(uint16_t pipeline) const {
+        return *static_cast<const PipelineDesc*>(pipelines.GetDesc(pipeline));
+    }
+
+    // Send every part of a pipeline to a state cache, which drops the ones already bound
+    void Bind(StateCache& state, uint16_t pipeline) const;
+
+    // Unique objects of a kind, and pipelines
+    uint32_t GetStateCount(StateKind kind) const {
+        return states[kind]->GetCount();
+    }
+    uint32_t GetPipelineCount() const {
+        return pipelines.GetCount();
+    }
+
+  private:
+    StateFactory& factory;
+    std::unique_ptr<StateObjectCache> states[StateKindCount];
+    StateObjectCache pipelines;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include "MatrixBatch.h"
+#include "VertexFormat.h"
+#include <cstdint>
+
+// Vertex format shared by every backend
+// Graphics stores it as PackedVertex (see VertexEncoder.h); SoftwareRasterizer uses it as is
+struct Vertex {
+    float position[3]; // x, y, z; BasicVS transforms (x, y, z, 1) into clip space
+    float color[4];    // r, g, b, a
+};
+
+template <>
+struct VertexLayout<Vertex> {
+    static constexpr VertexElement Elements[] = {VERTEX_ELEMENT(Vertex, position, "POSITION", 0),
+                                                 VERTEX_ELEMENT(Vertex, color, "COLOR", 0)};
+};
+
+// Per-instance stream (input slot 1), read by BasicVS as INSTANCE_TRANSFORM0-2 and INSTANCE_COLOR
+// 64 bytes, so four instances fill a cache line pair and every row is 16-byte aligned
+struct alignas(16) InstanceData {
+    float transform[3][4]; // Rows of a 3x4 affine matrix: position' = transform * (x, y, z, 1)
+    float color[4];        // Multiplies the vertex color
+};
+static_assert(sizeof(InstanceData) == 64, "InstanceData is the per-instance vertex stride");
+
+// The transform rows share one member, so they are listed with explicit offsets
+template <>
+struct VertexLayout<InstanceData> {
+    static constexpr uint32_t Transform = static_cast<uint32_t>(offsetof(InstanceData, transform));
+    static constexpr uint32_t RowSize   = static_cast<uint32_t>(sizeof(float[4]));
+
+    static constexpr VertexElement Elements[] = {
+        {"INSTANCE_TRANSFORM", 0, VertexElementFormat::Float4, Transform},
+        {"INSTANCE_TRANSFORM", 1, VertexElementFormat::Float4, Transform + RowSize},
+        {"INSTANCE_TRANSFORM", 2, VertexElementFormat::Float4, Transform + 2 * RowSize},
+        VERTEX_ELEMENT(InstanceData, color, "INSTANCE_COLOR", 0)};
+};
+
+// Backend creation parameters
+struct BackendDesc {
+    void* windowHandle = nullptr; // Native window (HWND); unused by headless backends
+    int width          = 0;       // Render target width in pixels
+    int height         = 0;       // Render target height in pixels
+};
+
+// Render Backend Interface
+// Minimal immediate-mode surface extracted from Graphics so frames can be produced either by
+// Direct3D 11 or by the headless SoftwareRasterizer
+class RenderBackend {
+  public:
+    virtual ~RenderBackend() = default;
+
+    // Create device resources for a width x height render target
+    virtual bool Initialize(const BackendDesc& desc) = 0;
+
+    // Begin a frame by clearing the render target to color (RGBA, 0..1)
+    virtual void Clear(const float color[4]) = 0;
+
+    // Copy vertices into backend-owned storage and make them the current vertex stream
+    virtual void SetVertexBuffer(const Vertex* vertices, uint32_t vertexCount) = 0;
+
+    /*
+    Camera for the draws of the frames that follow: clip position = (x, y, z, 1) * matrix
+    (row-vector convention, as BasicVS). Takes effect at the next Clear()
+    */
+    virtual void SetViewProjection(const Float4x4& matrix) = 0;
+
+    // Draw a triangle list from the current vertex stream
+    virtual void Draw(uint32_t vertexCount, uint32_t startVertex) = 0;
+
+    // Copy instances into backend-owned storage and make them the current instance stream
+    virtual void SetInstanceBuffer(const InstanceData* instances, uint32_t instanceCount) = 0;
+
+    /*
+    Draw instanceCount copies of a triangle list from the current vertex stream
+    Copy i is transformed and tinted by instance startInstance + i of the instance stream
+    */
+    virtual void DrawInstanced(uint32_t vertexCount,
+                               uint32_t instanceCount,
+                               uint32_t startVertex,
+                               uint32_t startInstance) = 0;
+
+    // Finish the frame and present it
+    virtual void Present() = 0;
+};
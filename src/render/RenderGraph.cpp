@@ -0,0 +1,246 @@
+#include "RenderGraph.h"
+#include <algorithm>
+
+uint32_t RenderTargetBytesPerPixel(RenderTargetFormat format) {
+    switch (format) {
+    case RenderTargetFormat::RGBA8:
+    case RenderTargetFormat::RGB10A2:
+    case RenderTargetFormat::R11G11B10F:
+    case RenderTargetFormat::RG16F:
+    case RenderTargetFormat::R32F:
+    case RenderTargetFormat::D32F:
+    case RenderTargetFormat::D24S8:
+        return 4;
+    case RenderTargetFormat::RGBA16F:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+uint64_t RenderTargetDesc::Bytes() const {
+    uint64_t texels = 0;
+    for (uint32_t mip = 0; mip < mipCount; ++mip) {
+        const uint64_t mipWidth  = std::max(width >> mip, 1u);
+        const uint64_t mipHeight = std::max(height >> mip, 1u);
+        texels += mipWidth * mipHeight;
+    }
+    return texels * sampleCount * RenderTargetBytesPerPixel(format);
+}
+
+// ========================================
+// 1. DECLARATION
+// ========================================
+
+void RenderGraph::Reset() {
+    resources.clear();
+    passes.clear();
+    uses.clear();
+    order.clear();
+    stats = Stats();
+}
+
+uint32_t RenderGraph::CreateTexture(const char* name, const RenderTargetDesc& desc) {
+    resources.push_back(
+        {name, desc, false, InvalidResource, InvalidResource, TransientPool::InvalidBlock});
+    return static_cast<uint32_t>(resources.size() - 1);
+}
+
+uint32_t RenderGraph::ImportTexture(const char* name, const RenderTargetDesc& desc) {
+    resources.push_back(
+        {name, desc, true, InvalidResource, InvalidResource, TransientPool::InvalidBlock});
+    return static_cast<uint32_t>(resources.size() - 1);
+}
+
+uint32_t RenderGraph::AddPass(const char* name, ExecuteFunction execute) {
+    passes.push_back({name, std::move(execute), false, false});
+    return static_cast<uint32_t>(passes.size() - 1);
+}
+
+void RenderGraph::Read(uint32_t pass, uint32_t texture) {
+    uses.push_back({pass, texture, false});
+}
+
+void RenderGraph::Write(uint32_t pass, uint32_t texture) {
+    uses.push_back({pass, texture, true});
+}
+
+void RenderGraph::SetSideEffect(uint32_t pass) {
+    passes[pass].sideEffect = true;
+}
+
+// ========================================
+// 2. COMPILE
+// ========================================
+
+bool RenderGraph::Compile() {
+    stats        = Stats();
+    stats.passes = static_cast<uint32_t>(passes.size());
+    order.clear();
+    for (const Use& use : uses) {
+        if (use.pass >= passes.size() || use.resource >= resources.size()) {
+            return false;
+        }
+    }
+
+    SortUses();
+    Cull();
+    if (!ComputeLifetimes()) {
+        return false;
+    }
+    Place();
+    return true;
+}
+
+void RenderGraph::SortUses() {
+    // Counting sort by pass; uses of one pass keep their declaration order
+    const uint32_t passCount = static_cast<uint32_t>(passes.size());
+    passUseStart.assign(passCount + 1, 0);
+    for (const Use& use : uses) {
+        ++passUseStart[use.pass + 1];
+    }
+    for (uint32_t p = 0; p < passCount; ++p) {
+        passUseStart[p + 1] += passUseStart[p];
+    }
+    sortedUses.resize(uses.size());
+    cursor.assign(passUseStart.begin(), passUseStart.end() - 1);
+    for (const Use& use : uses) {
+        sortedUses[cursor[use.pass]++] = use;
+    }
+}
+
+void RenderGraph::Cull() {
+    // needed[r]: the contents of r at this point are read later (or are the frame's output)
+    needed.resize(resources.size());
+    for (size_t r = 0; r < resources.size(); ++r) {
+        needed[r] = resources[r].imported;
+    }
+
+    for (uint32_t p = static_cast<uint32_t>(passes.size()); p-- > 0;) {
+        const Use* first = sortedUses.data() + passUseStart[p];
+        const Use* last  = sortedUses.data() + passUseStart[p + 1];
+        Pass& pass       = passes[p];
+        pass.live        = pass.sideEffect;
+        for (const Use* use = first; use != last; ++use) {
+            pass.live |= use->write && needed[use->resource];
+        }
+        if (!pass.live) {
+            ++stats.culledPasses;
+            continue;
+        }
+
+        // Writes satisfy what later passes needed; reads make the earlier contents needed
+        for (const Use* use = first; use != last; ++use) {
+            if (use->write) {
+                needed[use->resource] = false;
+            }
+        }
+        for (const Use* use = first; use != last; ++use) {
+            if (!use->write) {
+                needed[use->resource] = true;
+            }
+        }
+    }
+}
+
+bool RenderGraph::ComputeLifetimes() {
+    written.assign(resources.size(), 0);
+    for (Resource& resource : resources) {
+        resource.firstUse = InvalidResource;
+        resource.lastUse  = InvalidResource;
+        resource.block    = TransientPool::InvalidBlock;
+    }
+
+    for (uint32_t p = 0; p < passes.size(); ++p) {
+        if (!passes[p].live) {
+            continue;
+        }
+        const uint32_t position = static_cast<uint32_t>(order.size());
+        order.push_back(p);
+
+        const Use* first = sortedUses.data() + passUseStart[p];
+        const Use* last  = sortedUses.data() + passUseStart[p + 1];
+        for (const Use* use = first; use != last; ++use) {
+            Resource& resource = resources[use->resource];
+            if (!use->write && !resource.imported && !written[use->resource]) {
+                return false; // Reads contents nothing produced
+            }
+            if (resource.firstUse == InvalidResource) {
+                resource.firstUse = position;
+            }
+            resource.lastUse = position;
+        }
+        for (const Use* use = first; use != last; ++use) {
+            written[use->resource] |= use->write;
+        }
+    }
+    return true;
+}
+
+void RenderGraph::Place() {
+    // Start and end events per order position: texture t starts as 2t and ends as 2t + 1,
+    // bucketed by position with a counting sort (starts before ends within a position)
+    const uint32_t positions = static_cast<uint32_t>(order.size());
+    eventStart.assign(positions + 1, 0);
+    for (const Resource& resource : resources) {
+        if (!resource.imported && resource.firstUse != InvalidResource) {
+            ++eventStart[resource.firstUse + 1];
+            ++eventStart[resource.lastUse + 1];
+            ++stats.transients;
+            stats.unaliasedBytes += resource.desc.Bytes();
+        }
+    }
+    for (uint32_t i = 0; i < positions; ++i) {
+        eventStart[i + 1] += eventStart[i];
+    }
+    events.resize(eventStart[positions]);
+    cursor.assign(eventStart.begin(), eventStart.end() - 1);
+    for (uint32_t phase = 0; phase < 2; ++phase) {
+        for (uint32_t r = 0; r < resources.size(); ++r) {
+            const Resource& resource = resources[r];
+            if (!resource.imported && resource.firstUse != InvalidResource) {
+                const uint32_t position = phase == 0 ? resource.firstUse : resource.lastUse;
+                events[cursor[position]++] = 2 * r + phase;
+            }
+        }
+    }
+
+    pool.BeginFrame();
+    blockCounted.assign(pool.GetBlockCount(), 0);
+
+    // A position's ends follow all of its starts, so a pass never shares a block between
+    // two of its own textures
+    uint64_t liveBytes = 0;
+    for (uint32_t e = 0; e < events.size(); ++e) {
+        Resource& resource  = resources[events[e] / 2];
+        const uint64_t size = resource.desc.Bytes();
+        if (events[e] % 2 != 0) {
+            pool.Release(resource.block);
+            liveBytes -= size;
+            continue;
+        }
+        resource.block = pool.Acquire(size);
+        liveBytes += size;
+        stats.peakLiveBytes = std::max(stats.peakLiveBytes, liveBytes);
+        if (resource.block >= blockCounted.size()) {
+            blockCounted.resize(resource.block + 1, 0);
+        }
+        if (!blockCounted[resource.block]) {
+            blockCounted[resource.block] = 1;
+            stats.aliasedBytes += pool.GetBlockSize(resource.block);
+            ++stats.blocks;
+        }
+    }
+}
+
+// ========================================
+// 3. EXECUTION
+// ========================================
+
+void RenderGraph::Execute() const {
+    for (uint32_t p : order) {
+        if (passes[p].execute) {
+            passes[p].execute(*this);
+        }
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include "TransientPool.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Formats of render graph textures; backends translate them (Graphics: DXGI_FORMAT)
+enum class RenderTargetFormat : uint8_t {
+    RGBA8 = 0,
+    RGB10A2,
+    R11G11B10F,
+    RGBA16F,
+    RG16F,
+    R32F,
+    D32F,
+    D24S8,
+    Count
+};
+
+uint32_t RenderTargetBytesPerPixel(RenderTargetFormat format);
+
+// Size and format of a render graph texture
+struct RenderTargetDesc {
+    uint32_t width            = 0;
+    uint32_t height           = 0;
+    RenderTargetFormat format = RenderTargetFormat::RGBA8;
+    uint32_t mipCount         = 1;
+    uint32_t sampleCount      = 1;
+
+    // Bytes of every mip and sample, tightly packed
+    uint64_t Bytes() const;
+};
+
+// Render Graph Class
+// A frame described as passes that declare which textures they read and write, rebuilt
+// every frame: Reset, declare, Compile, Execute. Passes run in declaration order, so a pass
+// may only read what an earlier pass wrote. Compile does the rest:
+//
+//   Culling    walking backwards from the imported textures (e.g. the back buffer) and the
+//              passes with side effects, a pass survives only if something later reads a
+//              texture it writes. Write without Read replaces the whole texture, so the
+//              writes before it are dead unless read in between; a pass that draws over
+//              existing contents declares both.
+//   Lifetimes  each transient texture lives from the first to the last surviving pass that
+//              uses it; a read of a transient texture nothing wrote fails the compile.
+//   Aliasing   walking the passes in order, a texture takes a TransientPool block when its
+//              lifetime starts and gives it back after its last pass, so textures whose
+//              lifetimes do not overlap share memory.
+//
+// The graph only knows descriptions and block ids; a backend creates the memory behind
+// the blocks and places each texture on GetBlock(texture) when its pass executes.
+// Imported textures are owned by the caller and never placed.
+class RenderGraph {
+  public:
+    static constexpr uint32_t InvalidResource = 0xFFFFFFFFu;
+
+    using ExecuteFunction = std::function<void(const RenderGraph& graph)>;
+
+    // Result of the last Compile
+    struct Stats {
+        uint32_t passes         = 0; // Declared
+        uint32_t culledPasses   = 0;
+        uint32_t transients     = 0; // Transient textures used by surviving passes
+        uint64_t unaliasedBytes = 0; // Every transient texture in memory of its own
+        uint64_t peakLiveBytes  = 0; // Most bytes of transient textures alive at once
+        uint64_t aliasedBytes   = 0; // Pool blocks the frame used (size classes rounded up)
+        uint32_t blocks         = 0;
+    };
+
+    // Forget the previous frame's passes and textures; the pool keeps its blocks
+    void Reset();
+
+    /*
+    Declare a texture whose memory the graph manages
+    name: Not copied (a string literal); for debugging
+    */
+    uint32_t CreateTexture(const char* name, const RenderTargetDesc& desc);
+
+    // Declare a texture owned outside the graph; its final contents are the frame's output
+    uint32_t ImportTexture(const char* name, const RenderTargetDesc& desc);
+
+    // Add a pass after every pass so far; execute runs it if it survives culling
+    uint32_t AddPass(const char* name, ExecuteFunction execute);
+
+    void Read(uint32_t pass, uint32_t texture);
+    void Write(uint32_t pass, uint32_t texture);
+
+    // Keep a pass that writes nothing anyone reads (e.g. a readback or a GPU query)
+    void SetSideEffect(uint32_t pass);
+
+    // Cull, compute lifetimes and place the transient textures; false on an invalid graph
+    bool Compile();
+
+    // Run the surviving passes in order (after a successful Compile)
+    void Execute() const;
+
+    // Surviving passes, in execution order
+    const std::vector<uint32_t>& GetOrder() const {
+        return order;
+    }
+    bool IsPassCulled(uint32_t pass) const {
+        return !passes[pass].live;
+    }
+
+    const RenderTargetDesc& GetDesc(uint32_t texture) const {
+        return resources[texture].desc;
+    }
+    const char* GetName(uint32_t texture) const {
+        return resources[texture].name;
+    }
+    const char* GetPassName(uint32_t pass) const {
+        return passes[pass].name;
+    }
+
+    // TransientPool block of a transient texture; InvalidBlock if imported or unused
+    uint32_t GetBlock(uint32_t texture) const {
+        return resources[texture].block;
+    }
+
+    /*
+    First and last position in GetOrder() that use a texture
+    InvalidResource for both when no surviving pass uses it
+    */
+    uint32_t GetFirstUse(uint32_t texture) const {
+        return resources[texture].firstUse;
+    }
+    uint32_t GetLastUse(uint32_t texture) const {
+        return resources[texture].lastUse;
+    }
+
+    Stats GetStats() const {
+        return stats;
+    }
+
+    TransientPool& GetPool() {
+        return pool;
+    }
+
+  private:
+    struct Resource {
+        const char* name;
+        RenderTargetDesc desc;
+        bool imported;
+        uint32_t firstUse;
+        uint32_t lastUse;
+        uint32_t block;
+    };
+
+    struct Pass {
+        const char* name;
+        ExecuteFunction execute;
+        bool sideEffect;
+        bool live;
+    };
+
+    struct Use {
+        uint32_t pass;
+        uint32_t resource;
+        bool write;
+    };
+
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+    std::vector<Use> uses; // In declaration order
+    std::vector<uint32_t> order;
+    TransientPool pool;
+    Stats stats;
+
+    // Compile scratch, kept between frames
+    std::vector<uint32_t> passUseStart; // Pass p's uses start at sortedUses[passUseStart[p]]
+    std::vector<Use> sortedUses;
+    std::vector<uint8_t> needed;
+    std::vector<uint8_t> written;
+    std::vector<uint32_t> eventStart; // Textures starting or ending at each order position
+    std::vector<uint32_t> events;
+    std::vector<uint32_t> cursor;
+    std::vector<uint8_t> blockCounted;
+
+    void SortUses();
+    void Cull();
+    bool ComputeLifetimes();
+    void Place();
+};
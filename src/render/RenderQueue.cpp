@@ -0,0 +1,186 @@
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cstring>
+
+RenderQueue::RenderQueue() : packetCount(0) {}
+
+void RenderQueue::Reserve(uint32_t packetCapacity) {
+    if (packets.size() < packetCapacity) {
+        packets.resize(packetCapacity);
+        entries.resize(packetCapacity);
+        scratch.resize(packetCapacity);
+    }
+}
+
+void RenderQueue::Reset() {
+    packetCount.store(0, std::memory_order_release);
+}
+
+bool RenderQueue::Submit(const DrawPacket& packet) {
+    uint32_t slot = packetCount.fetch_add(1, std::memory_order_acq_rel);
+    if (slot >= packets.size()) {
+        packetCount.fetch_sub(1, std::memory_order_acq_rel);
+        return false;
+    }
+    packets[slot] = packet;
+    return true;
+}
+
+void RenderQueue::Sort() {
+    const uint32_t count = GetPacketCount();
+    stats                = Stats();
+    stats.packets        = count;
+    if (count == 0) {
+        return;
+    }
+
+    const uint32_t chunkCount = (count + ChunkSize - 1) / ChunkSize;
+    chunkHistograms.assign(static_cast<size_t>(chunkCount) * 8 * 256, 0);
+
+    auto runTasks = [&](const std::function<void(uint32_t)>& task) {
+        if (parallelFor && chunkCount > 1) {
+            parallelFor(chunkCount, task);
+        } else {
+            for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+                task(chunk);
+            }
+        }
+    };
+
+    // ========================================
+    // 1. GATHER KEYS AND FUSED HISTOGRAMS
+    // ========================================
+    // One sweep counts all 8 key bytes; a byte that is identical in every key (typically
+    // the layer and most of the shader field) needs no pass at all
+    runTasks([&](uint32_t chunk) {
+        uint32_t begin      = chunk * ChunkSize;
+        uint32_t end        = std::min(count, begin + ChunkSize);
+        uint32_t* histogram = Histogram(chunk, 0);
+        for (uint32_t i = begin; i < end; ++i) {
+            uint64_t key = packets[i].sortKey;
+            entries[i]   = {key, i, 0};
+            for (uint32_t pass = 0; pass < 8; ++pass) {
+                ++histogram[pass * 256 + ((key >> (pass * 8)) & 0xFF)];
+            }
+        }
+    });
+
+    bool passNeeded[8];
+    for (uint32_t pass = 0; pass < 8; ++pass) {
+        passNeeded[pass] = true;
+        for (uint32_t bucket = 0; bucket < 256; ++bucket) {
+            uint32_t total = 0;
+            for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+                total += Histogram(chunk, pass)[bucket];
+            }
+            if (total == count) {
+                passNeeded[pass] = false;
+                break;
+            }
+            if (total != 0) {
+                break;
+            }
+        }
+    }
+
+    // ========================================
+    // 2. LSD RADIX PASSES (CHUNKED, STABLE)
+    // ========================================
+    SortEntry* src = entries.data();
+    SortEntry* dst = scratch.data();
+    std::pmr::vector<uint32_t> offsets(static_cast<size_t>(chunkCount) * 256, memoryResource);
+
+    for (uint32_t pass = 0; pass < 8; ++pass) {
+        if (!passNeeded[pass]) {
+            continue;
+        }
+        const uint32_t shift = pass * 8;
+
+        // Per-chunk histogram of the current byte in the current order
+        if (stats.radixPasses > 0) {
+            runTasks([&](uint32_t chunk) {
+                uint32_t begin      = chunk * ChunkSize;
+                uint32_t end        = std::min(count, begin + ChunkSize);
+                uint32_t* histogram = Histogram(chunk, pass);
+                std::memset(histogram, 0, 256 * sizeof(uint32_t));
+                for (uint32_t i = begin; i < end; ++i) {
+                    ++histogram[(src[i].key >> shift) & 0xFF];
+                }
+            });
+        }
+
+        // Exclusive prefix sum, bucket-major then chunk order, keeps the sort stable
+        uint32_t running = 0;
+        for (uint32_t bucket = 0; bucket < 256; ++bucket) {
+            for (uint32_t chunk = 0; chunk < chunkCount; ++chunk) {
+                offsets[chunk * 256 + bucket] = running;
+                running += Histogram(chunk, pass)[bucket];
+            }
+        }
+
+        // Scatter: every chunk owns disjoint destination ranges, so chunks run in parallel
+        runTasks([&](uint32_t chunk) {
+            uint32_t begin   = chunk * ChunkSize;
+            uint32_t end     = std::min(count, begin + ChunkSize);
+            uint32_t* offset = &offsets[chunk * 256];
+            for (uint32_t i = begin; i < end; ++i) {
+                dst[offset[(src[i].key >> shift) & 0xFF]++] = src[i];
+            }
+        });
+
+        std::swap(src, dst);
+        ++stats.radixPasses;
+    }
+
+    // Leave the sorted order in entries
+    if (src != entries.data()) {
+        entries.swap(scratch);
+    }
+}
+
+void RenderQueue::Execute(Dispatcher& dispatcher) {
+    Stats counters        = ExecuteRange(dispatcher, 0, GetPacketCount());
+    stats.shaderChanges   = counters.shaderChanges;
+    stats.materialChanges = counters.materialChanges;
+    stats.geometryChanges = counters.geometryChanges;
+}
+
+RenderQueue::Stats RenderQueue::ExecuteRange(Dispatcher& dispatcher,
+                                             uint32_t begin,
+                                             uint32_t end) const {
+    Stats counters;
+    end = std::min(end, GetPacketCount());
+
+    uint32_t currentShader   = ~0u;
+    uint32_t currentMaterial = ~0u;
+    uint32_t currentGeometry = ~0u;
+    uint32_t currentOffset   = ~0u;
+
+    for (uint32_t i = begin; i < end; ++i) {
+        const DrawPacket& packet = packets[entries[i].index];
+
+        uint32_t shader = SortKey::Shader(packet.sortKey);
+        if (shader != currentShader) {
+            dispatcher.BindShader(shader);
+            currentShader = shader;
+            ++counters.shaderChanges;
+        }
+
+        uint32_t material = SortKey::Material(packet.sortKey);
+        if (material != currentMaterial) {
+            dispatcher.BindMaterial(material);
+            currentMaterial = material;
+            ++counters.materialChanges;
+        }
+
+        if (packet.geometry != currentGeometry || packet.vertexOffset != currentOffset) {
+            dispatcher.BindGeometry(packet.geometry, packet.vertexOffset);
+            currentGeometry = packet.geometry;
+            currentOffset   = packet.vertexOffset;
+            ++counters.geometryChanges;
+        }
+
+        dispatcher.Draw(packet);
+    }
+    return counters;
+}
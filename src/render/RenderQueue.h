@@ -0,0 +1,154 @@
+#pragma once
+#include "threading/ParallelFor.h"
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// Sort Key Helpers
+// 64-bit key, most significant field first, so sorting by key minimizes state changes:
+// [63..60] layer | [59..48] shader | [47..32] material | [31..8] depth bucket | [7..0] sequence
+namespace SortKey {
+
+constexpr uint64_t Make(uint32_t layer,
+                        uint32_t shader,
+                        uint32_t material,
+                        uint32_t depth,
+                        uint32_t sequence = 0) {
+    return (static_cast<uint64_t>(layer & 0xF) << 60) |
+           (static_cast<uint64_t>(shader & 0xFFF) << 48) |
+           (static_cast<uint64_t>(material & 0xFFFF) << 32) |
+           (static_cast<uint64_t>(depth & 0xFFFFFF) << 8) | (sequence & 0xFF);
+}
+
+constexpr uint32_t Layer(uint64_t key) {
+    return static_cast<uint32_t>(key >> 60) & 0xF;
+}
+constexpr uint32_t Shader(uint64_t key) {
+    return static_cast<uint32_t>(key >> 48) & 0xFFF;
+}
+constexpr uint32_t Material(uint64_t key) {
+    return static_cast<uint32_t>(key >> 32) & 0xFFFF;
+}
+constexpr uint32_t Depth(uint64_t key) {
+    return static_cast<uint32_t>(key >> 8) & 0xFFFFFF;
+}
+
+// Quantize a view depth in [nearZ, farZ] to the 24-bit depth field (front to back)
+inline uint32_t QuantizeDepth(float viewDepth, float nearZ, float farZ) {
+    float t = (viewDepth - nearZ) / (farZ - nearZ);
+    t       = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    return static_cast<uint32_t>(t * 16777215.0f);
+}
+
+} // namespace SortKey
+
+// Draw Packet
+// Compact POD describing one draw; handles index tables owned by the backend
+struct DrawPacket {
+    uint64_t sortKey;       // See SortKey; shader and material are decoded from it
+    uint32_t geometry;      // Vertex buffer handle
+    uint32_t vertexOffset;  // Byte offset into the vertex buffer
+    uint32_t vertexCount;   // Vertices per instance
+    uint32_t startVertex;   // First vertex
+    uint32_t instanceCount; // 1 for non-instanced draws
+    uint32_t startInstance; // First instance in the instance stream (0 = identity)
+    uint32_t constants;     // First 256-byte constant slot (ConstantAllocator), or InvalidSlot
+};
+static_assert(sizeof(DrawPacket) == 40, "8-byte key and seven 32-bit fields; the sort moves keys");
+
+// Render Queue Class
+// Collects draw packets for one frame, radix-sorts them by key and replays them through a
+// Dispatcher, only re-binding shader, material and geometry when they actually change
+class RenderQueue {
+  public:
+    // Backend hook that turns sorted packets into API calls
+    class Dispatcher {
+      public:
+        virtual ~Dispatcher() = default;
+
+        virtual void BindShader(uint32_t shader)                            = 0;
+        virtual void BindMaterial(uint32_t material)                        = 0;
+        virtual void BindGeometry(uint32_t geometry, uint32_t vertexOffset) = 0;
+        virtual void Draw(const DrawPacket& packet)                         = 0;
+    };
+
+    // Counters for the last Sort()/Execute()
+    struct Stats {
+        uint32_t packets         = 0;
+        uint32_t radixPasses     = 0; // Byte passes actually performed (uniform bytes skipped)
+        uint32_t shaderChanges   = 0;
+        uint32_t materialChanges = 0;
+        uint32_t geometryChanges = 0;
+    };
+
+    RenderQueue();
+
+    // Pre-size storage so Submit never reallocates during the frame
+    void Reserve(uint32_t packetCount);
+
+    // Discard all packets; call once per frame before submitting
+    void Reset();
+
+    /*
+    Append a packet
+    Thread safe as long as the total stays within the reserved capacity
+    Returns false when the queue is full
+    */
+    bool Submit(const DrawPacket& packet);
+
+    // Radix-sort submitted packets by sortKey (stable)
+    void Sort();
+
+    // Replay sorted packets through dispatcher with redundant binds removed
+    void Execute(Dispatcher& dispatcher);
+
+    /*
+    Replay sorted packets [begin, end) and return their change counters
+    Const and independent per range, so ranges can be recorded on separate threads
+    (e.g. one deferred context each); binds restart from scratch at begin
+    */
+    Stats ExecuteRange(Dispatcher& dispatcher, uint32_t begin, uint32_t end) const;
+
+    // Install a parallel executor for the sort's per-chunk histogram and scatter passes
+    // (default: serial)
+    void SetParallelFor(ParallelFor executor) {
+        parallelFor = std::move(executor);
+    }
+
+    // Memory for the sort's per-frame scratch (default: the global heap)
+    void SetMemoryResource(std::pmr::memory_resource* resource) {
+        memoryResource = resource;
+    }
+
+    uint32_t GetPacketCount() const {
+        return packetCount.load(std::memory_order_acquire);
+    }
+    const Stats& GetStats() const {
+        return stats;
+    }
+
+  private:
+    struct SortEntry {
+        uint64_t key;
+        uint32_t index;
+        uint32_t padding;
+    };
+
+    // Packets per parallel task; below two chunks the sort runs serially
+    static constexpr uint32_t ChunkSize = 16384;
+
+    std::vector<DrawPacket> packets;
+    std::atomic<uint32_t> packetCount;
+    std::vector<SortEntry> entries;
+    std::vector<SortEntry> scratch;
+    std::vector<uint32_t> chunkHistograms; // chunkCount * 8 passes * 256 buckets
+    ParallelFor parallelFor;
+    std::pmr::memory_resource* memoryResource = std::pmr::get_default_resource();
+    Stats stats;
+
+    // 256 bucket counts for one key byte of one chunk
+    uint32_t* Histogram(uint32_t chunk, uint32_t pass) {
+        return &chunkHistograms[(static_cast<size_t>(chunk) * 8 + pass) * 256];
+    }
+};
@@ -0,0 +1,223 @@
+#include "ShaderArchive.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+static_assert(sizeof(ShaderArchive::Header) == 16, "archive layout is part of the file format");
+static_assert(sizeof(ShaderArchive::Entry) == 72, "archive layout is part of the file format");
+
+namespace {
+
+// Indexed by ShaderStage
+const char* const StageSuffixes[] = {"VS", "PS", "GS", "HS", "DS", "CS"};
+
+} // namespace
+
+bool ShaderStageFromName(const std::string& name, ShaderStage& stage) {
+    if (name.size() < 2) {
+        return false;
+    }
+    for (uint32_t i = 0; i < static_cast<uint32_t>(ShaderStage::Count); ++i) {
+        if (name.compare(name.size() - 2, 2, StageSuffixes[i]) == 0) {
+            stage = static_cast<ShaderStage>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* ShaderStageSuffix(ShaderStage stage) {
+    return stage < ShaderStage::Count ? StageSuffixes[static_cast<uint32_t>(stage)] : "??";
+}
+
+// ========================================
+// 1. READER
+// ========================================
+
+bool ShaderArchive::Open(const std::string& path) {
+    Close();
+    if (!file.Open(path)) {
+        return false;
+    }
+    if (!Load(file.GetData(), file.GetSize())) {
+        file.Close();
+        return false;
+    }
+    return true;
+}
+
+bool ShaderArchive::Load(const uint8_t* data, size_t size) {
+    base       = nullptr;
+    entries    = nullptr;
+    entryCount = 0;
+    blobCount  = 0;
+
+    if (size < sizeof(Header)) {
+        return false;
+    }
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != Magic || header.version != Version) {
+        return false;
+    }
+    if (header.entryCount > (size - sizeof(Header)) / sizeof(Entry)) {
+        return false;
+    }
+
+    // Only the index is inspected here; bytecode pages stay untouched until first use
+    const Entry* index = reinterpret_cast<const Entry*>(data + sizeof(Header));
+    for (uint32_t i = 0; i < header.entryCount; ++i) {
+        const Entry& entry = index[i];
+        if (entry.name[MaxNameLen] != '\0' || entry.stage >= ShaderStage::Count ||
+            entry.size == 0 || entry.offset > size || entry.size > size - entry.offset) {
+            return false;
+        }
+        if (i > 0 && std::strcmp(index[i - 1].name, entry.name) >= 0) {
+            return false; // Find relies on strictly sorted names
+        }
+    }
+
+    base       = data;
+    entries    = index;
+    entryCount = header.entryCount;
+    blobCount  = header.blobCount;
+    return true;
+}
+
+void ShaderArchive::Close() {
+    file.Close();
+    base       = nullptr;
+    entries    = nullptr;
+    entryCount = 0;
+    blobCount  = 0;
+}
+
+bool ShaderArchive::Verify() const {
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        if (Hash(GetBytecode(entries[i]), entries[i].size) != entries[i].hash) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const ShaderArchive::Entry* ShaderArchive::Find(const char* name) const {
+    const Entry* end   = entries + entryCount;
+    auto byName        = [](const Entry& entry, const char* key) {
+        return std::strcmp(entry.name, key) < 0;
+    };
+    const Entry* found = std::lower_bound(entries, end, name, byName);
+    if (found == end || std::strcmp(found->name, name) != 0) {
+        return nullptr;
+    }
+    return found;
+}
+
+uint64_t ShaderArchive::Hash(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash        = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+// ========================================
+// 2. WRITER
+// ========================================
+
+bool ShaderArchiveWriter::Add(const std::string& name,
+                              ShaderStage stage,
+                              const void* data,
+                              size_t size) {
+    if (size == 0 || size > UINT32_MAX || name.empty() || name.size() > ShaderArchive::MaxNameLen ||
+        stage >= ShaderStage::Count) {
+        return false;
+    }
+    for (const Pending& shader : shaders) {
+        if (shader.name == name) {
+            return false;
+        }
+    }
+
+    Pending shader;
+    shader.name  = name;
+    shader.stage = stage;
+    shader.hash  = ShaderArchive::Hash(data, size);
+    shader.bytecode.assign(static_cast<const uint8_t*>(data),
+                           static_cast<const uint8_t*>(data) + size);
+    shaders.push_back(std::move(shader));
+    return true;
+}
+
+std::vector<uint8_t> ShaderArchiveWriter::Build() const {
+    std::vector<const Pending*> sorted;
+    sorted.reserve(shaders.size());
+    for (const Pending& shader : shaders) {
+        sorted.push_back(&shader);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Pending* a, const Pending* b) {
+        return a->name < b->name;
+    });
+
+    const size_t indexSize = sizeof(ShaderArchive::Entry) * sorted.size();
+    std::vector<uint8_t> out(sizeof(ShaderArchive::Header) + indexSize, 0);
+
+    // Lay out blobs, reusing the offset of an earlier blob with the same contents
+    struct Blob {
+        const Pending* shader;
+        uint64_t offset;
+    };
+    std::unordered_map<uint64_t, std::vector<Blob>> written;
+    std::vector<ShaderArchive::Entry> entries(sorted.size());
+    uint32_t blobCount = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const Pending& shader       = *sorted[i];
+        ShaderArchive::Entry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        std::memcpy(entry.name, shader.name.c_str(), shader.name.size());
+        entry.stage = shader.stage;
+        entry.size  = static_cast<uint32_t>(shader.bytecode.size());
+        entry.hash  = shader.hash;
+
+        std::vector<Blob>& sameHash = written[shader.hash];
+        auto sameBytes = [&](const Blob& blob) {
+            return blob.shader->bytecode == shader.bytecode;
+        };
+        auto duplicate = std::find_if(sameHash.begin(), sameHash.end(), sameBytes);
+        if (duplicate != sameHash.end()) {
+            entry.offset = duplicate->offset;
+            continue;
+        }
+
+        const size_t alignMask = ShaderArchive::BlobAlign - 1;
+        size_t offset          = (out.size() + alignMask) & ~alignMask;
+        out.resize(offset);
+        out.insert(out.end(), shader.bytecode.begin(), shader.bytecode.end());
+        entry.offset = offset;
+        sameHash.push_back({&shader, offset});
+        ++blobCount;
+    }
+
+    ShaderArchive::Header header;
+    header.magic      = ShaderArchive::Magic;
+    header.version    = ShaderArchive::Version;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.blobCount  = blobCount;
+    std::memcpy(out.data(), &header, sizeof(header));
+    if (!entries.empty()) {
+        std::memcpy(out.data() + sizeof(header), entries.data(), indexSize);
+    }
+    return out;
+}
+
+bool ShaderArchiveWriter::Write(const std::string& path) const {
+    std::vector<uint8_t> bytes = Build();
+    FILE* file                 = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && ok;
+}
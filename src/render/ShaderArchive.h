@@ -0,0 +1,108 @@
+#pragma once
+#include "utils/MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class ShaderStage : uint32_t { Vertex = 0, Pixel, Geometry, Hull, Domain, Compute, Count };
+
+// Stage from the naming convention of shaders/: a VS/PS/GS/HS/DS/CS suffix (e.g. "BasicVS")
+bool ShaderStageFromName(const std::string& name, ShaderStage& stage);
+
+// Two-letter suffix for stage ("VS", "PS", ...)
+const char* ShaderStageSuffix(ShaderStage stage);
+
+// Shader Archive Class
+// Read side of the packed shader file written by ShaderArchiveWriter:
+//
+//   Header | Entry[entryCount] sorted by name | blobs (16-byte aligned)
+//
+// Each entry carries the name, stage, size, offset and a 64-bit content hash of its
+// bytecode. Identical bytecode is stored once and shared by every entry that uses it, so
+// equal hashes mean equal blobs. The archive is memory-mapped and never copied; bytecode
+// pointers stay valid until Close.
+class ShaderArchive {
+  public:
+    static constexpr uint32_t Magic      = 0x41444853; // "SHDA"
+    static constexpr uint32_t Version    = 1;
+    static constexpr uint32_t MaxNameLen = 47; // Excluding the terminator
+    static constexpr uint32_t BlobAlign  = 16;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t blobCount; // Distinct blobs after deduplication
+    };
+
+    struct Entry {
+        char name[MaxNameLen + 1];
+        ShaderStage stage;
+        uint32_t size;   // Bytecode size in bytes
+        uint64_t hash;   // Hash(bytecode)
+        uint64_t offset; // From the start of the file
+    };
+
+    // Map and validate an archive file
+    bool Open(const std::string& path);
+
+    /*
+    Validate an archive already in memory (not copied; must outlive this object)
+    Checks the header and that every entry lies inside the buffer
+    */
+    bool Load(const uint8_t* data, size_t size);
+
+    void Close();
+
+    // Recompute every blob's hash; touches all pages, meant for tools and tests
+    bool Verify() const;
+
+    uint32_t GetEntryCount() const {
+        return entryCount;
+    }
+    uint32_t GetBlobCount() const {
+        return blobCount;
+    }
+    const Entry& GetEntry(uint32_t index) const {
+        return entries[index];
+    }
+    const uint8_t* GetBytecode(const Entry& entry) const {
+        return base + entry.offset;
+    }
+
+    // Binary search by name; nullptr when absent
+    const Entry* Find(const char* name) const;
+
+    // 64-bit FNV-1a over the bytecode
+    static uint64_t Hash(const void* data, size_t size);
+
+  private:
+    MappedFile file;
+    const uint8_t* base  = nullptr;
+    const Entry* entries = nullptr;
+    uint32_t entryCount  = 0;
+    uint32_t blobCount   = 0;
+};
+
+// Shader Archive Writer Class
+// Collects named bytecode blobs and lays them out as a ShaderArchive
+class ShaderArchiveWriter {
+  public:
+    // Fails on an empty blob, a name longer than MaxNameLen or a duplicate name
+    bool Add(const std::string& name, ShaderStage stage, const void* data, size_t size);
+
+    // Serialize; blobs with identical contents are written once
+    std::vector<uint8_t> Build() const;
+    bool Write(const std::string& path) const;
+
+  private:
+    struct Pending {
+        std::string name;
+        ShaderStage stage;
+        uint64_t hash;
+        std::vector<uint8_t> bytecode;
+    };
+
+    std::vector<Pending> shaders;
+};
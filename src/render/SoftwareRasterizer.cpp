@@ -0,0 +1,725 @@
+#include "SoftwareRasterizer.h"
+#include "utils/ImageWriter.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTWARE_RASTERIZER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// AVX2 is compiled for any x86 target and picked at run time with CPUID
+#if SOFTWARE_RASTERIZER_SSE2 && (defined(_MSC_VER) || defined(__GNUC__))
+#define SOFTWARE_RASTERIZER_AVX2 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SOFTWARE_RASTERIZER_AVX2_TARGET
+#else
+#define SOFTWARE_RASTERIZER_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+uint32_t PackColor(float r, float g, float b, float a) {
+    auto toByte = [](float v) {
+        v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+        return static_cast<uint32_t>(v * 255.0f + 0.5f);
+    };
+    // Memory order R, G, B, A (matches DXGI_FORMAT_R8G8B8A8_UNORM)
+    return toByte(r) | (toByte(g) << 8) | (toByte(b) << 16) | (toByte(a) << 24);
+}
+
+#if SOFTWARE_RASTERIZER_AVX2
+// The CPU has AVX2 and the OS saves the YMM registers
+bool CpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx     = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
+} // namespace
+
+// ========================================
+// INNER LOOPS
+// ========================================
+// Each rasterizes tri over the pixel rectangle [x0, x1] x [y0, y1] and returns the pixels it
+// wrote. They evaluate E = A*x + (B*y + C) and the attribute planes with the same operations
+// in the same order, so they write identical pixels. The SIMD paths process aligned groups
+// of lanes and mask off those outside [x0, x1]; rows are padded to 8 pixels and tiles are
+// multiples of 8 wide, so a group never reaches into another tile.
+struct SoftwareRasterizer::Kernels {
+    static uint64_t Scalar(const SetupTriangle& tri,
+                           uint32_t* framebuffer,
+                           int stride,
+                           int x0,
+                           int y0,
+                           int x1,
+                           int y1) {
+        uint64_t pixels = 0;
+        for (int y = y0; y <= y1; ++y) {
+            float py      = static_cast<float>(y) + 0.5f;
+            uint32_t* row = framebuffer + static_cast<size_t>(y) * stride;
+
+            float edgeRow[3], planeRow[5];
+            for (int e = 0; e < 3; ++e) {
+                edgeRow[e] = tri.edgeB[e] * py + tri.edgeC[e];
+            }
+            for (int p = 0; p < 5; ++p) {
+                planeRow[p] = tri.plane[p][1] * py + tri.plane[p][2];
+            }
+
+            for (int x = x0; x <= x1; ++x) {
+                float px    = static_cast<float>(x) + 0.5f;
+                bool inside = true;
+                for (int e = 0; e < 3 && inside; ++e) {
+                    float value = tri.edgeA[e] * px + edgeRow[e];
+                    inside      = tri.topLeft[e] ? value >= 0.0f : value > 0.0f;
+                }
+                if (!inside) {
+                    continue;
+                }
+                float attribute[5];
+                for (int p = 0; p < 5; ++p) {
+                    attribute[p] = tri.plane[p][0] * px + planeRow[p];
+                }
+                float w = 1.0f / attribute[0];
+                row[x]  = PackColor(attribute[1] * w,
+                                   attribute[2] * w,
+                                   attribute[3] * w,
+                                   attribute[4] * w);
+                ++pixels;
+            }
+        }
+        return pixels;
+    }
+
+#if SOFTWARE_RASTERIZER_SSE2
+    // 4 pixels per iteration
+    static uint64_t Sse2(const SetupTriangle& tri,
+                         uint32_t* framebuffer,
+                         int stride,
+                         int x0,
+                         int y0,
+                         int x1,
+                         int y1) {
+        const __m128 laneOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128i laneIndex = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128 zero       = _mm_setzero_ps();
+        const __m128 one        = _mm_set1_ps(1.0f);
+        const __m128 scale      = _mm_set1_ps(255.0f);
+        const __m128 half       = _mm_set1_ps(0.5f);
+        const __m128i firstX    = _mm_set1_epi32(x0 - 1);
+        const __m128i lastX     = _mm_set1_epi32(x1 + 1);
+
+        __m128 edgeA[3], planeX[5];
+        for (int e = 0; e < 3; ++e) {
+            edgeA[e] = _mm_set1_ps(tri.edgeA[e]);
+        }
+        for (int p = 0; p < 5; ++p) {
+            planeX[p] = _mm_set1_ps(tri.plane[p][0]);
+        }
+
+        uint64_t pixels = 0;
+        int startX      = x0 & ~3; // Aligned groups; lanes outside [x0, x1] are masked off
+        for (int y = y0; y <= y1; ++y) {
+            float py      = static_cast<float>(y) + 0.5f;
+            uint32_t* row = framebuffer + static_cast<size_t>(y) * stride;
+
+            // Per-row constant terms: B*y + C for edges, p1*y + p2 for attributes
+            __m128 edgeRow[3], planeRow[5];
+            for (int e = 0; e < 3; ++e) {
+                edgeRow[e] = _mm_set1_ps(tri.edgeB[e] * py + tri.edgeC[e]);
+            }
+            for (int p = 0; p < 5; ++p) {
+                planeRow[p] = _mm_set1_ps(tri.plane[p][1] * py + tri.plane[p][2]);
+            }
+
+            for (int x = startX; x <= x1; x += 4) {
+                __m128 px     = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffset);
+                __m128i laneX = _mm_add_epi32(_mm_set1_epi32(x), laneIndex);
+                __m128 mask   = _mm_castsi128_ps(
+                    _mm_and_si128(_mm_cmpgt_epi32(laneX, firstX), _mm_cmplt_epi32(laneX, lastX)));
+
+                for (int e = 0; e < 3; ++e) {
+                    __m128 value = _mm_add_ps(_mm_mul_ps(edgeA[e], px), edgeRow[e]);
+                    __m128 test  = tri.topLeft[e] ? _mm_cmpge_ps(value, zero)
+                                                  : _mm_cmpgt_ps(value, zero);
+                    mask         = _mm_and_ps(mask, test);
+                }
+
+                int bits = _mm_movemask_ps(mask);
+                if (bits == 0) {
+                    continue;
+                }
+
+                // Perspective-correct interpolation: color = (color/w) / (1/w)
+                __m128 invW = _mm_add_ps(_mm_mul_ps(planeX[0], px), planeRow[0]);
+                __m128 w    = _mm_div_ps(one, invW);
+                __m128i channel[4];
+                for (int c = 0; c < 4; ++c) {
+                    __m128 value = _mm_add_ps(_mm_mul_ps(planeX[1 + c], px), planeRow[1 + c]);
+                    value        = _mm_min_ps(_mm_max_ps(_mm_mul_ps(value, w), zero), one);
+                    channel[c]   = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half));
+                }
+                __m128i packed = _mm_or_si128(
+                    _mm_or_si128(channel[0], _mm_slli_epi32(channel[1], 8)),
+                    _mm_or_si128(_mm_slli_epi32(channel[2], 16), _mm_slli_epi32(channel[3], 24)));
+
+                __m128i* dst     = reinterpret_cast<__m128i*>(row + x);
+                __m128i existing = _mm_loadu_si128(dst);
+                __m128i keep     = _mm_castps_si128(mask);
+                _mm_storeu_si128(dst,
+                                 _mm_or_si128(_mm_and_si128(keep, packed),
+                                              _mm_andnot_si128(keep, existing)));
+
+                for (; bits != 0; bits &= bits - 1) {
+                    ++pixels;
+                }
+            }
+        }
+        return pixels;
+    }
+#endif
+
+#if SOFTWARE_RASTERIZER_AVX2
+    // 8 pixels per iteration; the same steps as Sse2 on twice the lanes
+    SOFTWARE_RASTERIZER_AVX2_TARGET
+    static uint64_t Avx2(const SetupTriangle& tri,
+                         uint32_t* framebuffer,
+                         int stride,
+                         int x0,
+                         int y0,
+                         int x1,
+                         int y1) {
+        const __m256 laneOffset = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+        const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256 zero       = _mm256_setzero_ps();
+        const __m256 one        = _mm256_set1_ps(1.0f);
+        const __m256 scale      = _mm256_set1_ps(255.0f);
+        const __m256 half       = _mm256_set1_ps(0.5f);
+        const __m256i firstX    = _mm256_set1_epi32(x0 - 1);
+        const __m256i lastX     = _mm256_set1_epi32(x1 + 1);
+
+        __m256 edgeA[3], planeX[5];
+        for (int e = 0; e < 3; ++e) {
+            edgeA[e] = _mm256_set1_ps(tri.edgeA[e]);
+        }
+        for (int p = 0; p < 5; ++p) {
+            planeX[p] = _mm256_set1_ps(tri.plane[p][0]);
+        }
+
+        uint64_t pixels = 0;
+        int startX      = x0 & ~7;
+        for (int y = y0; y <= y1; ++y) {
+            float py      = static_cast<float>(y) + 0.5f;
+            uint32_t* row = framebuffer + static_cast<size_t>(y) * stride;
+
+            __m256 edgeRow[3], planeRow[5];
+            for (int e = 0; e < 3; ++e) {
+                edgeRow[e] = _mm256_set1_ps(tri.edgeB[e] * py + tri.edgeC[e]);
+            }
+            for (int p = 0; p < 5; ++p) {
+                planeRow[p] = _mm256_set1_ps(tri.plane[p][1] * py + tri.plane[p][2]);
+            }
+
+            for (int x = startX; x <= x1; x += 8) {
+                __m256 px     = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffset);
+                __m256i laneX = _mm256_add_epi32(_mm256_set1_epi32(x), laneIndex);
+                __m256 mask   = _mm256_castsi256_ps(_mm256_and_si256(
+                    _mm256_cmpgt_epi32(laneX, firstX), _mm256_cmpgt_epi32(lastX, laneX)));
+
+                for (int e = 0; e < 3; ++e) {
+                    __m256 value = _mm256_add_ps(_mm256_mul_ps(edgeA[e], px), edgeRow[e]);
+                    __m256 test  = tri.topLeft[e] ? _mm256_cmp_ps(value, zero, _CMP_GE_OQ)
+                                                  : _mm256_cmp_ps(value, zero, _CMP_GT_OQ);
+                    mask         = _mm256_and_ps(mask, test);
+                }
+
+                int bits = _mm256_movemask_ps(mask);
+                if (bits == 0) {
+                    continue;
+                }
+
+                __m256 invW = _mm256_add_ps(_mm256_mul_ps(planeX[0], px), planeRow[0]);
+                __m256 w    = _mm256_div_ps(one, invW);
+                __m256i channel[4];
+                for (int c = 0; c < 4; ++c) {
+                    __m256 value = _mm256_add_ps(_mm256_mul_ps(planeX[1 + c], px), planeRow[1 + c]);
+                    value = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(value, w), zero), one);
+                    channel[c] =
+                        _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, scale), half));
+                }
+                __m256i packed =
+                    _mm256_or_si256(_mm256_or_si256(channel[0], _mm256_slli_epi32(channel[1], 8)),
+                                    _mm256_or_si256(_mm256_slli_epi32(channel[2], 16),
+                                                    _mm256_slli_epi32(channel[3], 24)));
+
+                __m256i* dst     = reinterpret_cast<__m256i*>(row + x);
+                __m256i existing = _mm256_loadu_si256(dst);
+                _mm256_storeu_si256(
+                    dst, _mm256_blendv_epi8(existing, packed, _mm256_castps_si256(mask)));
+
+                for (; bits != 0; bits &= bits - 1) {
+                    ++pixels;
+                }
+            }
+        }
+        return pixels;
+    }
+#endif
+};
+
+SoftwareRasterizer::SoftwareRasterizer()
+    : nextTile(0),
+      statTriangles(0),
+      statRasterized(0),
+      statPixels(0) {}
+
+SoftwareRasterizer::~SoftwareRasterizer() {
+    StopWorkers();
+}
+
+bool SoftwareRasterizer::Initialize(const BackendDesc& desc) {
+    if (desc.width <= 0 || desc.height <= 0) {
+        return false;
+    }
+    width  = desc.width;
+    height = desc.height;
+    stride = (width + 7) & ~7;
+    framebuffer.assign(static_cast<size_t>(stride) * height, 0);
+
+    tilesX = (width + TileSize - 1) / TileSize;
+    tilesY = (height + TileSize - 1) / TileSize;
+    bins.assign(static_cast<size_t>(tilesX) * tilesY, {});
+    triangles.clear();
+
+    if (workers.empty()) {
+        SetThreadCount(0);
+    }
+    return true;
+}
+
+void SoftwareRasterizer::SetThreadCount(uint32_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    StopWorkers();
+
+    // Workers start from the generation current at spawn time. Reading it from the new thread
+    // would race with a RasterizeTiles() that bumps it first, and the worker would sleep
+    // through that batch while the caller waits for it forever
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        poolQuit   = false;
+        generation = poolGeneration;
+    }
+    for (uint32_t i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&SoftwareRasterizer::WorkerLoop, this, generation);
+    }
+}
+
+SoftwareRasterizer::RasterPath SoftwareRasterizer::SetRasterPath(RasterPath path) {
+    const RasterPath best = GetBestRasterPath();
+    rasterPath            = path < best ? path : best;
+    return rasterPath;
+}
+
+SoftwareRasterizer::RasterPath SoftwareRasterizer::GetBestRasterPath() {
+#if SOFTWARE_RASTERIZER_AVX2
+    static const bool avx2 = CpuHasAvx2();
+    if (avx2) {
+        return RasterPath::Avx2;
+    }
+#endif
+#if SOFTWARE_RASTERIZER_SSE2
+    return RasterPath::Sse2;
+#else
+    return RasterPath::Scalar;
+#endif
+}
+
+void SoftwareRasterizer::StopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        poolQuit = true;
+    }
+    poolWake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+void SoftwareRasterizer::Clear(const float color[4]) {
+    // Draws recorded before the clear must land before it is applied
+    if (!triangles.empty()) {
+        Flush();
+    }
+    clearValue          = PackColor(color[0], color[1], color[2], color[3]);
+    clearPending        = true;
+    frameViewProjection = viewProjection; // Graphics also writes its camera at the clear
+}
+
+void SoftwareRasterizer::SetVertexBuffer(const Vertex* vertices, uint32_t vertexCount) {
+    vertexBuffer.assign(vertices, vertices + vertexCount);
+}
+
+void SoftwareRasterizer::Draw(uint32_t vertexCount, uint32_t startVertex) {
+    if (startVertex >= vertexBuffer.size()) {
+        return;
+    }
+    uint32_t available = static_cast<uint32_t>(vertexBuffer.size()) - startVertex;
+    uint32_t count     = std::min(vertexCount, available) / 3 * 3;
+
+    for (uint32_t i = 0; i < count; i += 3) {
+        const Vertex* v = &vertexBuffer[startVertex + i];
+        SetupAndBin(v[0], v[1], v[2]);
+    }
+    statTriangles.fetch_add(count / 3, std::memory_order_relaxed);
+}
+
+void SoftwareRasterizer::SetInstanceBuffer(const InstanceData* instances, uint32_t instanceCount) {
+    instanceBuffer.assign(instances, instances + instanceCount);
+}
+
+void SoftwareRasterizer::DrawInstanced(uint32_t vertexCount,
+                                       uint32_t instanceCount,
+                                       uint32_t startVertex,
+                                       uint32_t startInstance) {
+    if (startVertex >= vertexBuffer.size() || startInstance >= instanceBuffer.size()) {
+        return;
+    }
+    uint32_t available = static_cast<uint32_t>(vertexBuffer.size()) - startVertex;
+    uint32_t count     = std::min(vertexCount, available) / 3 * 3;
+    uint32_t instances =
+        std::min(instanceCount, static_cast<uint32_t>(instanceBuffer.size()) - startInstance);
+
+    // Same math as BasicVS: position' = transform * (position, 1), color' = color * tint
+    for (uint32_t n = 0; n < instances; ++n) {
+        const InstanceData& instance = instanceBuffer[startInstance + n];
+        for (uint32_t i = 0; i < count; i += 3) {
+            Vertex v[3];
+            for (int k = 0; k < 3; ++k) {
+                const Vertex& in = vertexBuffer[startVertex + i + k];
+                for (int row = 0; row < 3; ++row) {
+                    const float* m     = instance.transform[row];
+                    v[k].position[row] = m[0] * in.position[0] + m[1] * in.position[1] +
+                                         m[2] * in.position[2] + m[3];
+                }
+                for (int c = 0; c < 4; ++c) {
+                    v[k].color[c] = in.color[c] * instance.color[c];
+                }
+            }
+            SetupAndBin(v[0], v[1], v[2]);
+        }
+    }
+    statTriangles.fetch_add(static_cast<uint64_t>(count / 3) * instances,
+                            std::memory_order_relaxed);
+}
+
+void SoftwareRasterizer::Present() {
+    Flush();
+    if (!dumpPath.empty()) {
+        SaveFrame(dumpPath);
+    }
+}
+
+void SoftwareRasterizer::Flush() {
+    if (triangles.empty() && !clearPending) {
+        return;
+    }
+    RasterizeTiles();
+
+    for (std::vector<uint32_t>& bin : bins) {
+        bin.clear();
+    }
+    triangles.clear();
+    clearPending = false;
+}
+
+bool SoftwareRasterizer::SaveFrame(const std::string& path) {
+    Flush();
+    bool png = path.size() >= 4 && path.compare(path.size() - 4, 4, ".png") == 0;
+    if (png) {
+        return ImageWriter::WritePNG(path, GetPixels(), width, height, GetRowPitch());
+    }
+    return ImageWriter::WritePPM(path, GetPixels(), width, height, GetRowPitch());
+}
+
+SoftwareRasterizer::Stats SoftwareRasterizer::GetStats() const {
+    Stats stats;
+    stats.trianglesSubmitted  = statTriangles.load(std::memory_order_relaxed);
+    stats.trianglesRasterized = statRasterized.load(std::memory_order_relaxed);
+    stats.pixelsWritten       = statPixels.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SoftwareRasterizer::ResetStats() {
+    statTriangles.store(0, std::memory_order_relaxed);
+    statRasterized.store(0, std::memory_order_relaxed);
+    statPixels.store(0, std::memory_order_relaxed);
+}
+
+void SoftwareRasterizer::SetupAndBin(const Vertex& v0, const Vertex& v1, const Vertex& v2) {
+    // ========================================
+    // 1. OBJECT SPACE TO CLIP SPACE
+    // ========================================
+    // Same as BasicVS: clip position = (x, y, z, 1) * worldViewProjection
+    const Vertex* v[3] = {&v0, &v1, &v2};
+    const float(*m)[4] = frameViewProjection.m;
+    ClipVertex clip[3];
+    for (int i = 0; i < 3; ++i) {
+        const float* p = v[i]->position;
+        for (int k = 0; k < 4; ++k) {
+            clip[i].position[k] = p[0] * m[0][k] + p[1] * m[1][k] + p[2] * m[2][k] + m[3][k];
+            clip[i].color[k]    = v[i]->color[k];
+        }
+    }
+
+    // ========================================
+    // 2. NEAR AND FAR PLANE CLIPPING
+    // ========================================
+    // D3D keeps 0 <= z <= w. x and y need no clipping: the screen bounds clamp them once w > 0
+    auto nearDistance = [](const ClipVertex& c) { return c.position[2]; };
+    auto farDistance  = [](const ClipVertex& c) { return c.position[3] - c.position[2]; };
+
+    bool inside = true;
+    for (int i = 0; i < 3; ++i) {
+        inside = inside && nearDistance(clip[i]) >= 0.0f && farDistance(clip[i]) >= 0.0f;
+    }
+    if (inside) {
+        BinTriangle(clip[0], clip[1], clip[2]);
+        return;
+    }
+
+    // Sutherland-Hodgman against each plane: a triangle grows to at most 5 vertices
+    ClipVertex polygon[2][5];
+    int count = 3;
+    std::copy(clip, clip + 3, polygon[0]);
+    int current = 0;
+    for (int plane = 0; plane < 2 && count >= 3; ++plane) {
+        const ClipVertex* in = polygon[current];
+        ClipVertex* out      = polygon[current ^ 1];
+        int outCount         = 0;
+        for (int i = 0; i < count; ++i) {
+            const ClipVertex& a = in[i];
+            const ClipVertex& b = in[(i + 1) % count];
+            float da            = plane == 0 ? nearDistance(a) : farDistance(a);
+            float db            = plane == 0 ? nearDistance(b) : farDistance(b);
+            if (da >= 0.0f) {
+                out[outCount++] = a;
+            }
+            if ((da >= 0.0f) != (db >= 0.0f)) {
+                float t         = da / (da - db);
+                ClipVertex& mid = out[outCount++];
+                for (int k = 0; k < 4; ++k) {
+                    mid.position[k] = a.position[k] + (b.position[k] - a.position[k]) * t;
+                    mid.color[k]    = a.color[k] + (b.color[k] - a.color[k]) * t;
+                }
+            }
+        }
+        count   = outCount;
+        current = 1 - current;
+    }
+
+    // Clipping keeps the winding, so a fan of the polygon culls like the original triangle
+    for (int i = 1; i + 1 < count; ++i) {
+        BinTriangle(polygon[current][0], polygon[current][i], polygon[current][i + 1]);
+    }
+}
+
+void SoftwareRasterizer::BinTriangle(const ClipVertex& v0,
+                                     const ClipVertex& v1,
+                                     const ClipVertex& v2) {
+    // ========================================
+    // 1. CLIP SPACE TO SCREEN SPACE
+    // ========================================
+    // Attributes are interpolated as value/w and divided by the interpolated 1/w per pixel
+    const ClipVertex* v[3] = {&v0, &v1, &v2};
+    float sx[3], sy[3], invW[3];
+    for (int i = 0; i < 3; ++i) {
+        const float w = v[i]->position[3];
+        if (!(w > 0.0f)) {
+            return; // Only a degenerate projection puts a vertex inside z range behind the eye
+        }
+        invW[i] = 1.0f / w;
+        sx[i]   = (v[i]->position[0] * invW[i] * 0.5f + 0.5f) * width;
+        sy[i]   = (0.5f - v[i]->position[1] * invW[i] * 0.5f) * height;
+    }
+
+    // ========================================
+    // 2. BACK-FACE CULLING
+    // ========================================
+    // D3D11 default rasterizer state: clockwise is front facing, back faces are culled
+    // With y pointing down, a clockwise triangle has positive signed area
+    float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+    if (!(area > 0.0f)) {
+        return;
+    }
+
+    // ========================================
+    // 3. EDGE EQUATIONS AND ATTRIBUTE PLANES
+    // ========================================
+    SetupTriangle tri;
+    for (int e = 0; e < 3; ++e) {
+        int a          = (e + 1) % 3; // Edge e is opposite vertex e
+        int b          = (e + 2) % 3;
+        float A        = sy[a] - sy[b];
+        float B        = sx[b] - sx[a];
+        tri.edgeA[e]   = A;
+        tri.edgeB[e]   = B;
+        tri.edgeC[e]   = -(A * sx[a] + B * sy[a]);
+        tri.topLeft[e] = A > 0.0f || (A == 0.0f && B > 0.0f);
+    }
+
+    // Attribute values carry 1/w so they can be interpolated linearly in screen space
+    float attributes[5][3];
+    for (int i = 0; i < 3; ++i) {
+        attributes[0][i] = invW[i];
+        for (int c = 0; c < 4; ++c) {
+            attributes[1 + c][i] = v[i]->color[c] * invW[i];
+        }
+    }
+    float invArea = 1.0f / area;
+    for (int p = 0; p < 5; ++p) {
+        const float* f = attributes[p];
+        tri.plane[p][0] =
+            (tri.edgeA[0] * f[0] + tri.edgeA[1] * f[1] + tri.edgeA[2] * f[2]) * invArea;
+        tri.plane[p][1] =
+            (tri.edgeB[0] * f[0] + tri.edgeB[1] * f[1] + tri.edgeB[2] * f[2]) * invArea;
+        tri.plane[p][2] =
+            (tri.edgeC[0] * f[0] + tri.edgeC[1] * f[1] + tri.edgeC[2] * f[2]) * invArea;
+    }
+
+    // ========================================
+    // 4. BOUNDS AND TILE BINNING
+    // ========================================
+    float minXf = std::min({sx[0], sx[1], sx[2]});
+    float maxXf = std::max({sx[0], sx[1], sx[2]});
+    float minYf = std::min({sy[0], sy[1], sy[2]});
+    float maxYf = std::max({sy[0], sy[1], sy[2]});
+    tri.minX    = std::max(0, static_cast<int>(std::floor(minXf)));
+    tri.minY    = std::max(0, static_cast<int>(std::floor(minYf)));
+    tri.maxX    = std::min(width - 1, static_cast<int>(std::ceil(maxXf)));
+    tri.maxY    = std::min(height - 1, static_cast<int>(std::ceil(maxYf)));
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY) {
+        return;
+    }
+
+    uint32_t index = static_cast<uint32_t>(triangles.size());
+    triangles.push_back(tri);
+    for (int ty = tri.minY / TileSize; ty <= tri.maxY / TileSize; ++ty) {
+        for (int tx = tri.minX / TileSize; tx <= tri.maxX / TileSize; ++tx) {
+            bins[ty * tilesX + tx].push_back(index);
+        }
+    }
+    statRasterized.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SoftwareRasterizer::RasterizeTiles() {
+    int tileCount = tilesX * tilesY;
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        nextTile.store(0, std::memory_order_relaxed);
+        poolBusy = static_cast<uint32_t>(workers.size());
+        ++poolGeneration;
+    }
+    poolWake.notify_all();
+
+    // The calling thread participates instead of idling
+    for (int tile; (tile = nextTile.fetch_add(1)) < tileCount;) {
+        RasterizeTile(tile);
+    }
+
+    std::unique_lock<std::mutex> lock(poolMutex);
+    poolDone.wait(lock, [this] { return poolBusy == 0; });
+}
+
+void SoftwareRasterizer::WorkerLoop(uint64_t seenGeneration) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            poolWake.wait(lock, [&] { return poolQuit || poolGeneration != seenGeneration; });
+            if (poolQuit) {
+                return;
+            }
+            seenGeneration = poolGeneration;
+        }
+
+        int tileCount = tilesX * tilesY;
+        for (int tile; (tile = nextTile.fetch_add(1)) < tileCount;) {
+            RasterizeTile(tile);
+        }
+
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (--poolBusy == 0) {
+            poolDone.notify_one();
+        }
+    }
+}
+
+void SoftwareRasterizer::RasterizeTile(int tileIndex) {
+    int x0 = (tileIndex % tilesX) * TileSize;
+    int y0 = (tileIndex / tilesX) * TileSize;
+    int x1 = std::min(x0 + TileSize, width) - 1;
+    int y1 = std::min(y0 + TileSize, height) - 1;
+
+    if (clearPending) {
+        for (int y = y0; y <= y1; ++y) {
+            uint32_t* row = framebuffer.data() + static_cast<size_t>(y) * stride;
+            std::fill(row + x0, row + x1 + 1, clearValue);
+        }
+    }
+
+    // Triangles are visited in submission order, so overlapping draws resolve like the GPU
+    for (uint32_t index : bins[tileIndex]) {
+        const SetupTriangle& tri = triangles[index];
+        RasterizeTriangle(tri,
+                          std::max(x0, tri.minX),
+                          std::max(y0, tri.minY),
+                          std::min(x1, tri.maxX),
+                          std::min(y1, tri.maxY));
+    }
+}
+
+void SoftwareRasterizer::RasterizeTriangle(const SetupTriangle& tri,
+                                           int x0,
+                                           int y0,
+                                           int x1,
+                                           int y1) {
+    uint64_t pixels = 0;
+    switch (rasterPath) {
+#if SOFTWARE_RASTERIZER_AVX2
+    case RasterPath::Avx2:
+        pixels = Kernels::Avx2(tri, framebuffer.data(), stride, x0, y0, x1, y1);
+        break;
+#endif
+#if SOFTWARE_RASTERIZER_SSE2
+    case RasterPath::Sse2:
+        pixels = Kernels::Sse2(tri, framebuffer.data(), stride, x0, y0, x1, y1);
+        break;
+#endif
+    default:
+        pixels = Kernels::Scalar(tri, framebuffer.data(), stride, x0, y0, x1, y1);
+        break;
+    }
+    statPixels.fetch_add(pixels, std::memory_order_relaxed);
+}
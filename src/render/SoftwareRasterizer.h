@@ -0,0 +1,163 @@
+#pragma once
+#include "RenderBackend.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Software Rasterizer Class
+// Headless RenderBackend that writes into an in-memory RGBA8 framebuffer.
+// Vertices are transformed by the view-projection like BasicVS and clipped against the near and
+// far planes. Triangles are set up once, binned into screen tiles, and the tiles are rasterized
+// in parallel (one thread per tile at a time, so output is deterministic) with SIMD edge
+// evaluation and perspective-correct color interpolation: 8 pixels at a time with AVX2 when
+// the CPU has it, else 4 with SSE2, else one. Every path produces the same pixels.
+class SoftwareRasterizer : public RenderBackend {
+  public:
+    static constexpr int TileSize = 64; // Tile edge in pixels
+
+    // Inner loop that evaluates edges and shades pixels
+    enum class RasterPath : uint8_t { Scalar, Sse2, Avx2 };
+
+    // Counters accumulated since the last ResetStats()
+    struct Stats {
+        uint64_t trianglesSubmitted  = 0; // Triangles passed to Draw/DrawInstanced
+        uint64_t trianglesRasterized = 0; // Triangles that survived culling
+        uint64_t pixelsWritten       = 0; // Covered pixels shaded
+    };
+
+    SoftwareRasterizer();
+    ~SoftwareRasterizer() override;
+
+    // RenderBackend interface
+    bool Initialize(const BackendDesc& desc) override;
+    void Clear(const float color[4]) override;
+    void SetVertexBuffer(const Vertex* vertices, uint32_t vertexCount) override;
+    void SetViewProjection(const Float4x4& matrix) override {
+        viewProjection = matrix;
+    }
+    void Draw(uint32_t vertexCount, uint32_t startVertex) override;
+    void SetInstanceBuffer(const InstanceData* instances, uint32_t instanceCount) override;
+    void DrawInstanced(uint32_t vertexCount,
+                       uint32_t instanceCount,
+                       uint32_t startVertex,
+                       uint32_t startInstance) override;
+    void Present() override;
+
+    /*
+    Set the number of threads used for tile rasterization (including the caller)
+    0 = std::thread::hardware_concurrency()
+    */
+    void SetThreadCount(uint32_t threadCount);
+    uint32_t GetThreadCount() const {
+        return static_cast<uint32_t>(workers.size()) + 1;
+    }
+
+    /*
+    Use path for the inner loop, or the best supported one below it when this build or CPU
+    lacks it (the default is the best overall). Returns the path now in use
+    */
+    RasterPath SetRasterPath(RasterPath path);
+    RasterPath GetRasterPath() const {
+        return rasterPath;
+    }
+
+    // Fastest path this build and CPU support
+    static RasterPath GetBestRasterPath();
+
+    // Every Present() also writes the frame to this path (.ppm or .png); empty disables
+    void SetDumpPath(const std::string& path) {
+        dumpPath = path;
+    }
+
+    // Rasterize all pending triangles now (Present does this implicitly)
+    void Flush();
+
+    // Write the current framebuffer; format is picked from the extension (.png or .ppm)
+    bool SaveFrame(const std::string& path);
+
+    const uint8_t* GetPixels() const {
+        return reinterpret_cast<const uint8_t*>(framebuffer.data());
+    }
+    int GetWidth() const {
+        return width;
+    }
+    int GetHeight() const {
+        return height;
+    }
+    int GetRowPitch() const {
+        return stride * 4;
+    }
+
+    Stats GetStats() const;
+    void ResetStats();
+
+  private:
+    // Vertex after the view-projection, before the perspective divide
+    struct ClipVertex {
+        float position[4]; // x, y, z, w
+        float color[4];
+    };
+
+    // Triangle after setup: edge equations and attribute planes in screen space
+    struct SetupTriangle {
+        float edgeA[3], edgeB[3], edgeC[3]; // E(x, y) = A*x + B*y + C, inside when >= 0
+        bool topLeft[3];                    // Top-left fill rule per edge
+        float plane[5][3];                  // 1/w and color/w: value = p[0]*x + p[1]*y + p[2]
+        int minX, minY, maxX, maxY;         // Pixel bounds, clamped to the render target
+    };
+
+    int width  = 0;
+    int height = 0;
+    int stride = 0; // Pixels per row, padded to a multiple of 8 for SIMD stores
+
+    std::vector<uint32_t> framebuffer; // RGBA8, one uint32_t per pixel
+    std::vector<Vertex> vertexBuffer;
+    std::vector<InstanceData> instanceBuffer;
+    std::string dumpPath;
+    RasterPath rasterPath = GetBestRasterPath();
+
+    uint32_t clearValue = 0;
+    bool clearPending   = false;
+
+    Float4x4 viewProjection      = Float4x4::Identity(); // Set by SetViewProjection
+    Float4x4 frameViewProjection = Float4x4::Identity(); // Latched by Clear, used by draws
+
+    // Binning
+    int tilesX = 0;
+    int tilesY = 0;
+    std::vector<SetupTriangle> triangles;
+    std::vector<std::vector<uint32_t>> bins; // Triangle indices per tile, in submission order
+
+    // Worker threads
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable poolWake;
+    std::condition_variable poolDone;
+    uint64_t poolGeneration = 0;
+    uint32_t poolBusy       = 0;
+    bool poolQuit           = false;
+    std::atomic<int> nextTile;
+
+    std::atomic<uint64_t> statTriangles;
+    std::atomic<uint64_t> statRasterized;
+    std::atomic<uint64_t> statPixels;
+
+    // Transform to clip space, clip against the near and far planes, then BinTriangle
+    void SetupAndBin(const Vertex& v0, const Vertex& v1, const Vertex& v2);
+    // Perspective divide, culling, edge and attribute setup, tile binning
+    void BinTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2);
+    void RasterizeTiles();
+    void RasterizeTile(int tileIndex);
+    void RasterizeTriangle(const SetupTriangle& tri, int x0, int y0, int x1, int y1);
+
+    // The inner loops, one static function per RasterPath (defined in the .cpp)
+    struct Kernels;
+
+    // seenGeneration: poolGeneration when the worker was spawned
+    void WorkerLoop(uint64_t seenGeneration);
+    void StopWorkers();
+};
@@ -0,0 +1,200 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// Upper half of a sprite's sort key: [31..24] layer | [23..20] blend | [19..0] texture
+uint32_t StateKey(const Sprite& sprite) {
+    return (static_cast<uint32_t>(sprite.layer) << 24) |
+           (static_cast<uint32_t>(sprite.blend) << 20) | (sprite.texture & 0xFFFFFu);
+}
+
+bool SameBatch(const Sprite& a, const Sprite& b) {
+    return a.texture == b.texture && a.blend == b.blend;
+}
+
+} // namespace
+
+void SpriteBatch::SetViewport(float width, float height) {
+    scaleX = width > 0.0f ? 2.0f / width : 1.0f;
+    scaleY = height > 0.0f ? 2.0f / height : 1.0f;
+}
+
+void SpriteBatch::Reserve(uint32_t spriteCount) {
+    sprites.reserve(spriteCount);
+    keys.reserve(spriteCount);
+    scratch.reserve(spriteCount);
+    order.reserve(spriteCount);
+}
+
+// ========================================
+// 1. SORT
+// ========================================
+
+void SpriteBatch::Sort() {
+    const uint32_t count = static_cast<uint32_t>(sprites.size());
+    order.resize(count);
+    if (sortMode == SortMode::Submission) {
+        for (uint32_t i = 0; i < count; ++i) {
+            order[i] = i;
+        }
+        return;
+    }
+
+    // The low half of every key is the submission index, so keys start out in order and an
+    // LSD radix sort over the high half alone is stable. Bytes every key shares (usually
+    // layer and blend) are skipped, so one texture and one blend mode cost no pass at all
+    keys.resize(count);
+    scratch.resize(count);
+    uint32_t allOnes = 0xFFFFFFFFu;
+    uint32_t anyOnes = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t state = StateKey(sprites[i]);
+        keys[i]              = (static_cast<uint64_t>(state) << 32) | i;
+        allOnes &= state;
+        anyOnes |= state;
+    }
+
+    const uint32_t varying = allOnes ^ anyOnes;
+    for (uint32_t shift = 32; shift < 64; shift += 8) {
+        if (((varying >> (shift - 32)) & 0xFFu) == 0) {
+            continue;
+        }
+        uint32_t offsets[256] = {};
+        for (uint64_t key : keys) {
+            ++offsets[(key >> shift) & 0xFF];
+        }
+        uint32_t sum = 0;
+        for (uint32_t& offset : offsets) {
+            const uint32_t bucket = offset;
+            offset                = sum;
+            sum += bucket;
+        }
+        for (uint64_t key : keys) {
+            scratch[offsets[(key >> shift) & 0xFF]++] = key;
+        }
+        keys.swap(scratch);
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        order[i] = static_cast<uint32_t>(keys[i]);
+    }
+}
+
+// ========================================
+// 2. WRITE AND DRAW
+// ========================================
+
+SpriteBatch::Stats SpriteBatch::End(Target& target) {
+    stats         = Stats();
+    stats.sprites = static_cast<uint32_t>(sprites.size());
+    Sort();
+
+    for (uint32_t chunkBegin = 0; chunkBegin < stats.sprites; chunkBegin += MaxQuadsPerDraw) {
+        const uint32_t chunkSize = std::min(MaxQuadsPerDraw, stats.sprites - chunkBegin);
+        const uint32_t* chunk    = order.data() + chunkBegin;
+
+        // Every vertex of the chunk is written before its first draw: the target may have to
+        // unmap the memory to draw from it
+        SpriteVertex* vertices = target.BeginChunk(chunkSize);
+        ++stats.chunks;
+        if (!vertices) {
+            stats.dropped += chunkSize;
+            continue;
+        }
+        const uint32_t taskCount = (chunkSize + TaskSize - 1) / TaskSize;
+        if (parallelFor && taskCount > 1) {
+            parallelFor(taskCount, [&](uint32_t task) {
+                const uint32_t begin = task * TaskSize;
+                const uint32_t end   = std::min(chunkSize, begin + TaskSize);
+                WriteVertices(sprites.data(),
+                              chunk + begin,
+                              end - begin,
+                              scaleX,
+                              scaleY,
+                              vertices + begin * 4);
+            });
+        } else {
+            WriteVertices(sprites.data(), chunk, chunkSize, scaleX, scaleY, vertices);
+        }
+
+        // One draw per run of equal texture and blend mode
+        uint32_t runBegin = 0;
+        for (uint32_t i = 1; i <= chunkSize; ++i) {
+            if (i < chunkSize && SameBatch(sprites[chunk[i]], sprites[chunk[runBegin]])) {
+                continue;
+            }
+            const Sprite& first = sprites[chunk[runBegin]];
+            target.DrawQuads(first.texture, first.blend, runBegin, i - runBegin);
+            ++stats.draws;
+            runBegin = i;
+        }
+    }
+
+    sprites.clear();
+    return stats;
+}
+
+void SpriteBatch::WriteIndices(uint16_t* indices, uint32_t quadCount) {
+    // Corners are top-left, top-right, bottom-left, bottom-right: both triangles wind
+    // clockwise on screen
+    for (uint32_t quad = 0; quad < quadCount; ++quad) {
+        const uint16_t base = static_cast<uint16_t>(quad * 4);
+        indices[0]          = base;
+        indices[1]          = static_cast<uint16_t>(base + 1);
+        indices[2]          = static_cast<uint16_t>(base + 2);
+        indices[3]          = static_cast<uint16_t>(base + 2);
+        indices[4]          = static_cast<uint16_t>(base + 1);
+        indices[5]          = static_cast<uint16_t>(base + 3);
+        indices += IndicesPerQuad;
+    }
+}
+
+void SpriteBatch::WriteVertices(const Sprite* sprites,
+                                const uint32_t* order,
+                                uint32_t count,
+                                float scaleX,
+                                float scaleY,
+                                SpriteVertex* destination) {
+    // Corners are built in a local array and copied out whole: the destination is usually
+    // write-combined GPU memory, which must only ever be written sequentially
+    for (uint32_t i = 0; i < count; ++i) {
+        const Sprite& sprite = sprites[order[i]];
+        const float halfW    = sprite.width * 0.5f;
+        const float halfH    = sprite.height * 0.5f;
+
+        // Half extents along the sprite's rotated x and y axes, in pixels (y down)
+        float axisX[2] = {halfW, 0.0f};
+        float axisY[2] = {0.0f, halfH};
+        if (sprite.rotation != 0.0f) {
+            const float c = std::cos(sprite.rotation);
+            const float s = std::sin(sprite.rotation);
+            axisX[0]      = halfW * c;
+            axisX[1]      = halfW * s;
+            axisY[0]      = -halfH * s;
+            axisY[1]      = halfH * c;
+        }
+
+        // Pixels to clip space: x' = x * 2 / width - 1, y' = 1 - y * 2 / height
+        const float centerX = sprite.x * scaleX - 1.0f;
+        const float centerY = 1.0f - sprite.y * scaleY;
+        const float ax      = axisX[0] * scaleX;
+        const float ay      = -axisX[1] * scaleY;
+        const float bx      = axisY[0] * scaleX;
+        const float by      = -axisY[1] * scaleY;
+
+        UNorm8x4 color;
+        memcpy(color.v, &sprite.color, sizeof(color.v));
+        const SpriteRegion& uv = sprite.region;
+
+        const SpriteVertex corners[4] = {
+            {{centerX - ax - bx, centerY - ay - by}, {uv.u0, uv.v0}, color},
+            {{centerX + ax - bx, centerY + ay - by}, {uv.u1, uv.v0}, color},
+            {{centerX - ax + bx, centerY - ay + by}, {uv.u0, uv.v1}, color},
+            {{centerX + ax + bx, centerY + ay + by}, {uv.u1, uv.v1}, color},
+        };
+        memcpy(destination + i * 4, corners, sizeof(corners));
+    }
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include "VertexFormat.h"
+#include "threading/ParallelFor.h"
+#include <cstdint>
+#include <vector>
+
+// How a sprite's color is combined with the render target
+enum class SpriteBlend : uint8_t {
+    Alpha = 0, // Straight alpha: src * a + dst * (1 - a)
+    Additive,  // src * a + dst
+    Opaque,    // src; alpha is ignored
+};
+constexpr uint32_t SpriteBlendCount = 3;
+
+// Sprite Vertex
+// One corner of a queued quad, already transformed to clip space
+struct SpriteVertex {
+    float position[2]; // Clip space
+    float uv[2];       // Texture coordinates
+    UNorm8x4 color;    // RGBA8 tint
+};
+
+template <>
+struct VertexLayout<SpriteVertex> {
+    static constexpr VertexElement Elements[] = {
+        VERTEX_ELEMENT(SpriteVertex, position, "POSITION", 0),
+        VERTEX_ELEMENT(SpriteVertex, uv, "TEXCOORD", 0),
+        VERTEX_ELEMENT(SpriteVertex, color, "COLOR", 0)};
+};
+
+// Part of a texture a sprite shows, in normalized texture coordinates
+struct SpriteRegion {
+    float u0 = 0.0f;
+    float v0 = 0.0f;
+    float u1 = 1.0f;
+    float v1 = 1.0f;
+};
+
+// Sprite
+// One screen-space quad queued on a SpriteBatch
+struct Sprite {
+    float x        = 0.0f; // Center, in pixels from the top-left corner of the viewport
+    float y        = 0.0f;
+    float width    = 0.0f; // Size in pixels; negative mirrors the region
+    float height   = 0.0f;
+    float rotation = 0.0f; // Radians about the center, clockwise on screen
+    SpriteRegion region;
+    uint32_t color    = 0xFFFFFFFFu; // RGBA8 multiplier, red in the low byte
+    uint32_t texture  = 0;           // Renderer texture handle, below SpriteBatch::MaxTextures
+    SpriteBlend blend = SpriteBlend::Alpha;
+    uint8_t layer     = 0; // Lower layers are drawn first in every sort mode
+};
+
+// Sprite Batch Class
+// Collects sprites for a frame and turns them into as few draws as possible. Vertices are
+// written straight into memory the Target hands out (a mapped dynamic buffer), in chunks of
+// at most MaxQuadsPerDraw quads, so every draw can use one shared static 16-bit index buffer
+// of the pattern WriteIndices produces. Within a chunk, consecutive sprites with the same
+// texture and blend mode become a single indexed draw.
+//
+// SortMode::Texture stably radix-sorts the sprites by (layer, blend, texture) first, which
+// turns interleaved submissions into one run per texture and blend mode per layer; the
+// order within a run is kept, so overlapping sprites of one texture still draw in order.
+// Everything up to the Target is API independent.
+class SpriteBatch {
+  public:
+    // 65536 vertices: the most one draw can address with 16-bit indices
+    static constexpr uint32_t MaxQuadsPerDraw = 16384;
+    static constexpr uint32_t IndicesPerQuad  = 6;
+    static constexpr uint32_t MaxTextures     = 1u << 20; // Handles fit the sort key
+
+    // Quads per parallel vertex-writing task; smaller chunks are written on the calling thread
+    static constexpr uint32_t TaskSize = 4096;
+
+    enum class SortMode : uint8_t {
+        Submission, // Draw in the order sprites were queued; batches break on every change
+        Texture,    // Group by layer, blend and texture (stable)
+    };
+
+    // Backend hook that owns the vertex memory and issues the draws
+    class Target {
+      public:
+        virtual ~Target() = default;
+
+        /*
+        Memory for quadCount * 4 vertices (quadCount <= MaxQuadsPerDraw), written once front
+        to back before the chunk's first DrawQuads; nullptr drops the chunk
+        */
+        virtual SpriteVertex* BeginChunk(uint32_t quadCount) = 0;
+
+        // Draw quads [firstQuad, firstQuad + quadCount) of the current chunk
+        virtual void DrawQuads(uint32_t texture,
+                               SpriteBlend blend,
+                               uint32_t firstQuad,
+                               uint32_t quadCount) = 0;
+    };
+
+    // Counters for the last End()
+    struct Stats {
+        uint32_t sprites = 0;
+        uint32_t chunks  = 0; // Target::BeginChunk calls
+        uint32_t draws   = 0; // Target::DrawQuads calls
+        uint32_t dropped = 0; // Sprites in chunks the target had no memory for
+    };
+
+    // Size of the viewport sprite coordinates are given in, in pixels
+    void SetViewport(float width, float height);
+
+    void SetSortMode(SortMode mode) {
+        sortMode = mode;
+    }
+
+    // Pre-size storage so Draw never reallocates during the frame
+    void Reserve(uint32_t spriteCount);
+
+    // Queue sprites for the next End
+    void Draw(const Sprite& sprite) {
+        sprites.push_back(sprite);
+    }
+    void Draw(const Sprite* first, uint32_t count) {
+        sprites.insert(sprites.end(), first, first + count);
+    }
+
+    // Write and draw every queued sprite through target, then empty the batch
+    Stats End(Target& target);
+
+    // Install a parallel executor for vertex writing (default: serial)
+    void SetParallelFor(ParallelFor executor) {
+        parallelFor = std::move(executor);
+    }
+
+    uint32_t GetSpriteCount() const {
+        return static_cast<uint32_t>(sprites.size());
+    }
+    const Stats& GetStats() const {
+        return stats;
+    }
+
+    // Index pattern of the shared index buffer: quad q is (0, 1, 2, 2, 1, 3) + 4 * q
+    static void WriteIndices(uint16_t* indices, uint32_t quadCount);
+
+    /*
+    Write 4 vertices per sprite for sprites[order[i]], i in [0, count)
+    scaleX, scaleY: 2 / viewport size, mapping pixels to clip space
+    */
+    static void WriteVertices(const Sprite* sprites,
+                              const uint32_t* order,
+                              uint32_t count,
+                              float scaleX,
+                              float scaleY,
+                              SpriteVertex* destination);
+
+  private:
+    std::vector<Sprite> sprites;
+    std::vector<uint64_t> keys;    // (layer | blend | texture) << 32 | submission index
+    std::vector<uint64_t> scratch; // Radix sort ping-pong buffer
+    std::vector<uint32_t> order;   // Sprite indices in draw order
+
+    SortMode sortMode = SortMode::Texture;
+    float scaleX      = 1.0f;
+    float scaleY      = 1.0f;
+    ParallelFor parallelFor;
+    Stats stats;
+
+    // Fill order, sorted by key if sortMode asks for it
+    void Sort();
+};
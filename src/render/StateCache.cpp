@@ -0,0 +1,222 @@
+#include "StateCache.h"
+
+StateCache::StateCache(ContextSink& contextSink) : sink(contextSink) {}
+
+void StateCache::Invalidate() {
+    validBits = 0;
+}
+
+void StateCache::BeginFrame() {
+    stats = Stats();
+}
+
+bool StateCache::Changed(uint32_t bit, bool same) {
+    if ((validBits & bit) && same) {
+        ++stats.elided;
+        return false;
+    }
+    validBits |= bit;
+    ++stats.issued;
+    return true;
+}
+
+// ========================================
+// IA STAGE
+// ========================================
+
+void StateCache::SetInputLayout(void* layout) {
+    if (Changed(BitInputLayout, shadow.inputLayout == layout)) {
+        shadow.inputLayout = layout;
+        sink.SetInputLayout(layout);
+    }
+}
+
+void StateCache::SetPrimitiveTopology(uint32_t topology) {
+    if (Changed(BitTopology, shadow.topology == topology)) {
+        shadow.topology = topology;
+        sink.SetPrimitiveTopology(topology);
+    }
+}
+
+void StateCache::SetVertexBuffer(uint32_t slot, void* buffer, uint32_t stride, uint32_t offset) {
+    if (slot >= MaxVertexBuffers) {
+        ++stats.issued;
+        sink.SetVertexBuffer(slot, buffer, stride, offset);
+        return;
+    }
+    VertexBufferBinding& binding = shadow.vertexBuffers[slot];
+
+    bool same = binding.buffer == buffer && binding.stride == stride && binding.offset == offset;
+    if (Changed(BitVertexBuffer << slot, same)) {
+        binding.buffer = buffer;
+        binding.stride = stride;
+        binding.offset = offset;
+        sink.SetVertexBuffer(slot, buffer, stride, offset);
+    }
+}
+
+void StateCache::SetIndexBuffer(void* buffer, uint32_t format, uint32_t offset) {
+    bool same = shadow.indexBuffer == buffer && shadow.indexFormat == format &&
+                shadow.indexOffset == offset;
+    if (Changed(BitIndexBuffer, same)) {
+        shadow.indexBuffer = buffer;
+        shadow.indexFormat = format;
+        shadow.indexOffset = offset;
+        sink.SetIndexBuffer(buffer, format, offset);
+    }
+}
+
+// ========================================
+// SHADER STAGES
+// ========================================
+
+void StateCache::SetVertexShader(void* shader) {
+    if (Changed(BitVertexShader, shadow.vertexShader == shader)) {
+        shadow.vertexShader = shader;
+        sink.SetVertexShader(shader);
+    }
+}
+
+void StateCache::SetPixelShader(void* shader) {
+    if (Changed(BitPixelShader, shadow.pixelShader == shader)) {
+        shadow.pixelShader = shader;
+        sink.SetPixelShader(shader);
+    }
+}
+
+void StateCache::SetPixelShaderResource(uint32_t slot, void* resource) {
+    if (slot >= MaxPixelSlots) {
+        ++stats.issued;
+        sink.SetPixelShaderResource(slot, resource);
+        return;
+    }
+    if (Changed(BitPixelResource << slot, shadow.pixelResources[slot] == resource)) {
+        shadow.pixelResources[slot] = resource;
+        sink.SetPixelShaderResource(slot, resource);
+    }
+}
+
+void StateCache::SetPixelSampler(uint32_t slot, void* sampler) {
+    if (slot >= MaxPixelSlots) {
+        ++stats.issued;
+        sink.SetPixelSampler(slot, sampler);
+        return;
+    }
+    if (Changed(BitPixelSampler << slot, shadow.pixelSamplers[slot] == sampler)) {
+        shadow.pixelSamplers[slot] = sampler;
+        sink.SetPixelSampler(slot, sampler);
+    }
+}
+
+void StateCache::SetVertexConstantBuffer(uint32_t slot,
+                                         void* buffer,
+                                         uint32_t firstConstant,
+                                         uint32_t constantCount) {
+    if (slot >= MaxConstantSlots) {
+        ++stats.issued;
+        sink.SetVertexConstantBuffer(slot, buffer, firstConstant, constantCount);
+        return;
+    }
+
+    // Objects in one page differ only by firstConstant, which still has to be forwarded
+    ConstantBufferBinding& binding = shadow.vertexConstants[slot];
+
+    const bool same = binding.buffer == buffer && binding.firstConstant == firstConstant &&
+                      binding.constantCount == constantCount;
+    if (Changed(BitVertexConstants << slot, same)) {
+        binding.buffer        = buffer;
+        binding.firstConstant = firstConstant;
+        binding.constantCount = constantCount;
+        sink.SetVertexConstantBuffer(slot, buffer, firstConstant, constantCount);
+    }
+}
+
+// ========================================
+// RS AND OM STAGES
+// ========================================
+
+void StateCache::SetRasterizerState(void* state) {
+    if (Changed(BitRasterizer, shadow.rasterizer == state)) {
+        shadow.rasterizer = state;
+        sink.SetRasterizerState(state);
+    }
+}
+
+void StateCache::SetViewport(float x, float y, float width, float height) {
+    bool same = shadow.viewport[0] == x && shadow.viewport[1] == y &&
+                shadow.viewport[2] == width && shadow.viewport[3] == height;
+    if (Changed(BitViewport, same)) {
+        shadow.viewport[0] = x;
+        shadow.viewport[1] = y;
+        shadow.viewport[2] = width;
+        shadow.viewport[3] = height;
+        sink.SetViewport(x, y, width, height);
+    }
+}
+
+void StateCache::SetDepthStencilState(void* state, uint32_t stencilRef) {
+    bool same = shadow.depthStencil == state && shadow.stencilRef == stencilRef;
+    if (Changed(BitDepthStencil, same)) {
+        shadow.depthStencil = state;
+        shadow.stencilRef   = stencilRef;
+        sink.SetDepthStencilState(state, stencilRef);
+    }
+}
+
+void StateCache::SetBlendState(void* state, const float blendFactor[4], uint32_t mask) {
+    static const float defaultFactor[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    const float* factor                 = blendFactor ? blendFactor : defaultFactor;
+
+    bool same = shadow.blend == state && shadow.sampleMask == mask;
+    for (int i = 0; i < 4 && same; ++i) {
+        same = shadow.blendFactor[i] == factor[i];
+    }
+    if (Changed(BitBlend, same)) {
+        shadow.blend      = state;
+        shadow.sampleMask = mask;
+        for (int i = 0; i < 4; ++i) {
+            shadow.blendFactor[i] = factor[i];
+        }
+        sink.SetBlendState(state, blendFactor, mask);
+    }
+}
+
+void StateCache::SetRenderTarget(void* renderTarget, void* depthStencil) {
+    bool same = shadow.renderTarget == renderTarget && shadow.depthTarget == depthStencil;
+    if (Changed(BitRenderTarget, same)) {
+        shadow.renderTarget = renderTarget;
+        shadow.depthTarget  = depthStencil;
+        sink.SetRenderTarget(renderTarget, depthStencil);
+    }
+}
+
+// ========================================
+// DRAW COMMANDS (ALWAYS FORWARDED)
+// ========================================
+
+void StateCache::Draw(uint32_t vertexCount, uint32_t startVertex) {
+    ++stats.draws;
+    sink.Draw(vertexCount, startVertex);
+}
+
+void StateCache::DrawInstanced(uint32_t vertexCount,
+                               uint32_t instanceCount,
+                               uint32_t startVertex,
+                               uint32_t startInstance) {
+    ++stats.draws;
+    sink.DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+}
+
+void StateCache::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) {
+    ++stats.draws;
+    sink.DrawIndexed(indexCount, startIndex, baseVertex);
+}
+
+void StateCache::DrawIndexedInstanced(uint32_t indexCount,
+                                      uint32_t instanceCount,
+                                      uint32_t startIndex,
+                                      int32_t baseVertex,
+                                      uint32_t startInstance) {
+    ++stats.draws;
+    sink.DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
@@ -0,0 +1,181 @@
+#pragma once
+#include <cstdint>
+
+// Context Sink Interface
+// The subset of a device context that StateCache forwards to. Objects are passed as opaque
+// pointers so the cache compiles without any graphics API headers; D3D11ContextSink casts
+// them back to the D3D11 interfaces, and a recording mock can simply log them.
+class ContextSink {
+  public:
+    virtual ~ContextSink() = default;
+
+    // IA stage
+    virtual void SetInputLayout(void* layout)                                   = 0;
+    virtual void SetPrimitiveTopology(uint32_t topology)                        = 0;
+    virtual void SetIndexBuffer(void* buffer, uint32_t format, uint32_t offset) = 0;
+    virtual void SetVertexBuffer(uint32_t slot,
+                                 void* buffer,
+                                 uint32_t stride,
+                                 uint32_t offset) = 0;
+
+    // Shader stages
+    virtual void SetVertexShader(void* shader)                         = 0;
+    virtual void SetPixelShader(void* shader)                          = 0;
+    virtual void SetPixelShaderResource(uint32_t slot, void* resource) = 0;
+    virtual void SetPixelSampler(uint32_t slot, void* sampler)         = 0;
+
+    // Window [firstConstant, firstConstant + constantCount) of a constant buffer, in 16-byte
+    // constants (Direct3D 11.1 VSSetConstantBuffers1)
+    virtual void SetVertexConstantBuffer(uint32_t slot,
+                                         void* buffer,
+                                         uint32_t firstConstant,
+                                         uint32_t constantCount) = 0;
+
+    // RS and OM stages
+    virtual void SetRasterizerState(void* state)                                       = 0;
+    virtual void SetViewport(float x, float y, float width, float height)              = 0;
+    virtual void SetDepthStencilState(void* state, uint32_t stencilRef)                = 0;
+    virtual void SetBlendState(void* state, const float blendFactor[4], uint32_t mask) = 0;
+    virtual void SetRenderTarget(void* renderTarget, void* depthStencil)               = 0;
+
+    // Draw commands are always forwarded
+    virtual void Draw(uint32_t vertexCount, uint32_t startVertex)                          = 0;
+    virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) = 0;
+    virtual void DrawInstanced(uint32_t vertexCount,
+                               uint32_t instanceCount,
+                               uint32_t startVertex,
+                               uint32_t startInstance) = 0;
+    virtual void DrawIndexedInstanced(uint32_t indexCount,
+                                      uint32_t instanceCount,
+                                      uint32_t startIndex,
+                                      int32_t baseVertex,
+                                      uint32_t startInstance) = 0;
+};
+
+// State Cache Class
+// Shadows the IA/VS/PS/RS/OM state bound through it and drops calls that would not change
+// anything. Counts issued versus elided calls per frame.
+class StateCache {
+  public:
+    static constexpr uint32_t MaxVertexBuffers = 4;
+    static constexpr uint32_t MaxPixelSlots    = 4; // Shadowed SRV and sampler slots each
+    static constexpr uint32_t MaxConstantSlots = 4; // Shadowed vertex constant buffer slots
+
+    // Per-frame counters (reset by BeginFrame)
+    struct Stats {
+        uint32_t issued = 0; // State calls forwarded to the sink
+        uint32_t elided = 0; // State calls dropped as redundant
+        uint32_t draws  = 0; // Draw calls forwarded
+    };
+
+    explicit StateCache(ContextSink& sink);
+
+    // Forget the shadow state; the next call of every kind is forwarded.
+    // Use after anything that changes bindings behind the cache's back (ClearState, Present
+    // in flip model, command list execution).
+    void Invalidate();
+
+    // Reset per-frame counters
+    void BeginFrame();
+
+    void SetInputLayout(void* layout);
+    void SetPrimitiveTopology(uint32_t topology);
+    void SetVertexBuffer(uint32_t slot, void* buffer, uint32_t stride, uint32_t offset);
+    void SetIndexBuffer(void* buffer, uint32_t format, uint32_t offset);
+    void SetVertexShader(void* shader);
+    void SetPixelShader(void* shader);
+    void SetPixelShaderResource(uint32_t slot, void* resource);
+    void SetPixelSampler(uint32_t slot, void* sampler);
+    void SetVertexConstantBuffer(uint32_t slot,
+                                 void* buffer,
+                                 uint32_t firstConstant,
+                                 uint32_t constantCount);
+    void SetRasterizerState(void* state);
+    void SetViewport(float x, float y, float width, float height);
+    void SetDepthStencilState(void* state, uint32_t stencilRef);
+    void SetBlendState(void* state, const float blendFactor[4], uint32_t mask);
+    void SetRenderTarget(void* renderTarget, void* depthStencil);
+
+    void Draw(uint32_t vertexCount, uint32_t startVertex);
+    void DrawInstanced(uint32_t vertexCount,
+                       uint32_t instanceCount,
+                       uint32_t startVertex,
+                       uint32_t startInstance);
+    void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex);
+    void DrawIndexedInstanced(uint32_t indexCount,
+                              uint32_t instanceCount,
+                              uint32_t startIndex,
+                              int32_t baseVertex,
+                              uint32_t startInstance);
+
+    const Stats& GetStats() const {
+        return stats;
+    }
+    ContextSink& GetSink() {
+        return sink;
+    }
+
+  private:
+    struct VertexBufferBinding {
+        void* buffer    = nullptr;
+        uint32_t stride = 0;
+        uint32_t offset = 0;
+    };
+
+    struct ConstantBufferBinding {
+        void* buffer           = nullptr;
+        uint32_t firstConstant = 0;
+        uint32_t constantCount = 0;
+    };
+
+    // Shadow copy of everything bound through the cache; "valid" flags mark unknown state
+    struct Shadow {
+        void* inputLayout = nullptr;
+        uint32_t topology = 0;
+        VertexBufferBinding vertexBuffers[MaxVertexBuffers];
+        ConstantBufferBinding vertexConstants[MaxConstantSlots];
+        void* indexBuffer                   = nullptr;
+        uint32_t indexFormat                = 0;
+        uint32_t indexOffset                = 0;
+        void* vertexShader                  = nullptr;
+        void* pixelShader                   = nullptr;
+        void* pixelResources[MaxPixelSlots] = {};
+        void* pixelSamplers[MaxPixelSlots]  = {};
+        void* rasterizer                    = nullptr;
+        float viewport[4]                   = {};
+        void* depthStencil                  = nullptr;
+        uint32_t stencilRef                 = 0;
+        void* blend                         = nullptr;
+        float blendFactor[4]                = {};
+        uint32_t sampleMask                 = 0;
+        void* renderTarget                  = nullptr;
+        void* depthTarget                   = nullptr;
+    };
+
+    enum StateBit : uint32_t {
+        BitInputLayout     = 1u << 0,
+        BitTopology        = 1u << 1,
+        BitIndexBuffer     = 1u << 2,
+        BitVertexShader    = 1u << 3,
+        BitPixelShader     = 1u << 4,
+        BitRasterizer      = 1u << 5,
+        BitViewport        = 1u << 6,
+        BitDepthStencil    = 1u << 7,
+        BitBlend           = 1u << 8,
+        BitRenderTarget    = 1u << 9,
+        BitVertexBuffer    = 1u << 10, // + slot
+        BitPixelResource   = 1u << 14, // + slot
+        BitPixelSampler    = 1u << 18, // + slot
+        BitVertexConstants = 1u << 22, // + slot
+    };
+    static_assert(MaxVertexBuffers <= 4 && MaxPixelSlots <= 4 && MaxConstantSlots <= 4,
+                  "Slot bits would overlap");
+
+    ContextSink& sink;
+    Shadow shadow;
+    uint32_t validBits = 0; // Which shadow entries reflect real context state
+    Stats stats;
+
+    // True when the call must be forwarded; updates the valid bit and counters
+    bool Changed(uint32_t bit, bool same);
+};
@@ -0,0 +1,127 @@
+#include "StateObjectCache.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Slot layout: hash bits 16-63 tag the entry, bits 0-15 hold handle + 1 (0 = empty)
+constexpr uint64_t TagMask = ~uint64_t(0xFFFF);
+
+} // namespace
+
+StateObjectCache::StateObjectCache(size_t descSize, uint32_t capacity)
+    : descSize(descSize),
+      descStride((descSize + 7) & ~size_t(7)),
+      capacity(std::min(std::max(capacity, 1u), MaxCapacity)) {
+    uint32_t slotCount = 16;
+    while (slotCount < this->capacity * 2) {
+        slotCount *= 2;
+    }
+    slotMask = slotCount - 1;
+    slots.reset(new std::atomic<uint64_t>[slotCount]);
+    for (uint32_t i = 0; i < slotCount; ++i) {
+        slots[i].store(0, std::memory_order_relaxed);
+    }
+    descs.reset(new uint8_t[descStride * this->capacity]);
+    objects.reset(new void*[this->capacity]);
+}
+
+uint64_t StateObjectCache::Hash(const void* data, size_t size) {
+    // FNV-style multiply per 8-byte word, then the splitmix64 finalizer: the slot index
+    // comes from the low bits, which the multiply alone leaves poorly mixed
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash        = 0xCBF29CE484222325ull ^ size;
+    size_t offset        = 0;
+    for (; offset + 8 <= size; offset += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + offset, 8);
+        hash = (hash ^ word) * 0x100000001B3ull;
+    }
+    if (offset < size) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + offset, size - offset);
+        hash = (hash ^ word) * 0x100000001B3ull;
+    }
+    hash ^= hash >> 30;
+    hash *= 0xBF58476D1CE4E5B9ull;
+    hash ^= hash >> 27;
+    hash *= 0x94D049BB133111EBull;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+uint16_t StateObjectCache::Probe(const void* desc, uint64_t hash, uint32_t& slot) const {
+    slot = static_cast<uint32_t>(hash) & slotMask;
+    for (;;) {
+        const uint64_t value = slots[slot].load(std::memory_order_acquire);
+        if (value == 0) {
+            return InvalidHandle;
+        }
+        const uint16_t handle = static_cast<uint16_t>((value & 0xFFFF) - 1);
+        if (((value ^ hash) & TagMask) == 0 &&
+            std::memcmp(GetDesc(handle), desc, descSize) == 0) {
+            return handle;
+        }
+        slot = (slot + 1) & slotMask;
+    }
+}
+
+uint16_t StateObjectCache::Find(const void* desc) const {
+    uint32_t slot;
+    return Probe(desc, Hash(desc, descSize), slot);
+}
+
+uint16_t StateObjectCache::Acquire(const void* desc, const CreateFunction& create) {
+    const uint64_t hash = Hash(desc, descSize);
+    uint32_t slot;
+    uint16_t handle = Probe(desc, hash, slot);
+    if (handle != InvalidHandle) {
+        return handle;
+    }
+
+    // Another thread may have inserted it since; slot is the empty end of the chain after
+    // the second probe, and only inserts (all under the lock) fill empty slots
+    std::lock_guard<std::mutex> lock(insertMutex);
+    handle = Probe(desc, hash, slot);
+    if (handle != InvalidHandle) {
+        return handle;
+    }
+    const uint32_t index = count.load(std::memory_order_relaxed);
+    if (index >= capacity) {
+        ++failures;
+        return InvalidHandle;
+    }
+
+    uint8_t* stored = descs.get() + size_t(index) * descStride;
+    std::memcpy(stored, desc, descSize);
+    void* object = nullptr;
+    if (create) {
+        object = create(stored);
+        if (!object) {
+            ++failures;
+            return InvalidHandle;
+        }
+    }
+    objects[index] = object;
+
+    slots[slot].store((hash & TagMask) | (index + 1), std::memory_order_release);
+    count.store(index + 1, std::memory_order_release);
+    return static_cast<uint16_t>(index);
+}
+
+void StateObjectCache::Clear() {
+    std::lock_guard<std::mutex> lock(insertMutex);
+    for (uint32_t i = 0; i <= slotMask; ++i) {
+        slots[i].store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_release);
+    failures = 0;
+}
+
+StateObjectCache::Stats StateObjectCache::GetStats() const {
+    std::lock_guard<std::mutex> lock(insertMutex);
+    Stats stats;
+    stats.entries  = count.load(std::memory_order_relaxed);
+    stats.failures = failures;
+    return stats;
+}
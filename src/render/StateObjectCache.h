@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+// State Object Cache Class
+// Deduplicates fixed-size descriptors (e.g. a D3D11_BLEND_DESC) into 16-bit handles, each
+// paired with the object created for it on first sight. Descriptors compare bytewise, so
+// callers zero their padding and unused fields before asking; handles are dense and stay
+// valid until Clear, which makes them cheap to store and compare in sort keys.
+//
+// Lookups are lock-free: an open-addressing table of 64-bit slots, each holding the upper
+// bits of the descriptor's hash and its handle + 1. Inserts take a mutex and publish the
+// descriptor and object before the slot, so a thread that finds a slot sees both.
+class StateObjectCache {
+  public:
+    static constexpr uint16_t InvalidHandle = 0xFFFF;
+    static constexpr uint32_t MaxCapacity   = 4096; // Direct3D 11's unique objects per kind
+
+    // Creates the object for a descriptor seen for the first time; nullptr on failure
+    using CreateFunction = std::function<void*(const void* desc)>;
+
+    struct Stats {
+        uint32_t entries  = 0;
+        uint32_t failures = 0; // Acquires refused: cache full or creation failed
+    };
+
+    /*
+    descSize: Bytes per descriptor
+    capacity: Largest number of entries, at most MaxCapacity
+    */
+    explicit StateObjectCache(size_t descSize, uint32_t capacity = MaxCapacity);
+
+    StateObjectCache(const StateObjectCache&)            = delete;
+    StateObjectCache& operator=(const StateObjectCache&) = delete;
+
+    // Handle of a descriptor already in the cache, or InvalidHandle; never blocks
+    uint16_t Find(const void* desc) const;
+
+    /*
+    Handle of a descriptor, adding it on first sight with the object create returns
+    create: May be empty for entries without an object; runs under the insert lock
+    Returns InvalidHandle when the cache is full or create fails
+    */
+    uint16_t Acquire(const void* desc, const CreateFunction& create);
+
+    // Forget every entry; not safe against concurrent calls (release the objects first)
+    void Clear();
+
+    void* GetObject(uint16_t handle) const {
+        return objects[handle];
+    }
+    const void* GetDesc(uint16_t handle) const {
+        return descs.get() + size_t(handle) * descStride;
+    }
+    size_t GetDescSize() const {
+        return descSize;
+    }
+
+    // Handles are below this
+    uint32_t GetCount() const {
+        return count.load(std::memory_order_acquire);
+    }
+
+    Stats GetStats() const;
+
+    // 64-bit hash of a byte range, read a word at a time
+    static uint64_t Hash(const void* data, size_t size);
+
+  private:
+    size_t descSize;
+    size_t descStride; // descSize rounded up to 8, so descriptors stay aligned
+    uint32_t capacity;
+    uint32_t slotMask; // Slot count - 1; at least twice the capacity
+    std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    std::unique_ptr<uint8_t[]> descs;
+    std::unique_ptr<void*[]> objects;
+    std::atomic<uint32_t> count{0};
+    uint32_t failures = 0;
+    mutable std::mutex insertMutex;
+
+    // Probe from the hash's home slot; the handle found, or the empty slot ending the chain
+    uint16_t Probe(const void* desc, uint64_t hash, uint32_t& slot) const;
+};
@@ -0,0 +1,246 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <numeric>
+
+// ========================================
+// 1. SKYLINE PACKER
+// ========================================
+
+void AtlasPacker::Reset(uint32_t width, uint32_t height) {
+    binWidth  = width;
+    binHeight = height;
+    usedArea  = 0;
+    skyline.clear();
+    skyline.push_back({0, 0, width});
+}
+
+bool AtlasPacker::Fit(size_t index, uint32_t width, uint32_t height, uint32_t& y) const {
+    const uint32_t x = skyline[index].x;
+    if (x + width > binWidth) {
+        return false;
+    }
+    // Rest on the highest segment the rectangle spans
+    y                  = 0;
+    uint32_t remaining = width;
+    for (size_t i = index; remaining > 0; ++i) {
+        y = std::max(y, skyline[i].y);
+        if (y + height > binHeight) {
+            return false;
+        }
+        remaining -= std::min(remaining, skyline[i].width);
+    }
+    return true;
+}
+
+bool AtlasPacker::Insert(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y) {
+    if (width == 0 || height == 0) {
+        x = 0;
+        y = 0;
+        return true;
+    }
+
+    // ========================================
+    // 1.1 FIND THE LOWEST POSITION
+    // ========================================
+    // Lowest top edge wins; ties go to the narrower segment, which leaves wide ones for
+    // wide rectangles
+    size_t best        = skyline.size();
+    uint32_t bestTop   = UINT32_MAX;
+    uint32_t bestWidth = UINT32_MAX;
+    uint32_t bestY     = 0;
+    for (size_t i = 0; i < skyline.size(); ++i) {
+        uint32_t top = 0;
+        if (!Fit(i, width, height, top)) {
+            continue;
+        }
+        if (top + height < bestTop ||
+            (top + height == bestTop && skyline[i].width < bestWidth)) {
+            best      = i;
+            bestTop   = top + height;
+            bestWidth = skyline[i].width;
+            bestY     = top;
+        }
+    }
+    if (best == skyline.size()) {
+        return false;
+    }
+
+    // ========================================
+    // 1.2 RAISE THE SKYLINE
+    // ========================================
+    // The new segment replaces everything it covers; a partly covered segment is shortened
+    const Segment placed = {skyline[best].x, bestTop, width};
+    skyline.insert(skyline.begin() + static_cast<ptrdiff_t>(best), placed);
+
+    const uint32_t right = placed.x + placed.width;
+    size_t next          = best + 1;
+    while (next < skyline.size() && skyline[next].x < right) {
+        Segment& segment            = skyline[next];
+        const uint32_t segmentRight = segment.x + segment.width;
+        if (segmentRight <= right) {
+            skyline.erase(skyline.begin() + static_cast<ptrdiff_t>(next));
+            continue;
+        }
+        segment.width = segmentRight - right;
+        segment.x     = right;
+        break;
+    }
+
+    // Neighbors at the same height become one segment
+    for (size_t i = 0; i + 1 < skyline.size();) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + static_cast<ptrdiff_t>(i + 1));
+        } else {
+            ++i;
+        }
+    }
+
+    x = placed.x;
+    y = bestY;
+    usedArea += static_cast<uint64_t>(width) * height;
+    return true;
+}
+
+// ========================================
+// 2. ATLAS
+// ========================================
+
+uint32_t TextureAtlas::Add(const uint32_t* source, uint32_t imageWidth, uint32_t imageHeight) {
+    Image image;
+    image.width  = imageWidth;
+    image.height = imageHeight;
+    image.pixels.assign(source, source + static_cast<size_t>(imageWidth) * imageHeight);
+    images.push_back(std::move(image));
+    return static_cast<uint32_t>(images.size() - 1);
+}
+
+void TextureAtlas::Clear() {
+    images.clear();
+    regions.clear();
+    pixels.clear();
+    width  = 0;
+    height = 0;
+}
+
+bool TextureAtlas::Pack(uint32_t binWidth, uint32_t binHeight, uint32_t padding) {
+    // Tallest first (then widest), which is what keeps a skyline flat
+    std::vector<uint32_t> order(images.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        if (images[a].height != images[b].height) {
+            return images[a].height > images[b].height;
+        }
+        return images[a].width > images[b].width;
+    });
+
+    AtlasPacker packer(binWidth, binHeight);
+    regions.assign(images.size(), Region());
+    for (uint32_t id : order) {
+        const Image& image = images[id];
+        uint32_t x         = 0;
+        uint32_t y         = 0;
+        if (!packer.Insert(image.width + 2 * padding, image.height + 2 * padding, x, y)) {
+            return false;
+        }
+        Region& region = regions[id];
+        region.x       = x + padding;
+        region.y       = y + padding;
+        region.width   = image.width;
+        region.height  = image.height;
+    }
+    return true;
+}
+
+bool TextureAtlas::Build(uint32_t maxSize, uint32_t padding) {
+    // ========================================
+    // 2.1 FIND THE SMALLEST SIZE THAT FITS
+    // ========================================
+    // Start at the smallest power-of-two size whose area holds the padded images, then keep
+    // alternating between doubling the width and the height
+    uint64_t area    = 0;
+    uint32_t largest = 1;
+    for (const Image& image : images) {
+        const uint32_t paddedWidth  = image.width + 2 * padding;
+        const uint32_t paddedHeight = image.height + 2 * padding;
+        area += static_cast<uint64_t>(paddedWidth) * paddedHeight;
+        largest = std::max(largest, std::max(paddedWidth, paddedHeight));
+    }
+    uint32_t binWidth = 1;
+    while (binWidth < largest) {
+        binWidth *= 2;
+    }
+    uint32_t binHeight = binWidth;
+
+    auto grow = [&binWidth, &binHeight]() {
+        if (binWidth == binHeight) {
+            binWidth *= 2;
+        } else {
+            binHeight *= 2;
+        }
+    };
+    while (static_cast<uint64_t>(binWidth) * binHeight < area) {
+        grow();
+    }
+
+    bool packed = false;
+    while (binWidth <= maxSize && binHeight <= maxSize) {
+        if (Pack(binWidth, binHeight, padding)) {
+            packed = true;
+            break;
+        }
+        grow();
+    }
+    if (!packed) {
+        regions.clear();
+        return false;
+    }
+
+    // ========================================
+    // 2.2 COPY THE IMAGES
+    // ========================================
+    // Padding pixels repeat the nearest border pixel of their image (clamp-to-edge)
+    width  = binWidth;
+    height = binHeight;
+    pixels.assign(static_cast<size_t>(width) * height, 0u);
+    for (size_t id = 0; id < images.size(); ++id) {
+        const Image& image = images[id];
+        Region& region     = regions[id];
+        if (image.width == 0 || image.height == 0) {
+            continue;
+        }
+        const int32_t pad = static_cast<int32_t>(padding);
+        for (int32_t row = -pad; row < static_cast<int32_t>(image.height) + pad; ++row) {
+            const uint32_t sourceRow =
+                static_cast<uint32_t>(std::clamp(row, 0, static_cast<int32_t>(image.height) - 1));
+            const uint32_t* source  = image.pixels.data() + sourceRow * image.width;
+            const int64_t targetRow = static_cast<int64_t>(region.y) + row;
+            uint32_t* destination   = pixels.data() + targetRow * width + region.x;
+            for (int32_t column = -pad; column < 0; ++column) {
+                destination[column] = source[0];
+            }
+            std::copy(source, source + image.width, destination);
+            for (uint32_t column = 0; column < padding; ++column) {
+                destination[image.width + column] = source[image.width - 1];
+            }
+        }
+
+        region.u0 = static_cast<float>(region.x) / static_cast<float>(width);
+        region.v0 = static_cast<float>(region.y) / static_cast<float>(height);
+        region.u1 = static_cast<float>(region.x + region.width) / static_cast<float>(width);
+        region.v1 = static_cast<float>(region.y + region.height) / static_cast<float>(height);
+    }
+    return true;
+}
+
+float TextureAtlas::GetOccupancy() const {
+    if (width == 0 || height == 0) {
+        return 0.0f;
+    }
+    uint64_t covered = 0;
+    for (const Image& image : images) {
+        covered += static_cast<uint64_t>(image.width) * image.height;
+    }
+    return static_cast<float>(static_cast<double>(covered) /
+                              (static_cast<double>(width) * height));
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Atlas Packer Class
+// Skyline bottom-left rectangle packer: the packed area is tracked as the outline of its
+// top edge (a list of horizontal segments), and each rectangle goes where its top would be
+// lowest. Wasted space is only ever left below the skyline, which keeps it dense for
+// rectangles inserted tallest first.
+class AtlasPacker {
+  public:
+    AtlasPacker() = default;
+    AtlasPacker(uint32_t width, uint32_t height) {
+        Reset(width, height);
+    }
+
+    // Empty the bin and resize it
+    void Reset(uint32_t width, uint32_t height);
+
+    // Place a width x height rectangle; false (and nothing changed) when it does not fit
+    bool Insert(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y);
+
+    uint32_t GetWidth() const {
+        return binWidth;
+    }
+    uint32_t GetHeight() const {
+        return binHeight;
+    }
+
+    // Area of all inserted rectangles, in pixels
+    uint64_t GetUsedArea() const {
+        return usedArea;
+    }
+
+  private:
+    struct Segment {
+        uint32_t x;
+        uint32_t y; // Height of the skyline over [x, x + width)
+        uint32_t width;
+    };
+
+    std::vector<Segment> skyline; // Left to right, covering the whole bin width
+    uint32_t binWidth  = 0;
+    uint32_t binHeight = 0;
+    uint64_t usedArea  = 0;
+
+    // Lowest y a rectangle starting at skyline[index] can sit at; false if it overhangs
+    bool Fit(size_t index, uint32_t width, uint32_t height, uint32_t& y) const;
+};
+
+// Texture Atlas Class
+// Packs many small RGBA8 images into one texture, so sprites that use them share a texture
+// and therefore a draw. Build() tries power-of-two sizes from the smallest that could hold
+// the images up to maxSize, inserting tallest first. Every image is surrounded by padding
+// pixels copied from its own border, so bilinear filtering at a region's edge never picks
+// up a neighbor.
+class TextureAtlas {
+  public:
+    // Where an image ended up: pixel rectangle and normalized texture coordinates
+    struct Region {
+        uint32_t x      = 0;
+        uint32_t y      = 0;
+        uint32_t width  = 0;
+        uint32_t height = 0;
+        float u0        = 0.0f;
+        float v0        = 0.0f;
+        float u1        = 0.0f;
+        float v1        = 0.0f;
+    };
+
+    /*
+    Queue a copy of an image for the next Build and return its id
+    pixels: width * height RGBA8 values, rows top to bottom
+    */
+    uint32_t Add(const uint32_t* pixels, uint32_t width, uint32_t height);
+
+    // Pack every added image; false if they do not fit in maxSize x maxSize
+    bool Build(uint32_t maxSize = 4096, uint32_t padding = 1);
+
+    // Forget all images and the built atlas
+    void Clear();
+
+    // Valid after a successful Build
+    const Region& GetRegion(uint32_t id) const {
+        return regions[id];
+    }
+    uint32_t GetImageCount() const {
+        return static_cast<uint32_t>(images.size());
+    }
+    const std::vector<uint32_t>& GetPixels() const {
+        return pixels;
+    }
+    uint32_t GetWidth() const {
+        return width;
+    }
+    uint32_t GetHeight() const {
+        return height;
+    }
+
+    // Share of the atlas covered by images (without padding), 0 before Build
+    float GetOccupancy() const;
+
+  private:
+    struct Image {
+        uint32_t width  = 0;
+        uint32_t height = 0;
+        std::vector<uint32_t> pixels;
+    };
+
+    std::vector<Image> images;
+    std::vector<Region> regions;
+    std::vector<uint32_t> pixels; // Built atlas, width * height RGBA8
+    uint32_t width  = 0;
+    uint32_t height = 0;
+
+    // Place every image in a width x height bin; false if one does not fit
+    bool Pack(uint32_t binWidth, uint32_t binHeight, uint32_t padding);
+};
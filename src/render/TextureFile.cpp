@@ -0,0 +1,307 @@
+#include "TextureFile.h"
+#include <cstring>
+
+namespace {
+
+// DDS: "DDS " then DDS_HEADER (124 bytes), then DDS_HEADER_DXT10 if the FourCC is "DX10"
+constexpr uint32_t DdsMagic          = 0x20534444;
+constexpr uint32_t DdsHeaderSize     = 124;
+constexpr uint32_t DdsDx10HeaderSize = 20;
+constexpr uint32_t DdsMipCountFlag   = 0x20000;  // DDSD_MIPMAPCOUNT
+constexpr uint32_t DdsFourCCFlag     = 0x4;      // DDPF_FOURCC
+constexpr uint32_t DdsRgbFlag        = 0x40;     // DDPF_RGB
+constexpr uint32_t DdsCubeOrVolume   = 0x200600; // DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME
+
+constexpr uint32_t FourCC(char a, char b, char c, char d) {
+    return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) |
+           (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+}
+
+// DXGI_FORMAT values of the DX10 header
+enum DxgiFormat : uint32_t {
+    DxgiRGBA8 = 28,
+    DxgiBC1   = 71,
+    DxgiBC3   = 77,
+    DxgiBGRA8 = 87,
+    DxgiBC7   = 98,
+};
+constexpr uint32_t DdsTexture2D = 3; // D3D10_RESOURCE_DIMENSION_TEXTURE2D
+
+// KTX2: identifier, 9 header words, index, then one level entry per mip (mip 0 first)
+constexpr uint8_t Ktx2Identifier[12] = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+constexpr size_t Ktx2LevelIndexOffset = 80;
+
+// VkFormat values
+enum VkFormat : uint32_t {
+    VkRGBA8   = 37,
+    VkBGRA8   = 44,
+    VkBC1RGB  = 131,
+    VkBC1RGBA = 133,
+    VkBC3     = 137,
+    VkBC7     = 145,
+};
+
+uint32_t ReadU32(const uint8_t* data, size_t offset) {
+    uint32_t value;
+    std::memcpy(&value, data + offset, sizeof(value));
+    return value;
+}
+
+uint64_t ReadU64(const uint8_t* data, size_t offset) {
+    uint64_t value;
+    std::memcpy(&value, data + offset, sizeof(value));
+    return value;
+}
+
+uint32_t BlockBytes(TextureFormat format) {
+    switch (format) {
+    case TextureFormat::BC1:
+        return 8;
+    case TextureFormat::BC3:
+    case TextureFormat::BC7:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+// A non-empty size and no more levels than it takes to reach 1x1
+bool HasValidChain(const TextureDesc& desc) {
+    if (desc.width == 0 || desc.height == 0 || desc.mipCount > TextureFile::MaxMips) {
+        return false;
+    }
+    const uint32_t largest = desc.width > desc.height ? desc.width : desc.height;
+    uint32_t fullChain     = 1;
+    while ((largest >> fullChain) > 0) {
+        ++fullChain;
+    }
+    return desc.mipCount <= fullChain;
+}
+
+} // namespace
+
+uint32_t TextureDesc::RowPitch(uint32_t mip) const {
+    if (format == TextureFormat::RGBA8) {
+        return MipWidth(mip) * 4;
+    }
+    return (MipWidth(mip) + 3) / 4 * BlockBytes(format);
+}
+
+uint32_t TextureDesc::RowCount(uint32_t mip) const {
+    return format == TextureFormat::RGBA8 ? MipHeight(mip) : (MipHeight(mip) + 3) / 4;
+}
+
+// ========================================
+// 1. OPEN
+// ========================================
+
+bool TextureFile::Open(const std::string& path) {
+    Close();
+    if (!file.Open(path)) {
+        return false;
+    }
+    if (!Load(file.GetData(), file.GetSize())) {
+        file.Close();
+        return false;
+    }
+    return true;
+}
+
+bool TextureFile::Load(const uint8_t* fileData, size_t fileSize) {
+    desc        = TextureDesc();
+    data        = nullptr;
+    size        = 0;
+    swapRedBlue = false;
+
+    bool loaded = false;
+    if (fileSize >= 4 + DdsHeaderSize && ReadU32(fileData, 0) == DdsMagic) {
+        loaded = LoadDds(fileData, fileSize);
+    } else if (fileSize >= Ktx2LevelIndexOffset &&
+               std::memcmp(fileData, Ktx2Identifier, sizeof(Ktx2Identifier)) == 0) {
+        loaded = LoadKtx2(fileData, fileSize);
+    }
+    if (!loaded) {
+        desc = TextureDesc();
+        return false;
+    }
+    data = fileData;
+    size = fileSize;
+    return true;
+}
+
+void TextureFile::Close() {
+    file.Close();
+    desc = TextureDesc();
+    data = nullptr;
+    size = 0;
+}
+
+bool TextureFile::LayoutPackedMips(uint64_t offset) {
+    for (uint32_t mip = 0; mip < desc.mipCount; ++mip) {
+        levels[mip].offset = offset;
+        levels[mip].size   = desc.MipBytes(mip);
+        offset += levels[mip].size;
+    }
+    return true;
+}
+
+// ========================================
+// 2. DDS
+// ========================================
+
+bool TextureFile::LoadDds(const uint8_t* fileData, size_t fileSize) {
+    const uint8_t* header = fileData + 4;
+    if (ReadU32(header, 0) != DdsHeaderSize) {
+        return false;
+    }
+    const uint32_t flags      = ReadU32(header, 4);
+    desc.height               = ReadU32(header, 8);
+    desc.width                = ReadU32(header, 12);
+    const uint32_t mipCount   = ReadU32(header, 24);
+    const uint32_t pixelFlags = ReadU32(header, 76);
+    const uint32_t fourCC     = ReadU32(header, 80);
+    const uint32_t bitCount   = ReadU32(header, 84);
+    const uint32_t redMask    = ReadU32(header, 88);
+    const uint32_t caps2      = ReadU32(header, 108);
+    desc.mipCount             = (flags & DdsMipCountFlag) && mipCount > 0 ? mipCount : 1;
+    uint64_t dataOffset       = 4 + DdsHeaderSize;
+    if ((caps2 & DdsCubeOrVolume) != 0) {
+        return false;
+    }
+
+    // Pixel format: the DX10 extension header names a DXGI format directly
+    if ((pixelFlags & DdsFourCCFlag) && fourCC == FourCC('D', 'X', '1', '0')) {
+        if (fileSize < dataOffset + DdsDx10HeaderSize) {
+            return false;
+        }
+        const uint8_t* dx10 = fileData + dataOffset;
+        if (ReadU32(dx10, 4) != DdsTexture2D || ReadU32(dx10, 12) > 1) {
+            return false; // Arrays are not streamed
+        }
+        switch (ReadU32(dx10, 0)) {
+        case DxgiRGBA8:
+            desc.format = TextureFormat::RGBA8;
+            break;
+        case DxgiBGRA8:
+            desc.format = TextureFormat::RGBA8;
+            swapRedBlue = true;
+            break;
+        case DxgiBC1:
+            desc.format = TextureFormat::BC1;
+            break;
+        case DxgiBC3:
+            desc.format = TextureFormat::BC3;
+            break;
+        case DxgiBC7:
+            desc.format = TextureFormat::BC7;
+            break;
+        default:
+            return false;
+        }
+        dataOffset += DdsDx10HeaderSize;
+    } else if (pixelFlags & DdsFourCCFlag) {
+        if (fourCC == FourCC('D', 'X', 'T', '1')) {
+            desc.format = TextureFormat::BC1;
+        } else if (fourCC == FourCC('D', 'X', 'T', '5')) {
+            desc.format = TextureFormat::BC3;
+        } else {
+            return false;
+        }
+    } else if ((pixelFlags & DdsRgbFlag) && bitCount == 32) {
+        desc.format = TextureFormat::RGBA8;
+        swapRedBlue = redMask == 0x00FF0000u;
+    } else {
+        return false;
+    }
+
+    if (!HasValidChain(desc)) {
+        return false;
+    }
+
+    // Levels follow each other, finest first, tightly packed
+    LayoutPackedMips(dataOffset);
+    const Level& last = levels[desc.mipCount - 1];
+    return last.offset + last.size <= fileSize;
+}
+
+// ========================================
+// 3. KTX2
+// ========================================
+
+bool TextureFile::LoadKtx2(const uint8_t* fileData, size_t fileSize) {
+    const uint32_t vkFormat         = ReadU32(fileData, 12);
+    desc.width                      = ReadU32(fileData, 20);
+    desc.height                     = ReadU32(fileData, 24);
+    const uint32_t depth            = ReadU32(fileData, 28);
+    const uint32_t layerCount       = ReadU32(fileData, 32);
+    const uint32_t faceCount        = ReadU32(fileData, 36);
+    const uint32_t levelCount       = ReadU32(fileData, 40);
+    const uint32_t supercompression = ReadU32(fileData, 44);
+    desc.mipCount                   = levelCount > 0 ? levelCount : 1;
+
+    // Supercompressed (Basis, zstd) files would need a transcoder on the loader thread
+    if (depth > 1 || layerCount > 1 || faceCount != 1 || supercompression != 0 ||
+        !HasValidChain(desc)) {
+        return false;
+    }
+    switch (vkFormat) {
+    case VkRGBA8:
+        desc.format = TextureFormat::RGBA8;
+        break;
+    case VkBGRA8:
+        desc.format = TextureFormat::RGBA8;
+        swapRedBlue = true;
+        break;
+    case VkBC1RGB:
+    case VkBC1RGBA:
+        desc.format = TextureFormat::BC1;
+        break;
+    case VkBC3:
+        desc.format = TextureFormat::BC3;
+        break;
+    case VkBC7:
+        desc.format = TextureFormat::BC7;
+        break;
+    default:
+        return false;
+    }
+
+    // The level index gives every level's place; KTX2 writers usually store the coarsest
+    // level first, so nothing is assumed about the order
+    if (fileSize < Ktx2LevelIndexOffset + static_cast<size_t>(desc.mipCount) * 24) {
+        return false;
+    }
+    for (uint32_t mip = 0; mip < desc.mipCount; ++mip) {
+        const size_t entry = Ktx2LevelIndexOffset + static_cast<size_t>(mip) * 24;
+        levels[mip].offset = ReadU64(fileData, entry);
+        levels[mip].size   = ReadU64(fileData, entry + 8);
+        if (levels[mip].size != desc.MipBytes(mip) || levels[mip].offset > fileSize ||
+            levels[mip].size > fileSize - levels[mip].offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========================================
+// 4. READ
+// ========================================
+
+bool TextureFile::ReadMip(uint32_t mip, uint8_t* destination) const {
+    if (!data || mip >= desc.mipCount) {
+        return false;
+    }
+    const Level& level = levels[mip];
+    std::memcpy(destination, data + level.offset, static_cast<size_t>(level.size));
+
+    // BGRA8 to RGBA8: swap bytes 0 and 2 of every texel
+    if (swapRedBlue) {
+        for (uint64_t i = 0; i < level.size; i += 4) {
+            const uint8_t blue = destination[i];
+            destination[i]     = destination[i + 2];
+            destination[i + 2] = blue;
+        }
+    }
+    return true;
+}
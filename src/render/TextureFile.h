@@ -0,0 +1,99 @@
+#pragma once
+#include "utils/MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// GPU formats a streamed texture can have; backends translate them (Graphics: DXGI_FORMAT)
+enum class TextureFormat : uint8_t {
+    Unknown = 0,
+    RGBA8, // 4 bytes per texel, red first
+    BC1,   // 8 bytes per 4x4 block
+    BC3,   // 16 bytes per 4x4 block
+    BC7,   // 16 bytes per 4x4 block
+};
+
+// Texture Desc
+// Size and format of a 2D texture with a full or partial mip chain (mip 0 is the finest)
+struct TextureDesc {
+    TextureFormat format = TextureFormat::Unknown;
+    uint32_t width       = 0;
+    uint32_t height      = 0;
+    uint32_t mipCount    = 0;
+
+    uint32_t MipWidth(uint32_t mip) const {
+        return (width >> mip) > 0 ? width >> mip : 1;
+    }
+    uint32_t MipHeight(uint32_t mip) const {
+        return (height >> mip) > 0 ? height >> mip : 1;
+    }
+
+    // Bytes from one row of texels (or 4x4 blocks) to the next in a tightly packed mip
+    uint32_t RowPitch(uint32_t mip) const;
+
+    // Rows of texels (or blocks) in a mip
+    uint32_t RowCount(uint32_t mip) const;
+
+    uint64_t MipBytes(uint32_t mip) const {
+        return static_cast<uint64_t>(RowPitch(mip)) * RowCount(mip);
+    }
+};
+
+// Texture File Class
+// Read side of DDS and KTX2 files holding one 2D texture and its mip chain. Open maps the
+// file and parses only the headers; ReadMip copies one level out of the mapping (faulting
+// in just its pages) and decodes it to the desc format, so a loader thread can stream a
+// texture level by level, coarsest first, without ever reading the levels it skips.
+//
+// Supported: DDS with a DX10 header (R8G8B8A8, B8G8R8A8, BC1, BC3, BC7) or a legacy header
+// (DXT1, DXT5, 32-bit RGBA/BGRA masks); KTX2 without supercompression in the matching
+// Vulkan formats. Arrays, cube maps and volumes are rejected.
+class TextureFile {
+  public:
+    static constexpr uint32_t MaxMips = 16; // 32768 x 32768
+
+    // Map and parse path; closes any previous file
+    bool Open(const std::string& path);
+
+    /*
+    Parse a file already in memory (not copied; must outlive this)
+    Checks the headers and that every level lies inside the data
+    */
+    bool Load(const uint8_t* data, size_t size);
+
+    void Close();
+
+    const TextureDesc& GetDesc() const {
+        return desc;
+    }
+
+    // Bytes of a level as stored in the file
+    uint64_t GetStoredSize(uint32_t mip) const {
+        return levels[mip].size;
+    }
+
+    /*
+    Copy a level into destination, which holds desc.MipBytes(mip) bytes, converting BGRA
+    files to RGBA on the way. Thread safe: the mapping is only read
+    */
+    bool ReadMip(uint32_t mip, uint8_t* destination) const;
+
+  private:
+    struct Level {
+        uint64_t offset = 0; // From the start of the file
+        uint64_t size   = 0;
+    };
+
+    MappedFile file;
+    const uint8_t* data = nullptr;
+    size_t size         = 0;
+    TextureDesc desc;
+    Level levels[MaxMips];
+    bool swapRedBlue = false; // Stored as BGRA8
+
+    bool LoadDds(const uint8_t* data, size_t size);
+    bool LoadKtx2(const uint8_t* data, size_t size);
+
+    // Fill levels for tightly packed mips starting at offset, finest first (DDS layout)
+    bool LayoutPackedMips(uint64_t offset);
+};
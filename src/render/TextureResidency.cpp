@@ -0,0 +1,194 @@
+#include "TextureResidency.h"
+#include <algorithm>
+
+uint32_t TextureResidency::Add(const TextureDesc& desc) {
+    Texture texture;
+    texture.mipCount = desc.mipCount;
+    for (uint32_t mip = desc.mipCount; mip-- > 0;) {
+        texture.bytesFrom[mip] = texture.bytesFrom[mip + 1] + desc.MipBytes(mip);
+    }
+
+    // The tail is every level that fits in TailSize x TailSize (at least the last one)
+    texture.tailFirst = desc.mipCount - 1;
+    while (texture.tailFirst > 0 && desc.MipWidth(texture.tailFirst - 1) <= TailSize &&
+           desc.MipHeight(texture.tailFirst - 1) <= TailSize) {
+        --texture.tailFirst;
+    }
+
+    texture.firstResident = desc.mipCount;
+    texture.pendingFirst  = desc.mipCount;
+    textures.push_back(texture);
+    return static_cast<uint32_t>(textures.size() - 1);
+}
+
+void TextureResidency::Request(uint32_t texture, uint32_t mip, uint64_t frame) {
+    Texture& entry = textures[texture];
+    mip            = std::min(mip, entry.mipCount - 1);
+
+    ++stats.requests;
+    if (mip >= entry.firstResident) {
+        ++stats.hits;
+    }
+
+    // First request this frame: becomes most recently used, and its desired mip starts over
+    if (!entry.used || entry.lastUsed != frame) {
+        if (entry.used) {
+            Unlink(texture);
+        }
+        entry.used     = true;
+        entry.lastUsed = frame;
+        entry.desired  = mip;
+        PushHead(texture);
+    } else {
+        entry.desired = std::min(entry.desired, mip);
+    }
+}
+
+// ========================================
+// 1. CHOOSING LOADS
+// ========================================
+
+void TextureResidency::Update(uint64_t frame,
+                              uint32_t maxLoads,
+                              std::vector<Load>& loads,
+                              std::vector<Eviction>& evictions) {
+    // Textures requested this frame sit at the head of the list, so the walk stops at the
+    // first one that was not
+    candidates.clear();
+    for (uint32_t index = head; index != InvalidTexture && textures[index].lastUsed == frame;
+         index = textures[index].next) {
+        const Texture& entry = textures[index];
+        if (entry.failed || entry.pendingFirst != entry.firstResident) {
+            continue; // One load in flight per texture
+        }
+
+        Load load;
+        load.texture = index;
+        if (entry.firstResident == entry.mipCount) {
+            load.firstMip = entry.tailFirst;
+            load.endMip   = entry.mipCount;
+        } else if (entry.desired < entry.firstResident) {
+            load.firstMip = entry.firstResident - 1;
+            load.endMip   = entry.firstResident;
+        } else {
+            continue;
+        }
+        load.bytes = entry.bytesFrom[load.firstMip] - entry.bytesFrom[load.endMip];
+        candidates.push_back(load);
+    }
+
+    // Smallest first; equal sizes by handle, so the order does not depend on the list
+    std::sort(candidates.begin(), candidates.end(), [](const Load& a, const Load& b) {
+        return a.bytes != b.bytes ? a.bytes < b.bytes : a.texture < b.texture;
+    });
+
+    uint32_t issued = 0;
+    for (const Load& load : candidates) {
+        if (issued == maxLoads || !MakeRoom(load.bytes, frame, evictions)) {
+            break; // Every later candidate is at least as large
+        }
+        textures[load.texture].pendingFirst = load.firstMip;
+        stats.pendingBytes += load.bytes;
+        loads.push_back(load);
+        ++issued;
+    }
+}
+
+void TextureResidency::OnLoaded(const Load& load) {
+    Texture& entry      = textures[load.texture];
+    entry.firstResident = load.firstMip;
+    entry.pendingFirst  = load.firstMip;
+
+    stats.pendingBytes -= load.bytes;
+    stats.residentBytes += load.bytes;
+    stats.bytesLoaded += load.bytes;
+    ++stats.loads;
+}
+
+void TextureResidency::OnFailed(const Load& load) {
+    Texture& entry     = textures[load.texture];
+    entry.pendingFirst = entry.firstResident;
+    entry.failed       = true;
+    stats.pendingBytes -= load.bytes;
+}
+
+TextureResidency::Stats TextureResidency::GetStats() const {
+    return stats;
+}
+
+// ========================================
+// 2. EVICTION
+// ========================================
+
+bool TextureResidency::MakeRoom(uint64_t bytes,
+                                uint64_t frame,
+                                std::vector<Eviction>& evictions) {
+    if (bytes > budget) {
+        return false;
+    }
+
+    // Finest levels first, one texture at a time from the least recently used end. Textures
+    // with a load in flight are skipped: their resident range is about to change
+    for (uint32_t index = tail; index != InvalidTexture &&
+                                stats.residentBytes + stats.pendingBytes + bytes > budget;
+         index = textures[index].previous) {
+        Texture& entry = textures[index];
+        if (entry.pendingFirst != entry.firstResident) {
+            continue;
+        }
+
+        // Always keep the tail; keep what this frame samples too
+        uint32_t keepFirst = entry.tailFirst;
+        if (entry.lastUsed == frame) {
+            keepFirst = std::min(keepFirst, entry.desired);
+        }
+
+        uint32_t firstMip = entry.firstResident;
+        while (firstMip < keepFirst &&
+               stats.residentBytes + stats.pendingBytes + bytes > budget) {
+            const uint64_t levelBytes = entry.bytesFrom[firstMip] - entry.bytesFrom[firstMip + 1];
+            stats.residentBytes -= levelBytes;
+            stats.bytesEvicted += levelBytes;
+            ++stats.evictions;
+            ++firstMip;
+        }
+        if (firstMip != entry.firstResident) {
+            entry.firstResident = firstMip;
+            entry.pendingFirst  = firstMip;
+            evictions.push_back({index, firstMip});
+        }
+    }
+    return stats.residentBytes + stats.pendingBytes + bytes <= budget;
+}
+
+// ========================================
+// 3. LEAST RECENTLY USED LIST
+// ========================================
+
+void TextureResidency::Unlink(uint32_t texture) {
+    Texture& entry = textures[texture];
+    if (entry.previous != InvalidTexture) {
+        textures[entry.previous].next = entry.next;
+    } else {
+        head = entry.next;
+    }
+    if (entry.next != InvalidTexture) {
+        textures[entry.next].previous = entry.previous;
+    } else {
+        tail = entry.previous;
+    }
+    entry.previous = InvalidTexture;
+    entry.next     = InvalidTexture;
+}
+
+void TextureResidency::PushHead(uint32_t texture) {
+    Texture& entry = textures[texture];
+    entry.previous = InvalidTexture;
+    entry.next     = head;
+    if (head != InvalidTexture) {
+        textures[head].previous = texture;
+    } else {
+        tail = texture;
+    }
+    head = texture;
+}
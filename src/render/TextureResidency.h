@@ -0,0 +1,128 @@
+#pragma once
+#include "TextureFile.h"
+#include <cstdint>
+#include <vector>
+
+// Texture Residency Class
+// Decides which mips of which streamed textures should be in video memory; owns no data and
+// does no I/O, so the policy runs the same under the streamer and in a test.
+//
+// Every texture keeps a contiguous range of mips [firstResident, mipCount) resident, so
+// loading means extending the range one finer level at a time and evicting means dropping
+// its finest levels. The first load of a texture brings in its whole tail (every mip of at
+// most TailSize texels) at once, so anything requested can be sampled from the next frame.
+//
+// Textures are kept in least-recently-requested order. Loads are chosen among the textures
+// requested this frame, smallest first (which is coarsest first: a texture far from its
+// desired mip gets its cheap levels before a nearly complete one gets its largest), and make
+// room within the budget by evicting finer levels from the least recently used end: down to
+// the tail for textures not requested this frame, down to the requested mip for the rest.
+class TextureResidency {
+  public:
+    static constexpr uint32_t InvalidTexture = 0xFFFFFFFFu;
+    static constexpr uint32_t TailSize       = 64;
+
+    // Read mips [firstMip, endMip) and make them resident
+    struct Load {
+        uint32_t texture  = InvalidTexture;
+        uint32_t firstMip = 0;
+        uint32_t endMip   = 0;
+        uint64_t bytes    = 0;
+    };
+
+    // Drop every mip finer than firstMip
+    struct Eviction {
+        uint32_t texture  = InvalidTexture;
+        uint32_t firstMip = 0;
+    };
+
+    // Totals since construction, plus the current resident and in-flight bytes
+    struct Stats {
+        uint64_t requests      = 0;
+        uint64_t hits          = 0; // Requests whose mip was already resident
+        uint64_t loads         = 0;
+        uint64_t bytesLoaded   = 0;
+        uint64_t evictions     = 0; // Levels dropped
+        uint64_t bytesEvicted  = 0;
+        uint64_t residentBytes = 0;
+        uint64_t pendingBytes  = 0; // Loads issued but not yet finished
+    };
+
+    explicit TextureResidency(uint64_t budgetBytes = 0) : budget(budgetBytes) {}
+
+    // Bytes resident plus in flight that Update keeps below; lowering it evicts lazily
+    void SetBudget(uint64_t budgetBytes) {
+        budget = budgetBytes;
+    }
+    uint64_t GetBudget() const {
+        return budget;
+    }
+
+    // Track a texture with nothing resident; returns its handle
+    uint32_t Add(const TextureDesc& desc);
+
+    uint32_t GetTextureCount() const {
+        return static_cast<uint32_t>(textures.size());
+    }
+
+    /*
+    Note that texture is sampled at mip this frame
+    Counts a hit when the mip is resident and marks the texture most recently used
+    */
+    void Request(uint32_t texture, uint32_t mip, uint64_t frame);
+
+    /*
+    Choose up to maxLoads new loads among the textures requested in frame, and the evictions
+    that make room for them. Appends to loads and evictions; evictions take effect at once
+    and must be applied before the next draw, loads finish with OnLoaded or OnFailed
+    */
+    void Update(uint64_t frame,
+                uint32_t maxLoads,
+                std::vector<Load>& loads,
+                std::vector<Eviction>& evictions);
+
+    // A load's mips are in video memory
+    void OnLoaded(const Load& load);
+
+    // A load could not be read or uploaded; the texture is not streamed further
+    void OnFailed(const Load& load);
+
+    // First resident mip of a texture; its mip count when nothing is resident
+    uint32_t GetFirstResident(uint32_t texture) const {
+        return textures[texture].firstResident;
+    }
+
+    Stats GetStats() const;
+
+  private:
+    struct Texture {
+        uint64_t bytesFrom[TextureFile::MaxMips + 1] = {}; // Bytes of mips [m, mipCount)
+
+        uint32_t mipCount      = 0;
+        uint32_t tailFirst     = 0;     // First mip of at most TailSize x TailSize
+        uint32_t firstResident = 0;     // mipCount when nothing is resident
+        uint32_t pendingFirst  = 0;     // firstResident once the load in flight lands
+        uint32_t desired       = 0;     // Finest mip requested in lastUsed
+        uint64_t lastUsed      = 0;     // Frame of the last Request
+        bool used              = false; // Requested at least once (lastUsed is valid)
+        bool failed            = false;
+
+        // Least recently used list, most recent at head
+        uint32_t previous = InvalidTexture;
+        uint32_t next     = InvalidTexture;
+    };
+
+    std::vector<Texture> textures;
+    uint32_t head   = InvalidTexture;
+    uint32_t tail   = InvalidTexture;
+    uint64_t budget = 0;
+    Stats stats;
+
+    std::vector<Load> candidates; // Update scratch
+
+    void Unlink(uint32_t texture);
+    void PushHead(uint32_t texture);
+
+    // Evict from the least recently used end until bytes more fit; false if they cannot
+    bool MakeRoom(uint64_t bytes, uint64_t frame, std::vector<Eviction>& evictions);
+};
@@ -0,0 +1,130 @@
+#include "TextureStreamer.h"
+
+TextureStreamer::~TextureStreamer() {
+    Stop();
+}
+
+bool TextureStreamer::Start(const Settings& newSettings) {
+    Stop();
+    settings = newSettings;
+    residency.SetBudget(settings.budgetBytes);
+
+    quit = false;
+    const uint32_t threadCount = settings.threadCount > 0 ? settings.threadCount : 1;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(&TextureStreamer::LoaderLoop, this);
+    }
+    return true;
+}
+
+void TextureStreamer::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+
+    // Reads that never ran or never reached Update stay pending in the residency
+    queued.clear();
+    finished.clear();
+}
+
+uint32_t TextureStreamer::Add(const std::string& path) {
+    auto file = std::make_unique<TextureFile>();
+    if (!file->Open(path)) {
+        return InvalidTexture;
+    }
+    const uint32_t texture = residency.Add(file->GetDesc());
+    files.push_back(std::move(file));
+    return texture;
+}
+
+// ========================================
+// 1. RENDER THREAD
+// ========================================
+
+void TextureStreamer::Update(Uploader& uploader) {
+    // Take the finished reads in one short lock
+    landed.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        landed.swap(finished);
+    }
+
+    for (Read& read : landed) {
+        const TextureResidency::Load& load = read.load;
+        const TextureDesc& desc            = files[load.texture]->GetDesc();
+        if (read.succeeded &&
+            uploader.UploadMips(load.texture, desc, load.firstMip, load.endMip, read.data.data())) {
+            residency.OnLoaded(load);
+        } else {
+            residency.OnFailed(load);
+        }
+    }
+
+    // Evictions are applied before this frame draws; loads land in a later Update
+    loads.clear();
+    evictions.clear();
+    residency.Update(frame, settings.maxLoadsPerFrame, loads, evictions);
+    for (const TextureResidency::Eviction& eviction : evictions) {
+        uploader.Evict(eviction.texture, files[eviction.texture]->GetDesc(), eviction.firstMip);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Read& read : landed) {
+            read.data.clear();
+            spareBuffers.push_back(std::move(read.data));
+        }
+        for (const TextureResidency::Load& load : loads) {
+            Read read;
+            read.load = load;
+            read.file = files[load.texture].get();
+            queued.push_back(std::move(read));
+        }
+    }
+    if (!loads.empty()) {
+        wake.notify_all();
+    }
+    ++frame;
+}
+
+// ========================================
+// 2. LOADER THREADS
+// ========================================
+
+void TextureStreamer::LoaderLoop() {
+    for (;;) {
+        Read read;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return quit || !queued.empty(); });
+            if (quit) {
+                return;
+            }
+            read = std::move(queued.front());
+            queued.pop_front();
+            if (!spareBuffers.empty()) {
+                read.data = std::move(spareBuffers.back());
+                spareBuffers.pop_back();
+            }
+        }
+
+        // Levels are copied finest first, the order Uploader::UploadMips expects
+        const TextureDesc& desc = read.file->GetDesc();
+        read.data.resize(static_cast<size_t>(read.load.bytes));
+        uint8_t* destination = read.data.data();
+        read.succeeded       = true;
+        for (uint32_t mip = read.load.firstMip; mip < read.load.endMip && read.succeeded; ++mip) {
+            read.succeeded = read.file->ReadMip(mip, destination);
+            destination += desc.MipBytes(mip);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.push_back(std::move(read));
+    }
+}
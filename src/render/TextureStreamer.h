@@ -0,0 +1,116 @@
+#pragma once
+#include "TextureFile.h"
+#include "TextureResidency.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Texture Streamer Class
+// Streams the mips of DDS/KTX2 textures into video memory as they are needed. The render
+// thread requests the mip each texture is sampled at; once a frame, Update hands finished
+// reads to the backend's Uploader and lets TextureResidency pick the next loads and
+// evictions under the memory budget. Loader threads only copy levels out of the mapped
+// files, so a slow disk delays sharpness, never a frame. Platform-neutral (std::thread only).
+class TextureStreamer {
+  public:
+    static constexpr uint32_t InvalidTexture = TextureResidency::InvalidTexture;
+
+    // Backend side: owns the GPU textures and changes their resident mips on the render thread
+    class Uploader {
+      public:
+        virtual ~Uploader() = default;
+
+        /*
+        Make mips [firstMip, desc.mipCount) resident: data holds [firstMip, endMip) packed
+        finest first (desc.MipBytes each), the coarser levels are resident already
+        Returns false if the texture could not be created
+        */
+        virtual bool UploadMips(uint32_t texture,
+                                const TextureDesc& desc,
+                                uint32_t firstMip,
+                                uint32_t endMip,
+                                const uint8_t* data) = 0;
+
+        // Drop every mip finer than firstMip
+        virtual void Evict(uint32_t texture, const TextureDesc& desc, uint32_t firstMip) = 0;
+    };
+
+    struct Settings {
+        uint64_t budgetBytes      = 256ull * 1024 * 1024; // Resident plus in-flight mips
+        uint32_t threadCount      = 2;                    // Loader threads
+        uint32_t maxLoadsPerFrame = 8;                    // New loads Update may issue
+    };
+
+    TextureStreamer() = default;
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&)            = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Start the loader threads
+    bool Start(const Settings& settings);
+
+    // Join the loader threads; loads still queued are dropped
+    void Stop();
+
+    // Open a texture file (headers only); returns its handle or InvalidTexture
+    uint32_t Add(const std::string& path);
+
+    // Sample texture at mip this frame (render thread)
+    void Request(uint32_t texture, uint32_t mip) {
+        residency.Request(texture, mip, frame);
+    }
+
+    /*
+    Once per frame on the render thread, after the frame's requests: upload finished reads,
+    apply evictions and queue the next loads
+    */
+    void Update(Uploader& uploader);
+
+    const TextureDesc& GetDesc(uint32_t texture) const {
+        return files[texture]->GetDesc();
+    }
+
+    // First resident mip of a texture; its mip count when nothing is resident
+    uint32_t GetResidentMip(uint32_t texture) const {
+        return residency.GetFirstResident(texture);
+    }
+
+    TextureResidency::Stats GetStats() const {
+        return residency.GetStats();
+    }
+
+  private:
+    struct Read {
+        TextureResidency::Load load;
+        const TextureFile* file = nullptr; // Stable: files holds unique_ptrs
+        std::vector<uint8_t> data;
+        bool succeeded = false;
+    };
+
+    Settings settings;
+    std::vector<std::unique_ptr<TextureFile>> files; // Indexed by handle
+    TextureResidency residency;
+    uint64_t frame = 0;
+
+    // Render thread -> loaders and back; spare buffers are recycled between reads
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<Read> queued;
+    std::vector<Read> finished;
+    std::vector<std::vector<uint8_t>> spareBuffers;
+    bool quit = false;
+    std::vector<std::thread> threads;
+
+    // Update scratch
+    std::vector<Read> landed;
+    std::vector<TextureResidency::Load> loads;
+    std::vector<TextureResidency::Eviction> evictions;
+
+    void LoaderLoop();
+};
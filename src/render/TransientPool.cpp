@@ -0,0 +1,97 @@
+#include "TransientPool.h"
+#include <algorithm>
+
+namespace {
+
+// Classes 0-7 are 1-8 units; from 8 on, each power of two 2^k (k >= 3) is split in four
+constexpr uint32_t LinearClasses = 8;
+
+uint32_t FloorLog2(uint64_t value) {
+    uint32_t log = 0;
+    while (value >>= 1) {
+        ++log;
+    }
+    return log;
+}
+
+} // namespace
+
+uint32_t TransientPool::SizeClass(uint64_t size) {
+    const uint64_t units = std::max<uint64_t>((size + BlockAlign - 1) / BlockAlign, 1);
+    if (units <= LinearClasses) {
+        return static_cast<uint32_t>(units - 1);
+    }
+    const uint32_t octave  = FloorLog2(units - 1);
+    const uint64_t quarter = uint64_t(1) << (octave - 2);
+    const uint64_t step    = (units - (uint64_t(1) << octave) + quarter - 1) / quarter;
+    return LinearClasses + (octave - 3) * 4 + static_cast<uint32_t>(step) - 1;
+}
+
+uint64_t TransientPool::ClassSize(uint32_t sizeClass) {
+    if (sizeClass < LinearClasses) {
+        return (sizeClass + 1) * BlockAlign;
+    }
+    const uint32_t octave = 3 + (sizeClass - LinearClasses) / 4;
+    const uint64_t step   = (sizeClass - LinearClasses) % 4 + 1;
+    return ((uint64_t(1) << octave) + step * (uint64_t(1) << (octave - 2))) * BlockAlign;
+}
+
+void TransientPool::BeginFrame() {
+    ++frame;
+    auto stale = [this](uint32_t id) { return frame - blocks[id].lastUsed > trimFrames; };
+    for (std::vector<uint32_t>& list : freeBlocks) {
+        auto kept = std::stable_partition(list.begin(), list.end(), stale);
+        for (auto it = list.begin(); it != kept; ++it) {
+            stats.bytes -= blocks[*it].size;
+            --stats.blocks;
+            ++stats.blocksTrimmed;
+            blocks[*it] = Block();
+            unusedIds.push_back(*it);
+        }
+        list.erase(list.begin(), kept);
+    }
+}
+
+uint32_t TransientPool::Acquire(uint64_t size) {
+    const uint32_t sizeClass = SizeClass(size);
+    if (sizeClass >= freeBlocks.size()) {
+        freeBlocks.resize(sizeClass + 1);
+    }
+    ++stats.acquires;
+
+    uint32_t id;
+    std::vector<uint32_t>& list = freeBlocks[sizeClass];
+    if (!list.empty()) {
+        id = list.back();
+        list.pop_back();
+        ++stats.reuses;
+    } else {
+        if (!unusedIds.empty()) {
+            id = unusedIds.back();
+            unusedIds.pop_back();
+        } else {
+            id = static_cast<uint32_t>(blocks.size());
+            blocks.emplace_back();
+        }
+        blocks[id].size      = ClassSize(sizeClass);
+        blocks[id].sizeClass = sizeClass;
+        stats.bytes += blocks[id].size;
+        stats.peakBytes = std::max(stats.peakBytes, stats.bytes);
+        ++stats.blocks;
+        ++stats.blocksCreated;
+    }
+    blocks[id].lastUsed = frame;
+    return id;
+}
+
+void TransientPool::Release(uint32_t block) {
+    freeBlocks[blocks[block].sizeClass].push_back(block);
+}
+
+void TransientPool::Clear() {
+    blocks.clear();
+    freeBlocks.clear();
+    unusedIds.clear();
+    stats.bytes  = 0;
+    stats.blocks = 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Transient Pool Class
+// Memory blocks for the transient resources of a RenderGraph, recycled within a frame and
+// kept across frames. Sizes round up to a size class (eight linear classes of BlockAlign,
+// then four per power of two, so at most 25% is wasted), and a block only ever hosts
+// resources of its own class: a released block goes on its class's free list and the next
+// Acquire of that class takes it back, which is what lets two resources with disjoint
+// lifetimes share memory.
+//
+// The pool only does the bookkeeping; a backend creates the memory behind each block id
+// (a placed-resource heap, or a tile pool range) and watches GetBlockSize for ids that
+// were trimmed (0) or recreated. Blocks not acquired for TrimFrames frames are released
+// by BeginFrame.
+class TransientPool {
+  public:
+    static constexpr uint64_t BlockAlign   = 64 * 1024; // Placement granularity of a heap
+    static constexpr uint32_t InvalidBlock = 0xFFFFFFFFu;
+
+    struct Stats {
+        uint64_t bytes         = 0; // Held by every live block
+        uint64_t peakBytes     = 0;
+        uint32_t blocks        = 0;
+        uint64_t acquires      = 0;
+        uint64_t reuses        = 0; // Acquires served from a free list
+        uint64_t blocksCreated = 0;
+        uint64_t blocksTrimmed = 0;
+    };
+
+    // Size class of a size in bytes, and the block size of a class
+    static uint32_t SizeClass(uint64_t size);
+    static uint64_t ClassSize(uint32_t sizeClass);
+
+    /*
+    Start a frame: every block must have been released. Blocks whose last Acquire was more
+    than TrimFrames frames ago are freed
+    */
+    void BeginFrame();
+
+    // Take a block of at least size bytes: a free one of its class, or a new one
+    uint32_t Acquire(uint64_t size);
+
+    // Return a block to its class's free list; the next Acquire of the class may take it
+    void Release(uint32_t block);
+
+    // Free every block (all must have been released)
+    void Clear();
+
+    // Frames a block may sit unused before BeginFrame frees it (default 60)
+    void SetTrimFrames(uint32_t frames) {
+        trimFrames = frames;
+    }
+
+    // Block ids are below this; a freed id reads as size 0 until it is reused
+    uint32_t GetBlockCount() const {
+        return static_cast<uint32_t>(blocks.size());
+    }
+    uint64_t GetBlockSize(uint32_t block) const {
+        return blocks[block].size;
+    }
+
+    Stats GetStats() const {
+        return stats;
+    }
+
+  private:
+    struct Block {
+        uint64_t size      = 0; // 0 while the id is unused
+        uint64_t lastUsed  = 0; // Frame of the last Acquire
+        uint32_t sizeClass = 0;
+    };
+
+    std::vector<Block> blocks;
+    std::vector<std::vector<uint32_t>> freeBlocks; // Per class, most recently released last
+    std::vector<uint32_t> unusedIds;
+    uint64_t frame      = 0;
+    uint32_t trimFrames = 60;
+    Stats stats;
+};
@@ -0,0 +1,249 @@
+#include "VertexEncoder.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VERTEX_ENCODER_SSE2 1
+#include <emmintrin.h>
+#else
+#define VERTEX_ENCODER_SSE2 0
+#endif
+
+namespace VertexEncoder {
+
+namespace {
+
+const float* Advance(const float* pointer, size_t bytes) {
+    return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(pointer) + bytes);
+}
+
+uint8_t* Advance(void* pointer, size_t bytes) {
+    return static_cast<uint8_t*>(pointer) + bytes;
+}
+
+#if VERTEX_ENCODER_SSE2
+// x, y, z, 0 without reading past the third float (tightly packed float3 arrays)
+__m128 LoadFloat3(const float* source) {
+    // movq, not a double load: float3 arrays are only 4-byte aligned
+    __m128 xy = _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)));
+    return _mm_movelh_ps(xy, _mm_load_ss(source + 2));
+}
+
+// Clamp to [-1, 1] and round to the nearest SNORM16 step, as EncodeSNorm16 does
+__m128i QuantizeSNorm16(__m128 value) {
+    value = _mm_min_ps(_mm_max_ps(value, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+    return _mm_cvtps_epi32(_mm_mul_ps(value, _mm_set1_ps(32767.0f)));
+}
+
+// 1.0 where value >= 0, -1.0 elsewhere
+__m128 SignNotZero(__m128 value) {
+    __m128 positive = _mm_cmpge_ps(value, _mm_setzero_ps());
+    return _mm_or_ps(_mm_and_ps(positive, _mm_set1_ps(1.0f)),
+                     _mm_andnot_ps(positive, _mm_set1_ps(-1.0f)));
+}
+
+__m128 Select(__m128 mask, __m128 ifTrue, __m128 ifFalse) {
+    return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+void Store32(uint8_t* destination, __m128i value) {
+    int32_t bits = _mm_cvtsi128_si32(value);
+    memcpy(destination, &bits, sizeof(bits));
+}
+#endif
+
+} // namespace
+
+// ========================================
+// 1. SCALAR REFERENCE
+// ========================================
+
+void EncodeSNorm16x4Scalar(const float* source,
+                           size_t sourceStride,
+                           uint32_t count,
+                           void* destination,
+                           size_t destinationStride) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const float* in = Advance(source, i * sourceStride);
+        SNorm16x4 out;
+        out.v[0] = EncodeSNorm16(in[0]);
+        out.v[1] = EncodeSNorm16(in[1]);
+        out.v[2] = EncodeSNorm16(in[2]);
+        out.v[3] = EncodeSNorm16(1.0f);
+        memcpy(Advance(destination, i * destinationStride), &out, sizeof(out));
+    }
+}
+
+void EncodeUNorm8x4Scalar(const float* source,
+                          size_t sourceStride,
+                          uint32_t count,
+                          void* destination,
+                          size_t destinationStride) {
+    for (uint32_t i = 0; i < count; ++i) {
+        const float* in = Advance(source, i * sourceStride);
+        UNorm8x4 out;
+        for (int c = 0; c < 4; ++c) {
+            out.v[c] = EncodeUNorm8(in[c]);
+        }
+        memcpy(Advance(destination, i * destinationStride), &out, sizeof(out));
+    }
+}
+
+void EncodeOctahedralScalar(const float* source,
+                            size_t sourceStride,
+                            uint32_t count,
+                            void* destination,
+                            size_t destinationStride) {
+    for (uint32_t i = 0; i < count; ++i) {
+        float encoded[2];
+        OctahedralEncode(Advance(source, i * sourceStride), encoded);
+        SNorm16x2 out;
+        out.v[0] = EncodeSNorm16(encoded[0]);
+        out.v[1] = EncodeSNorm16(encoded[1]);
+        memcpy(Advance(destination, i * destinationStride), &out, sizeof(out));
+    }
+}
+
+// ========================================
+// 2. SSE2 BATCH ENCODERS
+// ========================================
+
+void EncodeSNorm16x4(const float* source,
+                     size_t sourceStride,
+                     uint32_t count,
+                     void* destination,
+                     size_t destinationStride) {
+    uint32_t i = 0;
+#if VERTEX_ENCODER_SSE2
+    // One position per register; w comes from OR-ing 1.0 into the zeroed fourth lane
+    const __m128 oneW = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128i q[4];
+        for (int k = 0; k < 4; ++k) {
+            __m128 position = LoadFloat3(Advance(source, (i + k) * sourceStride));
+            q[k]            = QuantizeSNorm16(_mm_or_ps(position, oneW));
+        }
+        __m128i packed01 = _mm_packs_epi32(q[0], q[1]);
+        __m128i packed23 = _mm_packs_epi32(q[2], q[3]);
+
+        uint8_t* out = Advance(destination, i * destinationStride);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), packed01);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + destinationStride),
+                         _mm_unpackhi_epi64(packed01, packed01));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 2 * destinationStride), packed23);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 3 * destinationStride),
+                         _mm_unpackhi_epi64(packed23, packed23));
+    }
+#endif
+    EncodeSNorm16x4Scalar(Advance(source, i * sourceStride),
+                          sourceStride,
+                          count - i,
+                          Advance(destination, i * destinationStride),
+                          destinationStride);
+}
+
+void EncodeUNorm8x4(const float* source,
+                    size_t sourceStride,
+                    uint32_t count,
+                    void* destination,
+                    size_t destinationStride) {
+    uint32_t i = 0;
+#if VERTEX_ENCODER_SSE2
+    // Four colors saturate down to one register of bytes, one 32-bit lane per color
+    const __m128 zero  = _mm_setzero_ps();
+    const __m128 one   = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128i q[4];
+        for (int k = 0; k < 4; ++k) {
+            __m128 color = _mm_loadu_ps(Advance(source, (i + k) * sourceStride));
+            color        = _mm_min_ps(_mm_max_ps(color, zero), one);
+            q[k]         = _mm_cvtps_epi32(_mm_mul_ps(color, scale));
+        }
+        __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(q[0], q[1]),
+                                         _mm_packs_epi32(q[2], q[3]));
+
+        uint8_t* out = Advance(destination, i * destinationStride);
+        for (int k = 0; k < 4; ++k) {
+            Store32(out + k * destinationStride, bytes);
+            bytes = _mm_srli_si128(bytes, 4);
+        }
+    }
+#endif
+    EncodeUNorm8x4Scalar(Advance(source, i * sourceStride),
+                         sourceStride,
+                         count - i,
+                         Advance(destination, i * destinationStride),
+                         destinationStride);
+}
+
+void EncodeOctahedral(const float* source,
+                      size_t sourceStride,
+                      uint32_t count,
+                      void* destination,
+                      size_t destinationStride) {
+    uint32_t i = 0;
+#if VERTEX_ENCODER_SSE2
+    // Four normals transposed to x, y, z registers; same operations as OctahedralEncode
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 zero    = _mm_setzero_ps();
+    const __m128 one     = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = LoadFloat3(Advance(source, i * sourceStride));
+        __m128 y = LoadFloat3(Advance(source, (i + 1) * sourceStride));
+        __m128 z = LoadFloat3(Advance(source, (i + 2) * sourceStride));
+        __m128 w = LoadFloat3(Advance(source, (i + 3) * sourceStride));
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        __m128 length = _mm_add_ps(_mm_add_ps(_mm_and_ps(x, absMask), _mm_and_ps(y, absMask)),
+                                   _mm_and_ps(z, absMask));
+        __m128 scale  = _mm_and_ps(_mm_div_ps(one, length), _mm_cmpgt_ps(length, zero));
+        x             = _mm_mul_ps(x, scale);
+        y             = _mm_mul_ps(y, scale);
+
+        __m128 foldedX = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(y, absMask)), SignNotZero(x));
+        __m128 foldedY = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(x, absMask)), SignNotZero(y));
+        __m128 lower   = _mm_cmplt_ps(z, zero);
+        __m128i qx     = QuantizeSNorm16(Select(lower, foldedX, x));
+        __m128i qy     = QuantizeSNorm16(Select(lower, foldedY, y));
+
+        // x0 y0 x1 y1 x2 y2 x3 y3 as int16
+        __m128i packed = _mm_packs_epi32(_mm_unpacklo_epi32(qx, qy), _mm_unpackhi_epi32(qx, qy));
+
+        uint8_t* out = Advance(destination, i * destinationStride);
+        for (int k = 0; k < 4; ++k) {
+            Store32(out + k * destinationStride, packed);
+            packed = _mm_srli_si128(packed, 4);
+        }
+    }
+#endif
+    EncodeOctahedralScalar(Advance(source, i * sourceStride),
+                           sourceStride,
+                           count - i,
+                           Advance(destination, i * destinationStride),
+                           destinationStride);
+}
+
+// ========================================
+// 3. WHOLE VERTICES
+// ========================================
+
+void EncodeVertices(const Vertex* vertices, uint32_t count, PackedVertex* destination) {
+    if (count == 0) {
+        return;
+    }
+    // Byte addresses rather than &destination[0].color: the strided writes run past the
+    // first element, which GCC's object-size checks would otherwise flag
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(destination);
+    EncodeSNorm16x4(vertices[0].position,
+                    sizeof(Vertex),
+                    count,
+                    bytes + offsetof(PackedVertex, position),
+                    sizeof(PackedVertex));
+    EncodeUNorm8x4(vertices[0].color,
+                   sizeof(Vertex),
+                   count,
+                   bytes + offsetof(PackedVertex, color),
+                   sizeof(PackedVertex));
+}
+
+} // namespace VertexEncoder
@@ -0,0 +1,124 @@
+#pragma once
+#include "RenderBackend.h"
+#include "VertexFormat.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Packed counterpart of Vertex, 12 bytes instead of 28: position as SNORM16 with w = 1
+// (so coordinates must lie in [-1, 1]) and color as RGBA8 UNORM. The input assembler
+// expands both back to floats, so BasicVS reads the same float3/float4 inputs
+struct PackedVertex {
+    SNorm16x4 position;
+    UNorm8x4 color;
+};
+
+template <>
+struct VertexLayout<PackedVertex> {
+    static constexpr VertexElement Elements[] = {
+        VERTEX_ELEMENT(PackedVertex, position, "POSITION", 0),
+        VERTEX_ELEMENT(PackedVertex, color, "COLOR", 0)};
+};
+
+// Vertex Encoder
+// Float to packed attribute conversion. Each batch encoder reads count attributes with a
+// byte stride and writes them with another, so it can fill one member of an array of
+// vertex structs (or a mapped buffer) directly; the SSE2 versions handle four attributes per
+// iteration and match the scalar ones bit for bit
+namespace VertexEncoder {
+
+// Round-to-nearest quantization of a single value (clamped to the format's range)
+inline int16_t EncodeSNorm16(float value) {
+    value = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+    return static_cast<int16_t>(std::lrint(value * 32767.0f));
+}
+inline uint8_t EncodeUNorm8(float value) {
+    value = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+    return static_cast<uint8_t>(std::lrint(value * 255.0f));
+}
+inline float DecodeSNorm16(int16_t value) {
+    float decoded = static_cast<float>(value) * (1.0f / 32767.0f);
+    return decoded < -1.0f ? -1.0f : decoded;
+}
+
+/*
+Octahedral mapping of a unit vector to [-1, 1]^2: project onto the octahedron
+|x| + |y| + |z| = 1, then fold the lower hemisphere over the diagonals
+Stored as SNORM16x2 the worst-case angular error is about 0.005 degrees
+*/
+inline void OctahedralEncode(const float normal[3], float out[2]) {
+    float length = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+    float scale  = length > 0.0f ? 1.0f / length : 0.0f;
+    float x      = normal[0] * scale;
+    float y      = normal[1] * scale;
+    if (normal[2] < 0.0f) {
+        float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x             = foldedX;
+        y             = foldedY;
+    }
+    out[0] = x;
+    out[1] = y;
+}
+inline void OctahedralDecode(const float encoded[2], float normal[3]) {
+    float x = encoded[0];
+    float y = encoded[1];
+    float z = 1.0f - std::fabs(x) - std::fabs(y);
+    if (z < 0.0f) {
+        float unfoldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float unfoldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x               = unfoldedX;
+        y               = unfoldedY;
+    }
+    float length = std::sqrt(x * x + y * y + z * z);
+    normal[0]    = x / length;
+    normal[1]    = y / length;
+    normal[2]    = z / length;
+}
+
+/*
+float3 positions to SNorm16x4 with w = 1.0 (32767)
+source/sourceStride: First x and bytes between consecutive positions
+destination/destinationStride: First SNorm16x4 and bytes between consecutive outputs
+*/
+void EncodeSNorm16x4(const float* source,
+                     size_t sourceStride,
+                     uint32_t count,
+                     void* destination,
+                     size_t destinationStride);
+
+// float4 colors to UNorm8x4, strides as above
+void EncodeUNorm8x4(const float* source,
+                    size_t sourceStride,
+                    uint32_t count,
+                    void* destination,
+                    size_t destinationStride);
+
+// float3 normals (need not be normalized) to octahedral SNorm16x2, strides as above
+void EncodeOctahedral(const float* source,
+                      size_t sourceStride,
+                      uint32_t count,
+                      void* destination,
+                      size_t destinationStride);
+
+// Scalar reference versions of the batch encoders
+void EncodeSNorm16x4Scalar(const float* source,
+                           size_t sourceStride,
+                           uint32_t count,
+                           void* destination,
+                           size_t destinationStride);
+void EncodeUNorm8x4Scalar(const float* source,
+                          size_t sourceStride,
+                          uint32_t count,
+                          void* destination,
+                          size_t destinationStride);
+void EncodeOctahedralScalar(const float* source,
+                            size_t sourceStride,
+                            uint32_t count,
+                            void* destination,
+                            size_t destinationStride);
+
+// Pack count vertices (positions must lie in [-1, 1])
+void EncodeVertices(const Vertex* vertices, uint32_t count, PackedVertex* destination);
+
+} // namespace VertexEncoder
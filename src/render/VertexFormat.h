@@ -0,0 +1,148 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Storage format of one vertex attribute; backends translate it to their own enum
+// (Graphics: DXGI_FORMAT, see core/InputLayout.h)
+enum class VertexElementFormat : uint8_t {
+    Float2,    // float[2]
+    Float3,    // float[3]
+    Float4,    // float[4]
+    SNorm16x2, // Two int16 in [-1, 1], e.g. an octahedral normal
+    SNorm16x4, // Four int16 in [-1, 1], e.g. a quantized position with w = 1
+    UNorm8x4,  // Four uint8 in [0, 1], e.g. an RGBA color
+};
+
+// Size in bytes of one attribute of the given format
+constexpr uint32_t VertexElementSize(VertexElementFormat format) {
+    switch (format) {
+    case VertexElementFormat::Float2:
+        return 8;
+    case VertexElementFormat::Float3:
+        return 12;
+    case VertexElementFormat::Float4:
+        return 16;
+    case VertexElementFormat::SNorm16x2:
+        return 4;
+    case VertexElementFormat::SNorm16x4:
+        return 8;
+    case VertexElementFormat::UNorm8x4:
+        return 4;
+    }
+    return 0;
+}
+
+// Packed attribute types; declaring a vertex member with one of these picks its format
+struct SNorm16x2 {
+    int16_t v[2];
+};
+struct SNorm16x4 {
+    int16_t v[4];
+};
+struct UNorm8x4 {
+    uint8_t v[4];
+};
+
+// Maps a vertex member type to its format; unsupported types fail to compile
+template <typename T>
+struct VertexElementFormatOf;
+
+template <>
+struct VertexElementFormatOf<float[2]> {
+    static constexpr VertexElementFormat value = VertexElementFormat::Float2;
+};
+template <>
+struct VertexElementFormatOf<float[3]> {
+    static constexpr VertexElementFormat value = VertexElementFormat::Float3;
+};
+template <>
+struct VertexElementFormatOf<float[4]> {
+    static constexpr VertexElementFormat value = VertexElementFormat::Float4;
+};
+template <>
+struct VertexElementFormatOf<SNorm16x2> {
+    static constexpr VertexElementFormat value = VertexElementFormat::SNorm16x2;
+};
+template <>
+struct VertexElementFormatOf<SNorm16x4> {
+    static constexpr VertexElementFormat value = VertexElementFormat::SNorm16x4;
+};
+template <>
+struct VertexElementFormatOf<UNorm8x4> {
+    static constexpr VertexElementFormat value = VertexElementFormat::UNorm8x4;
+};
+
+// Vertex Element
+// One attribute of a vertex struct: shader semantic, storage format and byte offset
+struct VertexElement {
+    const char* semantic;   // HLSL semantic name, a string literal
+    uint32_t semanticIndex; // For repeated semantics (TEXCOORD0, TEXCOORD1, ...)
+    VertexElementFormat format;
+    uint32_t offset; // Byte offset from the start of the vertex
+};
+
+/*
+Describe a member of a vertex struct; format and offset come from the member itself
+Type: Vertex struct, member: Data member name, semantic/index: Shader input it feeds
+*/
+#define VERTEX_ELEMENT(Type, member, semantic, index)                         \
+    VertexElement{semantic,                                                   \
+                  index,                                                      \
+                  VertexElementFormatOf<decltype(Type::member)>::value,       \
+                  static_cast<uint32_t>(offsetof(Type, member))}
+
+/*
+Vertex Layout
+Specialize for every vertex struct that feeds an input layout, listing its members once:
+
+    template <>
+    struct VertexLayout<MyVertex> {
+        static constexpr VertexElement Elements[] = {
+            VERTEX_ELEMENT(MyVertex, position, "POSITION", 0),
+            VERTEX_ELEMENT(MyVertex, color, "COLOR", 0)};
+    };
+*/
+template <typename V>
+struct VertexLayout;
+
+// True if the elements of VertexLayout<V> exactly tile V: every element inside the struct
+// and 4-byte aligned, no two overlapping, and no bytes left unlisted
+template <typename V>
+constexpr bool IsValidVertexLayout() {
+    constexpr uint32_t count =
+        sizeof(VertexLayout<V>::Elements) / sizeof(VertexLayout<V>::Elements[0]);
+    const VertexElement* elements = VertexLayout<V>::Elements;
+
+    uint32_t covered = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t begin = elements[i].offset;
+        const uint32_t end   = begin + VertexElementSize(elements[i].format);
+        if (end > sizeof(V) || begin % 4 != 0) {
+            return false;
+        }
+        for (uint32_t j = 0; j < i; ++j) {
+            const uint32_t otherBegin = elements[j].offset;
+            const uint32_t otherEnd   = otherBegin + VertexElementSize(elements[j].format);
+            if (begin < otherEnd && otherBegin < end) {
+                return false;
+            }
+        }
+        covered += end - begin;
+    }
+    return covered == sizeof(V);
+}
+
+// Vertex Format
+// Compile-time view of a VertexLayout: elements, element count and stride. Naming
+// VertexFormat<V> checks the layout against the struct, so a member added without an
+// element (or an element with a stale offset) is a compile error
+template <typename V>
+struct VertexFormat {
+    static_assert(IsValidVertexLayout<V>(),
+                  "VertexLayout elements must exactly cover the vertex struct");
+
+    static constexpr const VertexElement* Elements = VertexLayout<V>::Elements;
+    static constexpr uint32_t Count =
+        sizeof(VertexLayout<V>::Elements) / sizeof(VertexLayout<V>::Elements[0]);
+    static constexpr uint32_t Stride = sizeof(V);
+};
@@ -0,0 +1,160 @@
+#include "BenchmarkScene.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// xorshift32: deterministic, so every run draws the same scene
+struct Random {
+    uint32_t seed;
+
+    uint32_t Next() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+};
+
+// Cells per side of the smallest square grid holding count objects
+uint32_t GridSide(uint32_t count) {
+    return static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+}
+
+} // namespace
+
+void InstanceScene::Build(uint32_t instanceCount) {
+    *this = InstanceScene();
+    count = instanceCount;
+    if (count == 0) {
+        return;
+    }
+
+    positionX.resize(count);
+    positionY.resize(count);
+    positionZ.assign(count, 0.0f);
+    rotationX.assign(count, 0.0f);
+    rotationY.assign(count, 0.0f);
+    rotationZ.resize(count);
+    rotationW.resize(count);
+    scale.resize(count);
+    color.resize(count);
+
+    Random random       = {0x9E3779B9u};
+    const uint32_t side = GridSide(count);
+    const float cell    = 2.0f / static_cast<float>(side);
+    for (uint32_t i = 0; i < count; ++i) {
+        float halfAngle = static_cast<float>(random.Next() >> 8) * (3.14159265f / 16777216.0f);
+        positionX[i]    = -1.0f + (static_cast<float>(i % side) + 0.5f) * cell;
+        positionY[i]    = -1.0f + (static_cast<float>(i / side) + 0.5f) * cell;
+        rotationZ[i]    = std::sin(halfAngle);
+        rotationW[i]    = std::cos(halfAngle);
+        scale[i]        = cell * 0.5f; // The triangle spans 1.6 units
+        color[i]        = random.Next() | 0xFF000000u;
+    }
+}
+
+InstanceSource InstanceScene::GetSource() const {
+    InstanceSource source;
+    source.positionX = positionX.data();
+    source.positionY = positionY.data();
+    source.positionZ = positionZ.data();
+    source.rotationX = rotationX.data();
+    source.rotationY = rotationY.data();
+    source.rotationZ = rotationZ.data();
+    source.rotationW = rotationW.data();
+    source.scale     = scale.data();
+    source.color     = color.data();
+    return source;
+}
+
+void ObjectScene::Build(uint32_t objectCount) {
+    world.clear();
+    if (objectCount == 0) {
+        return;
+    }
+
+    Random random       = {0x68E31DA4u};
+    const uint32_t side = GridSide(objectCount);
+    const float cell    = 2.0f / static_cast<float>(side);
+    const float scale   = cell * 0.5f; // The triangle spans 1.6 units
+    world.resize(objectCount);
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        const float angle = static_cast<float>(random.Next() >> 8) * (6.28318531f / 16777216.0f);
+        const float c     = std::cos(angle) * scale;
+        const float s     = std::sin(angle) * scale;
+        const float x     = -1.0f + (static_cast<float>(i % side) + 0.5f) * cell;
+        const float y     = -1.0f + (static_cast<float>(i / side) + 0.5f) * cell;
+        world[i]          = {{{c, s, 0.0f, 0.0f},
+                              {-s, c, 0.0f, 0.0f},
+                              {0.0f, 0.0f, 1.0f, 0.0f},
+                              {x, y, 0.0f, 1.0f}}};
+    }
+}
+
+bool SpriteScene::BuildAtlas() {
+    // 64 soft-edged discs of 8 to 40 pixels
+    Random random = {0x2545F491u};
+    atlas.Clear();
+    std::vector<uint32_t> image;
+    for (uint32_t i = 0; i < 64; ++i) {
+        const uint32_t size = 8 + random.Next() % 33;
+        const float radius  = static_cast<float>(size) * 0.5f;
+        image.assign(static_cast<size_t>(size) * size, 0u);
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                const float dx       = static_cast<float>(x) + 0.5f - radius;
+                const float dy       = static_cast<float>(y) + 0.5f - radius;
+                const float distance = std::sqrt(dx * dx + dy * dy);
+                const float coverage = std::clamp(radius - distance, 0.0f, 1.0f);
+                const uint32_t alpha = static_cast<uint32_t>(coverage * 255.0f);
+                image[y * size + x]  = (alpha << 24) | 0xFFFFFFu;
+            }
+        }
+        atlas.Add(image.data(), size, size);
+    }
+    return atlas.Build(1024, 1);
+}
+
+void SpriteScene::Build(uint32_t spriteCount, uint32_t width, uint32_t height, uint32_t texture) {
+    sprites.resize(spriteCount);
+    spin.resize(spriteCount);
+    if (spriteCount == 0 || atlas.GetImageCount() == 0 || width == 0 || height == 0) {
+        sprites.clear();
+        spin.clear();
+        return;
+    }
+
+    Random random = {0x68E31DA4u};
+    for (uint32_t i = 0; i < spriteCount; ++i) {
+        const TextureAtlas::Region& region = atlas.GetRegion(random.Next() % atlas.GetImageCount());
+
+        Sprite& sprite  = sprites[i];
+        sprite          = Sprite();
+        sprite.x        = static_cast<float>(random.Next() % width);
+        sprite.y        = static_cast<float>(random.Next() % height);
+        sprite.width    = static_cast<float>(region.width);
+        sprite.height   = static_cast<float>(region.height);
+        sprite.rotation = static_cast<float>(random.Next() >> 8) * (6.28318531f / 16777216.0f);
+        sprite.region   = {region.u0, region.v0, region.u1, region.v1};
+        sprite.color    = (random.Next() & 0x00FFFFFFu) | 0xC0000000u;
+        sprite.texture  = texture;
+
+        const uint32_t kind = random.Next() % 8;
+        if (kind == 0) {
+            sprite.texture = 0;
+            sprite.region  = SpriteRegion();
+            sprite.width *= 0.5f;
+            sprite.height *= 0.5f;
+        } else if (kind == 1) {
+            sprite.blend = SpriteBlend::Additive;
+        }
+        spin[i] = (static_cast<float>(random.Next() % 2001) - 1000.0f) * 0.00005f;
+    }
+}
+
+void SpriteScene::Animate() {
+    for (size_t i = 0; i < sprites.size(); ++i) {
+        sprites[i].rotation += spin[i];
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "render/InstanceWriter.h"
+#include "render/MatrixBatch.h"
+#include "render/SpriteBatch.h"
+#include "render/TextureAtlas.h"
+#include <cstdint>
+#include <vector>
+
+// Benchmark Scenes
+// Deterministic content for the command line benchmarks in main.cpp: built once, then
+// handed to Graphics every frame, which logs the CPU cost of submitting it.
+
+// Instance Scene
+// Copies of the triangle on a square grid covering clip space, each scaled to its cell, with
+// a random rotation about the view axis and a random tint (Graphics::DrawInstances)
+struct InstanceScene {
+    uint32_t count = 0;
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+    std::vector<float> scale;
+    std::vector<uint32_t> color;
+
+    void Build(uint32_t instanceCount);
+
+    // View of the arrays; valid until the next Build
+    InstanceSource GetSource() const;
+};
+
+// Object Scene
+// The instance scene's grid, but every copy is its own draw with its own world matrix:
+// scale and a random rotation about the view axis, translation in row 3
+// (Graphics::DrawObjects)
+struct ObjectScene {
+    std::vector<Float4x4> world;
+
+    void Build(uint32_t objectCount);
+};
+
+// Sprite Scene
+// Spinning sprites scattered over the viewport, drawn from a generated atlas of soft-edged
+// discs; one in eight is an untextured square and one in eight is additive, interleaved, so
+// only sorting keeps the draw count down (Graphics::GetSpriteBatch)
+struct SpriteScene {
+    TextureAtlas atlas; // White discs, so the sprite color tints them
+    std::vector<Sprite> sprites;
+    std::vector<float> spin; // Radians per frame
+
+    // Pack the atlas; false if it does not fit in 1024x1024
+    bool BuildAtlas();
+
+    /*
+    Scatter spriteCount sprites over a width x height viewport (after BuildAtlas)
+    texture: renderer handle of the atlas; untextured sprites use handle 0 (white)
+    */
+    void Build(uint32_t spriteCount, uint32_t width, uint32_t height, uint32_t texture);
+
+    // Advance every sprite's rotation by one frame
+    void Animate();
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
+// Bounds Array
+// Axis-aligned boxes in structure-of-arrays form, so SIMD tests load four boxes per register.
+// The arrays are padded to a multiple of four with empty boxes (min > max), which every
+// frustum test rejects, so a SIMD loop never needs a scalar tail.
+class BoundsArray {
+  public:
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    // Resize to count boxes; new boxes (and the padding) are empty
+    void Resize(uint32_t count) {
+        const uint32_t padded = (count + 3) & ~3u;
+        for (std::vector<float>* axis : {&minX, &minY, &minZ}) {
+            axis->resize(padded, FLT_MAX);
+            std::fill(axis->begin() + count, axis->end(), FLT_MAX);
+        }
+        for (std::vector<float>* axis : {&maxX, &maxY, &maxZ}) {
+            axis->resize(padded, -FLT_MAX);
+            std::fill(axis->begin() + count, axis->end(), -FLT_MAX);
+        }
+        size = count;
+    }
+
+    void Set(uint32_t index, const float min[3], const float max[3]) {
+        minX[index] = min[0];
+        minY[index] = min[1];
+        minZ[index] = min[2];
+        maxX[index] = max[0];
+        maxY[index] = max[1];
+        maxZ[index] = max[2];
+    }
+
+    uint32_t Size() const {
+        return size;
+    }
+
+  private:
+    uint32_t size = 0;
+};
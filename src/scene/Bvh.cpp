@@ -0,0 +1,412 @@
+#include "Bvh.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+struct Box {
+    float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    void Grow(const float otherMin[3], const float otherMax[3]) {
+        for (int axis = 0; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], otherMin[axis]);
+            max[axis] = std::max(max[axis], otherMax[axis]);
+        }
+    }
+
+    // Half the surface area; SAH only compares ratios
+    float Area() const {
+        if (min[0] > max[0]) {
+            return 0.0f;
+        }
+        float x = max[0] - min[0];
+        float y = max[1] - min[1];
+        float z = max[2] - min[2];
+        return x * y + y * z + z * x;
+    }
+};
+
+float Centroid(const BoundsArray& bounds, uint32_t object, int axis) {
+    switch (axis) {
+    case 0:
+        return bounds.minX[object] + bounds.maxX[object];
+    case 1:
+        return bounds.minY[object] + bounds.maxY[object];
+    default:
+        return bounds.minZ[object] + bounds.maxZ[object];
+    }
+}
+
+} // namespace
+
+// ========================================
+// 1. BUILD
+// ========================================
+
+void Bvh::Build(const BoundsArray& bounds) {
+    const uint32_t count = bounds.Size();
+    nodes.clear();
+    nodeRanges.clear();
+    subtrees.clear();
+    order.resize(count);
+    std::iota(order.begin(), order.end(), 0u);
+
+    // Structure first (this only reorders the slot array), then every node's child boxes
+    // come from the same bottom-up pass Refit uses
+    if (count > 0) {
+        nodes.reserve(count / 2 + 1);
+        nodeRanges.reserve(count / 2 + 1);
+        BuildNode(bounds, Range{0, count});
+    }
+    Refit(bounds);
+    FindSubtrees(64);
+}
+
+uint32_t Bvh::BuildNode(const BoundsArray& bounds, Range range) {
+    const uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+    nodeRanges.push_back(range);
+
+    // Two rounds of binary splits: split the range, then split both halves again, always
+    // taking the largest part that is still above leaf size
+    Range parts[4] = {range};
+    uint32_t partCount = 1;
+    while (partCount < 4) {
+        uint32_t largest = Empty;
+        for (uint32_t k = 0; k < partCount; ++k) {
+            uint32_t size = parts[k].end - parts[k].begin;
+            if (size > LeafSize &&
+                (largest == Empty || size > parts[largest].end - parts[largest].begin)) {
+                largest = k;
+            }
+        }
+        if (largest == Empty) {
+            break;
+        }
+        uint32_t middle    = Split(bounds, parts[largest]);
+        parts[partCount++] = Range{middle, parts[largest].end};
+        parts[largest].end = middle;
+    }
+
+    for (uint32_t k = 0; k < 4; ++k) {
+        uint32_t child = Empty;
+        uint32_t count = 0;
+        if (k < partCount) {
+            uint32_t size = parts[k].end - parts[k].begin;
+            if (size <= LeafSize) {
+                child = parts[k].begin;
+                count = size;
+            } else {
+                child = BuildNode(bounds, parts[k]); // May reallocate nodes
+            }
+        }
+        nodes[index].child[k] = child;
+        nodes[index].count[k] = count;
+    }
+    return index;
+}
+
+uint32_t Bvh::Split(const BoundsArray& bounds, Range range) {
+    // ========================================
+    // 1. SPLIT AXIS
+    // ========================================
+    // Centroids (scaled by 2, which changes nothing) are binned along their widest axis
+    float centroidMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float centroidMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (uint32_t slot = range.begin; slot < range.end; ++slot) {
+        for (int axis = 0; axis < 3; ++axis) {
+            float c           = Centroid(bounds, order[slot], axis);
+            centroidMin[axis] = std::min(centroidMin[axis], c);
+            centroidMax[axis] = std::max(centroidMax[axis], c);
+        }
+    }
+    int axis = 0;
+    for (int candidate = 1; candidate < 3; ++candidate) {
+        if (centroidMax[candidate] - centroidMin[candidate] >
+            centroidMax[axis] - centroidMin[axis]) {
+            axis = candidate;
+        }
+    }
+    const float extent = centroidMax[axis] - centroidMin[axis];
+    const uint32_t mid = range.begin + (range.end - range.begin) / 2;
+    if (!(extent > 0.0f)) {
+        return mid; // Every centroid coincides: any split is as good as another
+    }
+
+    // ========================================
+    // 2. BIN AND EVALUATE SAH
+    // ========================================
+    const float scale = static_cast<float>(BinCount) / extent;
+
+    auto binOf = [&](uint32_t object) {
+        int bin = static_cast<int>((Centroid(bounds, object, axis) - centroidMin[axis]) * scale);
+        return std::min(bin, static_cast<int>(BinCount) - 1);
+    };
+
+    Box binBounds[BinCount];
+    uint32_t binCounts[BinCount] = {};
+    for (uint32_t slot = range.begin; slot < range.end; ++slot) {
+        uint32_t object = order[slot];
+        int bin         = binOf(object);
+
+        const float min[3] = {bounds.minX[object], bounds.minY[object], bounds.minZ[object]};
+        const float max[3] = {bounds.maxX[object], bounds.maxY[object], bounds.maxZ[object]};
+        binBounds[bin].Grow(min, max);
+        ++binCounts[bin];
+    }
+
+    // Sweep from the right to get the cost of every "bins > i" side, then from the left
+    float rightCost[BinCount] = {};
+    Box sweep;
+    uint32_t sweepCount = 0;
+    for (uint32_t i = BinCount - 1; i > 0; --i) {
+        sweep.Grow(binBounds[i].min, binBounds[i].max);
+        sweepCount += binCounts[i];
+        rightCost[i - 1] = sweep.Area() * static_cast<float>(sweepCount);
+    }
+
+    float bestCost   = FLT_MAX;
+    uint32_t bestBin = Empty;
+    sweep            = Box();
+    sweepCount       = 0;
+    for (uint32_t i = 0; i + 1 < BinCount; ++i) {
+        sweep.Grow(binBounds[i].min, binBounds[i].max);
+        sweepCount += binCounts[i];
+        float cost = sweep.Area() * static_cast<float>(sweepCount) + rightCost[i];
+        if (sweepCount > 0 && sweepCount < range.end - range.begin && cost < bestCost) {
+            bestCost = cost;
+            bestBin  = i;
+        }
+    }
+
+    // ========================================
+    // 3. PARTITION THE SLOTS
+    // ========================================
+    if (bestBin == Empty) {
+        return mid;
+    }
+    auto first = order.begin() + range.begin;
+    auto last  = order.begin() + range.end;
+    auto split = std::partition(first, last, [&](uint32_t object) {
+        return binOf(object) <= static_cast<int>(bestBin);
+    });
+    return static_cast<uint32_t>(split - order.begin());
+}
+
+void Bvh::FindSubtrees(uint32_t targetCount) {
+    // Expand the frontier from the root while whole nodes can be replaced by their children;
+    // a node with a leaf child stays, so the frontier always covers every object once
+    subtrees.clear();
+    if (nodes.empty()) {
+        return;
+    }
+    subtrees.push_back(0);
+    bool expanded = true;
+    while (expanded && subtrees.size() < targetCount) {
+        expanded = false;
+        std::vector<uint32_t> next;
+        for (uint32_t index : subtrees) {
+            const Node& node = nodes[index];
+            bool innerOnly   = true;
+            for (uint32_t k = 0; k < 4; ++k) {
+                innerOnly = innerOnly && (node.child[k] == Empty || node.count[k] == 0);
+            }
+            if (!innerOnly) {
+                next.push_back(index);
+                continue;
+            }
+            for (uint32_t k = 0; k < 4; ++k) {
+                if (node.child[k] != Empty) {
+                    next.push_back(node.child[k]);
+                }
+            }
+            expanded = true;
+        }
+        subtrees.swap(next);
+    }
+
+    // CullParallel compacts the per-task output front to back, which needs slot order
+    std::sort(subtrees.begin(), subtrees.end(), [&](uint32_t a, uint32_t b) {
+        return nodeRanges[a].begin < nodeRanges[b].begin;
+    });
+}
+
+// ========================================
+// 2. REFIT
+// ========================================
+
+void Bvh::Refit(const BoundsArray& bounds) {
+    // Copy the object boxes into slot order; the three extra empty boxes let Test4 read a
+    // full group of four from the last leaf
+    const uint32_t count = static_cast<uint32_t>(order.size());
+    slotBounds.Resize(count + LeafSize - 1);
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        uint32_t object       = order[slot];
+        slotBounds.minX[slot] = bounds.minX[object];
+        slotBounds.minY[slot] = bounds.minY[object];
+        slotBounds.minZ[slot] = bounds.minZ[object];
+        slotBounds.maxX[slot] = bounds.maxX[object];
+        slotBounds.maxY[slot] = bounds.maxY[object];
+        slotBounds.maxZ[slot] = bounds.maxZ[object];
+    }
+
+    // Children have higher indices than their parents, so a reverse sweep is bottom-up
+    for (size_t i = nodes.size(); i-- > 0;) {
+        RefitNode(nodes[i]);
+    }
+}
+
+void Bvh::RefitNode(Node& node) {
+    for (uint32_t k = 0; k < 4; ++k) {
+        Box box;
+        if (node.child[k] != Empty && node.count[k] > 0) {
+            for (uint32_t slot = node.child[k]; slot < node.child[k] + node.count[k]; ++slot) {
+                const float min[3] = {slotBounds.minX[slot],
+                                      slotBounds.minY[slot],
+                                      slotBounds.minZ[slot]};
+                const float max[3] = {slotBounds.maxX[slot],
+                                      slotBounds.maxY[slot],
+                                      slotBounds.maxZ[slot]};
+                box.Grow(min, max);
+            }
+        } else if (node.child[k] != Empty) {
+            const Node& child = nodes[node.child[k]];
+            for (uint32_t c = 0; c < 4; ++c) {
+                const float min[3] = {child.minX[c], child.minY[c], child.minZ[c]};
+                const float max[3] = {child.maxX[c], child.maxY[c], child.maxZ[c]};
+                box.Grow(min, max);
+            }
+        }
+        node.minX[k] = box.min[0];
+        node.minY[k] = box.min[1];
+        node.minZ[k] = box.min[2];
+        node.maxX[k] = box.max[0];
+        node.maxY[k] = box.max[1];
+        node.maxZ[k] = box.max[2];
+    }
+}
+
+float Bvh::GetCost() const {
+    // Expected Test4 calls for a query that overlaps the root (a child is tested when its
+    // parent's box is hit, in proportion to area), divided by the linear scan's count
+    if (nodes.empty()) {
+        return 0.0f;
+    }
+    Box root;
+    for (uint32_t k = 0; k < 4; ++k) {
+        const float min[3] = {nodes[0].minX[k], nodes[0].minY[k], nodes[0].minZ[k]};
+        const float max[3] = {nodes[0].maxX[k], nodes[0].maxY[k], nodes[0].maxZ[k]};
+        root.Grow(min, max);
+    }
+    const float rootArea = root.Area();
+    if (rootArea <= 0.0f) {
+        return 1.0f;
+    }
+
+    double tests = 1.0;
+    for (const Node& node : nodes) {
+        for (uint32_t k = 0; k < 4; ++k) {
+            Box box;
+            const float min[3] = {node.minX[k], node.minY[k], node.minZ[k]};
+            const float max[3] = {node.maxX[k], node.maxY[k], node.maxZ[k]};
+            box.Grow(min, max);
+            tests += box.Area() / rootArea;
+        }
+    }
+    return static_cast<float>(tests / ((order.size() + 3) / 4));
+}
+
+// ========================================
+// 3. CULLING
+// ========================================
+
+uint32_t Bvh::Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+    visible.resize(order.size());
+    if (nodes.empty()) {
+        return 0;
+    }
+    const FrustumTest test(frustum);
+    uint32_t* out = visible.data();
+    CullNode(test, 0, out);
+
+    visible.resize(out - visible.data());
+    return static_cast<uint32_t>(visible.size());
+}
+
+uint32_t Bvh::CullParallel(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+    const uint32_t taskCount = static_cast<uint32_t>(subtrees.size());
+    if (!parallelFor || taskCount < 2) {
+        return Cull(frustum, visible);
+    }
+
+    // Each subtree writes into its own slice of visible (sized for the worst case), then
+    // the slices are compacted in subtree order
+    const FrustumTest test(frustum);
+    std::vector<uint32_t> written(taskCount);
+    visible.resize(order.size());
+    parallelFor(taskCount, [&](uint32_t task) {
+        uint32_t* begin = visible.data() + nodeRanges[subtrees[task]].begin;
+        uint32_t* out   = begin;
+        CullNode(test, subtrees[task], out);
+        written[task] = static_cast<uint32_t>(out - begin);
+    });
+
+    uint32_t total = 0;
+    for (uint32_t task = 0; task < taskCount; ++task) {
+        const uint32_t* begin = visible.data() + nodeRanges[subtrees[task]].begin;
+        memmove(visible.data() + total, begin, written[task] * sizeof(uint32_t));
+        total += written[task];
+    }
+    visible.resize(total);
+    return total;
+}
+
+void Bvh::CullNode(const FrustumTest& test, uint32_t root, uint32_t*& out) const {
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(root);
+    while (!stack.empty()) {
+        const Node& node = nodes[stack.back()];
+        stack.pop_back();
+
+        const FrustumTest::Result result =
+            test.Test4(node.minX, node.minY, node.minZ, node.maxX, node.maxY, node.maxZ);
+        for (uint32_t k = 0; k < 4; ++k) {
+            if (!(result.visible & (1 << k))) {
+                continue; // Outside, or an empty slot
+            }
+            if (result.inside & (1 << k)) {
+                EmitAll(node.child[k], node.count[k], out);
+            } else if (node.count[k] > 0) {
+                EmitLeaf(test, node.child[k], node.count[k], out);
+            } else {
+                stack.push_back(node.child[k]);
+            }
+        }
+    }
+}
+
+void Bvh::EmitAll(uint32_t child, uint32_t count, uint32_t*& out) const {
+    // A subtree covers a contiguous run of slots, so this is one copy
+    Range range = count > 0 ? Range{child, child + count} : nodeRanges[child];
+    memcpy(out, order.data() + range.begin, (range.end - range.begin) * sizeof(uint32_t));
+    out += range.end - range.begin;
+}
+
+void Bvh::EmitLeaf(const FrustumTest& test, uint32_t first, uint32_t count, uint32_t*& out) const {
+    int mask = test.Test4(&slotBounds.minX[first],
+                          &slotBounds.minY[first],
+                          &slotBounds.minZ[first],
+                          &slotBounds.maxX[first],
+                          &slotBounds.maxY[first],
+                          &slotBounds.maxZ[first])
+                   .visible &
+               ((1 << count) - 1);
+    for (uint32_t lane = 0; mask != 0; ++lane, mask >>= 1) {
+        if (mask & 1) {
+            *out++ = order[first + lane];
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "Bounds.h"
+#include "Frustum.h"
+#include "threading/ParallelFor.h"
+#include <cstdint>
+#include <vector>
+
+// BVH Class
+// Four-wide bounding volume hierarchy over a BoundsArray, for frustum culling.
+// Every node stores the boxes of its four children in SoA form, so one FrustumTest::Test4
+// classifies all of them; leaves hold up to LeafSize objects whose boxes are kept in BVH
+// order, so a leaf is also tested with a single Test4. Children entirely inside the
+// frustum are emitted without testing anything below them.
+//
+// Build is a top-down binned SAH build (two binary splits per node). Moving objects are
+// handled by Refit, which copies the current boxes and recomputes node bounds bottom-up
+// in O(n) without changing the tree; when objects have moved far from where they were at
+// build time, GetCost() grows and a Build restores the quality.
+class Bvh {
+  public:
+    static constexpr uint32_t LeafSize = 4;  // Objects per leaf at most (one Test4)
+    static constexpr uint32_t BinCount = 16; // SAH bins per split
+    static constexpr uint32_t Empty    = ~0u;
+
+    // Install a parallel executor for CullParallel (default: serial)
+    void SetParallelFor(ParallelFor executor) {
+        parallelFor = std::move(executor);
+    }
+
+    // Build the hierarchy over every box in bounds
+    void Build(const BoundsArray& bounds);
+
+    // Take the current boxes of the same objects (same count) and update node bounds
+    void Refit(const BoundsArray& bounds);
+
+    /*
+    Collect the indices of the objects that may be visible
+    visible: Resized to hold exactly the visible object indices (order follows the tree)
+    Returns the number of visible objects
+    */
+    uint32_t Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+    // Cull with the top subtrees spread over the ParallelFor; same result set as Cull
+    uint32_t CullParallel(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+    /*
+    SAH cost of the tree for its current bounds, relative to testing every object (1.0)
+    Lower is better; compare against the value right after Build to decide on a rebuild
+    */
+    float GetCost() const;
+
+    uint32_t GetObjectCount() const {
+        return static_cast<uint32_t>(order.size());
+    }
+    uint32_t GetNodeCount() const {
+        return static_cast<uint32_t>(nodes.size());
+    }
+
+  private:
+    // Child slot k: count[k] == 0 and child[k] != Empty is an inner node, count[k] > 0 is a
+    // leaf of count[k] objects starting at slot child[k] of the BVH-order arrays
+    struct alignas(16) Node {
+        float minX[4], minY[4], minZ[4];
+        float maxX[4], maxY[4], maxZ[4];
+        uint32_t child[4];
+        uint32_t count[4];
+    };
+
+    // Contiguous range of BVH slots; every subtree covers one
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    std::vector<Node> nodes;        // nodes[0] is the root; children always follow parents
+    std::vector<Range> nodeRanges;  // Slots covered by each node's subtree
+    std::vector<uint32_t> order;    // BVH slot -> object index
+    BoundsArray slotBounds;         // Object boxes in BVH slot order, padded for Test4
+    std::vector<uint32_t> subtrees; // Inner nodes CullParallel hands out as tasks
+    ParallelFor parallelFor;
+
+    uint32_t BuildNode(const BoundsArray& bounds, Range range);
+    uint32_t Split(const BoundsArray& bounds, Range range); // Returns the first right slot
+    void FindSubtrees(uint32_t targetCount);
+    void RefitNode(Node& node);
+
+    void CullNode(const FrustumTest& test, uint32_t root, uint32_t*& out) const;
+    void EmitAll(uint32_t child, uint32_t count, uint32_t*& out) const;
+    void EmitLeaf(const FrustumTest& test, uint32_t first, uint32_t count, uint32_t*& out) const;
+};
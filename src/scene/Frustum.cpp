@@ -0,0 +1,140 @@
+#include "Frustum.h"
+#include <cmath>
+
+namespace {
+
+float PlaneDistance(const float plane[4], float x, float y, float z) {
+    return plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+}
+
+} // namespace
+
+// ========================================
+// 1. FRUSTUM
+// ========================================
+
+Frustum Frustum::FromViewProjection(const float m[16]) {
+    // Gribb/Hartmann: with clip = p * M, clip coordinate j is p dotted with column j of M,
+    // and each clip-space bound (-w <= x <= w, 0 <= z <= w, ...) is a plane in p
+    float column[4][4];
+    for (int j = 0; j < 4; ++j) {
+        for (int i = 0; i < 4; ++i) {
+            column[j][i] = m[i * 4 + j];
+        }
+    }
+
+    Frustum frustum;
+    for (int i = 0; i < 4; ++i) {
+        frustum.planes[Left][i]   = column[3][i] + column[0][i];
+        frustum.planes[Right][i]  = column[3][i] - column[0][i];
+        frustum.planes[Bottom][i] = column[3][i] + column[1][i];
+        frustum.planes[Top][i]    = column[3][i] - column[1][i];
+        frustum.planes[Near][i]   = column[2][i];
+        frustum.planes[Far][i]    = column[3][i] - column[2][i];
+    }
+
+    // Unit normals make the plane distances metric (not needed for the tests themselves)
+    for (float(&plane)[4] : frustum.planes) {
+        float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length > 0.0f) {
+            for (float& value : plane) {
+                value /= length;
+            }
+        }
+    }
+    return frustum;
+}
+
+bool Frustum::TestBox(const float min[3], const float max[3]) const {
+    for (const float(&plane)[4] : planes) {
+        float x = plane[0] >= 0.0f ? max[0] : min[0];
+        float y = plane[1] >= 0.0f ? max[1] : min[1];
+        float z = plane[2] >= 0.0f ? max[2] : min[2];
+        if (PlaneDistance(plane, x, y, z) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ========================================
+// 2. FOUR-WIDE TEST
+// ========================================
+
+FrustumTest::FrustumTest(const Frustum& frustum) : frustum(frustum) {
+#if FRUSTUM_SSE2
+    for (int p = 0; p < Frustum::PlaneCount; ++p) {
+        const float* plane      = frustum.planes[p];
+        simdPlanes[p].a         = _mm_set1_ps(plane[0]);
+        simdPlanes[p].b         = _mm_set1_ps(plane[1]);
+        simdPlanes[p].c         = _mm_set1_ps(plane[2]);
+        simdPlanes[p].d         = _mm_set1_ps(plane[3]);
+        simdPlanes[p].positiveX = plane[0] >= 0.0f;
+        simdPlanes[p].positiveY = plane[1] >= 0.0f;
+        simdPlanes[p].positiveZ = plane[2] >= 0.0f;
+    }
+#endif
+}
+
+#if !FRUSTUM_SSE2
+int FrustumTest::Classify(const float min[3], const float max[3]) const {
+    int result = 1;
+    for (const float(&plane)[4] : frustum.planes) {
+        bool positiveX = plane[0] >= 0.0f;
+        bool positiveY = plane[1] >= 0.0f;
+        bool positiveZ = plane[2] >= 0.0f;
+        float px       = positiveX ? max[0] : min[0];
+        float py       = positiveY ? max[1] : min[1];
+        float pz       = positiveZ ? max[2] : min[2];
+        if (PlaneDistance(plane, px, py, pz) < 0.0f) {
+            return -1;
+        }
+        float nx = positiveX ? min[0] : max[0];
+        float ny = positiveY ? min[1] : max[1];
+        float nz = positiveZ ? min[2] : max[2];
+        if (PlaneDistance(plane, nx, ny, nz) < 0.0f) {
+            result = 0;
+        }
+    }
+    return result;
+}
+#endif
+
+// ========================================
+// 3. LINEAR CULLING
+// ========================================
+
+uint32_t CullBoxes(const Frustum& frustum, const BoundsArray& bounds, uint32_t* visible) {
+    // The padding boxes are empty and always rejected, so whole groups of four are safe
+    const FrustumTest test(frustum);
+    const uint32_t count = bounds.Size();
+
+    uint32_t written = 0;
+    for (uint32_t i = 0; i < count; i += 4) {
+        int mask = test.Test4(&bounds.minX[i],
+                              &bounds.minY[i],
+                              &bounds.minZ[i],
+                              &bounds.maxX[i],
+                              &bounds.maxY[i],
+                              &bounds.maxZ[i])
+                       .visible;
+        for (int lane = 0; mask != 0; ++lane, mask >>= 1) {
+            if (mask & 1) {
+                visible[written++] = i + lane;
+            }
+        }
+    }
+    return written;
+}
+
+uint32_t CullBoxesScalar(const Frustum& frustum, const BoundsArray& bounds, uint32_t* visible) {
+    uint32_t written = 0;
+    for (uint32_t i = 0; i < bounds.Size(); ++i) {
+        const float min[3] = {bounds.minX[i], bounds.minY[i], bounds.minZ[i]};
+        const float max[3] = {bounds.maxX[i], bounds.maxY[i], bounds.maxZ[i]};
+        if (frustum.TestBox(min, max)) {
+            visible[written++] = i;
+        }
+    }
+    return written;
+}
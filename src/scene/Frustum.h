@@ -0,0 +1,125 @@
+#pragma once
+#include "Bounds.h"
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_SSE2 1
+#include <emmintrin.h>
+#else
+#define FRUSTUM_SSE2 0
+#endif
+
+// Frustum
+// Six inward-facing planes; a point p is inside plane (a, b, c, d) when a*x + b*y + c*z + d
+// >= 0. Boxes are tested against each plane with their "positive vertex" (the corner furthest
+// along the normal): the box is outside if that corner is behind any plane. The test is
+// conservative (large boxes near frustum corners can pass), and exact in one direction: a box
+// contained in another never passes when the outer one fails, which lets the BVH skip tests.
+struct Frustum {
+    enum Plane { Left, Right, Bottom, Top, Near, Far, PlaneCount };
+
+    float planes[PlaneCount][4];
+
+    /*
+    Extract the planes of a view-projection matrix
+    m: Row-major, row-vector convention (clip = p * M, as DirectXMath), depth in [0, w]
+    */
+    static Frustum FromViewProjection(const float m[16]);
+
+    // Scalar reference test of one box; true if it may be visible
+    bool TestBox(const float min[3], const float max[3]) const;
+};
+
+// Frustum Test
+// The planes broadcast into SIMD registers once per cull, plus which box corner each plane
+// reads (positive vertex per axis). Test4 classifies four boxes given in SoA form.
+class FrustumTest {
+  public:
+    // Bit k of visible: box k is not outside any plane; of inside: box k is inside all planes
+    struct Result {
+        int visible;
+        int inside;
+    };
+
+    explicit FrustumTest(const Frustum& frustum);
+
+    Result Test4(const float* minX,
+                 const float* minY,
+                 const float* minZ,
+                 const float* maxX,
+                 const float* maxY,
+                 const float* maxZ) const {
+#if FRUSTUM_SSE2
+        const __m128 lowX  = _mm_loadu_ps(minX);
+        const __m128 lowY  = _mm_loadu_ps(minY);
+        const __m128 lowZ  = _mm_loadu_ps(minZ);
+        const __m128 highX = _mm_loadu_ps(maxX);
+        const __m128 highY = _mm_loadu_ps(maxY);
+        const __m128 highZ = _mm_loadu_ps(maxZ);
+        const __m128 zero  = _mm_setzero_ps();
+
+        __m128 outside   = _mm_setzero_ps();
+        __m128 straddles = _mm_setzero_ps();
+        for (int p = 0; p < Frustum::PlaneCount; ++p) {
+            const PlaneSimd& plane = simdPlanes[p];
+
+            // Positive vertex decides outside, negative vertex decides fully inside
+            __m128 px = plane.positiveX ? highX : lowX;
+            __m128 py = plane.positiveY ? highY : lowY;
+            __m128 pz = plane.positiveZ ? highZ : lowZ;
+            __m128 nx = plane.positiveX ? lowX : highX;
+            __m128 ny = plane.positiveY ? lowY : highY;
+            __m128 nz = plane.positiveZ ? lowZ : highZ;
+
+            __m128 positive = Distance(plane, px, py, pz);
+            __m128 negative = Distance(plane, nx, ny, nz);
+            outside         = _mm_or_ps(outside, _mm_cmplt_ps(positive, zero));
+            straddles       = _mm_or_ps(straddles, _mm_cmplt_ps(negative, zero));
+        }
+        Result result;
+        result.visible = ~_mm_movemask_ps(outside) & 0xF;
+        result.inside  = result.visible & ~_mm_movemask_ps(straddles);
+        return result;
+#else
+        Result result = {0, 0};
+        for (int k = 0; k < 4; ++k) {
+            const float min[3] = {minX[k], minY[k], minZ[k]};
+            const float max[3] = {maxX[k], maxY[k], maxZ[k]};
+            int classification = Classify(min, max);
+            result.visible |= (classification >= 0) << k;
+            result.inside |= (classification > 0) << k;
+        }
+        return result;
+#endif
+    }
+
+  private:
+#if FRUSTUM_SSE2
+    struct PlaneSimd {
+        __m128 a, b, c, d;
+        bool positiveX, positiveY, positiveZ;
+    };
+
+    // Same evaluation order as Frustum::TestBox, so both agree bit for bit
+    static __m128 Distance(const PlaneSimd& plane, __m128 x, __m128 y, __m128 z) {
+        __m128 xy = _mm_add_ps(_mm_mul_ps(plane.a, x), _mm_mul_ps(plane.b, y));
+        return _mm_add_ps(_mm_add_ps(xy, _mm_mul_ps(plane.c, z)), plane.d);
+    }
+
+    PlaneSimd simdPlanes[Frustum::PlaneCount];
+#else
+    // -1 outside, 0 intersecting, 1 inside
+    int Classify(const float min[3], const float max[3]) const;
+#endif
+    Frustum frustum;
+};
+
+/*
+Linear culling over a whole BoundsArray (no hierarchy)
+visible: Receives the indices of the boxes that pass, in increasing order (room for
+bounds.Size()); returns how many were written
+*/
+uint32_t CullBoxes(const Frustum& frustum, const BoundsArray& bounds, uint32_t* visible);
+
+// Scalar reference of CullBoxes
+uint32_t CullBoxesScalar(const Frustum& frustum, const BoundsArray& bounds, uint32_t* visible);
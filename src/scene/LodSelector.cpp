@@ -0,0 +1,81 @@
+#include "LodSelector.h"
+#include <algorithm>
+#include <cmath>
+
+uint32_t LodSelector::AddChain(const float* levelErrors, uint32_t levelCount) {
+    const uint32_t id = static_cast<uint32_t>(chains.size());
+    chains.push_back({static_cast<uint32_t>(errors.size()), levelCount});
+    errors.insert(errors.end(), levelErrors, levelErrors + levelCount);
+    return id;
+}
+
+void LodSelector::Clear() {
+    errors.clear();
+    chains.clear();
+}
+
+void LodSelector::SetProjection(float fovY, float viewportHeight, float newNearZ) {
+    projectionScale = viewportHeight / (2.0f * std::tan(0.5f * fovY));
+    nearZ           = std::max(newNearZ, 1e-6f);
+}
+
+void LodSelector::SetCamera(const float position[3]) {
+    camera[0] = position[0];
+    camera[1] = position[1];
+    camera[2] = position[2];
+}
+
+void LodSelector::SetThreshold(float pixels) {
+    threshold = pixels;
+}
+
+void LodSelector::SetHysteresis(float fraction) {
+    hysteresis = std::min(std::max(fraction, 0.0f), 1.0f);
+}
+
+float LodSelector::PixelsPerUnit(const Object& object) const {
+    const float dx       = object.center[0] - camera[0];
+    const float dy       = object.center[1] - camera[1];
+    const float dz       = object.center[2] - camera[2];
+    const float distance = std::sqrt(dx * dx + dy * dy + dz * dz) - object.radius;
+    return object.scale * projectionScale / std::max(distance, nearZ);
+}
+
+float LodSelector::ProjectedError(const Object& object, uint32_t level) const {
+    return GetError(object.chain, level) * PixelsPerUnit(object);
+}
+
+uint32_t LodSelector::Select(Object* objects, uint32_t count) const {
+    // Errors are compared in model units: the pixel limits divided by the object's pixels
+    // per unit, one division per object instead of one per level
+    uint32_t changes = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        Object& object = objects[i];
+        if (object.chain == InvalidChain || chains[object.chain].count == 0) {
+            continue;
+        }
+        const Chain& chain   = chains[object.chain];
+        const float* levels  = errors.data() + chain.start;
+        const float perUnit  = PixelsPerUnit(object);
+        const float limit    = threshold / perUnit;
+        const float coarsen  = limit * (1.0f - hysteresis);
+        const uint32_t last  = chain.count - 1;
+        const uint32_t start = std::min(object.lod, last);
+
+        uint32_t lod = start;
+        if (levels[lod] > limit) {
+            // Too coarse: the coarsest level that fits, at once
+            while (lod > 0 && levels[lod] > limit) {
+                --lod;
+            }
+        } else {
+            // Fits: move coarser only past the hysteresis band
+            while (lod < last && levels[lod + 1] <= coarsen) {
+                ++lod;
+            }
+        }
+        changes += lod != object.lod;
+        object.lod = lod;
+    }
+    return changes;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// LOD Selector Class
+// Picks each object's level of detail from the screen-space size of its simplification
+// error: a level with model-space error e, on an object of world scale s whose bounding
+// sphere is d units from the camera, is off by about e * s * projectionScale / d pixels,
+// where projectionScale = viewportHeight / (2 * tan(fovY / 2)). Select takes the coarsest
+// level within the pixel threshold.
+//
+// Hysteresis keeps objects near a switching distance from popping back and forth: a level
+// becomes too coarse as soon as its error passes the threshold, but an object only moves to
+// a coarser level once that level is below threshold * (1 - hysteresis). The distance is
+// measured to the sphere's surface and clamped to nearZ, so a camera inside the sphere sees
+// the object as nearZ away.
+//
+// Level 0 is the mesh itself; level l > 0 is MeshFile::Lod lodStart + l - 1 of its submesh.
+class LodSelector {
+  public:
+    static constexpr uint32_t InvalidChain = ~0u;
+
+    // One object to select for; lod is its current level, updated in place
+    struct Object {
+        float center[3]; // World-space bounding sphere
+        float radius;
+        float scale; // World units per model unit (the largest axis scale)
+        uint32_t chain;
+        uint32_t lod;
+    };
+
+    /*
+    Register the errors of one mesh's levels (model units, finest first; see MeshFile::Lod)
+    The errors are expected to grow along the chain. Returns the chain id for Object::chain
+    */
+    uint32_t AddChain(const float* errors, uint32_t levelCount);
+
+    // Remove every chain
+    void Clear();
+
+    /*
+    Set the camera projection
+    fovY: Vertical field of view in radians
+    viewportHeight: In pixels
+    */
+    void SetProjection(float fovY, float viewportHeight, float nearZ);
+
+    void SetCamera(const float position[3]);
+
+    // Largest tolerated error in pixels (default 1)
+    void SetThreshold(float pixels);
+
+    // Fraction of the threshold an object must drop below to move coarser (default 0.25)
+    void SetHysteresis(float fraction);
+
+    // Update every object's lod; returns how many changed
+    uint32_t Select(Object* objects, uint32_t count) const;
+
+    // Projected error in pixels of the given level of an object
+    float ProjectedError(const Object& object, uint32_t level) const;
+
+    uint32_t GetLevelCount(uint32_t chain) const {
+        return chains[chain].count;
+    }
+    float GetError(uint32_t chain, uint32_t level) const {
+        return errors[chains[chain].start + level];
+    }
+
+  private:
+    struct Chain {
+        uint32_t start;
+        uint32_t count;
+    };
+
+    // Pixels per model unit of error for an object: scale * projectionScale / distance
+    float PixelsPerUnit(const Object& object) const;
+
+    std::vector<float> errors;
+    std::vector<Chain> chains;
+    float camera[3]       = {0.0f, 0.0f, 0.0f};
+    float projectionScale = 1.0f;
+    float nearZ           = 0.1f;
+    float threshold       = 1.0f;
+    float hysteresis      = 0.25f;
+};
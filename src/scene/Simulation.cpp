@@ -0,0 +1,152 @@
+#include "Simulation.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr float Pi = 3.14159265f;
+
+// Windows virtual-key codes of the arrow keys, in Step's key bit order
+constexpr uint32_t ArrowKeys[] = {0x25, 0x26, 0x27, 0x28}; // VK_LEFT, VK_UP, VK_RIGHT, VK_DOWN
+
+float WrapAngle(float angle) {
+    return angle - 2.0f * Pi * std::floor((angle + Pi) / (2.0f * Pi));
+}
+
+} // namespace
+
+SceneState SceneState::Lerp(const SceneState& a, const SceneState& b, float t) {
+    SceneState result;
+    result.position[0] = a.position[0] + (b.position[0] - a.position[0]) * t;
+    result.position[1] = a.position[1] + (b.position[1] - a.position[1]) * t;
+    result.angle       = WrapAngle(a.angle + WrapAngle(b.angle - a.angle) * t);
+    return result;
+}
+
+Simulation::Simulation(PacingClock* clock) : clock(clock) {
+    if (!this->clock) {
+        ownedClock  = PacingClock::CreateSystemClock();
+        this->clock = ownedClock.get();
+    }
+}
+
+Simulation::~Simulation() {
+    Stop();
+}
+
+// ========================================
+// 1. THREAD
+// ========================================
+
+bool Simulation::Start(double tickRate) {
+    if (running.load() || tickRate <= 0.0) {
+        return false;
+    }
+    period = std::llround(1e9 / tickRate);
+    running.store(true);
+    thread = std::thread(&Simulation::Run, this);
+    return true;
+}
+
+void Simulation::Stop() {
+    running.store(false);
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void Simulation::Run() {
+    uint64_t tick = 0;
+    int64_t due   = clock->Now();
+    while (running.load(std::memory_order_relaxed)) {
+        Tick(due, ++tick);
+        due += period;
+
+        // Behind schedule: run the next tick at once. Far behind (a debugger break, a
+        // suspended laptop): drop the backlog rather than simulate it at full speed
+        int64_t now = clock->Now();
+        if (now - due > static_cast<int64_t>(MaxCatchUp) * period) {
+            int64_t behind = (now - due) / period;
+            skipped.fetch_add(static_cast<uint64_t>(behind), std::memory_order_relaxed);
+            due += behind * period;
+        }
+        if (due > now) {
+            clock->Sleep(due - now);
+        }
+    }
+}
+
+// ========================================
+// 2. TICK
+// ========================================
+
+void Simulation::Tick(int64_t tickTime, uint64_t tick) {
+    // Apply every input received so far; key state is held between ticks
+    int64_t inputTime = 0;
+    InputEvent event;
+    while (inputQueue.Pop(event)) {
+        for (uint32_t bit = 0; bit < 4; ++bit) {
+            if (event.key == ArrowKeys[bit]) {
+                const uint32_t mask = 1u << bit;
+                keys = event.type == InputEvent::KeyDown ? keys | mask : keys & ~mask;
+            }
+        }
+        inputs.fetch_add(1, std::memory_order_relaxed);
+        if (event.time == 0) {
+            continue; // Not time-stamped
+        }
+        inputTime = std::max(inputTime, event.time);
+
+        int64_t wait = clock->Now() - event.time;
+        if (wait > maxInputWait.load(std::memory_order_relaxed)) {
+            maxInputWait.store(wait, std::memory_order_relaxed);
+        }
+    }
+
+    SceneSnapshot& snapshot = snapshots.GetWriteBuffer();
+    snapshot.previous       = state;
+    Step(state, keys, static_cast<float>(static_cast<double>(period) * 1e-9));
+    snapshot.current   = state;
+    snapshot.tick      = tick;
+    snapshot.tickTime  = tickTime;
+    snapshot.inputTime = inputTime;
+    snapshots.Publish();
+
+    ticks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Simulation::Step(SceneState& state, uint32_t keys, float dt) {
+    // Arrow keys move the triangle, clamped to stay on screen; it spins on its own
+    const int dx      = static_cast<int>((keys >> 2) & 1) - static_cast<int>(keys & 1);
+    const int dy      = static_cast<int>((keys >> 1) & 1) - static_cast<int>((keys >> 3) & 1);
+    state.position[0] = std::clamp(state.position[0] + dx * MoveSpeed * dt, -1.0f, 1.0f);
+    state.position[1] = std::clamp(state.position[1] + dy * MoveSpeed * dt, -1.0f, 1.0f);
+    state.angle       = WrapAngle(state.angle + SpinSpeed * dt);
+}
+
+// ========================================
+// 3. RENDER THREAD
+// ========================================
+
+SceneState Simulation::Sample() {
+    snapshots.Update();
+    const SceneSnapshot& snapshot = snapshots.GetReadBuffer();
+    if (snapshot.tick == 0 || period == 0) {
+        return snapshot.current;
+    }
+
+    // How far into the tick after the newest one we are; past a whole tick the simulation
+    // is late and the newest state is the best there is
+    const int64_t since = clock->Now() - snapshot.tickTime;
+    const double t      = std::clamp(static_cast<double>(since) / period, 0.0, 1.0);
+    return SceneState::Lerp(snapshot.previous, snapshot.current, static_cast<float>(t));
+}
+
+Simulation::Stats Simulation::GetStats() const {
+    Stats stats;
+    stats.ticks        = ticks.load(std::memory_order_relaxed);
+    stats.skipped      = skipped.load(std::memory_order_relaxed);
+    stats.inputs       = inputs.load(std::memory_order_relaxed);
+    stats.maxInputWait = maxInputWait.load(std::memory_order_relaxed);
+    return stats;
+}
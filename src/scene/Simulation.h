@@ -0,0 +1,127 @@
+#pragma once
+#include "render/FramePacer.h"
+#include "threading/SpscQueue.h"
+#include "threading/TripleBuffer.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// Input Event
+// Key transition forwarded from the window thread to the simulation thread
+struct InputEvent {
+    enum Type : uint32_t { KeyDown = 0, KeyUp };
+
+    Type type    = KeyDown;
+    uint32_t key = 0; // Windows virtual-key code
+    int64_t time = 0; // Receive time on the system PacingClock (steady_clock ns), 0 = none
+};
+
+// Events the window may queue before the simulation drains them; later ones are dropped
+using InputQueue = SpscQueue<InputEvent, 256>;
+
+// Render-relevant state of one simulation tick
+struct SceneState {
+    float position[2] = {0.0f, 0.0f}; // Triangle offset in clip space
+    float angle       = 0.0f;         // Rotation about the view axis, radians in [-pi, pi)
+
+    // State between a (t = 0) and b (t = 1); the angle takes the short way round
+    static SceneState Lerp(const SceneState& a, const SceneState& b, float t);
+};
+
+// What the simulation publishes each tick: the last two states, so the renderer can
+// interpolate between them without keeping history of its own
+struct SceneSnapshot {
+    SceneState previous;
+    SceneState current;
+    uint64_t tick     = 0; // 0 = nothing simulated yet
+    int64_t tickTime  = 0; // Clock time the current tick was due
+    int64_t inputTime = 0; // Receive time of the newest input event the tick applied
+};
+
+// Simulation Class
+// Fixed-timestep simulation on its own thread. Every tick drains the input queue, advances
+// the scene by exactly 1 / tickRate seconds and publishes a SceneSnapshot through a triple
+// buffer, so neither the window thread (input) nor the render thread (Sample) ever waits
+// for it, and it never waits for them. Ticks that fall behind run back to back; after a
+// stall of more than MaxCatchUp ticks the schedule restarts instead.
+//
+// The renderer draws one tick in the past: Sample() interpolates between the two latest
+// ticks by how far the current time is past the newest one.
+class Simulation {
+  public:
+    static constexpr uint32_t MaxCatchUp = 8;
+
+    // Clip-space units per second while an arrow key is held, radians per second spin
+    static constexpr float MoveSpeed = 1.0f;
+    static constexpr float SpinSpeed = 1.0f;
+
+    // Totals since Start
+    struct Stats {
+        uint64_t ticks       = 0;
+        uint64_t skipped     = 0; // Ticks given up by the catch-up limit
+        uint64_t inputs      = 0; // Events applied
+        int64_t maxInputWait = 0; // Longest receive-to-apply delay, nanoseconds
+    };
+
+    // clock: Time source, not owned; nullptr uses the system clock
+    explicit Simulation(PacingClock* clock = nullptr);
+    ~Simulation();
+
+    Simulation(const Simulation&)            = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    // Start ticking tickRate times per second on a new thread
+    bool Start(double tickRate);
+
+    // Stop and join the thread; the last snapshot stays readable
+    void Stop();
+
+    // Window thread only: the queue Window forwards key events into
+    InputQueue& GetInputQueue() {
+        return inputQueue;
+    }
+
+    /*
+    Render thread only: the scene interpolated for the current time
+    Between the two latest ticks, so what is drawn trails the simulation by one tick
+    */
+    SceneState Sample();
+
+    // Render thread only: the snapshot the last Sample used
+    const SceneSnapshot& GetSnapshot() const {
+        return snapshots.GetReadBuffer();
+    }
+
+    // Read after Stop (or approximately while running)
+    Stats GetStats() const;
+
+    /*
+    Advance state by dt seconds with keys held (bit 0-3: left, up, right, down)
+    The whole simulation, separate from the threading so it can be run directly
+    */
+    static void Step(SceneState& state, uint32_t keys, float dt);
+
+  private:
+    std::unique_ptr<PacingClock> ownedClock;
+    PacingClock* clock = nullptr;
+    int64_t period     = 0; // Nanoseconds per tick
+
+    std::thread thread;
+    std::atomic<bool> running{false};
+
+    InputQueue inputQueue;                 // Window thread -> simulation thread
+    TripleBuffer<SceneSnapshot> snapshots; // Simulation thread -> render thread
+
+    // Simulation thread state
+    SceneState state;
+    uint32_t keys = 0;
+
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<uint64_t> skipped{0};
+    std::atomic<uint64_t> inputs{0};
+    std::atomic<int64_t> maxInputWait{0};
+
+    void Run();
+    void Tick(int64_t tickTime, uint64_t tick);
+};
@@ -0,0 +1,267 @@
+#include "TransformHierarchy.h"
+#include <algorithm>
+
+void TransformHierarchy::Clear() {
+    nodeParent.clear();
+    nodeSlot.clear();
+    parent.clear();
+    subtreeEnd.clear();
+    slotNode.clear();
+    local.clear();
+    world.clear();
+    marked.clear();
+    dirty.clear();
+    changed.clear();
+    layoutDirty = false;
+    relayout    = false;
+}
+
+void TransformHierarchy::Reserve(uint32_t nodeCount) {
+    nodeParent.reserve(nodeCount);
+    nodeSlot.reserve(nodeCount);
+    parent.reserve(nodeCount);
+    subtreeEnd.reserve(nodeCount);
+    slotNode.reserve(nodeCount);
+    local.reserve(nodeCount);
+    world.reserve(nodeCount);
+    marked.reserve(nodeCount);
+}
+
+uint32_t TransformHierarchy::AddNode(uint32_t parentNode, const Float4x4& localMatrix) {
+    const uint32_t node = static_cast<uint32_t>(nodeParent.size());
+    if (parentNode != InvalidNode && parentNode >= node) {
+        return InvalidNode; // Parents must exist first, which also rules out cycles
+    }
+
+    // Appended at the end for now; the next Update moves it into its parent's subtree
+    const uint32_t slot = static_cast<uint32_t>(parent.size());
+    nodeParent.push_back(parentNode);
+    nodeSlot.push_back(slot);
+    parent.push_back(parentNode == InvalidNode ? InvalidNode : nodeSlot[parentNode]);
+    subtreeEnd.push_back(slot + 1);
+    slotNode.push_back(node);
+    local.push_back(localMatrix);
+    world.push_back(Float4x4::Identity());
+    marked.push_back(0);
+    layoutDirty = true;
+    return node;
+}
+
+void TransformHierarchy::SetLocal(uint32_t node, const Float4x4& localMatrix) {
+    const uint32_t slot = nodeSlot[node];
+    local[slot]         = localMatrix;
+    if (!marked[slot]) {
+        marked[slot] = 1;
+        dirty.push_back(slot);
+    }
+}
+
+uint32_t TransformHierarchy::Update() {
+    const uint32_t count = static_cast<uint32_t>(parent.size());
+    changed.clear();
+    relayout = false;
+
+    // ========================================
+    // 1. CHANGE LIST
+    // ========================================
+    // Marked slots become the subtrees below them; a marked slot inside an earlier subtree
+    // is already covered, and touching subtrees are merged. Past a sixteenth of the nodes
+    // a scan of the flags is cheaper than sorting the marks
+    if (layoutDirty) {
+        Relayout();
+        std::fill(marked.begin(), marked.end(), uint8_t(0));
+        if (count > 0) {
+            changed.push_back(Range{0, count});
+        }
+        relayout    = true;
+        layoutDirty = false;
+    } else {
+        auto add = [this](uint32_t slot) {
+            if (!changed.empty() && slot < changed.back().end) {
+                return;
+            }
+            if (!changed.empty() && slot == changed.back().end) {
+                changed.back().end = subtreeEnd[slot];
+            } else {
+                changed.push_back(Range{slot, subtreeEnd[slot]});
+            }
+        };
+        if (dirty.size() > count / 16) {
+            for (uint32_t slot = 0; slot < count; ++slot) {
+                if (marked[slot]) {
+                    marked[slot] = 0;
+                    add(slot);
+                }
+            }
+        } else {
+            std::sort(dirty.begin(), dirty.end());
+            for (uint32_t slot : dirty) {
+                marked[slot] = 0;
+                add(slot);
+            }
+        }
+    }
+    dirty.clear();
+
+    // ========================================
+    // 2. SPLIT INTO TASKS
+    // ========================================
+    // Ranges above TaskSize are broken into child subtrees (their roots are computed here,
+    // so every piece starts below a final world matrix); the pieces are then grouped into
+    // tasks of about TaskSize nodes
+    work.clear();
+    uint32_t total = 0;
+    for (const Range& range : changed) {
+        SplitRange(range);
+        total += range.end - range.begin;
+    }
+
+    groups.clear();
+    uint32_t nodes = TaskSize;
+    for (uint32_t i = 0; i < work.size(); ++i) {
+        if (nodes >= TaskSize) {
+            groups.push_back(i);
+            nodes = 0;
+        }
+        nodes += work[i].end - work[i].begin;
+    }
+    groups.push_back(static_cast<uint32_t>(work.size()));
+
+    // ========================================
+    // 3. WORLD MATRICES
+    // ========================================
+    const uint32_t taskCount = static_cast<uint32_t>(groups.size()) - 1;
+
+    auto task = [this](uint32_t group) {
+        for (uint32_t i = groups[group]; i < groups[group + 1]; ++i) {
+            UpdateRange(work[i]);
+        }
+    };
+    if (!parallelFor || taskCount < 2) {
+        for (uint32_t group = 0; group < taskCount; ++group) {
+            task(group);
+        }
+    } else {
+        parallelFor(taskCount, task);
+    }
+    return total;
+}
+
+void TransformHierarchy::Relayout() {
+    const uint32_t count = static_cast<uint32_t>(nodeParent.size());
+
+    // ========================================
+    // 1. CHILD LISTS
+    // ========================================
+    // Counting sort by parent id; children keep their id order
+    std::vector<uint32_t> firstChild(count + 1, 0);
+    for (uint32_t node = 0; node < count; ++node) {
+        if (nodeParent[node] != InvalidNode) {
+            ++firstChild[nodeParent[node] + 1];
+        }
+    }
+    for (uint32_t node = 0; node < count; ++node) {
+        firstChild[node + 1] += firstChild[node];
+    }
+    std::vector<uint32_t> children(firstChild[count]);
+    std::vector<uint32_t> fill(firstChild.begin(), firstChild.end() - 1);
+    for (uint32_t node = 0; node < count; ++node) {
+        if (nodeParent[node] != InvalidNode) {
+            children[fill[nodeParent[node]]++] = node;
+        }
+    }
+
+    // ========================================
+    // 2. DEPTH-FIRST ORDER
+    // ========================================
+    // Roots in id order, each followed by its subtree; locals move with their nodes
+    std::vector<Float4x4> oldLocal(local.begin(), local.end());
+    std::vector<uint32_t> oldSlot(nodeSlot.begin(), nodeSlot.end());
+    uint32_t next = 0;
+    stack.clear();
+    for (uint32_t root = 0; root < count; ++root) {
+        if (nodeParent[root] != InvalidNode) {
+            continue;
+        }
+        stack.push_back(root);
+        while (!stack.empty()) {
+            const uint32_t node = stack.back();
+            stack.pop_back();
+            nodeSlot[node] = next;
+            slotNode[next] = node;
+            local[next]    = oldLocal[oldSlot[node]];
+            ++next;
+            for (uint32_t i = firstChild[node + 1]; i > firstChild[node]; --i) {
+                stack.push_back(children[i - 1]);
+            }
+        }
+    }
+
+    // ========================================
+    // 3. PARENT SLOTS AND SUBTREE EXTENTS
+    // ========================================
+    // Children follow their parents, so one backward pass accumulates subtree sizes
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        const uint32_t parentNode = nodeParent[slotNode[slot]];
+        parent[slot]              = parentNode == InvalidNode ? InvalidNode : nodeSlot[parentNode];
+        subtreeEnd[slot]          = 1;
+    }
+    for (uint32_t slot = count; slot-- > 0;) {
+        if (parent[slot] != InvalidNode) {
+            subtreeEnd[parent[slot]] += subtreeEnd[slot];
+        }
+    }
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        subtreeEnd[slot] += slot;
+    }
+}
+
+void TransformHierarchy::SplitRange(Range range) {
+    // Adjacent pieces are merged back while they stay under TaskSize, so a parent with
+    // thousands of leaf children does not become thousands of one-node ranges
+    auto emit = [this](Range piece) {
+        if (!work.empty() && work.back().end == piece.begin &&
+            piece.end - work.back().begin <= TaskSize) {
+            work.back().end = piece.end;
+        } else {
+            work.push_back(piece);
+        }
+    };
+
+    // A changed range is a run of whole subtrees whose parents are outside it; subtrees are
+    // only found front to back, so they are reversed onto the stack to pop in slot order
+    stack.clear();
+    for (uint32_t slot = range.begin; slot < range.end; slot = subtreeEnd[slot]) {
+        stack.push_back(slot);
+    }
+    std::reverse(stack.begin(), stack.end());
+
+    while (!stack.empty()) {
+        const uint32_t root = stack.back();
+        stack.pop_back();
+        const uint32_t end = subtreeEnd[root];
+        if (end - root <= TaskSize) {
+            emit(Range{root, end});
+            continue;
+        }
+
+        // Too big for one task: finish the root here and hand out its children
+        UpdateRange(Range{root, root + 1});
+        const size_t mark = stack.size();
+        for (uint32_t child = root + 1; child < end; child = subtreeEnd[child]) {
+            stack.push_back(child);
+        }
+        std::reverse(stack.begin() + static_cast<std::ptrdiff_t>(mark), stack.end());
+    }
+}
+
+void TransformHierarchy::UpdateRange(Range range) {
+    for (uint32_t slot = range.begin; slot < range.end; ++slot) {
+        const uint32_t parentSlot = parent[slot];
+        if (parentSlot == InvalidNode) {
+            world[slot] = local[slot];
+        } else {
+            world[slot] = Float4x4::Multiply(local[slot], world[parentSlot]);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "render/MatrixBatch.h"
+#include "threading/ParallelFor.h"
+#include <cstdint>
+#include <vector>
+
+// Transform Hierarchy Class
+// Parent-relative transforms of many nodes and their world matrices, stored as flat arrays
+// in depth-first order instead of a tree of node objects: every subtree is one contiguous
+// range of slots [slot, subtreeEnd[slot]) and every parent comes before its children, so a
+// world update is a forward pass world = local * world[parent] over a few ranges.
+//
+// Nodes keep the id AddNode returned; slots are internal and change when nodes are added
+// (the layout is rebuilt by the next Update). SetLocal only marks the node; Update merges
+// the marked subtrees into ranges, recomputes those alone and reports them as the change
+// list, so the renderer can upload just the world matrices that moved. Large ranges are
+// split into independent subtrees for a ParallelFor.
+class TransformHierarchy {
+  public:
+    static constexpr uint32_t InvalidNode = ~0u;
+
+    // Nodes per parallel task at least; smaller updates run on the calling thread
+    static constexpr uint32_t TaskSize = 8192;
+
+    // Slots [begin, end) whose world matrices were recomputed
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    // Install a parallel executor (default: serial)
+    void SetParallelFor(ParallelFor executor) {
+        parallelFor = std::move(executor);
+    }
+
+    // Remove every node
+    void Clear();
+    void Reserve(uint32_t nodeCount);
+
+    /*
+    Add a node below parent (InvalidNode for a root); returns its id
+    Ids are dense and never change; the node's world matrix is valid after the next Update
+    */
+    uint32_t AddNode(uint32_t parent, const Float4x4& local = Float4x4::Identity());
+
+    // Replace a node's parent-relative transform; its subtree is recomputed by Update
+    void SetLocal(uint32_t node, const Float4x4& local);
+
+    /*
+    Recompute the world matrices of every subtree changed since the last Update
+    Returns the number of nodes recomputed; GetChangedRanges lists them
+    */
+    uint32_t Update();
+
+    // Change list of the last Update, in slot order and disjoint
+    const std::vector<Range>& GetChangedRanges() const {
+        return changed;
+    }
+
+    // True if the last Update rebuilt the layout: every slot moved, upload them all
+    bool WasRelayout() const {
+        return relayout;
+    }
+
+    const Float4x4& GetLocal(uint32_t node) const {
+        return local[nodeSlot[node]];
+    }
+    const Float4x4& GetWorld(uint32_t node) const {
+        return world[nodeSlot[node]];
+    }
+    uint32_t GetParent(uint32_t node) const {
+        return nodeParent[node];
+    }
+
+    // Slot-ordered world matrices, for uploading the change list (valid after Update)
+    const Float4x4* GetWorlds() const {
+        return world.data();
+    }
+    uint32_t GetSlot(uint32_t node) const {
+        return nodeSlot[node];
+    }
+    uint32_t GetSlotNode(uint32_t slot) const {
+        return slotNode[slot];
+    }
+
+    uint32_t GetNodeCount() const {
+        return static_cast<uint32_t>(nodeParent.size());
+    }
+
+  private:
+    // Per node id
+    std::vector<uint32_t> nodeParent; // Parent id, InvalidNode for roots
+    std::vector<uint32_t> nodeSlot;   // Current slot
+
+    // Per slot (depth-first order)
+    std::vector<uint32_t> parent;     // Parent slot, InvalidNode for roots
+    std::vector<uint32_t> subtreeEnd; // One past the last slot of the subtree
+    std::vector<uint32_t> slotNode;   // Node id
+    std::vector<Float4x4> local;
+    std::vector<Float4x4> world;
+    std::vector<uint8_t> marked; // SetLocal since the last Update
+
+    std::vector<uint32_t> dirty;  // Marked slots, unsorted
+    std::vector<Range> changed;   // Merged subtrees of the last Update
+    std::vector<Range> work;      // Subtrees whose parent world is final, in slot order
+    std::vector<uint32_t> groups; // First work range of each task, plus the end
+    std::vector<uint32_t> stack;  // Scratch for splitting large subtrees
+    bool layoutDirty = false;     // Nodes added since the last Update
+    bool relayout    = false;
+    ParallelFor parallelFor;
+
+    void Relayout();
+    void SplitRange(Range range);
+    void UpdateRange(Range range);
+};
@@ -0,0 +1,355 @@
+#include "JobSystem.h"
+#include "utils/Profiler.h"
+#include <algorithm>
+#include <string>
+
+namespace {
+
+// Worker identity of the calling thread; a thread belongs to at most one JobSystem
+thread_local const JobSystem* currentSystem = nullptr;
+thread_local int32_t currentIndex           = -1;
+
+// Spins (with yields) an idle worker does before going to sleep
+constexpr uint32_t IdleSpins = 64;
+
+void RunRange(const Job& job) {
+    using RangeFunction = JobSystem::RangeFunction;
+    (*static_cast<const RangeFunction*>(job.data))(job.begin, job.end);
+}
+
+} // namespace
+
+JobSystem::JobSystem() : injectedCount(0), queuedJobs(0), sleepers(0), quit(false) {}
+
+JobSystem::~JobSystem() {
+    Shutdown();
+}
+
+// ========================================
+// 1. STARTUP AND SHUTDOWN
+// ========================================
+
+bool JobSystem::Initialize(uint32_t threadCount) {
+    Shutdown();
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    quit.store(false, std::memory_order_relaxed);
+    workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+        workers.back()->random = 0x9E3779B9u * (i + 1);
+    }
+
+    // The caller becomes worker 0 and runs jobs whenever it waits
+    currentSystem = this;
+    currentIndex  = 0;
+
+    threads.reserve(threadCount - 1);
+    for (uint32_t i = 1; i < threadCount; ++i) {
+        threads.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+    return true;
+}
+
+void JobSystem::Shutdown() {
+    if (workers.empty()) {
+        return;
+    }
+
+    // Drain whatever is still queued, then stop the workers
+    if (CurrentWorker() >= 0) {
+        while (TryRunOne(CurrentWorker())) {
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        quit.store(true, std::memory_order_seq_cst);
+    }
+    sleepWake.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    workers.clear();
+
+    if (currentSystem == this) {
+        currentSystem = nullptr;
+        currentIndex  = -1;
+    }
+}
+
+void JobSystem::WorkerLoop(uint32_t index) {
+    currentSystem = this;
+    currentIndex  = static_cast<int32_t>(index);
+    PROFILE_THREAD_NAME(("Job Worker " + std::to_string(index)).c_str());
+
+    uint32_t idle = 0;
+    while (!quit.load(std::memory_order_relaxed)) {
+        if (TryRunOne(currentIndex)) {
+            idle = 0;
+            continue;
+        }
+        if (++idle < IdleSpins) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Nothing to run or steal: sleep until something is queued
+        // sleepers and queuedJobs are both seq_cst, so either this thread sees the new job
+        // or the pusher sees this sleeper and notifies
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        sleepWake.wait(lock, [this] {
+            return quit.load(std::memory_order_seq_cst) ||
+                   queuedJobs.load(std::memory_order_seq_cst) > 0;
+        });
+        sleepers.fetch_sub(1, std::memory_order_seq_cst);
+        idle = 0;
+    }
+}
+
+int32_t JobSystem::CurrentWorker() const {
+    return currentSystem == this ? currentIndex : -1;
+}
+
+// ========================================
+// 2. SUBMISSION
+// ========================================
+
+void JobSystem::Run(JobFunction function,
+                    void* data,
+                    uint32_t begin,
+                    uint32_t end,
+                    JobCounter* counter,
+                    JobCounter* dependency) {
+    Job job;
+    job.function = function;
+    job.data     = data;
+    job.begin    = begin;
+    job.end      = end;
+    job.counter  = counter;
+
+    if (counter) {
+        counter->value.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // Park the job on its dependency; Finish() pushes it once the dependency hits zero.
+    // Both sides hold waitingMutex, so a job is either parked before the release or sees zero.
+    if (dependency) {
+        std::lock_guard<std::mutex> lock(dependency->waitingMutex);
+        if (dependency->value.load(std::memory_order_acquire) != 0) {
+            dependency->waiting.push_back(job);
+            return;
+        }
+    }
+    Push(job);
+}
+
+void JobSystem::Push(const Job& job) {
+    int32_t worker = CurrentWorker();
+    if (worker >= 0) {
+        if (!workers[worker]->queue.Push(job)) {
+            // Deque full: running inline keeps submission wait-free and bounded
+            workers[worker]->inlined.fetch_add(1, std::memory_order_relaxed);
+            Execute(job);
+            return;
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(injectMutex);
+        injected.push_back(job);
+        injectedCount.fetch_add(1, std::memory_order_release);
+    }
+    queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+    WakeWorkers(1);
+}
+
+void JobSystem::WakeWorkers(uint32_t count) {
+    if (sleepers.load(std::memory_order_seq_cst) == 0) {
+        return;
+    }
+    {
+        // Pairs with the predicate check in WorkerLoop so the wake cannot be lost
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    if (count == 1) {
+        sleepWake.notify_one();
+    } else {
+        sleepWake.notify_all();
+    }
+}
+
+// ========================================
+// 3. EXECUTION
+// ========================================
+
+bool JobSystem::TryRunOne(int32_t worker) {
+    Job job;
+    bool found = worker >= 0 && workers[worker]->queue.Take(job);
+
+    if (!found && injectedCount.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> lock(injectMutex);
+        if (!injected.empty()) {
+            job = injected.front();
+            injected.pop_front();
+            injectedCount.fetch_sub(1, std::memory_order_relaxed);
+            found = true;
+        }
+    }
+    if (!found) {
+        found = Steal(worker, job);
+    }
+    if (!found) {
+        return false;
+    }
+
+    queuedJobs.fetch_sub(1, std::memory_order_seq_cst);
+    Execute(job);
+    return true;
+}
+
+bool JobSystem::Steal(int32_t thief, Job& job) {
+    const uint32_t count = static_cast<uint32_t>(workers.size());
+    if (count < 2 && thief >= 0) {
+        return false;
+    }
+
+    // Start at a random victim so thieves spread out instead of all hitting worker 0
+    uint32_t start = 0;
+    if (thief >= 0) {
+        uint32_t& x = workers[thief]->random;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        start = x % count;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t victim = (start + i) % count;
+        if (static_cast<int32_t>(victim) == thief) {
+            continue;
+        }
+        if (workers[victim]->queue.Steal(job)) {
+            if (thief >= 0) {
+                workers[thief]->stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::Execute(const Job& job) {
+    job.function(job);
+
+    int32_t worker = CurrentWorker();
+    if (worker >= 0) {
+        workers[worker]->executed.fetch_add(1, std::memory_order_relaxed);
+    }
+    Finish(job.counter);
+}
+
+void JobSystem::Finish(JobCounter* counter) {
+    if (!counter) {
+        return;
+    }
+
+    // Not the last job: a plain decrement
+    uint32_t value = counter->value.load(std::memory_order_relaxed);
+    while (value > 1) {
+        if (counter->value.compare_exchange_weak(value,
+                                                 value - 1,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed)) {
+            return;
+        }
+    }
+
+    // Possibly the last job: the final decrement happens under waitingMutex, and Wait()
+    // takes the same lock before returning, so the counter (often a local of the waiter)
+    // stays alive until this thread is done touching it
+    std::vector<Job> released;
+    {
+        std::lock_guard<std::mutex> lock(counter->waitingMutex);
+        if (counter->value.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            released.swap(counter->waiting);
+        }
+    }
+    for (const Job& job : released) {
+        Push(job);
+    }
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    int32_t worker = CurrentWorker();
+    while (!counter.IsDone()) {
+        if (!TryRunOne(worker)) {
+            std::this_thread::yield();
+        }
+    }
+    std::lock_guard<std::mutex> lock(counter.waitingMutex);
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t grain, const RangeFunction& function) {
+    if (count == 0) {
+        return;
+    }
+
+    const uint32_t threadCount = std::max(1u, GetThreadCount());
+    if (grain == 0) {
+        grain = std::max(1u, count / (threadCount * 4));
+    }
+    if (threadCount == 1 || count <= grain) {
+        function(0, count);
+        return;
+    }
+
+    // Push the ranges back to front so the owner's LIFO takes the first range next while
+    // thieves start from the far end
+    JobCounter counter;
+    uint32_t rangeCount = (count + grain - 1) / grain;
+    for (uint32_t range = rangeCount; range-- > 1;) {
+        uint32_t begin = range * grain;
+        uint32_t end   = std::min(count, begin + grain);
+        Run(RunRange, const_cast<RangeFunction*>(&function), begin, end, &counter);
+    }
+
+    // The caller takes the first range itself instead of queuing it
+    function(0, std::min(count, grain));
+    Wait(counter);
+}
+
+::ParallelFor JobSystem::GetTaskExecutor() {
+    return [this](uint32_t taskCount, const std::function<void(uint32_t)>& task) {
+        ParallelFor(taskCount, 1, [&task](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                task(i);
+            }
+        });
+    };
+}
+
+// ========================================
+// 4. STATISTICS
+// ========================================
+
+JobSystem::Stats JobSystem::GetStats() const {
+    Stats stats;
+    for (const std::unique_ptr<Worker>& worker : workers) {
+        stats.jobsExecuted += worker->executed.load(std::memory_order_relaxed);
+        stats.jobsStolen += worker->stolen.load(std::memory_order_relaxed);
+        stats.jobsInline += worker->inlined.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void JobSystem::ResetStats() {
+    for (const std::unique_ptr<Worker>& worker : workers) {
+        worker->executed.store(0, std::memory_order_relaxed);
+        worker->stolen.store(0, std::memory_order_relaxed);
+        worker->inlined.store(0, std::memory_order_relaxed);
+    }
+}
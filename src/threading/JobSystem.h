@@ -0,0 +1,150 @@
+#pragma once
+#include "ParallelFor.h"
+#include "WorkStealingQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobCounter;
+struct Job;
+using JobFunction = void (*)(const Job& job);
+
+// Job
+// One unit of work: a function applied to the index range [begin, end) of some shared data
+struct Job {
+    JobFunction function = nullptr;
+    void* data           = nullptr;
+    uint32_t begin       = 0;
+    uint32_t end         = 0;
+    JobCounter* counter  = nullptr; // Decremented when the job has finished
+};
+
+// Job Counter Class
+// Counts unfinished jobs. JobSystem::Wait blocks (while helping) until it reaches zero, and
+// jobs run with a counter as their dependency start only once it has reached zero.
+class JobCounter {
+  public:
+    JobCounter() : value(0) {}
+
+    JobCounter(const JobCounter&)            = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool IsDone() const {
+        return value.load(std::memory_order_acquire) == 0;
+    }
+
+  private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> value;
+    std::mutex waitingMutex;
+    std::vector<Job> waiting; // Jobs parked until value reaches zero
+};
+
+// Job System Class
+// Work-stealing scheduler: every thread owns a Chase-Lev deque, pushes and pops its own work
+// LIFO and steals FIFO from a random victim when it runs dry. The thread that calls
+// Initialize is worker 0 and participates whenever it waits. Other threads may submit too;
+// their jobs go through a shared injection queue. Platform-neutral (std::thread only).
+class JobSystem {
+  public:
+    // Jobs a single thread may have queued at once; further jobs run inline
+    static constexpr uint32_t QueueCapacity = 4096;
+
+    using RangeFunction = std::function<void(uint32_t begin, uint32_t end)>;
+
+    // Totals since Initialize (or the last ResetStats)
+    struct Stats {
+        uint64_t jobsExecuted = 0; // Jobs run by any thread
+        uint64_t jobsStolen   = 0; // Jobs taken from another thread's deque
+        uint64_t jobsInline   = 0; // Jobs run at submission because the deque was full
+    };
+
+    JobSystem();
+    ~JobSystem();
+
+    JobSystem(const JobSystem&)            = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /*
+    Start the worker threads
+    threadCount: Total threads including the caller (0 = std::thread::hardware_concurrency())
+    */
+    bool Initialize(uint32_t threadCount = 0);
+
+    // Run the caller's queued jobs and join the workers
+    void Shutdown();
+
+    uint32_t GetThreadCount() const {
+        return static_cast<uint32_t>(workers.size());
+    }
+
+    /*
+    Queue function(job) for the range [begin, end)
+    counter: Incremented now, decremented when the job finishes (may be nullptr)
+    dependency: The job is held back until this counter reaches zero (may be nullptr)
+    */
+    void Run(JobFunction function,
+             void* data,
+             uint32_t begin,
+             uint32_t end,
+             JobCounter* counter,
+             JobCounter* dependency = nullptr);
+
+    // Run other jobs until counter reaches zero
+    void Wait(JobCounter& counter);
+
+    /*
+    Call function(begin, end) over [0, count) split into ranges of at most grain items and
+    wait for all of them. grain 0 picks about four ranges per thread.
+    */
+    void ParallelFor(uint32_t count, uint32_t grain, const RangeFunction& function);
+
+    // Executor for the SetParallelFor hooks of RenderQueue, InstanceWriter, SpriteBatch,
+    // MatrixBatch and friends (see ParallelFor.h): one job per task
+    ::ParallelFor GetTaskExecutor();
+
+    Stats GetStats() const;
+    void ResetStats();
+
+  private:
+    // Per-thread state, cache-line aligned so counters never share a line with a neighbour
+    struct alignas(64) Worker {
+        WorkStealingQueue<Job, QueueCapacity> queue;
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> stolen{0};
+        std::atomic<uint64_t> inlined{0};
+        uint32_t random = 0; // xorshift state for victim selection
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers; // [0] is the initializing thread
+    std::vector<std::thread> threads;             // Threads for workers[1..]
+
+    // Jobs submitted from threads that are not workers of this system
+    std::mutex injectMutex;
+    std::deque<Job> injected;
+    std::atomic<uint32_t> injectedCount; // Lets TryRunOne skip the lock when empty
+
+    // Sleeping: idle workers block until queuedJobs is non-zero
+    std::mutex sleepMutex;
+    std::condition_variable sleepWake;
+    std::atomic<int64_t> queuedJobs;
+    std::atomic<uint32_t> sleepers;
+    std::atomic<bool> quit;
+
+    void WorkerLoop(uint32_t index);
+    int32_t CurrentWorker() const;
+
+    void Push(const Job& job);
+    bool TryRunOne(int32_t worker);
+    bool Steal(int32_t thief, Job& job);
+    void Execute(const Job& job);
+    void Finish(JobCounter* counter);
+    void WakeWorkers(uint32_t count);
+};
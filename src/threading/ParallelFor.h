@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+// Parallel For
+// Executor hook shared by the batch processors (RenderQueue, InstanceWriter, SpriteBatch,
+// MatrixBatch, TransformHierarchy, Bvh, MeshSimplifier): runs task(i) for i in
+// [0, taskCount), possibly in parallel, and returns once every task has finished. Each
+// class runs serially until one is installed with its SetParallelFor;
+// JobSystem::GetTaskExecutor provides one backed by the job system.
+using ParallelFor =
+    std::function<void(uint32_t taskCount, const std::function<void(uint32_t)>& task)>;
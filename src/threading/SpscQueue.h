@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+// SPSC Queue Class
+// Bounded single-producer single-consumer ring. Each side owns one index and keeps a cached
+// copy of the other's, so Push and Pop touch shared cache lines only when the cached view
+// says the queue looks full (or empty); both are wait-free.
+// Exactly one thread may push and one (other) thread may pop. T must be trivially copyable.
+template <typename T, uint32_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "T is copied between threads");
+
+  public:
+    SpscQueue() : tail(0), head(0) {}
+
+    SpscQueue(const SpscQueue&)            = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer only; returns false (and drops nothing) when the queue is full
+    bool Push(const T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead == Capacity) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead == Capacity) {
+                return false;
+            }
+        }
+        items[t & Mask] = item;
+        tail.store(t + 1, std::memory_order_release); // Publishes the item
+        return true;
+    }
+
+    // Consumer only; takes the oldest item
+    bool Pop(T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) {
+                return false;
+            }
+        }
+        item = items[h & Mask];
+        head.store(h + 1, std::memory_order_release); // Hands the slot back to the producer
+        return true;
+    }
+
+    // Approximate from any thread; exact from either side while the other is idle
+    uint32_t GetSize() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+  private:
+    static constexpr uint32_t Mask = Capacity - 1;
+
+    // Producer and consumer state on separate cache lines; indices wrap freely (unsigned)
+    alignas(64) std::atomic<uint32_t> tail;
+    uint32_t cachedHead = 0; // Producer's last view of head
+    alignas(64) std::atomic<uint32_t> head;
+    uint32_t cachedTail = 0; // Consumer's last view of tail
+    alignas(64) T items[Capacity];
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Triple Buffer Class
+// Wait-free handoff of the latest value from one writer thread to one reader thread. Three
+// slots rotate between the roles "being written", "latest published" and "being read";
+// publishing and picking up are a single atomic exchange of the middle slot's index, so
+// neither side ever blocks the other or copies more than its own slot. Intermediate values
+// the reader never picked up are simply overwritten.
+template <typename T>
+class TripleBuffer {
+  public:
+    TripleBuffer() : middle(1) {}
+
+    TripleBuffer(const TripleBuffer&)            = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /*
+    Writer only: the slot to fill for the next Publish
+    It holds whatever was published two rotations ago, not the last published value
+    */
+    T& GetWriteBuffer() {
+        return slots[writeIndex].value;
+    }
+
+    // Writer only: make the write slot the latest value and take over the old middle slot
+    void Publish() {
+        // Release: the slot's contents are visible to the reader that acquires it
+        uint32_t previous = middle.exchange(writeIndex | Fresh, std::memory_order_acq_rel);
+        writeIndex        = previous & IndexMask;
+    }
+
+    // Reader only: pick up the latest published value; false if nothing new was published
+    bool Update() {
+        if ((middle.load(std::memory_order_relaxed) & Fresh) == 0) {
+            return false;
+        }
+        // Acquire: everything written to the slot before its Publish is visible
+        uint32_t previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex         = previous & IndexMask;
+        return true;
+    }
+
+    // Reader only: the value picked up by the last successful Update
+    const T& GetReadBuffer() const {
+        return slots[readIndex].value;
+    }
+
+  private:
+    static constexpr uint32_t IndexMask = 3;
+    static constexpr uint32_t Fresh     = 4; // Middle slot was published since the last read
+
+    // Slots on their own cache lines, so writer and reader never share one
+    struct alignas(64) Slot {
+        T value{};
+    };
+
+    Slot slots[3];
+    alignas(64) std::atomic<uint32_t> middle; // Index of the middle slot | Fresh
+    alignas(64) uint32_t writeIndex = 0;      // Writer-owned
+    alignas(64) uint32_t readIndex  = 2;      // Reader-owned
+};
@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Work Stealing Queue Class
+// Fixed-capacity Chase-Lev deque (after Le, Pop, Cohen and Zappa Nardelli 2013), with the
+// fences expressed as seq_cst accesses on top and bottom.
+// The owning thread pushes and takes at the bottom (LIFO, cache-warm); any other thread may
+// steal from the top (FIFO, oldest and usually largest work first).
+// Elements are copied in and out by value, so T must be trivially copyable. A thief copies
+// its slot before the CAS that claims it; the owner only reuses a slot after top has moved
+// past it, which makes that CAS fail, so a torn copy is always discarded. Slots hold their
+// element as relaxed atomic words, which makes that overlapping copy a defined race.
+template <typename T, uint32_t Capacity>
+class WorkStealingQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "T is copied between threads");
+    static_assert(std::is_default_constructible<T>::value, "T is rebuilt from slot words");
+
+  public:
+    WorkStealingQueue() : top(0), bottom(0) {}
+
+    WorkStealingQueue(const WorkStealingQueue&)            = delete;
+    WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+    // Owner thread only; returns false when the queue is full
+    bool Push(const T& item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= static_cast<int64_t>(Capacity)) {
+            return false;
+        }
+        Store(b, item);
+        bottom.store(b + 1, std::memory_order_release); // Publishes the item to thieves
+        return true;
+    }
+
+    // Owner thread only; takes the most recently pushed item
+    bool Take(T& item) {
+        // The seq_cst store/load pair orders the reservation of slot b against thieves
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_seq_cst);
+
+        if (t > b) {
+            // Empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = Load(b);
+        if (t == b) {
+            // Last item: race thieves for it
+            bool won = top.compare_exchange_strong(t,
+                                                   t + 1,
+                                                   std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread; takes the oldest item
+    bool Steal(T& item) {
+        int64_t t = top.load(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b) {
+            return false;
+        }
+
+        T copy = Load(t);
+        if (!top.compare_exchange_strong(t,
+                                         t + 1,
+                                         std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            return false; // Lost to another thief or the owner
+        }
+        item = copy;
+        return true;
+    }
+
+    // Approximate; exact only when called by the owner with no concurrent thieves
+    uint32_t GetSize() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<uint32_t>(b - t) : 0;
+    }
+
+  private:
+    static constexpr int64_t Mask      = Capacity - 1;
+    static constexpr size_t WordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot {
+        std::atomic<uint64_t> words[WordCount];
+    };
+
+    void Store(int64_t index, const T& item) {
+        uint64_t words[WordCount] = {};
+        std::memcpy(words, &item, sizeof(T));
+        Slot& slot = items[index & Mask];
+        for (size_t i = 0; i < WordCount; ++i) {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    // Ordered by the bottom/top accesses around it; may be torn when racing a Push
+    T Load(int64_t index) const {
+        uint64_t words[WordCount];
+        const Slot& slot = items[index & Mask];
+        for (size_t i = 0; i < WordCount; ++i) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        T item;
+        std::memcpy(&item, words, sizeof(T));
+        return item;
+    }
+
+    // top and bottom live on separate cache lines: thieves hammer top, the owner bottom
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    alignas(64) Slot items[Capacity];
+};
@@ -0,0 +1,247 @@
+#include "FileWatcher.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+struct FileWatcher::Native {
+    HANDLE directory = INVALID_HANDLE_VALUE;
+    HANDLE stopEvent = nullptr;
+    OVERLAPPED overlapped = {};
+    bool reading          = false; // An overlapped read is outstanding
+    alignas(DWORD) uint8_t buffer[16 * 1024];
+
+    ~Native() {
+        if (directory != INVALID_HANDLE_VALUE) {
+            CancelIo(directory);
+            if (reading) {
+                DWORD ignored = 0;
+                GetOverlappedResult(directory, &overlapped, &ignored, TRUE);
+            }
+            CloseHandle(directory);
+        }
+        if (overlapped.hEvent) {
+            CloseHandle(overlapped.hEvent);
+        }
+        if (stopEvent) {
+            CloseHandle(stopEvent);
+        }
+    }
+
+    bool Open(const std::string& path) {
+        directory = CreateFileA(path.c_str(),
+                                FILE_LIST_DIRECTORY,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr,
+                                OPEN_EXISTING,
+                                FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+                                nullptr);
+        overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        stopEvent         = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        return directory != INVALID_HANDLE_VALUE && overlapped.hEvent && stopEvent &&
+               Read();
+    }
+
+    bool Read() {
+        const DWORD filter = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME |
+                             FILE_NOTIFY_CHANGE_SIZE;
+        ResetEvent(overlapped.hEvent);
+        reading = ReadDirectoryChangesW(directory,
+                                        buffer,
+                                        sizeof(buffer),
+                                        FALSE,
+                                        filter,
+                                        nullptr,
+                                        &overlapped,
+                                        nullptr) != FALSE;
+        return reading;
+    }
+
+    void Wake() {
+        SetEvent(stopEvent);
+    }
+
+    // Returns false when woken by Wake
+    bool Wait(int timeoutMs, std::vector<std::string>& names) {
+        HANDLE handles[2] = {overlapped.hEvent, stopEvent};
+        DWORD timeout     = timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs);
+        DWORD result      = WaitForMultipleObjects(2, handles, FALSE, timeout);
+        if (result == WAIT_OBJECT_0 + 1) {
+            return false;
+        }
+        if (result != WAIT_OBJECT_0) {
+            return true; // Timeout
+        }
+
+        DWORD bytes = 0;
+        reading     = false;
+        if (GetOverlappedResult(directory, &overlapped, &bytes, FALSE) && bytes > 0) {
+            const uint8_t* record = buffer;
+            for (;;) {
+                const FILE_NOTIFY_INFORMATION* info =
+                    reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(record);
+                if (info->Action != FILE_ACTION_REMOVED &&
+                    info->Action != FILE_ACTION_RENAMED_OLD_NAME) {
+                    int length = static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+                    char name[MAX_PATH * 3];
+                    int size = WideCharToMultiByte(
+                        CP_UTF8, 0, info->FileName, length, name, sizeof(name), nullptr, nullptr);
+                    if (size > 0) {
+                        names.emplace_back(name, static_cast<size_t>(size));
+                    }
+                }
+                if (info->NextEntryOffset == 0) {
+                    break;
+                }
+                record += info->NextEntryOffset;
+            }
+        }
+        // bytes == 0 means the buffer overflowed; the burst is still reported by whatever
+        // arrives next, so only the re-arm matters here
+        Read();
+        return true;
+    }
+};
+
+#else
+
+struct FileWatcher::Native {
+    int notifyFd    = -1;
+    int wakePipe[2] = {-1, -1};
+    alignas(inotify_event) char buffer[16 * 1024];
+
+    ~Native() {
+        for (int fd : {notifyFd, wakePipe[0], wakePipe[1]}) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    bool Open(const std::string& path) {
+        notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (notifyFd < 0 || pipe(wakePipe) != 0) {
+            return false;
+        }
+        // CLOSE_WRITE covers in-place saves, MOVED_TO covers editors that write a temporary
+        // file and rename it over the original
+        const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+        return inotify_add_watch(notifyFd, path.c_str(), mask) >= 0;
+    }
+
+    void Wake() {
+        char byte = 0;
+        (void)!write(wakePipe[1], &byte, 1);
+    }
+
+    // Returns false when woken by Wake
+    bool Wait(int timeoutMs, std::vector<std::string>& names) {
+        pollfd fds[2] = {{notifyFd, POLLIN, 0}, {wakePipe[0], POLLIN, 0}};
+        if (poll(fds, 2, timeoutMs) <= 0) {
+            return true; // Timeout (or EINTR)
+        }
+        if (fds[1].revents) {
+            return false;
+        }
+
+        ssize_t bytes;
+        while ((bytes = read(notifyFd, buffer, sizeof(buffer))) > 0) {
+            for (char* record = buffer; record < buffer + bytes;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(record);
+                if (event->len > 0 && !(event->mask & IN_ISDIR)) {
+                    names.emplace_back(event->name);
+                }
+                record += sizeof(inotify_event) + event->len;
+            }
+        }
+        return true;
+    }
+};
+
+#endif
+
+// ========================================
+// 1. LIFETIME
+// ========================================
+
+FileWatcher::FileWatcher() {}
+
+FileWatcher::~FileWatcher() {
+    Stop();
+}
+
+bool FileWatcher::Start(const std::string& directory, Callback changeCallback) {
+    Stop();
+
+    native.reset(new Native());
+    if (!native->Open(directory)) {
+        native.reset();
+        return false;
+    }
+
+    callback = std::move(changeCallback);
+    stopping.store(false, std::memory_order_relaxed);
+    thread = std::thread(&FileWatcher::ThreadLoop, this);
+    return true;
+}
+
+void FileWatcher::Stop() {
+    if (thread.joinable()) {
+        stopping.store(true, std::memory_order_relaxed);
+        native->Wake();
+        thread.join();
+    }
+    native.reset();
+}
+
+// ========================================
+// 2. WATCHER THREAD
+// ========================================
+
+void FileWatcher::ThreadLoop() {
+    std::vector<std::string> pending;
+    std::vector<std::string> names;
+    Clock::time_point firstChange;
+    Clock::time_point lastChange;
+
+    while (!stopping.load(std::memory_order_relaxed)) {
+        // Sleep until something changes; once a burst started, only until it has been
+        // quiet for DebounceMs
+        int timeoutMs = -1;
+        if (!pending.empty()) {
+            auto quiet = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() -
+                                                                               lastChange);
+            timeoutMs  = std::max(0, static_cast<int>(DebounceMs - quiet.count()));
+        }
+
+        names.clear();
+        if (!native->Wait(timeoutMs, names)) {
+            break;
+        }
+
+        Clock::time_point now = Clock::now();
+        for (std::string& name : names) {
+            if (pending.empty()) {
+                firstChange = now;
+            }
+            lastChange = now;
+            if (std::find(pending.begin(), pending.end(), name) == pending.end()) {
+                pending.push_back(std::move(name));
+            }
+        }
+
+        if (!pending.empty() && now - lastChange >= std::chrono::milliseconds(DebounceMs)) {
+            callback(pending, firstChange);
+            pending.clear();
+        }
+    }
+}
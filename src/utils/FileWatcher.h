@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// File Watcher Class
+// Watches one directory (not recursive) on a background thread: inotify on Linux,
+// ReadDirectoryChangesW on Windows. Editors save in bursts (truncate, write, rename, touch),
+// so changes are debounced: the callback runs once the directory has been quiet for
+// DebounceMs, with every file name seen in the burst, each listed once.
+// The callback runs on the watcher thread.
+class FileWatcher {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /*
+    files: Names relative to the watched directory
+    firstChange: When the first notification of the burst arrived
+    */
+    using Callback =
+        std::function<void(const std::vector<std::string>& files, Clock::time_point firstChange)>;
+
+    static constexpr uint32_t DebounceMs = 50;
+
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&)            = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Start watching; fails if the directory cannot be watched
+    bool Start(const std::string& directory, Callback callback);
+
+    // Stop the thread; pending (not yet debounced) changes are discarded
+    void Stop();
+
+    bool IsRunning() const {
+        return thread.joinable();
+    }
+
+  private:
+    void ThreadLoop();
+
+    // Platform handles and read buffer, defined in FileWatcher.cpp
+    struct Native;
+
+    std::unique_ptr<Native> native;
+    Callback callback;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+};
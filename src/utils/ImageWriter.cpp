@@ -0,0 +1,135 @@
+#include "ImageWriter.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        tableReady = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+void PutBE32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void PutChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data) {
+    PutBE32(out, static_cast<uint32_t>(data.size()));
+    size_t typeStart = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    PutBE32(out, Crc32(out.data() + typeStart, 4 + data.size()));
+}
+
+} // namespace
+
+namespace ImageWriter {
+
+bool WritePPM(const std::string& path,
+              const uint8_t* pixels,
+              int width,
+              int height,
+              int rowPitch) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "P6\n%d %d\n255\n", width, height);
+
+    std::vector<uint8_t> row(static_cast<size_t>(width) * 3);
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* src = pixels + static_cast<size_t>(y) * rowPitch;
+        for (int x = 0; x < width; ++x) {
+            row[x * 3 + 0] = src[x * 4 + 0];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 2];
+        }
+        std::fwrite(row.data(), 1, row.size(), file);
+    }
+    std::fclose(file);
+    return true;
+}
+
+bool WritePNG(const std::string& path,
+              const uint8_t* pixels,
+              int width,
+              int height,
+              int rowPitch) {
+    // ========================================
+    // 1. RAW SCANLINES (FILTER TYPE 0)
+    // ========================================
+    size_t rowBytes = static_cast<size_t>(width) * 4 + 1;
+    std::vector<uint8_t> raw(rowBytes * height);
+    for (int y = 0; y < height; ++y) {
+        uint8_t* dst       = raw.data() + y * rowBytes;
+        dst[0]             = 0;
+        const uint8_t* src = pixels + static_cast<size_t>(y) * rowPitch;
+        std::copy(src, src + width * 4, dst + 1);
+    }
+
+    // ========================================
+    // 2. ZLIB STREAM WITH STORED DEFLATE BLOCKS
+    // ========================================
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    size_t pos                = 0;
+    do {
+        size_t blockSize = std::min<size_t>(65535, raw.size() - pos);
+        bool last        = pos + blockSize == raw.size();
+        uint16_t len     = static_cast<uint16_t>(blockSize);
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(len));
+        zlib.push_back(static_cast<uint8_t>(len >> 8));
+        zlib.push_back(static_cast<uint8_t>(~len));
+        zlib.push_back(static_cast<uint8_t>(~len >> 8));
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + blockSize);
+        pos += blockSize;
+    } while (pos < raw.size());
+
+    uint32_t a = 1, b = 0; // Adler-32
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    PutBE32(zlib, (b << 16) | a);
+
+    // ========================================
+    // 3. PNG CONTAINER
+    // ========================================
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::vector<uint8_t> header;
+    PutBE32(header, static_cast<uint32_t>(width));
+    PutBE32(header, static_cast<uint32_t>(height));
+    header.insert(header.end(), {8, 6, 0, 0, 0}); // 8-bit RGBA, no interlace
+    PutChunk(png, "IHDR", header);
+    PutChunk(png, "IDAT", zlib);
+    PutChunk(png, "IEND", {});
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    size_t written = std::fwrite(png.data(), 1, png.size(), file);
+    std::fclose(file);
+    return written == png.size();
+}
+
+} // namespace ImageWriter
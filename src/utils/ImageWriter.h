@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Image Writer Utilities
+// Dump RGBA8 pixel data to disk for frame comparison; no external dependencies
+namespace ImageWriter {
+
+/*
+Write a binary PPM (P6); alpha is dropped
+pixels: RGBA8 rows, rowPitch bytes apart
+*/
+bool WritePPM(const std::string& path,
+              const uint8_t* pixels,
+              int width,
+              int height,
+              int rowPitch);
+
+/*
+Write an RGBA8 PNG using uncompressed (stored) deflate blocks
+Larger than a compressed PNG, but byte-exact and readable by any image tool
+*/
+bool WritePNG(const std::string& path,
+              const uint8_t* pixels,
+              int width,
+              int height,
+              int rowPitch);
+
+} // namespace ImageWriter
@@ -0,0 +1,698 @@
+#include "Logger.h"
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+// snprintf result to the number of characters actually in a buffer of capacity bytes
+size_t ClampLength(int written, size_t capacity) {
+    if (written < 0) {
+        return 0;
+    }
+    return static_cast<size_t>(written) < capacity ? static_cast<size_t>(written) : capacity - 1;
+}
+
+// Small sequential thread ids read better in the log than hashed std::thread::ids
+uint32_t CurrentThreadId() {
+    static std::atomic<uint32_t> nextId{0};
+    thread_local uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+const char* LevelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Trace:
+        return "TRACE";
+    case LogLevel::Debug:
+        return "DEBUG";
+    case LogLevel::Info:
+        return "INFO ";
+    case LogLevel::Warning:
+        return "WARN ";
+    case LogLevel::Error:
+        return "ERROR";
+    default:
+        return "?????";
+    }
+}
+
+// ========================================
+// DEFERRED FORMATTING
+// ========================================
+// A producer walks the format once, copying each argument's value (and each %s string's
+// characters) into the record; the background thread walks it again, reads them back with
+// the same types and formats one conversion at a time with snprintf.
+
+// Argument types, by conversion and length modifier
+enum class ArgType : uint8_t {
+    Int,
+    Long,
+    LongLong,
+    IntMax,
+    Size,
+    PtrDiff,
+    Double,
+    LongDouble,
+    Pointer,
+    String
+};
+
+// One conversion specification, from its '%' to its conversion character
+struct Spec {
+    const char* begin;  // The '%'
+    const char* end;    // One past the conversion character
+    ArgType type;       // Of the converted argument
+    bool widthStar;     // An int argument supplies the width
+    bool precisionStar; // An int argument supplies the precision
+    int precision;      // Literal precision, or -1
+};
+
+constexpr size_t MaxSpecLength = 31;
+
+// Parse the specification at percent; false for anything the packer cannot carry
+bool ParseSpec(const char* percent, Spec& spec) {
+    const char* c      = percent + 1;
+    spec.begin         = percent;
+    spec.widthStar     = false;
+    spec.precisionStar = false;
+    spec.precision     = -1;
+
+    while (*c == '-' || *c == '+' || *c == ' ' || *c == '#' || *c == '0') {
+        ++c;
+    }
+    if (*c == '*') {
+        spec.widthStar = true;
+        ++c;
+    } else {
+        while (*c >= '0' && *c <= '9') {
+            ++c;
+        }
+    }
+    if (*c == '.') {
+        ++c;
+        spec.precision = 0;
+        if (*c == '*') {
+            spec.precisionStar = true;
+            spec.precision     = -1;
+            ++c;
+        } else {
+            while (*c >= '0' && *c <= '9') {
+                spec.precision = spec.precision * 10 + (*c - '0');
+                ++c;
+            }
+        }
+    }
+
+    // Length modifier: 0 none, or h, H (hh), l, q (ll), j, z, t, L
+    char length = 0;
+    if (*c == 'h' || *c == 'l') {
+        length = *c++;
+        if (*c == length) {
+            length = length == 'h' ? 'H' : 'q';
+            ++c;
+        }
+    } else if (*c == 'j' || *c == 'z' || *c == 't' || *c == 'L') {
+        length = *c++;
+    }
+
+    const char conversion = *c;
+    switch (conversion) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+        switch (length) {
+        case 'l':
+            spec.type = ArgType::Long;
+            break;
+        case 'q':
+            spec.type = ArgType::LongLong;
+            break;
+        case 'j':
+            spec.type = ArgType::IntMax;
+            break;
+        case 'z':
+            spec.type = ArgType::Size;
+            break;
+        case 't':
+            spec.type = ArgType::PtrDiff;
+            break;
+        case 'L':
+            return false;
+        default:
+            spec.type = ArgType::Int; // char and short arrive promoted
+            break;
+        }
+        break;
+    case 'c':
+        spec.type = ArgType::Int;
+        if (length != 0) {
+            return false; // Wide character
+        }
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        spec.type = length == 'L' ? ArgType::LongDouble : ArgType::Double;
+        break;
+    case 's':
+        spec.type = ArgType::String;
+        if (length != 0) {
+            return false; // Wide string
+        }
+        break;
+    case 'p':
+        spec.type = ArgType::Pointer;
+        break;
+    default:
+        return false; // %n, positional arguments, platform extensions
+    }
+    spec.end = c + 1;
+    return static_cast<size_t>(spec.end - spec.begin) <= MaxSpecLength;
+}
+
+// Bounded byte stream over a record's text
+struct ArgWriter {
+    char* data;
+    size_t capacity;
+    size_t used = 0;
+
+    template <typename T>
+    bool Put(T value) {
+        return PutBytes(&value, sizeof(value));
+    }
+    bool PutBytes(const void* bytes, size_t size) {
+        if (size > capacity - used) {
+            return false;
+        }
+        memcpy(data + used, bytes, size);
+        used += size;
+        return true;
+    }
+};
+
+struct ArgReader {
+    const char* data;
+
+    template <typename T>
+    T Get() {
+        T value;
+        memcpy(&value, data, sizeof(value));
+        data += sizeof(value);
+        return value;
+    }
+};
+
+// Copy the arguments of format into out; false if they do not fit or cannot be carried
+bool PackArgs(const char* format, va_list args, char* out, size_t capacity) {
+    ArgWriter writer = {out, capacity};
+    for (const char* c = format; *c; ++c) {
+        if (*c != '%') {
+            continue;
+        }
+        if (c[1] == '%') {
+            ++c;
+            continue;
+        }
+        Spec spec;
+        if (!ParseSpec(c, spec)) {
+            return false;
+        }
+        c = spec.end - 1;
+
+        int precision = spec.precision;
+        if (spec.widthStar && !writer.Put(va_arg(args, int))) {
+            return false;
+        }
+        if (spec.precisionStar) {
+            precision = va_arg(args, int);
+            if (!writer.Put(precision)) {
+                return false;
+            }
+        }
+
+        bool fits = true;
+        switch (spec.type) {
+        case ArgType::Int:
+            fits = writer.Put(va_arg(args, int));
+            break;
+        case ArgType::Long:
+            fits = writer.Put(va_arg(args, long));
+            break;
+        case ArgType::LongLong:
+            fits = writer.Put(va_arg(args, long long));
+            break;
+        case ArgType::IntMax:
+            fits = writer.Put(va_arg(args, intmax_t));
+            break;
+        case ArgType::Size:
+            fits = writer.Put(va_arg(args, size_t));
+            break;
+        case ArgType::PtrDiff:
+            fits = writer.Put(va_arg(args, ptrdiff_t));
+            break;
+        case ArgType::Double:
+            fits = writer.Put(va_arg(args, double));
+            break;
+        case ArgType::LongDouble:
+            fits = writer.Put(va_arg(args, long double));
+            break;
+        case ArgType::Pointer:
+            fits = writer.Put(va_arg(args, void*));
+            break;
+        case ArgType::String: {
+            // Only the characters the precision lets through; the caller's buffer may end
+            // right after them without a terminator
+            const char* text = va_arg(args, const char*);
+            if (!text) {
+                text = "(null)";
+            }
+            const size_t limit = precision < 0 ? capacity : static_cast<size_t>(precision);
+            size_t length      = 0;
+            while (length < limit && length <= capacity && text[length]) {
+                ++length;
+            }
+            fits = length <= capacity && writer.Put(static_cast<uint32_t>(length)) &&
+                   writer.PutBytes(text, length);
+            break;
+        }
+        }
+        if (!fits) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// snprintf one specification, passing the star arguments it takes before the value
+template <typename T>
+int FormatOne(char* out,
+              size_t size,
+              const char* spec,
+              const Spec& parsed,
+              int width,
+              int precision,
+              T value) {
+    if (parsed.widthStar && parsed.precisionStar) {
+        return snprintf(out, size, spec, width, precision, value);
+    }
+    if (parsed.widthStar) {
+        return snprintf(out, size, spec, width, value);
+    }
+    if (parsed.precisionStar) {
+        return snprintf(out, size, spec, precision, value);
+    }
+    return snprintf(out, size, spec, value);
+}
+
+// Format format with the arguments PackArgs stored in args; returns the length in out
+size_t UnpackAndFormat(const char* format, const char* args, char* out, size_t capacity) {
+    ArgReader reader = {args};
+    size_t length    = 0;
+    for (const char* c = format; *c && length < capacity - 1;) {
+        if (*c != '%' || c[1] == '%') {
+            out[length++] = *c;
+            c += *c == '%' ? 2 : 1;
+            continue;
+        }
+        Spec parsed;
+        ParseSpec(c, parsed); // Succeeded on the producer
+        char spec[MaxSpecLength + 1];
+        memcpy(spec, parsed.begin, parsed.end - parsed.begin);
+        spec[parsed.end - parsed.begin] = '\0';
+        c                               = parsed.end;
+
+        const int width     = parsed.widthStar ? reader.Get<int>() : 0;
+        const int precision = parsed.precisionStar ? reader.Get<int>() : 0;
+        char* at            = out + length;
+        const size_t room   = capacity - length;
+        int written         = 0;
+        switch (parsed.type) {
+        case ArgType::Int:
+            written = FormatOne(at, room, spec, parsed, width, precision, reader.Get<int>());
+            break;
+        case ArgType::Long:
+            written = FormatOne(at, room, spec, parsed, width, precision, reader.Get<long>());
+            break;
+        case ArgType::LongLong:
+            written =
+                FormatOne(at, room, spec, parsed, width, precision, reader.Get<long long>());
+            break;
+        case ArgType::IntMax:
+            written = FormatOne(at, room, spec, parsed, width, precision, reader.Get<intmax_t>());
+            break;
+        case ArgType::Size:
+            written = FormatOne(at, room, spec, parsed, width, precision, reader.Get<size_t>());
+            break;
+        case ArgType::PtrDiff:
+            written =
+                FormatOne(at, room, spec, parsed, width, precision, reader.Get<ptrdiff_t>());
+            break;
+        case ArgType::Double:
+            written = FormatOne(at, room, spec, parsed, width, precision, reader.Get<double>());
+            break;
+        case ArgType::LongDouble:
+            written =
+                FormatOne(at, room, spec, parsed, width, precision, reader.Get<long double>());
+            break;
+        case ArgType::Pointer:
+            written = FormatOne(at, room, spec, parsed, width, precision, reader.Get<void*>());
+            break;
+        case ArgType::String: {
+            char text[Logger::MessageSize + 1];
+            const uint32_t size = reader.Get<uint32_t>();
+            memcpy(text, reader.data, size);
+            text[size] = '\0';
+            reader.data += size;
+            written = FormatOne(at, room, spec, parsed, width, precision, text);
+            break;
+        }
+        }
+        length += ClampLength(written, room);
+    }
+    out[length] = '\0';
+    return length;
+}
+
+// __FILE__ without its directories
+const char* BaseName(const char* path) {
+    const char* name = path;
+    for (const char* c = path; *c; ++c) {
+        if (*c == '/' || *c == '\\') {
+            name = c + 1;
+        }
+    }
+    return name;
+}
+
+} // namespace
+
+// ========================================
+// 1. LIFETIME
+// ========================================
+
+Logger& Logger::Get() {
+    static Logger instance;
+    return instance;
+}
+
+Logger::Logger()
+    : startTime(std::chrono::steady_clock::now()), cells(new Cell[QueueCapacity]), enqueuePos(0),
+      flushed(0), minLevel(0), console(true), dropped(0), suppressed(0), written(0),
+      sleeping(false), quit(false) {
+#ifdef NDEBUG
+    minLevel.store(static_cast<uint8_t>(LogLevel::Info), std::memory_order_relaxed);
+#endif
+    for (uint32_t i = 0; i < QueueCapacity; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    worker = std::thread(&Logger::WorkerLoop, this);
+}
+
+Logger::~Logger() {
+    // Write out everything still queued before the process exits
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        quit.store(true, std::memory_order_seq_cst);
+    }
+    wake.notify_one();
+    worker.join();
+
+    if (file) {
+        fclose(file);
+    }
+}
+
+bool Logger::SetFile(const std::string& path) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+    if (path.empty()) {
+        return true;
+    }
+#ifdef _MSC_VER
+    fopen_s(&file, path.c_str(), "ab");
+#else
+    file = fopen(path.c_str(), "ab");
+#endif
+    return file != nullptr;
+}
+
+// ========================================
+// 2. PRODUCER SIDE (ANY THREAD)
+// ========================================
+
+uint64_t Logger::Now() const {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(
+        duration_cast<nanoseconds>(steady_clock::now() - startTime).count());
+}
+
+bool Logger::Admit(LogSite& site, uint64_t nowMs) {
+    // Start a new window once the current one has expired; whoever wins the CAS resets it
+    uint64_t start = site.windowStart.load(std::memory_order_relaxed);
+    if (nowMs - start >= LogSite::WindowMs &&
+        site.windowStart.compare_exchange_strong(start, nowMs, std::memory_order_relaxed)) {
+        site.windowCount.store(0, std::memory_order_relaxed);
+    }
+
+    if (site.windowCount.fetch_add(1, std::memory_order_relaxed) >= LogSite::Burst) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+Logger::Record* Logger::Claim(LogSite& site, uint64_t timestamp, uint64_t& pos) {
+    // Claim a cell: its sequence equals our position when it is free
+    Cell* cell = nullptr;
+    pos        = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        cell         = &cells[pos & (QueueCapacity - 1)];
+        uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Full: the background thread is behind by a whole queue
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    Record& record    = cell->record;
+    record.timestamp  = timestamp;
+    record.file       = site.file;
+    record.line       = static_cast<uint32_t>(site.line);
+    record.suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    record.threadId   = CurrentThreadId();
+    record.level      = site.level;
+    record.format     = nullptr;
+    return &record;
+}
+
+void Logger::Publish(uint64_t pos) {
+    cells[pos & (QueueCapacity - 1)].sequence.store(pos + 1, std::memory_order_release);
+
+    if (sleeping.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wake.notify_one();
+    }
+}
+
+void Logger::Write(LogSite& site, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    WriteV(site, format, args);
+    va_end(args);
+}
+
+void Logger::WriteV(LogSite& site, const char* format, va_list args) {
+    uint64_t timestamp = Now();
+    if (!Admit(site, timestamp / 1000000)) {
+        return;
+    }
+
+    // Pack the arguments into the claimed record for the background thread to format;
+    // what cannot be packed is formatted here, into the same record
+    uint64_t pos   = 0;
+    Record* record = Claim(site, timestamp, pos);
+    if (!record) {
+        return;
+    }
+    va_list packed;
+    va_copy(packed, args);
+    if (PackArgs(format, packed, record->text, MessageSize)) {
+        record->format = format;
+    } else {
+        vsnprintf(record->text, MessageSize, format, args);
+    }
+    va_end(packed);
+    Publish(pos);
+}
+
+void Logger::WriteBlock(LogSite& site, const char* text, size_t length) {
+    uint64_t timestamp = Now();
+    if (!Admit(site, timestamp / 1000000)) {
+        return;
+    }
+
+    // Fill each record with as many whole lines as fit; a single overlong line is cut
+    while (length > 0) {
+        size_t chunk = length;
+        if (chunk > MessageSize - 1) {
+            chunk = MessageSize - 1;
+            while (chunk > 0 && text[chunk - 1] != '\n') {
+                --chunk;
+            }
+            if (chunk == 0) {
+                chunk = MessageSize - 1;
+            }
+        }
+
+        uint64_t pos   = 0;
+        Record* record = Claim(site, timestamp, pos);
+        if (!record) {
+            return;
+        }
+        memcpy(record->text, text, chunk);
+        record->text[chunk] = '\0';
+        Publish(pos);
+
+        text   += chunk;
+        length -= chunk;
+    }
+}
+
+void Logger::Flush() {
+    uint64_t target = enqueuePos.load(std::memory_order_acquire);
+    while (flushed.load(std::memory_order_acquire) < target) {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            wake.notify_one();
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+Logger::Stats Logger::GetStats() const {
+    Stats stats;
+    stats.written    = written.load(std::memory_order_relaxed);
+    stats.dropped    = dropped.load(std::memory_order_relaxed);
+    stats.suppressed = suppressed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// ========================================
+// 3. BACKGROUND THREAD
+// ========================================
+
+void Logger::WorkerLoop() {
+    for (;;) {
+        if (Drain() > 0) {
+            continue;
+        }
+        if (quit.load(std::memory_order_seq_cst)) {
+            Drain();
+            return;
+        }
+
+        // Sleep until a producer sees sleeping and notifies (or a short timeout, which also
+        // covers a record claimed but not yet published when we looked)
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        sleeping.store(true, std::memory_order_seq_cst);
+        const Cell& next = cells[dequeuePos & (QueueCapacity - 1)];
+        if (next.sequence.load(std::memory_order_acquire) != dequeuePos + 1 &&
+            !quit.load(std::memory_order_seq_cst)) {
+            wake.wait_for(lock, std::chrono::milliseconds(20));
+        }
+        sleeping.store(false, std::memory_order_seq_cst);
+    }
+}
+
+size_t Logger::Drain() {
+    size_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        for (;;) {
+            Cell& cell = cells[dequeuePos & (QueueCapacity - 1)];
+            if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+                break;
+            }
+            WriteRecord(cell.record);
+            cell.sequence.store(dequeuePos + QueueCapacity, std::memory_order_release);
+            ++dequeuePos;
+            ++count;
+        }
+
+        // One flush per batch instead of one per line
+        if (count > 0) {
+            if (console.load(std::memory_order_relaxed)) {
+                fflush(stdout);
+            }
+            if (file) {
+                fflush(file);
+            }
+        }
+    }
+    written.fetch_add(count, std::memory_order_relaxed);
+    flushed.store(dequeuePos, std::memory_order_release);
+    return count;
+}
+
+void Logger::WriteRecord(const Record& record) {
+    char message[MessageSize];
+    const char* text = record.text;
+    if (record.format) {
+        UnpackAndFormat(record.format, record.text, message, MessageSize);
+        text = message;
+    }
+
+    char line[MessageSize + 128];
+    int written = snprintf(line,
+                           sizeof(line),
+                           "[%5u.%03u] %s T%-2u %s:%u  %s",
+                           static_cast<uint32_t>(record.timestamp / 1000000000),
+                           static_cast<uint32_t>(record.timestamp / 1000000 % 1000),
+                           LevelName(record.level),
+                           record.threadId,
+                           BaseName(record.file),
+                           record.line,
+                           text);
+    size_t length = ClampLength(written, sizeof(line));
+
+    // Strip the caller's trailing newline; one is added below
+    while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+        --length;
+    }
+    if (record.suppressed > 0) {
+        written = snprintf(line + length,
+                           sizeof(line) - length,
+                           " (%u similar suppressed)",
+                           record.suppressed);
+        length += ClampLength(written, sizeof(line) - length);
+    }
+
+    if (console.load(std::memory_order_relaxed)) {
+        fwrite(line, 1, length, stdout);
+        fputc('\n', stdout);
+    }
+    if (file) {
+        fwrite(line, 1, length, file);
+        fputc('\n', file);
+    }
+}
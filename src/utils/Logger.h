@@ -0,0 +1,163 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+enum class LogLevel : uint8_t { Trace = 0, Debug, Info, Warning, Error, Off };
+
+// Log Site
+// One static instance per LOG_* call site, holding that site's rate limit state.
+// Every site may emit Burst messages per Window; the rest are counted and reported as
+// "suppressed" on the next message that gets through.
+struct LogSite {
+    static constexpr uint32_t Burst    = 8;
+    static constexpr uint64_t WindowMs = 1000;
+
+    const char* file;
+    int line;
+    LogLevel level;
+
+    std::atomic<uint64_t> windowStart{0}; // Milliseconds since logger start
+    std::atomic<uint32_t> windowCount{0}; // Messages issued in the current window
+    std::atomic<uint32_t> suppressed{0};  // Messages dropped since the last one issued
+};
+
+// Logger Class
+// Asynchronous logger. Callers copy the format pointer and their raw arguments (strings by
+// value) into a fixed-size record claimed from a bounded lock-free MPSC queue; a background
+// thread formats the message, adds the timestamp and severity, writes to the console
+// and/or a file and flushes once per batch. Calls whose arguments do not fit a record, or
+// use a conversion the packer does not know (%n, wide strings, positional arguments), are
+// formatted on the calling thread instead.
+// Nothing on the calling thread blocks or touches a stream. A full queue drops the
+// message, and the drop is counted in the stats.
+class Logger {
+  public:
+    static constexpr uint32_t QueueCapacity = 4096; // Records, power of two
+    static constexpr uint32_t MessageSize   = 224;  // Bytes of text per record (truncated)
+
+    struct Stats {
+        uint64_t written    = 0; // Records written by the background thread
+        uint64_t dropped    = 0; // Records lost because the queue was full
+        uint64_t suppressed = 0; // Messages rejected by per-site rate limits
+    };
+
+    static Logger& Get();
+
+    // Messages below level are discarded at the call site
+    void SetLevel(LogLevel level) {
+        minLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+    bool IsEnabled(LogLevel level) const {
+        return static_cast<uint8_t>(level) >= minLevel.load(std::memory_order_relaxed);
+    }
+
+    // Also write to a file (appends); empty path closes it
+    bool SetFile(const std::string& path);
+
+    // Enable or disable the console sink (stdout)
+    void SetConsole(bool enabled) {
+        console.store(enabled, std::memory_order_relaxed);
+    }
+
+    /*
+    printf-style; use the LOG_* macros rather than calling this directly
+    format is read later by the background thread, so it must outlive the logger (the
+    string literals the macros pass always do)
+    */
+    void Write(LogSite& site, const char* format, ...);
+    void WriteV(LogSite& site, const char* format, va_list args);
+
+    /*
+    Multi-line text (e.g. compiler output) as one message: it counts once against the site's
+    rate limit and is split into records at line breaks only where it exceeds MessageSize
+    */
+    void WriteBlock(LogSite& site, const char* text, size_t length);
+
+    // Block until everything queued so far has been written and the sinks flushed
+    void Flush();
+
+    Stats GetStats() const;
+
+  private:
+    struct Record {
+        uint64_t timestamp; // Nanoseconds since logger start
+        const char* file;
+        uint32_t line;
+        uint32_t suppressed; // Messages this site dropped before this one
+        uint32_t threadId;
+        LogLevel level;
+        const char* format;     // Formatted by the background thread; nullptr: text is final
+        char text[MessageSize]; // The packed arguments of format, or the message
+    };
+
+    // Vyukov bounded queue cell: sequence == position means free, position + 1 means full
+    struct Cell {
+        std::atomic<uint64_t> sequence;
+        Record record;
+    };
+
+    Logger();
+    ~Logger();
+
+    uint64_t Now() const;
+    bool Admit(LogSite& site, uint64_t nowMs);
+    Record* Claim(LogSite& site, uint64_t timestamp, uint64_t& pos);
+    void Publish(uint64_t pos);
+    void WorkerLoop();
+    size_t Drain();
+    void WriteRecord(const Record& record);
+
+    std::chrono::steady_clock::time_point startTime;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::atomic<uint64_t> enqueuePos;
+    alignas(64) uint64_t dequeuePos = 0;       // Background thread only
+    alignas(64) std::atomic<uint64_t> flushed; // Queue position written and flushed
+
+    std::atomic<uint8_t> minLevel;
+    std::atomic<bool> console;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint64_t> suppressed;
+    std::atomic<uint64_t> written;
+
+    std::mutex fileMutex; // Guards file against SetFile while the worker writes
+    FILE* file = nullptr;
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> sleeping;
+    std::atomic<bool> quit;
+    std::thread worker;
+};
+
+// One static LogSite per expansion; the level check happens before any formatting
+#define LOG_AT(logLevel, ...)                                                 \
+    do {                                                                      \
+        if (Logger::Get().IsEnabled(logLevel)) {                              \
+            static LogSite logSite{__FILE__, __LINE__, logLevel};             \
+            Logger::Get().Write(logSite, __VA_ARGS__);                        \
+        }                                                                     \
+    } while (0)
+
+#define LOG_BLOCK_AT(logLevel, text, length)                                  \
+    do {                                                                      \
+        if (Logger::Get().IsEnabled(logLevel)) {                              \
+            static LogSite logSite{__FILE__, __LINE__, logLevel};             \
+            Logger::Get().WriteBlock(logSite, text, length);                  \
+        }                                                                     \
+    } while (0)
+
+#define LOG_TRACE(...)   LOG_AT(LogLevel::Trace, __VA_ARGS__)
+#define LOG_DEBUG(...)   LOG_AT(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...)    LOG_AT(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(LogLevel::Warning, __VA_ARGS__)
+#define LOG_ERROR(...)   LOG_AT(LogLevel::Error, __VA_ARGS__)
+
+#define LOG_ERROR_BLOCK(text, length) LOG_BLOCK_AT(LogLevel::Error, text, length)
@@ -0,0 +1,173 @@
+#include "Lz4.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr size_t MinMatch     = 4;
+constexpr size_t LastLiterals = 5;  // The block always ends with at least this many literals
+constexpr size_t MatchLimit   = 12; // No match may start in the last 12 bytes
+constexpr size_t MaxOffset    = 65535;
+constexpr int HashBits        = 12;
+
+uint32_t Read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t Hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+// Length continuation: 255 per extra byte, then the remainder
+uint8_t* PutLength(uint8_t* op, size_t length) {
+    for (; length >= 255; length -= 255) {
+        *op++ = 255;
+    }
+    *op++ = static_cast<uint8_t>(length);
+    return op;
+}
+
+uint8_t* PutSequence(uint8_t* op,
+                     const uint8_t* literals,
+                     size_t literalLength,
+                     size_t offset,
+                     size_t matchLength) {
+    uint8_t* token = op++;
+    *token         = static_cast<uint8_t>(std::min<size_t>(literalLength, 15) << 4);
+    if (literalLength >= 15) {
+        op = PutLength(op, literalLength - 15);
+    }
+    if (literalLength > 0) {
+        std::memcpy(op, literals, literalLength);
+        op += literalLength;
+    }
+    if (matchLength == 0) {
+        return op; // Last sequence: literals only
+    }
+
+    *op++ = static_cast<uint8_t>(offset);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+    matchLength -= MinMatch;
+    *token |= static_cast<uint8_t>(std::min<size_t>(matchLength, 15));
+    if (matchLength >= 15) {
+        op = PutLength(op, matchLength - 15);
+    }
+    return op;
+}
+
+// Reads a length continuation; false if it runs past end
+bool GetLength(const uint8_t*& ip, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (ip >= end) {
+            return false;
+        }
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+} // namespace
+
+namespace Lz4 {
+
+size_t Compress(const uint8_t* src, size_t size, uint8_t* dst, size_t dstCapacity) {
+    if (dstCapacity < CompressBound(size)) {
+        return 0;
+    }
+    const uint8_t* ip     = src;
+    const uint8_t* anchor = src; // Start of the pending literals
+    const uint8_t* end    = src + size;
+    uint8_t* op           = dst;
+
+    if (size > MatchLimit) {
+        const uint8_t* matchEnd   = end - LastLiterals;
+        const uint8_t* matchStart = end - MatchLimit;
+        std::vector<uint32_t> table(size_t(1) << HashBits, 0); // Hash -> last position seen
+
+        while (ip <= matchStart) {
+            uint32_t sequence     = Read32(ip);
+            uint32_t& slot        = table[Hash(sequence)];
+            const uint8_t* match  = src + slot;
+            slot                  = static_cast<uint32_t>(ip - src);
+            const size_t distance = static_cast<size_t>(ip - match);
+            if (distance == 0 || distance > MaxOffset || Read32(match) != sequence) {
+                ++ip;
+                continue;
+            }
+
+            // Grow the match backwards into the literals, then forwards
+            while (ip > anchor && match > src && ip[-1] == match[-1]) {
+                --ip;
+                --match;
+            }
+            size_t length = MinMatch;
+            while (ip + length < matchEnd && ip[length] == match[length]) {
+                ++length;
+            }
+
+            op     = PutSequence(op, anchor, static_cast<size_t>(ip - anchor), distance, length);
+            ip     = ip + length;
+            anchor = ip;
+        }
+    }
+    op = PutSequence(op, anchor, static_cast<size_t>(end - anchor), 0, 0);
+    return static_cast<size_t>(op - dst);
+}
+
+bool Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+    const uint8_t* ip   = src;
+    const uint8_t* iend = src + srcSize;
+    uint8_t* op         = dst;
+    uint8_t* oend       = dst + dstSize;
+
+    while (ip < iend) {
+        const uint8_t token = *ip++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !GetLength(ip, iend, literalLength)) {
+            return false;
+        }
+        if (literalLength > static_cast<size_t>(iend - ip) ||
+            literalLength > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+        if (literalLength > 0) {
+            std::memcpy(op, ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+        }
+        if (ip == iend) {
+            break; // The last sequence has no match
+        }
+
+        if (iend - ip < 2) {
+            return false;
+        }
+        const size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !GetLength(ip, iend, matchLength)) {
+            return false;
+        }
+        matchLength += MinMatch;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst) ||
+            matchLength > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+
+        // Byte by byte: the source may overlap the bytes being written (repeats)
+        const uint8_t* match = op - offset;
+        for (size_t i = 0; i < matchLength; ++i) {
+            op[i] = match[i];
+        }
+        op += matchLength;
+    }
+    return op == oend;
+}
+
+} // namespace Lz4
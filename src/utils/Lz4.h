@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// LZ4 Block Codec
+// Compressor and bounds-checked decompressor for the LZ4 block format (no frame header, no
+// checksum), so output can also be read by the reference lz4 library. The compressor is the
+// simple greedy single-hash variant: fast enough for offline tools, and decompression speed
+// does not depend on how hard the compressor tried.
+namespace Lz4 {
+
+// Worst-case compressed size of size input bytes
+constexpr size_t CompressBound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+/*
+Compress size bytes of src into dst
+dstCapacity: At least CompressBound(size)
+Returns the compressed size, or 0 if dst is too small
+*/
+size_t Compress(const uint8_t* src, size_t size, uint8_t* dst, size_t dstCapacity);
+
+/*
+Decompress a block that expands to exactly dstSize bytes
+Never reads or writes out of bounds on corrupt input; returns false instead
+*/
+bool Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+} // namespace Lz4
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Mapped File Class
+// Read-only memory mapping of a whole file (CreateFileMapping on Windows, mmap elsewhere).
+// Pages are faulted in on first touch, so opening a large archive costs no reads at all.
+class MappedFile {
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map path; closes any previous mapping. Empty files fail.
+    bool Open(const std::string& path);
+    void Close();
+
+    const uint8_t* GetData() const {
+        return data;
+    }
+    size_t GetSize() const {
+        return size;
+    }
+    bool IsOpen() const {
+        return data != nullptr;
+    }
+
+  private:
+    const uint8_t* data = nullptr;
+    size_t size         = 0;
+#ifdef _WIN32
+    void* fileHandle    = nullptr; // HANDLE, kept opaque to avoid windows.h here
+    void* mappingHandle = nullptr;
+#endif
+};
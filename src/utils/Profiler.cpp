@@ -0,0 +1,313 @@
+#include "Profiler.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+thread_local uint32_t ProfileScope::currentDepth = 0;
+
+namespace {
+
+// GPU intervals kept for export
+constexpr uint32_t GpuCapacity = 4096;
+
+// Cached per thread so Record never takes the lock after the first call
+thread_local void* threadLog = nullptr;
+
+// Minimal JSON string escaping for event and thread names
+void WriteJsonString(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* c = text ? text : ""; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+            fputc(*c, file);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            fprintf(file, "\\u%04x", *c);
+        } else {
+            fputc(*c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+// One complete ("X") event; always follows the thread name metadata, hence the comma
+void WriteEvent(FILE* file, const ProfileEvent& event, uint32_t tid, uint64_t origin) {
+    fputs(",\n  {\"name\": ", file);
+    WriteJsonString(file, event.name);
+    fprintf(file,
+            ", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f, "
+            "\"args\": {\"frame\": %u}}",
+            tid,
+            Profiler::Get().ToNanoseconds(event.start - origin) / 1000.0,
+            Profiler::Get().ToNanoseconds(event.end - event.start) / 1000.0,
+            event.frame);
+}
+
+} // namespace
+
+// ========================================
+// 1. SETUP AND RECORDING
+// ========================================
+
+Profiler& Profiler::Get() {
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::Profiler() : frameIndex(0), exportRequested(false) {
+    gpuEvents.resize(GpuCapacity);
+    Calibrate();
+    frameStart = Now();
+}
+
+void Profiler::Calibrate() {
+#if PROFILER_USE_TSC
+    // Invariant TSC: measure its rate against steady_clock over a few milliseconds
+    using namespace std::chrono;
+    auto clockBegin   = steady_clock::now();
+    uint64_t tscBegin = __rdtsc();
+    while (steady_clock::now() - clockBegin < milliseconds(5)) {
+    }
+    auto clockEnd   = steady_clock::now();
+    uint64_t tscEnd = __rdtsc();
+
+    double elapsed = static_cast<double>(duration_cast<nanoseconds>(clockEnd - clockBegin).count());
+    nanosecondsPerTick = tscEnd > tscBegin ? elapsed / (tscEnd - tscBegin) : 1.0;
+#else
+    nanosecondsPerTick = 1.0;
+#endif
+}
+
+Profiler::ThreadLog* Profiler::GetThreadLog() {
+    if (threadLog) {
+        return static_cast<ThreadLog*>(threadLog);
+    }
+
+    // First marker on this thread: allocate its ring (kept until exit so traces survive)
+    std::lock_guard<std::mutex> lock(mutex);
+    logs.push_back(std::make_unique<ThreadLog>());
+    ThreadLog* log = logs.back().get();
+    log->threadId  = static_cast<uint32_t>(logs.size());
+    log->name      = "Thread " + std::to_string(log->threadId);
+    threadLog      = log;
+    return log;
+}
+
+void Profiler::SetThreadName(const char* name) {
+    ThreadLog* log = GetThreadLog();
+    std::lock_guard<std::mutex> lock(mutex);
+    log->name = name;
+}
+
+void Profiler::Record(const char* name, uint64_t start, uint64_t end, uint32_t depth) {
+    ThreadLog* log = GetThreadLog();
+
+    // Single writer: claim the slot, fill it, then publish with the release store. The
+    // fence keeps the fill after the previous head store for an exporter that sees it
+    uint64_t index  = log->head.load(std::memory_order_relaxed);
+    EventSlot& slot = log->events[index & (ThreadCapacity - 1)];
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.depth.store(depth, std::memory_order_relaxed);
+    slot.frame.store(frameIndex.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    log->head.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::RecordGpu(const char* name, uint64_t start, uint64_t end, uint32_t depth) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ProfileEvent& event = gpuEvents[gpuNext++ % GpuCapacity];
+    event.name          = name;
+    event.start         = start;
+    event.end           = end;
+    event.depth         = depth;
+    event.frame         = frameIndex.load(std::memory_order_relaxed);
+}
+
+// ========================================
+// 2. FRAME STATISTICS
+// ========================================
+
+void Profiler::FrameRing::Add(float value) {
+    samples[next] = value;
+    next          = (next + 1) % FrameHistory;
+    count         = std::min(count + 1, FrameHistory);
+}
+
+Profiler::FrameStats Profiler::FrameRing::Compute() const {
+    FrameStats stats;
+    if (count == 0) {
+        return stats;
+    }
+
+    float sorted[FrameHistory];
+    std::copy(samples, samples + count, sorted);
+    std::sort(sorted, sorted + count);
+
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < count; ++i) {
+        sum += sorted[i];
+    }
+    stats.samples = count;
+    stats.minMs   = sorted[0];
+    stats.maxMs   = sorted[count - 1];
+    stats.avgMs   = sum / count;
+    stats.p99Ms   = sorted[std::min(count - 1, (count * 99 + 99) / 100 - 1)];
+    return stats;
+}
+
+void Profiler::AddGpuFrame(float milliseconds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    gpuFrames.Add(milliseconds);
+}
+
+void Profiler::EndFrame() {
+    // The whole frame becomes one outermost event on the render thread
+    uint64_t now = Now();
+    Record("Frame", frameStart, now, 0);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cpuFrames.Add(static_cast<float>(ToNanoseconds(now - frameStart) / 1.0e6));
+    }
+    frameStart = now;
+    frameIndex.fetch_add(1, std::memory_order_relaxed);
+
+    if (exportRequested.exchange(false, std::memory_order_acq_rel)) {
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            path = exportPath;
+        }
+        FrameStats cpu = GetCpuFrameStats();
+        FrameStats gpu = GetGpuFrameStats();
+        LOG_INFO("Profiler: CPU frame min %.3f / avg %.3f / p99 %.3f ms, "
+                 "GPU frame avg %.3f / p99 %.3f ms",
+                 cpu.minMs,
+                 cpu.avgMs,
+                 cpu.p99Ms,
+                 gpu.avgMs,
+                 gpu.p99Ms);
+        if (ExportChromeTrace(path)) {
+            LOG_INFO("Profiler: trace written to %s", path.c_str());
+        } else {
+            LOG_ERROR("Profiler: failed to write %s", path.c_str());
+        }
+    }
+}
+
+Profiler::FrameStats Profiler::GetCpuFrameStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cpuFrames.Compute();
+}
+
+Profiler::FrameStats Profiler::GetGpuFrameStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return gpuFrames.Compute();
+}
+
+// ========================================
+// 3. CHROME TRACE EXPORT
+// ========================================
+
+void Profiler::RequestExport(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        exportPath = path;
+    }
+    exportRequested.store(true, std::memory_order_release);
+}
+
+bool Profiler::ExportChromeTrace(const std::string& path) {
+    // Snapshot every ring first so file I/O happens outside the lock
+    struct ThreadSnapshot {
+        uint32_t threadId;
+        std::string name;
+        std::vector<ProfileEvent> events;
+    };
+    std::vector<ThreadSnapshot> threads;
+    std::vector<ProfileEvent> gpu;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const std::unique_ptr<ThreadLog>& log : logs) {
+            ThreadSnapshot snapshot;
+            snapshot.threadId = log->threadId;
+            snapshot.name     = log->name;
+
+            // Writers keep going while we copy: take [head - capacity, head), then drop any
+            // slot the writer may have reused during the copy. Record fills slot `after`
+            // before it publishes head = after + 1, so that slot counts as reused too.
+            uint64_t head  = log->head.load(std::memory_order_acquire);
+            uint64_t first = head > ThreadCapacity ? head - ThreadCapacity : 0;
+            for (uint64_t i = first; i < head; ++i) {
+                const EventSlot& slot = log->events[i & (ThreadCapacity - 1)];
+                ProfileEvent event;
+                event.name  = slot.name.load(std::memory_order_relaxed);
+                event.start = slot.start.load(std::memory_order_relaxed);
+                event.end   = slot.end.load(std::memory_order_relaxed);
+                event.depth = slot.depth.load(std::memory_order_relaxed);
+                event.frame = slot.frame.load(std::memory_order_relaxed);
+                snapshot.events.push_back(event);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t after = log->head.load(std::memory_order_relaxed);
+            if (after + 1 > first + ThreadCapacity) {
+                size_t stale = static_cast<size_t>(after + 1 - ThreadCapacity - first);
+                stale        = std::min(stale, snapshot.events.size());
+                snapshot.events.erase(snapshot.events.begin(), snapshot.events.begin() + stale);
+            }
+            threads.push_back(std::move(snapshot));
+        }
+        for (uint32_t i = 0; i < std::min(gpuNext, GpuCapacity); ++i) {
+            gpu.push_back(gpuEvents[i]);
+        }
+    }
+
+    // Earliest timestamp becomes ts = 0
+    uint64_t origin = UINT64_MAX;
+    for (const ThreadSnapshot& thread : threads) {
+        for (const ProfileEvent& event : thread.events) {
+            origin = std::min(origin, event.start);
+        }
+    }
+    for (const ProfileEvent& event : gpu) {
+        origin = std::min(origin, event.start);
+    }
+    if (origin == UINT64_MAX) {
+        origin = 0;
+    }
+
+    FILE* file = nullptr;
+#ifdef _MSC_VER
+    fopen_s(&file, path.c_str(), "wb");
+#else
+    file = fopen(path.c_str(), "wb");
+#endif
+    if (!file) {
+        return false;
+    }
+
+    // GPU intervals go on tid 0, CPU threads keep their registration order
+    fputs("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [", file);
+    fputs("\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, "
+          "\"args\": {\"name\": \"GPU\"}}",
+          file);
+    for (const ThreadSnapshot& thread : threads) {
+        fprintf(file,
+                ",\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, "
+                "\"args\": {\"name\": ",
+                thread.threadId);
+        WriteJsonString(file, thread.name.c_str());
+        fputs("}}", file);
+    }
+    for (const ProfileEvent& event : gpu) {
+        WriteEvent(file, event, 0, origin);
+    }
+    for (const ThreadSnapshot& thread : threads) {
+        for (const ProfileEvent& event : thread.events) {
+            WriteEvent(file, event, thread.threadId, origin);
+        }
+    }
+    fputs("\n]}\n", file);
+    return fclose(file) == 0;
+}
@@ -0,0 +1,204 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+PROFILING_ENABLED: 1 compiles the PROFILE_* macros (and the GPU timers in Graphics) in,
+0 compiles them out entirely. Defaults to on in debug builds and off when NDEBUG is set;
+define it on the command line to override either way.
+*/
+#ifndef PROFILING_ENABLED
+#ifdef NDEBUG
+#define PROFILING_ENABLED 0
+#else
+#define PROFILING_ENABLED 1
+#endif
+#endif
+
+// The time stamp counter is read directly where available: a marker then costs two
+// ~10-cycle reads instead of two OS clock calls
+#if defined(_M_X64) || defined(__x86_64__)
+#define PROFILER_USE_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#define PROFILER_USE_TSC 0
+#endif
+
+// Profile Event
+// One closed CPU or GPU interval; name must point to a string literal (never copied)
+struct ProfileEvent {
+    const char* name = nullptr;
+    uint64_t start   = 0; // Profiler::Now() ticks
+    uint64_t end     = 0;
+    uint32_t depth   = 0; // Nesting level within its thread (0 = outermost)
+    uint32_t frame   = 0; // Frame index the event was recorded in
+};
+
+// Profiler Class
+// Process-wide CPU profiler. Scoped markers append to a per-thread ring buffer owned by the
+// recording thread (no locks, no allocation after the first marker on a thread). The render
+// thread calls EndFrame once per frame to roll frame statistics; ExportChromeTrace writes
+// everything still in the rings as chrome://tracing / Perfetto JSON.
+class Profiler {
+  public:
+    // Events kept per thread; older ones are overwritten
+    static constexpr uint32_t ThreadCapacity = 1u << 14;
+    // Frames kept for the rolling statistics
+    static constexpr uint32_t FrameHistory = 240;
+
+    // Rolling frame time statistics in milliseconds
+    struct FrameStats {
+        uint32_t samples = 0;
+        float minMs      = 0.0f;
+        float avgMs      = 0.0f;
+        float p99Ms      = 0.0f;
+        float maxMs      = 0.0f;
+    };
+
+    static Profiler& Get();
+
+    // Monotonic timestamp in ticks (TSC cycles, or nanoseconds without a TSC)
+    static uint64_t Now() {
+#if PROFILER_USE_TSC
+        return __rdtsc();
+#else
+        using namespace std::chrono;
+        return static_cast<uint64_t>(
+            duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Convert between tick deltas and nanoseconds (calibrated once at startup)
+    double ToNanoseconds(uint64_t ticks) const {
+        return ticks * nanosecondsPerTick;
+    }
+    uint64_t FromNanoseconds(double nanoseconds) const {
+        return static_cast<uint64_t>(nanoseconds / nanosecondsPerTick);
+    }
+
+    // Label the calling thread in exported traces
+    void SetThreadName(const char* name);
+
+    /*
+    Record a closed interval on the calling thread
+    Used by ProfileScope; lock-free, single writer per ring
+    */
+    void Record(const char* name, uint64_t start, uint64_t end, uint32_t depth);
+
+    // Record a GPU interval already converted to Now() ticks (render thread)
+    void RecordGpu(const char* name, uint64_t start, uint64_t end, uint32_t depth);
+
+    // Feed one resolved GPU frame time (GpuProfiler, a few frames late)
+    void AddGpuFrame(float milliseconds);
+
+    // Render thread: close the current frame, roll statistics and service export requests
+    void EndFrame();
+
+    FrameStats GetCpuFrameStats() const;
+    FrameStats GetGpuFrameStats() const;
+    uint32_t GetFrameIndex() const {
+        return frameIndex.load(std::memory_order_relaxed);
+    }
+
+    // Ask for a trace at the end of the current frame (safe from any thread)
+    void RequestExport(const std::string& path);
+
+    // Write the buffered events as Chrome trace JSON
+    bool ExportChromeTrace(const std::string& path);
+
+  private:
+    // One ring entry; fields are relaxed atomics so the exporter may copy a slot while its
+    // writer reuses it (the copy is then discarded, see ExportChromeTrace)
+    struct EventSlot {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> start{0};
+        std::atomic<uint64_t> end{0};
+        std::atomic<uint32_t> depth{0};
+        std::atomic<uint32_t> frame{0};
+    };
+
+    // Per-thread event ring; only the owning thread writes events and head
+    struct ThreadLog {
+        EventSlot events[ThreadCapacity];
+        std::atomic<uint64_t> head{0};
+        uint32_t threadId = 0;
+        std::string name;
+    };
+
+    // Frame time samples, oldest overwritten first
+    struct FrameRing {
+        float samples[FrameHistory] = {};
+        uint32_t count              = 0;
+        uint32_t next               = 0;
+
+        void Add(float value);
+        FrameStats Compute() const;
+    };
+
+    Profiler();
+
+    ThreadLog* GetThreadLog();
+    void Calibrate();
+
+    double nanosecondsPerTick = 1.0;
+
+    mutable std::mutex mutex; // Guards logs, gpuEvents, frame rings and exportPath
+    std::vector<std::unique_ptr<ThreadLog>> logs;
+    std::vector<ProfileEvent> gpuEvents; // Ring of GPU intervals
+    uint32_t gpuNext = 0;
+    FrameRing cpuFrames;
+    FrameRing gpuFrames;
+
+    std::atomic<uint32_t> frameIndex;
+    uint64_t frameStart = 0;
+    std::string exportPath;
+    std::atomic<bool> exportRequested;
+};
+
+// Profile Scope Class
+// RAII marker: records [construction, destruction) on the calling thread
+class ProfileScope {
+  public:
+    explicit ProfileScope(const char* scopeName) : name(scopeName) {
+        depth = currentDepth++;
+        start = Profiler::Now();
+    }
+    ~ProfileScope() {
+        uint64_t end = Profiler::Now();
+        --currentDepth;
+        Profiler::Get().Record(name, start, end, depth);
+    }
+
+    ProfileScope(const ProfileScope&)            = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+  private:
+    static thread_local uint32_t currentDepth;
+
+    const char* name;
+    uint64_t start;
+    uint32_t depth;
+};
+
+#if PROFILING_ENABLED
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b)       PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name)        ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION()         PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_THREAD_NAME(name)  Profiler::Get().SetThreadName(name)
+#define PROFILE_END_FRAME()        Profiler::Get().EndFrame()
+#else
+#define PROFILE_SCOPE(name)       ((void)0)
+#define PROFILE_FUNCTION()        ((void)0)
+#define PROFILE_THREAD_NAME(name) ((void)0)
+#define PROFILE_END_FRAME()       ((void)0)
+#endif
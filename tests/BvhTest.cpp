@@ -0,0 +1,224 @@
+#include "Test.h"
+#include "scene/Bvh.h"
+#include "threading/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+/*
+Row-vector view-projection (clip = p * M, depth in [0, w]) of a camera at position turned
+yaw radians about +y from looking down +z, with a 60 degree vertical field of view
+*/
+Frustum MakeFrustum(const float position[3], float yaw, float nearZ = 0.5f, float farZ = 300.0f) {
+    const float right[3]   = {std::cos(yaw), 0.0f, -std::sin(yaw)};
+    const float up[3]      = {0.0f, 1.0f, 0.0f};
+    const float forward[3] = {std::sin(yaw), 0.0f, std::cos(yaw)};
+    const float yScale     = 1.0f / std::tan(0.5236f);
+    const float xScale     = yScale * 9.0f / 16.0f;
+    const float depth      = farZ / (farZ - nearZ);
+
+    auto dot = [&](const float axis[3]) {
+        return axis[0] * position[0] + axis[1] * position[1] + axis[2] * position[2];
+    };
+    float m[16];
+    for (int i = 0; i < 3; ++i) {
+        m[i * 4 + 0] = xScale * right[i];
+        m[i * 4 + 1] = yScale * up[i];
+        m[i * 4 + 2] = depth * forward[i];
+        m[i * 4 + 3] = forward[i];
+    }
+    m[12] = -xScale * dot(right);
+    m[13] = -yScale * dot(up);
+    m[14] = -depth * dot(forward) - depth * nearZ;
+    m[15] = -dot(forward);
+    return Frustum::FromViewProjection(m);
+}
+
+// count boxes of 0.5 to 5 units scattered through a 400-unit cube around the origin
+BoundsArray MakeBounds(uint32_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> center(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> extent(0.25f, 2.5f);
+    BoundsArray bounds;
+    bounds.Resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        float min[3], max[3];
+        for (int axis = 0; axis < 3; ++axis) {
+            const float c = center(rng);
+            const float e = extent(rng);
+            min[axis]     = c - e;
+            max[axis]     = c + e;
+        }
+        bounds.Set(i, min, max);
+    }
+    return bounds;
+}
+
+// Frusta looking around from a few places, some well outside the scene
+std::vector<Frustum> MakeFrusta() {
+    std::vector<Frustum> frusta;
+    const float positions[][3] = {{0.0f, 0.0f, 0.0f},
+                                  {150.0f, 20.0f, -180.0f},
+                                  {0.0f, 0.0f, -400.0f}};
+    for (const float(&position)[3] : positions) {
+        for (int step = 0; step < 6; ++step) {
+            frusta.push_back(MakeFrustum(position, step * 1.0472f));
+        }
+    }
+    return frusta;
+}
+
+// Indices passing Frustum::TestBox, in increasing order
+std::vector<uint32_t> Reference(const Frustum& frustum, const BoundsArray& bounds) {
+    std::vector<uint32_t> visible(bounds.Size());
+    visible.resize(CullBoxesScalar(frustum, bounds, visible.data()));
+    return visible;
+}
+
+std::vector<uint32_t> Sorted(std::vector<uint32_t> indices) {
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+} // namespace
+
+TEST(IdentityMatrixGivesTheClipVolume) {
+    // clip = p: -1 <= x, y <= 1 and 0 <= z <= 1
+    const float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+    const Frustum frustum    = Frustum::FromViewProjection(identity);
+
+    const float insideMin[3]   = {-0.5f, -0.5f, 0.2f};
+    const float insideMax[3]   = {0.5f, 0.5f, 0.8f};
+    const float straddleMin[3] = {0.9f, 0.0f, 0.5f};
+    const float straddleMax[3] = {1.5f, 0.1f, 0.6f};
+    const float behindMin[3]   = {0.0f, 0.0f, -0.5f};
+    const float behindMax[3]   = {0.1f, 0.1f, -0.1f};
+    const float leftMin[3]     = {-3.0f, 0.0f, 0.5f};
+    const float leftMax[3]     = {-1.5f, 0.1f, 0.6f};
+    CHECK(frustum.TestBox(insideMin, insideMax));
+    CHECK(frustum.TestBox(straddleMin, straddleMax));
+    CHECK(!frustum.TestBox(behindMin, behindMax));
+    CHECK(!frustum.TestBox(leftMin, leftMax));
+
+    // Test4 agrees, and only the first box is entirely inside
+    BoundsArray bounds;
+    bounds.Resize(4);
+    bounds.Set(0, insideMin, insideMax);
+    bounds.Set(1, straddleMin, straddleMax);
+    bounds.Set(2, behindMin, behindMax);
+    bounds.Set(3, leftMin, leftMax);
+    const FrustumTest test(frustum);
+    FrustumTest::Result result = test.Test4(bounds.minX.data(),
+                                            bounds.minY.data(),
+                                            bounds.minZ.data(),
+                                            bounds.maxX.data(),
+                                            bounds.maxY.data(),
+                                            bounds.maxZ.data());
+    CHECK(result.visible == 0x3);
+    CHECK(result.inside == 0x1);
+}
+
+TEST(PaddingBoxesAreNeverVisible) {
+    BoundsArray bounds = MakeBounds(5, 1);
+    CHECK(bounds.Size() == 5);
+    CHECK(bounds.minX.size() == 8);
+
+    // A volume 10000 units across sees every box but still rejects the three padding ones
+    const float everywhere[16] = {1e-4f, 0, 0, 0, 0, 1e-4f, 0, 0, 0, 0, 1e-4f, 0, 0, 0, 0.5f, 1};
+    std::vector<uint32_t> visible(8);
+    CHECK(CullBoxes(Frustum::FromViewProjection(everywhere), bounds, visible.data()) == 5);
+}
+
+TEST(LinearSimdCullMatchesScalar) {
+    for (uint32_t count : {0u, 1u, 3u, 4u, 5u, 9u, 20000u}) {
+        const BoundsArray bounds = MakeBounds(count, count + 1);
+        for (const Frustum& frustum : MakeFrusta()) {
+            std::vector<uint32_t> visible(count);
+            visible.resize(CullBoxes(frustum, bounds, visible.data()));
+            CHECK(visible == Reference(frustum, bounds));
+        }
+    }
+}
+
+TEST(BvhCullMatchesScalar) {
+    // Single leaf, one level, and a deep tree
+    for (uint32_t count : {0u, 1u, 4u, 5u, 17u, 1000u, 50000u}) {
+        const BoundsArray bounds = MakeBounds(count, count + 2);
+        Bvh bvh;
+        bvh.Build(bounds);
+        CHECK(bvh.GetObjectCount() == count);
+
+        std::vector<uint32_t> visible;
+        for (const Frustum& frustum : MakeFrusta()) {
+            CHECK(bvh.Cull(frustum, visible) == visible.size());
+            CHECK(Sorted(visible) == Reference(frustum, bounds));
+        }
+    }
+}
+
+TEST(BvhReducesTheTestCount) {
+    const BoundsArray bounds = MakeBounds(50000, 3);
+    Bvh bvh;
+    bvh.Build(bounds);
+    CHECK(bvh.GetCost() > 0.0f);
+    CHECK(bvh.GetCost() < 0.5f);
+
+    // The test frusta are selective, so the comparisons above mean something
+    const float origin[3] = {0.0f, 0.0f, 0.0f};
+    std::vector<uint32_t> visible;
+    const uint32_t count = bvh.Cull(MakeFrustum(origin, 0.0f), visible);
+    CHECK(count > bounds.Size() / 100);
+    CHECK(count < bounds.Size() / 2);
+}
+
+TEST(RefitTracksMovedObjects) {
+    const uint32_t count = 20000;
+    BoundsArray bounds   = MakeBounds(count, 4);
+    Bvh bvh;
+    bvh.Build(bounds);
+    const float builtCost = bvh.GetCost();
+
+    // Move a tenth of the objects to random places; the tree is unchanged but still exact
+    std::mt19937 rng(5);
+    const BoundsArray moved = MakeBounds(count, 6);
+    for (uint32_t step = 0; step < count / 10; ++step) {
+        const uint32_t i   = rng() % count;
+        const float min[3] = {moved.minX[i], moved.minY[i], moved.minZ[i]};
+        const float max[3] = {moved.maxX[i], moved.maxY[i], moved.maxZ[i]};
+        bounds.Set(i, min, max);
+    }
+    bvh.Refit(bounds);
+    CHECK(bvh.GetCost() > builtCost);
+
+    std::vector<uint32_t> visible;
+    for (const Frustum& frustum : MakeFrusta()) {
+        bvh.Cull(frustum, visible);
+        CHECK(Sorted(visible) == Reference(frustum, bounds));
+    }
+
+    // A rebuild brings the cost back down
+    bvh.Build(bounds);
+    CHECK(bvh.GetCost() < builtCost * 1.1f);
+}
+
+TEST(ParallelCullMatchesSerial) {
+    const BoundsArray bounds = MakeBounds(100000, 7);
+    JobSystem jobSystem;
+    REQUIRE(jobSystem.Initialize(4));
+    Bvh bvh;
+    bvh.SetParallelFor(jobSystem.GetTaskExecutor());
+    bvh.Build(bounds);
+
+    std::vector<uint32_t> serial;
+    std::vector<uint32_t> parallel;
+    for (const Frustum& frustum : MakeFrusta()) {
+        bvh.Cull(frustum, serial);
+        CHECK(bvh.CullParallel(frustum, parallel) == parallel.size());
+        CHECK(Sorted(parallel) == Sorted(serial));
+        CHECK(Sorted(parallel) == Reference(frustum, bounds));
+    }
+    jobSystem.Shutdown();
+}
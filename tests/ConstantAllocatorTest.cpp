@@ -0,0 +1,474 @@
+#include "Test.h"
+#include "render/ConstantAllocator.h"
+#include "render/MatrixBatch.h"
+#include "render/ObjectSubmitter.h"
+#include "render/RenderQueue.h"
+#include "render/StateCache.h"
+#include "threading/JobSystem.h"
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Cache-line aligned bytes, like a mapped buffer, so the streaming store path is taken
+struct alignas(64) Line {
+    uint8_t bytes[64];
+};
+
+class AlignedBytes {
+  public:
+    explicit AlignedBytes(size_t size) : lines((size + 63) / 64) {}
+
+    uint8_t* Data() {
+        return lines.front().bytes;
+    }
+
+  private:
+    std::vector<Line> lines;
+};
+
+// Pages in ordinary memory; can be told to fail
+class MemoryTarget : public ConstantAllocator::Target {
+  public:
+    explicit MemoryTarget(uint32_t slotsPerPage) : pageBytes(slotsPerPage * 256) {}
+
+    std::vector<uint32_t> mapped; // Pages in the order they were mapped
+    uint32_t allocated = 0;       // Slots reported through OnAllocated
+    uint32_t failAfter = 0;       // When nonzero, fail once this many pages are mapped
+    bool fail          = false;
+
+    uint8_t* MapPage(uint32_t page) override {
+        if (fail || (failAfter > 0 && mapped.size() >= failAfter)) {
+            return nullptr;
+        }
+        mapped.push_back(page);
+        while (pages.size() <= page) {
+            pages.emplace_back(pageBytes);
+        }
+        return pages[page].Data();
+    }
+
+    void OnAllocated(uint32_t, uint32_t slotCount) override {
+        allocated += slotCount;
+    }
+
+    uint8_t* GetPage(uint32_t page) {
+        return pages[page].Data();
+    }
+
+  private:
+    size_t pageBytes;
+    std::vector<AlignedBytes> pages;
+};
+
+std::vector<Float4x4> RandomMatrices(uint32_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(-2.0f, 2.0f);
+    std::vector<Float4x4> matrices(count);
+    for (Float4x4& matrix : matrices) {
+        for (auto& row : matrix.m) {
+            for (float& value : row) {
+                value = unit(rng);
+            }
+        }
+    }
+    return matrices;
+}
+
+// The SIMD path sums the same products in the same order as the scalar one; the tolerance
+// only allows for a compiler contracting them into fused multiply-adds
+bool SameResults(const uint8_t* actual, const uint8_t* expected, uint32_t count, size_t stride) {
+    for (uint32_t i = 0; i < count; ++i) {
+        float a[16];
+        float b[16];
+        std::memcpy(a, actual + i * stride, sizeof(a));
+        std::memcpy(b, expected + i * stride, sizeof(b));
+        for (int k = 0; k < 16; ++k) {
+            if (!Test::Near(a[k], b[k], 1e-5 * (1.0 + std::fabs(b[k])))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Logs the constant buffer window bound at each draw
+class RecordingSink : public ContextSink {
+  public:
+    struct Binding {
+        void* buffer           = nullptr;
+        uint32_t firstConstant = 0;
+        uint32_t constantCount = 0;
+    };
+    Binding bound;
+    std::vector<Binding> draws;
+    uint32_t bindCalls = 0;
+
+    void SetInputLayout(void*) override {}
+    void SetPrimitiveTopology(uint32_t) override {}
+    void SetIndexBuffer(void*, uint32_t, uint32_t) override {}
+    void SetVertexBuffer(uint32_t, void*, uint32_t, uint32_t) override {}
+    void SetVertexShader(void*) override {}
+    void SetPixelShader(void*) override {}
+    void SetPixelShaderResource(uint32_t, void*) override {}
+    void SetPixelSampler(uint32_t, void*) override {}
+    void SetVertexConstantBuffer(uint32_t slot,
+                                 void* buffer,
+                                 uint32_t firstConstant,
+                                 uint32_t constantCount) override {
+        if (slot == 0) {
+            bound = {buffer, firstConstant, constantCount};
+            ++bindCalls;
+        }
+    }
+    void SetRasterizerState(void*) override {}
+    void SetViewport(float, float, float, float) override {}
+    void SetDepthStencilState(void*, uint32_t) override {}
+    void SetBlendState(void*, const float*, uint32_t) override {}
+    void SetRenderTarget(void*, void*) override {}
+    void Draw(uint32_t, uint32_t) override {
+        draws.push_back(bound);
+    }
+    void DrawIndexed(uint32_t, uint32_t, int32_t) override {}
+    void DrawInstanced(uint32_t, uint32_t, uint32_t, uint32_t) override {}
+    void DrawIndexedInstanced(uint32_t, uint32_t, uint32_t, int32_t, uint32_t) override {}
+};
+
+// The backend's dispatcher for object packets: bind the packet's slot window of its page
+// (ConstantBufferPool::BindVertex) through the cache, then draw. Page p's buffer is the
+// fake pointer p + 1
+class ObjectDispatcher : public RenderQueue::Dispatcher {
+  public:
+    ObjectDispatcher(const ConstantAllocator& allocator, StateCache& state)
+        : allocator(allocator), state(state) {}
+
+    void BindShader(uint32_t) override {}
+    void BindMaterial(uint32_t) override {}
+    void BindGeometry(uint32_t, uint32_t) override {}
+    void Draw(const DrawPacket& packet) override {
+        const uintptr_t page = allocator.GetPage(packet.constants);
+        state.SetVertexConstantBuffer(0,
+                                      reinterpret_cast<void*>(page + 1),
+                                      allocator.GetFirstConstant(packet.constants),
+                                      ConstantAllocator::ConstantsPerSlot);
+        state.Draw(packet.vertexCount, packet.startVertex);
+    }
+
+  private:
+    const ConstantAllocator& allocator;
+    StateCache& state;
+};
+
+DrawPacket ObjectPacket() {
+    DrawPacket packet    = {};
+    packet.sortKey       = SortKey::Make(0, 1, 0, 0);
+    packet.geometry      = 1;
+    packet.vertexCount   = 3;
+    packet.instanceCount = 1;
+    packet.constants     = ConstantAllocator::InvalidSlot;
+    return packet;
+}
+
+} // namespace
+
+TEST(Float4x4MultiplyAppliesLeftThenRight) {
+    // Scale by 2, then translate by (1, 2, 3): the row-vector convention puts the
+    // translation in row 3 and composes left to right
+    Float4x4 scale     = Float4x4::Identity();
+    scale.m[0][0]      = 2.0f;
+    scale.m[1][1]      = 2.0f;
+    scale.m[2][2]      = 2.0f;
+    Float4x4 translate = Float4x4::Identity();
+    translate.m[3][0]  = 1.0f;
+    translate.m[3][1]  = 2.0f;
+    translate.m[3][2]  = 3.0f;
+
+    const Float4x4 both = Float4x4::Multiply(scale, translate);
+    CHECK(both.m[0][0] == 2.0f);
+    CHECK(both.m[3][0] == 1.0f);
+    CHECK(both.m[3][1] == 2.0f);
+    CHECK(both.m[3][2] == 3.0f);
+    CHECK(both.m[3][3] == 1.0f);
+
+    // The other order scales the translation too
+    const Float4x4 reverse = Float4x4::Multiply(translate, scale);
+    CHECK(reverse.m[3][0] == 2.0f);
+    CHECK(reverse.m[3][2] == 6.0f);
+
+    const std::vector<Float4x4> random = RandomMatrices(2, 4);
+    const Float4x4 product             = Float4x4::Multiply(random[0], random[1]);
+    Float4x4 expected;
+    MatrixBatch::MultiplyRangeScalar(&random[0], random[1], 0, 1, &expected, sizeof(expected));
+    CHECK(SameResults(reinterpret_cast<const uint8_t*>(&product),
+                      reinterpret_cast<const uint8_t*>(&expected),
+                      1,
+                      sizeof(Float4x4)));
+}
+
+TEST(MatrixBatchMatchesScalarAtAnyStride) {
+    // Packed, constant buffer slots (streaming stores), an unaligned base and an odd stride
+    const uint32_t count             = 37;
+    const std::vector<Float4x4> left = RandomMatrices(count, 1);
+    const Float4x4 right             = RandomMatrices(1, 2)[0];
+    const size_t strides[]           = {64, 256, 256, 80};
+    const size_t offsets[]           = {0, 0, 4, 16};
+    for (int c = 0; c < 4; ++c) {
+        const size_t stride = strides[c];
+        const size_t bytes  = count * stride + 64;
+        AlignedBytes actualBytes(bytes);
+        AlignedBytes expectedBytes(bytes);
+        uint8_t* actual   = actualBytes.Data();
+        uint8_t* expected = expectedBytes.Data();
+        std::memset(actual, 0xCD, bytes);
+        std::memset(expected, 0xCD, bytes);
+
+        MatrixBatch::MultiplyRange(left.data(), right, 0, count, actual + offsets[c], stride);
+        MatrixBatch::MultiplyRangeScalar(left.data(),
+                                         right,
+                                         0,
+                                         count,
+                                         expected + offsets[c],
+                                         stride);
+        CHECK(SameResults(actual + offsets[c], expected + offsets[c], count, stride));
+
+        // Nothing between or around the results is touched
+        bool untouched = true;
+        for (size_t i = 0; i < bytes; ++i) {
+            const size_t at     = i - offsets[c];
+            const bool inResult = i >= offsets[c] && at < count * stride && at % stride < 64;
+            untouched = untouched && (inResult || actual[i] == 0xCD);
+        }
+        CHECK(untouched);
+    }
+
+    // A partial range writes only its own results
+    const Float4x4 identity = Float4x4::Identity();
+    std::vector<Float4x4> partial(count, identity);
+    MatrixBatch::MultiplyRange(left.data(), right, 10, 20, partial.data(), sizeof(Float4x4));
+    CHECK(std::memcmp(&partial[9], &identity, sizeof(Float4x4)) == 0);
+    CHECK(std::memcmp(&partial[20], &identity, sizeof(Float4x4)) == 0);
+    CHECK(std::memcmp(&partial[10], &identity, sizeof(Float4x4)) != 0);
+}
+
+TEST(MatrixBatchSplitsLargeBatchesAcrossTheJobSystem) {
+    const uint32_t count             = MatrixBatch::ChunkSize * 3 + 17;
+    const std::vector<Float4x4> left = RandomMatrices(count, 5);
+    const Float4x4 right             = RandomMatrices(1, 6)[0];
+    std::vector<uint8_t> expected(count * 256);
+    MatrixBatch serial;
+    serial.Multiply(left.data(), right, count, expected.data(), 256);
+
+    JobSystem jobSystem;
+    jobSystem.Initialize();
+    MatrixBatch parallel;
+    parallel.SetParallelFor(jobSystem.GetTaskExecutor());
+    AlignedBytes actual(count * 256);
+    parallel.Multiply(left.data(), right, count, actual.Data(), 256);
+    jobSystem.Shutdown();
+
+    CHECK(SameResults(actual.Data(), expected.data(), count, 256));
+}
+
+TEST(ConstantAllocatorFillsPagesInOrder) {
+    ConstantAllocator allocator(64);
+    MemoryTarget target(64);
+    allocator.BeginFrame();
+    CHECK(target.mapped.empty()); // Nothing mapped before the first allocation
+
+    ConstantAllocator::Run run = allocator.Allocate(target, 40);
+    CHECK(run.objectCount == 40);
+    CHECK(run.firstSlot == 0);
+    CHECK(run.cpuPtr == target.GetPage(0));
+
+    // A run stops at the end of the page; the caller asks again for the rest
+    run = allocator.Allocate(target, 40);
+    CHECK(run.objectCount == 24);
+    CHECK(run.firstSlot == 40);
+    CHECK(run.cpuPtr == target.GetPage(0) + 40 * ConstantAllocator::SlotSize);
+    run = allocator.Allocate(target, 16);
+    CHECK(run.objectCount == 16);
+    CHECK(run.firstSlot == 64);
+    CHECK(allocator.GetPage(run.firstSlot) == 1);
+    CHECK(allocator.GetFirstConstant(run.firstSlot) == 0);
+    CHECK(allocator.GetFirstConstant(run.firstSlot + 5) == 5 * 16);
+    REQUIRE(target.mapped.size() == 2);
+    CHECK(target.mapped[0] == 0 && target.mapped[1] == 1); // Each page once
+
+    uint8_t* cpuPtr     = nullptr;
+    const uint32_t slot = allocator.AllocateOne(target, 1, &cpuPtr);
+    CHECK(slot == 80);
+    CHECK(cpuPtr == target.GetPage(1) + 16 * ConstantAllocator::SlotSize);
+
+    const ConstantAllocator::Stats& stats = allocator.GetStats();
+    CHECK(stats.objects == 81);
+    CHECK(stats.slots == 81);
+    CHECK(stats.pages == 2);
+    CHECK(stats.slotsWasted == 0);
+
+    // The next frame starts over at page 0 and maps it again
+    allocator.BeginFrame();
+    CHECK(allocator.GetStats().objects == 0);
+    run = allocator.Allocate(target, 1);
+    CHECK(run.firstSlot == 0);
+    CHECK(target.mapped.size() == 3);
+    CHECK(target.mapped.back() == 0);
+}
+
+TEST(ConstantAllocatorMultiSlotObjectsAndClosedPages) {
+    ConstantAllocator allocator(64);
+    MemoryTarget target(64);
+    allocator.BeginFrame();
+
+    // Objects of 3 slots: 21 fit in a page, the last slot is wasted
+    ConstantAllocator::Run run = allocator.Allocate(target, 30, 3);
+    CHECK(run.objectCount == 21);
+    run = allocator.Allocate(target, 9, 3);
+    CHECK(run.objectCount == 9);
+    CHECK(run.firstSlot == 64);
+    CHECK(allocator.GetStats().slotsWasted == 1);
+    CHECK(allocator.GetStats().slots == 90);
+
+    // A closed page is never written again: the next run starts a fresh page
+    allocator.ClosePage();
+    run = allocator.Allocate(target, 1);
+    CHECK(run.firstSlot == 128);
+    CHECK(allocator.GetStats().slotsWasted == 1 + 64 - 27);
+    CHECK(allocator.GetStats().pages == 3);
+
+    // Requests that cannot be placed
+    CHECK(allocator.Allocate(target, 0).objectCount == 0);
+    CHECK(allocator.Allocate(target, 1, 0).objectCount == 0);
+    CHECK(allocator.Allocate(target, 1, 65).objectCount == 0); // Bigger than a page
+    ConstantAllocator large(1024);
+    CHECK(large.Allocate(target, 1, ConstantAllocator::MaxSlotsPerObject + 1).objectCount == 0);
+
+    // A target that cannot map leaves nothing half placed
+    target.fail = true;
+    allocator.ClosePage();
+    run = allocator.Allocate(target, 5);
+    CHECK(run.objectCount == 0);
+    CHECK(run.firstSlot == ConstantAllocator::InvalidSlot);
+    uint8_t* cpuPtr = reinterpret_cast<uint8_t*>(1);
+    CHECK(allocator.AllocateOne(target, 1, &cpuPtr) == ConstantAllocator::InvalidSlot);
+    CHECK(cpuPtr == nullptr);
+    target.fail = false;
+    run         = allocator.Allocate(target, 5);
+    CHECK(run.objectCount == 5);
+}
+
+TEST(ConstantAllocatorAndMatrixBatchFillSlots) {
+    // The Graphics pattern: run by run, one batched multiply straight into the page
+    const uint32_t count              = 1000;
+    const std::vector<Float4x4> world = RandomMatrices(count, 8);
+    const Float4x4 viewProjection     = RandomMatrices(1, 9)[0];
+    ConstantAllocator allocator(256);
+    MemoryTarget target(256);
+    MatrixBatch batch;
+    allocator.BeginFrame();
+
+    std::vector<uint32_t> slots;
+    uint32_t placed = 0;
+    while (placed < count) {
+        const ConstantAllocator::Run run = allocator.Allocate(target, count - placed);
+        REQUIRE(run.objectCount > 0);
+        batch.Multiply(world.data() + placed,
+                       viewProjection,
+                       run.objectCount,
+                       run.cpuPtr,
+                       ConstantAllocator::SlotSize);
+        for (uint32_t i = 0; i < run.objectCount; ++i) {
+            slots.push_back(run.firstSlot + i);
+        }
+        placed += run.objectCount;
+    }
+    CHECK(allocator.GetStats().pages == 4);
+
+    bool matches = true;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t slot = slots[i];
+        const uint8_t* data = target.GetPage(allocator.GetPage(slot)) +
+                              allocator.GetFirstConstant(slot) * 16;
+        Float4x4 expected;
+        MatrixBatch::MultiplyRangeScalar(&world[i], viewProjection, 0, 1, &expected, 64);
+        matches = matches && SameResults(data, reinterpret_cast<const uint8_t*>(&expected), 1, 64);
+    }
+    CHECK(matches);
+}
+
+TEST(ObjectSubmitterBindsEachObjectsSlotForItsDraw) {
+    // Two batches over three 64-slot pages, replayed through the queue into a recording
+    // sink: one draw per object, each bound to its own 256-byte window of world * VP
+    const std::vector<Float4x4> first  = RandomMatrices(100, 10);
+    const std::vector<Float4x4> second = RandomMatrices(37, 11);
+    const Float4x4 viewProjection      = RandomMatrices(1, 12)[0];
+    ConstantAllocator allocator(64);
+    MemoryTarget target(64);
+    MatrixBatch batch;
+    RenderQueue queue;
+    queue.Reserve(256);
+    allocator.BeginFrame();
+
+    ObjectSubmitter submitter;
+    submitter.Add(first.data(), 100);
+    submitter.Add(second.data(), 0);
+    submitter.Add(second.data(), 37);
+    CHECK(submitter.GetCount() == 137);
+    const uint32_t submitted =
+        submitter.Submit(allocator, target, batch, viewProjection, ObjectPacket(), queue);
+    CHECK(submitted == 137);
+    CHECK(submitter.GetCount() == 0);
+    CHECK(queue.GetPacketCount() == 137);
+    CHECK(target.mapped.size() == 3);
+    CHECK(target.allocated == 137);
+
+    RecordingSink sink;
+    StateCache state(sink);
+    ObjectDispatcher dispatcher(allocator, state);
+    queue.Sort();
+    queue.Execute(dispatcher);
+    REQUIRE(sink.draws.size() == 137);
+    CHECK(sink.bindCalls == 137); // Every window differs, so none is elided
+
+    // Equal keys keep submission order, so draw i is object i
+    bool bindings = true;
+    bool contents = true;
+    for (uint32_t i = 0; i < 137; ++i) {
+        const RecordingSink::Binding& binding = sink.draws[i];
+        const uintptr_t page                  = i / 64;
+        bindings = bindings && binding.buffer == reinterpret_cast<void*>(page + 1) &&
+                   binding.firstConstant == i % 64 * ConstantAllocator::ConstantsPerSlot &&
+                   binding.constantCount == ConstantAllocator::ConstantsPerSlot;
+
+        const Float4x4& world = i < 100 ? first[i] : second[i - 100];
+        Float4x4 expected;
+        MatrixBatch::MultiplyRangeScalar(&world, viewProjection, 0, 1, &expected, 64);
+        const uint8_t* data = target.GetPage(static_cast<uint32_t>(page)) +
+                              binding.firstConstant * 16;
+        contents =
+            contents && SameResults(data, reinterpret_cast<const uint8_t*>(&expected), 1, 64);
+    }
+    CHECK(bindings);
+    CHECK(contents);
+}
+
+TEST(ObjectSubmitterDropsWhatTheTargetCannotMap) {
+    const std::vector<Float4x4> world = RandomMatrices(100, 13);
+    ConstantAllocator allocator(64);
+    MemoryTarget target(64);
+    target.failAfter = 1;
+    MatrixBatch batch;
+    RenderQueue queue;
+    queue.Reserve(128);
+    allocator.BeginFrame();
+
+    // The first page holds 64 objects; the rest are dropped and the queue still empties
+    ObjectSubmitter submitter;
+    submitter.Add(world.data(), 100);
+    const uint32_t submitted =
+        submitter.Submit(allocator, target, batch, Float4x4::Identity(), ObjectPacket(), queue);
+    CHECK(submitted == 64);
+    CHECK(queue.GetPacketCount() == 64);
+    CHECK(submitter.GetCount() == 0);
+}
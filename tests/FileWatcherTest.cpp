@@ -0,0 +1,148 @@
+#include "Test.h"
+#include "utils/FileWatcher.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Fresh empty directory for one test, removed with everything in it afterwards
+class TempDirectory {
+  public:
+    TempDirectory() {
+        path = fs::temp_directory_path() / ("FileWatcherTest." + std::to_string(counter++));
+        fs::remove_all(path);
+        fs::create_directories(path);
+    }
+    ~TempDirectory() {
+        std::error_code error;
+        fs::remove_all(path, error);
+    }
+
+    std::string File(const char* name) const {
+        return (path / name).string();
+    }
+
+    fs::path path;
+
+  private:
+    static inline int counter = 0;
+};
+
+void WriteText(const std::string& path, const char* text) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file) {
+        std::fputs(text, file);
+        std::fclose(file);
+    }
+}
+
+// Collects callbacks from the watcher thread
+struct Bursts {
+    std::mutex mutex;
+    std::condition_variable arrived;
+    std::vector<std::vector<std::string>> files;
+    std::vector<FileWatcher::Clock::time_point> firstChanges;
+    std::vector<FileWatcher::Clock::time_point> deliveries;
+
+    FileWatcher::Callback Callback() {
+        return [this](const std::vector<std::string>& names, FileWatcher::Clock::time_point first) {
+            std::lock_guard<std::mutex> lock(mutex);
+            files.push_back(names);
+            firstChanges.push_back(first);
+            deliveries.push_back(FileWatcher::Clock::now());
+            arrived.notify_all();
+        };
+    }
+
+    // Wait until count bursts arrived, or give up after timeout
+    bool WaitFor(size_t count, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return arrived.wait_for(lock, timeout, [&] { return files.size() >= count; });
+    }
+};
+
+} // namespace
+
+TEST(StartFailsForAMissingDirectory) {
+    FileWatcher watcher;
+    Bursts bursts;
+    CHECK(!watcher.Start((fs::temp_directory_path() / "FileWatcherTest.missing").string(),
+                         bursts.Callback()));
+    CHECK(!watcher.IsRunning());
+}
+
+TEST(BurstIsDebouncedIntoOneCallback) {
+    TempDirectory directory;
+    FileWatcher watcher;
+    Bursts bursts;
+    REQUIRE(watcher.Start(directory.path.string(), bursts.Callback()));
+    CHECK(watcher.IsRunning());
+
+    // An editor-style save sequence touching two files several times
+    const FileWatcher::Clock::time_point edit = FileWatcher::Clock::now();
+    WriteText(directory.File("BasicVS.hlsl"), "first");
+    WriteText(directory.File("BasicVS.hlsl"), "second");
+    WriteText(directory.File("BasicPS.hlsl.tmp"), "temporary");
+    fs::rename(directory.File("BasicPS.hlsl.tmp"), directory.File("BasicPS.hlsl"));
+
+    REQUIRE(bursts.WaitFor(1, std::chrono::seconds(5)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(FileWatcher::DebounceMs * 4));
+    watcher.Stop();
+
+    std::lock_guard<std::mutex> lock(bursts.mutex);
+    REQUIRE(bursts.files.size() == 1);
+    std::vector<std::string> names = bursts.files[0];
+    std::sort(names.begin(), names.end());
+    names.erase(std::remove(names.begin(), names.end(), "BasicPS.hlsl.tmp"), names.end());
+    CHECK(names == std::vector<std::string>({"BasicPS.hlsl", "BasicVS.hlsl"}));
+
+    // Delivered only after the directory has been quiet for the debounce interval
+    CHECK(bursts.firstChanges[0] >= edit);
+    CHECK(bursts.deliveries[0] - bursts.firstChanges[0] >=
+          std::chrono::milliseconds(FileWatcher::DebounceMs));
+}
+
+TEST(SeparateEditsGiveSeparateCallbacks) {
+    TempDirectory directory;
+    FileWatcher watcher;
+    Bursts bursts;
+    REQUIRE(watcher.Start(directory.path.string(), bursts.Callback()));
+
+    for (int edit = 0; edit < 3; ++edit) {
+        WriteText(directory.File("SpritePS.hlsl"), "edit");
+        REQUIRE(bursts.WaitFor(edit + 1, std::chrono::seconds(5)));
+    }
+    watcher.Stop();
+
+    std::lock_guard<std::mutex> lock(bursts.mutex);
+    CHECK(bursts.files.size() == 3);
+    for (const std::vector<std::string>& names : bursts.files) {
+        CHECK(names == std::vector<std::string>({"SpritePS.hlsl"}));
+    }
+}
+
+TEST(StopDiscardsPendingChangesAndAllowsRestart) {
+    TempDirectory directory;
+    FileWatcher watcher;
+    Bursts bursts;
+    REQUIRE(watcher.Start(directory.path.string(), bursts.Callback()));
+
+    // Stop right after the edit, well inside the debounce interval
+    WriteText(directory.File("BasicVS.hlsl"), "edit");
+    watcher.Stop();
+    CHECK(!watcher.IsRunning());
+    CHECK(!bursts.WaitFor(1, std::chrono::milliseconds(FileWatcher::DebounceMs * 4)));
+
+    REQUIRE(watcher.Start(directory.path.string(), bursts.Callback()));
+    WriteText(directory.File("BasicPS.hlsl"), "edit");
+    CHECK(bursts.WaitFor(1, std::chrono::seconds(5)));
+    watcher.Stop();
+}
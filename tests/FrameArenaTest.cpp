@@ -0,0 +1,284 @@
+#include "Test.h"
+#include "memory/FrameArena.h"
+#include "memory/ObjectPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory_resource>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+bool Aligned(const void* pointer, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(pointer) % alignment == 0;
+}
+
+// [begin, end) ranges sorted by begin must not overlap
+bool Disjoint(std::vector<std::pair<uintptr_t, uintptr_t>> ranges) {
+    std::sort(ranges.begin(), ranges.end());
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        if (ranges[i].first < ranges[i - 1].second) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Counts live instances, to check the pool constructs and destroys in place
+struct Tracked {
+    static int live;
+    int value;
+
+    explicit Tracked(int value) : value(value) {
+        ++live;
+    }
+    ~Tracked() {
+        --live;
+    }
+};
+int Tracked::live = 0;
+
+struct alignas(64) CacheLine {
+    uint8_t bytes[64];
+};
+
+} // namespace
+
+TEST(LinearArenaAlignsAndNeverOverlaps) {
+    LinearArena arena(1024);
+    std::vector<std::pair<uintptr_t, uintptr_t>> ranges;
+    const size_t alignments[] = {1, 4, 8, 16, 64, 256};
+    for (int i = 0; i < 200; ++i) {
+        const size_t size      = 1 + (i * 37) % 300;
+        const size_t alignment = alignments[i % 6];
+        void* pointer          = arena.Allocate(size, alignment);
+        REQUIRE(pointer != nullptr);
+        CHECK(Aligned(pointer, alignment));
+        std::memset(pointer, i, size);
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(pointer);
+        ranges.emplace_back(begin, begin + size);
+    }
+    CHECK(Disjoint(ranges));
+    CHECK(arena.GetBytesUsed() <= arena.GetBytesReserved());
+}
+
+TEST(LinearArenaSettlesOnOneChunk) {
+    // The first pass spills over several chunks; after Reset the same pass fits in one, and
+    // repeating it never asks the heap for more
+    LinearArena arena(256);
+    auto pass = [&arena] {
+        for (int i = 0; i < 40; ++i) {
+            arena.Allocate(100, 16);
+        }
+    };
+    pass();
+    const size_t reserved = arena.GetBytesReserved();
+    CHECK(reserved >= 40 * 100);
+    CHECK(arena.GetBytesUsed() >= 40 * 100);
+
+    arena.Reset();
+    CHECK(arena.GetBytesUsed() == 0);
+    CHECK(arena.GetBytesReserved() == reserved);
+    for (int frame = 0; frame < 5; ++frame) {
+        pass();
+        arena.Reset();
+        CHECK(arena.GetBytesReserved() == reserved);
+    }
+
+    // A request larger than the chunk size gets a chunk of its own
+    void* large = arena.Allocate(reserved * 2, 64);
+    CHECK(Aligned(large, 64));
+    CHECK(arena.GetBytesReserved() >= reserved * 3);
+
+    arena.Release();
+    CHECK(arena.GetBytesReserved() == 0);
+    CHECK(arena.GetBytesUsed() == 0);
+    CHECK(arena.Allocate(8, 8) != nullptr);
+}
+
+TEST(ObjectPoolReusesTheLastFreedSlot) {
+    ObjectPool<Tracked, 4> pool;
+    Tracked* a = pool.Create(1);
+    Tracked* b = pool.Create(2);
+    CHECK(a->value == 1);
+    CHECK(b->value == 2);
+    CHECK(Tracked::live == 2);
+
+    pool.Destroy(a);
+    CHECK(Tracked::live == 1);
+    Tracked* c = pool.Create(3);
+    CHECK(c == a);
+    CHECK(c->value == 3);
+    pool.Destroy(nullptr);
+
+    // Growing past a block keeps existing objects where they are
+    std::vector<Tracked*> objects;
+    for (int i = 0; i < 10; ++i) {
+        objects.push_back(pool.Create(100 + i));
+    }
+    CHECK(b->value == 2);
+    CHECK(c->value == 3);
+    for (int i = 0; i < 10; ++i) {
+        CHECK(objects[i]->value == 100 + i);
+    }
+
+    ObjectPool<Tracked, 4>::Stats stats = pool.GetStats();
+    CHECK(stats.live == 12);
+    CHECK(stats.highWater == 12);
+    CHECK(stats.capacity == 12);
+
+    for (Tracked* object : objects) {
+        pool.Destroy(object);
+    }
+    pool.Destroy(b);
+    pool.Destroy(c);
+    CHECK(Tracked::live == 0);
+    CHECK(pool.GetStats().live == 0);
+    CHECK(pool.GetStats().highWater == 12);
+}
+
+TEST(ObjectPoolHonoursAlignmentAndReserve) {
+    ObjectPool<CacheLine, 8> pool;
+    pool.Reserve(20);
+    CHECK(pool.GetStats().capacity == 24);
+    for (int i = 0; i < 24; ++i) {
+        CHECK(Aligned(pool.Create(), alignof(CacheLine)));
+    }
+    CHECK(pool.GetStats().capacity == 24);
+}
+
+TEST(FrameArenaKeepsEveryFrameInFlight) {
+    FrameArena arena;
+    uint8_t* frames[FrameArena::FrameCount];
+    for (uint32_t frame = 0; frame < FrameArena::FrameCount; ++frame) {
+        if (frame > 0) {
+            arena.BeginFrame();
+        }
+        frames[frame] = arena.AllocateArray<uint8_t>(1000);
+        std::memset(frames[frame], static_cast<int>(frame + 1), 1000);
+    }
+
+    // Later frames wrote elsewhere, so every frame's data is still intact
+    for (uint32_t frame = 0; frame < FrameArena::FrameCount; ++frame) {
+        CHECK(std::count(frames[frame], frames[frame] + 1000, frame + 1) == 1000);
+    }
+
+    // One more frame reuses the memory of the oldest
+    arena.BeginFrame();
+    CHECK(arena.AllocateArray<uint8_t>(1000) == frames[0]);
+}
+
+TEST(FrameArenaReportsTheFinishedFrame) {
+    FrameArena arena;
+    arena.Allocate(100, 16, MemoryTag::Culling);
+    arena.Allocate(300, 16, MemoryTag::Culling);
+    arena.Allocate(50, 4, MemoryTag::Instances);
+    CHECK(arena.GetStats().allocations == 0); // Nothing until the frame ends
+
+    arena.BeginFrame();
+    FrameArena::Stats stats = arena.GetStats();
+    CHECK(stats.allocations == 3);
+    CHECK(stats.bytesUsed >= 450);
+    CHECK(stats.tagBytes[static_cast<uint32_t>(MemoryTag::Culling)] == 400);
+    CHECK(stats.tagBytes[static_cast<uint32_t>(MemoryTag::Instances)] == 50);
+    CHECK(stats.tagBytes[static_cast<uint32_t>(MemoryTag::General)] == 0);
+    CHECK(stats.highWater == stats.bytesUsed);
+    CHECK(stats.bytesReserved >= stats.bytesUsed);
+
+    // A lighter frame lowers the totals but not the high-water marks
+    const uint64_t peak = stats.highWater;
+    arena.Allocate(10, 4, MemoryTag::Culling);
+    arena.BeginFrame();
+    stats = arena.GetStats();
+    CHECK(stats.allocations == 1);
+    CHECK(stats.tagBytes[static_cast<uint32_t>(MemoryTag::Culling)] == 10);
+    CHECK(stats.tagHighWater[static_cast<uint32_t>(MemoryTag::Culling)] == 400);
+    CHECK(stats.highWater == peak);
+
+    arena.Release();
+    CHECK(arena.GetStats().bytesReserved == 0);
+    CHECK(std::strcmp(MemoryTagName(MemoryTag::RenderQueue), "RenderQueue") == 0);
+}
+
+TEST(FrameArenaThreadsAllocateWithoutOverlap) {
+    // Two rounds of more threads than MaxThreads alive at once, within one frame: the first
+    // overflows into the shared arena, the second reuses the slots the first released
+    FrameArena arena;
+    const int threadCount = static_cast<int>(FrameArena::MaxThreads) + 8;
+    const int perThread   = 500;
+    std::vector<std::vector<std::pair<uintptr_t, uintptr_t>>> ranges(threadCount * 2);
+    for (int round = 0; round < 2; ++round) {
+        std::atomic<int> started{0};
+        std::vector<std::thread> threads;
+        for (int t = round * threadCount; t < (round + 1) * threadCount; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < perThread; ++i) {
+                    const size_t size = 8 + (i * 13 + t) % 120;
+                    auto* bytes       = static_cast<uint8_t*>(arena.Allocate(size, 8));
+                    std::memset(bytes, t, size);
+                    const uintptr_t begin = reinterpret_cast<uintptr_t>(bytes);
+                    ranges[t].emplace_back(begin, begin + size);
+
+                    // Hold the slot until every thread of the round has one
+                    if (i == 0) {
+                        started.fetch_add(1);
+                        while (started.load() < threadCount) {
+                            std::this_thread::yield();
+                        }
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    std::vector<std::pair<uintptr_t, uintptr_t>> all;
+    for (const auto& thread : ranges) {
+        all.insert(all.end(), thread.begin(), thread.end());
+    }
+    CHECK(Disjoint(all));
+    arena.BeginFrame();
+    CHECK(arena.GetStats().allocations == static_cast<uint64_t>(threadCount) * perThread * 2);
+    CHECK(arena.GetStats().sharedAllocations > 0);
+}
+
+TEST(FrameArenaReusesTheSlotsOfExitedThreads) {
+    // Far more threads than MaxThreads over the arena's life, but one at a time: each takes
+    // the slot the previous one released, so none falls back to the locked arena
+    FrameArena arena;
+    const uint32_t threadCount = FrameArena::MaxThreads * 3;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        std::thread thread([&arena] {
+            for (int i = 0; i < 10; ++i) {
+                arena.Allocate(64, 16);
+            }
+        });
+        thread.join();
+    }
+    arena.BeginFrame();
+    CHECK(arena.GetStats().allocations == threadCount * 10);
+    CHECK(arena.GetStats().sharedAllocations == 0);
+}
+
+TEST(PmrContainersAllocateFromTheFrame) {
+    FrameArena arena;
+    {
+        std::pmr::vector<int> values(arena.GetResource(MemoryTag::RenderQueue));
+        for (int i = 0; i < 1000; ++i) {
+            values.push_back(i);
+        }
+        CHECK(values[999] == 999);
+        CHECK(arena.GetResource(MemoryTag::RenderQueue) !=
+              arena.GetResource(MemoryTag::General));
+        CHECK(arena.GetResource(MemoryTag::RenderQueue)
+                  ->is_equal(*arena.GetResource(MemoryTag::RenderQueue)));
+    }
+    arena.BeginFrame();
+    const uint64_t bytes =
+        arena.GetStats().tagBytes[static_cast<uint32_t>(MemoryTag::RenderQueue)];
+    CHECK(bytes >= 1000 * sizeof(int));
+}
@@ -0,0 +1,348 @@
+#include "Test.h"
+#include "render/FrameCapture.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+/*
+Logs every call as text. Objects are renumbered in order of first appearance (nullptr is 0),
+so a frame issued with real pointers and its replay with capture ids log the same, and
+floats are logged by bit pattern
+*/
+class LoggingSink : public ContextSink {
+  public:
+    std::vector<std::string> calls;
+
+    // Buffer contents, logged into the same stream as the calls
+    void BufferData(void* buffer, uint32_t offset, const void* data, uint64_t size) {
+        std::string line = "BufferData " + Id(buffer) + " " + std::to_string(offset) + " ";
+        line.append(static_cast<const char*>(data), static_cast<size_t>(size));
+        calls.push_back(line);
+    }
+
+    void SetInputLayout(void* layout) override {
+        Log("InputLayout", {Id(layout)});
+    }
+    void SetPrimitiveTopology(uint32_t topology) override {
+        Log("Topology", {Num(topology)});
+    }
+    void SetIndexBuffer(void* buffer, uint32_t format, uint32_t offset) override {
+        Log("IndexBuffer", {Id(buffer), Num(format), Num(offset)});
+    }
+    void SetVertexBuffer(uint32_t slot, void* buffer, uint32_t stride, uint32_t offset) override {
+        Log("VertexBuffer", {Num(slot), Id(buffer), Num(stride), Num(offset)});
+    }
+    void SetVertexShader(void* shader) override {
+        Log("VertexShader", {Id(shader)});
+    }
+    void SetPixelShader(void* shader) override {
+        Log("PixelShader", {Id(shader)});
+    }
+    void SetPixelShaderResource(uint32_t slot, void* resource) override {
+        Log("PixelResource", {Num(slot), Id(resource)});
+    }
+    void SetPixelSampler(uint32_t slot, void* sampler) override {
+        Log("PixelSampler", {Num(slot), Id(sampler)});
+    }
+    void SetVertexConstantBuffer(uint32_t slot,
+                                 void* buffer,
+                                 uint32_t firstConstant,
+                                 uint32_t constantCount) override {
+        Log("VertexConstants", {Num(slot), Id(buffer), Num(firstConstant), Num(constantCount)});
+    }
+    void SetRasterizerState(void* state) override {
+        Log("Rasterizer", {Id(state)});
+    }
+    void SetViewport(float x, float y, float width, float height) override {
+        Log("Viewport", {Bits(x), Bits(y), Bits(width), Bits(height)});
+    }
+    void SetDepthStencilState(void* state, uint32_t stencilRef) override {
+        Log("DepthStencil", {Id(state), Num(stencilRef)});
+    }
+    void SetBlendState(void* state, const float blendFactor[4], uint32_t mask) override {
+        if (!blendFactor) {
+            Log("Blend", {Id(state), "default", Num(mask)});
+            return;
+        }
+        Log("Blend",
+            {Id(state),
+             Bits(blendFactor[0]),
+             Bits(blendFactor[1]),
+             Bits(blendFactor[2]),
+             Bits(blendFactor[3]),
+             Num(mask)});
+    }
+    void SetRenderTarget(void* renderTarget, void* depthStencil) override {
+        Log("RenderTarget", {Id(renderTarget), Id(depthStencil)});
+    }
+    void Draw(uint32_t vertexCount, uint32_t startVertex) override {
+        Log("Draw", {Num(vertexCount), Num(startVertex)});
+    }
+    void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override {
+        Log("DrawIndexed", {Num(indexCount), Num(startIndex), std::to_string(baseVertex)});
+    }
+    void DrawInstanced(uint32_t vertexCount,
+                       uint32_t instanceCount,
+                       uint32_t startVertex,
+                       uint32_t startInstance) override {
+        Log("DrawInstanced",
+            {Num(vertexCount), Num(instanceCount), Num(startVertex), Num(startInstance)});
+    }
+    void DrawIndexedInstanced(uint32_t indexCount,
+                              uint32_t instanceCount,
+                              uint32_t startIndex,
+                              int32_t baseVertex,
+                              uint32_t startInstance) override {
+        Log("DrawIndexedInstanced",
+            {Num(indexCount),
+             Num(instanceCount),
+             Num(startIndex),
+             std::to_string(baseVertex),
+             Num(startInstance)});
+    }
+
+  private:
+    std::unordered_map<const void*, uint32_t> ids;
+
+    std::string Id(const void* object) {
+        if (!object) {
+            return "#0";
+        }
+        auto inserted = ids.emplace(object, static_cast<uint32_t>(ids.size() + 1));
+        return "#" + std::to_string(inserted.first->second);
+    }
+    static std::string Num(uint32_t value) {
+        return std::to_string(value);
+    }
+    static std::string Bits(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return "f" + std::to_string(bits);
+    }
+    void Log(const char* name, std::initializer_list<std::string> args) {
+        std::string line = name;
+        for (const std::string& arg : args) {
+            line += " " + arg;
+        }
+        calls.push_back(line);
+    }
+};
+
+// Distinct fake object pointers; only their identity matters
+void* Object(uintptr_t id) {
+    return reinterpret_cast<void*>(id * 16);
+}
+
+/*
+A frame using every call, the special float values and negative base vertices, with buffer
+contents recorded through capture and logged into log (5 uploads, 4 distinct)
+*/
+void IssueFrame(FrameCapture& capture, LoggingSink& log) {
+    auto upload = [&](void* buffer, uint32_t offset, const std::string& bytes) {
+        capture.RecordBufferData(buffer, offset, bytes.data(), bytes.size());
+        log.BufferData(buffer, offset, bytes.data(), bytes.size());
+    };
+
+    const float blendFactor[4] = {0.25f, -0.0f, 1e-40f, 1.0f};
+    capture.SetRenderTarget(Object(1), Object(2));
+    capture.SetViewport(0.0f, 0.0f, 1920.0f, 1080.0f);
+    capture.SetRasterizerState(nullptr);
+    capture.SetDepthStencilState(Object(3), 7);
+    capture.SetBlendState(nullptr, nullptr, 0xFFFFFFFFu);
+    capture.SetInputLayout(Object(4));
+    capture.SetPrimitiveTopology(4);
+    capture.SetVertexShader(Object(5));
+    capture.SetPixelShader(Object(6));
+    capture.SetPixelSampler(0, Object(7));
+    upload(Object(8), 0, "vertices of the first mesh");
+    upload(Object(9), 0, std::string("indices\0with\0zeros", 18));
+    capture.SetVertexBuffer(0, Object(8), 28, 0);
+    capture.SetIndexBuffer(Object(9), 42, 0);
+    for (uint32_t object = 0; object < 3; ++object) {
+        upload(Object(10), object * 256, object == 2 ? "other constants" : "same constants");
+        capture.SetVertexConstantBuffer(0, Object(10), object * 16, 16);
+        capture.SetPixelShaderResource(0, Object(11 + object));
+        capture.DrawIndexed(36, 0, -static_cast<int32_t>(object));
+    }
+    capture.SetBlendState(Object(14), blendFactor, 0x0Fu);
+    capture.DrawInstanced(6, 100, 0, 0);
+    capture.DrawIndexedInstanced(36, 10, 0, -5, 2);
+    capture.SetPixelShaderResource(0, nullptr);
+    capture.Draw(3, 0);
+}
+
+// Capture IssueFrame; sink sees the forwarded calls and the uploads, in issue order
+std::vector<uint8_t> CaptureFrame(LoggingSink& sink) {
+    FrameCapture capture(sink);
+    capture.Begin(42);
+    IssueFrame(capture, sink);
+    return capture.End();
+}
+
+} // namespace
+
+TEST(FrameCaptureForwardsEveryCall) {
+    // Outside a capture, calls pass through and nothing is recorded
+    LoggingSink target;
+    FrameCapture capture(target);
+    IssueFrame(capture, target);
+    CHECK(!capture.IsCapturing());
+    CHECK(target.calls.size() == 26 + 5);
+    CHECK(capture.End().empty());
+    CHECK(capture.GetStats().commands == 0);
+
+    // During one they still pass through, unchanged
+    LoggingSink captured;
+    const std::vector<uint8_t> file = CaptureFrame(captured);
+    CHECK(!file.empty());
+    CHECK(captured.calls == target.calls);
+}
+
+TEST(FrameCaptureRoundTripsThroughReplay) {
+    LoggingSink original;
+    const std::vector<uint8_t> file = CaptureFrame(original);
+
+    CaptureFile capture;
+    REQUIRE(capture.Load(file.data(), file.size()));
+    const CaptureFile::Header& header = capture.GetHeader();
+    CHECK(header.frame == 42);
+    CHECK(header.commandCount == 31); // 26 calls + 5 uploads
+    CHECK(header.drawCount == 6);
+    CHECK(header.objectCount == 14);
+    CHECK(header.blobCount == 4); // The repeated constants are stored once
+    CHECK(capture.GetOpCounts()[CaptureFile::DrawIndexed] == 3);
+    CHECK(capture.GetOpCounts()[CaptureFile::BufferData] == 5);
+    CHECK(capture.GetObjectKind(1) == CaptureFile::RenderTarget);
+    CHECK(capture.GetObjectKind(2) == CaptureFile::DepthStencil);
+    CHECK(std::string(CaptureFile::GetOpInfo(CaptureFile::Draw).name) == "Draw");
+
+    // Every call and upload comes back in issue order with the same arguments
+    LoggingSink replayed;
+    capture.Replay(replayed, nullptr, [&replayed](void* buffer,
+                                                  uint32_t offset,
+                                                  const void* data,
+                                                  uint64_t size) {
+        replayed.BufferData(buffer, offset, data, size);
+    });
+    CHECK(replayed.calls == original.calls);
+
+    // With an object table, its pointers stand in for the ids
+    std::vector<void*> objects(header.objectCount + 1, nullptr);
+    for (uint32_t id = 1; id <= header.objectCount; ++id) {
+        objects[id] = Object(100 + id);
+    }
+    LoggingSink ids;
+    LoggingSink remapped;
+    capture.Replay(ids);
+    capture.Replay(remapped, objects.data());
+    CHECK(remapped.calls == ids.calls);
+    CHECK(remapped.calls.size() == 26);
+
+    // Capturing the replay gives the same file, byte for byte
+    LoggingSink sink;
+    FrameCapture recapture(sink);
+    recapture.Begin(42);
+    capture.Replay(recapture, nullptr, [&recapture](void* buffer,
+                                                    uint32_t offset,
+                                                    const void* data,
+                                                    uint64_t size) {
+        recapture.RecordBufferData(buffer, offset, data, size);
+    });
+    CHECK(recapture.End() == file);
+
+    const FrameCapture::Stats stats = recapture.GetStats();
+    CHECK(stats.commands == 31);
+    CHECK(stats.draws == 6);
+    CHECK(stats.blobs == 4);
+    CHECK(stats.blobsReused == 1);
+    CHECK(stats.blobBytesReused == std::strlen("same constants"));
+    CHECK(stats.fileBytes == file.size());
+}
+
+TEST(FrameCaptureWritesAndOpensFiles) {
+    const char* path = "FrameCaptureTest.fcap";
+    LoggingSink sink;
+    FrameCapture capture(sink);
+    CHECK(!capture.End(path)); // Nothing to write
+    capture.Begin(7);
+    LoggingSink log;
+    IssueFrame(capture, log);
+    REQUIRE(capture.End(path));
+
+    CaptureFile file;
+    REQUIRE(file.Open(path));
+    CHECK(file.GetHeader().frame == 7);
+    CHECK(file.GetHeader().commandCount == 31);
+    const CaptureFile::Blob& blob = file.GetBlob(0);
+    CHECK(std::string(reinterpret_cast<const char*>(file.GetBlobData(0)),
+                      static_cast<size_t>(blob.size)) == "vertices of the first mesh");
+    file.Close();
+    std::remove(path);
+
+    CHECK(!file.Open("FrameCaptureTest.missing"));
+}
+
+TEST(CaptureFileRejectsDamagedFiles) {
+    LoggingSink original;
+    const std::vector<uint8_t> file = CaptureFrame(original);
+    CaptureFile capture;
+
+    // Every truncation that cuts into a section (the file may end in alignment padding)
+    CaptureFile::Header header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    uint64_t end = sizeof(header);
+    for (const CaptureFile::Section& section : header.sections) {
+        end = std::max(end, section.offset + section.size);
+    }
+    for (size_t size = 0; size < end; ++size) {
+        std::vector<uint8_t> truncated(file.begin(), file.begin() + size);
+        CHECK(!capture.Load(truncated.data(), truncated.size()));
+    }
+
+    std::vector<uint8_t> damaged = file;
+    damaged[0] ^= 1; // Magic
+    CHECK(!capture.Load(damaged.data(), damaged.size()));
+    damaged = file;
+    ++damaged[4]; // Version
+    CHECK(!capture.Load(damaged.data(), damaged.size()));
+    damaged = file;
+    damaged[header.sections[CaptureFile::Commands].offset] = CaptureFile::OpCount; // Opcode
+    CHECK(!capture.Load(damaged.data(), damaged.size()));
+
+    // Random corruption: either rejected, or safe to replay (checked by the sanitizers)
+    std::mt19937 rng(25);
+    LoggingSink sink;
+    uint32_t accepted = 0;
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+        damaged               = file;
+        const uint32_t errors = 1 + rng() % 4;
+        for (uint32_t e = 0; e < errors; ++e) {
+            damaged[rng() % damaged.size()] ^= static_cast<uint8_t>(1 + rng() % 255);
+        }
+        if (!capture.Load(damaged.data(), damaged.size())) {
+            continue;
+        }
+        ++accepted;
+        uint64_t bytes = 0;
+        sink.calls.clear();
+        capture.Replay(sink, nullptr, [&bytes](void*, uint32_t, const void* data, uint64_t size) {
+            const uint8_t* first = static_cast<const uint8_t*>(data);
+            for (uint64_t i = 0; i < size; ++i) {
+                bytes += first[i];
+            }
+        });
+        CHECK(sink.calls.size() + capture.GetOpCounts()[CaptureFile::BufferData] ==
+              capture.GetHeader().commandCount);
+    }
+    // Flips in arguments and blob data leave valid files
+    CHECK(accepted > 0);
+
+    // The original still loads after all that
+    CHECK(capture.Load(file.data(), file.size()));
+}
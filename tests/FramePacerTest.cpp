@@ -0,0 +1,225 @@
+#include "Test.h"
+#include "render/FramePacer.h"
+#include <cstdint>
+
+namespace {
+
+const int64_t Ms = 1000000;
+
+// Simulated time: sleeps overshoot by a set amount, a spin step costs 200 ns
+class SimulatedClock : public PacingClock {
+  public:
+    int64_t time      = 1000 * Ms;
+    int64_t oversleep = 0;
+    int sleeps        = 0;
+
+    int64_t Now() override {
+        return time;
+    }
+    void Sleep(int64_t ns) override {
+        time += ns + oversleep;
+        ++sleeps;
+    }
+    void Spin() override {
+        time += 200;
+    }
+
+    void Advance(int64_t ns) {
+        time += ns;
+    }
+
+    // First vertical blank after now, on a display refreshing every refresh nanoseconds
+    int64_t NextVblank(int64_t refresh) const {
+        return (time / refresh + 1) * refresh;
+    }
+};
+
+// frames frames of work ns each, presenting immediately
+void RunFrames(FramePacer& pacer, SimulatedClock& clock, int frames, int64_t work) {
+    for (int i = 0; i < frames; ++i) {
+        pacer.WaitForFrameStart();
+        clock.Advance(work);
+        pacer.OnPresent();
+    }
+}
+
+} // namespace
+
+TEST(UncappedNeverWaits) {
+    SimulatedClock clock;
+    FramePacer pacer(&clock);
+    for (int i = 0; i < 100; ++i) {
+        pacer.WaitForFrameStart();
+        clock.Advance(i % 2 ? 20 * Ms : 10 * Ms);
+        pacer.OnPresent();
+    }
+    CHECK(clock.sleeps == 0);
+
+    const FramePacer::Stats stats = pacer.GetStats();
+    CHECK(stats.frames == 100);
+    CHECK_NEAR(stats.frameMs, 15.0, 0.1);
+    CHECK_NEAR(stats.frameDevMs, 5.0, 0.1);
+    CHECK_NEAR(stats.maxFrameMs, 20.0, 1e-9);
+    CHECK_NEAR(stats.latencyMs, 15.0, 1e-9);
+    CHECK_NEAR(stats.maxLatencyMs, 20.0, 1e-9);
+    CHECK(stats.sleepMs == 0.0);
+    CHECK(stats.missed == 0);
+}
+
+TEST(TargetRateHoldsASteadyInterval) {
+    SimulatedClock clock;
+    FramePacer pacer(&clock);
+    FramePacer::Settings settings;
+    settings.targetFps = 60.0;
+    pacer.SetSettings(settings);
+
+    RunFrames(pacer, clock, 300, 5 * Ms);
+    const FramePacer::Stats stats = pacer.GetStats();
+    CHECK_NEAR(stats.frameMs, 1000.0 / 60.0, 0.001);
+    CHECK(stats.frameDevMs < 0.001);
+    CHECK(stats.missed == 0);
+
+    // Most of the idle time is slept, only the margin is spun
+    CHECK(stats.sleepMs > 11.0);
+    CHECK(stats.spinMs < 0.2);
+}
+
+TEST(SpinMarginAdaptsToOversleep) {
+    SimulatedClock clock;
+    clock.oversleep = 1 * Ms;
+    FramePacer pacer(&clock);
+    FramePacer::Settings settings;
+    settings.targetFps = 100.0;
+    pacer.SetSettings(settings);
+
+    // After the first late wakeup the margin covers the overshoot and frames stay on time
+    RunFrames(pacer, clock, 10, 2 * Ms);
+    pacer.ResetStats();
+    RunFrames(pacer, clock, 200, 2 * Ms);
+    FramePacer::Stats stats = pacer.GetStats();
+    CHECK(stats.spinMarginMs >= 1.0);
+    CHECK(stats.spinMarginMs <= 2.0);
+    CHECK_NEAR(stats.frameMs, 10.0, 0.001);
+    CHECK(stats.maxFrameMs < 10.01);
+    CHECK(stats.missed == 0);
+
+    // Accurate sleeps let it decay back towards the minimum
+    clock.oversleep = 0;
+    RunFrames(pacer, clock, 300, 2 * Ms);
+    stats = pacer.GetStats();
+    CHECK(stats.spinMarginMs < 0.1);
+}
+
+TEST(SpinMarginIsCapped) {
+    SimulatedClock clock;
+    clock.oversleep = 5 * Ms;
+    FramePacer pacer(&clock);
+    FramePacer::Settings settings;
+    settings.targetFps = 60.0;
+    settings.maxSpinNs = 2 * Ms;
+    pacer.SetSettings(settings);
+
+    RunFrames(pacer, clock, 50, 1 * Ms);
+    CHECK_NEAR(pacer.GetStats().spinMarginMs, 2.0, 1e-9);
+}
+
+TEST(HitchRestartsTheSchedule) {
+    SimulatedClock clock;
+    FramePacer pacer(&clock);
+    FramePacer::Settings settings;
+    settings.targetFps = 50.0;
+    pacer.SetSettings(settings);
+    RunFrames(pacer, clock, 10, 5 * Ms);
+
+    // One 70 ms frame: the next starts at once, later ones are back on a 20 ms grid rather
+    // than crowding in to catch up
+    pacer.WaitForFrameStart();
+    clock.Advance(70 * Ms);
+    pacer.OnPresent();
+    const int64_t restart = clock.Now();
+    RunFrames(pacer, clock, 1, 5 * Ms);
+    CHECK(clock.Now() == restart + 5 * Ms);
+    pacer.ResetStats();
+    RunFrames(pacer, clock, 20, 5 * Ms);
+    const FramePacer::Stats stats = pacer.GetStats();
+    CHECK(stats.frameDevMs < 0.001);
+    CHECK_NEAR(stats.frameMs, 20.0, 0.001);
+}
+
+TEST(SlowFramesAreCountedAsMissed) {
+    SimulatedClock clock;
+    FramePacer pacer(&clock);
+    FramePacer::Settings settings;
+    settings.targetFps = 100.0;
+    pacer.SetSettings(settings);
+
+    // 15 ms of work at 100 Hz: starts fall behind the grid until a whole period late, when
+    // it restarts; the late ones count as missed and none of them wait
+    RunFrames(pacer, clock, 2, 5 * Ms);
+    RunFrames(pacer, clock, 1, 15 * Ms);
+    pacer.ResetStats();
+    RunFrames(pacer, clock, 30, 15 * Ms);
+    CHECK(pacer.GetStats().missed >= 10);
+    CHECK(pacer.GetStats().missed < 30);
+    CHECK(pacer.GetStats().sleepMs == 0.0);
+    CHECK_NEAR(pacer.GetStats().frameMs, 15.0, 0.01);
+}
+
+TEST(LowLatencyStartsJustInTimeForVblank) {
+    // A 60 Hz vsynced flip-model swap chain with a frame latency of one: Present queues the
+    // frame for the next vertical blank, and the frame-latency wait before the next frame
+    // blocks until it is on screen. A fixed schedule starts work at that blank, a refresh
+    // before its own; low-latency mode starts the 4 ms of work just before it
+    const int64_t refresh = 16666667;
+    double displayMs[2]   = {};
+    double frameMs[2]     = {};
+    uint32_t missed[2]    = {};
+    for (int lowLatency = 0; lowLatency < 2; ++lowLatency) {
+        SimulatedClock clock;
+        clock.time = 0;
+        FramePacer pacer(&clock);
+        FramePacer::Settings settings;
+        settings.targetFps  = 60.0;
+        settings.lowLatency = lowLatency == 1;
+        pacer.SetSettings(settings);
+
+        int64_t onScreen     = 0;
+        int64_t displaySum   = 0;
+        const int frameCount = 120;
+        for (int frame = 0; frame < frameCount; ++frame) {
+            if (frame == 20) {
+                pacer.ResetStats();
+                displaySum = 0;
+            }
+            if (onScreen > clock.time) {
+                clock.time = onScreen;
+                pacer.SyncToDisplay(onScreen);
+            }
+            pacer.WaitForFrameStart();
+            const int64_t start = clock.Now();
+            clock.Advance(4 * Ms);
+            pacer.OnPresent();
+            onScreen = clock.NextVblank(refresh);
+            displaySum += onScreen - start;
+        }
+        const FramePacer::Stats stats = pacer.GetStats();
+        displayMs[lowLatency]         = static_cast<double>(displaySum) / (frameCount - 20) / Ms;
+        frameMs[lowLatency]           = stats.frameMs;
+        missed[lowLatency]            = stats.missed;
+        CHECK_NEAR(stats.latencyMs, 4.0, 0.01); // Start to Present is the work either way
+    }
+    CHECK(displayMs[0] > 15.0);
+    CHECK(displayMs[1] < 6.0);
+    CHECK_NEAR(frameMs[0], 1000.0 / 60.0, 0.01);
+    CHECK_NEAR(frameMs[1], 1000.0 / 60.0, 0.01);
+    CHECK(missed[1] == 0);
+}
+
+TEST(SystemClockIsMonotonicAndSleeps) {
+    std::unique_ptr<PacingClock> clock = PacingClock::CreateSystemClock();
+    const int64_t start                = clock->Now();
+    clock->Sleep(2 * Ms);
+    clock->Spin();
+    const int64_t end = clock->Now();
+    CHECK(end - start >= 2 * Ms);
+}
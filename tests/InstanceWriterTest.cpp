@@ -0,0 +1,165 @@
+#include "Test.h"
+#include "render/InstanceWriter.h"
+#include "threading/JobSystem.h"
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Owns the arrays an InstanceSource points into: random positions, unit quaternions,
+// scales and colors
+struct Scene {
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+    std::vector<float> scale;
+    std::vector<uint32_t> color;
+
+    explicit Scene(uint32_t count, uint32_t seed = 1) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        for (uint32_t i = 0; i < count; ++i) {
+            positionX.push_back(unit(rng) * 10.0f);
+            positionY.push_back(unit(rng) * 10.0f);
+            positionZ.push_back(unit(rng) * 10.0f);
+
+            float q[4]   = {unit(rng), unit(rng), unit(rng), unit(rng)};
+            float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+            rotationX.push_back(q[0] / length);
+            rotationY.push_back(q[1] / length);
+            rotationZ.push_back(q[2] / length);
+            rotationW.push_back(q[3] / length);
+
+            scale.push_back(0.5f + unit(rng) * 0.25f);
+            color.push_back(static_cast<uint32_t>(rng()));
+        }
+    }
+
+    InstanceSource Source() const {
+        InstanceSource source;
+        source.positionX = positionX.data();
+        source.positionY = positionY.data();
+        source.positionZ = positionZ.data();
+        source.rotationX = rotationX.data();
+        source.rotationY = rotationY.data();
+        source.rotationZ = rotationZ.data();
+        source.rotationW = rotationW.data();
+        source.scale     = scale.data();
+        source.color     = color.data();
+        return source;
+    }
+};
+
+// The SIMD path computes the same products in the same order as the scalar one; the
+// tolerance only allows for a compiler contracting them into fused multiply-adds
+bool Matches(const InstanceData* actual, const InstanceData* expected, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        for (int row = 0; row < 3; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                if (!Test::Near(actual[i].transform[row][column],
+                                expected[i].transform[row][column],
+                                1e-5)) {
+                    return false;
+                }
+            }
+        }
+        if (std::memcmp(actual[i].color, expected[i].color, sizeof(actual[i].color)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<InstanceData> Reference(const Scene& scene, uint32_t count) {
+    std::vector<InstanceData> expected(count);
+    InstanceWriter::WriteRangeScalar(scene.Source(), 0, count, expected.data());
+    return expected;
+}
+
+} // namespace
+
+TEST(ScalarWriterBuildsTheAffineTransform) {
+    // A quarter turn about z: x maps to y, y to -x
+    const float half         = std::sqrt(0.5f);
+    const float positionX[]  = {1.0f};
+    const float positionY[]  = {2.0f};
+    const float positionZ[]  = {3.0f};
+    const float rotationXY[] = {0.0f};
+    const float rotationZ[]  = {half};
+    const float rotationW[]  = {half};
+    const float scale[]      = {2.0f};
+    const uint32_t color[]   = {0x80FF3300u};
+    InstanceSource source;
+    source.positionX = positionX;
+    source.positionY = positionY;
+    source.positionZ = positionZ;
+    source.rotationX = rotationXY;
+    source.rotationY = rotationXY;
+    source.rotationZ = rotationZ;
+    source.rotationW = rotationW;
+    source.scale     = scale;
+    source.color     = color;
+
+    InstanceData instance;
+    InstanceWriter::WriteRangeScalar(source, 0, 1, &instance);
+    const float expected[3][4] = {{0.0f, -2.0f, 0.0f, 1.0f},
+                                  {2.0f, 0.0f, 0.0f, 2.0f},
+                                  {0.0f, 0.0f, 2.0f, 3.0f}};
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            CHECK_NEAR(instance.transform[row][column], expected[row][column], 1e-6);
+        }
+    }
+    // Red in the low byte
+    CHECK_NEAR(instance.color[0], 0.0f, 1e-6);
+    CHECK_NEAR(instance.color[1], 0x33 / 255.0f, 1e-6);
+    CHECK_NEAR(instance.color[2], 1.0f, 1e-6);
+    CHECK_NEAR(instance.color[3], 0x80 / 255.0f, 1e-6);
+}
+
+TEST(SimdWriterMatchesScalar) {
+    // Counts around the four-wide loop, so the scalar tail is covered too
+    for (uint32_t count : {0u, 1u, 3u, 4u, 5u, 8u, 17u, 1000u}) {
+        Scene scene(count, count + 1);
+        std::vector<InstanceData> expected = Reference(scene, count);
+        std::vector<InstanceData> actual(count);
+        InstanceWriter::WriteRange(scene.Source(), 0, count, actual.data());
+        CHECK(Matches(actual.data(), expected.data(), count));
+    }
+}
+
+TEST(PartialRangesLeaveTheRestUntouched) {
+    const uint32_t count = 64;
+    Scene scene(count);
+    std::vector<InstanceData> expected = Reference(scene, count);
+
+    InstanceData blank;
+    std::memset(&blank, 0xCD, sizeof(blank));
+    std::vector<InstanceData> actual(count, blank);
+    InstanceWriter::WriteRange(scene.Source(), 10, 23, actual.data());
+    CHECK(Matches(actual.data() + 10, expected.data() + 10, 13));
+    CHECK(std::memcmp(&actual[9], &blank, sizeof(blank)) == 0);
+    CHECK(std::memcmp(&actual[23], &blank, sizeof(blank)) == 0);
+}
+
+TEST(ParallelWriteMatchesSerial) {
+    // Several chunks plus a partial one, so every task boundary is exercised
+    const uint32_t count = InstanceWriter::ChunkSize * 3 + 123;
+    Scene scene(count);
+    std::vector<InstanceData> expected = Reference(scene, count);
+
+    InstanceWriter serial;
+    std::vector<InstanceData> actual(count);
+    serial.Write(scene.Source(), count, actual.data());
+    CHECK(Matches(actual.data(), expected.data(), count));
+
+    JobSystem jobSystem;
+    REQUIRE(jobSystem.Initialize(4));
+    InstanceWriter parallel;
+    parallel.SetParallelFor(jobSystem.GetTaskExecutor());
+    std::vector<InstanceData> fromJobs(count);
+    parallel.Write(scene.Source(), count, fromJobs.data());
+    jobSystem.Shutdown();
+    CHECK(Matches(fromJobs.data(), expected.data(), count));
+}
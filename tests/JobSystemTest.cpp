@@ -0,0 +1,281 @@
+#include "Test.h"
+#include "threading/JobSystem.h"
+#include "threading/WorkStealingQueue.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// The deque and scheduler stress tests are meant to be run under ThreadSanitizer as well
+// (cmake -DSANITIZE=thread); they check that every item is claimed once either way
+
+namespace {
+
+// Thread counts every test runs with: no helpers, a few, and more threads than cores
+const uint32_t ThreadCounts[] = {1, 2, 4, 8};
+
+struct Hits {
+    std::vector<std::atomic<uint32_t>> counts;
+    explicit Hits(uint32_t size) : counts(size) {}
+
+    bool AllExactlyOnce() const {
+        for (const std::atomic<uint32_t>& count : counts) {
+            if (count.load() != 1) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+void MarkRange(const Job& job) {
+    Hits& hits = *static_cast<Hits*>(job.data);
+    for (uint32_t i = job.begin; i < job.end; ++i) {
+        hits.counts[i].fetch_add(1);
+    }
+}
+
+// Two-stage chain: the second stage must observe every write of the first
+struct Pipeline {
+    std::vector<uint32_t> values;
+    std::atomic<uint32_t> misordered{0};
+};
+
+void ProduceRange(const Job& job) {
+    Pipeline& pipeline = *static_cast<Pipeline*>(job.data);
+    for (uint32_t i = job.begin; i < job.end; ++i) {
+        pipeline.values[i] = i + 1;
+    }
+}
+
+void ConsumeRange(const Job& job) {
+    Pipeline& pipeline = *static_cast<Pipeline*>(job.data);
+    for (uint32_t i = job.begin; i < job.end; ++i) {
+        if (pipeline.values[i] != i + 1) {
+            pipeline.misordered.fetch_add(1);
+        }
+    }
+}
+
+// Each job fans out again through ParallelFor from whichever worker runs it
+struct Nested {
+    JobSystem* jobSystem;
+    Hits* hits;
+    uint32_t inner;
+};
+
+void NestedRange(const Job& job) {
+    const Nested& nested = *static_cast<const Nested*>(job.data);
+    for (uint32_t outer = job.begin; outer < job.end; ++outer) {
+        nested.jobSystem->ParallelFor(nested.inner, 16, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                nested.hits->counts[outer * nested.inner + i].fetch_add(1);
+            }
+        });
+    }
+}
+
+} // namespace
+
+// Spans several words, so a torn slot copy shows up as mismatched words
+struct Token {
+    uint64_t words[4] = {};
+};
+
+TEST(DequeThievesClaimEveryItemOnceUntorn) {
+    // A small deque wraps constantly, so thieves keep reading slots the owner is rewriting
+    WorkStealingQueue<Token, 64> queue;
+    const uint32_t count = 200000;
+    Hits hits(count);
+    std::atomic<bool> torn(false);
+    std::atomic<bool> done(false);
+
+    auto claim = [&](const Token& token) {
+        for (uint64_t word : token.words) {
+            if (word != token.words[0]) {
+                torn.store(true);
+            }
+        }
+        if (token.words[0] < count) {
+            hits.counts[token.words[0]].fetch_add(1);
+        } else {
+            torn.store(true);
+        }
+    };
+
+    std::vector<std::thread> thieves;
+    for (uint32_t t = 0; t < 3; ++t) {
+        thieves.emplace_back([&] {
+            Token token;
+            while (!done.load()) {
+                if (queue.Steal(token)) {
+                    claim(token);
+                }
+            }
+            while (queue.Steal(token)) {
+                claim(token);
+            }
+        });
+    }
+
+    Token token;
+    for (uint32_t i = 0; i < count; ++i) {
+        Token item;
+        for (uint64_t& word : item.words) {
+            word = i;
+        }
+        while (!queue.Push(item)) {
+            if (queue.Take(token)) {
+                claim(token);
+            }
+        }
+        if (i % 3 == 0 && queue.Take(token)) {
+            claim(token);
+        }
+    }
+    while (queue.Take(token)) {
+        claim(token);
+    }
+    done.store(true);
+    for (std::thread& thief : thieves) {
+        thief.join();
+    }
+    CHECK(!torn.load());
+    CHECK(hits.AllExactlyOnce());
+}
+
+TEST(RunAndWaitExecuteEveryJobOnce) {
+    for (uint32_t threads : ThreadCounts) {
+        JobSystem jobSystem;
+        REQUIRE(jobSystem.Initialize(threads));
+        REQUIRE(jobSystem.GetThreadCount() == threads);
+
+        Hits hits(10000);
+        JobCounter counter;
+        for (uint32_t begin = 0; begin < 10000; begin += 10) {
+            jobSystem.Run(MarkRange, &hits, begin, begin + 10, &counter);
+        }
+        jobSystem.Wait(counter);
+        CHECK(counter.IsDone());
+        CHECK(hits.AllExactlyOnce());
+        CHECK(jobSystem.GetStats().jobsExecuted == 1000);
+    }
+}
+
+TEST(ParallelForCoversTheRangeExactlyOnce) {
+    for (uint32_t threads : ThreadCounts) {
+        JobSystem jobSystem;
+        REQUIRE(jobSystem.Initialize(threads));
+        for (uint32_t count : {0u, 1u, 7u, 1000u, 100003u}) {
+            for (uint32_t grain : {0u, 1u, 64u, 200000u}) {
+                Hits hits(count);
+                jobSystem.ParallelFor(count, grain, [&](uint32_t begin, uint32_t end) {
+                    for (uint32_t i = begin; i < end; ++i) {
+                        hits.counts[i].fetch_add(1);
+                    }
+                });
+                CHECK(hits.AllExactlyOnce());
+            }
+        }
+    }
+}
+
+TEST(DependentJobsStartAfterTheirDependency) {
+    for (uint32_t threads : ThreadCounts) {
+        JobSystem jobSystem;
+        REQUIRE(jobSystem.Initialize(threads));
+        for (int round = 0; round < 50; ++round) {
+            Pipeline pipeline;
+            pipeline.values.assign(4096, 0);
+            JobCounter produced;
+            JobCounter consumed;
+            for (uint32_t begin = 0; begin < 4096; begin += 64) {
+                jobSystem.Run(ProduceRange, &pipeline, begin, begin + 64, &produced);
+            }
+            for (uint32_t begin = 0; begin < 4096; begin += 64) {
+                jobSystem.Run(ConsumeRange, &pipeline, begin, begin + 64, &consumed, &produced);
+            }
+            jobSystem.Wait(consumed);
+            CHECK(produced.IsDone());
+            CHECK(pipeline.misordered.load() == 0);
+        }
+    }
+}
+
+TEST(NestedParallelForFromWorkers) {
+    for (uint32_t threads : ThreadCounts) {
+        JobSystem jobSystem;
+        REQUIRE(jobSystem.Initialize(threads));
+        Hits hits(64 * 256);
+        Nested nested = {&jobSystem, &hits, 256};
+        JobCounter counter;
+        for (uint32_t outer = 0; outer < 64; ++outer) {
+            jobSystem.Run(NestedRange, &nested, outer, outer + 1, &counter);
+        }
+        jobSystem.Wait(counter);
+        CHECK(hits.AllExactlyOnce());
+    }
+}
+
+TEST(ExternalThreadsSubmitThroughTheInjectionQueue) {
+    for (uint32_t threads : ThreadCounts) {
+        JobSystem jobSystem;
+        REQUIRE(jobSystem.Initialize(threads));
+        Hits hits(4 * 2000);
+        std::vector<std::thread> submitters;
+        for (uint32_t t = 0; t < 4; ++t) {
+            submitters.emplace_back([&jobSystem, &hits, t] {
+                JobCounter counter;
+                for (uint32_t i = 0; i < 2000; i += 4) {
+                    uint32_t begin = t * 2000 + i;
+                    jobSystem.Run(MarkRange, &hits, begin, begin + 4, &counter);
+                }
+                jobSystem.Wait(counter);
+            });
+        }
+        for (std::thread& submitter : submitters) {
+            submitter.join();
+        }
+        CHECK(hits.AllExactlyOnce());
+    }
+}
+
+TEST(FullDequeRunsJobsInline) {
+    JobSystem jobSystem;
+    REQUIRE(jobSystem.Initialize(1));
+    const uint32_t count = JobSystem::QueueCapacity + 100;
+    Hits hits(count);
+    JobCounter counter;
+    for (uint32_t i = 0; i < count; ++i) {
+        jobSystem.Run(MarkRange, &hits, i, i + 1, &counter);
+    }
+    CHECK(jobSystem.GetStats().jobsInline >= 100);
+    jobSystem.Wait(counter);
+    CHECK(hits.AllExactlyOnce());
+}
+
+TEST(TaskExecutorRunsEveryTask) {
+    for (uint32_t threads : ThreadCounts) {
+        JobSystem jobSystem;
+        REQUIRE(jobSystem.Initialize(threads));
+        ParallelFor executor = jobSystem.GetTaskExecutor();
+        Hits hits(37);
+        executor(37, [&](uint32_t task) { hits.counts[task].fetch_add(1); });
+        CHECK(hits.AllExactlyOnce());
+    }
+}
+
+TEST(RepeatedInitializeAndShutdown) {
+    // Startup and shutdown race against workers going to sleep; cycle them many times
+    JobSystem jobSystem;
+    for (int cycle = 0; cycle < 200; ++cycle) {
+        REQUIRE(jobSystem.Initialize(ThreadCounts[cycle % 4]));
+        Hits hits(256);
+        jobSystem.ParallelFor(256, 8, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                hits.counts[i].fetch_add(1);
+            }
+        });
+        CHECK(hits.AllExactlyOnce());
+        jobSystem.Shutdown();
+    }
+}
@@ -0,0 +1,99 @@
+#include "Test.h"
+#include "scene/LodSelector.h"
+#include <cmath>
+
+namespace {
+
+// 90 degrees over 1000 pixels: 500 pixels per unit at distance 1
+LodSelector MakeSelector() {
+    LodSelector selector;
+    selector.SetProjection(1.57079633f, 1000.0f, 0.1f);
+    const float camera[3] = {0.0f, 0.0f, 0.0f};
+    selector.SetCamera(camera);
+    return selector;
+}
+
+// An object on the z axis whose sphere surface is distance units from the camera
+LodSelector::Object At(float distance, uint32_t chain, uint32_t lod = 0) {
+    return {{0.0f, 0.0f, distance + 1.0f}, 1.0f, 1.0f, chain, lod};
+}
+
+} // namespace
+
+TEST(LodSelectorProjectsErrorsToPixels) {
+    LodSelector selector = MakeSelector();
+    const float errors[] = {0.0f, 0.1f, 0.2f, 0.4f};
+    const uint32_t chain = selector.AddChain(errors, 4);
+    CHECK(selector.GetLevelCount(chain) == 4);
+    CHECK(selector.GetError(chain, 2) == 0.2f);
+
+    // error * scale * 500 / distance
+    LodSelector::Object object = At(100.0f, chain);
+    CHECK_NEAR(selector.ProjectedError(object, 2), 1.0, 1e-4);
+    object.scale = 2.0f;
+    CHECK_NEAR(selector.ProjectedError(object, 2), 2.0, 1e-4);
+
+    // Inside the sphere the distance is clamped to nearZ
+    object = At(-0.5f, chain);
+    CHECK_NEAR(selector.ProjectedError(object, 1), 0.1 * 500.0 / 0.1, 1e-1);
+}
+
+TEST(LodSelectorPicksTheCoarsestLevelWithinThreshold) {
+    LodSelector selector = MakeSelector();
+    const float errors[] = {0.0f, 0.1f, 0.2f, 0.4f};
+    const uint32_t chain = selector.AddChain(errors, 4);
+    selector.SetHysteresis(0.0f);
+
+    // At 150 units a pixel is 0.3 units: level 2 fits, level 3 does not
+    LodSelector::Object objects[3] = {At(150.0f, chain), At(10.0f, chain), At(1000.0f, chain)};
+    CHECK(selector.Select(objects, 3) == 2);
+    CHECK(objects[0].lod == 2);
+    CHECK(objects[1].lod == 0);
+    CHECK(objects[2].lod == 3);
+    CHECK(selector.Select(objects, 3) == 0); // Stable
+
+    // A 2-pixel threshold allows twice the error
+    selector.SetThreshold(2.0f);
+    CHECK(selector.Select(objects, 3) == 1);
+    CHECK(objects[0].lod == 3);
+
+    // Objects without a chain are left alone; a stale level past the chain is clamped
+    LodSelector::Object unchained = At(150.0f, LodSelector::InvalidChain, 7);
+    CHECK(selector.Select(&unchained, 1) == 0);
+    CHECK(unchained.lod == 7);
+    LodSelector::Object stale = At(10.0f, chain, 9);
+    CHECK(selector.Select(&stale, 1) == 1);
+    CHECK(stale.lod == 0);
+
+    selector.Clear();
+    CHECK(selector.AddChain(errors, 2) == 0);
+}
+
+TEST(LodSelectorHysteresisDelaysCoarsening) {
+    LodSelector selector = MakeSelector();
+    const float errors[] = {0.0f, 0.1f};
+    const uint32_t chain = selector.AddChain(errors, 2);
+    selector.SetHysteresis(0.5f);
+
+    // Level 1 is 1 pixel at 50 units. Moving away, it is taken only once it is below half
+    // a pixel, past 100 units; moving back, it is dropped as soon as it passes 1 pixel
+    LodSelector::Object object = At(40.0f, chain);
+    const float path[]         = {40.0f, 60.0f, 90.0f, 110.0f, 90.0f, 60.0f, 45.0f, 60.0f};
+    const uint32_t expected[]  = {0, 0, 0, 1, 1, 1, 0, 0};
+    uint32_t changes           = 0;
+    for (int step = 0; step < 8; ++step) {
+        object.center[2] = path[step] + 1.0f;
+        changes += selector.Select(&object, 1);
+        CHECK(object.lod == expected[step]);
+    }
+    CHECK(changes == 2);
+
+    // Without hysteresis the same path switches at 50 units both ways
+    selector.SetHysteresis(0.0f);
+    object.lod       = 0;
+    object.center[2] = 61.0f;
+    CHECK(selector.Select(&object, 1) == 1);
+    object.center[2] = 46.0f;
+    CHECK(selector.Select(&object, 1) == 1);
+    CHECK(object.lod == 0);
+}
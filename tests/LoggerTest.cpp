@@ -0,0 +1,245 @@
+#include "Test.h"
+#include "utils/Logger.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Sends the process-wide logger to a fresh file for one test and reads it back
+class LogCapture {
+  public:
+    LogCapture() {
+        std::remove(Path);
+        Logger::Get().SetConsole(false);
+        Logger::Get().SetLevel(LogLevel::Trace);
+        Logger::Get().SetFile(Path);
+    }
+    ~LogCapture() {
+        Logger::Get().Flush();
+        Logger::Get().SetFile("");
+        Logger::Get().SetConsole(true);
+        std::remove(Path);
+    }
+
+    std::string Text() {
+        Logger::Get().Flush();
+        std::string text;
+        FILE* file = std::fopen(Path, "rb");
+        if (file) {
+            char buffer[65536];
+            size_t read = 0;
+            while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+                text.append(buffer, read);
+            }
+            std::fclose(file);
+        }
+        return text;
+    }
+
+  private:
+    static constexpr const char* Path = "LoggerTest.log";
+};
+
+uint32_t Count(const std::string& text, const std::string& pattern) {
+    uint32_t count = 0;
+    size_t at      = text.find(pattern);
+    while (at != std::string::npos) {
+        ++count;
+        at = text.find(pattern, at + 1);
+    }
+    return count;
+}
+
+// Call sites built at run time, for tests that need more than one site per loop
+std::unique_ptr<LogSite[]> MakeSites(uint32_t count, LogLevel level) {
+    std::unique_ptr<LogSite[]> sites(new LogSite[count]);
+    for (uint32_t i = 0; i < count; ++i) {
+        sites[i].file  = __FILE__;
+        sites[i].line  = static_cast<int>(i);
+        sites[i].level = level;
+    }
+    return sites;
+}
+
+// One call site for every message, like an error logged once per frame
+void LogEveryFrame(int frame) {
+    LOG_ERROR("every frame %d", frame);
+}
+
+} // namespace
+
+TEST(MessagesReachTheFileSink) {
+    LogCapture capture;
+    LOG_INFO("plain message %d", 42);
+    LOG_WARNING("warning with a trailing newline\n");
+    LOG_ERROR("error %s", "text");
+    const std::string text = capture.Text();
+    CHECK(Count(text, "plain message 42\n") == 1);
+    CHECK(Count(text, "warning with a trailing newline\n") == 1);
+    CHECK(Count(text, "error text\n") == 1);
+    CHECK(Count(text, "LoggerTest.cpp:") == 3);
+}
+
+TEST(DeferredFormattingMatchesPrintf) {
+    // Arguments are copied at the call and formatted later by the background thread; the
+    // caller's string buffer is overwritten before then
+    LogCapture capture;
+    char name[16]              = "shader.hlsl";
+    const char unterminated[4] = {'a', 'b', 'c', 'd'};
+    const long long big        = -1234567890123LL;
+    const size_t bytes         = 4096;
+    const double ratio         = 0.3333333;
+    LOG_INFO("[%s] [%-6d|%+05d] [%*d] [%.*f] [%lld] [%zu] [%x] [%c] [%5.2e] [%.3s] [100%%]",
+             name,
+             42,
+             7,
+             6,
+             -3,
+             2,
+             ratio,
+             big,
+             bytes,
+             0xBEEFu,
+             'q',
+             12345.678,
+             unterminated);
+    std::strcpy(name, "overwritten");
+
+    char expected[256];
+    std::snprintf(expected,
+                  sizeof(expected),
+                  "[%s] [%-6d|%+05d] [%*d] [%.*f] [%lld] [%zu] [%x] [%c] [%5.2e] [%.3s] [100%%]\n",
+                  "shader.hlsl",
+                  42,
+                  7,
+                  6,
+                  -3,
+                  2,
+                  ratio,
+                  big,
+                  bytes,
+                  0xBEEFu,
+                  'q',
+                  12345.678,
+                  unterminated);
+    const std::string text = capture.Text();
+    CHECK(Count(text, expected) == 1);
+    CHECK(Count(text, "overwritten") == 0);
+}
+
+TEST(LevelsBelowTheMinimumAreDiscarded) {
+    LogCapture capture;
+    Logger::Get().SetLevel(LogLevel::Warning);
+    CHECK(!Logger::Get().IsEnabled(LogLevel::Info));
+    CHECK(Logger::Get().IsEnabled(LogLevel::Error));
+    LOG_DEBUG("hidden debug");
+    LOG_INFO("hidden info");
+    LOG_WARNING("shown warning");
+    const std::string text = capture.Text();
+    CHECK(Count(text, "hidden") == 0);
+    CHECK(Count(text, "shown warning") == 1);
+}
+
+TEST(LongMessagesAreTruncated) {
+    LogCapture capture;
+    const std::string longText(Logger::MessageSize * 2, 'x');
+    LOG_INFO("%s", longText.c_str());
+    const std::string text = capture.Text();
+    CHECK(Count(text, std::string(Logger::MessageSize - 1, 'x')) == 1);
+    CHECK(Count(text, std::string(Logger::MessageSize, 'x')) == 0);
+}
+
+TEST(EachSiteIsRateLimited) {
+    LogCapture capture;
+    const uint64_t suppressedBefore = Logger::Get().GetStats().suppressed;
+    for (int i = 0; i < 100; ++i) {
+        LogEveryFrame(i);
+    }
+    LOG_ERROR("another site");
+    std::string text = capture.Text();
+    CHECK(Count(text, "every frame") == LogSite::Burst);
+    CHECK(Count(text, "another site") == 1);
+    CHECK(Logger::Get().GetStats().suppressed - suppressedBefore == 100 - LogSite::Burst);
+
+    // The first message of the next window reports what the site dropped
+    std::this_thread::sleep_for(std::chrono::milliseconds(LogSite::WindowMs + 50));
+    LogEveryFrame(100);
+    LogEveryFrame(101);
+    text = capture.Text();
+    CHECK(Count(text, "every frame 100 (92 similar suppressed)") == 1);
+    CHECK(Count(text, "every frame 101\n") == 1);
+}
+
+TEST(BlocksCountOnceAndKeepEveryLine) {
+    LogCapture capture;
+    std::string block;
+    for (int i = 0; i < 40; ++i) {
+        block += "error X" + std::to_string(1000 + i) + ": something went wrong here\n";
+    }
+    LOG_ERROR_BLOCK(block.c_str(), block.size());
+    std::string text = capture.Text();
+    for (int i = 0; i < 40; ++i) {
+        CHECK(Count(text, "error X" + std::to_string(1000 + i) + ":") == 1);
+    }
+
+    // One site, many blocks: the burst applies to blocks, not records
+    std::unique_ptr<LogSite[]> site = MakeSites(1, LogLevel::Error);
+    const std::string small         = "block line one\nblock line two\n";
+    for (int i = 0; i < 20; ++i) {
+        Logger::Get().WriteBlock(site[0], small.c_str(), small.size());
+    }
+    text = capture.Text();
+    CHECK(Count(text, "block line one") == LogSite::Burst);
+
+    // A line longer than a record is cut rather than lost
+    const std::string overlong(Logger::MessageSize + 10, 'y');
+    std::unique_ptr<LogSite[]> other = MakeSites(1, LogLevel::Error);
+    Logger::Get().WriteBlock(other[0], overlong.c_str(), overlong.size());
+    text = capture.Text();
+    CHECK(Count(text, std::string(Logger::MessageSize - 1, 'y')) == 1);
+    CHECK(Count(text, std::string(Logger::MessageSize, 'y')) == 0);
+}
+
+TEST(ConcurrentProducersNeverInterleave) {
+    LogCapture capture;
+    const uint32_t threadCount = 4;
+    const uint32_t perThread   = 256; // One site each, so no rate limit applies
+    const Logger::Stats before = Logger::Get().GetStats();
+
+    std::vector<std::unique_ptr<LogSite[]>> sites;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        sites.push_back(MakeSites(perThread, LogLevel::Info));
+    }
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&sites, t] {
+            for (uint32_t i = 0; i < perThread; ++i) {
+                Logger::Get().Write(sites[t][i], "producer %u message %u end", t, i);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const std::string text    = capture.Text();
+    const Logger::Stats after = Logger::Get().GetStats();
+    const uint64_t written    = after.written - before.written;
+    const uint64_t dropped    = after.dropped - before.dropped;
+    CHECK(written + dropped == threadCount * perThread);
+    CHECK(dropped == 0); // 1024 records fit the queue even if the writer never ran
+
+    bool intact = true;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        for (uint32_t i = 0; i < perThread; ++i) {
+            const std::string message =
+                "producer " + std::to_string(t) + " message " + std::to_string(i) + " end\n";
+            intact = intact && Count(text, message) == 1;
+        }
+    }
+    CHECK(intact);
+}
@@ -0,0 +1,327 @@
+#include "Test.h"
+#include "render/MeshFile.h"
+#include "render/VertexEncoder.h"
+#include "utils/Lz4.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+// A strip of quads split into two submeshes, each with part-local indices
+struct SampleMesh {
+    std::vector<PackedVertex> vertices;
+    std::vector<uint32_t> indices;
+    uint32_t firstVertexCount = 0;
+    uint32_t firstIndexCount  = 0;
+
+    explicit SampleMesh(uint32_t quads) {
+        std::vector<Vertex> source;
+        for (uint32_t part = 0; part < 2; ++part) {
+            const uint32_t base = static_cast<uint32_t>(source.size());
+            for (uint32_t i = 0; i <= quads; ++i) {
+                for (uint32_t row = 0; row < 2; ++row) {
+                    Vertex vertex;
+                    vertex.position[0] = -1.0f + 2.0f * i / quads;
+                    vertex.position[1] = row ? 0.5f : -0.5f;
+                    vertex.position[2] = part * 0.25f;
+                    vertex.color[0]    = 1.0f;
+                    vertex.color[1]    = static_cast<float>(i % 2);
+                    vertex.color[2]    = 0.0f;
+                    vertex.color[3]    = 1.0f;
+                    source.push_back(vertex);
+                }
+            }
+            for (uint32_t i = 0; i < quads; ++i) {
+                const uint32_t a = i * 2;
+                for (uint32_t index : {a, a + 1, a + 2, a + 2, a + 1, a + 3}) {
+                    indices.push_back(index);
+                }
+            }
+            if (part == 0) {
+                firstVertexCount = static_cast<uint32_t>(source.size()) - base;
+                firstIndexCount  = static_cast<uint32_t>(indices.size());
+            }
+        }
+        vertices.resize(source.size());
+        VertexEncoder::EncodeVertices(source.data(),
+                                      static_cast<uint32_t>(source.size()),
+                                      vertices.data());
+    }
+
+    void Fill(MeshFileWriter& writer) const {
+        const float min[3] = {-1.0f, -0.5f, 0.0f};
+        const float max[3] = {1.0f, 0.5f, 0.25f};
+        writer.SetVertices(vertices.data(), static_cast<uint32_t>(vertices.size()));
+        writer.SetIndices(indices.data(), static_cast<uint32_t>(indices.size()));
+        writer.SetBounds(min, max);
+        const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+        const uint32_t indexCount  = static_cast<uint32_t>(indices.size());
+        writer.AddSubmesh("Front", 0, firstIndexCount, 0, firstVertexCount, min, max);
+        writer.AddSubmesh("Back",
+                          firstIndexCount,
+                          indexCount - firstIndexCount,
+                          firstVertexCount,
+                          vertexCount - firstVertexCount,
+                          min,
+                          max);
+    }
+};
+
+std::vector<uint8_t> BuildSample(bool compress) {
+    MeshFileWriter writer;
+    SampleMesh(16).Fill(writer);
+    return writer.Build(compress);
+}
+
+// The file's indices widened to 32 bits
+std::vector<uint32_t> ReadIndices(const MeshFile& mesh) {
+    const uint32_t count = mesh.GetHeader().indexCount;
+    std::vector<uint32_t> indices(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (mesh.GetHeader().indexSize == 2) {
+            uint16_t index;
+            std::memcpy(&index, static_cast<const uint8_t*>(mesh.GetIndexData()) + i * 2, 2);
+            indices[i] = index;
+        } else {
+            std::memcpy(&indices[i], static_cast<const uint8_t*>(mesh.GetIndexData()) + i * 4, 4);
+        }
+    }
+    return indices;
+}
+
+} // namespace
+
+TEST(RoundTripThroughMemory) {
+    const SampleMesh sample(16);
+    const std::vector<uint8_t> bytes = BuildSample(false);
+    MeshFile mesh;
+    REQUIRE(mesh.Load(bytes.data(), bytes.size()));
+    CHECK(mesh.Verify());
+
+    const MeshFile::Header& header = mesh.GetHeader();
+    CHECK(header.vertexCount == sample.vertices.size());
+    CHECK(header.indexCount == sample.indices.size());
+    CHECK(header.indexSize == 2);
+    CHECK(header.positionScale == 1.0f);
+    CHECK(mesh.HasVertexFormat<PackedVertex>());
+    CHECK(!mesh.HasVertexFormat<Vertex>());
+
+    // Sections are aligned and the uncompressed ones point into the caller's bytes
+    for (uint32_t i = 0; i < MeshFile::SectionCount; ++i) {
+        CHECK(header.sections[i].offset % MeshFile::SectionAlign == 0);
+    }
+    CHECK(mesh.GetVertexData() == bytes.data() + header.sections[MeshFile::Vertices].offset);
+    CHECK(mesh.GetVertexDataSize() == sample.vertices.size() * sizeof(PackedVertex));
+    CHECK(std::memcmp(mesh.GetVertexData(), sample.vertices.data(), mesh.GetVertexDataSize()) ==
+          0);
+    CHECK(ReadIndices(mesh) == sample.indices);
+
+    REQUIRE(mesh.GetSubmeshCount() == 2);
+    CHECK(std::strcmp(mesh.GetSubmesh(0).name, "Front") == 0);
+    CHECK(std::strcmp(mesh.GetSubmesh(1).name, "Back") == 0);
+    CHECK(mesh.GetSubmesh(1).indexStart == sample.firstIndexCount);
+    CHECK(mesh.GetSubmesh(1).baseVertex == sample.firstVertexCount);
+}
+
+TEST(CompressedFileDecodesToTheSameData) {
+    const std::vector<uint8_t> plain      = BuildSample(false);
+    const std::vector<uint8_t> compressed = BuildSample(true);
+    CHECK(compressed.size() < plain.size());
+
+    MeshFile expected;
+    MeshFile actual;
+    REQUIRE(expected.Load(plain.data(), plain.size()));
+    REQUIRE(actual.Load(compressed.data(), compressed.size()));
+    CHECK(actual.GetHeader().flags == MeshFile::Compressed);
+    REQUIRE(actual.GetVertexDataSize() == expected.GetVertexDataSize());
+    CHECK(std::memcmp(actual.GetVertexData(),
+                      expected.GetVertexData(),
+                      expected.GetVertexDataSize()) == 0);
+    CHECK(ReadIndices(actual) == ReadIndices(expected));
+    CHECK(actual.Verify());
+}
+
+TEST(LargeIndicesUseThirtyTwoBits) {
+    std::vector<Vertex> vertices(70000);
+    std::vector<uint32_t> indices = {0, 1, 69999};
+    MeshFileWriter writer;
+    writer.SetVertices(vertices.data(), static_cast<uint32_t>(vertices.size()));
+    writer.SetIndices(indices.data(), 3);
+    const float zero[3] = {0.0f, 0.0f, 0.0f};
+    REQUIRE(writer.AddSubmesh("Big", 0, 3, 0, 70000, zero, zero));
+    const std::vector<uint8_t> bytes = writer.Build(false);
+
+    MeshFile mesh;
+    REQUIRE(mesh.Load(bytes.data(), bytes.size()));
+    CHECK(mesh.GetHeader().indexSize == 4);
+    CHECK(mesh.HasVertexFormat<Vertex>());
+    CHECK(ReadIndices(mesh) == indices);
+}
+
+TEST(WriterRejectsInvalidSubmeshes) {
+    MeshFileWriter writer;
+    SampleMesh sample(4);
+    writer.SetVertices(sample.vertices.data(), static_cast<uint32_t>(sample.vertices.size()));
+    writer.SetIndices(sample.indices.data(), static_cast<uint32_t>(sample.indices.size()));
+    const uint32_t indexCount  = static_cast<uint32_t>(sample.indices.size());
+    const uint32_t vertexCount = static_cast<uint32_t>(sample.vertices.size());
+    const float zero[3]        = {0.0f, 0.0f, 0.0f};
+
+    CHECK(writer.AddSubmesh("All", 0, indexCount, 0, vertexCount, zero, zero));
+    CHECK(!writer.AddSubmesh("PastIndices", 1, indexCount, 0, vertexCount, zero, zero));
+    CHECK(!writer.AddSubmesh("PastVertices", 0, indexCount, 1, vertexCount, zero, zero));
+    CHECK(!writer.AddSubmesh("NoMeshlets", 0, indexCount, 0, vertexCount, zero, zero, 0, 1));
+    CHECK(!writer.AddSubmesh("NoLods", 0, indexCount, 0, vertexCount, zero, zero, 0, 0, 0, 1));
+    const std::string longName(MeshFile::MaxNameLen + 1, 'A');
+    CHECK(!writer.AddSubmesh(longName, 0, indexCount, 0, vertexCount, zero, zero));
+
+    // A meshlet must lie inside the range of the submesh that lists it
+    MeshFile::Meshlet meshlet = {};
+    meshlet.indexStart        = 0;
+    meshlet.indexCount        = 6;
+    writer.SetMeshlets(&meshlet, 1);
+    CHECK(writer.AddSubmesh("Meshlet", 0, indexCount, 0, vertexCount, zero, zero, 0, 1));
+    CHECK(!writer.AddSubmesh("Outside", 6, 6, 0, vertexCount, zero, zero, 0, 1));
+}
+
+TEST(MeshletsAndLodsRoundTrip) {
+    MeshFileWriter writer;
+    SampleMesh sample(8);
+    const uint32_t indexCount = sample.firstIndexCount;
+    writer.SetVertices(sample.vertices.data(), static_cast<uint32_t>(sample.vertices.size()));
+    writer.SetIndices(sample.indices.data(), static_cast<uint32_t>(sample.indices.size()));
+
+    // Two meshlets for the submesh, one for its single LOD (the second part's triangles)
+    MeshFile::Meshlet meshlets[3] = {};
+    meshlets[0].indexStart        = 0;
+    meshlets[0].indexCount        = indexCount / 2;
+    meshlets[1].indexStart        = indexCount / 2;
+    meshlets[1].indexCount        = indexCount - indexCount / 2;
+    meshlets[2].indexStart        = indexCount;
+    meshlets[2].indexCount        = 12;
+    meshlets[1].radius            = 2.5f;
+    MeshFile::Lod lod             = {indexCount, 12, 2, 1, 0.125f};
+    writer.SetMeshlets(meshlets, 3);
+    writer.SetLods(&lod, 1);
+    const float zero[3] = {0.0f, 0.0f, 0.0f};
+    REQUIRE(writer.AddSubmesh(
+        "Front", 0, indexCount, 0, sample.firstVertexCount, zero, zero, 0, 2, 0, 1));
+
+    const std::vector<uint8_t> bytes = writer.Build(true);
+    MeshFile mesh;
+    REQUIRE(mesh.Load(bytes.data(), bytes.size()));
+    CHECK(mesh.Verify());
+    REQUIRE(mesh.GetMeshletCount() == 3);
+    REQUIRE(mesh.GetLodCount() == 1);
+    CHECK(mesh.GetMeshlet(1).indexStart == indexCount / 2);
+    CHECK(mesh.GetMeshlet(1).radius == 2.5f);
+    CHECK(mesh.GetLod(0).indexStart == indexCount);
+    CHECK(mesh.GetLod(0).error == 0.125f);
+    CHECK(mesh.GetSubmesh(0).lodCount == 1);
+}
+
+TEST(LoadRejectsDamagedFiles) {
+    const std::vector<uint8_t> good = BuildSample(false);
+    MeshFile mesh;
+    CHECK(!mesh.Load(good.data(), sizeof(MeshFile::Header) - 1));
+    CHECK(!mesh.Load(good.data(), good.size() - 1)); // Last section cut short
+
+    std::vector<uint8_t> bytes = good;
+    bytes[0] ^= 0xFF; // Magic
+    CHECK(!mesh.Load(bytes.data(), bytes.size()));
+
+    bytes                    = good;
+    MeshFile::Header* header = reinterpret_cast<MeshFile::Header*>(bytes.data());
+    header->version          = MeshFile::Version + 1;
+    CHECK(!mesh.Load(bytes.data(), bytes.size()));
+
+    bytes              = good;
+    header             = reinterpret_cast<MeshFile::Header*>(bytes.data());
+    header->indexCount = header->indexCount + 1; // Sizes no longer follow from the counts
+    CHECK(!mesh.Load(bytes.data(), bytes.size()));
+
+    // A failed load leaves the mesh empty
+    CHECK(mesh.GetSubmeshCount() == 0);
+    CHECK(mesh.GetVertexData() == nullptr);
+}
+
+TEST(VerifyDetectsIndicesPastTheVertices) {
+    std::vector<uint8_t> bytes = BuildSample(false);
+    MeshFile mesh;
+    REQUIRE(mesh.Load(bytes.data(), bytes.size()));
+    const MeshFile::Header& header = mesh.GetHeader();
+    const uint16_t outside         = static_cast<uint16_t>(header.vertexCount);
+    std::memcpy(bytes.data() + header.sections[MeshFile::Indices].offset, &outside, 2);
+    CHECK(mesh.Load(bytes.data(), bytes.size())); // Load leaves the index pages alone
+    CHECK(!mesh.Verify());
+}
+
+TEST(CorruptFilesNeverLoadOutOfBounds) {
+    // Random truncations and bit flips either fail to load or load something that verifies
+    // without reading outside the buffer (run under a sanitizer to catch the latter)
+    for (bool compress : {false, true}) {
+        const std::vector<uint8_t> good = BuildSample(compress);
+        std::mt19937 rng(compress ? 2 : 1);
+        for (int trial = 0; trial < 2000; ++trial) {
+            std::vector<uint8_t> bytes = good;
+            if (trial % 4 == 0) {
+                bytes.resize(rng() % bytes.size());
+            } else {
+                for (int flip = 0; flip < 1 + trial % 3; ++flip) {
+                    bytes[rng() % bytes.size()] ^= static_cast<uint8_t>(1u << (rng() % 8));
+                }
+            }
+            MeshFile mesh;
+            if (mesh.Load(bytes.data(), bytes.size())) {
+                mesh.Verify();
+            }
+        }
+    }
+}
+
+TEST(OpenMapsAFile) {
+    const char* path = "MeshFileTest.mesh";
+    MeshFileWriter writer;
+    SampleMesh(16).Fill(writer);
+    REQUIRE(writer.Write(path, false));
+
+    MeshFile mesh;
+    REQUIRE(mesh.Open(path));
+    CHECK(mesh.Verify());
+    CHECK(mesh.GetSubmeshCount() == 2);
+    mesh.Close();
+    CHECK(mesh.GetSubmeshCount() == 0);
+    std::remove(path);
+
+    CHECK(!mesh.Open("MeshFileTest.missing"));
+}
+
+TEST(Lz4RoundTrips) {
+    std::mt19937 rng(3);
+    for (int trial = 0; trial < 200; ++trial) {
+        // Mixes of runs, repeated phrases and noise, from empty to 64 KB
+        std::vector<uint8_t> data(rng() % 65536 * (trial % 10 != 0));
+        for (size_t i = 0; i < data.size(); ++i) {
+            const uint32_t kind = (i / 512 + trial) % 3;
+            data[i] = kind == 0 ? 7 : (kind == 1 ? static_cast<uint8_t>(i % 13) : rng() & 0xFF);
+        }
+        std::vector<uint8_t> compressed(Lz4::CompressBound(data.size()));
+        const size_t size =
+            Lz4::Compress(data.data(), data.size(), compressed.data(), compressed.size());
+        REQUIRE(size > 0 || data.empty());
+
+        std::vector<uint8_t> decoded(data.size());
+        CHECK(Lz4::Decompress(compressed.data(), size, decoded.data(), decoded.size()));
+        CHECK(decoded == data);
+
+        // A short block or a wrong expected size is an error, not an overrun
+        if (size > 1) {
+            CHECK(!Lz4::Decompress(compressed.data(), size - 1, decoded.data(), decoded.size()));
+        }
+        if (!data.empty()) {
+            CHECK(!Lz4::Decompress(compressed.data(), size, decoded.data(), decoded.size() - 1));
+        }
+    }
+}
@@ -0,0 +1,415 @@
+#include "Test.h"
+#include "render/MeshOptimizer.h"
+#include "render/RenderBackend.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Mesh {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+
+    uint32_t VertexCount() const {
+        return static_cast<uint32_t>(vertices.size());
+    }
+    uint32_t IndexCount() const {
+        return static_cast<uint32_t>(indices.size());
+    }
+    const float* Positions() const {
+        return vertices.front().position;
+    }
+};
+
+// Same as the optimizer's: the front-face normal, not normalized
+void FaceNormal(const float* a, const float* b, const float* c, float normal[3]) {
+    const float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    const float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    normal[0]         = e1[1] * e2[2] - e1[2] * e2[1];
+    normal[1]         = e1[2] * e2[0] - e1[0] * e2[2];
+    normal[2]         = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+/*
+UV sphere with front faces outward; the poles repeat one vertex per slice, so the
+triangles touching them are degenerate
+*/
+Mesh Sphere(uint32_t stacks, uint32_t slices, float radius, const float center[3]) {
+    Mesh mesh;
+    for (uint32_t stack = 0; stack <= stacks; ++stack) {
+        const float theta = 3.14159265f * static_cast<float>(stack) / static_cast<float>(stacks);
+        for (uint32_t slice = 0; slice <= slices; ++slice) {
+            const float phi = 6.28318531f * static_cast<float>(slice) / static_cast<float>(slices);
+            Vertex vertex;
+            vertex.position[0] = center[0] + radius * std::sin(theta) * std::cos(phi);
+            vertex.position[1] = center[1] + radius * std::cos(theta);
+            vertex.position[2] = center[2] + radius * std::sin(theta) * std::sin(phi);
+            vertex.color[0]    = static_cast<float>(stack) / static_cast<float>(stacks);
+            vertex.color[1]    = 0.5f;
+            vertex.color[2]    = 0.25f;
+            vertex.color[3]    = 1.0f;
+            mesh.vertices.push_back(vertex);
+        }
+    }
+    for (uint32_t stack = 0; stack < stacks; ++stack) {
+        for (uint32_t slice = 0; slice < slices; ++slice) {
+            const uint32_t a       = stack * (slices + 1) + slice;
+            const uint32_t b       = a + slices + 1;
+            const uint32_t quad[6] = {a, b, a + 1, a + 1, b, b + 1};
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    }
+
+    // Wind every triangle so its normal points away from the centre
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        const float* p[3] = {mesh.vertices[mesh.indices[i]].position,
+                             mesh.vertices[mesh.indices[i + 1]].position,
+                             mesh.vertices[mesh.indices[i + 2]].position};
+        float normal[3];
+        FaceNormal(p[0], p[1], p[2], normal);
+        float outward = 0.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            outward += normal[axis] * (p[0][axis] + p[1][axis] + p[2][axis] - 3.0f * center[axis]);
+        }
+        if (outward < 0.0f) {
+            std::swap(mesh.indices[i + 1], mesh.indices[i + 2]);
+        }
+    }
+    return mesh;
+}
+
+// One vertex per corner, as a loader that does not share vertices produces
+Mesh Soup(const Mesh& mesh) {
+    Mesh soup;
+    for (uint32_t index : mesh.indices) {
+        soup.indices.push_back(soup.VertexCount());
+        soup.vertices.push_back(mesh.vertices[index]);
+    }
+    return soup;
+}
+
+void Append(Mesh& mesh, const Mesh& part) {
+    const uint32_t base = mesh.VertexCount();
+    mesh.vertices.insert(mesh.vertices.end(), part.vertices.begin(), part.vertices.end());
+    for (uint32_t index : part.indices) {
+        mesh.indices.push_back(base + index);
+    }
+}
+
+void ShuffleTriangles(Mesh& mesh, uint32_t seed) {
+    std::mt19937 rng(seed);
+    const uint32_t triangles = mesh.IndexCount() / 3;
+    for (uint32_t i = triangles; i > 1; --i) {
+        const uint32_t j = static_cast<uint32_t>(rng() % i);
+        for (int k = 0; k < 3; ++k) {
+            std::swap(mesh.indices[(i - 1) * 3 + k], mesh.indices[j * 3 + k]);
+        }
+    }
+}
+
+// Triangles with their smallest index first (winding kept), sorted
+std::vector<std::array<uint32_t, 3>> Triangles(const std::vector<uint32_t>& indices) {
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        std::array<uint32_t, 3> t = {indices[i], indices[i + 1], indices[i + 2]};
+        while (t[0] > t[1] || t[0] > t[2]) {
+            t = {t[1], t[2], t[0]};
+        }
+        triangles.push_back(t);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+// Two nested spheres and a third beside them, unwelded and shuffled
+Mesh Corpus() {
+    const float origin[3] = {0.0f, 0.0f, 0.0f};
+    const float beside[3] = {3.0f, 0.5f, 0.0f};
+    Mesh mesh;
+    Append(mesh, Sphere(24, 48, 1.0f, origin));
+    Append(mesh, Sphere(16, 32, 0.6f, origin));
+    Append(mesh, Sphere(12, 24, 0.8f, beside));
+    mesh = Soup(mesh);
+    ShuffleTriangles(mesh, 7);
+    return mesh;
+}
+
+// The converter's pipeline; every stage's output is checked by the caller
+struct Optimized {
+    Mesh welded;
+    std::vector<uint32_t> cacheOrder;
+    std::vector<uint32_t> overdrawOrder;
+    Mesh fetched;
+    std::vector<MeshFile::Meshlet> meshlets;
+};
+
+Optimized Optimize(const Mesh& mesh) {
+    Optimized result;
+    std::vector<uint32_t> remap(mesh.VertexCount());
+    const uint32_t unique = MeshOptimizer::GenerateRemap(remap.data(),
+                                                         mesh.vertices.data(),
+                                                         mesh.VertexCount(),
+                                                         sizeof(Vertex));
+    result.welded.vertices.resize(unique);
+    result.welded.indices = mesh.indices;
+    MeshOptimizer::RemapIndices(result.welded.indices.data(), mesh.IndexCount(), remap.data());
+    MeshOptimizer::RemapVertices(result.welded.vertices.data(),
+                                 mesh.vertices.data(),
+                                 mesh.VertexCount(),
+                                 sizeof(Vertex),
+                                 remap.data());
+
+    const Mesh& welded = result.welded;
+    result.cacheOrder.resize(welded.IndexCount());
+    MeshOptimizer::OptimizeVertexCache(result.cacheOrder.data(),
+                                       welded.indices.data(),
+                                       welded.IndexCount(),
+                                       welded.VertexCount());
+    result.overdrawOrder.resize(welded.IndexCount());
+    MeshOptimizer::OptimizeOverdraw(result.overdrawOrder.data(),
+                                    result.cacheOrder.data(),
+                                    welded.IndexCount(),
+                                    welded.Positions(),
+                                    welded.VertexCount(),
+                                    sizeof(Vertex));
+
+    result.fetched.indices = result.overdrawOrder;
+    result.fetched.vertices.resize(welded.VertexCount());
+    const uint32_t used = MeshOptimizer::OptimizeVertexFetch(result.fetched.vertices.data(),
+                                                             result.fetched.indices.data(),
+                                                             welded.IndexCount(),
+                                                             welded.vertices.data(),
+                                                             welded.VertexCount(),
+                                                             sizeof(Vertex));
+    result.fetched.vertices.resize(used);
+    MeshOptimizer::BuildMeshlets(result.meshlets,
+                                 result.fetched.indices.data(),
+                                 result.fetched.IndexCount(),
+                                 result.fetched.Positions(),
+                                 result.fetched.VertexCount(),
+                                 sizeof(Vertex));
+    return result;
+}
+
+} // namespace
+
+TEST(MeshOptimizerCacheStatsCountFifoMisses) {
+    const uint32_t triangle[6] = {0, 1, 2, 0, 1, 2};
+    MeshOptimizer::CacheStats stats = MeshOptimizer::AnalyzeVertexCache(triangle, 3, 3);
+    CHECK(stats.misses == 3);
+    CHECK_NEAR(stats.acmr, 3.0, 1e-6);
+    CHECK_NEAR(stats.atvr, 1.0, 1e-6);
+
+    // The repeat hits, so the two triangles cost three misses
+    stats = MeshOptimizer::AnalyzeVertexCache(triangle, 6, 3);
+    CHECK(stats.misses == 3);
+    CHECK_NEAR(stats.acmr, 1.5, 1e-6);
+
+    // With a cache of 3, a fourth vertex evicts the first
+    const uint32_t strip[9] = {0, 1, 2, 1, 2, 3, 0, 1, 2};
+    stats                   = MeshOptimizer::AnalyzeVertexCache(strip, 9, 4, 3);
+    CHECK(stats.misses == 7);
+}
+
+TEST(MeshOptimizerWeldsIdenticalVertices) {
+    const float center[3]  = {0.0f, 0.0f, 0.0f};
+    const Mesh sphere      = Sphere(16, 32, 1.0f, center);
+    const Mesh soup        = Soup(sphere);
+    const Optimized result = Optimize(soup);
+
+    // Every corner keeps its bytes, and nothing identical survives twice
+    CHECK(result.welded.VertexCount() <= sphere.VertexCount());
+    CHECK(result.welded.VertexCount() * 5 < soup.VertexCount());
+    bool sameBytes = true;
+    for (uint32_t i = 0; i < soup.IndexCount(); ++i) {
+        sameBytes = sameBytes && std::memcmp(&result.welded.vertices[result.welded.indices[i]],
+                                             &soup.vertices[soup.indices[i]],
+                                             sizeof(Vertex)) == 0;
+    }
+    CHECK(sameBytes);
+    const std::vector<Vertex>& vertices = result.welded.vertices;
+    bool distinct                       = true;
+    for (size_t a = 0; a < vertices.size(); ++a) {
+        for (size_t b = a + 1; b < vertices.size(); ++b) {
+            distinct = distinct && std::memcmp(&vertices[a], &vertices[b], sizeof(Vertex)) != 0;
+        }
+    }
+    CHECK(distinct);
+
+    // Numbered in order of first appearance
+    std::vector<uint32_t> remap(soup.VertexCount());
+    MeshOptimizer::GenerateRemap(remap.data(),
+                                 soup.vertices.data(),
+                                 soup.VertexCount(),
+                                 sizeof(Vertex));
+    uint32_t next = 0;
+    bool ordered  = true;
+    for (uint32_t value : remap) {
+        ordered = ordered && value <= next;
+        next    = std::max(next, value + 1);
+    }
+    CHECK(ordered);
+}
+
+TEST(MeshOptimizerPassesKeepEveryTriangle) {
+    const Mesh mesh        = Corpus();
+    const Optimized result = Optimize(mesh);
+    const auto welded      = Triangles(result.welded.indices);
+    CHECK(Triangles(result.cacheOrder) == welded);
+    CHECK(Triangles(result.overdrawOrder) == welded);
+
+    // Fetch ordering renumbers; every corner still reads the same vertex bytes
+    REQUIRE(result.fetched.indices.size() == mesh.indices.size());
+    bool sameBytes = true;
+    for (uint32_t i = 0; i < mesh.IndexCount(); ++i) {
+        sameBytes = sameBytes && std::memcmp(&result.fetched.vertices[result.fetched.indices[i]],
+                                             &result.welded.vertices[result.overdrawOrder[i]],
+                                             sizeof(Vertex)) == 0;
+    }
+    CHECK(sameBytes);
+}
+
+TEST(MeshOptimizerImprovesCacheAndOverdraw) {
+    const Mesh mesh        = Corpus();
+    const Optimized result = Optimize(mesh);
+    const Mesh& welded     = result.welded;
+
+    const uint32_t count = welded.IndexCount();
+    const uint32_t verts = welded.VertexCount();
+    const MeshOptimizer::CacheStats before =
+        MeshOptimizer::AnalyzeVertexCache(welded.indices.data(), count, verts);
+    const MeshOptimizer::CacheStats cached =
+        MeshOptimizer::AnalyzeVertexCache(result.cacheOrder.data(), count, verts);
+    const MeshOptimizer::CacheStats after =
+        MeshOptimizer::AnalyzeVertexCache(result.overdrawOrder.data(), count, verts);
+    CHECK(before.acmr > 2.5f); // Shuffled: nearly every corner misses
+    CHECK(cached.acmr < 0.9f);
+    CHECK(after.acmr < cached.acmr * 1.1f); // Overdraw ordering gives up little
+    CHECK(cached.atvr < before.atvr);
+
+    const MeshOptimizer::OverdrawStats shuffled = MeshOptimizer::AnalyzeOverdraw(
+        welded.indices.data(), count, welded.Positions(), verts, sizeof(Vertex));
+    const MeshOptimizer::OverdrawStats sorted = MeshOptimizer::AnalyzeOverdraw(
+        result.overdrawOrder.data(), count, welded.Positions(), verts, sizeof(Vertex));
+    CHECK(shuffled.covered == sorted.covered);
+    CHECK(sorted.overdraw < shuffled.overdraw);
+
+    // A single convex mesh never overdraws with back faces culled
+    const float center[3] = {0.0f, 0.0f, 0.0f};
+    const Mesh sphere     = Sphere(24, 48, 1.0f, center);
+    const MeshOptimizer::OverdrawStats convex =
+        MeshOptimizer::AnalyzeOverdraw(sphere.indices.data(),
+                                       sphere.IndexCount(),
+                                       sphere.Positions(),
+                                       sphere.VertexCount(),
+                                       sizeof(Vertex));
+    CHECK_NEAR(convex.overdraw, 1.0, 0.01);
+}
+
+TEST(MeshOptimizerFetchOrderIsFirstUse) {
+    // Unreferenced vertices in between are dropped
+    const float center[3] = {0.0f, 0.0f, 0.0f};
+    Mesh mesh             = Sphere(8, 16, 1.0f, center);
+    Mesh padded;
+    for (uint32_t i = 0; i < mesh.VertexCount(); ++i) {
+        padded.vertices.push_back(mesh.vertices[i]);
+        padded.vertices.push_back(mesh.vertices[(i * 7) % mesh.VertexCount()]);
+    }
+    for (uint32_t index : mesh.indices) {
+        padded.indices.push_back(index * 2);
+    }
+    ShuffleTriangles(padded, 3);
+
+    std::vector<Vertex> fetched(padded.VertexCount());
+    std::vector<uint32_t> indices = padded.indices;
+    const uint32_t used = MeshOptimizer::OptimizeVertexFetch(fetched.data(),
+                                                             indices.data(),
+                                                             padded.IndexCount(),
+                                                             padded.vertices.data(),
+                                                             padded.VertexCount(),
+                                                             sizeof(Vertex));
+    CHECK(used == mesh.VertexCount());
+    uint32_t next  = 0;
+    bool firstUse  = true;
+    bool sameBytes = true;
+    for (uint32_t i = 0; i < padded.IndexCount(); ++i) {
+        firstUse  = firstUse && indices[i] <= next;
+        next      = std::max(next, indices[i] + 1);
+        sameBytes = sameBytes && std::memcmp(&fetched[indices[i]],
+                                             &padded.vertices[padded.indices[i]],
+                                             sizeof(Vertex)) == 0;
+    }
+    CHECK(firstUse);
+    CHECK(sameBytes);
+}
+
+TEST(MeshOptimizerMeshletsRespectLimitsAndBounds) {
+    const Optimized result = Optimize(Corpus());
+    const Mesh& mesh       = result.fetched;
+    REQUIRE(!result.meshlets.empty());
+
+    // Consecutive, covering the index list exactly, within the limits
+    uint32_t next     = 0;
+    bool withinLimits = true;
+    bool inSphere     = true;
+    for (const MeshFile::Meshlet& meshlet : result.meshlets) {
+        CHECK(meshlet.indexStart == next);
+        next += meshlet.indexCount;
+        std::vector<uint32_t> vertices(mesh.indices.begin() + meshlet.indexStart,
+                                       mesh.indices.begin() + meshlet.indexStart +
+                                           meshlet.indexCount);
+        std::sort(vertices.begin(), vertices.end());
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+        withinLimits = withinLimits && meshlet.indexCount % 3 == 0 && meshlet.indexCount > 0 &&
+                       meshlet.indexCount / 3 <= 124 && vertices.size() <= 64;
+        for (uint32_t vertex : vertices) {
+            const float* p = mesh.vertices[vertex].position;
+            float squared  = 0.0f;
+            for (int axis = 0; axis < 3; ++axis) {
+                squared += (p[axis] - meshlet.center[axis]) * (p[axis] - meshlet.center[axis]);
+            }
+            inSphere = inSphere && std::sqrt(squared) <= meshlet.radius * 1.0001f + 1e-6f;
+        }
+    }
+    CHECK(next == mesh.IndexCount());
+    CHECK(withinLimits);
+    CHECK(inSphere);
+
+    // From any camera the cone test culls a meshlet for, all of its triangles face away
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> unit(-6.0f, 6.0f);
+    uint32_t culled = 0;
+    bool onlyBacks  = true;
+    for (int camera = 0; camera < 64; ++camera) {
+        const float c[3] = {unit(rng), unit(rng), unit(rng)};
+        for (const MeshFile::Meshlet& meshlet : result.meshlets) {
+            const float d[3] = {meshlet.center[0] - c[0],
+                                meshlet.center[1] - c[1],
+                                meshlet.center[2] - c[2]};
+            const float distance = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+            const float along    = d[0] * meshlet.coneAxis[0] + d[1] * meshlet.coneAxis[1] +
+                                   d[2] * meshlet.coneAxis[2];
+            if (along < meshlet.coneCutoff * distance + meshlet.radius) {
+                continue;
+            }
+            ++culled;
+            for (uint32_t i = meshlet.indexStart; i < meshlet.indexStart + meshlet.indexCount;
+                 i += 3) {
+                const float* p[3] = {mesh.vertices[mesh.indices[i]].position,
+                                     mesh.vertices[mesh.indices[i + 1]].position,
+                                     mesh.vertices[mesh.indices[i + 2]].position};
+                float normal[3];
+                FaceNormal(p[0], p[1], p[2], normal);
+                const float facing = normal[0] * (p[0][0] - c[0]) + normal[1] * (p[0][1] - c[1]) +
+                                     normal[2] * (p[0][2] - c[2]);
+                onlyBacks = onlyBacks && facing >= -1e-5f;
+            }
+        }
+    }
+    CHECK(culled > 0);
+    CHECK(onlyBacks);
+}
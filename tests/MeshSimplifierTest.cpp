@@ -0,0 +1,363 @@
+#include "Test.h"
+#include "render/MeshSimplifier.h"
+#include "threading/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+struct Mesh {
+    std::vector<float> positions; // x, y, z per vertex
+    std::vector<uint32_t> indices;
+
+    uint32_t VertexCount() const {
+        return static_cast<uint32_t>(positions.size() / 3);
+    }
+    uint32_t IndexCount() const {
+        return static_cast<uint32_t>(indices.size());
+    }
+    const float* Position(uint32_t vertex) const {
+        return &positions[size_t(vertex) * 3];
+    }
+    MeshSimplifier::Input Input() const {
+        return {indices.data(), IndexCount(), positions.data(), VertexCount(), 3 * sizeof(float)};
+    }
+};
+
+void Cross(const float a[3], const float b[3], float out[3]) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+float Dot(const float a[3], const float b[3]) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+void Normal(const Mesh& mesh, const uint32_t* corner, float normal[3]) {
+    const float* a    = mesh.Position(corner[0]);
+    const float* b    = mesh.Position(corner[1]);
+    const float* c    = mesh.Position(corner[2]);
+    const float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    const float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    Cross(e1, e2, normal);
+}
+
+/*
+(cells + 1)^2 vertices on y = 0 over [-1, 1]^2, two triangles per cell
+seamColumn: Vertices of this column are doubled, the copy used by the cells to its right,
+as a COLOR discontinuity leaves them after welding (~0u for none)
+*/
+Mesh Grid(uint32_t cells, uint32_t seamColumn = ~0u) {
+    Mesh mesh;
+    std::vector<uint32_t> right((cells + 1) * (cells + 1));
+    for (uint32_t y = 0; y <= cells; ++y) {
+        for (uint32_t x = 0; x <= cells; ++x) {
+            const float p[3] = {-1.0f + 2.0f * x / cells, 0.0f, -1.0f + 2.0f * y / cells};
+            mesh.positions.insert(mesh.positions.end(), p, p + 3);
+        }
+    }
+    for (uint32_t vertex = 0; vertex < right.size(); ++vertex) {
+        right[vertex] = vertex;
+        if (vertex % (cells + 1) == seamColumn) {
+            right[vertex]       = mesh.VertexCount();
+            const float* p      = mesh.Position(vertex);
+            const float copy[3] = {p[0], p[1], p[2]};
+            mesh.positions.insert(mesh.positions.end(), copy, copy + 3);
+        }
+    }
+    for (uint32_t y = 0; y < cells; ++y) {
+        for (uint32_t x = 0; x < cells; ++x) {
+            // The left corners of the cell right of the seam use the copies
+            const uint32_t a       = y * (cells + 1) + x;
+            const uint32_t b       = a + cells + 1;
+            const uint32_t left    = x == seamColumn ? right[a] : a;
+            const uint32_t below   = x == seamColumn ? right[b] : b;
+            const uint32_t quad[6] = {left, below, a + 1, a + 1, below, b + 1};
+            mesh.indices.insert(mesh.indices.end(), quad, quad + 6);
+        }
+    }
+    return mesh;
+}
+
+// A closed sphere without duplicated seam vertices: poles and the wrap column are shared
+Mesh Sphere(uint32_t slices, uint32_t stacks) {
+    Mesh mesh;
+    const float top[3] = {0.0f, 1.0f, 0.0f};
+    mesh.positions.insert(mesh.positions.end(), top, top + 3);
+    for (uint32_t stack = 1; stack < stacks; ++stack) {
+        const float theta = 3.14159265f * stack / stacks;
+        for (uint32_t slice = 0; slice < slices; ++slice) {
+            const float phi  = 6.28318531f * slice / slices;
+            const float p[3] = {std::sin(theta) * std::cos(phi),
+                                std::cos(theta),
+                                std::sin(theta) * std::sin(phi)};
+            mesh.positions.insert(mesh.positions.end(), p, p + 3);
+        }
+    }
+    const float bottom[3] = {0.0f, -1.0f, 0.0f};
+    mesh.positions.insert(mesh.positions.end(), bottom, bottom + 3);
+
+    const uint32_t last = mesh.VertexCount() - 1;
+    auto ring           = [slices](uint32_t stack, uint32_t slice) {
+        return 1 + (stack - 1) * slices + slice % slices;
+    };
+    auto add = [&mesh](uint32_t a, uint32_t b, uint32_t c) {
+        const uint32_t corner[3] = {a, b, c};
+        float normal[3];
+        const float* p = mesh.Position(a);
+        Normal(mesh, corner, normal);
+        if (Dot(normal, p) < 0.0f) {
+            std::swap(b, c); // Wind outward
+        }
+        const uint32_t triangle[3] = {a, b, c};
+        mesh.indices.insert(mesh.indices.end(), triangle, triangle + 3);
+    };
+    for (uint32_t slice = 0; slice < slices; ++slice) {
+        add(0, ring(1, slice), ring(1, slice + 1));
+        add(last, ring(stacks - 1, slice + 1), ring(stacks - 1, slice));
+        for (uint32_t stack = 1; stack + 1 < stacks; ++stack) {
+            add(ring(stack, slice), ring(stack + 1, slice), ring(stack, slice + 1));
+            add(ring(stack, slice + 1), ring(stack + 1, slice), ring(stack + 1, slice + 1));
+        }
+    }
+    return mesh;
+}
+
+// Closest distance from p to triangle abc (Ericson, Real-Time Collision Detection 5.1.5)
+float PointTriangleDistance(const float p[3],
+                            const float a[3],
+                            const float b[3],
+                            const float c[3]) {
+    const float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    const float ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    const float ap[3] = {p[0] - a[0], p[1] - a[1], p[2] - a[2]};
+    const float bp[3] = {p[0] - b[0], p[1] - b[1], p[2] - b[2]};
+    const float cp[3] = {p[0] - c[0], p[1] - c[1], p[2] - c[2]};
+    const float d1    = Dot(ab, ap);
+    const float d2    = Dot(ac, ap);
+    const float d3    = Dot(ab, bp);
+    const float d4    = Dot(ac, bp);
+    const float d5    = Dot(ab, cp);
+    const float d6    = Dot(ac, cp);
+    const float va    = d3 * d6 - d5 * d4;
+    const float vb    = d5 * d2 - d1 * d6;
+    const float vc    = d1 * d4 - d3 * d2;
+
+    float v = 0.0f;
+    float w = 0.0f;
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+    } else if (d3 >= 0.0f && d4 <= d3) {
+        v = 1.0f;
+    } else if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        v = d1 / (d1 - d3);
+    } else if (d6 >= 0.0f && d5 <= d6) {
+        w = 1.0f;
+    } else if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        w = d2 / (d2 - d6);
+    } else if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        v = 1.0f - w;
+    } else {
+        const float denominator = 1.0f / (va + vb + vc);
+        v                       = vb * denominator;
+        w                       = vc * denominator;
+    }
+    float d[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        d[axis] = a[axis] + ab[axis] * v + ac[axis] * w - p[axis];
+    }
+    return std::sqrt(Dot(d, d));
+}
+
+// Largest distance from any input vertex to the nearest simplified triangle
+float MeasuredDeviation(const Mesh& mesh, const uint32_t* indices, uint32_t indexCount) {
+    float deviation = 0.0f;
+    for (uint32_t vertex = 0; vertex < mesh.VertexCount(); ++vertex) {
+        float nearest = 1e30f;
+        for (uint32_t i = 0; i < indexCount; i += 3) {
+            nearest = std::min(nearest,
+                               PointTriangleDistance(mesh.Position(vertex),
+                                                     mesh.Position(indices[i]),
+                                                     mesh.Position(indices[i + 1]),
+                                                     mesh.Position(indices[i + 2])));
+        }
+        deviation = std::max(deviation, nearest);
+    }
+    return deviation;
+}
+
+} // namespace
+
+TEST(MeshSimplifierCollapsesPlanesWithoutError) {
+    const Mesh grid = Grid(16);
+    std::vector<uint32_t> result(grid.IndexCount());
+    float error            = -1.0f;
+    const uint32_t reached = MeshSimplifier::Simplify(result.data(),
+                                                      grid.indices.data(),
+                                                      grid.IndexCount(),
+                                                      grid.positions.data(),
+                                                      grid.VertexCount(),
+                                                      3 * sizeof(float),
+                                                      grid.IndexCount() / 8,
+                                                      0.01f,
+                                                      &error);
+    CHECK(reached % 3 == 0);
+    CHECK(reached <= grid.IndexCount() / 4);
+    CHECK_NEAR(error, 0.0, 1e-5);
+
+    // Same area, same facing, no degenerate triangles: the outline only slid along itself
+    float facing[3];
+    Normal(grid, grid.indices.data(), facing);
+    double area   = 0.0;
+    bool sameSide = true;
+    bool distinct = true;
+    for (uint32_t i = 0; i < reached; i += 3) {
+        float normal[3];
+        Normal(grid, &result[i], normal);
+        area += 0.5 * std::fabs(normal[1]);
+        sameSide = sameSide && normal[1] * facing[1] > 0.0f;
+        distinct = distinct && result[i] != result[i + 1] && result[i + 1] != result[i + 2] &&
+                   result[i] != result[i + 2];
+    }
+    CHECK_NEAR(area, 4.0, 1e-4);
+    CHECK(sameSide);
+    CHECK(distinct);
+
+    // The result may be written over the input
+    std::vector<uint32_t> inPlace = grid.indices;
+    CHECK(MeshSimplifier::Simplify(inPlace.data(),
+                                   inPlace.data(),
+                                   grid.IndexCount(),
+                                   grid.positions.data(),
+                                   grid.VertexCount(),
+                                   3 * sizeof(float),
+                                   grid.IndexCount() / 8,
+                                   0.01f) == reached);
+    CHECK(std::equal(result.begin(), result.begin() + reached, inPlace.begin()));
+}
+
+TEST(MeshSimplifierNeverFlipsTriangles) {
+    const Mesh sphere = Sphere(48, 24);
+    std::vector<uint32_t> result(sphere.IndexCount());
+    const uint32_t reached = MeshSimplifier::Simplify(result.data(),
+                                                      sphere.indices.data(),
+                                                      sphere.IndexCount(),
+                                                      sphere.positions.data(),
+                                                      sphere.VertexCount(),
+                                                      3 * sizeof(float),
+                                                      sphere.IndexCount() / 4,
+                                                      1.0f);
+    CHECK(reached <= sphere.IndexCount() / 3);
+    bool outward = true;
+    for (uint32_t i = 0; i < reached; i += 3) {
+        float normal[3];
+        Normal(sphere, &result[i], normal);
+        const float* a        = sphere.Position(result[i]);
+        const float* b        = sphere.Position(result[i + 1]);
+        const float* c        = sphere.Position(result[i + 2]);
+        const float middle[3] = {a[0] + b[0] + c[0], a[1] + b[1] + c[1], a[2] + b[2] + c[2]};
+        outward               = outward && Dot(normal, middle) > -1e-6f; // Slivers are ~0
+    }
+    CHECK(outward);
+}
+
+TEST(MeshSimplifierReportsAnUpperBoundOnTheError) {
+    // Every input vertex lies within the reported error of the simplified surface, and a
+    // tight error bound stops the simplification early
+    const Mesh sphere = Sphere(32, 16);
+    std::vector<uint32_t> result(sphere.IndexCount());
+    const float bounds[] = {0.01f, 0.05f, 1.0f};
+    uint32_t previous    = sphere.IndexCount() + 1;
+    for (float bound : bounds) {
+        float error            = 0.0f;
+        const uint32_t reached = MeshSimplifier::Simplify(result.data(),
+                                                          sphere.indices.data(),
+                                                          sphere.IndexCount(),
+                                                          sphere.positions.data(),
+                                                          sphere.VertexCount(),
+                                                          3 * sizeof(float),
+                                                          sphere.IndexCount() / 10,
+                                                          bound,
+                                                          &error);
+        CHECK(reached < previous);
+        CHECK(error > 0.0f);
+        CHECK(MeasuredDeviation(sphere, result.data(), reached) <= error * 1.001f + 1e-6f);
+        previous = reached;
+    }
+    CHECK(previous <= sphere.IndexCount() / 10 + 3);
+}
+
+TEST(MeshSimplifierLocksAttributeSeams) {
+    const uint32_t cells = 16;
+    const Mesh grid      = Grid(cells, cells / 2);
+    std::vector<uint32_t> result(grid.IndexCount());
+    const uint32_t reached = MeshSimplifier::Simplify(result.data(),
+                                                      grid.indices.data(),
+                                                      grid.IndexCount(),
+                                                      grid.positions.data(),
+                                                      grid.VertexCount(),
+                                                      3 * sizeof(float),
+                                                      0,
+                                                      0.01f);
+    CHECK(reached < grid.IndexCount() / 4); // Both halves still simplify
+
+    // Both copies of every seam vertex are still used, on their own sides
+    std::vector<uint8_t> used(grid.VertexCount(), 0);
+    for (uint32_t i = 0; i < reached; ++i) {
+        used[result[i]] = 1;
+    }
+    bool seamKept = true;
+    for (uint32_t y = 0; y <= cells; ++y) {
+        seamKept = seamKept && used[y * (cells + 1) + cells / 2];
+        seamKept = seamKept && used[(cells + 1) * (cells + 1) + y];
+    }
+    CHECK(seamKept);
+}
+
+TEST(MeshSimplifierBuildsChainsInParallel) {
+    std::vector<Mesh> meshes;
+    for (uint32_t i = 0; i < 6; ++i) {
+        meshes.push_back(i % 2 ? Sphere(32 + 8 * i, 16 + 4 * i) : Grid(12 + 4 * i, 5));
+    }
+    std::vector<MeshSimplifier::Input> inputs;
+    for (const Mesh& mesh : meshes) {
+        inputs.push_back(mesh.Input());
+    }
+    const MeshSimplifier::ChainSettings settings = MeshSimplifier::DefaultChainSettings();
+    std::vector<MeshSimplifier::Chain> serial(meshes.size());
+    MeshSimplifier simplifier;
+    simplifier.BuildChains(serial.data(), inputs.data(), 6, settings);
+
+    for (size_t m = 0; m < meshes.size(); ++m) {
+        const MeshSimplifier::Chain& chain = serial[m];
+        REQUIRE(!chain.lods.empty());
+        CHECK(chain.lods.size() <= settings.maxLods);
+        CHECK(chain.lods[0].indexStart == 0);
+        CHECK(chain.lods[0].indexCount == meshes[m].IndexCount());
+        CHECK(chain.lods[0].error == 0.0f);
+        CHECK(std::equal(meshes[m].indices.begin(),
+                         meshes[m].indices.end(),
+                         chain.indices.begin()));
+        for (size_t level = 1; level < chain.lods.size(); ++level) {
+            const MeshSimplifier::Lod& lod = chain.lods[level];
+            CHECK(lod.indexCount < chain.lods[level - 1].indexCount);
+            CHECK(lod.indexCount / 3 >= settings.minTriangles);
+            CHECK(lod.error >= chain.lods[level - 1].error);
+            CHECK(lod.indexStart + lod.indexCount <= chain.indices.size());
+        }
+    }
+    CHECK(serial[1].lods.size() > 2);
+
+    JobSystem jobSystem;
+    jobSystem.Initialize();
+    simplifier.SetParallelFor(jobSystem.GetTaskExecutor());
+    std::vector<MeshSimplifier::Chain> parallel(meshes.size());
+    simplifier.BuildChains(parallel.data(), inputs.data(), 6, settings);
+    jobSystem.Shutdown();
+    for (size_t m = 0; m < meshes.size(); ++m) {
+        CHECK(parallel[m].indices == serial[m].indices);
+        CHECK(parallel[m].lods.size() == serial[m].lods.size());
+    }
+}
@@ -0,0 +1,322 @@
+#include "Test.h"
+#include "render/PipelineCache.h"
+#include "render/StateObjectCache.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Sizes of the D3D11 descriptors behind each kind
+const size_t DescSizes[PipelineCache::StateKindCount] = {264, 40, 52, 52};
+
+// A descriptor of size bytes derived from id, zero elsewhere like a cleared D3D11 desc
+std::vector<uint8_t> Desc(size_t size, uint32_t id) {
+    std::vector<uint8_t> desc(size, 0);
+    std::memcpy(desc.data(), &id, sizeof(id));
+    desc[size - 1] = static_cast<uint8_t>(id * 7 + 1); // Reaches into the tail word
+    return desc;
+}
+
+// Distinct fake object pointers; the caches only store them
+void* Object(uintptr_t id) {
+    return reinterpret_cast<void*>((id + 1) * 16);
+}
+
+// Creates a heap object per state so leaks and double releases show under ASan; a
+// descriptor starting with 0xFF fails to create
+class CountingFactory : public PipelineCache::StateFactory {
+  public:
+    uint32_t created[PipelineCache::StateKindCount]  = {};
+    uint32_t released[PipelineCache::StateKindCount] = {};
+
+    size_t GetDescSize(PipelineCache::StateKind kind) const override {
+        return DescSizes[kind];
+    }
+    void* Create(PipelineCache::StateKind kind, const void* desc) override {
+        if (*static_cast<const uint8_t*>(desc) == 0xFF) {
+            return nullptr;
+        }
+        ++created[kind];
+        return new uint32_t(kind);
+    }
+    void Release(PipelineCache::StateKind kind, void* object) override {
+        CHECK(*static_cast<uint32_t*>(object) == kind);
+        ++released[kind];
+        delete static_cast<uint32_t*>(object);
+    }
+};
+
+// Logs the state calls Bind makes, with the object each one binds
+class RecordingSink : public ContextSink {
+  public:
+    std::vector<std::string> calls;
+    void* lastSampler[StateCache::MaxPixelSlots] = {};
+    void* lastBlend                              = nullptr;
+
+    void SetInputLayout(void*) override {
+        calls.push_back("InputLayout");
+    }
+    void SetPrimitiveTopology(uint32_t) override {
+        calls.push_back("Topology");
+    }
+    void SetIndexBuffer(void*, uint32_t, uint32_t) override {}
+    void SetVertexBuffer(uint32_t, void*, uint32_t, uint32_t) override {}
+    void SetVertexShader(void*) override {
+        calls.push_back("VertexShader");
+    }
+    void SetPixelShader(void*) override {
+        calls.push_back("PixelShader");
+    }
+    void SetPixelShaderResource(uint32_t, void*) override {}
+    void SetPixelSampler(uint32_t slot, void* sampler) override {
+        calls.push_back("PixelSampler" + std::to_string(slot));
+        lastSampler[slot] = sampler;
+    }
+    void SetVertexConstantBuffer(uint32_t, void*, uint32_t, uint32_t) override {}
+    void SetRasterizerState(void*) override {
+        calls.push_back("Rasterizer");
+    }
+    void SetViewport(float, float, float, float) override {}
+    void SetDepthStencilState(void*, uint32_t) override {
+        calls.push_back("DepthStencil");
+    }
+    void SetBlendState(void* state, const float*, uint32_t) override {
+        calls.push_back("Blend");
+        lastBlend = state;
+    }
+    void SetRenderTarget(void*, void*) override {}
+    void Draw(uint32_t, uint32_t) override {}
+    void DrawIndexed(uint32_t, uint32_t, int32_t) override {}
+    void DrawInstanced(uint32_t, uint32_t, uint32_t, uint32_t) override {}
+    void DrawIndexedInstanced(uint32_t, uint32_t, uint32_t, int32_t, uint32_t) override {}
+};
+
+} // namespace
+
+// ========================================
+// STATE OBJECT CACHE
+// ========================================
+
+TEST(StateObjectCacheDeduplicatesIntoDenseHandles) {
+    // 13 bytes: a word and a partial tail, so the tail must take part in hash and compare
+    StateObjectCache cache(13, 64);
+    uint32_t creates = 0;
+    const StateObjectCache::CreateFunction create = [&creates](const void*) {
+        return Object(creates++);
+    };
+
+    for (uint32_t id = 0; id < 40; ++id) {
+        const std::vector<uint8_t> desc = Desc(13, id);
+        CHECK(cache.Find(desc.data()) == StateObjectCache::InvalidHandle);
+        CHECK(cache.Acquire(desc.data(), create) == id);
+    }
+    CHECK(creates == 40);
+    CHECK(cache.GetCount() == 40);
+    for (uint32_t id = 0; id < 40; ++id) {
+        const std::vector<uint8_t> desc = Desc(13, id);
+        CHECK(cache.Acquire(desc.data(), create) == id);
+        CHECK(cache.Find(desc.data()) == id);
+        CHECK(cache.GetObject(static_cast<uint16_t>(id)) == Object(id));
+        CHECK(std::memcmp(cache.GetDesc(static_cast<uint16_t>(id)), desc.data(), 13) == 0);
+    }
+    CHECK(creates == 40); // Hits create nothing
+
+    // Only the last byte differs
+    std::vector<uint8_t> tail = Desc(13, 3);
+    ++tail[12];
+    CHECK(cache.Find(tail.data()) == StateObjectCache::InvalidHandle);
+
+    // Entries without an object
+    const std::vector<uint8_t> bare = Desc(13, 100);
+    const uint16_t handle           = cache.Acquire(bare.data(), nullptr);
+    CHECK(handle == 40);
+    CHECK(cache.GetObject(handle) == nullptr);
+    CHECK(cache.GetStats().entries == 41);
+    CHECK(cache.GetStats().failures == 0);
+
+    cache.Clear();
+    CHECK(cache.GetCount() == 0);
+    CHECK(cache.Find(Desc(13, 0).data()) == StateObjectCache::InvalidHandle);
+    CHECK(cache.Acquire(Desc(13, 5).data(), create) == 0);
+}
+
+TEST(StateObjectCacheRefusesWhenFullOrCreationFails) {
+    StateObjectCache cache(40, 8);
+    const StateObjectCache::CreateFunction fail = [](const void*) -> void* { return nullptr; };
+    CHECK(cache.Acquire(Desc(40, 1).data(), fail) == StateObjectCache::InvalidHandle);
+    CHECK(cache.GetCount() == 0);
+    CHECK(cache.Find(Desc(40, 1).data()) == StateObjectCache::InvalidHandle);
+
+    // A failed creation leaves no entry, so a later attempt may succeed
+    const StateObjectCache::CreateFunction create = [](const void*) { return Object(0); };
+    CHECK(cache.Acquire(Desc(40, 1).data(), create) == 0);
+    for (uint32_t id = 2; id <= 8; ++id) {
+        CHECK(cache.Acquire(Desc(40, id).data(), create) == id - 1);
+    }
+    CHECK(cache.Acquire(Desc(40, 9).data(), create) == StateObjectCache::InvalidHandle);
+    CHECK(cache.Acquire(Desc(40, 8).data(), create) == 7); // Existing entries still hit
+    const StateObjectCache::Stats stats = cache.GetStats();
+    CHECK(stats.entries == 8);
+    CHECK(stats.failures == 2);
+
+    // Capacity is clamped to Direct3D 11's limit
+    StateObjectCache huge(4, 100000);
+    for (uint32_t id = 0; id < StateObjectCache::MaxCapacity; ++id) {
+        REQUIRE(huge.Acquire(&id, nullptr) == id);
+    }
+    const uint32_t over = StateObjectCache::MaxCapacity;
+    CHECK(huge.Acquire(&over, nullptr) == StateObjectCache::InvalidHandle);
+}
+
+TEST(StateObjectCacheConcurrentAcquiresAgree) {
+    // Every thread acquires the same descriptors in its own order while others insert
+    const uint32_t descCount   = 3000;
+    const uint32_t threadCount = 8;
+    StateObjectCache cache(52);
+    std::vector<std::vector<uint8_t>> descs;
+    for (uint32_t id = 0; id < descCount; ++id) {
+        descs.push_back(Desc(52, id));
+    }
+    std::vector<std::atomic<uint32_t>> creates(descCount);
+    for (std::atomic<uint32_t>& count : creates) {
+        count = 0;
+    }
+    const StateObjectCache::CreateFunction create = [&creates](const void* desc) {
+        uint32_t id;
+        std::memcpy(&id, desc, sizeof(id));
+        creates[id].fetch_add(1);
+        return Object(id);
+    };
+
+    std::vector<std::vector<uint16_t>> handles(threadCount,
+                                               std::vector<uint16_t>(descCount, 0));
+    std::atomic<uint32_t> wrongFinds{0};
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<uint32_t> order(descCount);
+            for (uint32_t i = 0; i < descCount; ++i) {
+                order[i] = i;
+            }
+            std::shuffle(order.begin(), order.end(), std::mt19937(t));
+            for (uint32_t id : order) {
+                // A lookup racing an insert finds nothing or the finished entry
+                const uint16_t found = cache.Find(descs[id].data());
+                if (found != StateObjectCache::InvalidHandle &&
+                    cache.GetObject(found) != Object(id)) {
+                    ++wrongFinds;
+                }
+                handles[t][id] = cache.Acquire(descs[id].data(), create);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(wrongFinds == 0);
+    CHECK(cache.GetCount() == descCount);
+    std::vector<uint8_t> seen(descCount, 0);
+    for (uint32_t id = 0; id < descCount; ++id) {
+        const uint16_t handle = handles[0][id];
+        REQUIRE(handle < descCount);
+        CHECK(creates[id] == 1);
+        CHECK(!seen[handle]);
+        seen[handle] = 1;
+        CHECK(cache.GetObject(handle) == Object(id));
+        for (uint32_t t = 1; t < threadCount; ++t) {
+            CHECK(handles[t][id] == handle);
+        }
+    }
+}
+
+// ========================================
+// PIPELINE CACHE
+// ========================================
+
+TEST(PipelineCacheCreatesOneObjectPerUniqueState) {
+    CountingFactory factory;
+    {
+        PipelineCache cache(factory);
+        for (uint32_t kind = 0; kind < PipelineCache::StateKindCount; ++kind) {
+            const PipelineCache::StateKind stateKind = static_cast<PipelineCache::StateKind>(kind);
+            const std::vector<uint8_t> a             = Desc(DescSizes[kind], 1);
+            const std::vector<uint8_t> b             = Desc(DescSizes[kind], 2);
+            const uint16_t handleA                   = cache.AcquireState(stateKind, a.data());
+            CHECK(handleA == 0);
+            CHECK(cache.AcquireState(stateKind, b.data()) == 1);
+            CHECK(cache.AcquireState(stateKind, a.data()) == handleA);
+            CHECK(cache.GetStateCount(stateKind) == 2);
+            CHECK(*static_cast<uint32_t*>(cache.GetStateObject(stateKind, handleA)) == kind);
+            CHECK(cache.GetStateObject(stateKind, PipelineCache::DefaultState) == nullptr);
+
+            // A failed creation falls back to the default state
+            std::vector<uint8_t> broken = Desc(DescSizes[kind], 3);
+            broken[0]                   = 0xFF;
+            CHECK(cache.AcquireState(stateKind, broken.data()) == PipelineCache::DefaultState);
+            CHECK(cache.GetStateCount(stateKind) == 2);
+        }
+
+        // Prewarm takes packed descriptors and skips the known ones
+        std::vector<uint8_t> packed;
+        for (uint32_t id = 1; id <= 5; ++id) {
+            const std::vector<uint8_t> desc = Desc(DescSizes[PipelineCache::Sampler], id);
+            packed.insert(packed.end(), desc.begin(), desc.end());
+        }
+        cache.Prewarm(PipelineCache::Sampler, packed.data(), 5);
+        CHECK(cache.GetStateCount(PipelineCache::Sampler) == 5);
+        CHECK(factory.created[PipelineCache::Sampler] == 5);
+        CHECK(factory.created[PipelineCache::Blend] == 2);
+    }
+    // Every object is released exactly once with the cache
+    for (uint32_t kind = 0; kind < PipelineCache::StateKindCount; ++kind) {
+        CHECK(factory.released[kind] == factory.created[kind]);
+    }
+}
+
+TEST(PipelineCacheBindsPipelinesThroughTheStateCache) {
+    CountingFactory factory;
+    PipelineCache cache(factory);
+    const std::vector<uint8_t> additive = Desc(DescSizes[PipelineCache::Blend], 1);
+    const std::vector<uint8_t> linear   = Desc(DescSizes[PipelineCache::Sampler], 1);
+
+    PipelineCache::PipelineDesc opaque;
+    opaque.inputLayout  = Object(1);
+    opaque.vertexShader = Object(2);
+    opaque.pixelShader  = Object(3);
+    opaque.topology     = 4;
+    opaque.samplers[0]  = cache.AcquireState(PipelineCache::Sampler, linear.data());
+    PipelineCache::PipelineDesc blended = opaque;
+    blended.blend = cache.AcquireState(PipelineCache::Blend, additive.data());
+
+    const uint16_t first  = cache.AcquirePipeline(opaque);
+    const uint16_t second = cache.AcquirePipeline(blended);
+    CHECK(first != PipelineCache::InvalidPipeline);
+    CHECK(second != first);
+    CHECK(cache.AcquirePipeline(opaque) == first);
+    CHECK(cache.GetPipelineCount() == 2);
+    CHECK(cache.GetPipeline(second).blend == blended.blend);
+    CHECK(std::memcmp(&cache.GetPipeline(first), &opaque, sizeof(opaque)) == 0);
+
+    RecordingSink sink;
+    StateCache state(sink);
+    cache.Bind(state, first);
+    // Topology, layout, shaders, 4 samplers, rasterizer, depth-stencil, blend
+    CHECK(sink.calls.size() == 11);
+    CHECK(sink.lastSampler[0] == cache.GetStateObject(PipelineCache::Sampler, opaque.samplers[0]));
+    CHECK(sink.lastSampler[1] == nullptr);
+    CHECK(sink.lastBlend == nullptr);
+
+    // The same pipeline again binds nothing; the blended one only changes blend
+    sink.calls.clear();
+    cache.Bind(state, first);
+    CHECK(sink.calls.empty());
+    cache.Bind(state, second);
+    CHECK(sink.calls == std::vector<std::string>{"Blend"});
+    CHECK(sink.lastBlend == cache.GetStateObject(PipelineCache::Blend, blended.blend));
+}
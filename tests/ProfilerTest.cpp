@@ -0,0 +1,192 @@
+#include "Test.h"
+#include "utils/Profiler.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// The profiler is a process-wide singleton, so every test uses its own event names and
+// inspects the exported trace rather than internal state
+std::string ExportTrace() {
+    const char* path = "ProfilerTest.json";
+    std::string text;
+    if (Profiler::Get().ExportChromeTrace(path)) {
+        FILE* file = std::fopen(path, "rb");
+        if (file) {
+            char buffer[65536];
+            size_t read = 0;
+            while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+                text.append(buffer, read);
+            }
+            std::fclose(file);
+        }
+        std::remove(path);
+    }
+    return text;
+}
+
+// Complete events named name in trace
+uint32_t CountEvents(const std::string& trace, const char* name) {
+    const std::string pattern = "{\"name\": \"" + std::string(name) + "\", \"ph\": \"X\"";
+    uint32_t count            = 0;
+    size_t at                 = trace.find(pattern);
+    while (at != std::string::npos) {
+        ++count;
+        at = trace.find(pattern, at + 1);
+    }
+    return count;
+}
+
+} // namespace
+
+TEST(ScopesRecordNestedIntervals) {
+    {
+        ProfileScope outer("ScopesOuter");
+        {
+            ProfileScope inner("ScopesInner");
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    const std::string trace = ExportTrace();
+    REQUIRE(!trace.empty());
+    CHECK(trace.compare(0, 1, "{") == 0);
+    CHECK(CountEvents(trace, "ScopesOuter") == 1);
+    CHECK(CountEvents(trace, "ScopesInner") == 1);
+
+    // The inner scope closes first, so it is recorded (and exported) before the outer one
+    CHECK(trace.find("\"ScopesInner\"") < trace.find("\"ScopesOuter\""));
+}
+
+TEST(ThreadsGetTheirOwnNamedRings) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t] {
+            const std::string name = "ProfilerTest Worker " + std::to_string(t);
+            Profiler::Get().SetThreadName(name.c_str());
+            for (int i = 0; i < 1000; ++i) {
+                ProfileScope scope("ThreadsEvent");
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    const std::string trace = ExportTrace();
+    CHECK(CountEvents(trace, "ThreadsEvent") == 4000);
+    for (int t = 0; t < 4; ++t) {
+        CHECK(trace.find("\"ProfilerTest Worker " + std::to_string(t) + "\"") !=
+              std::string::npos);
+    }
+}
+
+TEST(FullRingKeepsTheNewestEvents) {
+    // A fresh thread so the ring holds nothing else
+    std::thread writer([] {
+        for (uint32_t i = 0; i < Profiler::ThreadCapacity + 100; ++i) {
+            ProfileScope scope(i < 100 ? "OverwrittenEvent" : "KeptEvent");
+        }
+    });
+    writer.join();
+    const std::string trace = ExportTrace();
+    // The export cannot tell an idle full ring from one whose writer is refilling the
+    // oldest slot, so it always leaves that slot out
+    CHECK(CountEvents(trace, "OverwrittenEvent") == 0);
+    CHECK(CountEvents(trace, "KeptEvent") == Profiler::ThreadCapacity - 1);
+}
+
+TEST(ExportDuringRecordingDropsReusedSlots) {
+    // Every event lasts exactly 1000 ticks; a slot copied while its writer refills it would
+    // mix two events and show a different duration
+    std::atomic<bool> stop(false);
+    std::thread writer([&stop] {
+        const uint64_t base = Profiler::Now();
+        for (uint64_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+            Profiler::Get().Record("ReusedSlotEvent", base + i * 4000, base + i * 4000 + 1000, 0);
+        }
+    });
+    const std::string pattern = "{\"name\": \"ReusedSlotEvent\", \"ph\": \"X\"";
+    uint32_t mismatched       = 0;
+    uint32_t exported         = 0;
+    for (int round = 0; round < 20; ++round) {
+        const std::string trace = ExportTrace();
+        std::string expected;
+        for (size_t at = trace.find(pattern); at != std::string::npos;
+             at        = trace.find(pattern, at + 1)) {
+            size_t dur             = trace.find("\"dur\": ", at);
+            size_t comma           = trace.find(',', dur);
+            const std::string text = trace.substr(dur, comma - dur);
+            if (expected.empty()) {
+                expected = text;
+            }
+            mismatched += text != expected ? 1 : 0;
+            ++exported;
+        }
+    }
+    stop.store(true);
+    writer.join();
+    CHECK(exported > 0);
+    CHECK(mismatched == 0);
+}
+
+TEST(GpuFrameStatistics) {
+    // 1..100 ms: min 1, max 100, mean 50.5, and 99 % of the frames take at most 99 ms
+    for (int i = 1; i <= 100; ++i) {
+        Profiler::Get().AddGpuFrame(static_cast<float>(i));
+    }
+    Profiler::FrameStats stats = Profiler::Get().GetGpuFrameStats();
+    CHECK(stats.samples == 100);
+    CHECK_NEAR(stats.minMs, 1.0, 1e-4);
+    CHECK_NEAR(stats.maxMs, 100.0, 1e-4);
+    CHECK_NEAR(stats.avgMs, 50.5, 1e-3);
+    CHECK_NEAR(stats.p99Ms, 99.0, 1e-4);
+
+    // The history is a ring: older samples fall out
+    for (uint32_t i = 0; i < Profiler::FrameHistory; ++i) {
+        Profiler::Get().AddGpuFrame(5.0f);
+    }
+    stats = Profiler::Get().GetGpuFrameStats();
+    CHECK(stats.samples == Profiler::FrameHistory);
+    CHECK_NEAR(stats.minMs, 5.0, 1e-4);
+    CHECK_NEAR(stats.maxMs, 5.0, 1e-4);
+}
+
+TEST(EndFrameRollsCpuStatistics) {
+    const uint32_t firstFrame = Profiler::Get().GetFrameIndex();
+    Profiler::Get().EndFrame();
+    for (int frame = 0; frame < 5; ++frame) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        Profiler::Get().EndFrame();
+    }
+    CHECK(Profiler::Get().GetFrameIndex() == firstFrame + 6);
+
+    Profiler::FrameStats stats = Profiler::Get().GetCpuFrameStats();
+    CHECK(stats.samples >= 5);
+    CHECK(stats.minMs <= stats.avgMs);
+    CHECK(stats.avgMs <= stats.maxMs);
+    CHECK(stats.p99Ms <= stats.maxMs);
+    CHECK(stats.maxMs >= 2.0f);
+}
+
+TEST(TicksConvertToWallTime) {
+    const uint64_t start = Profiler::Now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const double milliseconds = Profiler::Get().ToNanoseconds(Profiler::Now() - start) / 1e6;
+    // Sleeps only ever overshoot; the upper bound just catches a wildly wrong calibration
+    CHECK(milliseconds >= 19.0);
+    CHECK(milliseconds < 500.0);
+
+    const uint64_t ticks = Profiler::Get().FromNanoseconds(1e6);
+    CHECK_NEAR(Profiler::Get().ToNanoseconds(ticks), 1e6, 1e3);
+}
+
+TEST(MacrosFollowProfilingEnabled) {
+    {
+        PROFILE_SCOPE("MacroScope");
+    }
+    const uint32_t expected = PROFILING_ENABLED ? 1 : 0;
+    CHECK(CountEvents(ExportTrace(), "MacroScope") == expected);
+}
@@ -0,0 +1,422 @@
+#include "Test.h"
+#include "render/RenderGraph.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+RenderTargetDesc Target(uint32_t width, uint32_t height, RenderTargetFormat format) {
+    RenderTargetDesc desc;
+    desc.width  = width;
+    desc.height = height;
+    desc.format = format;
+    return desc;
+}
+
+struct Access {
+    uint32_t pass;
+    uint32_t texture;
+    bool write;
+};
+
+/*
+Liveness straight from the definition, walking passes from the back: a pass survives if it
+has side effects, or writes a texture that a later surviving pass reads, or that is imported,
+before a surviving pass replaces it (writes without reading)
+*/
+std::vector<bool> ReferenceLive(uint32_t passCount,
+                                const std::vector<bool>& sideEffect,
+                                const std::vector<bool>& imported,
+                                const std::vector<Access>& accesses) {
+    auto uses = [&](uint32_t pass, uint32_t texture, bool write) {
+        for (const Access& access : accesses) {
+            if (access.pass == pass && access.texture == texture && access.write == write) {
+                return true;
+            }
+        }
+        return false;
+    };
+    std::vector<bool> live(passCount, false);
+    for (uint32_t p = passCount; p-- > 0;) {
+        live[p] = sideEffect[p];
+        for (const Access& access : accesses) {
+            if (access.pass != p || !access.write) {
+                continue;
+            }
+            bool consumed = imported[access.texture];
+            for (uint32_t q = p + 1; q < passCount; ++q) {
+                if (!live[q]) {
+                    continue;
+                }
+                if (uses(q, access.texture, false)) {
+                    consumed = true;
+                    break;
+                }
+                if (uses(q, access.texture, true)) {
+                    consumed = false;
+                    break;
+                }
+            }
+            live[p] = live[p] || consumed;
+        }
+    }
+    return live;
+}
+
+} // namespace
+
+// ========================================
+// TRANSIENT POOL
+// ========================================
+
+TEST(TransientPoolSizeClassesWasteAtMostAQuarter) {
+    const uint64_t unit = TransientPool::BlockAlign;
+    CHECK(TransientPool::SizeClass(0) == 0);
+    CHECK(TransientPool::SizeClass(1) == 0);
+    CHECK(TransientPool::SizeClass(unit) == 0);
+    CHECK(TransientPool::SizeClass(unit + 1) == 1);
+    CHECK(TransientPool::ClassSize(7) == 8 * unit);
+    CHECK(TransientPool::ClassSize(8) == 10 * unit);
+
+    std::mt19937 rng(23);
+    for (int i = 0; i < 20000; ++i) {
+        const uint64_t size      = 1 + rng() % (uint64_t(1) << (i % 33));
+        const uint32_t sizeClass = TransientPool::SizeClass(size);
+        const uint64_t classSize = TransientPool::ClassSize(sizeClass);
+        CHECK(classSize >= size);
+        CHECK(classSize % unit == 0);
+        // The class below would not fit, and past the linear classes the rounding stays
+        // within a quarter
+        if (sizeClass > 0) {
+            CHECK(TransientPool::ClassSize(sizeClass - 1) < size);
+        }
+        if (size > 8 * unit) {
+            CHECK(classSize - size < classSize / 4 + unit);
+        }
+    }
+    for (uint32_t sizeClass = 0; sizeClass < 100; ++sizeClass) {
+        CHECK(TransientPool::SizeClass(TransientPool::ClassSize(sizeClass)) == sizeClass);
+        CHECK(TransientPool::ClassSize(sizeClass + 1) > TransientPool::ClassSize(sizeClass));
+    }
+}
+
+TEST(TransientPoolReusesBlocksOfTheSameClassAndTrimsIdleOnes) {
+    const uint64_t unit = TransientPool::BlockAlign;
+    TransientPool pool;
+    pool.SetTrimFrames(3);
+    pool.BeginFrame();
+    const uint32_t a = pool.Acquire(3 * unit);
+    const uint32_t b = pool.Acquire(20 * unit);
+    CHECK(a != b);
+    CHECK(pool.GetBlockSize(a) == 3 * unit);
+    CHECK(pool.GetBlockSize(b) >= 20 * unit);
+    pool.Release(a);
+    CHECK(pool.Acquire(3 * unit - 100) == a); // Same class
+    const uint32_t c = pool.Acquire(2 * unit);
+    CHECK(c != a && c != b); // Another class: a new block, even with none free
+    pool.Release(a);
+    pool.Release(b);
+    pool.Release(c);
+
+    TransientPool::Stats stats = pool.GetStats();
+    CHECK(stats.blocks == 3);
+    CHECK(stats.acquires == 4);
+    CHECK(stats.reuses == 1);
+    CHECK(stats.bytes == 3 * unit + pool.GetBlockSize(b) + 2 * unit);
+
+    // Only a keeps being used; b and c go once idle for more than 3 frames
+    for (int frame = 0; frame < 4; ++frame) {
+        pool.BeginFrame();
+        CHECK(pool.Acquire(3 * unit) == a);
+        pool.Release(a);
+    }
+    stats = pool.GetStats();
+    CHECK(stats.blocks == 1);
+    CHECK(stats.blocksTrimmed == 2);
+    CHECK(stats.bytes == 3 * unit);
+    CHECK(pool.GetBlockSize(b) == 0);
+    CHECK(pool.GetBlockSize(c) == 0);
+
+    // Trimmed ids come back for new blocks
+    const uint32_t d = pool.Acquire(50 * unit);
+    CHECK(d == b || d == c);
+    CHECK(pool.GetBlockCount() == 3);
+    pool.Release(d);
+
+    pool.Clear();
+    CHECK(pool.GetBlockCount() == 0);
+    CHECK(pool.GetStats().bytes == 0);
+}
+
+// ========================================
+// RENDER GRAPH
+// ========================================
+
+TEST(RenderGraphCullsPassesWhoseResultsAreUnused) {
+    const RenderTargetDesc desc = Target(64, 64, RenderTargetFormat::RGBA8);
+    RenderGraph graph;
+    std::string ran;
+    auto record = [&ran](const char* tag) {
+        return [&ran, tag](const RenderGraph&) { ran += tag; };
+    };
+
+    graph.Reset();
+    const uint32_t backBuffer = graph.ImportTexture("back buffer", desc);
+    const uint32_t scene      = graph.CreateTexture("scene", desc);
+    const uint32_t debug      = graph.CreateTexture("debug", desc);
+    const uint32_t readback   = graph.CreateTexture("readback", desc);
+
+    const uint32_t overwritten = graph.AddPass("overwritten", record("o"));
+    graph.Write(overwritten, scene);
+    const uint32_t draw = graph.AddPass("draw", record("d"));
+    graph.Write(draw, scene);
+    const uint32_t unused = graph.AddPass("debug", record("x"));
+    graph.Read(unused, scene);
+    graph.Write(unused, debug);
+    const uint32_t overlay = graph.AddPass("overlay", record("v")); // Draws over the scene
+    graph.Read(overlay, scene);
+    graph.Write(overlay, scene);
+    const uint32_t query = graph.AddPass("query", record("q"));
+    graph.Read(query, scene);
+    graph.Write(query, readback);
+    graph.SetSideEffect(query);
+    const uint32_t present = graph.AddPass("present", record("p"));
+    graph.Read(present, scene);
+    graph.Write(present, backBuffer);
+
+    REQUIRE(graph.Compile());
+    CHECK(graph.IsPassCulled(overwritten));
+    CHECK(!graph.IsPassCulled(draw));
+    CHECK(graph.IsPassCulled(unused));
+    CHECK(!graph.IsPassCulled(overlay));
+    CHECK(!graph.IsPassCulled(query));
+    CHECK(!graph.IsPassCulled(present));
+    const std::vector<uint32_t> expected = {draw, overlay, query, present};
+    CHECK(graph.GetOrder() == expected);
+    graph.Execute();
+    CHECK(ran == "dvqp");
+
+    const RenderGraph::Stats stats = graph.GetStats();
+    CHECK(stats.passes == 6);
+    CHECK(stats.culledPasses == 2);
+    CHECK(stats.transients == 2); // debug belongs to a culled pass
+    CHECK(graph.GetBlock(debug) == TransientPool::InvalidBlock);
+    CHECK(graph.GetFirstUse(debug) == RenderGraph::InvalidResource);
+    CHECK(graph.GetBlock(backBuffer) == TransientPool::InvalidBlock);
+    CHECK(graph.GetFirstUse(scene) == 0);
+    CHECK(graph.GetLastUse(scene) == 3);
+    CHECK(graph.GetFirstUse(backBuffer) == 3);
+
+    // Without the presenting pass nothing reaches the output but the query
+    graph.Reset();
+    const uint32_t lonely = graph.CreateTexture("scene", desc);
+    graph.Write(graph.AddPass("draw", nullptr), lonely);
+    REQUIRE(graph.Compile());
+    CHECK(graph.GetOrder().empty());
+    CHECK(graph.GetStats().culledPasses == 1);
+    graph.Execute();
+}
+
+TEST(RenderGraphRejectsInvalidGraphs) {
+    const RenderTargetDesc desc = Target(64, 64, RenderTargetFormat::RGBA8);
+    RenderGraph graph;
+
+    // A transient texture read before anything wrote it
+    const uint32_t output = graph.ImportTexture("output", desc);
+    const uint32_t empty  = graph.CreateTexture("empty", desc);
+    const uint32_t pass   = graph.AddPass("pass", nullptr);
+    graph.Read(pass, empty);
+    graph.Write(pass, output);
+    CHECK(!graph.Compile());
+
+    // Imported textures have contents from the start
+    graph.Reset();
+    const uint32_t history = graph.ImportTexture("history", desc);
+    const uint32_t resolve = graph.ImportTexture("resolve", desc);
+    const uint32_t taa     = graph.AddPass("taa", nullptr);
+    graph.Read(taa, history);
+    graph.Write(taa, resolve);
+    CHECK(graph.Compile());
+
+    // Out-of-range ids
+    graph.Reset();
+    graph.Write(graph.AddPass("pass", nullptr), 5);
+    CHECK(!graph.Compile());
+    graph.Reset();
+    graph.Write(3, graph.ImportTexture("output", desc));
+    CHECK(!graph.Compile());
+}
+
+TEST(RenderGraphAliasesTexturesWithDisjointLifetimes) {
+    const RenderTargetDesc full = Target(1920, 1080, RenderTargetFormat::RGBA16F);
+    const RenderTargetDesc half = Target(960, 540, RenderTargetFormat::RGBA16F);
+    RenderGraph graph;
+    uint32_t a = 0;
+    uint32_t b = 0;
+    uint32_t c = 0;
+    uint32_t d = 0;
+    auto declare = [&] {
+        graph.Reset();
+        const uint32_t output = graph.ImportTexture("output", full);
+        a                     = graph.CreateTexture("a", full);
+        b                     = graph.CreateTexture("b", full);
+        c                     = graph.CreateTexture("c", full);
+        d                     = graph.CreateTexture("d", half);
+        const uint32_t p0     = graph.AddPass("p0", nullptr);
+        graph.Write(p0, a);
+        const uint32_t p1 = graph.AddPass("p1", nullptr);
+        graph.Read(p1, a);
+        graph.Write(p1, b);
+        graph.Write(p1, d);
+        const uint32_t p2 = graph.AddPass("p2", nullptr);
+        graph.Read(p2, b);
+        graph.Read(p2, d);
+        graph.Write(p2, c);
+        const uint32_t p3 = graph.AddPass("p3", nullptr);
+        graph.Read(p3, c);
+        graph.Write(p3, output);
+    };
+
+    declare();
+    REQUIRE(graph.Compile());
+    // a: 0-1, b: 1-2, c: 2-3, d: 1-2. Neighbours overlap at the pass between them; a and c
+    // do not, and a pass never gets one block for two of its textures
+    CHECK(graph.GetBlock(a) == graph.GetBlock(c));
+    CHECK(graph.GetBlock(a) != graph.GetBlock(b));
+    CHECK(graph.GetBlock(b) != graph.GetBlock(c));
+    CHECK(graph.GetBlock(d) != graph.GetBlock(a) && graph.GetBlock(d) != graph.GetBlock(b));
+
+    const RenderGraph::Stats stats = graph.GetStats();
+    const uint64_t fullBytes       = full.Bytes();
+    CHECK(fullBytes == 1920ull * 1080 * 8);
+    CHECK(stats.transients == 4);
+    CHECK(stats.unaliasedBytes == 3 * fullBytes + half.Bytes());
+    CHECK(stats.peakLiveBytes == 2 * fullBytes + half.Bytes());
+    CHECK(stats.blocks == 3);
+    const uint64_t fullBlock = TransientPool::ClassSize(TransientPool::SizeClass(fullBytes));
+    const uint64_t halfBlock = TransientPool::ClassSize(TransientPool::SizeClass(half.Bytes()));
+    CHECK(stats.aliasedBytes == 2 * fullBlock + halfBlock);
+
+    // The next frame takes the same blocks without creating any
+    const uint64_t created = graph.GetPool().GetStats().blocksCreated;
+    declare();
+    REQUIRE(graph.Compile());
+    CHECK(graph.GetPool().GetStats().blocksCreated == created);
+    CHECK(graph.GetStats().aliasedBytes == stats.aliasedBytes);
+
+    RenderTargetDesc mips = Target(256, 128, RenderTargetFormat::RGBA8);
+    mips.mipCount         = 3;
+    mips.sampleCount      = 2;
+    CHECK(mips.Bytes() == (256ull * 128 + 128 * 64 + 64 * 32) * 2 * 4);
+    CHECK(RenderTargetBytesPerPixel(RenderTargetFormat::D24S8) == 4);
+}
+
+TEST(RenderGraphRandomGraphsNeverShareLiveMemory) {
+    std::mt19937 rng(2023);
+    const RenderTargetFormat formats[] = {RenderTargetFormat::RGBA8,
+                                          RenderTargetFormat::RGBA16F,
+                                          RenderTargetFormat::R32F};
+    RenderGraph graph; // Reused, so the pool carries blocks across graphs
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+        const uint32_t textureCount = 1 + rng() % 12;
+        const uint32_t passCount    = 1 + rng() % 16;
+        std::vector<bool> imported(textureCount);
+        std::vector<bool> sideEffect(passCount);
+        std::vector<bool> written(textureCount, false);
+        std::vector<Access> accesses;
+
+        graph.Reset();
+        for (uint32_t t = 0; t < textureCount; ++t) {
+            const uint32_t size         = 16u << (rng() % 6);
+            const RenderTargetDesc desc = Target(size, size, formats[rng() % 3]);
+            imported[t]                 = rng() % 5 == 0;
+            if (imported[t]) {
+                graph.ImportTexture("imported", desc);
+            } else {
+                graph.CreateTexture("transient", desc);
+            }
+        }
+        // Reads only of textures with contents, so every graph compiles
+        for (uint32_t p = 0; p < passCount; ++p) {
+            graph.AddPass("pass", nullptr);
+            sideEffect[p] = rng() % 10 == 0;
+            if (sideEffect[p]) {
+                graph.SetSideEffect(p);
+            }
+            const uint32_t useCount = rng() % 4;
+            std::vector<uint32_t> writes;
+            for (uint32_t u = 0; u < useCount; ++u) {
+                const uint32_t t = rng() % textureCount;
+                if ((imported[t] || written[t]) && rng() % 2 == 0) {
+                    graph.Read(p, t);
+                    accesses.push_back({p, t, false});
+                } else {
+                    graph.Write(p, t);
+                    accesses.push_back({p, t, true});
+                    writes.push_back(t);
+                }
+            }
+            for (uint32_t t : writes) {
+                written[t] = true;
+            }
+        }
+        REQUIRE(graph.Compile());
+
+        const std::vector<bool> live = ReferenceLive(passCount, sideEffect, imported, accesses);
+        std::vector<uint32_t> order;
+        for (uint32_t p = 0; p < passCount; ++p) {
+            CHECK(graph.IsPassCulled(p) == !live[p]);
+            if (live[p]) {
+                order.push_back(p);
+            }
+        }
+        REQUIRE(graph.GetOrder() == order);
+
+        // Lifetimes cover exactly the surviving passes that use the texture
+        uint64_t unaliased = 0;
+        for (uint32_t t = 0; t < textureCount; ++t) {
+            uint32_t first = RenderGraph::InvalidResource;
+            uint32_t last  = RenderGraph::InvalidResource;
+            for (uint32_t position = 0; position < order.size(); ++position) {
+                for (const Access& access : accesses) {
+                    if (access.pass == order[position] && access.texture == t) {
+                        first = std::min(first, position);
+                        last  = position;
+                    }
+                }
+            }
+            CHECK(graph.GetFirstUse(t) == first);
+            CHECK(graph.GetLastUse(t) == last);
+            const bool placed = !imported[t] && first != RenderGraph::InvalidResource;
+            CHECK((graph.GetBlock(t) != TransientPool::InvalidBlock) == placed);
+            if (placed) {
+                const uint64_t bytes = graph.GetDesc(t).Bytes();
+                unaliased += bytes;
+                CHECK(graph.GetPool().GetBlockSize(graph.GetBlock(t)) >= bytes);
+            }
+        }
+
+        // Textures sharing a block have disjoint lifetimes and the same size class
+        for (uint32_t t = 0; t < textureCount; ++t) {
+            for (uint32_t u = t + 1; u < textureCount; ++u) {
+                const uint32_t block = graph.GetBlock(t);
+                if (block == TransientPool::InvalidBlock || block != graph.GetBlock(u)) {
+                    continue;
+                }
+                CHECK(graph.GetLastUse(t) < graph.GetFirstUse(u) ||
+                      graph.GetLastUse(u) < graph.GetFirstUse(t));
+                CHECK(TransientPool::SizeClass(graph.GetDesc(t).Bytes()) ==
+                      TransientPool::SizeClass(graph.GetDesc(u).Bytes()));
+            }
+        }
+
+        const RenderGraph::Stats stats = graph.GetStats();
+        CHECK(stats.culledPasses == passCount - order.size());
+        CHECK(stats.unaliasedBytes == unaliased);
+        CHECK(stats.peakLiveBytes <= unaliased);
+        CHECK(stats.peakLiveBytes <= stats.aliasedBytes);
+        CHECK(stats.blocks <= stats.transients);
+    }
+}
@@ -0,0 +1,230 @@
+#include "Test.h"
+#include "render/RenderQueue.h"
+#include "threading/JobSystem.h"
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Records every call so replays can be compared call for call
+class RecordingDispatcher : public RenderQueue::Dispatcher {
+  public:
+    std::vector<uint64_t> calls; // Tag in the top byte, argument below
+    std::vector<uint32_t> draws; // DrawPacket::constants of each draw, in order
+
+    void BindShader(uint32_t shader) override {
+        calls.push_back((1ull << 56) | shader);
+    }
+    void BindMaterial(uint32_t material) override {
+        calls.push_back((2ull << 56) | material);
+    }
+    void BindGeometry(uint32_t geometry, uint32_t vertexOffset) override {
+        calls.push_back((3ull << 56) | (static_cast<uint64_t>(geometry) << 24) | vertexOffset);
+    }
+    void Draw(const DrawPacket& packet) override {
+        calls.push_back((4ull << 56) | packet.constants);
+        draws.push_back(packet.constants);
+    }
+};
+
+// Few distinct keys so equal keys are common and stability is actually exercised;
+// constants carries the submission index
+std::vector<DrawPacket> MakePackets(uint32_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<DrawPacket> packets(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        DrawPacket& packet   = packets[i];
+        packet               = {};
+        packet.sortKey       = SortKey::Make(rng() % 3, rng() % 8, rng() % 16, rng() % 64);
+        packet.geometry      = rng() % 4;
+        packet.vertexOffset  = (rng() % 2) * 256;
+        packet.vertexCount   = 3;
+        packet.instanceCount = 1;
+        packet.constants     = i;
+    }
+    return packets;
+}
+
+// Submission indices in the order a stable sort by key produces
+std::vector<uint32_t> ReferenceOrder(const std::vector<DrawPacket>& packets) {
+    std::vector<DrawPacket> sorted = packets;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const DrawPacket& a, const DrawPacket& b) {
+        return a.sortKey < b.sortKey;
+    });
+    std::vector<uint32_t> order;
+    for (const DrawPacket& packet : sorted) {
+        order.push_back(packet.constants);
+    }
+    return order;
+}
+
+void Fill(RenderQueue& queue, const std::vector<DrawPacket>& packets) {
+    queue.Reserve(static_cast<uint32_t>(packets.size()));
+    queue.Reset();
+    for (const DrawPacket& packet : packets) {
+        queue.Submit(packet);
+    }
+}
+
+} // namespace
+
+TEST(SortMatchesStableSort) {
+    // Below and above the two-chunk threshold where the sort switches to chunked passes
+    for (uint32_t count : {1u, 100u, 5000u, 40000u}) {
+        std::vector<DrawPacket> packets = MakePackets(count, count);
+        RenderQueue queue;
+        Fill(queue, packets);
+        queue.Sort();
+
+        RecordingDispatcher dispatcher;
+        queue.Execute(dispatcher);
+        CHECK(dispatcher.draws == ReferenceOrder(packets));
+        CHECK(queue.GetStats().packets == count);
+    }
+}
+
+TEST(ParallelSortMatchesSerialSort) {
+    std::vector<DrawPacket> packets = MakePackets(100000, 7);
+
+    RenderQueue serial;
+    Fill(serial, packets);
+    serial.Sort();
+    RecordingDispatcher expected;
+    serial.Execute(expected);
+
+    JobSystem jobSystem;
+    REQUIRE(jobSystem.Initialize(4));
+    RenderQueue parallel;
+    parallel.SetParallelFor(jobSystem.GetTaskExecutor());
+    Fill(parallel, packets);
+    parallel.Sort();
+    RecordingDispatcher actual;
+    parallel.Execute(actual);
+    jobSystem.Shutdown();
+
+    CHECK(actual.calls == expected.calls);
+    CHECK(actual.draws == ReferenceOrder(packets));
+}
+
+TEST(UniformKeyBytesAreSkipped) {
+    // Only the depth field varies: its three bytes need passes, the other five do not
+    std::vector<DrawPacket> packets = MakePackets(1000, 3);
+    for (DrawPacket& packet : packets) {
+        packet.sortKey = SortKey::Make(1, 2, 3, SortKey::Depth(packet.sortKey) * 0x10101);
+    }
+    RenderQueue queue;
+    Fill(queue, packets);
+    queue.Sort();
+    CHECK(queue.GetStats().radixPasses == 3);
+
+    RecordingDispatcher dispatcher;
+    queue.Execute(dispatcher);
+    CHECK(dispatcher.draws == ReferenceOrder(packets));
+}
+
+TEST(RedundantBindsAreRemoved) {
+    RenderQueue queue;
+    queue.Reserve(4);
+    queue.Reset();
+    DrawPacket packet    = {};
+    packet.vertexCount   = 3;
+    packet.instanceCount = 1;
+    // Two draws with identical state, then a material change, then a geometry change
+    packet.sortKey = SortKey::Make(0, 1, 1, 0, 0);
+    queue.Submit(packet);
+    packet.sortKey = SortKey::Make(0, 1, 1, 0, 1);
+    queue.Submit(packet);
+    packet.sortKey = SortKey::Make(0, 1, 2, 0, 2);
+    queue.Submit(packet);
+    packet.sortKey      = SortKey::Make(0, 1, 2, 0, 3);
+    packet.vertexOffset = 64;
+    queue.Submit(packet);
+    queue.Sort();
+
+    RecordingDispatcher dispatcher;
+    queue.Execute(dispatcher);
+    const RenderQueue::Stats& stats = queue.GetStats();
+    CHECK(stats.shaderChanges == 1);
+    CHECK(stats.materialChanges == 2);
+    CHECK(stats.geometryChanges == 2);
+    CHECK(dispatcher.calls.size() == 4 + 1 + 2 + 2);
+}
+
+TEST(ExecuteRangesConcatenateToExecute) {
+    std::vector<DrawPacket> packets = MakePackets(3000, 11);
+    RenderQueue queue;
+    Fill(queue, packets);
+    queue.Sort();
+
+    RecordingDispatcher whole;
+    queue.Execute(whole);
+
+    RecordingDispatcher pieces;
+    RenderQueue::Stats total;
+    const uint32_t splits[] = {0, 1, 977, 2048, 3000, 5000}; // 5000 clamps to the packet count
+    for (uint32_t i = 0; i + 1 < 6; ++i) {
+        RenderQueue::Stats part = queue.ExecuteRange(pieces, splits[i], splits[i + 1]);
+        total.shaderChanges += part.shaderChanges;
+        total.materialChanges += part.materialChanges;
+        total.geometryChanges += part.geometryChanges;
+    }
+    CHECK(pieces.draws == whole.draws);
+
+    // Every range restarts its binds, so the pieces re-bind at least as often
+    const RenderQueue::Stats& stats = queue.GetStats();
+    CHECK(total.shaderChanges >= stats.shaderChanges);
+    CHECK(total.materialChanges >= stats.materialChanges);
+    CHECK(total.geometryChanges >= stats.geometryChanges);
+}
+
+TEST(SubmitFailsBeyondTheReservedCapacity) {
+    RenderQueue queue;
+    queue.Reserve(2);
+    queue.Reset();
+    DrawPacket packet = {};
+    CHECK(queue.Submit(packet));
+    CHECK(queue.Submit(packet));
+    CHECK(!queue.Submit(packet));
+    CHECK(queue.GetPacketCount() == 2);
+
+    queue.Reset();
+    CHECK(queue.GetPacketCount() == 0);
+    CHECK(queue.Submit(packet));
+}
+
+TEST(ConcurrentSubmitKeepsEveryPacket) {
+    const uint32_t threadCount = 4;
+    const uint32_t perThread   = 10000;
+    RenderQueue queue;
+    queue.Reserve(threadCount * perThread);
+    queue.Reset();
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&queue, t] {
+            for (uint32_t i = 0; i < perThread; ++i) {
+                DrawPacket packet = {};
+                packet.sortKey    = SortKey::Make(0, 0, 0, i % 1000);
+                packet.constants  = t * perThread + i;
+                queue.Submit(packet);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(queue.GetPacketCount() == threadCount * perThread);
+
+    queue.Sort();
+    RecordingDispatcher dispatcher;
+    queue.Execute(dispatcher);
+    std::vector<uint32_t> seen = dispatcher.draws;
+    std::sort(seen.begin(), seen.end());
+    bool complete = true;
+    for (uint32_t i = 0; i < seen.size(); ++i) {
+        complete = complete && seen[i] == i;
+    }
+    CHECK(complete);
+}
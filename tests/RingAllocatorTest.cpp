@@ -0,0 +1,200 @@
+#include "Test.h"
+#include "memory/RingAllocator.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(AllocationsAreAlignedAndInsideTheRegion) {
+    std::vector<uint8_t> memory(4096);
+    RingAllocator ring;
+    ring.Initialize(memory.size(), memory.data());
+
+    const uint64_t alignments[] = {1, 4, 16, 256};
+    for (int i = 0; i < 8; ++i) {
+        uint64_t alignment                   = alignments[i % 4];
+        RingAllocator::Allocation allocation = ring.Allocate(100, alignment);
+        REQUIRE(allocation.IsValid());
+        CHECK(allocation.offset % alignment == 0);
+        CHECK(allocation.offset + 100 <= memory.size());
+        CHECK(allocation.cpuPtr == memory.data() + allocation.offset);
+    }
+    CHECK(ring.GetStats().allocations == 8);
+}
+
+TEST(RejectsInvalidRequests) {
+    std::vector<uint8_t> memory(256);
+    RingAllocator ring;
+    ring.Initialize(memory.size(), memory.data());
+
+    CHECK(!ring.Allocate(0, 16).IsValid());
+    CHECK(!ring.Allocate(257, 16).IsValid());
+    ring.SetCpuBase(nullptr);
+    CHECK(!ring.Allocate(16, 16).IsValid());
+    CHECK(ring.GetStats().failedAllocations == 3);
+}
+
+TEST(FullRingFailsUntilTheOldestFrameRetires) {
+    std::vector<uint8_t> memory(1024);
+    RingAllocator ring;
+    ring.Initialize(memory.size(), memory.data());
+
+    // Frame 1 takes half the ring, frame 2 the other half
+    CHECK(ring.Allocate(512, 16).IsValid());
+    CHECK(ring.EndFrame(1));
+    ring.BeginFrame();
+    CHECK(ring.Allocate(512, 16).IsValid());
+    CHECK(ring.EndFrame(2));
+    CHECK(ring.GetPendingFrames() == 2);
+
+    // Nothing fits while both frames are in flight
+    ring.BeginFrame();
+    CHECK(!ring.Allocate(16, 16).IsValid());
+    CHECK(ring.GetStats().failedAllocations == 1);
+
+    // Fence 1 frees exactly frame 1's half
+    ring.Retire(1);
+    CHECK(ring.GetPendingFrames() == 1);
+    CHECK(ring.GetBytesInUse() == 512);
+    RingAllocator::Allocation allocation = ring.Allocate(512, 16);
+    REQUIRE(allocation.IsValid());
+    CHECK(allocation.offset == 0);
+    CHECK(!ring.Allocate(16, 16).IsValid());
+
+    // Retiring a fence twice, or an old fence, changes nothing
+    ring.Retire(1);
+    CHECK(ring.GetPendingFrames() == 1);
+    ring.Retire(2);
+    CHECK(ring.GetPendingFrames() == 0);
+}
+
+TEST(WrapAroundCountsTheSkippedTailAsPadding) {
+    std::vector<uint8_t> memory(1000);
+    RingAllocator ring;
+    ring.Initialize(memory.size(), memory.data());
+
+    CHECK(ring.Allocate(600, 8).IsValid());
+    ring.EndFrame(1);
+    ring.Retire(1);
+    ring.BeginFrame();
+
+    // 600 + 500 does not fit before the end: the allocation restarts at 0, 400 bytes skipped
+    RingAllocator::Allocation allocation = ring.Allocate(500, 8);
+    REQUIRE(allocation.IsValid());
+    CHECK(allocation.offset == 0);
+    CHECK(ring.GetStats().bytesPadding == 400);
+    CHECK(ring.GetBytesInUse() == 900);
+}
+
+TEST(RetiredSpaceIsReusedAcrossManyFrames) {
+    std::vector<uint8_t> memory(64 * 1024);
+    RingAllocator ring;
+    ring.Initialize(memory.size(), memory.data());
+
+    // Three frames in flight, each writing a recognizable pattern that must survive until
+    // its fence retires
+    const uint32_t framesInFlight = 3;
+    struct Written {
+        uint64_t fence;
+        uint8_t* data;
+        uint32_t size;
+        uint8_t value;
+    };
+    std::vector<Written> live;
+    for (uint64_t frame = 1; frame <= 500; ++frame) {
+        if (frame > framesInFlight) {
+            uint64_t completed = frame - framesInFlight;
+            for (const Written& written : live) {
+                if (written.fence == completed) {
+                    for (uint32_t i = 0; i < written.size; ++i) {
+                        REQUIRE(written.data[i] == written.value);
+                    }
+                }
+            }
+            live.erase(std::remove_if(live.begin(),
+                                      live.end(),
+                                      [&](const Written& w) { return w.fence <= completed; }),
+                       live.end());
+            ring.Retire(completed);
+        }
+        ring.BeginFrame();
+        for (uint32_t n = 0; n < 20; ++n) {
+            uint32_t size                        = 64 + (frame * 7 + n * 13) % 700;
+            RingAllocator::Allocation allocation = ring.Allocate(size, 16);
+            REQUIRE(allocation.IsValid());
+            uint8_t value = static_cast<uint8_t>(frame + n);
+            std::fill_n(static_cast<uint8_t*>(allocation.cpuPtr), size, value);
+            live.push_back({frame, static_cast<uint8_t*>(allocation.cpuPtr), size, value});
+        }
+        CHECK(ring.EndFrame(frame));
+        CHECK(ring.GetPendingFrames() <= framesInFlight);
+    }
+}
+
+#ifdef NDEBUG
+// Debug builds assert instead; the release fallback must hold memory, never free it early
+TEST(FullPendingListNeverReleasesAFrameEarly) {
+    std::vector<uint8_t> memory(4096);
+    RingAllocator ring;
+    ring.Initialize(memory.size(), memory.data());
+
+    for (uint64_t fence = 1; fence <= RingAllocator::MaxFramesInFlight; ++fence) {
+        ring.Allocate(100, 4);
+        CHECK(ring.EndFrame(fence));
+    }
+    ring.Allocate(100, 4);
+    CHECK(!ring.EndFrame(RingAllocator::MaxFramesInFlight + 1));
+    CHECK(ring.GetBytesInUse() == 900);
+
+    // The extra frame was folded into the newest one: it is freed with the last fence only
+    ring.Retire(RingAllocator::MaxFramesInFlight - 1);
+    CHECK(ring.GetBytesInUse() == 200);
+    ring.Retire(RingAllocator::MaxFramesInFlight);
+    CHECK(ring.GetBytesInUse() == 200);
+    ring.Retire(RingAllocator::MaxFramesInFlight + 1);
+    CHECK(ring.GetBytesInUse() == 0);
+}
+#endif
+
+TEST(ConcurrentAllocationsNeverOverlap) {
+    const uint32_t threadCount = 4;
+    const uint32_t perThread   = 2000;
+    std::vector<uint8_t> memory(threadCount * perThread * 64);
+    RingAllocator ring;
+    ring.Initialize(memory.size(), memory.data());
+
+    // Every thread stamps its bytes with its own id; any overlap shows up as a foreign id
+    std::vector<std::vector<RingAllocator::Allocation>> results(threadCount);
+    std::vector<std::thread> threads;
+    std::atomic<bool> go{false};
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            while (!go.load()) {
+            }
+            for (uint32_t i = 0; i < perThread; ++i) {
+                RingAllocator::Allocation allocation = ring.Allocate(24 + (i % 3) * 8, 16);
+                if (allocation.IsValid()) {
+                    std::fill_n(static_cast<uint8_t*>(allocation.cpuPtr), 24, uint8_t(t + 1));
+                    results[t].push_back(allocation);
+                }
+            }
+        });
+    }
+    go.store(true);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    uint64_t total = 0;
+    for (uint32_t t = 0; t < threadCount; ++t) {
+        total += results[t].size();
+        for (const RingAllocator::Allocation& allocation : results[t]) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(allocation.cpuPtr);
+            for (int i = 0; i < 24; ++i) {
+                REQUIRE(bytes[i] == t + 1);
+            }
+        }
+    }
+    CHECK(total == uint64_t(threadCount) * perThread);
+    CHECK(ring.GetStats().allocations == total);
+}
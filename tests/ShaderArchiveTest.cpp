@@ -0,0 +1,174 @@
+#include "Test.h"
+#include "render/ShaderArchive.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::vector<uint8_t> Blob(uint32_t size, uint8_t seed) {
+    std::vector<uint8_t> bytes(size);
+    for (uint32_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<uint8_t>(seed + i * 7);
+    }
+    return bytes;
+}
+
+// Entries deliberately added out of name order; BasicVS and CopyVS share their bytecode
+std::vector<uint8_t> BuildSample() {
+    ShaderArchiveWriter writer;
+    const std::vector<uint8_t> vertex = Blob(300, 1);
+    const std::vector<uint8_t> pixel  = Blob(123, 2);
+    const std::vector<uint8_t> sprite = Blob(64, 3);
+    writer.Add("SpritePS", ShaderStage::Pixel, sprite.data(), sprite.size());
+    writer.Add("BasicVS", ShaderStage::Vertex, vertex.data(), vertex.size());
+    writer.Add("BasicPS", ShaderStage::Pixel, pixel.data(), pixel.size());
+    writer.Add("CopyVS", ShaderStage::Vertex, vertex.data(), vertex.size());
+    return writer.Build();
+}
+
+} // namespace
+
+TEST(StageFollowsTheNameSuffix) {
+    ShaderStage stage = ShaderStage::Count;
+    CHECK(ShaderStageFromName("BasicVS", stage) && stage == ShaderStage::Vertex);
+    CHECK(ShaderStageFromName("SpritePS", stage) && stage == ShaderStage::Pixel);
+    CHECK(ShaderStageFromName("CullCS", stage) && stage == ShaderStage::Compute);
+    CHECK(!ShaderStageFromName("Basic", stage));
+    CHECK(!ShaderStageFromName("S", stage));
+    CHECK(std::strcmp(ShaderStageSuffix(ShaderStage::Hull), "HS") == 0);
+    CHECK(std::strcmp(ShaderStageSuffix(ShaderStage::Count), "??") == 0);
+}
+
+TEST(WriterRejectsInvalidEntries) {
+    ShaderArchiveWriter writer;
+    const std::vector<uint8_t> blob = Blob(16, 0);
+    CHECK(writer.Add("BasicVS", ShaderStage::Vertex, blob.data(), blob.size()));
+    CHECK(!writer.Add("BasicVS", ShaderStage::Vertex, blob.data(), blob.size()));
+    CHECK(!writer.Add("EmptyPS", ShaderStage::Pixel, blob.data(), 0));
+    const std::string longName(ShaderArchive::MaxNameLen + 1, 'A');
+    CHECK(!writer.Add(longName, ShaderStage::Pixel, blob.data(), blob.size()));
+    const std::string longestName(ShaderArchive::MaxNameLen, 'A');
+    CHECK(writer.Add(longestName, ShaderStage::Pixel, blob.data(), blob.size()));
+}
+
+TEST(RoundTripThroughMemory) {
+    const std::vector<uint8_t> bytes = BuildSample();
+    ShaderArchive archive;
+    REQUIRE(archive.Load(bytes.data(), bytes.size()));
+    CHECK(archive.GetEntryCount() == 4);
+    CHECK(archive.Verify());
+
+    // The index is sorted by name, whatever the insertion order
+    const char* const names[] = {"BasicPS", "BasicVS", "CopyVS", "SpritePS"};
+    for (uint32_t i = 0; i < 4; ++i) {
+        CHECK(std::strcmp(archive.GetEntry(i).name, names[i]) == 0);
+        CHECK(archive.GetEntry(i).offset % ShaderArchive::BlobAlign == 0);
+    }
+
+    const ShaderArchive::Entry* pixel = archive.Find("BasicPS");
+    REQUIRE(pixel != nullptr);
+    CHECK(pixel->stage == ShaderStage::Pixel);
+    CHECK(pixel->size == 123);
+    const std::vector<uint8_t> expected = Blob(123, 2);
+    CHECK(std::memcmp(archive.GetBytecode(*pixel), expected.data(), expected.size()) == 0);
+    CHECK(pixel->hash == ShaderArchive::Hash(expected.data(), expected.size()));
+
+    CHECK(archive.Find("MissingVS") == nullptr);
+    CHECK(archive.Find("") == nullptr);
+    CHECK(archive.Find("ZZZ") == nullptr);
+}
+
+TEST(IdenticalBytecodeIsStoredOnce) {
+    const std::vector<uint8_t> bytes = BuildSample();
+    ShaderArchive archive;
+    REQUIRE(archive.Load(bytes.data(), bytes.size()));
+    CHECK(archive.GetBlobCount() == 3);
+
+    const ShaderArchive::Entry* basic = archive.Find("BasicVS");
+    const ShaderArchive::Entry* copy  = archive.Find("CopyVS");
+    REQUIRE(basic && copy);
+    CHECK(basic->offset == copy->offset);
+    CHECK(basic->hash == copy->hash);
+
+    // Header, index, and three aligned blobs; the shared one is not repeated
+    size_t blobBytes = 0;
+    for (uint32_t size : {300u, 123u, 64u}) {
+        blobBytes += (size + ShaderArchive::BlobAlign - 1) / ShaderArchive::BlobAlign *
+                     ShaderArchive::BlobAlign;
+    }
+    const size_t indexBytes = sizeof(ShaderArchive::Header) + 4 * sizeof(ShaderArchive::Entry);
+    CHECK(bytes.size() <= indexBytes + ShaderArchive::BlobAlign + blobBytes);
+}
+
+TEST(LoadRejectsDamagedArchives) {
+    const std::vector<uint8_t> good = BuildSample();
+    ShaderArchive archive;
+
+    CHECK(!archive.Load(good.data(), sizeof(ShaderArchive::Header) - 1));
+    CHECK(!archive.Load(good.data(), sizeof(ShaderArchive::Header) + 10)); // Index cut off
+
+    std::vector<uint8_t> bytes = good;
+    bytes[0] ^= 0xFF; // Magic
+    CHECK(!archive.Load(bytes.data(), bytes.size()));
+
+    bytes = good;
+    bytes[4] = ShaderArchive::Version + 1;
+    CHECK(!archive.Load(bytes.data(), bytes.size()));
+
+    // A blob running past the end of the file
+    CHECK(!archive.Load(good.data(), good.size() - 1));
+
+    // Index no longer sorted
+    bytes = good;
+    ShaderArchive::Entry* entries =
+        reinterpret_cast<ShaderArchive::Entry*>(bytes.data() + sizeof(ShaderArchive::Header));
+    std::swap(entries[0], entries[1]);
+    CHECK(!archive.Load(bytes.data(), bytes.size()));
+
+    // A failed load leaves the archive empty
+    CHECK(archive.GetEntryCount() == 0);
+    CHECK(archive.Find("BasicVS") == nullptr);
+}
+
+TEST(VerifyDetectsCorruptBytecode) {
+    std::vector<uint8_t> bytes = BuildSample();
+    ShaderArchive archive;
+    REQUIRE(archive.Load(bytes.data(), bytes.size()));
+    const ShaderArchive::Entry* entry = archive.Find("SpritePS");
+    REQUIRE(entry != nullptr);
+    bytes[static_cast<size_t>(entry->offset) + 10] ^= 0x01;
+    CHECK(!archive.Verify());
+}
+
+TEST(RoundTripThroughAMappedFile) {
+    ShaderArchiveWriter writer;
+    std::vector<std::vector<uint8_t>> blobs;
+    for (uint32_t i = 0; i < 200; ++i) {
+        blobs.push_back(Blob(100 + i * 13, static_cast<uint8_t>(i)));
+        const std::string name  = "Shader" + std::to_string(i) + (i % 2 ? "PS" : "VS");
+        const ShaderStage stage = i % 2 ? ShaderStage::Pixel : ShaderStage::Vertex;
+        REQUIRE(writer.Add(name, stage, blobs.back().data(), blobs.back().size()));
+    }
+    const char* path = "ShaderArchiveTest.pak";
+    REQUIRE(writer.Write(path));
+
+    ShaderArchive archive;
+    REQUIRE(archive.Open(path));
+    CHECK(archive.GetEntryCount() == 200);
+    CHECK(archive.Verify());
+    for (uint32_t i = 0; i < 200; ++i) {
+        const std::string name            = "Shader" + std::to_string(i) + (i % 2 ? "PS" : "VS");
+        const ShaderArchive::Entry* entry = archive.Find(name.c_str());
+        REQUIRE(entry != nullptr);
+        CHECK(entry->size == blobs[i].size());
+        CHECK(std::memcmp(archive.GetBytecode(*entry), blobs[i].data(), entry->size) == 0);
+    }
+    archive.Close();
+    CHECK(archive.GetEntryCount() == 0);
+    std::remove(path);
+
+    CHECK(!archive.Open("ShaderArchiveTest.missing"));
+}
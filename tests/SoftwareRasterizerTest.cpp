@@ -0,0 +1,312 @@
+#include "Test.h"
+#include "render/SoftwareRasterizer.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+const float Black[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+
+uint32_t PixelAt(const SoftwareRasterizer& rasterizer, int x, int y) {
+    uint32_t pixel;
+    std::memcpy(&pixel, rasterizer.GetPixels() + y * rasterizer.GetRowPitch() + x * 4, 4);
+    return pixel;
+}
+
+void Initialize(SoftwareRasterizer& rasterizer, int width, int height, uint32_t threads) {
+    BackendDesc desc;
+    desc.width  = width;
+    desc.height = height;
+    rasterizer.Initialize(desc);
+    rasterizer.SetThreadCount(threads);
+}
+
+// Clockwise (front facing) triangles spread over the target, colors varying per vertex
+std::vector<Vertex> MakeScene(uint32_t count) {
+    std::vector<Vertex> vertices;
+    uint32_t seed = 7;
+    auto next     = [&seed] {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<float>(seed >> 8) / 16777216.0f;
+    };
+    for (uint32_t i = 0; i < count; ++i) {
+        float x = next() * 1.6f - 0.8f;
+        float y = next() * 1.6f - 0.8f;
+        float s = 0.05f + next() * 0.3f;
+        vertices.push_back({{x, y + s, 0.5f}, {next(), next(), next(), 1.0f}});
+        vertices.push_back({{x + s, y - s, 0.5f}, {next(), next(), next(), 1.0f}});
+        vertices.push_back({{x - s, y - s, 0.5f}, {next(), next(), next(), 1.0f}});
+    }
+    return vertices;
+}
+
+} // namespace
+
+TEST(ClearFillsTheTarget) {
+    SoftwareRasterizer rasterizer;
+    Initialize(rasterizer, 70, 33, 2);
+    const float red[4] = {1.0f, 0.0f, 0.0f, 1.0f};
+    rasterizer.Clear(red);
+    rasterizer.Flush();
+    CHECK(PixelAt(rasterizer, 0, 0) == 0xFF0000FFu);
+    CHECK(PixelAt(rasterizer, 69, 32) == 0xFF0000FFu);
+}
+
+// Regression: a batch issued right after SetThreadCount used to hang on the first frame
+TEST(FramesRightAfterSetThreadCountDoNotHang) {
+    for (int run = 0; run < 50; ++run) {
+        SoftwareRasterizer rasterizer;
+        Initialize(rasterizer, 128, 128, 8);
+        for (int frame = 0; frame < 4; ++frame) {
+            rasterizer.Clear(Black);
+            rasterizer.Present();
+        }
+        rasterizer.SetThreadCount(3);
+        rasterizer.Clear(Black);
+        rasterizer.Present();
+    }
+    CHECK(true);
+}
+
+TEST(SharedEdgesAreCoveredExactlyOnce) {
+    SoftwareRasterizer rasterizer;
+    Initialize(rasterizer, 64, 64, 1);
+
+    // Two clockwise triangles forming the quad [-0.5, 0.5]^2: 32 x 32 pixels
+    const float c[4]   = {1.0f, 1.0f, 1.0f, 1.0f};
+    Vertex vertices[6] = {{{-0.5f, 0.5f, 0.0f}, {c[0], c[1], c[2], c[3]}},
+                          {{0.5f, 0.5f, 0.0f}, {c[0], c[1], c[2], c[3]}},
+                          {{0.5f, -0.5f, 0.0f}, {c[0], c[1], c[2], c[3]}},
+                          {{-0.5f, 0.5f, 0.0f}, {c[0], c[1], c[2], c[3]}},
+                          {{0.5f, -0.5f, 0.0f}, {c[0], c[1], c[2], c[3]}},
+                          {{-0.5f, -0.5f, 0.0f}, {c[0], c[1], c[2], c[3]}}};
+    rasterizer.Clear(Black);
+    rasterizer.SetVertexBuffer(vertices, 6);
+    rasterizer.Draw(6, 0);
+    rasterizer.Flush();
+
+    CHECK(rasterizer.GetStats().pixelsWritten == 32 * 32);
+    CHECK(PixelAt(rasterizer, 16, 16) == 0xFFFFFFFFu);
+    CHECK(PixelAt(rasterizer, 47, 47) == 0xFFFFFFFFu);
+    CHECK(PixelAt(rasterizer, 15, 16) == 0xFF000000u);
+    CHECK(PixelAt(rasterizer, 48, 47) == 0xFF000000u);
+}
+
+TEST(BackFacesAreCulled) {
+    SoftwareRasterizer rasterizer;
+    Initialize(rasterizer, 32, 32, 1);
+    Vertex vertices[3] = {{{0.0f, 0.5f, 0.0f}, {1, 1, 1, 1}},
+                          {{-0.5f, -0.5f, 0.0f}, {1, 1, 1, 1}},
+                          {{0.5f, -0.5f, 0.0f}, {1, 1, 1, 1}}};
+    rasterizer.Clear(Black);
+    rasterizer.SetVertexBuffer(vertices, 3);
+    rasterizer.Draw(3, 0);
+    rasterizer.Flush();
+    CHECK(rasterizer.GetStats().trianglesSubmitted == 1);
+    CHECK(rasterizer.GetStats().trianglesRasterized == 0);
+    CHECK(rasterizer.GetStats().pixelsWritten == 0);
+}
+
+TEST(OutputIsIdenticalForEveryThreadCount) {
+    std::vector<Vertex> scene = MakeScene(2000);
+    std::vector<uint8_t> reference;
+    for (uint32_t threads : {1u, 2u, 4u, 7u}) {
+        SoftwareRasterizer rasterizer;
+        Initialize(rasterizer, 301, 199, threads);
+        rasterizer.Clear(Black);
+        rasterizer.SetVertexBuffer(scene.data(), static_cast<uint32_t>(scene.size()));
+        rasterizer.Draw(static_cast<uint32_t>(scene.size()), 0);
+        rasterizer.Flush();
+
+        const uint8_t* pixels = rasterizer.GetPixels();
+        std::vector<uint8_t> frame(pixels, pixels + rasterizer.GetRowPitch() * 199);
+        if (reference.empty()) {
+            reference = frame;
+        } else {
+            CHECK(frame == reference);
+        }
+    }
+}
+
+TEST(EveryRasterPathMatchesTheScalarReference) {
+    // Odd width so groups straddle the right edge; the second pass makes w vary across the
+    // target (w = 1 + 0.5 * x) so the interpolation is perspective-correct, not affine
+    using Path                = SoftwareRasterizer::RasterPath;
+    std::vector<Vertex> scene = MakeScene(2000);
+    Float4x4 perspective      = Float4x4::Identity();
+    perspective.m[0][3]       = 0.5f;
+    for (const Float4x4& viewProjection : {Float4x4::Identity(), perspective}) {
+        std::vector<uint8_t> reference;
+        uint64_t referencePixels = 0;
+        for (Path path : {Path::Scalar, Path::Sse2, Path::Avx2}) {
+            SoftwareRasterizer rasterizer;
+            Initialize(rasterizer, 301, 199, 1);
+            if (rasterizer.SetRasterPath(path) != path) {
+                std::printf("    (raster path %d not supported here)\n", static_cast<int>(path));
+                continue;
+            }
+            rasterizer.SetViewProjection(viewProjection);
+            rasterizer.Clear(Black);
+            rasterizer.SetVertexBuffer(scene.data(), static_cast<uint32_t>(scene.size()));
+            rasterizer.Draw(static_cast<uint32_t>(scene.size()), 0);
+            rasterizer.Flush();
+
+            const uint8_t* pixels = rasterizer.GetPixels();
+            std::vector<uint8_t> frame(pixels, pixels + rasterizer.GetRowPitch() * 199);
+            if (path == Path::Scalar) {
+                reference       = frame;
+                referencePixels = rasterizer.GetStats().pixelsWritten;
+                CHECK(referencePixels > 0);
+            } else {
+                CHECK(frame == reference);
+                CHECK(rasterizer.GetStats().pixelsWritten == referencePixels);
+            }
+        }
+    }
+    CHECK(SoftwareRasterizer().GetRasterPath() == SoftwareRasterizer::GetBestRasterPath());
+}
+
+TEST(InstancesMatchPreTransformedVertices) {
+    Vertex triangle[3] = {{{0.0f, 0.2f, 0.5f}, {1, 1, 1, 1}},
+                          {{0.2f, -0.2f, 0.5f}, {1, 1, 1, 1}},
+                          {{-0.2f, -0.2f, 0.5f}, {1, 1, 1, 1}}};
+    InstanceData instance = {};
+    instance.transform[0][0] = 1.5f;
+    instance.transform[0][3] = 0.3f;
+    instance.transform[1][1] = 1.0f;
+    instance.transform[1][3] = -0.1f;
+    instance.transform[2][2] = 1.0f;
+    instance.color[0]        = 0.5f;
+    instance.color[1]        = 1.0f;
+    instance.color[2]        = 0.25f;
+    instance.color[3]        = 1.0f;
+
+    SoftwareRasterizer instanced;
+    Initialize(instanced, 64, 64, 2);
+    instanced.Clear(Black);
+    instanced.SetVertexBuffer(triangle, 3);
+    instanced.SetInstanceBuffer(&instance, 1);
+    instanced.DrawInstanced(3, 1, 0, 0);
+    instanced.Flush();
+
+    Vertex transformed[3];
+    for (int i = 0; i < 3; ++i) {
+        transformed[i].position[0] = triangle[i].position[0] * 1.5f + 0.3f;
+        transformed[i].position[1] = triangle[i].position[1] - 0.1f;
+        transformed[i].position[2] = triangle[i].position[2];
+        for (int c = 0; c < 4; ++c) {
+            transformed[i].color[c] = triangle[i].color[c] * instance.color[c];
+        }
+    }
+    SoftwareRasterizer direct;
+    Initialize(direct, 64, 64, 2);
+    direct.Clear(Black);
+    direct.SetVertexBuffer(transformed, 3);
+    direct.Draw(3, 0);
+    direct.Flush();
+
+    CHECK(instanced.GetStats().pixelsWritten > 0);
+    CHECK(std::memcmp(instanced.GetPixels(), direct.GetPixels(), direct.GetRowPitch() * 64) == 0);
+}
+
+TEST(ViewProjectionDividesByW) {
+    // Left-handed perspective, 90 degree field of view, near 1, far 10 (row-vector convention)
+    Float4x4 projection = {};
+    projection.m[0][0]  = 1.0f;
+    projection.m[1][1]  = 1.0f;
+    projection.m[2][2]  = 10.0f / 9.0f;
+    projection.m[2][3]  = 1.0f;
+    projection.m[3][2]  = -10.0f / 9.0f;
+
+    auto coverage = [&](float depth) {
+        SoftwareRasterizer rasterizer;
+        Initialize(rasterizer, 128, 128, 2);
+        rasterizer.SetViewProjection(projection);
+        Vertex vertices[3] = {{{0.0f, 1.0f, depth}, {1, 1, 1, 1}},
+                              {{1.0f, -1.0f, depth}, {1, 1, 1, 1}},
+                              {{-1.0f, -1.0f, depth}, {1, 1, 1, 1}}};
+        rasterizer.Clear(Black);
+        rasterizer.SetVertexBuffer(vertices, 3);
+        rasterizer.Draw(3, 0);
+        rasterizer.Flush();
+        return rasterizer.GetStats().pixelsWritten;
+    };
+
+    // Twice as far away: half the size on screen, a quarter of the pixels
+    uint64_t near = coverage(2.0f);
+    uint64_t far  = coverage(4.0f);
+    CHECK(near == 64 * 32);
+    CHECK(far * 4 == near);
+
+    // Beyond the far plane nothing is drawn
+    CHECK(coverage(20.0f) == 0);
+}
+
+TEST(TrianglesCrossingTheNearPlaneAreClipped) {
+    Float4x4 projection = {};
+    projection.m[0][0]  = 1.0f;
+    projection.m[1][1]  = 1.0f;
+    projection.m[2][2]  = 10.0f / 9.0f;
+    projection.m[2][3]  = 1.0f;
+    projection.m[3][2]  = -10.0f / 9.0f;
+
+    SoftwareRasterizer rasterizer;
+    Initialize(rasterizer, 128, 128, 2);
+    rasterizer.SetViewProjection(projection);
+
+    // One vertex behind the camera: the visible part becomes a quad, drawn as two triangles
+    Vertex vertices[3] = {{{0.0f, 1.0f, 5.0f}, {1, 1, 1, 1}},
+                          {{1.0f, -1.0f, -3.0f}, {1, 1, 1, 1}},
+                          {{-1.0f, -1.0f, 5.0f}, {1, 1, 1, 1}}};
+    rasterizer.Clear(Black);
+    rasterizer.SetVertexBuffer(vertices, 3);
+    rasterizer.Draw(3, 0);
+    rasterizer.Flush();
+
+    SoftwareRasterizer::Stats stats = rasterizer.GetStats();
+    CHECK(stats.trianglesRasterized == 2);
+    CHECK(stats.pixelsWritten > 0);
+    CHECK(stats.pixelsWritten <= 128u * 128u);
+}
+
+TEST(ViewProjectionTakesEffectAtClear) {
+    SoftwareRasterizer rasterizer;
+    Initialize(rasterizer, 32, 32, 1);
+    Vertex vertices[3] = {{{0.0f, 0.5f, 0.5f}, {1, 1, 1, 1}},
+                          {{0.5f, -0.5f, 0.5f}, {1, 1, 1, 1}},
+                          {{-0.5f, -0.5f, 0.5f}, {1, 1, 1, 1}}};
+
+    // Moving the triangle off screen mid-frame does not affect the current frame
+    Float4x4 offscreen = Float4x4::Identity();
+    offscreen.m[3][0]  = 10.0f;
+    rasterizer.Clear(Black);
+    rasterizer.SetViewProjection(offscreen);
+    rasterizer.SetVertexBuffer(vertices, 3);
+    rasterizer.Draw(3, 0);
+    rasterizer.Flush();
+    CHECK(rasterizer.GetStats().pixelsWritten > 0);
+
+    rasterizer.ResetStats();
+    rasterizer.Clear(Black);
+    rasterizer.Draw(3, 0);
+    rasterizer.Flush();
+    CHECK(rasterizer.GetStats().pixelsWritten == 0);
+}
+
+TEST(SaveFrameWritesPpm) {
+    SoftwareRasterizer rasterizer;
+    Initialize(rasterizer, 5, 3, 1);
+    rasterizer.Clear(Black);
+    const char* path = "SoftwareRasterizerTest.ppm";
+    REQUIRE(rasterizer.SaveFrame(path));
+
+    FILE* file = std::fopen(path, "rb");
+    REQUIRE(file);
+    char header[16] = {};
+    size_t read     = std::fread(header, 1, 11, file);
+    std::fclose(file);
+    std::remove(path);
+    CHECK(read == 11);
+    CHECK(std::strncmp(header, "P6\n5 3\n255\n", 11) == 0);
+}
@@ -0,0 +1,337 @@
+#include "Test.h"
+#include "render/SpriteBatch.h"
+#include "render/TextureAtlas.h"
+#include "threading/JobSystem.h"
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Keeps every chunk's vertices and every draw, standing in for the D3D11 renderer
+class RecordingTarget : public SpriteBatch::Target {
+  public:
+    struct Draw {
+        uint32_t chunk;
+        uint32_t texture;
+        SpriteBlend blend;
+        uint32_t firstQuad;
+        uint32_t quadCount;
+    };
+
+    std::vector<std::vector<SpriteVertex>> chunks;
+    std::vector<Draw> draws;
+    uint32_t dropChunk = ~0u; // BeginChunk returns nullptr for this chunk
+
+    SpriteVertex* BeginChunk(uint32_t quadCount) override {
+        chunks.emplace_back(static_cast<size_t>(quadCount) * 4);
+        if (chunks.size() - 1 == dropChunk) {
+            return nullptr;
+        }
+        return chunks.back().data();
+    }
+    void DrawQuads(uint32_t texture,
+                   SpriteBlend blend,
+                   uint32_t firstQuad,
+                   uint32_t quadCount) override {
+        draws.push_back({static_cast<uint32_t>(chunks.size() - 1),
+                         texture,
+                         blend,
+                         firstQuad,
+                         quadCount});
+    }
+};
+
+// Sprites in a 100x100 viewport whose x is their submission index, so vertex positions
+// tell which sprite was written where
+std::vector<Sprite> MakeSprites(uint32_t count, uint32_t textures, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<Sprite> sprites(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        Sprite& sprite  = sprites[i];
+        sprite.x        = static_cast<float>(i);
+        sprite.y        = 50.0f;
+        sprite.width    = 2.0f;
+        sprite.height   = 2.0f;
+        sprite.texture  = rng() % textures;
+        sprite.blend    = static_cast<SpriteBlend>(rng() % SpriteBlendCount);
+        sprite.layer    = static_cast<uint8_t>(rng() % 2);
+        sprite.rotation = 0.0f;
+    }
+    return sprites;
+}
+
+// Submission index of the sprite whose first vertex this is (see MakeSprites)
+uint32_t SpriteIndex(const SpriteVertex& topLeft) {
+    const float centerX = (topLeft.position[0] + 1.0f) * 50.0f + 1.0f;
+    return static_cast<uint32_t>(centerX + 0.5f);
+}
+
+uint32_t StateOf(const Sprite& sprite) {
+    return (static_cast<uint32_t>(sprite.layer) << 24) |
+           (static_cast<uint32_t>(sprite.blend) << 20) | sprite.texture;
+}
+
+} // namespace
+
+TEST(SpriteIndexPatternIsTwoClockwiseTriangles) {
+    std::vector<uint16_t> indices(3 * SpriteBatch::IndicesPerQuad);
+    SpriteBatch::WriteIndices(indices.data(), 3);
+    const uint16_t expected[] = {0, 1, 2, 2, 1, 3, 4, 5, 6, 6, 5, 7, 8, 9, 10, 10, 9, 11};
+    CHECK(std::memcmp(indices.data(), expected, sizeof(expected)) == 0);
+
+    // The last quad of a full chunk still fits 16-bit indices
+    indices.resize(SpriteBatch::MaxQuadsPerDraw * SpriteBatch::IndicesPerQuad);
+    SpriteBatch::WriteIndices(indices.data(), SpriteBatch::MaxQuadsPerDraw);
+    CHECK(indices.back() == 65535);
+}
+
+TEST(SpriteVerticesMapPixelsToClipSpace) {
+    // A 20x10 sprite centered in a 200x100 viewport, tinted and showing part of a texture
+    Sprite sprite;
+    sprite.x      = 100.0f;
+    sprite.y      = 50.0f;
+    sprite.width  = 20.0f;
+    sprite.height = 10.0f;
+    sprite.region = {0.25f, 0.5f, 0.75f, 1.0f};
+    sprite.color  = 0x80FF4020u;
+    const uint32_t order = 0;
+    SpriteVertex corners[4];
+    SpriteBatch::WriteVertices(&sprite, &order, 1, 2.0f / 200.0f, 2.0f / 100.0f, corners);
+
+    // Top-left, top-right, bottom-left, bottom-right; y is up in clip space
+    const float expected[4][4] = {
+        {-0.1f, 0.1f, 0.25f, 0.5f},
+        {0.1f, 0.1f, 0.75f, 0.5f},
+        {-0.1f, -0.1f, 0.25f, 1.0f},
+        {0.1f, -0.1f, 0.75f, 1.0f},
+    };
+    for (int i = 0; i < 4; ++i) {
+        CHECK_NEAR(corners[i].position[0], expected[i][0], 1e-6);
+        CHECK_NEAR(corners[i].position[1], expected[i][1], 1e-6);
+        CHECK(corners[i].uv[0] == expected[i][2]);
+        CHECK(corners[i].uv[1] == expected[i][3]);
+        CHECK(corners[i].color.v[0] == 0x20);
+        CHECK(corners[i].color.v[1] == 0x40);
+        CHECK(corners[i].color.v[2] == 0xFF);
+        CHECK(corners[i].color.v[3] == 0x80);
+    }
+
+    // A quarter turn clockwise on screen takes the top-left corner to the top-right
+    sprite.x        = 0.0f;
+    sprite.y        = 0.0f;
+    sprite.width    = 2.0f;
+    sprite.height   = 2.0f;
+    sprite.rotation = 1.57079633f;
+    SpriteBatch::WriteVertices(&sprite, &order, 1, 1.0f, 1.0f, corners);
+    CHECK_NEAR(corners[0].position[0], 0.0f, 1e-6); // (-1, -1) px -> (1, -1) px
+    CHECK_NEAR(corners[0].position[1], 2.0f, 1e-6);
+    CHECK_NEAR(corners[3].position[0], -2.0f, 1e-6); // (1, 1) px -> (-1, 1) px
+    CHECK_NEAR(corners[3].position[1], 0.0f, 1e-6);
+}
+
+TEST(SpriteBatchSubmissionOrderBreaksOnEveryChange) {
+    SpriteBatch batch;
+    batch.SetViewport(100.0f, 100.0f);
+    batch.SetSortMode(SpriteBatch::SortMode::Submission);
+    Sprite sprite;
+    const uint32_t textures[] = {1, 1, 2, 1, 1, 1};
+    for (uint32_t texture : textures) {
+        sprite.texture = texture;
+        batch.Draw(sprite);
+    }
+    RecordingTarget target;
+    const SpriteBatch::Stats stats = batch.End(target);
+    CHECK(stats.sprites == 6);
+    CHECK(stats.chunks == 1);
+    CHECK(stats.draws == 3);
+    REQUIRE(target.draws.size() == 3);
+    CHECK(target.draws[0].firstQuad == 0 && target.draws[0].quadCount == 2);
+    CHECK(target.draws[1].firstQuad == 2 && target.draws[1].texture == 2);
+    CHECK(target.draws[2].firstQuad == 3 && target.draws[2].quadCount == 3);
+
+    // End empties the batch
+    CHECK(batch.GetSpriteCount() == 0);
+    CHECK(batch.End(target).draws == 0);
+}
+
+TEST(SpriteBatchTextureSortIsStableAndCoversEverySprite) {
+    const uint32_t count              = 100;
+    const std::vector<Sprite> sprites = MakeSprites(count, 4, 3);
+    SpriteBatch batch;
+    batch.SetViewport(100.0f, 100.0f);
+    batch.Draw(sprites.data(), count);
+    RecordingTarget target;
+    const SpriteBatch::Stats stats = batch.End(target);
+    REQUIRE(target.chunks.size() == 1);
+
+    // At most one draw per (layer, blend, texture), layers in order, and within a draw the
+    // sprites keep their submission order
+    CHECK(stats.draws <= 2 * SpriteBlendCount * 4);
+    std::vector<bool> seen(count, false);
+    uint32_t lastState = 0;
+    uint32_t covered   = 0;
+    for (size_t d = 0; d < target.draws.size(); ++d) {
+        const RecordingTarget::Draw& draw = target.draws[d];
+        uint32_t previous                 = 0;
+        for (uint32_t q = 0; q < draw.quadCount; ++q) {
+            const uint32_t index = SpriteIndex(target.chunks[0][(draw.firstQuad + q) * 4]);
+            REQUIRE(index < count);
+            const Sprite& sprite = sprites[index];
+            CHECK(sprite.texture == draw.texture);
+            CHECK(sprite.blend == draw.blend);
+            CHECK(q == 0 || index > previous);
+            CHECK(!seen[index]);
+            seen[index] = true;
+            previous    = index;
+        }
+        const uint32_t state = StateOf(sprites[previous]);
+        CHECK(d == 0 || state > lastState);
+        lastState = state;
+        CHECK(draw.firstQuad == covered);
+        covered += draw.quadCount;
+    }
+    CHECK(covered == count);
+}
+
+TEST(SpriteBatchSplitsChunksAndCountsDroppedOnes) {
+    const uint32_t count = SpriteBatch::MaxQuadsPerDraw * 2 + 100;
+    SpriteBatch batch;
+    batch.SetViewport(100.0f, 100.0f);
+    Sprite sprite;
+    sprite.texture = 7;
+    for (uint32_t i = 0; i < count; ++i) {
+        batch.Draw(sprite);
+    }
+    RecordingTarget target;
+    target.dropChunk               = 1;
+    const SpriteBatch::Stats stats = batch.End(target);
+    CHECK(stats.chunks == 3);
+    CHECK(stats.dropped == SpriteBatch::MaxQuadsPerDraw);
+    CHECK(stats.draws == 2); // One per chunk that got memory
+    REQUIRE(target.chunks.size() == 3);
+    CHECK(target.chunks[0].size() == SpriteBatch::MaxQuadsPerDraw * 4);
+    CHECK(target.chunks[2].size() == 100 * 4);
+    REQUIRE(target.draws.size() == 2);
+    CHECK(target.draws[0].chunk == 0);
+    CHECK(target.draws[0].quadCount == SpriteBatch::MaxQuadsPerDraw);
+    CHECK(target.draws[1].chunk == 2);
+    CHECK(target.draws[1].quadCount == 100);
+}
+
+TEST(SpriteBatchParallelWriteMatchesSerial) {
+    // Enough sprites for several tasks per chunk, and a chunk boundary
+    const uint32_t count        = SpriteBatch::MaxQuadsPerDraw + 3 * SpriteBatch::TaskSize;
+    std::vector<Sprite> sprites = MakeSprites(count, 16, 9);
+    for (uint32_t i = 0; i < count; ++i) {
+        sprites[i].rotation = static_cast<float>(i) * 0.001f;
+    }
+
+    SpriteBatch serial;
+    serial.SetViewport(1280.0f, 720.0f);
+    serial.Draw(sprites.data(), count);
+    RecordingTarget expected;
+    serial.End(expected);
+
+    JobSystem jobSystem;
+    jobSystem.Initialize();
+    SpriteBatch parallel;
+    parallel.SetViewport(1280.0f, 720.0f);
+    parallel.SetParallelFor(jobSystem.GetTaskExecutor());
+    parallel.Draw(sprites.data(), count);
+    RecordingTarget actual;
+    parallel.End(actual);
+    jobSystem.Shutdown();
+
+    REQUIRE(actual.chunks.size() == expected.chunks.size());
+    for (size_t i = 0; i < actual.chunks.size(); ++i) {
+        CHECK(std::memcmp(actual.chunks[i].data(),
+                          expected.chunks[i].data(),
+                          actual.chunks[i].size() * sizeof(SpriteVertex)) == 0);
+    }
+    CHECK(actual.draws.size() == expected.draws.size());
+}
+
+TEST(AtlasPackerKeepsRectanglesInsideAndApart) {
+    AtlasPacker packer(256, 256);
+    std::mt19937 rng(5);
+    struct Rect {
+        uint32_t x, y, width, height;
+    };
+    std::vector<Rect> placed;
+    uint64_t area = 0;
+    for (int i = 0; i < 400; ++i) {
+        const uint32_t width  = static_cast<uint32_t>(4 + rng() % 29);
+        const uint32_t height = static_cast<uint32_t>(4 + rng() % 29);
+        Rect rect             = {0, 0, width, height};
+        if (!packer.Insert(rect.width, rect.height, rect.x, rect.y)) {
+            continue;
+        }
+        CHECK(rect.x + rect.width <= 256);
+        CHECK(rect.y + rect.height <= 256);
+        for (const Rect& other : placed) {
+            const bool apart = rect.x + rect.width <= other.x || other.x + other.width <= rect.x ||
+                               rect.y + rect.height <= other.y || other.y + other.height <= rect.y;
+            CHECK(apart);
+        }
+        placed.push_back(rect);
+        area += static_cast<uint64_t>(rect.width) * rect.height;
+    }
+    CHECK(packer.GetUsedArea() == area);
+    CHECK(area > 256 * 256 / 2); // The bin filled up well before giving up
+
+    // A rectangle wider than the bin never fits, and leaves it unchanged
+    uint32_t x = 0;
+    uint32_t y = 0;
+    CHECK(!packer.Insert(257, 1, x, y));
+    CHECK(packer.GetUsedArea() == area);
+}
+
+TEST(TextureAtlasCopiesImagesWithExtrudedPadding) {
+    // Images filled with their id in every pixel, and one with a distinct corner
+    TextureAtlas atlas;
+    std::mt19937 rng(11);
+    std::vector<uint32_t> image;
+    for (uint32_t id = 0; id < 30; ++id) {
+        const uint32_t width  = 3 + rng() % 20;
+        const uint32_t height = 3 + rng() % 20;
+        image.assign(static_cast<size_t>(width) * height, 0xFF000000u | id);
+        image[0] = 0xFFABCDEFu;
+        CHECK(atlas.Add(image.data(), width, height) == id);
+    }
+    REQUIRE(atlas.Build(1024, 2));
+    const uint32_t width  = atlas.GetWidth();
+    const uint32_t height = atlas.GetHeight();
+    CHECK((width & (width - 1)) == 0);
+    CHECK((height & (height - 1)) == 0);
+    CHECK(atlas.GetOccupancy() > 0.3f);
+    CHECK(atlas.GetOccupancy() <= 1.0f);
+
+    const std::vector<uint32_t>& pixels = atlas.GetPixels();
+    for (uint32_t id = 0; id < atlas.GetImageCount(); ++id) {
+        const TextureAtlas::Region& region = atlas.GetRegion(id);
+        REQUIRE(region.x >= 2 && region.y >= 2);
+        REQUIRE(region.x + region.width + 2 <= width);
+        REQUIRE(region.y + region.height + 2 <= height);
+        CHECK(pixels[region.y * width + region.x] == 0xFFABCDEFu);
+        CHECK(pixels[(region.y + region.height - 1) * width + region.x + region.width - 1] ==
+              (0xFF000000u | id));
+
+        // The padding repeats the border: the corner pixel spreads diagonally
+        CHECK(pixels[(region.y - 2) * width + region.x - 2] == 0xFFABCDEFu);
+        CHECK(pixels[(region.y - 1) * width + region.x + 1] == (0xFF000000u | id));
+        CHECK(pixels[(region.y + region.height + 1) * width + region.x + region.width + 1] ==
+              (0xFF000000u | id));
+
+        CHECK_NEAR(region.u0, static_cast<double>(region.x) / width, 1e-7);
+        CHECK_NEAR(region.v0, static_cast<double>(region.y) / height, 1e-7);
+        CHECK_NEAR(region.u1, static_cast<double>(region.x + region.width) / width, 1e-7);
+        CHECK_NEAR(region.v1, static_cast<double>(region.y + region.height) / height, 1e-7);
+    }
+
+    // Too big for the limit
+    TextureAtlas tooBig;
+    image.assign(64 * 64, 0u);
+    tooBig.Add(image.data(), 64, 64);
+    CHECK(!tooBig.Build(32));
+}
@@ -0,0 +1,190 @@
+#include "Test.h"
+#include "render/StateCache.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+// Logs every forwarded call by name, which is all the cache's behavior is observable through
+class RecordingSink : public ContextSink {
+  public:
+    std::vector<std::string> calls;
+
+    void SetInputLayout(void*) override {
+        calls.push_back("InputLayout");
+    }
+    void SetPrimitiveTopology(uint32_t) override {
+        calls.push_back("Topology");
+    }
+    void SetIndexBuffer(void*, uint32_t, uint32_t) override {
+        calls.push_back("IndexBuffer");
+    }
+    void SetVertexBuffer(uint32_t slot, void*, uint32_t, uint32_t) override {
+        calls.push_back("VertexBuffer" + std::to_string(slot));
+    }
+    void SetVertexShader(void*) override {
+        calls.push_back("VertexShader");
+    }
+    void SetPixelShader(void*) override {
+        calls.push_back("PixelShader");
+    }
+    void SetPixelShaderResource(uint32_t slot, void*) override {
+        calls.push_back("PixelResource" + std::to_string(slot));
+    }
+    void SetPixelSampler(uint32_t slot, void*) override {
+        calls.push_back("PixelSampler" + std::to_string(slot));
+    }
+    void SetVertexConstantBuffer(uint32_t slot, void*, uint32_t, uint32_t) override {
+        calls.push_back("VertexConstants" + std::to_string(slot));
+    }
+    void SetRasterizerState(void*) override {
+        calls.push_back("Rasterizer");
+    }
+    void SetViewport(float, float, float, float) override {
+        calls.push_back("Viewport");
+    }
+    void SetDepthStencilState(void*, uint32_t) override {
+        calls.push_back("DepthStencil");
+    }
+    void SetBlendState(void*, const float*, uint32_t) override {
+        calls.push_back("Blend");
+    }
+    void SetRenderTarget(void*, void*) override {
+        calls.push_back("RenderTarget");
+    }
+    void Draw(uint32_t, uint32_t) override {
+        calls.push_back("Draw");
+    }
+    void DrawIndexed(uint32_t, uint32_t, int32_t) override {
+        calls.push_back("DrawIndexed");
+    }
+    void DrawInstanced(uint32_t, uint32_t, uint32_t, uint32_t) override {
+        calls.push_back("DrawInstanced");
+    }
+    void DrawIndexedInstanced(uint32_t, uint32_t, uint32_t, int32_t, uint32_t) override {
+        calls.push_back("DrawIndexedInstanced");
+    }
+};
+
+// Distinct fake object pointers; the cache only compares them
+void* Object(uintptr_t id) {
+    return reinterpret_cast<void*>(id * 16);
+}
+
+} // namespace
+
+TEST(FirstCallOfEveryKindIsForwarded) {
+    // Null is a valid binding too; an unknown shadow must not mistake it for "already bound"
+    RecordingSink sink;
+    StateCache cache(sink);
+    cache.SetInputLayout(nullptr);
+    cache.SetPrimitiveTopology(0);
+    cache.SetVertexShader(nullptr);
+    cache.SetPixelShader(nullptr);
+    cache.SetDepthStencilState(nullptr, 0);
+    cache.SetViewport(0.0f, 0.0f, 0.0f, 0.0f);
+    CHECK(sink.calls.size() == 6);
+    CHECK(cache.GetStats().issued == 6);
+    CHECK(cache.GetStats().elided == 0);
+}
+
+TEST(RedundantCallsAreElided) {
+    RecordingSink sink;
+    StateCache cache(sink);
+    for (int frame = 0; frame < 3; ++frame) {
+        cache.BeginFrame();
+        cache.SetInputLayout(Object(1));
+        cache.SetPrimitiveTopology(4);
+        cache.SetVertexShader(Object(2));
+        cache.SetPixelShader(Object(3));
+        cache.SetDepthStencilState(nullptr, 0);
+        cache.Draw(3, 0);
+    }
+    // Only the first frame binds anything; draws always go through
+    CHECK(sink.calls.size() == 5 + 3);
+    CHECK(cache.GetStats().issued == 0);
+    CHECK(cache.GetStats().elided == 5);
+    CHECK(cache.GetStats().draws == 1);
+}
+
+TEST(ChangedValuesAreForwarded) {
+    RecordingSink sink;
+    StateCache cache(sink);
+    cache.SetVertexBuffer(0, Object(1), 28, 0);
+    cache.SetVertexBuffer(0, Object(1), 28, 84); // Offset differs
+    cache.SetVertexBuffer(0, Object(1), 32, 84); // Stride differs
+    cache.SetVertexBuffer(0, Object(1), 32, 84);
+    cache.SetDepthStencilState(Object(2), 0);
+    cache.SetDepthStencilState(Object(2), 1); // Stencil reference differs
+    cache.SetVertexConstantBuffer(0, Object(3), 0, 16);
+    cache.SetVertexConstantBuffer(0, Object(3), 16, 16); // Window moves within the page
+    CHECK(cache.GetStats().issued == 7);
+    CHECK(cache.GetStats().elided == 1);
+}
+
+TEST(SlotsAreTrackedIndependently) {
+    RecordingSink sink;
+    StateCache cache(sink);
+    cache.SetPixelShaderResource(0, Object(1));
+    cache.SetPixelShaderResource(1, Object(1));
+    cache.SetPixelSampler(0, Object(1));
+    cache.SetPixelShaderResource(0, Object(1));
+    cache.SetPixelShaderResource(1, Object(2));
+    CHECK(sink.calls == std::vector<std::string>({"PixelResource0",
+                                                  "PixelResource1",
+                                                  "PixelSampler0",
+                                                  "PixelResource1"}));
+}
+
+TEST(SlotsBeyondTheShadowAreAlwaysForwarded) {
+    RecordingSink sink;
+    StateCache cache(sink);
+    for (int i = 0; i < 2; ++i) {
+        cache.SetVertexBuffer(StateCache::MaxVertexBuffers, Object(1), 16, 0);
+        cache.SetPixelShaderResource(StateCache::MaxPixelSlots, Object(1));
+        cache.SetPixelSampler(StateCache::MaxPixelSlots, Object(1));
+        cache.SetVertexConstantBuffer(StateCache::MaxConstantSlots, Object(1), 0, 16);
+    }
+    CHECK(sink.calls.size() == 8);
+    CHECK(cache.GetStats().elided == 0);
+}
+
+TEST(NullBlendFactorMatchesTheDefault) {
+    RecordingSink sink;
+    StateCache cache(sink);
+    const float ones[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    const float half[4] = {0.5f, 0.5f, 0.5f, 0.5f};
+    cache.SetBlendState(Object(1), nullptr, 0xFFFFFFFF);
+    cache.SetBlendState(Object(1), ones, 0xFFFFFFFF);
+    cache.SetBlendState(Object(1), half, 0xFFFFFFFF);
+    cache.SetBlendState(Object(1), half, 0x0000FFFF);
+    CHECK(cache.GetStats().issued == 3);
+    CHECK(cache.GetStats().elided == 1);
+}
+
+TEST(InvalidateForwardsTheNextCall) {
+    RecordingSink sink;
+    StateCache cache(sink);
+    cache.SetRenderTarget(Object(1), Object(2));
+    cache.SetRasterizerState(Object(3));
+    cache.Invalidate();
+    cache.SetRenderTarget(Object(1), Object(2));
+    cache.SetRasterizerState(Object(3));
+    cache.SetRasterizerState(Object(3));
+    CHECK(sink.calls.size() == 4);
+    CHECK(cache.GetStats().elided == 1);
+}
+
+TEST(EveryDrawKindIsForwarded) {
+    RecordingSink sink;
+    StateCache cache(sink);
+    for (int i = 0; i < 2; ++i) {
+        cache.Draw(3, 0);
+        cache.DrawIndexed(6, 0, 0);
+        cache.DrawInstanced(3, 10, 0, 0);
+        cache.DrawIndexedInstanced(6, 10, 0, 0, 0);
+    }
+    CHECK(sink.calls.size() == 8);
+    CHECK(cache.GetStats().draws == 8);
+    CHECK(cache.GetStats().issued == 0);
+}
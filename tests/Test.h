@@ -0,0 +1,54 @@
+#pragma once
+#include <cmath>
+#include <vector>
+
+// Test Utilities
+// Minimal harness for the portable unit tests. TEST(Name) defines a test and registers it;
+// CHECK records a failure and carries on, REQUIRE records it and leaves the test. TestMain.cpp
+// runs every registered test (or those whose name contains argv[1]) and returns non-zero when
+// any check failed, which is what CTest looks at.
+namespace Test {
+
+struct Case {
+    const char* name;
+    void (*function)();
+};
+
+std::vector<Case>& Registry();
+
+// Print file:line and the failed expression, and mark the running test as failed
+void Fail(const char* file, int line, const char* expression);
+
+struct Registrar {
+    Registrar(const char* name, void (*function)()) {
+        Registry().push_back({name, function});
+    }
+};
+
+inline bool Near(double a, double b, double tolerance) {
+    return std::fabs(a - b) <= tolerance;
+}
+
+} // namespace Test
+
+#define TEST(name)                                                            \
+    static void Test##name();                                                 \
+    static Test::Registrar testRegistrar##name(#name, Test##name);            \
+    static void Test##name()
+
+#define CHECK(condition)                                                      \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            Test::Fail(__FILE__, __LINE__, #condition);                       \
+        }                                                                     \
+    } while (0)
+
+#define REQUIRE(condition)                                                    \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            Test::Fail(__FILE__, __LINE__, #condition);                       \
+            return;                                                           \
+        }                                                                     \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tolerance) CHECK(Test::Near((a), (b), (tolerance)))
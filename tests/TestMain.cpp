@@ -0,0 +1,48 @@
+#include "Test.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+bool currentFailed = false;
+
+} // namespace
+
+namespace Test {
+
+std::vector<Case>& Registry() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+void Fail(const char* file, int line, const char* expression) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+    currentFailed = true;
+}
+
+} // namespace Test
+
+int main(int argc, char** argv) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    int run    = 0;
+    int failed = 0;
+    for (const Test::Case& test : Test::Registry()) {
+        if (filter && !std::strstr(test.name, filter)) {
+            continue;
+        }
+        currentFailed = false;
+        auto start    = std::chrono::steady_clock::now();
+        test.function();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                              start)
+                        .count();
+        std::printf("[%s] %s (%.1f ms)\n", currentFailed ? "FAIL" : " OK ", test.name, ms);
+        ++run;
+        failed += currentFailed ? 1 : 0;
+    }
+
+    std::printf("%d of %d tests passed\n", run - failed, run);
+    return failed == 0 && run > 0 ? 0 : 1;
+}
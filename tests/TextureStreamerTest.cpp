@@ -0,0 +1,530 @@
+#include "Test.h"
+#include "render/TextureFile.h"
+#include "render/TextureResidency.h"
+#include "render/TextureStreamer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void PutU32(std::vector<uint8_t>& bytes, size_t offset, uint32_t value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+}
+
+void PutU64(std::vector<uint8_t>& bytes, size_t offset, uint64_t value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+}
+
+// Byte i of mip m of a generated texture, distinct per texture and level
+uint8_t TexelByte(uint32_t seed, uint32_t mip, uint64_t i) {
+    return static_cast<uint8_t>(seed * 31 + mip * 7 + i);
+}
+
+// DDS with a DX10 header (dxgiFormat) or, for dxgiFormat 0, a legacy 32-bit BGRA header
+std::vector<uint8_t> MakeDds(const TextureDesc& desc, uint32_t dxgiFormat, uint32_t seed) {
+    std::vector<uint8_t> bytes(4 + 124 + (dxgiFormat ? 20 : 0), 0);
+    PutU32(bytes, 0, 0x20534444);
+    PutU32(bytes, 4, 124);
+    PutU32(bytes, 8, 0x1007 | 0x20000);
+    PutU32(bytes, 12, desc.height);
+    PutU32(bytes, 16, desc.width);
+    PutU32(bytes, 28, desc.mipCount);
+    PutU32(bytes, 76, 32);
+    if (dxgiFormat) {
+        PutU32(bytes, 80, 0x4);
+        PutU32(bytes, 84, 0x30315844); // "DX10"
+        PutU32(bytes, 128, dxgiFormat);
+        PutU32(bytes, 132, 3); // Texture2D
+        PutU32(bytes, 140, 1); // Array size
+    } else {
+        PutU32(bytes, 80, 0x41); // RGB | alpha pixels
+        PutU32(bytes, 88, 32);
+        PutU32(bytes, 92, 0x00FF0000u);
+        PutU32(bytes, 96, 0x0000FF00u);
+        PutU32(bytes, 100, 0x000000FFu);
+        PutU32(bytes, 104, 0xFF000000u);
+    }
+    for (uint32_t mip = 0; mip < desc.mipCount; ++mip) {
+        for (uint64_t i = 0; i < desc.MipBytes(mip); ++i) {
+            bytes.push_back(TexelByte(seed, mip, i));
+        }
+    }
+    return bytes;
+}
+
+// KTX2 with the levels stored coarsest first, as KTX2 writers do
+std::vector<uint8_t> MakeKtx2(const TextureDesc& desc, uint32_t vkFormat, uint32_t seed) {
+    const uint8_t identifier[12] = {
+        0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    std::vector<uint8_t> bytes(80 + desc.mipCount * 24, 0);
+    std::memcpy(bytes.data(), identifier, sizeof(identifier));
+    PutU32(bytes, 12, vkFormat);
+    PutU32(bytes, 16, 1);
+    PutU32(bytes, 20, desc.width);
+    PutU32(bytes, 24, desc.height);
+    PutU32(bytes, 36, 1); // Faces
+    PutU32(bytes, 40, desc.mipCount);
+    for (uint32_t mip = desc.mipCount; mip-- > 0;) {
+        const size_t entry = 80 + static_cast<size_t>(mip) * 24;
+        PutU64(bytes, entry, bytes.size());
+        PutU64(bytes, entry + 8, desc.MipBytes(mip));
+        PutU64(bytes, entry + 16, desc.MipBytes(mip));
+        for (uint64_t i = 0; i < desc.MipBytes(mip); ++i) {
+            bytes.push_back(TexelByte(seed, mip, i));
+        }
+    }
+    return bytes;
+}
+
+bool WriteFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && written;
+}
+
+TextureDesc Desc(TextureFormat format, uint32_t width, uint32_t height, uint32_t mipCount) {
+    TextureDesc desc;
+    desc.format   = format;
+    desc.width    = width;
+    desc.height   = height;
+    desc.mipCount = mipCount;
+    return desc;
+}
+
+// Stands in for TextureCache: checks every uploaded level and tracks the resident bytes
+class RecordingUploader : public TextureStreamer::Uploader {
+  public:
+    std::vector<uint32_t> firstMip;
+    uint64_t residentBytes    = 0;
+    uint64_t maxResidentBytes = 0;
+    bool contentsMatch        = true;
+    bool contiguous           = true;
+
+    bool UploadMips(uint32_t texture,
+                    const TextureDesc& desc,
+                    uint32_t first,
+                    uint32_t end,
+                    const uint8_t* data) override {
+        if (texture >= firstMip.size()) {
+            firstMip.resize(texture + 1, ~0u);
+        }
+        uint32_t& resident = firstMip[texture];
+        contiguous         = contiguous && end == std::min(resident, desc.mipCount);
+        for (uint32_t mip = first; mip < end; ++mip) {
+            for (uint64_t i = 0; i < desc.MipBytes(mip); ++i) {
+                contentsMatch = contentsMatch && data[i] == TexelByte(texture, mip, i);
+            }
+            data += desc.MipBytes(mip);
+            residentBytes += desc.MipBytes(mip);
+        }
+        resident         = first;
+        maxResidentBytes = std::max(maxResidentBytes, residentBytes);
+        return true;
+    }
+
+    void Evict(uint32_t texture, const TextureDesc& desc, uint32_t first) override {
+        for (uint32_t mip = firstMip[texture]; mip < first; ++mip) {
+            residentBytes -= desc.MipBytes(mip);
+        }
+        firstMip[texture] = first;
+    }
+};
+
+// Issue loads for frame and land them at once; returns the loads issued
+uint32_t RunFrame(TextureResidency& residency,
+                  uint64_t frame,
+                  uint32_t maxLoads,
+                  std::vector<TextureResidency::Eviction>& evictions) {
+    std::vector<TextureResidency::Load> loads;
+    residency.Update(frame, maxLoads, loads, evictions);
+    for (const TextureResidency::Load& load : loads) {
+        residency.OnLoaded(load);
+    }
+    return static_cast<uint32_t>(loads.size());
+}
+
+} // namespace
+
+// ========================================
+// TextureFile
+// ========================================
+
+TEST(TextureFileReadsDdsLevels) {
+    const TextureDesc desc           = Desc(TextureFormat::BC7, 256, 128, 9);
+    const std::vector<uint8_t> bytes = MakeDds(desc, 98, 3);
+    TextureFile file;
+    REQUIRE(file.Load(bytes.data(), bytes.size()));
+    CHECK(file.GetDesc().format == TextureFormat::BC7);
+    CHECK(file.GetDesc().width == 256);
+    CHECK(file.GetDesc().height == 128);
+    CHECK(file.GetDesc().mipCount == 9);
+    CHECK(file.GetDesc().MipBytes(0) == 256 * 128);
+    CHECK(file.GetDesc().MipBytes(8) == 16); // 1x1 still takes a whole block
+
+    for (uint32_t mip = 0; mip < 9; ++mip) {
+        std::vector<uint8_t> level(desc.MipBytes(mip));
+        REQUIRE(file.ReadMip(mip, level.data()));
+        bool same = true;
+        for (uint64_t i = 0; i < level.size(); ++i) {
+            same = same && level[i] == TexelByte(3, mip, i);
+        }
+        CHECK(same);
+    }
+    std::vector<uint8_t> level(16);
+    CHECK(!file.ReadMip(9, level.data()));
+
+    // Legacy BGRA masks are converted to RGBA
+    const TextureDesc bgraDesc           = Desc(TextureFormat::RGBA8, 4, 4, 3);
+    const std::vector<uint8_t> bgraBytes = MakeDds(bgraDesc, 0, 5);
+    REQUIRE(file.Load(bgraBytes.data(), bgraBytes.size()));
+    CHECK(file.GetDesc().format == TextureFormat::RGBA8);
+    level.resize(64);
+    REQUIRE(file.ReadMip(0, level.data()));
+    CHECK(level[0] == TexelByte(5, 0, 2));
+    CHECK(level[1] == TexelByte(5, 0, 1));
+    CHECK(level[2] == TexelByte(5, 0, 0));
+    CHECK(level[3] == TexelByte(5, 0, 3));
+}
+
+TEST(TextureFileReadsKtx2LevelsInAnyOrder) {
+    const TextureDesc desc           = Desc(TextureFormat::BC1, 64, 64, 7);
+    const std::vector<uint8_t> bytes = MakeKtx2(desc, 131, 9);
+    TextureFile file;
+    REQUIRE(file.Load(bytes.data(), bytes.size()));
+    CHECK(file.GetDesc().format == TextureFormat::BC1);
+    CHECK(file.GetDesc().mipCount == 7);
+    CHECK(file.GetStoredSize(0) == 64 / 4 * 64 / 4 * 8);
+    for (uint32_t mip = 0; mip < 7; ++mip) {
+        std::vector<uint8_t> level(desc.MipBytes(mip));
+        REQUIRE(file.ReadMip(mip, level.data()));
+        CHECK(level.front() == TexelByte(9, mip, 0));
+        CHECK(level.back() == TexelByte(9, mip, level.size() - 1));
+    }
+}
+
+TEST(TextureFileRejectsUnsupportedAndDamagedFiles) {
+    const TextureDesc desc = Desc(TextureFormat::BC7, 64, 64, 7);
+    TextureFile file;
+
+    std::vector<uint8_t> bytes = MakeDds(desc, 98, 1);
+    bytes.pop_back(); // Truncated last level
+    CHECK(!file.Load(bytes.data(), bytes.size()));
+
+    bytes = MakeDds(desc, 98, 1);
+    PutU32(bytes, 112, 0x200); // Cube map
+    CHECK(!file.Load(bytes.data(), bytes.size()));
+
+    bytes = MakeDds(desc, 98, 1);
+    PutU32(bytes, 140, 6); // Array of six
+    CHECK(!file.Load(bytes.data(), bytes.size()));
+
+    bytes = MakeDds(desc, 2, 1); // R32G32B32A32_FLOAT
+    CHECK(!file.Load(bytes.data(), bytes.size()));
+
+    bytes = MakeDds(Desc(TextureFormat::BC7, 64, 64, 8), 98, 1); // More levels than 64 -> 1
+    CHECK(!file.Load(bytes.data(), bytes.size()));
+
+    bytes = MakeKtx2(desc, 145, 1);
+    PutU64(bytes, 80 + 8, 100); // Level 0 size does not match the format
+    CHECK(!file.Load(bytes.data(), bytes.size()));
+
+    bytes = MakeKtx2(desc, 145, 1);
+    PutU32(bytes, 44, 2); // Zstandard supercompression
+    CHECK(!file.Load(bytes.data(), bytes.size()));
+
+    bytes = MakeKtx2(desc, 145, 1);
+    bytes[5] = 'x'; // Not a KTX2 identifier
+    CHECK(!file.Load(bytes.data(), bytes.size()));
+    CHECK(file.GetDesc().mipCount == 0);
+
+    CHECK(!file.Open("TextureStreamerTest.missing"));
+}
+
+// ========================================
+// TextureResidency
+// ========================================
+
+TEST(ResidencyLoadsTheTailThenOneLevelAtATime) {
+    // 1024x1024 BC7 (one byte per texel): the tail is mips 4 (64x64) to 10
+    const TextureDesc desc = Desc(TextureFormat::BC7, 1024, 1024, 11);
+    TextureResidency residency(64ull * 1024 * 1024);
+    const uint32_t texture = residency.Add(desc);
+    CHECK(residency.GetFirstResident(texture) == 11);
+
+    std::vector<TextureResidency::Load> loads;
+    std::vector<TextureResidency::Eviction> evictions;
+    residency.Request(texture, 0, 0);
+    residency.Update(0, 8, loads, evictions);
+    REQUIRE(loads.size() == 1);
+    CHECK(loads[0].firstMip == 4);
+    CHECK(loads[0].endMip == 11);
+    CHECK(loads[0].bytes == 4096 + 1024 + 256 + 64 + 16 + 16 + 16);
+    CHECK(residency.GetStats().pendingBytes == loads[0].bytes);
+
+    // One load in flight per texture
+    std::vector<TextureResidency::Load> more;
+    residency.Request(texture, 0, 1);
+    residency.Update(1, 8, more, evictions);
+    CHECK(more.empty());
+    residency.OnLoaded(loads[0]);
+    CHECK(residency.GetFirstResident(texture) == 4);
+
+    for (uint32_t mip = 4; mip-- > 0;) {
+        loads.clear();
+        residency.Request(texture, 0, 2 + mip);
+        residency.Update(2 + mip, 8, loads, evictions);
+        REQUIRE(loads.size() == 1);
+        CHECK(loads[0].firstMip == mip);
+        CHECK(loads[0].endMip == mip + 1);
+        CHECK(loads[0].bytes == desc.MipBytes(mip));
+        residency.OnLoaded(loads[0]);
+    }
+    CHECK(residency.GetFirstResident(texture) == 0);
+    CHECK(residency.GetStats().residentBytes == residency.GetStats().bytesLoaded);
+    CHECK(evictions.empty());
+
+    // Only what is asked for: a texture sampled at mip 2 stops there
+    const uint32_t second = residency.Add(desc);
+    for (uint64_t frame = 10; frame < 20; ++frame) {
+        residency.Request(second, 2, frame);
+        RunFrame(residency, frame, 8, evictions);
+    }
+    CHECK(residency.GetFirstResident(second) == 2);
+    residency.Request(second, 2, 20);
+    residency.Request(second, 3, 20);
+    CHECK(residency.GetStats().hits >= 2);
+}
+
+TEST(ResidencyLoadsSmallestFirstAndFailsCleanly) {
+    TextureResidency residency(64ull * 1024 * 1024);
+    const uint32_t large = residency.Add(Desc(TextureFormat::BC7, 1024, 1024, 11));
+    const uint32_t small = residency.Add(Desc(TextureFormat::BC7, 128, 64, 8));
+    std::vector<TextureResidency::Eviction> evictions;
+    residency.Request(large, 0, 0);
+    residency.Request(small, 0, 0);
+    CHECK(RunFrame(residency, 0, 8, evictions) == 2); // Both tails
+
+    // With one load a frame, the small texture's 128x64 level (8 KB) goes before the large
+    // one's 128x128 level (16 KB), although the large one was added first
+    std::vector<TextureResidency::Load> loads;
+    residency.Request(large, 0, 1);
+    residency.Request(small, 0, 1);
+    residency.Update(1, 1, loads, evictions);
+    REQUIRE(loads.size() == 1);
+    CHECK(loads[0].texture == small);
+    CHECK(loads[0].bytes == 128 * 64);
+
+    // A failed load stops streaming that texture and releases its pending bytes
+    residency.OnFailed(loads[0]);
+    CHECK(residency.GetStats().pendingBytes == 0);
+    CHECK(residency.GetFirstResident(small) == loads[0].endMip);
+    loads.clear();
+    residency.Request(small, 0, 2);
+    residency.Update(2, 8, loads, evictions);
+    CHECK(loads.empty());
+}
+
+TEST(ResidencyEvictsLeastRecentlyUsedDownToTheTail) {
+    // Room for one 256x256 BC7 texture in full and a second one's tail and 128x128 level
+    const TextureDesc desc = Desc(TextureFormat::BC7, 256, 256, 9);
+    const uint64_t full    = 65536 + 16384 + 4096 + 1024 + 256 + 64 + 16 + 16 + 16;
+    TextureResidency residency(full + 16384 + 5488);
+    const uint32_t a = residency.Add(desc);
+    const uint32_t b = residency.Add(desc);
+    std::vector<TextureResidency::Eviction> evictions;
+
+    uint64_t frame = 0;
+    for (; frame < 10; ++frame) {
+        residency.Request(a, 0, frame);
+        RunFrame(residency, frame, 8, evictions);
+    }
+    CHECK(residency.GetFirstResident(a) == 0);
+    CHECK(residency.GetStats().residentBytes == full);
+
+    // Only b is drawn now: a gives up its finest levels, never its tail
+    for (; frame < 20; ++frame) {
+        residency.Request(b, 0, frame);
+        RunFrame(residency, frame, 8, evictions);
+        const TextureResidency::Stats stats = residency.GetStats();
+        CHECK(stats.residentBytes + stats.pendingBytes <= residency.GetBudget());
+    }
+    CHECK(residency.GetFirstResident(b) == 0);
+    CHECK(residency.GetFirstResident(a) >= 1);
+    CHECK(residency.GetFirstResident(a) <= 2); // Tail of a 256x256 texture starts at mip 2
+    REQUIRE(!evictions.empty());
+    CHECK(evictions[0].texture == a);
+    CHECK(residency.GetStats().bytesEvicted ==
+          residency.GetStats().bytesLoaded - residency.GetStats().residentBytes);
+
+    // Lowering the budget below what is resident takes effect at the next load: b, unused
+    // now, drops to its tail, which still leaves no room for a's finest level
+    residency.SetBudget(65536 + 2 * 5488);
+    residency.Request(a, 0, frame);
+    CHECK(RunFrame(residency, frame, 8, evictions) == 0);
+    CHECK(residency.GetFirstResident(b) == 2);
+    CHECK(residency.GetStats().residentBytes <= residency.GetBudget());
+}
+
+TEST(ResidencyWorkingSetLargerThanBudget) {
+    // 32 textures all drawn at full detail every frame, with room for 8: each gets its tail,
+    // then (smallest first) 31 of them their 128x128 level, and loads stop at the budget.
+    // Nothing drawn this frame is evicted to make room for something else drawn this frame,
+    // so the set does not thrash
+    const TextureDesc desc = Desc(TextureFormat::BC7, 256, 256, 9);
+    const uint64_t full    = 65536 + 16384 + 5488;
+    const uint64_t budget  = 8 * full;
+    TextureResidency residency(budget);
+    for (uint32_t i = 0; i < 32; ++i) {
+        residency.Add(desc);
+    }
+    std::vector<TextureResidency::Eviction> evictions;
+    uint32_t loadsLastFrame = 0;
+    bool withinBudget       = true;
+    uint64_t frame          = 0;
+    for (; frame < 100; ++frame) {
+        for (uint32_t i = 0; i < 32; ++i) {
+            residency.Request(i, 0, frame);
+        }
+        loadsLastFrame                      = RunFrame(residency, frame, 8, evictions);
+        const TextureResidency::Stats stats = residency.GetStats();
+        withinBudget = withinBudget && stats.residentBytes + stats.pendingBytes <= budget;
+    }
+    CHECK(withinBudget);
+    CHECK(loadsLastFrame == 0);
+    CHECK(evictions.empty());
+    uint32_t refined = 0;
+    for (uint32_t i = 0; i < 32; ++i) {
+        CHECK(residency.GetFirstResident(i) <= 2);
+        refined += residency.GetFirstResident(i) == 1;
+    }
+    CHECK(refined == 31);
+    CHECK(residency.GetStats().residentBytes > budget - 16384); // Filled up
+
+    // The camera turns: only the last 6 are drawn, and they take over the budget from the
+    // ones behind it, which give up their finer levels
+    for (; frame < 200; ++frame) {
+        for (uint32_t i = 26; i < 32; ++i) {
+            residency.Request(i, 0, frame);
+        }
+        RunFrame(residency, frame, 8, evictions);
+        const TextureResidency::Stats stats = residency.GetStats();
+        withinBudget = withinBudget && stats.residentBytes + stats.pendingBytes <= budget;
+    }
+    CHECK(withinBudget);
+    CHECK(!evictions.empty());
+    for (uint32_t i = 26; i < 32; ++i) {
+        CHECK(residency.GetFirstResident(i) == 0);
+    }
+    for (uint32_t i = 0; i < 26; ++i) {
+        CHECK(residency.GetFirstResident(i) >= 1);
+        CHECK(residency.GetFirstResident(i) <= 2);
+    }
+}
+
+// ========================================
+// TextureStreamer
+// ========================================
+
+TEST(StreamerLoadsFilesOnLoaderThreads) {
+    // Eight files of 64 to 512 texels, DDS and KTX2 alternately; file i holds seed i
+    std::vector<std::string> paths;
+    TextureStreamer streamer;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < 8; ++i) {
+        const uint32_t size    = 64u << (i % 4);
+        const TextureDesc desc = Desc(TextureFormat::BC7, size, size, 1 + 6 + i % 4);
+        const std::string path = "TextureStreamerTest." + std::to_string(i) +
+                                 (i % 2 ? ".ktx2" : ".dds");
+        REQUIRE(WriteFile(path, i % 2 ? MakeKtx2(desc, 145, i) : MakeDds(desc, 98, i)));
+        paths.push_back(path);
+        CHECK(streamer.Add(path) == i);
+        for (uint32_t mip = 0; mip < desc.mipCount; ++mip) {
+            total += desc.MipBytes(mip);
+        }
+    }
+    CHECK(streamer.Add("TextureStreamerTest.missing") == TextureStreamer::InvalidTexture);
+
+    TextureStreamer::Settings settings;
+    settings.budgetBytes      = total;
+    settings.threadCount      = 2;
+    settings.maxLoadsPerFrame = 4;
+    REQUIRE(streamer.Start(settings));
+    RecordingUploader uploader;
+    bool complete = false;
+    for (int frame = 0; frame < 2000 && !complete; ++frame) {
+        complete = true;
+        for (uint32_t i = 0; i < 8; ++i) {
+            streamer.Request(i, 0);
+            complete = complete && streamer.GetResidentMip(i) == 0;
+        }
+        streamer.Update(uploader);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    streamer.Stop();
+    for (const std::string& path : paths) {
+        std::remove(path.c_str());
+    }
+
+    CHECK(complete);
+    CHECK(uploader.contentsMatch);
+    CHECK(uploader.contiguous);
+    CHECK(uploader.residentBytes == total);
+    CHECK(streamer.GetStats().residentBytes == total);
+    CHECK(streamer.GetStats().pendingBytes == 0);
+}
+
+TEST(StreamerStaysWithinABudgetSmallerThanTheWorkingSet) {
+    // Sixteen 256x256 textures, drawn in a window of eight that moves every 20 frames, with
+    // room for about four in full
+    const TextureDesc desc = Desc(TextureFormat::BC7, 256, 256, 9);
+    std::vector<std::string> paths;
+    TextureStreamer streamer;
+    for (uint32_t i = 0; i < 16; ++i) {
+        const std::string path = "TextureStreamerTest.budget." + std::to_string(i) + ".dds";
+        REQUIRE(WriteFile(path, MakeDds(desc, 98, i)));
+        paths.push_back(path);
+        REQUIRE(streamer.Add(path) == i);
+    }
+
+    TextureStreamer::Settings settings;
+    settings.budgetBytes = 4 * (65536 + 16384 + 5488);
+    settings.threadCount = 2;
+    REQUIRE(streamer.Start(settings));
+    RecordingUploader uploader;
+    bool withinBudget = true;
+    for (uint32_t frame = 0; frame < 400; ++frame) {
+        const uint32_t first = frame / 20 % 16;
+        for (uint32_t i = 0; i < 8; ++i) {
+            streamer.Request((first + i) % 16, 0);
+        }
+        streamer.Update(uploader);
+        const TextureResidency::Stats stats = streamer.GetStats();
+        const uint64_t used                 = stats.residentBytes + stats.pendingBytes;
+        withinBudget                        = withinBudget && used <= settings.budgetBytes;
+        if (frame % 4 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    streamer.Stop();
+    for (const std::string& path : paths) {
+        std::remove(path.c_str());
+    }
+
+    const TextureResidency::Stats stats = streamer.GetStats();
+    CHECK(withinBudget);
+    CHECK(uploader.maxResidentBytes <= settings.budgetBytes);
+    CHECK(uploader.residentBytes == stats.residentBytes);
+    CHECK(uploader.contentsMatch);
+    CHECK(uploader.contiguous);
+    CHECK(stats.evictions > 0);
+    CHECK(stats.hits > 0);
+    CHECK(stats.hits < stats.requests);
+}
@@ -0,0 +1,272 @@
+#include "Test.h"
+#include "scene/TransformHierarchy.h"
+#include "threading/JobSystem.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+enum class Shape { Random, Deep, Wide };
+
+// A turn about z, a slight scale and an offset: stays well conditioned through deep chains
+Float4x4 RandomLocal(std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const float angle = unit(rng) * 3.14159265f;
+    const float scale = 1.0f + unit(rng) * 0.01f;
+    const float c     = std::cos(angle) * scale;
+    const float s     = std::sin(angle) * scale;
+    return {{{c, s, 0.0f, 0.0f},
+             {-s, c, 0.0f, 0.0f},
+             {0.0f, 0.0f, scale, 0.0f},
+             {unit(rng), unit(rng), unit(rng), 1.0f}}};
+}
+
+/*
+The hierarchy under test beside the same forest as a plain tree: parents, locals and
+child lists by node id, with world matrices computed by recursion from the roots
+*/
+struct Forest {
+    TransformHierarchy hierarchy;
+    std::vector<uint32_t> parents;
+    std::vector<Float4x4> locals;
+    std::vector<std::vector<uint32_t>> children;
+    std::vector<Float4x4> reference;
+
+    void Add(uint32_t parent, const Float4x4& local) {
+        const uint32_t node = hierarchy.AddNode(parent, local);
+        parents.push_back(parent);
+        locals.push_back(local);
+        children.emplace_back();
+        if (parent != TransformHierarchy::InvalidNode) {
+            children[parent].push_back(node);
+        }
+    }
+
+    void Build(Shape shape, uint32_t count, std::mt19937& rng) {
+        for (uint32_t node = 0; node < count; ++node) {
+            uint32_t parent = TransformHierarchy::InvalidNode;
+            if (shape == Shape::Deep && node > 0) {
+                parent = node % 64 == 0 ? node - 64 : node - 1; // Long chains with side chains
+            } else if (shape == Shape::Wide && node > 0) {
+                parent = node < 8 ? 0 : static_cast<uint32_t>(rng() % 8);
+            } else if (shape == Shape::Random && node >= 16) {
+                parent = static_cast<uint32_t>(rng() % node); // 16 roots, then random trees
+            }
+            Add(parent, RandomLocal(rng));
+        }
+    }
+
+    void Visit(uint32_t node, const Float4x4* parentWorld) {
+        reference[node] = parentWorld ? Float4x4::Multiply(locals[node], *parentWorld)
+                                      : locals[node];
+        for (uint32_t child : children[node]) {
+            Visit(child, &reference[node]);
+        }
+    }
+
+    void ComputeReference() {
+        reference.assign(parents.size(), Float4x4::Identity());
+        for (uint32_t node = 0; node < parents.size(); ++node) {
+            if (parents[node] == TransformHierarchy::InvalidNode) {
+                Visit(node, nullptr);
+            }
+        }
+    }
+
+    bool MatchesReference() const {
+        for (uint32_t node = 0; node < parents.size(); ++node) {
+            const Float4x4& world = hierarchy.GetWorld(node);
+            for (int row = 0; row < 4; ++row) {
+                for (int column = 0; column < 4; ++column) {
+                    const float expected   = reference[node].m[row][column];
+                    const double tolerance = 1e-4 * (1.0 + std::fabs(expected));
+                    if (!Test::Near(world.m[row][column], expected, tolerance)) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // Every node with a moved ancestor (or itself moved) lies in the change list
+    bool ChangesCover(const std::vector<uint8_t>& moved, uint32_t recomputed) const {
+        const std::vector<TransformHierarchy::Range>& ranges = hierarchy.GetChangedRanges();
+        uint32_t total = 0;
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            const bool ordered = i == 0 || ranges[i - 1].end <= ranges[i].begin;
+            if (ranges[i].begin >= ranges[i].end || !ordered) {
+                return false;
+            }
+            total += ranges[i].end - ranges[i].begin;
+        }
+        if (total != recomputed) {
+            return false;
+        }
+
+        std::vector<uint8_t> covered(parents.size(), 0);
+        for (const TransformHierarchy::Range& range : ranges) {
+            for (uint32_t slot = range.begin; slot < range.end; ++slot) {
+                covered[hierarchy.GetSlotNode(slot)] = 1;
+            }
+        }
+        for (uint32_t node = 0; node < parents.size(); ++node) {
+            bool affected = false;
+            for (uint32_t n = node; n != TransformHierarchy::InvalidNode; n = parents[n]) {
+                affected = affected || moved[n];
+            }
+            if (affected && !covered[node]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Move count random nodes, update and check against the reference; false on any mismatch
+    bool Frame(uint32_t count, std::mt19937& rng) {
+        std::vector<uint8_t> moved(parents.size(), 0);
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t node = static_cast<uint32_t>(rng() % parents.size());
+            locals[node]        = RandomLocal(rng);
+            moved[node]         = 1;
+            hierarchy.SetLocal(node, locals[node]);
+        }
+        const uint32_t recomputed = hierarchy.Update();
+        ComputeReference();
+        return !hierarchy.WasRelayout() && MatchesReference() && ChangesCover(moved, recomputed);
+    }
+};
+
+// The layout invariants: parents before children, subtrees contiguous and nested
+bool LayoutIsDepthFirst(const Forest& forest) {
+    const TransformHierarchy& hierarchy = forest.hierarchy;
+    for (uint32_t node = 0; node < forest.parents.size(); ++node) {
+        const uint32_t slot = hierarchy.GetSlot(node);
+        if (hierarchy.GetSlotNode(slot) != node) {
+            return false;
+        }
+        if (forest.parents[node] != TransformHierarchy::InvalidNode &&
+            hierarchy.GetSlot(forest.parents[node]) >= slot) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CheckShape(Shape shape, uint32_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    Forest forest;
+    forest.Build(shape, count, rng);
+    const uint32_t recomputed = forest.hierarchy.Update();
+    forest.ComputeReference();
+    CHECK(recomputed == count);
+    CHECK(forest.hierarchy.WasRelayout());
+    CHECK(LayoutIsDepthFirst(forest));
+    CHECK(forest.MatchesReference());
+
+    // A few nodes (sorted marks), then past 1/16 of them (flag scan), then none
+    const uint32_t moves[] = {1, 7, count / 100, count / 8, count, 0};
+    for (uint32_t frame = 0; frame < 6; ++frame) {
+        CHECK(forest.Frame(moves[frame], rng));
+    }
+    CHECK(forest.hierarchy.GetChangedRanges().empty());
+}
+
+} // namespace
+
+TEST(TransformHierarchyMatchesRecursionOnRandomForests) {
+    CheckShape(Shape::Random, 20000, 1);
+}
+
+TEST(TransformHierarchyMatchesRecursionOnDeepChains) {
+    // Hundreds of levels in one tree of several TaskSize, which Update has to split
+    CheckShape(Shape::Deep, 3 * TransformHierarchy::TaskSize, 2);
+}
+
+TEST(TransformHierarchyMatchesRecursionOnWideTrees) {
+    CheckShape(Shape::Wide, 20000, 3);
+}
+
+TEST(TransformHierarchyMergesNestedAndAdjacentChanges) {
+    // 0 -> 1 -> 2, 0 -> 3, 4
+    std::mt19937 rng(4);
+    Forest forest;
+    forest.Add(TransformHierarchy::InvalidNode, RandomLocal(rng));
+    forest.Add(0, RandomLocal(rng));
+    forest.Add(1, RandomLocal(rng));
+    forest.Add(0, RandomLocal(rng));
+    forest.Add(TransformHierarchy::InvalidNode, RandomLocal(rng));
+    forest.hierarchy.Update();
+    const TransformHierarchy& hierarchy = forest.hierarchy;
+
+    // A child marked with its ancestor is covered by the ancestor's subtree
+    forest.hierarchy.SetLocal(2, RandomLocal(rng));
+    forest.hierarchy.SetLocal(0, RandomLocal(rng));
+    CHECK(forest.hierarchy.Update() == 4);
+    REQUIRE(hierarchy.GetChangedRanges().size() == 1);
+    CHECK(hierarchy.GetChangedRanges()[0].begin == 0);
+    CHECK(hierarchy.GetChangedRanges()[0].end == 4);
+
+    // Touching subtrees merge into one range; a lone leaf is a range of one
+    forest.hierarchy.SetLocal(3, RandomLocal(rng));
+    forest.hierarchy.SetLocal(4, RandomLocal(rng));
+    CHECK(forest.hierarchy.Update() == 2);
+    REQUIRE(hierarchy.GetChangedRanges().size() == 1);
+    CHECK(hierarchy.GetChangedRanges()[0].begin == hierarchy.GetSlot(3));
+    CHECK(hierarchy.GetChangedRanges()[0].end == 5);
+    forest.hierarchy.SetLocal(2, RandomLocal(rng));
+    forest.hierarchy.SetLocal(2, RandomLocal(rng)); // Marked once
+    CHECK(forest.hierarchy.Update() == 1);
+    CHECK(hierarchy.GetChangedRanges().size() == 1);
+
+    // Parents must exist first
+    CHECK(forest.hierarchy.AddNode(7) == TransformHierarchy::InvalidNode);
+    CHECK(forest.hierarchy.GetNodeCount() == 5);
+}
+
+TEST(TransformHierarchyRelayoutKeepsIdsAndLocals) {
+    std::mt19937 rng(5);
+    Forest forest;
+    forest.Build(Shape::Random, 5000, rng);
+    forest.hierarchy.Update();
+    CHECK(forest.Frame(50, rng));
+
+    // Children added under early nodes land inside their subtrees after the next Update
+    for (uint32_t i = 0; i < 500; ++i) {
+        forest.Add(static_cast<uint32_t>(rng() % 64), RandomLocal(rng));
+    }
+    forest.hierarchy.SetLocal(10, forest.locals[10] = RandomLocal(rng));
+    CHECK(forest.hierarchy.Update() == 5500);
+    CHECK(forest.hierarchy.WasRelayout());
+    REQUIRE(forest.hierarchy.GetChangedRanges().size() == 1);
+    CHECK(LayoutIsDepthFirst(forest));
+    forest.ComputeReference();
+    CHECK(forest.MatchesReference());
+    bool localsKept = true;
+    for (uint32_t node = 0; node < 5500; ++node) {
+        localsKept = localsKept &&
+                     forest.hierarchy.GetLocal(node).m[3][0] == forest.locals[node].m[3][0];
+    }
+    CHECK(localsKept);
+    CHECK(forest.Frame(200, rng));
+
+    forest.hierarchy.Clear();
+    CHECK(forest.hierarchy.GetNodeCount() == 0);
+    CHECK(forest.hierarchy.Update() == 0);
+}
+
+TEST(TransformHierarchyParallelUpdateMatchesSerial) {
+    std::mt19937 rng(6);
+    Forest forest;
+    forest.Build(Shape::Random, 100000, rng);
+    JobSystem jobSystem;
+    jobSystem.Initialize();
+    forest.hierarchy.SetParallelFor(jobSystem.GetTaskExecutor());
+    forest.hierarchy.Update();
+    forest.ComputeReference();
+    CHECK(forest.MatchesReference());
+    CHECK(forest.Frame(1000, rng));
+    CHECK(forest.Frame(100000, rng));
+    jobSystem.Shutdown();
+}
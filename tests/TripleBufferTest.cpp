@@ -0,0 +1,216 @@
+#include "Test.h"
+#include "scene/Simulation.h"
+#include "threading/SpscQueue.h"
+#include "threading/TripleBuffer.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+// The stress tests are meant to be run under ThreadSanitizer as well
+// (cmake -DSANITIZE=thread); they check ordering and tearing themselves either way
+
+namespace {
+
+// A value spread over a cache line, so a torn read shows up as mismatched words
+struct Payload {
+    uint64_t sequence = 0;
+    uint64_t words[7] = {};
+
+    void Fill(uint64_t value) {
+        sequence = value;
+        for (uint64_t& word : words) {
+            word = value * 0x9E3779B97F4A7C15ull;
+        }
+    }
+    bool Intact() const {
+        for (uint64_t word : words) {
+            if (word != sequence * 0x9E3779B97F4A7C15ull) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+const uint64_t StressCount = 1000000;
+
+} // namespace
+
+TEST(TripleBufferHandsOverTheLatestValue) {
+    TripleBuffer<int> buffer;
+    CHECK(!buffer.Update());
+    CHECK(buffer.GetReadBuffer() == 0);
+
+    buffer.GetWriteBuffer() = 1;
+    buffer.Publish();
+    CHECK(buffer.Update());
+    CHECK(buffer.GetReadBuffer() == 1);
+    CHECK(!buffer.Update()); // Nothing new: the read value stays
+    CHECK(buffer.GetReadBuffer() == 1);
+
+    // Values the reader missed are skipped, not queued
+    for (int value = 2; value <= 5; ++value) {
+        buffer.GetWriteBuffer() = value;
+        buffer.Publish();
+    }
+    CHECK(buffer.Update());
+    CHECK(buffer.GetReadBuffer() == 5);
+    CHECK(!buffer.Update());
+
+    // The writer never holds the slot the reader is looking at
+    CHECK(&buffer.GetWriteBuffer() != &buffer.GetReadBuffer());
+}
+
+TEST(TripleBufferStressIsMonotonicAndUntorn) {
+    TripleBuffer<Payload> buffer;
+    std::thread writer([&buffer] {
+        for (uint64_t i = 1; i <= StressCount; ++i) {
+            buffer.GetWriteBuffer().Fill(i);
+            buffer.Publish();
+        }
+    });
+
+    uint64_t last  = 0;
+    uint64_t reads = 0;
+    bool ordered   = true;
+    bool intact    = true;
+    while (last < StressCount) {
+        if (!buffer.Update()) {
+            std::this_thread::yield();
+            continue;
+        }
+        const Payload& payload = buffer.GetReadBuffer();
+        ordered                = ordered && payload.sequence > last;
+        intact                 = intact && payload.Intact();
+        last                   = payload.sequence;
+        ++reads;
+    }
+    writer.join();
+    CHECK(ordered);
+    CHECK(intact);
+    CHECK(last == StressCount); // The final publish is always picked up
+    CHECK(reads > 0);
+}
+
+TEST(SpscQueueIsFifoAndBounded) {
+    SpscQueue<uint32_t, 8> queue;
+    uint32_t item = 0;
+    CHECK(!queue.Pop(item));
+    for (uint32_t i = 0; i < 8; ++i) {
+        CHECK(queue.Push(i));
+    }
+    CHECK(!queue.Push(8)); // Full
+    CHECK(queue.GetSize() == 8);
+
+    // Indices wrap around the ring many times
+    for (uint32_t i = 0; i < 1000; ++i) {
+        REQUIRE(queue.Pop(item));
+        CHECK(item == i);
+        CHECK(queue.Push(i + 8));
+    }
+    CHECK(queue.GetSize() == 8);
+    for (uint32_t i = 1000; i < 1008; ++i) {
+        REQUIRE(queue.Pop(item));
+        CHECK(item == i);
+    }
+    CHECK(!queue.Pop(item));
+    CHECK(queue.GetSize() == 0);
+}
+
+TEST(SpscQueueStressDeliversEverythingInOrder) {
+    SpscQueue<Payload, 1024> queue;
+    std::thread producer([&queue] {
+        Payload payload;
+        for (uint64_t i = 1; i <= StressCount; ++i) {
+            payload.Fill(i);
+            while (!queue.Push(payload)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 1;
+    bool ordered      = true;
+    bool intact       = true;
+    Payload payload;
+    while (expected <= StressCount) {
+        if (!queue.Pop(payload)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && payload.sequence == expected;
+        intact  = intact && payload.Intact();
+        ++expected;
+    }
+    producer.join();
+    CHECK(ordered);
+    CHECK(intact);
+    CHECK(!queue.Pop(payload));
+}
+
+TEST(SimulationStepAndLerp) {
+    // One second of "right" and "up" held moves a unit each way, clamped to the screen
+    SceneState state;
+    for (int i = 0; i < 60; ++i) {
+        Simulation::Step(state, 0x6, 1.0f / 60.0f);
+    }
+    CHECK_NEAR(state.position[0], 1.0, 1e-4);
+    CHECK_NEAR(state.position[1], 1.0, 1e-4);
+    CHECK_NEAR(state.angle, Simulation::SpinSpeed, 1e-4);
+    Simulation::Step(state, 0x4, 1.0f);
+    CHECK(state.position[0] == 1.0f);
+
+    // Angles interpolate across the wrap the short way, and stay in [-pi, pi)
+    SceneState a;
+    SceneState b;
+    a.angle              = 3.0f;
+    b.angle              = -3.0f;
+    const SceneState mid = SceneState::Lerp(a, b, 0.5f);
+    CHECK(std::fabs(mid.angle) > 3.1f);
+    CHECK(mid.angle >= -3.14159266f);
+    CHECK(mid.angle < 3.14159266f);
+    b.position[0] = 1.0f;
+    CHECK_NEAR(SceneState::Lerp(a, b, 0.25f).position[0], 0.25, 1e-6);
+}
+
+TEST(SimulationRunsAlongsideInputAndRenderThreads) {
+    // A 1 kHz simulation with a window thread pushing key events and this thread sampling
+    Simulation simulation;
+    REQUIRE(simulation.Start(1000.0));
+    std::atomic<bool> done{false};
+    uint64_t pushed = 0;
+    std::thread window([&] {
+        std::unique_ptr<PacingClock> clock = PacingClock::CreateSystemClock();
+        for (uint32_t i = 0; i < 200; ++i) {
+            InputEvent event;
+            event.type = i % 2 ? InputEvent::KeyUp : InputEvent::KeyDown;
+            event.key  = 0x27; // VK_RIGHT
+            event.time = clock->Now();
+            pushed += simulation.GetInputQueue().Push(event);
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+        done.store(true);
+    });
+
+    uint64_t lastTick = 0;
+    bool monotonic    = true;
+    while (!done.load()) {
+        simulation.Sample();
+        const uint64_t tick = simulation.GetSnapshot().tick;
+        monotonic           = monotonic && tick >= lastTick;
+        lastTick            = tick;
+        std::this_thread::yield();
+    }
+    window.join();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Let the last events drain
+    simulation.Stop();
+
+    const Simulation::Stats stats = simulation.GetStats();
+    CHECK(monotonic);
+    CHECK(pushed == 200);
+    CHECK(stats.inputs == pushed);
+    CHECK(stats.ticks > 50);
+    CHECK(simulation.GetSnapshot().current.position[0] >= 0.0f);
+    CHECK(simulation.GetSnapshot().current.position[0] <= 1.0f);
+}
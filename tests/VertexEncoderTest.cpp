@@ -0,0 +1,209 @@
+#include "Test.h"
+#include "render/VertexEncoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+// count vertices with positions and colors slightly past their range, so clamping is hit
+std::vector<Vertex> MakeVertices(uint32_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-1.1f, 1.1f);
+    std::uniform_real_distribution<float> color(-0.1f, 1.1f);
+    std::vector<Vertex> vertices(count);
+    for (Vertex& vertex : vertices) {
+        for (float& value : vertex.position) {
+            value = position(rng);
+        }
+        for (float& value : vertex.color) {
+            value = color(rng);
+        }
+    }
+    return vertices;
+}
+
+// count float3 normals, not normalized, covering both hemispheres and the axes
+std::vector<float> MakeNormals(uint32_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(-2.0f, 2.0f);
+    std::vector<float> normals(count * 3);
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t c = 0; c < 3; ++c) {
+            normals[i * 3 + c] = i % 7 == 0 ? (i / 7 % 3 == c ? 1.0f : 0.0f) : unit(rng);
+        }
+    }
+    return normals;
+}
+
+// In double: near 0 degrees a float acos is off by more than the error being measured
+double AngleDegrees(const float a[3], const float b[3]) {
+    double dot = 0.0, lengthA = 0.0, lengthB = 0.0;
+    for (int c = 0; c < 3; ++c) {
+        dot += static_cast<double>(a[c]) * b[c];
+        lengthA += static_cast<double>(a[c]) * a[c];
+        lengthB += static_cast<double>(b[c]) * b[c];
+    }
+    double cosine = std::min(std::max(dot / std::sqrt(lengthA * lengthB), -1.0), 1.0);
+    return std::acos(cosine) * (180.0 / 3.14159265358979);
+}
+
+// Counts around the four-wide loops, so the scalar tails are covered too
+const uint32_t Counts[] = {0, 1, 3, 4, 5, 7, 8, 9, 1001};
+
+} // namespace
+
+TEST(SingleValuesRoundAndClamp) {
+    CHECK(VertexEncoder::EncodeSNorm16(1.0f) == 32767);
+    CHECK(VertexEncoder::EncodeSNorm16(-1.0f) == -32767);
+    CHECK(VertexEncoder::EncodeSNorm16(0.0f) == 0);
+    CHECK(VertexEncoder::EncodeSNorm16(2.0f) == 32767);
+    CHECK(VertexEncoder::EncodeSNorm16(-2.0f) == -32767);
+    CHECK(VertexEncoder::EncodeSNorm16(1.0f / 32767.0f) == 1);
+
+    CHECK(VertexEncoder::EncodeUNorm8(0.0f) == 0);
+    CHECK(VertexEncoder::EncodeUNorm8(1.0f) == 255);
+    CHECK(VertexEncoder::EncodeUNorm8(-0.5f) == 0);
+    CHECK(VertexEncoder::EncodeUNorm8(1.5f) == 255);
+    CHECK(VertexEncoder::EncodeUNorm8(100.0f / 255.0f) == 100);
+
+    // -32768 is the one code below -1 and decodes to -1 as well
+    CHECK(VertexEncoder::DecodeSNorm16(32767) == 1.0f);
+    CHECK(VertexEncoder::DecodeSNorm16(-32767) == -1.0f);
+    CHECK(VertexEncoder::DecodeSNorm16(-32768) == -1.0f);
+}
+
+TEST(PackedVertexIsTwelveBytes) {
+    CHECK(sizeof(PackedVertex) == 12);
+    CHECK(offsetof(PackedVertex, color) == 8);
+}
+
+TEST(SimdPositionsAndColorsMatchScalar) {
+    for (uint32_t count : Counts) {
+        std::vector<Vertex> vertices = MakeVertices(count, count + 1);
+        std::vector<PackedVertex> expected(count);
+        std::vector<PackedVertex> actual(count);
+        uint8_t* expectedBytes = reinterpret_cast<uint8_t*>(expected.data());
+        uint8_t* actualBytes   = reinterpret_cast<uint8_t*>(actual.data());
+        if (count > 0) {
+            VertexEncoder::EncodeSNorm16x4Scalar(vertices[0].position,
+                                                 sizeof(Vertex),
+                                                 count,
+                                                 expectedBytes + offsetof(PackedVertex, position),
+                                                 sizeof(PackedVertex));
+            VertexEncoder::EncodeUNorm8x4Scalar(vertices[0].color,
+                                                sizeof(Vertex),
+                                                count,
+                                                expectedBytes + offsetof(PackedVertex, color),
+                                                sizeof(PackedVertex));
+        }
+        VertexEncoder::EncodeVertices(vertices.data(), count, actual.data());
+        CHECK(count == 0 || std::memcmp(actualBytes, expectedBytes, count * sizeof(PackedVertex)) == 0);
+    }
+}
+
+TEST(SimdNormalsMatchScalar) {
+    for (uint32_t count : Counts) {
+        std::vector<float> normals = MakeNormals(count, count + 1);
+        std::vector<SNorm16x2> expected(count);
+        std::vector<SNorm16x2> actual(count);
+        VertexEncoder::EncodeOctahedralScalar(normals.data(),
+                                              3 * sizeof(float),
+                                              count,
+                                              expected.data(),
+                                              sizeof(SNorm16x2));
+        VertexEncoder::EncodeOctahedral(normals.data(),
+                                        3 * sizeof(float),
+                                        count,
+                                        actual.data(),
+                                        sizeof(SNorm16x2));
+        CHECK(count == 0 || std::memcmp(actual.data(), expected.data(), count * sizeof(SNorm16x2)) == 0);
+    }
+}
+
+TEST(StridesOnlyTouchTheirMember) {
+    // Positions written into every other 16-byte slot leave the bytes in between alone
+    const uint32_t count           = 13;
+    std::vector<Vertex> vertices   = MakeVertices(count, 5);
+    const size_t destinationStride = 16;
+    std::vector<uint8_t> bytes(count * destinationStride, 0xCD);
+    VertexEncoder::EncodeSNorm16x4(vertices[0].position,
+                                   sizeof(Vertex),
+                                   count,
+                                   bytes.data(),
+                                   destinationStride);
+    for (uint32_t i = 0; i < count; ++i) {
+        int16_t encoded[4];
+        std::memcpy(encoded, &bytes[i * destinationStride], sizeof(encoded));
+        for (int c = 0; c < 3; ++c) {
+            CHECK(encoded[c] == VertexEncoder::EncodeSNorm16(vertices[i].position[c]));
+        }
+        CHECK(encoded[3] == 32767);
+        for (size_t b = sizeof(encoded); b < destinationStride; ++b) {
+            CHECK(bytes[i * destinationStride + b] == 0xCD);
+        }
+    }
+}
+
+TEST(QuantizationErrorIsBounded) {
+    const uint32_t count         = 10000;
+    std::vector<Vertex> vertices = MakeVertices(count, 9);
+    std::vector<PackedVertex> packed(count);
+    VertexEncoder::EncodeVertices(vertices.data(), count, packed.data());
+
+    // Half a step of each format, for values inside the range
+    float worstPosition = 0.0f;
+    float worstColor    = 0.0f;
+    for (uint32_t i = 0; i < count; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            const float value   = std::min(std::max(vertices[i].position[c], -1.0f), 1.0f);
+            const float decoded = VertexEncoder::DecodeSNorm16(packed[i].position.v[c]);
+            worstPosition       = std::max(worstPosition, std::fabs(decoded - value));
+        }
+        for (int c = 0; c < 4; ++c) {
+            const float value   = std::min(std::max(vertices[i].color[c], 0.0f), 1.0f);
+            const float decoded = packed[i].color.v[c] / 255.0f;
+            worstColor          = std::max(worstColor, std::fabs(decoded - value));
+        }
+    }
+    CHECK(worstPosition <= 0.5 / 32767.0 + 1e-7);
+    CHECK(worstColor <= 0.5 / 255.0 + 1e-7);
+}
+
+TEST(OctahedralNormalsRoundTrip) {
+    const uint32_t count       = 10000;
+    std::vector<float> normals = MakeNormals(count, 11);
+    std::vector<SNorm16x2> packed(count);
+    VertexEncoder::EncodeOctahedral(normals.data(),
+                                    3 * sizeof(float),
+                                    count,
+                                    packed.data(),
+                                    sizeof(SNorm16x2));
+
+    double worst = 0.0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const float encoded[2] = {VertexEncoder::DecodeSNorm16(packed[i].v[0]),
+                                  VertexEncoder::DecodeSNorm16(packed[i].v[1])};
+        float decoded[3];
+        VertexEncoder::OctahedralDecode(encoded, decoded);
+        CHECK_NEAR(decoded[0] * decoded[0] + decoded[1] * decoded[1] + decoded[2] * decoded[2],
+                   1.0,
+                   1e-5);
+        worst = std::max(worst, AngleDegrees(&normals[i * 3], decoded));
+    }
+    CHECK(worst < 0.01);
+
+    // Both poles survive the fold exactly
+    const float up[3]   = {0.0f, 0.0f, 1.0f};
+    const float down[3] = {0.0f, 0.0f, -1.0f};
+    float encoded[2];
+    float decoded[3];
+    VertexEncoder::OctahedralEncode(up, encoded);
+    VertexEncoder::OctahedralDecode(encoded, decoded);
+    CHECK(decoded[2] == 1.0f);
+    VertexEncoder::OctahedralEncode(down, encoded);
+    VertexEncoder::OctahedralDecode(encoded, decoded);
+    CHECK(decoded[2] == -1.0f);
+}
@@ -0,0 +1,536 @@
+// Frame Replay
+// Re-executes frames captured by Graphics (--capture-every) without a GPU, and reports how
+// often each call is made and how long the CPU side of it takes.
+//
+//   FrameReplay <frame.fcap> [--repeat N] [--log] [--save-baseline <file>]
+//               [--baseline <file>] [--threshold PERCENT]
+//
+// Calls are replayed into a null sink (--log prints each one instead) and buffer contents
+// are copied into system memory, so the timings are the cost of decoding and issuing the
+// stream. Each call is timed on its own, minus the measured cost of reading the clock, and
+// the fastest of --repeat replays (default 100) is reported. --save-baseline writes the
+// counts and times to a text file; --baseline compares against one and exits with 2 if a
+// count changed (the capture is no longer the same frame), or if the frame or a call got
+// slower by more than --threshold percent (default 10) and by more than MinRegressionNs
+// per frame, below which single calls are timing noise.
+#include "render/FrameCapture.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Op    = CaptureFile::Op;
+
+// Slowdowns smaller than this per frame are timing noise, whatever their percentage
+constexpr double MinRegressionNs = 1000.0;
+
+// Accepts every call and does nothing
+class NullSink : public ContextSink {
+  public:
+    void SetInputLayout(void*) override {}
+    void SetPrimitiveTopology(uint32_t) override {}
+    void SetIndexBuffer(void*, uint32_t, uint32_t) override {}
+    void SetVertexBuffer(uint32_t, void*, uint32_t, uint32_t) override {}
+    void SetVertexShader(void*) override {}
+    void SetPixelShader(void*) override {}
+    void SetPixelShaderResource(uint32_t, void*) override {}
+    void SetPixelSampler(uint32_t, void*) override {}
+    void SetVertexConstantBuffer(uint32_t, void*, uint32_t, uint32_t) override {}
+    void SetRasterizerState(void*) override {}
+    void SetViewport(float, float, float, float) override {}
+    void SetDepthStencilState(void*, uint32_t) override {}
+    void SetBlendState(void*, const float*, uint32_t) override {}
+    void SetRenderTarget(void*, void*) override {}
+    void Draw(uint32_t, uint32_t) override {}
+    void DrawIndexed(uint32_t, uint32_t, int32_t) override {}
+    void DrawInstanced(uint32_t, uint32_t, uint32_t, uint32_t) override {}
+    void DrawIndexedInstanced(uint32_t, uint32_t, uint32_t, int32_t, uint32_t) override {}
+};
+
+// Prints every call; objects are shown by capture id (replayed without an object table)
+class LogSink : public ContextSink {
+  public:
+    void SetInputLayout(void* layout) override {
+        std::printf("SetInputLayout #%u\n", Id(layout));
+    }
+    void SetPrimitiveTopology(uint32_t topology) override {
+        std::printf("SetPrimitiveTopology %u\n", topology);
+    }
+    void SetIndexBuffer(void* buffer, uint32_t format, uint32_t offset) override {
+        std::printf("SetIndexBuffer #%u format %u offset %u\n", Id(buffer), format, offset);
+    }
+    void SetVertexBuffer(uint32_t slot, void* buffer, uint32_t stride, uint32_t offset) override {
+        std::printf("SetVertexBuffer %u #%u stride %u offset %u\n",
+                    slot,
+                    Id(buffer),
+                    stride,
+                    offset);
+    }
+    void SetVertexShader(void* shader) override {
+        std::printf("SetVertexShader #%u\n", Id(shader));
+    }
+    void SetPixelShader(void* shader) override {
+        std::printf("SetPixelShader #%u\n", Id(shader));
+    }
+    void SetPixelShaderResource(uint32_t slot, void* resource) override {
+        std::printf("SetPixelShaderResource %u #%u\n", slot, Id(resource));
+    }
+    void SetPixelSampler(uint32_t slot, void* sampler) override {
+        std::printf("SetPixelSampler %u #%u\n", slot, Id(sampler));
+    }
+    void SetVertexConstantBuffer(uint32_t slot,
+                                 void* buffer,
+                                 uint32_t firstConstant,
+                                 uint32_t constantCount) override {
+        std::printf("SetVertexConstantBuffer %u #%u constants %u+%u\n",
+                    slot,
+                    Id(buffer),
+                    firstConstant,
+                    constantCount);
+    }
+    void SetRasterizerState(void* state) override {
+        std::printf("SetRasterizerState #%u\n", Id(state));
+    }
+    void SetViewport(float x, float y, float width, float height) override {
+        std::printf("SetViewport %g %g %g %g\n", x, y, width, height);
+    }
+    void SetDepthStencilState(void* state, uint32_t stencilRef) override {
+        std::printf("SetDepthStencilState #%u ref %u\n", Id(state), stencilRef);
+    }
+    void SetBlendState(void* state, const float blendFactor[4], uint32_t mask) override {
+        if (blendFactor) {
+            std::printf("SetBlendState #%u factor %g %g %g %g mask 0x%08X\n",
+                        Id(state),
+                        blendFactor[0],
+                        blendFactor[1],
+                        blendFactor[2],
+                        blendFactor[3],
+                        mask);
+        } else {
+            std::printf("SetBlendState #%u mask 0x%08X\n", Id(state), mask);
+        }
+    }
+    void SetRenderTarget(void* renderTarget, void* depthStencil) override {
+        std::printf("SetRenderTarget #%u depth #%u\n", Id(renderTarget), Id(depthStencil));
+    }
+    void Draw(uint32_t vertexCount, uint32_t startVertex) override {
+        std::printf("Draw %u from %u\n", vertexCount, startVertex);
+    }
+    void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override {
+        std::printf("DrawIndexed %u from %u base %d\n", indexCount, startIndex, baseVertex);
+    }
+    void DrawInstanced(uint32_t vertexCount,
+                       uint32_t instanceCount,
+                       uint32_t startVertex,
+                       uint32_t startInstance) override {
+        std::printf("DrawInstanced %u x%u from %u instance %u\n",
+                    vertexCount,
+                    instanceCount,
+                    startVertex,
+                    startInstance);
+    }
+    void DrawIndexedInstanced(uint32_t indexCount,
+                              uint32_t instanceCount,
+                              uint32_t startIndex,
+                              int32_t baseVertex,
+                              uint32_t startInstance) override {
+        std::printf("DrawIndexedInstanced %u x%u from %u base %d instance %u\n",
+                    indexCount,
+                    instanceCount,
+                    startIndex,
+                    baseVertex,
+                    startInstance);
+    }
+
+  private:
+    static uint32_t Id(void* object) {
+        return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(object));
+    }
+};
+
+// Forwards every call to another sink and adds the time it took to its opcode
+class TimingSink : public ContextSink {
+  public:
+    explicit TimingSink(ContextSink& target) : target(target) {}
+
+    uint64_t nanoseconds[CaptureFile::OpCount] = {};
+
+    void Add(Op op, Clock::time_point start) {
+        nanoseconds[op] += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    void SetInputLayout(void* layout) override {
+        const Clock::time_point start = Clock::now();
+        target.SetInputLayout(layout);
+        Add(CaptureFile::SetInputLayout, start);
+    }
+    void SetPrimitiveTopology(uint32_t topology) override {
+        const Clock::time_point start = Clock::now();
+        target.SetPrimitiveTopology(topology);
+        Add(CaptureFile::SetPrimitiveTopology, start);
+    }
+    void SetIndexBuffer(void* buffer, uint32_t format, uint32_t offset) override {
+        const Clock::time_point start = Clock::now();
+        target.SetIndexBuffer(buffer, format, offset);
+        Add(CaptureFile::SetIndexBuffer, start);
+    }
+    void SetVertexBuffer(uint32_t slot, void* buffer, uint32_t stride, uint32_t offset) override {
+        const Clock::time_point start = Clock::now();
+        target.SetVertexBuffer(slot, buffer, stride, offset);
+        Add(CaptureFile::SetVertexBuffer, start);
+    }
+    void SetVertexShader(void* shader) override {
+        const Clock::time_point start = Clock::now();
+        target.SetVertexShader(shader);
+        Add(CaptureFile::SetVertexShader, start);
+    }
+    void SetPixelShader(void* shader) override {
+        const Clock::time_point start = Clock::now();
+        target.SetPixelShader(shader);
+        Add(CaptureFile::SetPixelShader, start);
+    }
+    void SetPixelShaderResource(uint32_t slot, void* resource) override {
+        const Clock::time_point start = Clock::now();
+        target.SetPixelShaderResource(slot, resource);
+        Add(CaptureFile::SetPixelShaderResource, start);
+    }
+    void SetPixelSampler(uint32_t slot, void* sampler) override {
+        const Clock::time_point start = Clock::now();
+        target.SetPixelSampler(slot, sampler);
+        Add(CaptureFile::SetPixelSampler, start);
+    }
+    void SetVertexConstantBuffer(uint32_t slot,
+                                 void* buffer,
+                                 uint32_t firstConstant,
+                                 uint32_t constantCount) override {
+        const Clock::time_point start = Clock::now();
+        target.SetVertexConstantBuffer(slot, buffer, firstConstant, constantCount);
+        Add(CaptureFile::SetVertexConstantBuffer, start);
+    }
+    void SetRasterizerState(void* state) override {
+        const Clock::time_point start = Clock::now();
+        target.SetRasterizerState(state);
+        Add(CaptureFile::SetRasterizerState, start);
+    }
+    void SetViewport(float x, float y, float width, float height) override {
+        const Clock::time_point start = Clock::now();
+        target.SetViewport(x, y, width, height);
+        Add(CaptureFile::SetViewport, start);
+    }
+    void SetDepthStencilState(void* state, uint32_t stencilRef) override {
+        const Clock::time_point start = Clock::now();
+        target.SetDepthStencilState(state, stencilRef);
+        Add(CaptureFile::SetDepthStencilState, start);
+    }
+    void SetBlendState(void* state, const float blendFactor[4], uint32_t mask) override {
+        const Clock::time_point start = Clock::now();
+        target.SetBlendState(state, blendFactor, mask);
+        Add(CaptureFile::SetBlendState, start);
+    }
+    void SetRenderTarget(void* renderTarget, void* depthStencil) override {
+        const Clock::time_point start = Clock::now();
+        target.SetRenderTarget(renderTarget, depthStencil);
+        Add(CaptureFile::SetRenderTarget, start);
+    }
+    void Draw(uint32_t vertexCount, uint32_t startVertex) override {
+        const Clock::time_point start = Clock::now();
+        target.Draw(vertexCount, startVertex);
+        Add(CaptureFile::Draw, start);
+    }
+    void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override {
+        const Clock::time_point start = Clock::now();
+        target.DrawIndexed(indexCount, startIndex, baseVertex);
+        Add(CaptureFile::DrawIndexed, start);
+    }
+    void DrawInstanced(uint32_t vertexCount,
+                       uint32_t instanceCount,
+                       uint32_t startVertex,
+                       uint32_t startInstance) override {
+        const Clock::time_point start = Clock::now();
+        target.DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+        Add(CaptureFile::DrawInstanced, start);
+    }
+    void DrawIndexedInstanced(uint32_t indexCount,
+                              uint32_t instanceCount,
+                              uint32_t startIndex,
+                              int32_t baseVertex,
+                              uint32_t startInstance) override {
+        const Clock::time_point start = Clock::now();
+        target.DrawIndexedInstanced(
+            indexCount, instanceCount, startIndex, baseVertex, startInstance);
+        Add(CaptureFile::DrawIndexedInstanced, start);
+    }
+
+  private:
+    ContextSink& target;
+};
+
+// Per-opcode results of one run, or of a baseline file
+struct Report {
+    double frameNs = 0.0; // Whole replay, untimed calls
+    uint32_t counts[CaptureFile::OpCount] = {};
+    double nsPerCall[CaptureFile::OpCount] = {};
+};
+
+// Cost of the Clock::now() pair around each timed call
+double MeasureTimerOverhead() {
+    constexpr uint32_t Samples = 100000;
+    uint64_t total             = 0;
+    for (uint32_t i = 0; i < Samples; ++i) {
+        const Clock::time_point start = Clock::now();
+        total += static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+    return static_cast<double>(total) / Samples;
+}
+
+bool SaveBaseline(const std::string& path, const Report& report) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "frame %.1f\n", report.frameNs);
+    for (uint32_t op = 0; op < CaptureFile::OpCount; ++op) {
+        if (report.counts[op] > 0) {
+            std::fprintf(file,
+                         "%s %u %.2f\n",
+                         CaptureFile::GetOpInfo(static_cast<Op>(op)).name,
+                         report.counts[op],
+                         report.nsPerCall[op]);
+        }
+    }
+    return std::fclose(file) == 0;
+}
+
+bool LoadBaseline(const std::string& path, Report& report) {
+    FILE* file = std::fopen(path.c_str(), "r");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fscanf(file, "frame %lf", &report.frameNs) == 1;
+    char name[64];
+    unsigned count;
+    double ns;
+    while (ok && std::fscanf(file, "%63s %u %lf", name, &count, &ns) == 3) {
+        uint32_t op = 0;
+        while (op < CaptureFile::OpCount &&
+               std::strcmp(CaptureFile::GetOpInfo(static_cast<Op>(op)).name, name) != 0) {
+            ++op;
+        }
+        if (op == CaptureFile::OpCount) {
+            ok = false;
+            break;
+        }
+        report.counts[op]    = count;
+        report.nsPerCall[op] = ns;
+    }
+    std::fclose(file);
+    return ok;
+}
+
+double PercentChange(double base, double now) {
+    return base > 0.0 ? (now - base) / base * 100.0 : 0.0;
+}
+
+// Print the deltas against a baseline; true if nothing regressed
+bool Compare(const Report& base, const Report& now, double threshold) {
+    bool regressed = false;
+    std::printf("\n%-24s %15s %23s %8s\n", "vs baseline", "count", "ns/call", "change");
+    for (uint32_t op = 0; op < CaptureFile::OpCount; ++op) {
+        if (base.counts[op] == 0 && now.counts[op] == 0) {
+            continue;
+        }
+        const double change     = PercentChange(base.nsPerCall[op], now.nsPerCall[op]);
+        const double addedNs    = (now.nsPerCall[op] - base.nsPerCall[op]) * now.counts[op];
+        const bool countChanged = base.counts[op] != now.counts[op];
+        const bool slower       = !countChanged && change > threshold && addedNs > MinRegressionNs;
+        std::printf("%-24s %7u -> %-7u %10.1f -> %-10.1f %+7.1f%%%s\n",
+                    CaptureFile::GetOpInfo(static_cast<Op>(op)).name,
+                    base.counts[op],
+                    now.counts[op],
+                    base.nsPerCall[op],
+                    now.nsPerCall[op],
+                    change,
+                    countChanged ? "  COUNT CHANGED" : slower ? "  SLOWER" : "");
+        regressed |= countChanged || slower;
+    }
+    const double frameChange = PercentChange(base.frameNs, now.frameNs);
+    const bool frameSlower =
+        frameChange > threshold && now.frameNs - base.frameNs > MinRegressionNs;
+    std::printf("%-24s %15s %10.1f -> %-10.1f %+7.1f%%%s\n",
+                "frame (us)",
+                "",
+                base.frameNs * 1e-3,
+                now.frameNs * 1e-3,
+                frameChange,
+                frameSlower ? "  SLOWER" : "");
+    return !(regressed || frameSlower);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string path;
+    std::string savePath;
+    std::string baselinePath;
+    uint32_t repeat  = 100;
+    double threshold = 10.0;
+    bool log         = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        const bool hasValue  = i + 1 < argc;
+        if (argument == "--repeat" && hasValue) {
+            repeat = std::max(1u, static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10)));
+        } else if (argument == "--log") {
+            log = true;
+        } else if (argument == "--save-baseline" && hasValue) {
+            savePath = argv[++i];
+        } else if (argument == "--baseline" && hasValue) {
+            baselinePath = argv[++i];
+        } else if (argument == "--threshold" && hasValue) {
+            threshold = std::strtod(argv[++i], nullptr);
+        } else if (path.empty()) {
+            path = argument;
+        } else {
+            path.clear();
+            break;
+        }
+    }
+    if (path.empty()) {
+        std::fprintf(stderr,
+                     "usage: %s <frame.fcap> [--repeat N] [--log] [--save-baseline <file>]\n"
+                     "       %*s [--baseline <file>] [--threshold PERCENT]\n",
+                     argv[0],
+                     static_cast<int>(std::strlen(argv[0])),
+                     "");
+        return 1;
+    }
+
+    CaptureFile capture;
+    if (!capture.Open(path)) {
+        std::fprintf(stderr, "%s: not a valid frame capture\n", path.c_str());
+        return 1;
+    }
+    const CaptureFile::Header& header = capture.GetHeader();
+    std::printf("frame %llu: %u commands, %u draws, %u objects, %u blobs (%llu bytes)\n",
+                static_cast<unsigned long long>(header.frame),
+                header.commandCount,
+                header.drawCount,
+                header.objectCount,
+                header.blobCount,
+                static_cast<unsigned long long>(header.sections[CaptureFile::BlobData].size));
+
+    // Buffer contents land in system memory copies of the captured buffers
+    std::unordered_map<void*, std::vector<uint8_t>> buffers;
+    auto bufferData = [&buffers](void* buffer, uint32_t offset, const void* data, uint64_t size) {
+        std::vector<uint8_t>& memory = buffers[buffer];
+        if (memory.size() < offset + size) {
+            memory.resize(static_cast<size_t>(offset + size));
+        }
+        std::memcpy(memory.data() + offset, data, static_cast<size_t>(size));
+    };
+
+    if (log) {
+        LogSink logSink;
+        auto logData = [](void* buffer, uint32_t offset, const void*, uint64_t size) {
+            std::printf("BufferData #%u offset %u, %llu bytes\n",
+                        static_cast<uint32_t>(reinterpret_cast<uintptr_t>(buffer)),
+                        offset,
+                        static_cast<unsigned long long>(size));
+        };
+        capture.Replay(logSink, nullptr, logData);
+        return 0;
+    }
+
+    // ========================================
+    // 1. WHOLE-FRAME REPLAY
+    // ========================================
+    // Untimed calls: what replaying the frame costs, without the clock reads per call
+    // The fastest replay is kept, as the one least disturbed by the rest of the system
+    NullSink nullSink;
+    Report report;
+    report.frameNs = 1e300;
+    capture.Replay(nullSink, nullptr, bufferData); // Warm up
+    for (uint32_t r = 0; r < repeat; ++r) {
+        const Clock::time_point start = Clock::now();
+        capture.Replay(nullSink, nullptr, bufferData);
+        const auto elapsed = Clock::now() - start;
+        report.frameNs     = std::min(
+            report.frameNs,
+            static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    // ========================================
+    // 2. PER-CALL TIMING
+    // ========================================
+    // Each call is timed on its own, and the clock's own cost measured and subtracted;
+    // again each opcode keeps its fastest replay
+    TimingSink timing(nullSink);
+    const double overhead = MeasureTimerOverhead();
+    uint64_t fastest[CaptureFile::OpCount];
+    std::fill(fastest, fastest + CaptureFile::OpCount, UINT64_MAX);
+    for (uint32_t r = 0; r < repeat; ++r) {
+        std::fill(timing.nanoseconds, timing.nanoseconds + CaptureFile::OpCount, 0);
+        capture.Replay(timing, nullptr, [&](void* b, uint32_t o, const void* d, uint64_t s) {
+            const Clock::time_point copyStart = Clock::now();
+            bufferData(b, o, d, s);
+            timing.Add(CaptureFile::BufferData, copyStart);
+        });
+        for (uint32_t op = 0; op < CaptureFile::OpCount; ++op) {
+            fastest[op] = std::min(fastest[op], timing.nanoseconds[op]);
+        }
+    }
+
+    std::printf("\n%-24s %8s %10s %12s\n", "call", "count", "ns/call", "us/frame");
+    for (uint32_t op = 0; op < CaptureFile::OpCount; ++op) {
+        const uint32_t count = capture.GetOpCounts()[op];
+        if (count == 0) {
+            continue;
+        }
+        const double perCall = std::max(0.0, static_cast<double>(fastest[op]) / count - overhead);
+        report.counts[op]    = count;
+        report.nsPerCall[op] = perCall;
+        std::printf("%-24s %8u %10.1f %12.2f\n",
+                    CaptureFile::GetOpInfo(static_cast<Op>(op)).name,
+                    count,
+                    perCall,
+                    perCall * count * 1e-3);
+    }
+    std::printf("replay: %.2f us per frame, fastest of %u (timer overhead %.1f ns per call "
+                "subtracted above)\n",
+                report.frameNs * 1e-3,
+                repeat,
+                overhead);
+
+    // ========================================
+    // 3. BASELINE
+    // ========================================
+    if (!savePath.empty()) {
+        if (!SaveBaseline(savePath, report)) {
+            std::fprintf(stderr, "%s: cannot write\n", savePath.c_str());
+            return 1;
+        }
+        std::printf("baseline written to %s\n", savePath.c_str());
+    }
+    if (!baselinePath.empty()) {
+        Report base;
+        if (!LoadBaseline(baselinePath, base)) {
+            std::fprintf(stderr, "%s: not a valid baseline\n", baselinePath.c_str());
+            return 1;
+        }
+        if (!Compare(base, report, threshold)) {
+            std::printf("regression beyond %.1f%%\n", threshold);
+            return 2;
+        }
+    }
+    return 0;
+}
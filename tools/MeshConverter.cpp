@@ -0,0 +1,633 @@
+// Mesh Converter
+// Converts OBJ and glTF models into MeshFile containers, inspects them, and measures how
+// long a model takes to load in either form.
+//
+//   MeshConverter <input.obj|.gltf|.glb> <output.mesh> [--float] [--lz4] [--no-optimize]
+//                 [--no-lod]
+//   MeshConverter --info <model.mesh>
+//   MeshConverter --load <model.obj|.gltf|.glb|.mesh>
+//   MeshConverter --analyze <model.obj|.gltf|.glb>...
+//
+// By default vertices are written as PackedVertex (SNORM16 position, RGBA8 color), with
+// positions quantized to the mesh bounds; the header's positionScale/positionOffset undo
+// that (fold them into the instance transform). --float keeps the float Vertex layout.
+// Every part is welded, reordered for the vertex cache, overdraw and vertex fetch, and cut
+// into meshlets (see MeshOptimizer) unless --no-optimize is given. Optimized parts also get
+// a chain of simplified LODs (see MeshSimplifier), built for all parts in parallel on the
+// job system, unless --no-lod is given; every LOD reuses its part's vertices.
+// --load prints the load time and the process's peak memory; run it once per format, in
+// separate processes, to compare them. --analyze optimizes each model in memory and prints
+// its cache and overdraw statistics before and after, and the optimizer's throughput.
+#include "MeshImport.h"
+#include "render/MeshFile.h"
+#include "render/MeshOptimizer.h"
+#include "render/MeshSimplifier.h"
+#include "render/VertexEncoder.h"
+#include "threading/JobSystem.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+struct Box {
+    float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    void Grow(const float point[3]) {
+        for (int axis = 0; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], point[axis]);
+            max[axis] = std::max(max[axis], point[axis]);
+        }
+    }
+};
+
+size_t PeakMemoryBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters = {};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss); // Bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; // Kilobytes on Linux
+#endif
+#endif
+}
+
+bool EndsWith(const std::string& text, const char* suffix) {
+    size_t length = std::strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+const float* Positions(const std::vector<Vertex>& vertices) {
+    return vertices.empty() ? nullptr : vertices[0].position;
+}
+
+// Indices of every part (LOD 0 only) rebased onto the whole vertex array, for analysing the
+// mesh as one
+std::vector<uint32_t> AbsoluteIndices(const ImportedMesh& mesh) {
+    std::vector<uint32_t> indices;
+    indices.reserve(mesh.indices.size());
+    for (const ImportedMesh::Part& part : mesh.parts) {
+        for (uint32_t i = part.indexStart; i < part.indexStart + part.indexCount; ++i) {
+            indices.push_back(mesh.indices[i] + part.baseVertex);
+        }
+    }
+    return indices;
+}
+
+struct MeshStats {
+    uint32_t vertexCount = 0;
+    MeshOptimizer::CacheStats cache;
+    MeshOptimizer::OverdrawStats overdraw;
+};
+
+MeshStats Analyze(const ImportedMesh& mesh) {
+    std::vector<uint32_t> indices = AbsoluteIndices(mesh);
+    const uint32_t indexCount     = static_cast<uint32_t>(indices.size());
+    const uint32_t vertexCount    = static_cast<uint32_t>(mesh.vertices.size());
+
+    MeshStats stats;
+    stats.vertexCount = vertexCount;
+    stats.cache       = MeshOptimizer::AnalyzeVertexCache(indices.data(), indexCount, vertexCount);
+    stats.overdraw    = MeshOptimizer::AnalyzeOverdraw(
+        indices.data(), indexCount, Positions(mesh.vertices), vertexCount, sizeof(Vertex));
+    return stats;
+}
+
+// Tables the optimizer produces alongside the mesh; index ranges are into the whole mesh
+struct OptimizedTables {
+    std::vector<MeshFile::Meshlet> meshlets;
+    std::vector<uint32_t> partMeshlets; // First meshlet of each part, plus the end
+    std::vector<MeshFile::Lod> lods;
+    std::vector<uint32_t> partLods; // First LOD of each part, plus the end
+    double simplifyMs = 0.0;
+};
+
+/*
+Optimize every part in place (parts keep their order; vertices and indices are compacted)
+simplifier: Builds each part's LOD chain, or nullptr for none. A part's LOD indices follow
+its own in mesh.indices, outside [indexStart, indexStart + indexCount)
+*/
+void Optimize(ImportedMesh& mesh, const MeshSimplifier* simplifier, OptimizedTables& tables) {
+    using Clock = std::chrono::steady_clock;
+
+    const size_t partCount = mesh.parts.size();
+    std::vector<std::vector<Vertex>> welded(partCount);
+    std::vector<std::vector<uint32_t>> weldedIndices(partCount);
+    std::vector<MeshSimplifier::Input> inputs(partCount);
+    std::vector<MeshSimplifier::Chain> chains(partCount);
+
+    // ========================================
+    // 1. WELD
+    // ========================================
+    // Welding compares whole vertices, so a color seam stays split and the simplifier sees
+    // it as an attribute discontinuity
+    for (size_t p = 0; p < partCount; ++p) {
+        const ImportedMesh::Part& part     = mesh.parts[p];
+        const Vertex* source               = mesh.vertices.data() + part.baseVertex;
+        std::vector<uint32_t>& partIndices = weldedIndices[p];
+        partIndices.assign(mesh.indices.begin() + part.indexStart,
+                           mesh.indices.begin() + part.indexStart + part.indexCount);
+
+        std::vector<uint32_t> remap(part.vertexCount);
+        const uint32_t unique = MeshOptimizer::GenerateRemap(
+            remap.data(), source, part.vertexCount, sizeof(Vertex));
+        welded[p].resize(unique);
+        MeshOptimizer::RemapVertices(
+            welded[p].data(), source, part.vertexCount, sizeof(Vertex), remap.data());
+        MeshOptimizer::RemapIndices(partIndices.data(), part.indexCount, remap.data());
+        inputs[p] = {
+            partIndices.data(), part.indexCount, Positions(welded[p]), unique, sizeof(Vertex)};
+    }
+
+    // ========================================
+    // 2. LOD CHAINS
+    // ========================================
+    if (simplifier != nullptr) {
+        auto start = Clock::now();
+        simplifier->BuildChains(chains.data(),
+                                inputs.data(),
+                                static_cast<uint32_t>(partCount),
+                                MeshSimplifier::DefaultChainSettings());
+        tables.simplifyMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    } else {
+        for (size_t p = 0; p < partCount; ++p) {
+            chains[p].indices.swap(weldedIndices[p]);
+            chains[p].lods = {{0, mesh.parts[p].indexCount, 0.0f}};
+        }
+    }
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<MeshFile::Meshlet> clusters;
+    tables.meshlets.clear();
+    tables.lods.clear();
+    tables.partMeshlets.assign(1, 0);
+    tables.partLods.assign(1, 0);
+    vertices.reserve(mesh.vertices.size());
+    indices.reserve(mesh.indices.size());
+
+    for (size_t p = 0; p < partCount; ++p) {
+        ImportedMesh::Part& part           = mesh.parts[p];
+        MeshSimplifier::Chain& chain       = chains[p];
+        std::vector<uint32_t>& partIndices = chain.indices;
+        const uint32_t unique              = static_cast<uint32_t>(welded[p].size());
+        const uint32_t total               = static_cast<uint32_t>(partIndices.size());
+
+        // ========================================
+        // 3. TRIANGLE ORDER
+        // ========================================
+        // Each LOD is ordered on its own; they are drawn separately
+        std::vector<uint32_t> cacheOrder;
+        for (const MeshSimplifier::Lod& lod : chain.lods) {
+            uint32_t* range = partIndices.data() + lod.indexStart;
+            cacheOrder.resize(lod.indexCount);
+            MeshOptimizer::OptimizeVertexCache(cacheOrder.data(), range, lod.indexCount, unique);
+            MeshOptimizer::OptimizeOverdraw(range,
+                                            cacheOrder.data(),
+                                            lod.indexCount,
+                                            Positions(welded[p]),
+                                            unique,
+                                            sizeof(Vertex));
+        }
+
+        // ========================================
+        // 4. VERTEX ORDER AND MESHLETS
+        // ========================================
+        // Vertices are ordered by first use across every LOD, finest first, so LOD 0 reads
+        // them in order and the coarser levels fetch a subset of the same lines
+        std::vector<Vertex> fetched(unique);
+        const uint32_t used = MeshOptimizer::OptimizeVertexFetch(
+            fetched.data(), partIndices.data(), total, welded[p].data(), unique, sizeof(Vertex));
+        fetched.resize(used);
+
+        const uint32_t indexBase = static_cast<uint32_t>(indices.size());
+        for (size_t l = 0; l < chain.lods.size(); ++l) {
+            const MeshSimplifier::Lod& lod = chain.lods[l];
+            const uint32_t meshletStart    = static_cast<uint32_t>(tables.meshlets.size());
+            MeshOptimizer::BuildMeshlets(clusters,
+                                         partIndices.data() + lod.indexStart,
+                                         lod.indexCount,
+                                         Positions(fetched),
+                                         used,
+                                         sizeof(Vertex));
+            for (MeshFile::Meshlet& meshlet : clusters) {
+                meshlet.indexStart += indexBase + lod.indexStart;
+                tables.meshlets.push_back(meshlet);
+            }
+            if (l == 0) {
+                tables.partMeshlets.push_back(static_cast<uint32_t>(tables.meshlets.size()));
+                continue;
+            }
+            MeshFile::Lod entry;
+            entry.indexStart   = indexBase + lod.indexStart;
+            entry.indexCount   = lod.indexCount;
+            entry.meshletStart = meshletStart;
+            entry.meshletCount = static_cast<uint32_t>(tables.meshlets.size()) - meshletStart;
+            entry.error        = lod.error;
+            tables.lods.push_back(entry);
+        }
+        tables.partLods.push_back(static_cast<uint32_t>(tables.lods.size()));
+
+        part.indexStart  = indexBase;
+        part.baseVertex  = static_cast<uint32_t>(vertices.size());
+        part.vertexCount = used;
+        vertices.insert(vertices.end(), fetched.begin(), fetched.end());
+        indices.insert(indices.end(), partIndices.begin(), partIndices.end());
+    }
+    mesh.vertices.swap(vertices);
+    mesh.indices.swap(indices);
+}
+
+// Triangles and error of each LOD level over all parts (a part with a shorter chain counts
+// its coarsest level), and the simplifier's throughput in LOD 0 triangles
+void PrintLods(const ImportedMesh& mesh, const OptimizedTables& tables) {
+    uint32_t levels = 1;
+    for (size_t p = 0; p < mesh.parts.size(); ++p) {
+        levels = std::max(levels, tables.partLods[p + 1] - tables.partLods[p] + 1);
+    }
+
+    for (uint32_t level = 0; level < levels; ++level) {
+        uint64_t triangles = 0;
+        float error        = 0.0f;
+        for (size_t p = 0; p < mesh.parts.size(); ++p) {
+            const uint32_t count = tables.partLods[p + 1] - tables.partLods[p];
+            if (level == 0 || count == 0) {
+                triangles += mesh.parts[p].indexCount / 3;
+                continue;
+            }
+            const MeshFile::Lod& lod = tables.lods[tables.partLods[p] + std::min(level, count) - 1];
+            triangles += lod.indexCount / 3;
+            error = std::max(error, lod.error);
+        }
+        std::printf("  LOD %u: %llu triangles, error %g\n",
+                    level,
+                    static_cast<unsigned long long>(triangles),
+                    error);
+    }
+    const size_t triangles = AbsoluteIndices(mesh).size() / 3;
+    std::printf("  simplified %zu triangles in %.2f ms (%.2f Mtri/s)\n",
+                triangles,
+                tables.simplifyMs,
+                tables.simplifyMs > 0.0 ? triangles / (tables.simplifyMs * 1000.0) : 0.0);
+}
+
+int Convert(const std::string& input,
+            const std::string& output,
+            bool packed,
+            bool compress,
+            bool optimize,
+            bool lod) {
+    ImportedMesh mesh;
+    std::string error;
+    if (!MeshImport::Import(input, mesh, error)) {
+        std::fprintf(stderr, "%s: %s\n", input.c_str(), error.c_str());
+        return 1;
+    }
+
+    OptimizedTables tables;
+    tables.partMeshlets.assign(mesh.parts.size() + 1, 0);
+    tables.partLods.assign(mesh.parts.size() + 1, 0);
+    std::vector<MeshFile::Meshlet>& meshlets = tables.meshlets;
+    if (optimize) {
+        // Parts are simplified in parallel, one task each
+        JobSystem jobSystem;
+        MeshSimplifier simplifier;
+        if (lod) {
+            jobSystem.Initialize();
+            simplifier.SetParallelFor(jobSystem.GetTaskExecutor());
+        }
+
+        MeshStats before = Analyze(mesh);
+        Optimize(mesh, lod ? &simplifier : nullptr, tables);
+        MeshStats after = Analyze(mesh);
+        std::printf("%s: vertices %u -> %u, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, "
+                    "overdraw %.3f -> %.3f, %zu meshlets\n",
+                    input.c_str(),
+                    before.vertexCount,
+                    after.vertexCount,
+                    before.cache.acmr,
+                    after.cache.acmr,
+                    before.cache.atvr,
+                    after.cache.atvr,
+                    before.overdraw.overdraw,
+                    after.overdraw.overdraw,
+                    meshlets.size());
+        if (lod) {
+            PrintLods(mesh, tables);
+        }
+    }
+
+    MeshFileWriter writer;
+    Box bounds;
+    for (const Vertex& vertex : mesh.vertices) {
+        bounds.Grow(vertex.position);
+    }
+    writer.SetBounds(bounds.min, bounds.max);
+
+    // ========================================
+    // 1. VERTICES
+    // ========================================
+    // Packed positions are SNORM16, so they are recentred and scaled into [-1, 1] first;
+    // the scale is uniform to keep the quantization error the same on every axis
+    if (packed) {
+        float center[3];
+        float scale = 0.0f;
+        for (int axis = 0; axis < 3; ++axis) {
+            center[axis] = 0.5f * (bounds.min[axis] + bounds.max[axis]);
+            scale        = std::max(scale, 0.5f * (bounds.max[axis] - bounds.min[axis]));
+        }
+        scale = scale > 0.0f ? scale : 1.0f;
+
+        std::vector<Vertex> normalized = mesh.vertices;
+        for (Vertex& vertex : normalized) {
+            for (int axis = 0; axis < 3; ++axis) {
+                float value           = (vertex.position[axis] - center[axis]) / scale;
+                vertex.position[axis] = std::min(std::max(value, -1.0f), 1.0f);
+            }
+        }
+        std::vector<PackedVertex> encoded(normalized.size());
+        VertexEncoder::EncodeVertices(
+            normalized.data(), static_cast<uint32_t>(normalized.size()), encoded.data());
+        writer.SetVertices(encoded.data(), static_cast<uint32_t>(encoded.size()));
+        writer.SetPositionTransform(scale, center);
+
+        // Meshlet bounds follow the positions into stored units (the cones are unchanged)
+        for (MeshFile::Meshlet& meshlet : meshlets) {
+            for (int axis = 0; axis < 3; ++axis) {
+                meshlet.center[axis] = (meshlet.center[axis] - center[axis]) / scale;
+            }
+            meshlet.radius /= scale;
+        }
+    } else {
+        const float zero[3] = {0.0f, 0.0f, 0.0f};
+        writer.SetVertices(mesh.vertices.data(), static_cast<uint32_t>(mesh.vertices.size()));
+        writer.SetPositionTransform(1.0f, zero);
+    }
+    writer.SetIndices(mesh.indices.data(), static_cast<uint32_t>(mesh.indices.size()));
+    writer.SetMeshlets(meshlets.data(), static_cast<uint32_t>(meshlets.size()));
+    writer.SetLods(tables.lods.data(), static_cast<uint32_t>(tables.lods.size()));
+
+    // ========================================
+    // 2. SUBMESHES
+    // ========================================
+    for (size_t p = 0; p < mesh.parts.size(); ++p) {
+        const ImportedMesh::Part& part = mesh.parts[p];
+        Box partBounds;
+        for (uint32_t v = 0; v < part.vertexCount; ++v) {
+            partBounds.Grow(mesh.vertices[part.baseVertex + v].position);
+        }
+        std::string name = part.name.substr(0, MeshFile::MaxNameLen);
+        if (!writer.AddSubmesh(name,
+                               part.indexStart,
+                               part.indexCount,
+                               part.baseVertex,
+                               part.vertexCount,
+                               partBounds.min,
+                               partBounds.max,
+                               tables.partMeshlets[p],
+                               tables.partMeshlets[p + 1] - tables.partMeshlets[p],
+                               tables.partLods[p],
+                               tables.partLods[p + 1] - tables.partLods[p])) {
+            std::fprintf(stderr, "%s: invalid part %s\n", input.c_str(), name.c_str());
+            return 1;
+        }
+    }
+
+    if (!writer.Write(output, compress)) {
+        std::fprintf(stderr, "%s: cannot write\n", output.c_str());
+        return 1;
+    }
+    std::printf("%s: %zu vertices, %zu triangles, %zu submeshes, %zu LODs\n",
+                output.c_str(),
+                mesh.vertices.size(),
+                AbsoluteIndices(mesh).size() / 3,
+                mesh.parts.size(),
+                tables.lods.size());
+    return 0;
+}
+
+int Info(const std::string& path) {
+    MeshFile mesh;
+    if (!mesh.Open(path)) {
+        std::fprintf(stderr, "%s: not a valid mesh file\n", path.c_str());
+        return 1;
+    }
+    const MeshFile::Header& header = mesh.GetHeader();
+    const char* format             = mesh.HasVertexFormat<PackedVertex>() ? "PackedVertex"
+                                     : mesh.HasVertexFormat<Vertex>()     ? "Vertex"
+                                                                          : "unknown";
+    std::printf("%u vertices (%s, %u bytes), %u indices (%u-bit), %u meshlets, %u LODs%s\n",
+                header.vertexCount,
+                format,
+                header.vertexStride,
+                header.indexCount,
+                header.indexSize * 8,
+                header.meshletCount,
+                header.lodCount,
+                (header.flags & MeshFile::Compressed) ? ", LZ4" : "");
+    std::printf("bounds (%g %g %g) - (%g %g %g)\n",
+                header.boundsMin[0],
+                header.boundsMin[1],
+                header.boundsMin[2],
+                header.boundsMax[0],
+                header.boundsMax[1],
+                header.boundsMax[2]);
+    for (uint32_t i = 0; i < mesh.GetSubmeshCount(); ++i) {
+        const MeshFile::Submesh& submesh = mesh.GetSubmesh(i);
+        std::printf("  %-32s indices %8u +%-8u vertices %8u +%-8u meshlets %6u +%u\n",
+                    submesh.name,
+                    submesh.indexStart,
+                    submesh.indexCount,
+                    submesh.baseVertex,
+                    submesh.vertexCount,
+                    submesh.meshletStart,
+                    submesh.meshletCount);
+        for (uint32_t l = submesh.lodStart; l < submesh.lodStart + submesh.lodCount; ++l) {
+            const MeshFile::Lod& lod = mesh.GetLod(l);
+            std::printf("    LOD %-26u indices %8u +%-8u error %-14g meshlets %6u +%u\n",
+                        l - submesh.lodStart + 1,
+                        lod.indexStart,
+                        lod.indexCount,
+                        lod.error,
+                        lod.meshletStart,
+                        lod.meshletCount);
+        }
+    }
+    if (!mesh.Verify()) {
+        std::fprintf(stderr, "%s: index out of range, file is corrupt\n", path.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+int Load(const std::string& path) {
+    // Both paths end with every vertex and index byte read once, which is what CreateBuffer
+    // does with the pointers it is given
+    using Clock = std::chrono::steady_clock;
+
+    auto start         = Clock::now();
+    uint64_t checksum  = 0;
+    size_t vertexCount = 0;
+    if (EndsWith(path, ".mesh")) {
+        MeshFile mesh;
+        if (!mesh.Open(path)) {
+            std::fprintf(stderr, "%s: not a valid mesh file\n", path.c_str());
+            return 1;
+        }
+        const uint8_t* sections[] = {static_cast<const uint8_t*>(mesh.GetVertexData()),
+                                     static_cast<const uint8_t*>(mesh.GetIndexData())};
+        const size_t sizes[]      = {mesh.GetVertexDataSize(), mesh.GetIndexDataSize()};
+        for (int s = 0; s < 2; ++s) {
+            for (size_t i = 0; i < sizes[s]; i += sizeof(uint64_t)) {
+                uint64_t word = 0;
+                std::memcpy(&word, sections[s] + i, std::min(sizeof(word), sizes[s] - i));
+                checksum += word;
+            }
+        }
+        vertexCount = mesh.GetHeader().vertexCount;
+    } else {
+        ImportedMesh mesh;
+        std::string error;
+        if (!MeshImport::Import(path, mesh, error)) {
+            std::fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+            return 1;
+        }
+        for (uint32_t index : mesh.indices) {
+            checksum += index;
+        }
+        vertexCount = mesh.vertices.size();
+    }
+
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::printf("%s: %zu vertices in %.2f ms, peak memory %.1f MB (checksum %llx)\n",
+                path.c_str(),
+                vertexCount,
+                ms,
+                PeakMemoryBytes() / (1024.0 * 1024.0),
+                static_cast<unsigned long long>(checksum));
+    return 0;
+}
+
+int AnalyzeCorpus(const std::vector<std::string>& paths) {
+    using Clock = std::chrono::steady_clock;
+
+    std::printf("%-24s %9s %9s %7s %7s %7s %7s %7s %7s %9s %7s\n",
+                "model",
+                "vertices",
+                "welded",
+                "ACMR",
+                "->",
+                "ATVR",
+                "->",
+                "overdr",
+                "->",
+                "ms",
+                "Mtri/s");
+    double totalMs     = 0.0;
+    uint64_t totalTris = 0;
+    for (const std::string& path : paths) {
+        ImportedMesh mesh;
+        std::string error;
+        if (!MeshImport::Import(path, mesh, error)) {
+            std::fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+            return 1;
+        }
+        MeshStats before = Analyze(mesh);
+
+        OptimizedTables tables;
+        auto start = Clock::now();
+        Optimize(mesh, nullptr, tables);
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        MeshStats after        = Analyze(mesh);
+        const size_t triangles = mesh.indices.size() / 3;
+        const size_t slash     = path.find_last_of("/\\");
+        const std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+        std::printf("%-24s %9u %9u %7.3f %7.3f %7.3f %7.3f %7.3f %7.3f %9.2f %7.2f\n",
+                    name.substr(0, 24).c_str(),
+                    before.vertexCount,
+                    after.vertexCount,
+                    before.cache.acmr,
+                    after.cache.acmr,
+                    before.cache.atvr,
+                    after.cache.atvr,
+                    before.overdraw.overdraw,
+                    after.overdraw.overdraw,
+                    ms,
+                    ms > 0.0 ? triangles / (ms * 1000.0) : 0.0);
+        totalMs += ms;
+        totalTris += triangles;
+    }
+    std::printf("%zu models, %llu triangles in %.2f ms (%.2f Mtri/s)\n",
+                paths.size(),
+                static_cast<unsigned long long>(totalTris),
+                totalMs,
+                totalMs > 0.0 ? totalTris / (totalMs * 1000.0) : 0.0);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc == 3 && std::string(argv[1]) == "--info") {
+        return Info(argv[2]);
+    }
+    if (argc == 3 && std::string(argv[1]) == "--load") {
+        return Load(argv[2]);
+    }
+    if (argc >= 3 && std::string(argv[1]) == "--analyze") {
+        return AnalyzeCorpus(std::vector<std::string>(argv + 2, argv + argc));
+    }
+
+    std::vector<std::string> paths;
+    bool packed   = true;
+    bool compress = false;
+    bool optimize = true;
+    bool lod      = true;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--float") {
+            packed = false;
+        } else if (argument == "--lz4") {
+            compress = true;
+        } else if (argument == "--no-optimize") {
+            optimize = false;
+        } else if (argument == "--no-lod") {
+            lod = false;
+        } else {
+            paths.push_back(argument);
+        }
+    }
+    if (paths.size() != 2) {
+        std::fprintf(stderr,
+                     "usage: %s <input.obj|.gltf|.glb> <output.mesh> [--float] [--lz4] "
+                     "[--no-optimize] [--no-lod]\n"
+                     "       %s --info <model.mesh>\n"
+                     "       %s --load <model.obj|.gltf|.glb|.mesh>\n"
+                     "       %s --analyze <model.obj|.gltf|.glb>...\n",
+                     argv[0],
+                     argv[0],
+                     argv[0],
+                     argv[0]);
+        return 1;
+    }
+    return Convert(paths[0], paths[1], packed, compress, optimize, lod);
+}
@@ -0,0 +1,759 @@
+#include "MeshImport.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+bool ReadFile(const std::string& path, std::vector<uint8_t>& bytes) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    bytes.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    bool ok = size > 0 && std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    std::fclose(file);
+    return ok;
+}
+
+std::string Extension(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos || path.find_first_of("/\\", dot) != std::string::npos) {
+        return "";
+    }
+    std::string extension = path.substr(dot + 1);
+    for (char& c : extension) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return extension;
+}
+
+// Both sources are right-handed with counter-clockwise front faces. Negating z moves a
+// vertex into D3D's left-handed space and turns the winding clockwise, D3D's default front.
+Vertex MakeVertex(const float position[3], const float color[4]) {
+    Vertex vertex;
+    vertex.position[0] = position[0];
+    vertex.position[1] = position[1];
+    vertex.position[2] = -position[2];
+    std::memcpy(vertex.color, color, sizeof(vertex.color));
+    return vertex;
+}
+
+// ========================================
+// 1. OBJ
+// ========================================
+
+bool IsSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Parts are flushed when a new o/g/usemtl starts; parts without faces are dropped
+struct ObjBuilder {
+    ImportedMesh& mesh;
+    ImportedMesh::Part part;
+    std::unordered_map<uint32_t, uint32_t> remap; // Position index -> part-local vertex
+
+    void Flush(const std::string& nextName) {
+        part.indexCount  = static_cast<uint32_t>(mesh.indices.size()) - part.indexStart;
+        part.vertexCount = static_cast<uint32_t>(mesh.vertices.size()) - part.baseVertex;
+        if (part.indexCount > 0) {
+            mesh.parts.push_back(part);
+        } else {
+            mesh.vertices.resize(part.baseVertex);
+        }
+        part            = ImportedMesh::Part();
+        part.name       = nextName;
+        part.indexStart = static_cast<uint32_t>(mesh.indices.size());
+        part.baseVertex = static_cast<uint32_t>(mesh.vertices.size());
+        remap.clear();
+    }
+
+    void Emit(uint32_t position,
+              const std::vector<float>& positions,
+              const std::vector<float>& colors) {
+        auto inserted = remap.emplace(position, static_cast<uint32_t>(remap.size()));
+        if (inserted.second) {
+            mesh.vertices.push_back(MakeVertex(&positions[position * 3], &colors[position * 4]));
+        }
+        mesh.indices.push_back(inserted.first->second);
+    }
+};
+
+} // namespace
+
+namespace MeshImport {
+
+bool ImportObj(const std::string& path, ImportedMesh& mesh, std::string& error) {
+    std::vector<uint8_t> text;
+    if (!ReadFile(path, text)) {
+        error = "cannot read";
+        return false;
+    }
+    text.push_back('\0'); // strtof and strtol stop here at the latest
+
+    mesh = ImportedMesh();
+    std::vector<float> positions;
+    std::vector<float> colors;
+    std::vector<uint32_t> polygon;
+    ObjBuilder builder{mesh, {}, {}};
+    builder.part.name = "default";
+
+    const char* p   = reinterpret_cast<const char*>(text.data());
+    const char* end = p + text.size() - 1;
+    uint32_t line   = 0;
+    while (p < end) {
+        ++line;
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        while (p < lineEnd && IsSpace(*p)) {
+            ++p;
+        }
+
+        if (p[0] == 'v' && IsSpace(p[1])) {
+            // v x y z [r g b]
+            char* next = const_cast<char*>(p + 1);
+            float values[6];
+            int count = 0;
+            for (; count < 6; ++count) {
+                char* parsed  = next;
+                values[count] = std::strtof(next, &parsed);
+                if (parsed == next || parsed > lineEnd) {
+                    break;
+                }
+                next = parsed;
+            }
+            if (count < 3) {
+                error = "line " + std::to_string(line) + ": malformed vertex";
+                return false;
+            }
+            positions.insert(positions.end(), values, values + 3);
+            const float white[3] = {1.0f, 1.0f, 1.0f};
+            const float* color   = count >= 6 ? values + 3 : white;
+            colors.insert(colors.end(), color, color + 3);
+            colors.push_back(1.0f);
+        } else if (p[0] == 'f' && IsSpace(p[1])) {
+            // f v[/vt][/vn] ...; negative indices count back from the last vertex
+            const uint32_t positionCount = static_cast<uint32_t>(positions.size() / 3);
+            polygon.clear();
+            char* next = const_cast<char*>(p + 1);
+            while (true) {
+                char* parsed = next;
+                long index   = std::strtol(next, &parsed, 10);
+                if (parsed == next || parsed > lineEnd) {
+                    break;
+                }
+                long resolved = index > 0 ? index - 1 : static_cast<long>(positionCount) + index;
+                if (index == 0 || resolved < 0 || resolved >= static_cast<long>(positionCount)) {
+                    error = "line " + std::to_string(line) + ": vertex index out of range";
+                    return false;
+                }
+                polygon.push_back(static_cast<uint32_t>(resolved));
+                next = parsed;
+                while (next < lineEnd && !IsSpace(*next)) {
+                    ++next; // Texture coordinate and normal references are not used
+                }
+            }
+            for (size_t i = 2; i < polygon.size(); ++i) {
+                builder.Emit(polygon[0], positions, colors);
+                builder.Emit(polygon[i - 1], positions, colors);
+                builder.Emit(polygon[i], positions, colors);
+            }
+        } else if (((p[0] == 'o' || p[0] == 'g') && IsSpace(p[1])) ||
+                   (std::strncmp(p, "usemtl", 6) == 0 && IsSpace(p[6]))) {
+            const char* name = p[0] == 'u' ? p + 6 : p + 1;
+            while (name < lineEnd && IsSpace(*name)) {
+                ++name;
+            }
+            const char* nameEnd = lineEnd;
+            while (nameEnd > name && IsSpace(nameEnd[-1])) {
+                --nameEnd;
+            }
+            builder.Flush(std::string(name, nameEnd));
+        }
+        p = lineEnd + 1;
+    }
+    builder.Flush("");
+
+    if (mesh.parts.empty()) {
+        error = "no faces";
+        return false;
+    }
+    return true;
+}
+
+} // namespace MeshImport
+
+namespace {
+
+// ========================================
+// 2. JSON
+// ========================================
+
+// Just enough JSON for glTF documents: numbers are doubles, objects keep member order
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type     = Type::Null;
+    bool boolean  = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    const JsonValue* Get(const char* key) const {
+        for (const auto& member : members) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+
+    const JsonValue* At(size_t index) const {
+        return type == Type::Array && index < items.size() ? &items[index] : nullptr;
+    }
+
+    double GetNumber(const char* key, double fallback) const {
+        const JsonValue* value = Get(key);
+        return value && value->type == Type::Number ? value->number : fallback;
+    }
+
+    std::string GetString(const char* key) const {
+        const JsonValue* value = Get(key);
+        return value && value->type == Type::String ? value->string : std::string();
+    }
+};
+
+class JsonParser {
+  public:
+    JsonParser(const char* begin, const char* end) : p(begin), end(end) {}
+
+    bool Parse(JsonValue& value) {
+        if (!ParseValue(value, 0)) {
+            return false;
+        }
+        SkipSpace();
+        return p == end;
+    }
+
+  private:
+    static constexpr int MaxDepth = 64;
+
+    const char* p;
+    const char* end;
+
+    void SkipSpace() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+            ++p;
+        }
+    }
+
+    bool Literal(const char* word) {
+        size_t length = std::strlen(word);
+        if (static_cast<size_t>(end - p) < length || std::strncmp(p, word, length) != 0) {
+            return false;
+        }
+        p += length;
+        return true;
+    }
+
+    bool ParseValue(JsonValue& value, int depth) {
+        SkipSpace();
+        if (p >= end || depth > MaxDepth) {
+            return false;
+        }
+        switch (*p) {
+        case '{':
+            return ParseObject(value, depth);
+        case '[':
+            return ParseArray(value, depth);
+        case '"':
+            value.type = JsonValue::Type::String;
+            return ParseString(value.string);
+        case 't':
+            value.type    = JsonValue::Type::Bool;
+            value.boolean = true;
+            return Literal("true");
+        case 'f':
+            value.type = JsonValue::Type::Bool;
+            return Literal("false");
+        case 'n':
+            return Literal("null");
+        default:
+            return ParseNumber(value);
+        }
+    }
+
+    bool ParseNumber(JsonValue& value) {
+        // The document buffer is null-terminated, so strtod cannot run past it
+        char* parsed = nullptr;
+        value.type   = JsonValue::Type::Number;
+        value.number = std::strtod(p, &parsed);
+        if (parsed == p || parsed > end) {
+            return false;
+        }
+        p = parsed;
+        return true;
+    }
+
+    bool ParseString(std::string& out) {
+        ++p; // Opening quote
+        while (p < end && *p != '"') {
+            char c = *p++;
+            if (c != '\\') {
+                out.push_back(c);
+                continue;
+            }
+            if (p >= end) {
+                return false;
+            }
+            char escape = *p++;
+            switch (escape) {
+            case 'b':
+                out.push_back('\b');
+                break;
+            case 'f':
+                out.push_back('\f');
+                break;
+            case 'n':
+                out.push_back('\n');
+                break;
+            case 'r':
+                out.push_back('\r');
+                break;
+            case 't':
+                out.push_back('\t');
+                break;
+            case 'u': {
+                // Basic multilingual plane only, encoded as UTF-8
+                if (end - p < 4) {
+                    return false;
+                }
+                unsigned code = std::strtoul(std::string(p, p + 4).c_str(), nullptr, 16);
+                p += 4;
+                if (code < 0x80) {
+                    out.push_back(static_cast<char>(code));
+                } else if (code < 0x800) {
+                    out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                } else {
+                    out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                    out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                }
+                break;
+            }
+            default:
+                out.push_back(escape); // \" \\ \/
+                break;
+            }
+        }
+        if (p >= end) {
+            return false;
+        }
+        ++p; // Closing quote
+        return true;
+    }
+
+    bool ParseArray(JsonValue& value, int depth) {
+        value.type = JsonValue::Type::Array;
+        ++p;
+        SkipSpace();
+        if (p < end && *p == ']') {
+            ++p;
+            return true;
+        }
+        while (true) {
+            value.items.emplace_back();
+            if (!ParseValue(value.items.back(), depth + 1)) {
+                return false;
+            }
+            SkipSpace();
+            if (p < end && *p == ',') {
+                ++p;
+            } else if (p < end && *p == ']') {
+                ++p;
+                return true;
+            } else {
+                return false;
+            }
+        }
+    }
+
+    bool ParseObject(JsonValue& value, int depth) {
+        value.type = JsonValue::Type::Object;
+        ++p;
+        SkipSpace();
+        if (p < end && *p == '}') {
+            ++p;
+            return true;
+        }
+        while (true) {
+            SkipSpace();
+            value.members.emplace_back();
+            auto& member = value.members.back();
+            if (p >= end || *p != '"' || !ParseString(member.first)) {
+                return false;
+            }
+            SkipSpace();
+            if (p >= end || *p != ':') {
+                return false;
+            }
+            ++p;
+            if (!ParseValue(member.second, depth + 1)) {
+                return false;
+            }
+            SkipSpace();
+            if (p < end && *p == ',') {
+                ++p;
+            } else if (p < end && *p == '}') {
+                ++p;
+                return true;
+            } else {
+                return false;
+            }
+        }
+    }
+};
+
+// ========================================
+// 3. GLTF
+// ========================================
+
+enum ComponentType : uint32_t {
+    Byte          = 5120,
+    UnsignedByte  = 5121,
+    Short         = 5122,
+    UnsignedShort = 5123,
+    UnsignedInt   = 5125,
+    Float         = 5126,
+};
+
+uint32_t ComponentSize(uint32_t type) {
+    switch (type) {
+    case Byte:
+    case UnsignedByte:
+        return 1;
+    case Short:
+    case UnsignedShort:
+        return 2;
+    case UnsignedInt:
+    case Float:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+template <typename T>
+T Load(const uint8_t* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Normalized integers map to [0, 1] (unsigned) or [-1, 1] (signed), as in the glTF spec
+double ReadComponent(const uint8_t* p, uint32_t type, bool normalized) {
+    switch (type) {
+    case Byte:
+        return normalized ? std::max(Load<int8_t>(p) / 127.0, -1.0) : Load<int8_t>(p);
+    case UnsignedByte:
+        return normalized ? Load<uint8_t>(p) / 255.0 : Load<uint8_t>(p);
+    case Short:
+        return normalized ? std::max(Load<int16_t>(p) / 32767.0, -1.0) : Load<int16_t>(p);
+    case UnsignedShort:
+        return normalized ? Load<uint16_t>(p) / 65535.0 : Load<uint16_t>(p);
+    case UnsignedInt:
+        return Load<uint32_t>(p);
+    default:
+        return Load<float>(p);
+    }
+}
+
+bool DecodeBase64(const std::string& text, size_t start, std::vector<uint8_t>& out) {
+    uint32_t bits = 0;
+    int bitCount  = 0;
+    for (size_t i = start; i < text.size() && text[i] != '='; ++i) {
+        const char c = text[i];
+        int value    = c >= 'A' && c <= 'Z'   ? c - 'A'
+                       : c >= 'a' && c <= 'z' ? c - 'a' + 26
+                       : c >= '0' && c <= '9' ? c - '0' + 52
+                       : c == '+'             ? 62
+                       : c == '/'             ? 63
+                                              : -1;
+        if (value < 0) {
+            return false;
+        }
+        bits = (bits << 6) | static_cast<uint32_t>(value);
+        bitCount += 6;
+        if (bitCount >= 8) {
+            bitCount -= 8;
+            out.push_back(static_cast<uint8_t>(bits >> bitCount));
+        }
+    }
+    return true;
+}
+
+struct GltfDocument {
+    JsonValue json;
+    std::vector<std::vector<uint8_t>> buffers;
+
+    /*
+    Read an accessor as doubles, components values per element
+    expectedComponents: Required SCALAR/VEC2/VEC3/VEC4 width, or 0 for any
+    */
+    bool ReadAccessor(uint32_t index,
+                      uint32_t expectedComponents,
+                      std::vector<double>& out,
+                      uint32_t& components,
+                      std::string& error) const {
+        const JsonValue* accessors = json.Get("accessors");
+        const JsonValue* accessor  = accessors ? accessors->At(index) : nullptr;
+        if (!accessor) {
+            error = "accessor " + std::to_string(index) + " missing";
+            return false;
+        }
+        const std::string typeName = accessor->GetString("type");
+        components                 = typeName == "SCALAR" ? 1
+                                     : typeName == "VEC2" ? 2
+                                     : typeName == "VEC3" ? 3
+                                     : typeName == "VEC4" ? 4
+                                                          : 0;
+        const uint32_t componentType =
+            static_cast<uint32_t>(accessor->GetNumber("componentType", 0));
+        const uint32_t componentSize = ComponentSize(componentType);
+        const size_t count           = static_cast<size_t>(accessor->GetNumber("count", 0));
+        const JsonValue* normalized  = accessor->Get("normalized");
+        if (components == 0 || componentSize == 0 ||
+            (expectedComponents && components != expectedComponents)) {
+            error = "accessor " + std::to_string(index) + " has an unsupported type";
+            return false;
+        }
+        if (accessor->Get("sparse") || !accessor->Get("bufferView")) {
+            error = "accessor " + std::to_string(index) + ": sparse accessors are not supported";
+            return false;
+        }
+
+        const JsonValue* views = json.Get("bufferViews");
+        const JsonValue* view  = views ? views->At(static_cast<size_t>(
+                                            accessor->GetNumber("bufferView", -1))) : nullptr;
+        const size_t bufferIndex = view ? static_cast<size_t>(view->GetNumber("buffer", -1)) : 0;
+        if (!view || bufferIndex >= buffers.size()) {
+            error = "accessor " + std::to_string(index) + " has no buffer";
+            return false;
+        }
+        const std::vector<uint8_t>& buffer = buffers[bufferIndex];
+        const size_t elementSize           = size_t(componentSize) * components;
+        const size_t stride = static_cast<size_t>(view->GetNumber("byteStride", 0));
+        const size_t step   = stride ? stride : elementSize;
+        const size_t start  = static_cast<size_t>(view->GetNumber("byteOffset", 0)) +
+                             static_cast<size_t>(accessor->GetNumber("byteOffset", 0));
+        const size_t length = static_cast<size_t>(view->GetNumber("byteLength", 0));
+        if (count > 0 && ((count - 1) * step + elementSize > length ||
+                          start + (count - 1) * step + elementSize > buffer.size())) {
+            error = "accessor " + std::to_string(index) + " runs past its buffer";
+            return false;
+        }
+
+        const bool isNormalized = normalized && normalized->boolean;
+        out.resize(count * components);
+        for (size_t i = 0; i < count; ++i) {
+            const uint8_t* element = buffer.data() + start + i * step;
+            for (uint32_t c = 0; c < components; ++c) {
+                out[i * components + c] =
+                    ReadComponent(element + c * componentSize, componentType, isNormalized);
+            }
+        }
+        return true;
+    }
+};
+
+bool LoadGltfDocument(const std::string& path, GltfDocument& document, std::string& error) {
+    std::vector<uint8_t> file;
+    if (!ReadFile(path, file)) {
+        error = "cannot read";
+        return false;
+    }
+
+    // .glb: 12-byte header, then a JSON chunk and an optional BIN chunk (buffer 0)
+    const char* jsonBegin = reinterpret_cast<const char*>(file.data());
+    const char* jsonEnd   = jsonBegin + file.size();
+    std::vector<uint8_t> binChunk;
+    bool hasBinChunk = false;
+    if (file.size() >= 20 && Load<uint32_t>(file.data()) == 0x46546C67) { // "glTF"
+        size_t offset = 12;
+        while (offset + 8 <= file.size()) {
+            const uint32_t length = Load<uint32_t>(file.data() + offset);
+            const uint32_t type   = Load<uint32_t>(file.data() + offset + 4);
+            if (length > file.size() - offset - 8) {
+                error = "truncated GLB chunk";
+                return false;
+            }
+            const uint8_t* chunk = file.data() + offset + 8;
+            if (type == 0x4E4F534A) { // "JSON"
+                jsonBegin = reinterpret_cast<const char*>(chunk);
+                jsonEnd   = jsonBegin + length;
+            } else if (type == 0x004E4942) { // "BIN\0"
+                binChunk.assign(chunk, chunk + length);
+                hasBinChunk = true;
+            }
+            offset += 8 + length;
+        }
+    }
+
+    const std::string text(jsonBegin, jsonEnd); // Null-terminated copy for strtod
+    JsonParser parser(text.c_str(), text.c_str() + text.size());
+    if (!parser.Parse(document.json) || document.json.type != JsonValue::Type::Object) {
+        error = "invalid JSON";
+        return false;
+    }
+
+    const size_t slash = path.find_last_of("/\\");
+    const std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+    const JsonValue* buffers    = document.json.Get("buffers");
+    const size_t bufferCount    = buffers ? buffers->items.size() : 0;
+    document.buffers.resize(bufferCount);
+    for (size_t i = 0; i < bufferCount; ++i) {
+        const std::string uri = buffers->items[i].GetString("uri");
+        if (uri.empty()) {
+            if (i != 0 || !hasBinChunk) {
+                error = "buffer " + std::to_string(i) + " has no data";
+                return false;
+            }
+            document.buffers[i] = std::move(binChunk);
+        } else if (uri.compare(0, 5, "data:") == 0) {
+            size_t comma = uri.find(";base64,");
+            if (comma == std::string::npos ||
+                !DecodeBase64(uri, comma + 8, document.buffers[i])) {
+                error = "buffer " + std::to_string(i) + " has an unsupported data URI";
+                return false;
+            }
+        } else if (!ReadFile(directory + uri, document.buffers[i])) {
+            error = "cannot read " + directory + uri;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+namespace MeshImport {
+
+bool ImportGltf(const std::string& path, ImportedMesh& mesh, std::string& error) {
+    GltfDocument document;
+    if (!LoadGltfDocument(path, document, error)) {
+        return false;
+    }
+
+    mesh                    = ImportedMesh();
+    const JsonValue* meshes = document.json.Get("meshes");
+    std::vector<double> positions, colors, indices;
+    for (size_t m = 0; meshes && m < meshes->items.size(); ++m) {
+        const JsonValue& source     = meshes->items[m];
+        const JsonValue* primitives = source.Get("primitives");
+        const size_t primitiveCount = primitives ? primitives->items.size() : 0;
+        for (size_t p = 0; p < primitiveCount; ++p) {
+            const JsonValue& primitive  = primitives->items[p];
+            const JsonValue* attributes = primitive.Get("attributes");
+            const JsonValue* position   = attributes ? attributes->Get("POSITION") : nullptr;
+            if (primitive.GetNumber("mode", 4) != 4 || !position) {
+                continue; // Points, lines and strips are not imported
+            }
+
+            uint32_t components = 0;
+            if (!document.ReadAccessor(
+                    static_cast<uint32_t>(position->number), 3, positions, components, error)) {
+                return false;
+            }
+            const size_t vertexCount  = positions.size() / 3;
+            const JsonValue* color    = attributes->Get("COLOR_0");
+            uint32_t colorComponents  = 0;
+            colors.clear();
+            if (color && !document.ReadAccessor(static_cast<uint32_t>(color->number),
+                                                0,
+                                                colors,
+                                                colorComponents,
+                                                error)) {
+                return false;
+            }
+            if (color && (colorComponents < 3 || colors.size() / colorComponents != vertexCount)) {
+                error = "COLOR_0 does not match POSITION";
+                return false;
+            }
+
+            const JsonValue* index = primitive.Get("indices");
+            if (index) {
+                if (!document.ReadAccessor(
+                        static_cast<uint32_t>(index->number), 1, indices, components, error)) {
+                    return false;
+                }
+            } else {
+                indices.resize(vertexCount);
+                for (size_t i = 0; i < vertexCount; ++i) {
+                    indices[i] = static_cast<double>(i);
+                }
+            }
+
+            ImportedMesh::Part part;
+            part.name        = source.GetString("name");
+            part.name        = part.name.empty() ? "mesh" + std::to_string(m) : part.name;
+            part.name        += primitiveCount > 1 ? "." + std::to_string(p) : "";
+            part.indexStart  = static_cast<uint32_t>(mesh.indices.size());
+            part.indexCount  = static_cast<uint32_t>(indices.size() / 3 * 3);
+            part.baseVertex  = static_cast<uint32_t>(mesh.vertices.size());
+            part.vertexCount = static_cast<uint32_t>(vertexCount);
+
+            for (size_t v = 0; v < vertexCount; ++v) {
+                float xyz[3]  = {static_cast<float>(positions[v * 3]),
+                                 static_cast<float>(positions[v * 3 + 1]),
+                                 static_cast<float>(positions[v * 3 + 2])};
+                float rgba[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+                for (uint32_t c = 0; c < colorComponents; ++c) {
+                    rgba[c] = static_cast<float>(colors[v * colorComponents + c]);
+                }
+                mesh.vertices.push_back(MakeVertex(xyz, rgba));
+            }
+            for (uint32_t i = 0; i < part.indexCount; ++i) {
+                if (indices[i] >= static_cast<double>(vertexCount)) {
+                    error = "index out of range in " + part.name;
+                    return false;
+                }
+                mesh.indices.push_back(static_cast<uint32_t>(indices[i]));
+            }
+            if (part.indexCount > 0) {
+                mesh.parts.push_back(part);
+            } else {
+                mesh.vertices.resize(part.baseVertex);
+            }
+        }
+    }
+
+    if (mesh.parts.empty()) {
+        error = "no triangle primitives";
+        return false;
+    }
+    return true;
+}
+
+bool Import(const std::string& path, ImportedMesh& mesh, std::string& error) {
+    const std::string extension = Extension(path);
+    if (extension == "obj") {
+        return ImportObj(path, mesh, error);
+    }
+    if (extension == "gltf" || extension == "glb") {
+        return ImportGltf(path, mesh, error);
+    }
+    error = "unknown extension (expected .obj, .gltf or .glb)";
+    return false;
+}
+
+} // namespace MeshImport
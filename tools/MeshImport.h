@@ -0,0 +1,43 @@
+#pragma once
+#include "render/RenderBackend.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Mesh Import
+// Source-format readers for MeshConverter. Everything is flattened into float Vertex data
+// (position and color; other attributes are dropped) with one part per OBJ object, group
+// or material and per glTF primitive. Each part has its own vertices and part-local indices,
+// so parts under 65536 vertices keep 16-bit indices however large the whole mesh is.
+struct ImportedMesh {
+    struct Part {
+        std::string name;
+        uint32_t indexStart  = 0;
+        uint32_t indexCount  = 0;
+        uint32_t baseVertex  = 0;
+        uint32_t vertexCount = 0;
+    };
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices; // Relative to the part's baseVertex
+    std::vector<Part> parts;
+};
+
+namespace MeshImport {
+
+/*
+Wavefront OBJ: v (with the optional "v x y z r g b" vertex color extension) and f
+Polygons are fan-triangulated; o, g and usemtl start a new part
+*/
+bool ImportObj(const std::string& path, ImportedMesh& mesh, std::string& error);
+
+/*
+glTF 2.0, .gltf (external or data: URI buffers) or .glb
+Triangle primitives with POSITION and optional COLOR_0; node transforms are not applied
+*/
+bool ImportGltf(const std::string& path, ImportedMesh& mesh, std::string& error);
+
+// Picks the reader from the extension
+bool Import(const std::string& path, ImportedMesh& mesh, std::string& error);
+
+} // namespace MeshImport
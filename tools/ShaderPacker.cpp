@@ -0,0 +1,99 @@
+// Shader Packer
+// Packs compiled shader objects into a ShaderArchive, or lists and verifies an existing one.
+//
+//   ShaderPacker <output.pak> <shader.cso>...
+//   ShaderPacker --list <archive.pak>
+//
+// Entry names are file names without directory or extension; the stage comes from the
+// VS/PS/GS/HS/DS/CS suffix, as in shaders/ (see ShaderStageFromName).
+#include "render/ShaderArchive.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool ReadFile(const std::string& path, std::vector<uint8_t>& bytes) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    bytes.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    bool ok = size > 0 && std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    std::fclose(file);
+    return ok;
+}
+
+std::string Stem(const std::string& path) {
+    size_t slash     = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot       = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+int List(const std::string& path) {
+    ShaderArchive archive;
+    if (!archive.Open(path)) {
+        std::fprintf(stderr, "%s: not a valid shader archive\n", path.c_str());
+        return 1;
+    }
+    for (uint32_t i = 0; i < archive.GetEntryCount(); ++i) {
+        const ShaderArchive::Entry& entry = archive.GetEntry(i);
+        std::printf("%-48s %s %8u bytes  offset %8llu  hash %016llx\n",
+                    entry.name,
+                    ShaderStageSuffix(entry.stage),
+                    entry.size,
+                    static_cast<unsigned long long>(entry.offset),
+                    static_cast<unsigned long long>(entry.hash));
+    }
+    std::printf("%u entries, %u distinct blobs\n", archive.GetEntryCount(), archive.GetBlobCount());
+    if (!archive.Verify()) {
+        std::fprintf(stderr, "%s: hash mismatch, archive is corrupt\n", path.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc == 3 && std::string(argv[1]) == "--list") {
+        return List(argv[2]);
+    }
+    if (argc < 3) {
+        std::fprintf(stderr,
+                     "usage: %s <output.pak> <shader.cso>...\n"
+                     "       %s --list <archive.pak>\n",
+                     argv[0],
+                     argv[0]);
+        return 1;
+    }
+
+    ShaderArchiveWriter writer;
+    std::vector<uint8_t> bytecode;
+    for (int i = 2; i < argc; ++i) {
+        std::string name = Stem(argv[i]);
+        ShaderStage stage;
+        if (!ShaderStageFromName(name, stage)) {
+            std::fprintf(stderr, "%s: no VS/PS/GS/HS/DS/CS suffix, skipped\n", argv[i]);
+            continue;
+        }
+        if (!ReadFile(argv[i], bytecode)) {
+            std::fprintf(stderr, "%s: cannot read\n", argv[i]);
+            return 1;
+        }
+        if (!writer.Add(name, stage, bytecode.data(), bytecode.size())) {
+            std::fprintf(stderr, "%s: duplicate or invalid name\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (!writer.Write(argv[1])) {
+        std::fprintf(stderr, "%s: cannot write\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}